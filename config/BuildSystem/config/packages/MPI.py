@@ -266,6 +266,9 @@ shared libraries and flag it with --known-mpi-shared-libraries=1')
         self.addDefine('HAVE_MPI_WIN_CREATE_FEATURE',1)
         self.addDefine('HAVE_MPI_PROCESS_SHARED_MEMORY',1)
         self.support_mpi3_shm = 1
+    if self.checkLink('#include <mpi.h>\n', 'MPI_Comm ncomm; MPI_Request req; if (MPI_Dist_graph_create_adjacent(MPI_COMM_WORLD,0,0,MPI_UNWEIGHTED,0,0,MPI_UNWEIGHTED,MPI_INFO_NULL,0,&ncomm));\n \
+                                             if (MPI_Ineighbor_alltoallv(0,0,0,MPI_INT,0,0,0,MPI_INT,ncomm,&req));\n'):
+      self.addDefine('HAVE_MPI_NEIGHBORHOOD_COLLECTIVES',1)
     self.compilers.CPPFLAGS = oldFlags
     self.compilers.LIBS = oldLibs
     self.logWrite(self.framework.restoreLog())
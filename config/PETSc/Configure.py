@@ -133,7 +133,7 @@ class Configure(config.base.Configure):
                                             'unistd', 'sys/sysinfo', 'machine/endian', 'sys/param', 'sys/procfs', 'sys/resource',
                                             'sys/systeminfo', 'sys/times', 'sys/utsname','string', 'stdlib',
                                             'sys/socket','sys/wait','netinet/in','netdb','Direct','time','Ws2tcpip','sys/types',
-                                            'WindowsX', 'cxxabi','float','ieeefp','stdint','sched','pthread','inttypes','immintrin','zmmintrin'])
+                                            'WindowsX', 'cxxabi','float','ieeefp','stdint','sched','pthread','inttypes','immintrin','zmmintrin','linux/perf_event'])
     functions = ['access', '_access', 'clock', 'drand48', 'getcwd', '_getcwd', 'getdomainname', 'gethostname',
                  'gettimeofday', 'getwd', 'memalign', 'mkstemp', 'popen', 'PXFGETARG', 'rand', 'getpagesize',
                  'readlink', 'realpath',  'sigaction', 'signal', 'sigset', 'usleep', 'sleep', '_sleep', 'socket',
@@ -819,6 +819,66 @@ fprintf(f, "%lu\\n", (unsigned long)sizeof(struct mystruct));
       self.addDefine('ATTRIBUTEALIGNED(size)', ' ')
     return
 
+  def configureHardwareCounters(self):
+    '''Checks if the cycles and instructions of -log_view_counters can be counted on this machine, through PAPI if it
+       was found and otherwise through perf_event_open(); virtual machines often have no counters to read'''
+    if self.framework.argDB['with-batch']: return
+    if self.papi.found:
+      includes = '#include <papi.h>\n'
+      body     = '''
+int       set = PAPI_NULL;
+long long v[2];
+if (PAPI_library_init(PAPI_VER_CURRENT) != PAPI_VER_CURRENT || PAPI_create_eventset(&set) != PAPI_OK) return 1;
+if (PAPI_add_event(set,PAPI_TOT_CYC) != PAPI_OK || PAPI_add_event(set,PAPI_TOT_INS) != PAPI_OK) return 1;
+if (PAPI_start(set) != PAPI_OK || PAPI_stop(set,v) != PAPI_OK) return 1;
+if (v[0] <= 0 || v[1] <= 0) return 1;
+'''
+      oldFlags = self.compilers.CPPFLAGS
+      oldLibs  = self.compilers.LIBS
+      self.compilers.CPPFLAGS += ' '+self.headers.toString(self.papi.include)
+      self.compilers.LIBS = self.libraries.toString(self.papi.lib)+' '+self.compilers.LIBS
+    elif self.headers.haveHeader('linux/perf_event.h') and self.headers.haveHeader('unistd.h'):
+      includes = '''
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <string.h>
+#include <unistd.h>
+static int open_counter(__u64 config,int group)
+{
+  struct perf_event_attr attr;
+  memset(&attr,0,sizeof(attr));
+  attr.size           = sizeof(attr);
+  attr.type           = PERF_TYPE_HARDWARE;
+  attr.config         = config;
+  attr.disabled       = group < 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv     = 1;
+  attr.read_format    = PERF_FORMAT_GROUP;
+  return (int)syscall(__NR_perf_event_open,&attr,0,-1,group,0);
+}
+'''
+      body     = '''
+__u64 v[3] = {0,0,0};
+volatile double s = 0.0;
+int i,fd = open_counter(PERF_COUNT_HW_CPU_CYCLES,-1);
+if (fd < 0 || open_counter(PERF_COUNT_HW_INSTRUCTIONS,fd) < 0) return 1;
+if (ioctl(fd,PERF_EVENT_IOC_ENABLE,PERF_IOC_FLAG_GROUP)) return 1;
+for (i=0; i<100000; i++) s += i;
+if (read(fd,v,sizeof(v)) != (ssize_t)sizeof(v) || v[0] != 2 || !v[1] || !v[2]) return 1;
+'''
+      oldFlags = self.compilers.CPPFLAGS
+      oldLibs  = self.compilers.LIBS
+    else:
+      return
+    self.pushLanguage('C')
+    if self.checkRun(includes, body):
+      self.addDefine('HAVE_HARDWARE_COUNTERS', 1)
+    self.popLanguage()
+    self.compilers.CPPFLAGS = oldFlags
+    self.compilers.LIBS     = oldLibs
+    return
+
   def configureExpect(self):
     '''Sees if the __builtin_expect directive is supported'''
     self.pushLanguage(self.languages.clanguage)
@@ -1105,6 +1165,7 @@ fprintf(f, "%lu\\n", (unsigned long)sizeof(struct mystruct));
     self.executeTest(self.configureInstall)
     self.executeTest(self.configureGCOV)
     self.executeTest(self.configureAtoll)
+    self.executeTest(self.configureHardwareCounters)
 
     self.Dump()
     self.dumpConfigInfo()
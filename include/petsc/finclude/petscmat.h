@@ -165,6 +165,7 @@
 #define MATSOLVERMATLAB          'matlab'
 #define MATSOLVERPETSC           'petsc'
 #define MATSOLVERBAS             'bas'
+#define MATSOLVERCHOWILU         'chowilu'
 #define MATSOLVERCUSPARSE        'cusparse'
 
 !
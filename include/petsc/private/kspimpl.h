@@ -188,6 +188,13 @@ PETSC_INTERN PetscErrorCode KSPSetUpNorms_Private(KSP,PetscBool,KSPNormType*,PCS
 
 PETSC_INTERN PetscErrorCode KSPPlotEigenContours_Private(KSP,PetscInt,const PetscReal*,const PetscReal*);
 
+/*
+    Polynomial bases of the s-step Krylov methods KSPSCG and KSPSGMRES, see KSPSStepBasisCoefficients_Private()
+*/
+typedef enum {KSP_SSTEP_BASIS_MONOMIAL,KSP_SSTEP_BASIS_NEWTON,KSP_SSTEP_BASIS_CHEBYSHEV} KSPSStepBasisType;
+PETSC_INTERN const char *const KSPSStepBasisTypes[];
+PETSC_INTERN PetscErrorCode KSPSStepBasisCoefficients_Private(KSPSStepBasisType,PetscInt,const PetscReal*,const PetscReal*,PetscInt,PetscScalar*,PetscScalar*,PetscScalar*);
+
 typedef struct _p_DMKSP *DMKSP;
 typedef struct _DMKSPOps *DMKSPOps;
 struct _DMKSPOps {
@@ -125,5 +125,8 @@ PETSC_EXTERN PetscErrorCode PetscEventRegLogGetEvent(PetscEventRegLog, const cha
 
 PETSC_INTERN PetscErrorCode PetscLogView_Nested(PetscViewer);
 PETSC_INTERN PetscErrorCode PetscLogNestedEnd(void);
+PETSC_INTERN PetscErrorCode PetscLogTimelineEnd(void);
+PETSC_INTERN PetscErrorCode PetscLogCountersRead(PetscLogDouble[]);
+PETSC_INTERN PetscErrorCode PetscLogCountersEnd(void);
 
 #endif /* PETSC_USE_LOG */
@@ -27,6 +27,7 @@ typedef struct {
   Mat           restrct;                       /* restrict is a reserved word in C99 and on Cray */
   Mat           inject;                        /* Used for moving state if provided. */
   Vec           rscale;                        /* scaling of restriction matrix */
+  PetscObjectState Anonzerostate,Bnonzerostate; /* nonzero states of the finer operators the Galerkin products were computed from */
   PetscLogEvent eventsmoothsetup;              /* if logging times for each level */
   PetscLogEvent eventsmoothsolve;
   PetscLogEvent eventresidual;
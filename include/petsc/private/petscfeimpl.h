@@ -122,7 +122,7 @@ struct _PetscFEOps {
   PetscErrorCode (*integratebd)(PetscDS, PetscInt, PetscBdPointFunc, PetscInt, PetscFEGeom *, const PetscScalar[], PetscDS, const PetscScalar[], PetscScalar[]);
   PetscErrorCode (*integrateresidual)(PetscDS, PetscInt, PetscInt, PetscFEGeom *, const PetscScalar[], const PetscScalar[], PetscDS, const PetscScalar[], PetscReal, PetscScalar[]);
   PetscErrorCode (*integratebdresidual)(PetscDS, PetscInt, PetscInt, PetscFEGeom *, const PetscScalar[], const PetscScalar[], PetscDS, const PetscScalar[], PetscReal, PetscScalar[]);
-  PetscErrorCode (*integratejacobianaction)(PetscFE, PetscDS, PetscInt, PetscInt, PetscFEGeom *, const PetscScalar[], const PetscScalar[], PetscDS, const PetscScalar[], PetscReal, PetscReal, PetscScalar[]);
+  PetscErrorCode (*integratejacobianaction)(PetscDS, PetscFEJacobianType, PetscInt, PetscInt, PetscInt, PetscFEGeom *, const PetscScalar[], const PetscScalar[], PetscDS, const PetscScalar[], PetscReal, PetscReal, const PetscScalar[], PetscScalar[]);
   PetscErrorCode (*integratejacobian)(PetscDS, PetscFEJacobianType, PetscInt, PetscInt, PetscInt, PetscFEGeom *, const PetscScalar[], const PetscScalar[], PetscDS, const PetscScalar[], PetscReal, PetscReal, PetscScalar[]);
   PetscErrorCode (*integratebdjacobian)(PetscDS, PetscInt, PetscInt, PetscInt, PetscFEGeom *, const PetscScalar[], const PetscScalar[], PetscDS, const PetscScalar[], PetscReal, PetscReal, PetscScalar[]);
 };
@@ -176,6 +176,23 @@ typedef struct {
   PetscInt     *embedding;      /* Map from subelements dofs to element dofs */
 } PetscFE_Composite;
 
+typedef struct {
+  PetscInt     width;    /* The number of cells integrated together */
+  PetscInt     workSize;
+  PetscScalar *work;     /* Batch arrays, with the cell index innermost */
+} PetscFE_Vector;
+
+typedef struct {
+  PetscQuadrature quad;     /* The quadrature the one dimensional factors were computed for */
+  PetscBool       tensor;   /* The basis and quadrature are tensor products of one dimensional pieces */
+  PetscInt        Nb1, Nq1; /* The number of one dimensional basis functions and quadrature points */
+  PetscReal      *B1, *D1;  /* The one dimensional tabulation B1[q*Nb1+b] and its derivative */
+  PetscInt       *bperm;    /* The basis function for component c at lexicographic node i is bperm[c*Nb1^dim+i] */
+  PetscInt       *qperm;    /* The quadrature point with lexicographic index i is qperm[i] */
+  PetscInt        workSize;
+  PetscScalar    *work;
+} PetscFE_SumFact;
+
 /* Utility functions */
 PETSC_STATIC_INLINE void CoordinatesRefToReal(PetscInt dimReal, PetscInt dimRef, const PetscReal xi0[], const PetscReal v0[], const PetscReal J[], const PetscReal xi[], PetscReal x[])
 {
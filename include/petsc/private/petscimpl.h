@@ -906,6 +906,30 @@ PETSC_INTERN PetscSpinlock PetscCommSpinLock;
 #endif
 #endif
 
+/*
+    PetscPragmaOMP - expands to an OpenMP pragma when PETSc is configured --with-openmp and to nothing otherwise,
+    for example PetscPragmaOMP(parallel for schedule(static)). Loops it annotates must only use variables
+    declared inside the loop body as temporaries.
+
+    PetscOMPUseThreads(n) - true if a kernel of length n (entries, rows or nonzeros) should run threaded, that
+    is if it is long enough to pay for waking up the thread team, more than one thread is available and the
+    caller is not already inside a parallel region. It is false at compile time without OpenMP, so the
+    threaded branch of a kernel is discarded and the sequential code is unchanged.
+*/
+#define PETSC_OMP_MIN_LENGTH 4096
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#define PetscPragmaOMP(x) _Pragma(PetscStringize(omp x))
+#define PetscOMPUseThreads(n) (PetscBool)((n) >= PETSC_OMP_MIN_LENGTH && !omp_in_parallel() && omp_get_max_threads() > 1)
+#if defined(PETSC_USE_COMPLEX) && defined(__cplusplus)
+/* OpenMP reductions only know the built-in arithmetic types, std::complex needs to be declared */
+PetscPragmaOMP(declare reduction(+:PetscScalar:omp_out += omp_in) initializer(omp_priv = PetscScalar(0.0)))
+#endif
+#else
+#define PetscPragmaOMP(x)
+#define PetscOMPUseThreads(n) PETSC_FALSE
+#endif
+
 PETSC_EXTERN PetscLogEvent PETSC_Barrier;
 PETSC_EXTERN PetscLogEvent PETSC_BuildTwoSided;
 PETSC_EXTERN PetscLogEvent PETSC_BuildTwoSidedF;
@@ -33,6 +33,10 @@ struct _PetscSFOps {
   PetscErrorCode (*BcastAndOpEnd)(PetscSF,MPI_Datatype,const void*,void*,MPI_Op);
   PetscErrorCode (*ReduceBegin)(PetscSF,MPI_Datatype,const void*,void*,MPI_Op);
   PetscErrorCode (*ReduceEnd)(PetscSF,MPI_Datatype,const void*,void*,MPI_Op);
+  PetscErrorCode (*BcastAndOpBeginMultiple)(PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op);
+  PetscErrorCode (*BcastAndOpEndMultiple)(PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op);
+  PetscErrorCode (*ReduceBeginMultiple)(PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op);
+  PetscErrorCode (*ReduceEndMultiple)(PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op);
   PetscErrorCode (*FetchAndOpBegin)(PetscSF,MPI_Datatype,void*,const void*,void*,MPI_Op);
   PetscErrorCode (*FetchAndOpEnd)(PetscSF,MPI_Datatype,void*,const void *,void *,MPI_Op);
   PetscErrorCode (*GetLeafRanks)(PetscSF,PetscInt*,const PetscMPIInt**,const PetscInt**,const PetscInt **);
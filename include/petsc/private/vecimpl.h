@@ -213,6 +213,8 @@ PETSC_INTERN PetscErrorCode VecLockWriteSet_Private(Vec,PetscBool);
 
 /* Default obtain and release vectors; can be used by any implementation */
 PETSC_EXTERN PetscErrorCode VecDuplicateVecs_Default(Vec,PetscInt,Vec *[]);
+PETSC_INTERN PetscErrorCode VecDuplicateVecsContiguous_Seq(Vec,PetscInt,Vec *[]);
+PETSC_INTERN PetscErrorCode VecDuplicateVecsContiguous_MPI(Vec,PetscInt,Vec *[]);
 PETSC_EXTERN PetscErrorCode VecDestroyVecs_Default(PetscInt,Vec []);
 PETSC_INTERN PetscErrorCode VecLoad_Binary(Vec, PetscViewer);
 PETSC_EXTERN PetscErrorCode VecLoad_Default(Vec, PetscViewer);
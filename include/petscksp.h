@@ -37,6 +37,7 @@ typedef const char* KSPType;
 #define KSPGROPPCG    "groppcg"
 #define KSPPIPECG     "pipecg"
 #define KSPPIPECGRR   "pipecgrr"
+#define KSPSCG        "scg"
 #define KSPPIPELCG     "pipelcg"
 #define   KSPCGNE       "cgne"
 #define   KSPNASH       "nash"
@@ -49,6 +50,7 @@ typedef const char* KSPType;
 #define KSPPIPEFCG    "pipefcg"
 #define KSPGMRES      "gmres"
 #define KSPPIPEFGMRES "pipefgmres"
+#define   KSPSGMRES     "sgmres"
 #define   KSPFGMRES     "fgmres"
 #define   KSPLGMRES     "lgmres"
 #define   KSPDGMRES     "dgmres"
@@ -213,6 +215,7 @@ PETSC_EXTERN PetscErrorCode KSPGMRESSetOrthogonalization(KSP,PetscErrorCode (*)(
 PETSC_EXTERN PetscErrorCode KSPGMRESGetOrthogonalization(KSP,PetscErrorCode (**)(KSP,PetscInt));
 PETSC_EXTERN PetscErrorCode KSPGMRESModifiedGramSchmidtOrthogonalization(KSP,PetscInt);
 PETSC_EXTERN PetscErrorCode KSPGMRESClassicalGramSchmidtOrthogonalization(KSP,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPGMRESCholQROrthogonalization(KSP,PetscInt);
 
 PETSC_EXTERN PetscErrorCode KSPLGMRESSetAugDim(KSP,PetscInt);
 PETSC_EXTERN PetscErrorCode KSPLGMRESSetConstant(KSP);
@@ -109,6 +109,9 @@ struct _n_PetscClassPerfLog {
       of these for each stage.
 
 */
+#define PETSC_LOG_NUM_COUNTERS 4
+typedef enum {PETSC_LOG_COUNTER_CYCLES,PETSC_LOG_COUNTER_INSTRUCTIONS,PETSC_LOG_COUNTER_CACHE_MISSES,PETSC_LOG_COUNTER_VECTOR_INSTRUCTIONS} PetscLogCounter;
+
 typedef struct {
   char         *name;         /* The name of this event */
   PetscClassId classid;       /* The class the event is associated with */
@@ -137,6 +140,7 @@ typedef struct {
   PetscLogDouble mallocIncrease;/* How much the maximum malloced space has increased in this event */
   PetscLogDouble mallocSpace;   /* How much the space was malloced and kept during this event */
   PetscLogDouble mallocIncreaseEvent;  /* Maximum of the high water mark with in event minus memory available at the end of the event */
+  PetscLogDouble counters[PETSC_LOG_NUM_COUNTERS]; /* The hardware counter increments in this event, see PetscLogCountersBegin() */
 } PetscEventPerfInfo;
 
 typedef struct _n_PetscEventRegLog *PetscEventRegLog;
@@ -238,6 +242,8 @@ PETSC_EXTERN PetscErrorCode PetscLogDefaultBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogAllBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogNestedBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogTraceBegin(FILE *);
+PETSC_EXTERN PetscErrorCode PetscLogTimelineBegin(PetscInt);
+PETSC_EXTERN PetscErrorCode PetscLogCountersBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogActions(PetscBool);
 PETSC_EXTERN PetscErrorCode PetscLogObjects(PetscBool);
 PETSC_EXTERN PetscErrorCode PetscLogSetThreshold(PetscLogDouble,PetscLogDouble*);
@@ -248,6 +254,7 @@ PETSC_EXTERN PetscErrorCode PetscLogSet(PetscErrorCode (*)(int, int, PetscObject
 PETSC_EXTERN PetscErrorCode PetscLogView(PetscViewer);
 PETSC_EXTERN PetscErrorCode PetscLogViewFromOptions(void);
 PETSC_EXTERN PetscErrorCode PetscLogDump(const char[]);
+PETSC_EXTERN PetscErrorCode PetscLogTimelineDump(const char[]);
 
 /* Stage functions */
 PETSC_EXTERN PetscErrorCode PetscLogStageRegister(const char[],PetscLogStage*);
@@ -292,6 +299,7 @@ PETSC_EXTERN PetscLogDouble petsc_wait_all_ct;
 PETSC_EXTERN PetscLogDouble petsc_sum_of_waits_ct;
 
 PETSC_EXTERN PetscBool      PetscLogMemory;
+PETSC_EXTERN PetscBool      PetscLogCounters;
 
 PETSC_EXTERN PetscBool PetscLogSyncOn;  /* true if logging synchronization is enabled */
 PETSC_EXTERN PetscErrorCode PetscLogEventSynchronize(PetscLogEvent, MPI_Comm);
@@ -439,6 +447,7 @@ PETSC_STATIC_INLINE int PetscMPIParallelComm(MPI_Comm comm)
 #else  /* ---Logging is turned off --------------------------------------------*/
 
 #define PetscLogMemory                     PETSC_FALSE
+#define PetscLogCounters                   PETSC_FALSE
 
 #define PetscLogFlops(n)                   0
 #define PetscGetFlops(a)                   (*(a) = 0.0,0)
@@ -480,6 +489,8 @@ PETSC_EXTERN PetscErrorCode PetscLogObjectState(PetscObject,const char[],...);
 #define PetscLogAllBegin()                 0
 #define PetscLogNestedBegin()              0
 #define PetscLogTraceBegin(file)           0
+#define PetscLogTimelineBegin(n)           0
+#define PetscLogCountersBegin()            0
 #define PetscLogActions(a)                 0
 #define PetscLogObjects(a)                 0
 #define PetscLogSetThreshold(a,b)          0
@@ -488,6 +499,7 @@ PETSC_EXTERN PetscErrorCode PetscLogObjectState(PetscObject,const char[],...);
 #define PetscLogView(viewer)               0
 #define PetscLogViewFromOptions()          0
 #define PetscLogDump(c)                    0
+#define PetscLogTimelineDump(c)            0
 
 #define PetscLogEventSync(e,comm)          0
 #define PetscLogEventBegin(e,o1,o2,o3,o4)  0
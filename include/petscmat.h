@@ -48,6 +48,9 @@ typedef const char* MatType;
 #define MATAIJSELL         "aijsell"
 #define MATSEQAIJSELL      "seqaijsell"
 #define MATMPIAIJSELL      "mpiaijsell"
+#define MATAIJSINGLE       "aijsingle"
+#define MATSEQAIJSINGLE    "seqaijsingle"
+#define MATMPIAIJSINGLE    "mpiaijsingle"
 #define MATAIJMKL          "aijmkl"
 #define MATSEQAIJMKL       "seqaijmkl"
 #define MATMPIAIJMKL       "mpiaijmkl"
@@ -129,6 +132,7 @@ typedef const char* MatSolverType;
 #define MATSOLVERMATLAB           "matlab"
 #define MATSOLVERPETSC            "petsc"
 #define MATSOLVERBAS              "bas"
+#define MATSOLVERCHOWILU          "chowilu"
 #define MATSOLVERCUSPARSE         "cusparse"
 
 /*E
@@ -264,6 +268,8 @@ PETSC_EXTERN PetscErrorCode MatLRCGetMats(Mat,Mat*,Mat*,Vec*,Mat*);
 PETSC_EXTERN PetscErrorCode MatCreateIS(MPI_Comm,PetscInt,PetscInt,PetscInt,PetscInt,PetscInt,ISLocalToGlobalMapping,ISLocalToGlobalMapping,Mat*);
 PETSC_EXTERN PetscErrorCode MatCreateSeqAIJCRL(MPI_Comm,PetscInt,PetscInt,PetscInt,const PetscInt[],Mat*);
 PETSC_EXTERN PetscErrorCode MatCreateMPIAIJCRL(MPI_Comm,PetscInt,PetscInt,PetscInt,const PetscInt[],PetscInt,const PetscInt[],Mat*);
+PETSC_EXTERN PetscErrorCode MatCreateSeqAIJSingle(MPI_Comm,PetscInt,PetscInt,PetscInt,const PetscInt[],Mat*);
+PETSC_EXTERN PetscErrorCode MatCreateMPIAIJSingle(MPI_Comm,PetscInt,PetscInt,PetscInt,PetscInt,PetscInt,const PetscInt[],PetscInt,const PetscInt[],Mat*);
 
 PETSC_EXTERN PetscErrorCode MatCreateScatter(MPI_Comm,VecScatter,Mat*);
 PETSC_EXTERN PetscErrorCode MatScatterSetVecScatter(Mat,VecScatter);
@@ -16,17 +16,20 @@ PETSC_EXTERN PetscClassId PETSCSF_CLASSID;
    Level: beginner
 
    Notes:
-    The two approaches provided are
-$     PETSCSFBASIC which uses MPI 1 message passing to perform the communication and
+    The three approaches provided are
+$     PETSCSFBASIC which uses MPI 1 message passing to perform the communication,
 $     PETSCSFWINDOW which uses MPI 2 one-sided operations to perform the communication, this may be more efficient,
 $                   but may not be available for all MPI distributions. In particular OpenMPI has bugs in its one-sided
-$                   operations that prevent its use.
+$                   operations that prevent its use, and
+$     PETSCSFNEIGHBOR which uses MPI 3 neighborhood collectives on a distributed graph communicator, so that the MPI
+$                   implementation can optimize the exchange with all neighbors as a whole.
 
 .seealso: PetscSFSetType(), PetscSF
 J*/
 typedef const char *PetscSFType;
-#define PETSCSFBASIC  "basic"
-#define PETSCSFWINDOW "window"
+#define PETSCSFBASIC    "basic"
+#define PETSCSFWINDOW   "window"
+#define PETSCSFNEIGHBOR "neighbor"
 
 /*E
     PetscSFWindowSyncType - Type of synchronization for PETSCSFWINDOW
@@ -101,6 +104,11 @@ PETSC_EXTERN PetscErrorCode PetscSFReduceBegin(PetscSF,MPI_Datatype,const void*,
   PetscAttrMPIPointerWithType(3,2) PetscAttrMPIPointerWithType(4,2);
 PETSC_EXTERN PetscErrorCode PetscSFReduceEnd(PetscSF,MPI_Datatype,const void*,void*,MPI_Op)
   PetscAttrMPIPointerWithType(3,2) PetscAttrMPIPointerWithType(4,2);
+/* Same as PetscSFBcastAndOp and PetscSFReduce on several arrays at once, sharing the messages */
+PETSC_EXTERN PetscErrorCode PetscSFBcastAndOpBeginMultiple(PetscSF,MPI_Datatype,PetscInt,const void *const[],void *const[],MPI_Op);
+PETSC_EXTERN PetscErrorCode PetscSFBcastAndOpEndMultiple(PetscSF,MPI_Datatype,PetscInt,const void *const[],void *const[],MPI_Op);
+PETSC_EXTERN PetscErrorCode PetscSFReduceBeginMultiple(PetscSF,MPI_Datatype,PetscInt,const void *const[],void *const[],MPI_Op);
+PETSC_EXTERN PetscErrorCode PetscSFReduceEndMultiple(PetscSF,MPI_Datatype,PetscInt,const void *const[],void *const[],MPI_Op);
 /* Atomically modifies (using provided operation) rootdata using leafdata from each leaf, value at root at time of modification is returned in leafupdate. */
 PETSC_EXTERN PetscErrorCode PetscSFFetchAndOpBegin(PetscSF,MPI_Datatype,void*,const void*,void*,MPI_Op)
   PetscAttrMPIPointerWithType(3,2) PetscAttrMPIPointerWithType(4,2) PetscAttrMPIPointerWithType(5,2);
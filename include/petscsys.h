@@ -1186,6 +1186,8 @@ PETSC_EXTERN PetscErrorCode (*PetscTrMalloc)(size_t,int,const char[],const char[
 PETSC_EXTERN PetscErrorCode (*PetscTrFree)(void*,int,const char[],const char[]);
 PETSC_EXTERN PetscErrorCode (*PetscTrRealloc)(size_t,int,const char[],const char[],void**);
 PETSC_EXTERN PetscErrorCode PetscMallocSetCoalesce(PetscBool);
+PETSC_EXTERN PetscErrorCode PetscMallocSetPool(PetscBool);
+PETSC_EXTERN PetscErrorCode PetscMallocSetPoolHuge(size_t,PetscInt);
 PETSC_EXTERN PetscErrorCode PetscMallocSet(PetscErrorCode (*)(size_t,int,const char[],const char[],void**),PetscErrorCode (*)(void*,int,const char[],const char[]));
 PETSC_EXTERN PetscErrorCode PetscMallocClear(void);
 
@@ -1203,6 +1205,7 @@ PETSC_EXTERN PetscErrorCode PetscMallocResetDRAM(void);
 */
 PETSC_EXTERN PetscErrorCode PetscMallocDump(FILE *);
 PETSC_EXTERN PetscErrorCode PetscMallocDumpLog(FILE *);
+PETSC_EXTERN PetscErrorCode PetscMallocPoolView(FILE *);
 PETSC_EXTERN PetscErrorCode PetscMallocGetCurrentUsage(PetscLogDouble *);
 PETSC_EXTERN PetscErrorCode PetscMallocGetMaximumUsage(PetscLogDouble *);
 PETSC_EXTERN PetscErrorCode PetscMallocPushMaximumUsage(int);
@@ -1844,6 +1847,8 @@ M*/
 #if defined(PETSC_HAVE_MPIIO)
 PETSC_EXTERN PetscErrorCode MPIU_File_write_all(MPI_File,void*,PetscMPIInt,MPI_Datatype,MPI_Status*);
 PETSC_EXTERN PetscErrorCode MPIU_File_read_all(MPI_File,void*,PetscMPIInt,MPI_Datatype,MPI_Status*);
+PETSC_EXTERN PetscErrorCode MPIU_File_write_at_all(MPI_File,MPI_Offset,void*,PetscMPIInt,MPI_Datatype,MPI_Status*);
+PETSC_EXTERN PetscErrorCode MPIU_File_read_at_all(MPI_File,MPI_Offset,void*,PetscMPIInt,MPI_Datatype,MPI_Status*);
 #endif
 
 /* the following petsc_static_inline require petscerror.h */
@@ -2291,6 +2296,8 @@ PETSC_EXTERN PetscErrorCode PetscOpenSocket(const char[],int,int*);
 
 PETSC_EXTERN PetscErrorCode PetscBinarySeek(int,off_t,PetscBinarySeekType,off_t*);
 PETSC_EXTERN PetscErrorCode PetscBinarySynchronizedSeek(MPI_Comm,int,off_t,PetscBinarySeekType,off_t*);
+PETSC_EXTERN PetscErrorCode PetscBinaryMap(int,off_t,PetscInt,PetscDataType,PetscBool,void**,void**,size_t*);
+PETSC_EXTERN PetscErrorCode PetscBinaryUnmap(void*,size_t);
 PETSC_EXTERN PetscErrorCode PetscByteSwap(void *,PetscDataType,PetscInt);
 
 PETSC_EXTERN PetscErrorCode PetscSetDebugTerminal(const char[]);
@@ -270,6 +270,7 @@ PETSC_EXTERN PetscErrorCode VecExp(Vec);
 PETSC_EXTERN PetscErrorCode VecAbs(Vec);
 PETSC_EXTERN PetscErrorCode VecDuplicate(Vec,Vec*);
 PETSC_EXTERN PetscErrorCode VecDuplicateVecs(Vec,PetscInt,Vec*[]);
+PETSC_EXTERN PetscErrorCode VecDuplicateVecsContiguous(Vec,PetscInt,Vec*[]);
 PETSC_EXTERN PetscErrorCode VecDestroyVecs(PetscInt, Vec*[]);
 PETSC_EXTERN PetscErrorCode VecStrideNormAll(Vec,NormType,PetscReal[]);
 PETSC_EXTERN PetscErrorCode VecStrideMaxAll(Vec,PetscInt [],PetscReal []);
@@ -344,6 +345,8 @@ PETSC_EXTERN PetscErrorCode VecRegister(const char[],PetscErrorCode (*)(Vec));
 
 PETSC_EXTERN PetscErrorCode VecScatterBegin(VecScatter,Vec,Vec,InsertMode,ScatterMode);
 PETSC_EXTERN PetscErrorCode VecScatterEnd(VecScatter,Vec,Vec,InsertMode,ScatterMode);
+PETSC_EXTERN PetscErrorCode VecScatterBeginMultiple(VecScatter,PetscInt,Vec[],Vec[],InsertMode,ScatterMode);
+PETSC_EXTERN PetscErrorCode VecScatterEndMultiple(VecScatter,PetscInt,Vec[],Vec[],InsertMode,ScatterMode);
 PETSC_EXTERN PetscErrorCode VecScatterDestroy(VecScatter*);
 PETSC_EXTERN PetscErrorCode VecScatterSetUp(VecScatter);
 PETSC_EXTERN PetscErrorCode VecScatterCopy(VecScatter,VecScatter *);
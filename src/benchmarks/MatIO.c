@@ -0,0 +1,92 @@
+
+#include <petscmat.h>
+#include <petsctime.h>
+
+/*
+   Times MatView() and MatLoad() of a 3d Laplacian to a binary file, with and without MPI-IO.
+   The problem grows with the number of processes (-n is the grid points per process in each
+   direction) so running it on increasing numbers of processes shows the weak scaling of the
+   two IO paths.
+*/
+int main(int argc,char **argv)
+{
+  Mat            A,B;
+  PetscViewer    viewer;
+  PetscInt       n = 20,N,i,j,k,row,col[7],ncols,rstart,rend;
+  PetscScalar    v[7];
+  PetscLogDouble t1,t2,t3,tview,tload;
+  PetscMPIInt    size;
+  PetscBool      equal;
+  size_t         bytes;
+  MatInfo        info;
+  char           file[PETSC_MAX_PATH_LEN] = "MatIO.dat";
+  int            mpiio;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,0,0);if (ierr) return ierr;
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetString(NULL,NULL,"-f",file,sizeof(file),NULL);CHKERRQ(ierr);
+
+  /* n*n*n grid points per process, stacked in the z direction */
+  N    = n*n*n*size;
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,N,N);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATMPIAIJ);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,7,NULL,1,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (row=rstart; row<rend; row++) {
+    i = row % n; j = (row/n) % n; k = row/(n*n);
+    ncols = 0;
+    if (k > 0)          {col[ncols] = row - n*n; v[ncols++] = -1.0;}
+    if (j > 0)          {col[ncols] = row - n;   v[ncols++] = -1.0;}
+    if (i > 0)          {col[ncols] = row - 1;   v[ncols++] = -1.0;}
+    col[ncols] = row; v[ncols++] = 6.0;
+    if (i < n-1)        {col[ncols] = row + 1;   v[ncols++] = -1.0;}
+    if (j < n-1)        {col[ncols] = row + n;   v[ncols++] = -1.0;}
+    if (k < n*size-1)   {col[ncols] = row + n*n; v[ncols++] = -1.0;}
+    ierr = MatSetValues(A,1,&row,ncols,col,v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr  = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr  = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr  = MatGetInfo(A,MAT_GLOBAL_SUM,&info);CHKERRQ(ierr);
+  bytes = (4 + N)*sizeof(PetscInt) + (size_t)info.nz_used*(sizeof(PetscInt) + sizeof(PetscScalar));
+  ierr  = PetscPrintf(PETSC_COMM_WORLD,"MatView/MatLoad of %D rows and %D nonzeros on %d processes, %g MB\n",N,(PetscInt)info.nz_used,size,bytes/1048576.0);CHKERRQ(ierr);
+
+  for (mpiio=0; mpiio<2; mpiio++) {
+    ierr = MPI_Barrier(PETSC_COMM_WORLD);CHKERRQ(ierr);
+    ierr = PetscTime(&t1);CHKERRQ(ierr);
+    ierr = PetscViewerCreate(PETSC_COMM_WORLD,&viewer);CHKERRQ(ierr);
+    ierr = PetscViewerSetType(viewer,PETSCVIEWERBINARY);CHKERRQ(ierr);
+    ierr = PetscViewerBinarySkipInfo(viewer);CHKERRQ(ierr);
+    ierr = PetscViewerBinarySetUseMPIIO(viewer,(PetscBool)mpiio);CHKERRQ(ierr);
+    ierr = PetscViewerFileSetMode(viewer,FILE_MODE_WRITE);CHKERRQ(ierr);
+    ierr = PetscViewerFileSetName(viewer,file);CHKERRQ(ierr);
+    ierr = MatView(A,viewer);CHKERRQ(ierr);
+    ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
+    ierr = MPI_Barrier(PETSC_COMM_WORLD);CHKERRQ(ierr);
+    ierr = PetscTime(&t2);CHKERRQ(ierr);
+
+    ierr = PetscViewerCreate(PETSC_COMM_WORLD,&viewer);CHKERRQ(ierr);
+    ierr = PetscViewerSetType(viewer,PETSCVIEWERBINARY);CHKERRQ(ierr);
+    ierr = PetscViewerBinarySkipInfo(viewer);CHKERRQ(ierr);
+    ierr = PetscViewerBinarySetUseMPIIO(viewer,(PetscBool)mpiio);CHKERRQ(ierr);
+    ierr = PetscViewerFileSetMode(viewer,FILE_MODE_READ);CHKERRQ(ierr);
+    ierr = PetscViewerFileSetName(viewer,file);CHKERRQ(ierr);
+    ierr = MatCreate(PETSC_COMM_WORLD,&B);CHKERRQ(ierr);
+    ierr = MatSetType(B,MATMPIAIJ);CHKERRQ(ierr);
+    ierr = MatLoad(B,viewer);CHKERRQ(ierr);
+    ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
+    ierr = MPI_Barrier(PETSC_COMM_WORLD);CHKERRQ(ierr);
+    ierr = PetscTime(&t3);CHKERRQ(ierr);
+
+    ierr  = MatEqual(A,B,&equal);CHKERRQ(ierr);
+    if (!equal) SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_PLIB,"Loaded matrix differs from the one written");
+    ierr  = MatDestroy(&B);CHKERRQ(ierr);
+    tview = t2 - t1; tload = t3 - t2;
+    ierr  = PetscPrintf(PETSC_COMM_WORLD,"%-7s MatView %8.4f s %8.1f MB/s   MatLoad %8.4f s %8.1f MB/s\n",mpiio ? "MPI-IO" : "default",tview,bytes/1048576.0/tview,tload,bytes/1048576.0/tload);CHKERRQ(ierr);
+  }
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
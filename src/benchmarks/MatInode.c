@@ -0,0 +1,114 @@
+#include <petscmat.h>
+#include <petsctime.h>
+#include <../src/mat/impls/aij/seq/aij.h> /* Need Mat_SeqAIJ to ask if the vectorized inode kernels are in use */
+
+/*
+   Times MatMult(), MatMultAdd() and MatSOR() of a SeqAIJ matrix with the structure of 3d linear elasticity on
+   hexahedral elements: 3 unknowns per vertex coupled to the 3 unknowns of its 27 neighbours, so the rows form
+   inodes of size 3 with 81 nonzeros. It compares the plain AIJ kernels (-mat_no_inode), the unrolled scalar inode
+   kernels and, when PETSc is compiled with AVX2 or AVX-512 (for example COPTFLAGS=-march=native), the vectorized
+   inode kernels. -n is the number of vertices in each direction.
+*/
+static PetscErrorCode CreateElasticity(PetscInt n,PetscBool inode,PetscBool simd,Mat *A)
+{
+  PetscInt       N = n*n*n,i,j,k,di,dj,dk,p,q,row,ncols,cols[81];
+  PetscScalar    v[81];
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = PetscOptionsSetValue(NULL,"-mat_inode_simd",simd ? "true" : "false");CHKERRQ(ierr);
+  ierr = MatCreate(PETSC_COMM_SELF,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,3*N,3*N,3*N,3*N);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(*A,81,NULL);CHKERRQ(ierr);
+  ierr = MatSetOption(*A,MAT_USE_INODES,inode);CHKERRQ(ierr);
+  ierr = PetscOptionsClearValue(NULL,"-mat_inode_simd");CHKERRQ(ierr);
+  for (k=0; k<n; k++) for (j=0; j<n; j++) for (i=0; i<n; i++) {
+    for (p=0; p<3; p++) {
+      row   = 3*(i + n*(j + n*k)) + p;
+      ncols = 0;
+      for (dk=PetscMax(k-1,0); dk<=PetscMin(k+1,n-1); dk++) for (dj=PetscMax(j-1,0); dj<=PetscMin(j+1,n-1); dj++) for (di=PetscMax(i-1,0); di<=PetscMin(i+1,n-1); di++) {
+        for (q=0; q<3; q++) {
+          cols[ncols] = 3*(di + n*(dj + n*dk)) + q;
+          if (cols[ncols]/3 == row/3) v[ncols] = (p == q) ? 32.0 : 1.0;
+          else                        v[ncols] = (p == q) ? -1.0 : -0.1*(p+q);
+          ncols++;
+        }
+      }
+      ierr = MatSetValues(*A,1,&row,ncols,cols,v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Mat            A;
+  Vec            x,y,z,r[3],ref[3];
+  PetscInt       n = 24,nits = 20,it,v,k;
+  PetscLogDouble t0,t1,t[3];
+  PetscReal      err,norm;
+  const char     *variants[] = {"no inode","inode","inode simd"};
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,0,0);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nits",&nits,NULL);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_SELF,"%-12s %14s %14s %14s\n","","MatMult","MatMultAdd","MatSOR");CHKERRQ(ierr);
+  for (v=0; v<3; v++) {
+    ierr = CreateElasticity(n,(PetscBool)(v > 0),(PetscBool)(v > 1),&A);CHKERRQ(ierr);
+    if (v == 2 && !((Mat_SeqAIJ*)A->data)->inode.simd) {
+      ierr = PetscPrintf(PETSC_COMM_SELF,"PETSc was not compiled with the AVX2 or AVX-512 inode kernels, inode simd is the same as inode\n");CHKERRQ(ierr);
+    }
+    ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+    ierr = VecDuplicate(x,&z);CHKERRQ(ierr);
+    ierr = VecSetRandom(x,NULL);CHKERRQ(ierr);
+    ierr = VecSet(y,0.0);CHKERRQ(ierr);
+    ierr = VecSet(z,1.0);CHKERRQ(ierr);
+    for (k=0; k<3; k++) {ierr = VecDuplicate(x,&r[k]);CHKERRQ(ierr);}
+
+    ierr = MatMult(A,x,r[0]);CHKERRQ(ierr);
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    for (it=0; it<nits; it++) {ierr = MatMult(A,x,y);CHKERRQ(ierr);}
+    ierr = PetscTime(&t1);CHKERRQ(ierr);
+    t[0] = (t1 - t0)/nits;
+
+    ierr = MatMultAdd(A,x,z,r[1]);CHKERRQ(ierr);
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    for (it=0; it<nits; it++) {ierr = MatMultAdd(A,x,z,y);CHKERRQ(ierr);}
+    ierr = PetscTime(&t1);CHKERRQ(ierr);
+    t[1] = (t1 - t0)/nits;
+
+    /* symmetric Gauss-Seidel as a multigrid smoother would apply it */
+    ierr = VecSet(r[2],0.0);CHKERRQ(ierr);
+    ierr = MatSOR(A,x,1.0,SOR_SYMMETRIC_SWEEP,0.0,2,1,r[2]);CHKERRQ(ierr);
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    for (it=0; it<nits; it++) {ierr = MatSOR(A,x,1.0,SOR_SYMMETRIC_SWEEP,0.0,2,1,y);CHKERRQ(ierr);}
+    ierr = PetscTime(&t1);CHKERRQ(ierr);
+    t[2] = (t1 - t0)/nits;
+
+    /* the inode MatSOR() is block Gauss-Seidel with the 3x3 diagonal blocks, it is checked against the first inode run */
+    for (k=0; k<3; k++) {
+      if (!v || (k == 2 && v == 1)) {
+        if (v) {ierr = VecDestroy(&ref[k]);CHKERRQ(ierr);}
+        ref[k] = r[k];
+        continue;
+      }
+      ierr = VecNorm(ref[k],NORM_2,&norm);CHKERRQ(ierr);
+      ierr = VecAXPY(r[k],-1.0,ref[k]);CHKERRQ(ierr);
+      ierr = VecNorm(r[k],NORM_2,&err);CHKERRQ(ierr);
+      if (err > 1.e-12*norm) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Result %D of %s differs from the reference by %g",k,variants[v],(double)(err/norm));
+      ierr = VecDestroy(&r[k]);CHKERRQ(ierr);
+    }
+    ierr = PetscPrintf(PETSC_COMM_SELF,"%-12s %12.3e s %12.3e s %12.3e s\n",variants[v],t[0],t[1],t[2]);CHKERRQ(ierr);
+    ierr = VecDestroy(&x);CHKERRQ(ierr);
+    ierr = VecDestroy(&y);CHKERRQ(ierr);
+    ierr = VecDestroy(&z);CHKERRQ(ierr);
+    ierr = MatDestroy(&A);CHKERRQ(ierr);
+  }
+  for (k=0; k<3; k++) {ierr = VecDestroy(&ref[k]);CHKERRQ(ierr);}
+  ierr = PetscFinalize();
+  return ierr;
+}
@@ -0,0 +1,126 @@
+#include <petscmat.h>
+#include <petsctime.h>
+
+/*
+   Times the SeqAIJ MatMatMult() algorithms selected with -matmatmult_via on the products that GAMG forms: A*P and
+   the Galerkin product P^T*A*P, where A is a 3d 7-point Laplacian on an n*n*n grid and P is a smoothed aggregation
+   interpolation (2x2x2 aggregates, one Jacobi smoothing step). MatPtAP() of SeqAIJ matrices computes P^T*(A*P)
+   with two MatMatMult(), so both products use the algorithm being timed. Every product is checked against the one
+   of the first algorithm.
+*/
+static PetscErrorCode TimeProducts(Mat A,Mat P,const char *alg,Mat *AP,Mat *PtAP,PetscLogDouble t[])
+{
+  PetscLogDouble t0,t1;
+  PetscInt       r,nreuse = 5;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = PetscOptionsSetValue(NULL,"-matmatmult_via",alg);CHKERRQ(ierr);
+  ierr = PetscTime(&t0);CHKERRQ(ierr);
+  ierr = MatMatMult(A,P,MAT_INITIAL_MATRIX,PETSC_DEFAULT,AP);CHKERRQ(ierr);
+  ierr = PetscTime(&t1);CHKERRQ(ierr);
+  t[0] = t1 - t0;
+  for (r=0; r<nreuse; r++) {ierr = MatMatMult(A,P,MAT_REUSE_MATRIX,PETSC_DEFAULT,AP);CHKERRQ(ierr);}
+  ierr = PetscTime(&t0);CHKERRQ(ierr);
+  t[1] = (t0 - t1)/nreuse;
+  ierr = MatPtAP(A,P,MAT_INITIAL_MATRIX,PETSC_DEFAULT,PtAP);CHKERRQ(ierr);
+  ierr = PetscTime(&t1);CHKERRQ(ierr);
+  t[2] = t1 - t0;
+  for (r=0; r<nreuse; r++) {ierr = MatPtAP(A,P,MAT_REUSE_MATRIX,PETSC_DEFAULT,PtAP);CHKERRQ(ierr);}
+  ierr = PetscTime(&t0);CHKERRQ(ierr);
+  t[3] = (t0 - t1)/nreuse;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode Difference(Mat X,Mat Y,PetscReal *diff)
+{
+  Mat            D;
+  PetscReal      norm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr  = MatDuplicate(X,MAT_COPY_VALUES,&D);CHKERRQ(ierr);
+  ierr  = MatAXPY(D,-1.0,Y,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
+  ierr  = MatNorm(D,NORM_FROBENIUS,diff);CHKERRQ(ierr);
+  ierr  = MatNorm(X,NORM_FROBENIUS,&norm);CHKERRQ(ierr);
+  *diff = *diff/norm;
+  ierr  = MatDestroy(&D);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Mat            A,P0,P,AP[2],PtAP[2],Dinv;
+  Vec            d;
+  PetscInt       n = 32,nc,N,Nc,i,j,k,row,col[7],ncols,a,alg;
+  PetscScalar    v[7],one = 1.0;
+  PetscLogDouble t[4] = {0};
+  PetscReal      diffAP,diffPtAP;
+  MatInfo        info;
+  const char     *algs[] = {"scalable","heap","btheap","hash"};
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,0,0);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  nc   = (n+1)/2;
+  N    = n*n*n;
+  Nc   = nc*nc*nc;
+
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,N,N,7,NULL,&A);CHKERRQ(ierr);
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,N,Nc,1,NULL,&P0);CHKERRQ(ierr);
+  for (row=0; row<N; row++) {
+    i = row % n; j = (row/n) % n; k = row/(n*n);
+    ncols = 0;
+    if (k > 0)   {col[ncols] = row - n*n; v[ncols++] = -1.0;}
+    if (j > 0)   {col[ncols] = row - n;   v[ncols++] = -1.0;}
+    if (i > 0)   {col[ncols] = row - 1;   v[ncols++] = -1.0;}
+    col[ncols] = row; v[ncols++] = 6.0;
+    if (i < n-1) {col[ncols] = row + 1;   v[ncols++] = -1.0;}
+    if (j < n-1) {col[ncols] = row + n;   v[ncols++] = -1.0;}
+    if (k < n-1) {col[ncols] = row + n*n; v[ncols++] = -1.0;}
+    ierr = MatSetValues(A,1,&row,ncols,col,v,INSERT_VALUES);CHKERRQ(ierr);
+    a    = i/2 + nc*(j/2) + nc*nc*(k/2);
+    ierr = MatSetValues(P0,1,&row,1,&a,&one,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(P0,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(P0,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  /* P = (I - 2/3 D^{-1} A) P0 */
+  ierr = MatCreateVecs(A,&d,NULL);CHKERRQ(ierr);
+  ierr = MatGetDiagonal(A,d);CHKERRQ(ierr);
+  ierr = VecReciprocal(d);CHKERRQ(ierr);
+  ierr = VecScale(d,-2.0/3.0);CHKERRQ(ierr);
+  ierr = MatDuplicate(A,MAT_COPY_VALUES,&Dinv);CHKERRQ(ierr);
+  ierr = MatDiagonalScale(Dinv,d,NULL);CHKERRQ(ierr);
+  ierr = MatShift(Dinv,1.0);CHKERRQ(ierr);
+  ierr = MatMatMult(Dinv,P0,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&P);CHKERRQ(ierr);
+  ierr = MatDestroy(&Dinv);CHKERRQ(ierr);
+  ierr = MatDestroy(&P0);CHKERRQ(ierr);
+  ierr = VecDestroy(&d);CHKERRQ(ierr);
+
+  ierr = MatGetInfo(P,MAT_LOCAL,&info);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_SELF,"A %D x %D, P %D x %D with %D nonzeros\n",N,N,N,Nc,(PetscInt)info.nz_used);CHKERRQ(ierr);
+  /* untimed product, so that the first algorithm does not pay for page faults */
+  ierr = MatMatMult(A,P,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&AP[0]);CHKERRQ(ierr);
+  ierr = MatDestroy(&AP[0]);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_SELF,"%-9s %12s %12s %12s %12s\n","","AP initial","AP reuse","PtAP initial","PtAP reuse");CHKERRQ(ierr);
+  for (alg=0; alg<4; alg++) {
+    ierr = TimeProducts(A,P,algs[alg],&AP[alg ? 1 : 0],&PtAP[alg ? 1 : 0],t);CHKERRQ(ierr);
+    if (alg) {
+      ierr = Difference(AP[0],AP[1],&diffAP);CHKERRQ(ierr);
+      ierr = Difference(PtAP[0],PtAP[1],&diffPtAP);CHKERRQ(ierr);
+      if (diffAP > 1.e-12 || diffPtAP > 1.e-12) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Products with %s differ from the first ones by %g and %g",algs[alg],(double)diffAP,(double)diffPtAP);
+      ierr = MatDestroy(&AP[1]);CHKERRQ(ierr);
+      ierr = MatDestroy(&PtAP[1]);CHKERRQ(ierr);
+    }
+    ierr = PetscPrintf(PETSC_COMM_SELF,"%-9s %10.4f s %10.4f s %10.4f s %10.4f s\n",algs[alg],t[0],t[1],t[2],t[3]);CHKERRQ(ierr);
+  }
+  ierr = MatDestroy(&AP[0]);CHKERRQ(ierr);
+  ierr = MatDestroy(&PtAP[0]);CHKERRQ(ierr);
+  ierr = MatDestroy(&P);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
@@ -0,0 +1,121 @@
+#include <petscmat.h>
+#include <petsctime.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+/*
+   Times MatSolve() of ILU(0) and ILU(1) factors of a 3d 7-point Poisson and a 3d convection-diffusion matrix on an
+   n*n*n grid, in the natural ordering, sequentially and with the level sets of -mat_factor_solve_levels for the
+   thread counts of -threads. The level sets of the 7-point stencil are the planes i+j+k = const, so there are
+   3n-2 levels of up to about 3n^2/4 rows; ILU(1) has twice as many levels. With one thread the factor with the
+   level sets falls back to the sequential solve. Every solve is checked against the sequential one.
+*/
+static PetscErrorCode CreateMatrix(PetscInt n,PetscReal beta,Mat *A)
+{
+  PetscInt       N = n*n*n,row,i,j,k,ncols,cols[7];
+  PetscScalar    vals[7],c = 0.5*beta/n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,N,N,7,NULL,A);CHKERRQ(ierr);
+  for (row=0; row<N; row++) {
+    i = row%n; j = (row/n)%n; k = row/(n*n);
+    ncols = 0;
+    if (k > 0)   {cols[ncols] = row-n*n; vals[ncols++] = -1.0 - c;}
+    if (j > 0)   {cols[ncols] = row-n;   vals[ncols++] = -1.0 - c;}
+    if (i > 0)   {cols[ncols] = row-1;   vals[ncols++] = -1.0 - c;}
+    cols[ncols] = row; vals[ncols++] = 6.0;
+    if (i < n-1) {cols[ncols] = row+1;   vals[ncols++] = -1.0 + c;}
+    if (j < n-1) {cols[ncols] = row+n;   vals[ncols++] = -1.0 + c;}
+    if (k < n-1) {cols[ncols] = row+n*n; vals[ncols++] = -1.0 + c;}
+    ierr = MatSetValues(*A,1,&row,ncols,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode Factor(Mat A,PetscInt levels,PetscBool solvelevels,Mat *F)
+{
+  MatFactorInfo  info;
+  IS             row,col;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = PetscOptionsSetValue(NULL,"-mat_factor_solve_levels",solvelevels ? "1" : "0");CHKERRQ(ierr);
+  ierr = MatGetFactor(A,MATSOLVERPETSC,MAT_FACTOR_ILU,F);CHKERRQ(ierr);
+  ierr = MatGetOrdering(A,MATORDERINGNATURAL,&row,&col);CHKERRQ(ierr);
+  ierr = MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+  info.levels = levels;
+  info.fill   = 3.0;
+  ierr = MatILUFactorSymbolic(*F,A,row,col,&info);CHKERRQ(ierr);
+  ierr = MatLUFactorNumeric(*F,A,&info);CHKERRQ(ierr);
+  ierr = ISDestroy(&row);CHKERRQ(ierr);
+  ierr = ISDestroy(&col);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Mat            A,F0,F1;
+  Vec            b,x0,x1;
+  PetscInt       n = 40,nits = 20,it,p,lev,t,nthreads[16],nt = 16;
+  PetscLogDouble t0,t1,tseq;
+  PetscReal      err,beta[2] = {0.0,20.0};
+  PetscBool      flg;
+  const char     *problems[2] = {"Poisson","conv-diff"};
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,0,0);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nits",&nits,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetIntArray(NULL,NULL,"-threads",nthreads,&nt,&flg);CHKERRQ(ierr);
+  if (!flg) {nthreads[0] = 1; nthreads[1] = 2; nthreads[2] = 4; nt = 3;}
+#if !defined(PETSC_HAVE_OPENMP)
+  ierr = PetscPrintf(PETSC_COMM_SELF,"Not configured with OpenMP, the solves with the level sets are sequential\n");CHKERRQ(ierr);
+  nthreads[0] = 1; nt = 1;
+#endif
+
+  ierr = PetscPrintf(PETSC_COMM_SELF,"MatSolve() on a %D^3 grid, time per solve\n",n);CHKERRQ(ierr);
+  for (p=0; p<2; p++) {
+    ierr = CreateMatrix(n,beta[p],&A);CHKERRQ(ierr);
+    ierr = MatCreateVecs(A,&x0,&b);CHKERRQ(ierr);
+    ierr = VecDuplicate(x0,&x1);CHKERRQ(ierr);
+    ierr = VecSetRandom(b,NULL);CHKERRQ(ierr);
+    for (lev=0; lev<2; lev++) {
+      ierr = Factor(A,lev,PETSC_FALSE,&F0);CHKERRQ(ierr);
+      ierr = Factor(A,lev,PETSC_TRUE,&F1);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP)
+      omp_set_num_threads(1);
+#endif
+      ierr = MatSolve(F0,b,x0);CHKERRQ(ierr);
+      ierr = PetscTime(&t0);CHKERRQ(ierr);
+      for (it=0; it<nits; it++) {ierr = MatSolve(F0,b,x0);CHKERRQ(ierr);}
+      ierr = PetscTime(&t1);CHKERRQ(ierr);
+      tseq = (t1 - t0)/nits;
+      ierr = PetscPrintf(PETSC_COMM_SELF,"%-10s ILU(%D) sequential       %10.3e s\n",problems[p],lev,tseq);CHKERRQ(ierr);
+      for (t=0; t<nt; t++) {
+#if defined(PETSC_HAVE_OPENMP)
+        omp_set_num_threads((int)nthreads[t]);
+#endif
+        ierr = MatSolve(F1,b,x1);CHKERRQ(ierr);
+        ierr = PetscTime(&t0);CHKERRQ(ierr);
+        for (it=0; it<nits; it++) {ierr = MatSolve(F1,b,x1);CHKERRQ(ierr);}
+        ierr = PetscTime(&t1);CHKERRQ(ierr);
+        ierr = VecAXPY(x1,-1.0,x0);CHKERRQ(ierr);
+        ierr = VecNorm(x1,NORM_INFINITY,&err);CHKERRQ(ierr);
+        if (err > 1.e-10) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Solve with %D threads differs by %g",nthreads[t],(double)err);
+        ierr = PetscPrintf(PETSC_COMM_SELF,"%-10s ILU(%D) levels %2D threads %10.3e s speedup %5.2f\n",problems[p],lev,nthreads[t],(t1 - t0)/nits,tseq*nits/(t1 - t0));CHKERRQ(ierr);
+      }
+      ierr = MatDestroy(&F0);CHKERRQ(ierr);
+      ierr = MatDestroy(&F1);CHKERRQ(ierr);
+    }
+    ierr = VecDestroy(&x0);CHKERRQ(ierr);
+    ierr = VecDestroy(&x1);CHKERRQ(ierr);
+    ierr = VecDestroy(&b);CHKERRQ(ierr);
+    ierr = MatDestroy(&A);CHKERRQ(ierr);
+  }
+  ierr = PetscFinalize();
+  return ierr;
+}
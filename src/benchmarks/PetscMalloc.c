@@ -4,9 +4,9 @@
 
 int main(int argc,char **argv)
 {
-  PetscLogDouble x,y;
+  PetscLogDouble x,y,z,w;
   double         value;
-  void           *arr[1000],*dummy;
+  void           *arr[1000],*dummy,*big;
   int            i,rand1[1000],rand2[1000];
   PetscErrorCode ierr;
   PetscRandom    r;
@@ -49,10 +49,22 @@ int main(int argc,char **argv)
     ierr = PetscFree(arr[i]);CHKERRQ(ierr);
   }
 
+  /* Create and destroy a large array repeatedly, as a work vector in a time stepping loop would be */
+  ierr = PetscTime(&z);CHKERRQ(ierr);
+  for (i=0; i<100; i++) {
+    ierr = PetscMalloc(8388608,&big);CHKERRQ(ierr);
+    ierr = PetscMemzero(big,8388608);CHKERRQ(ierr);
+    ierr = PetscFree(big);CHKERRQ(ierr);
+  }
+  ierr = PetscTime(&w);CHKERRQ(ierr);
+
   fprintf(stdout,"%-15s : %e sec, with options : ","PetscMalloc",(y-x)/500.0);
-  ierr = PetscOptionsHasName(NULL,"-malloc",&flg);CHKERRQ(ierr);
+  ierr = PetscOptionsHasName(NULL,NULL,"-malloc",&flg);CHKERRQ(ierr);
   if (flg) fprintf(stdout,"-malloc ");
+  ierr = PetscOptionsHasName(NULL,NULL,"-malloc_pool",&flg);CHKERRQ(ierr);
+  if (flg) fprintf(stdout,"-malloc_pool ");
   fprintf(stdout,"\n");
+  fprintf(stdout,"%-15s : %e sec\n","PetscMalloc 8MB",(w-z)/100.0);
 
   ierr = PetscRandomDestroy(&r);CHKERRQ(ierr);
   ierr = PetscFinalize();
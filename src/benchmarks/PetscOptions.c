@@ -0,0 +1,58 @@
+#include <petscsys.h>
+#include <petsctime.h>
+
+/*
+   Times the options database with a large number of deeply prefixed options, as set up by
+   a solver with fieldsplit inside multigrid levels. -n is the number of options. Each option
+   is inserted and then looked up as XXXSetFromOptions() would, together with a lookup of an
+   option that is not in the database, the most common case. Insertions interleaved with
+   lookups is what happens when the solver sets options for its subsolvers during setup.
+*/
+int main(int argc,char **argv)
+{
+  PetscOptions   options;
+  PetscInt       n = 2000,nlevels = 10,i,found = 0;
+  PetscLogDouble t1,t2,t3,t4;
+  char           (*name)[64],(*pre)[32],(*key)[32];
+  const char     *v;
+  PetscBool      set;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,0,0);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscMalloc3(n,&name,n,&pre,n,&key);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    ierr = PetscSNPrintf(pre[i],sizeof(pre[i]),"mg_levels_%D_fieldsplit_%D_",i%nlevels,(i/nlevels)%4);CHKERRQ(ierr);
+    ierr = PetscSNPrintf(key[i],sizeof(key[i]),"-ksp_opt%D",i);CHKERRQ(ierr);
+    ierr = PetscSNPrintf(name[i],sizeof(name[i]),"-%s%s",pre[i],key[i]+1);CHKERRQ(ierr);
+  }
+  ierr = PetscOptionsCreate(&options);CHKERRQ(ierr);
+
+  ierr = PetscTime(&t1);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    ierr = PetscOptionsSetValue(options,name[i],"1");CHKERRQ(ierr);
+    ierr = PetscOptionsFindPair(options,pre[i],key[i],&v,&set);CHKERRQ(ierr);
+    if (set) found++;
+    ierr = PetscOptionsFindPair(options,pre[i],"-ksp_missing",&v,&set);CHKERRQ(ierr);
+    if (set) found++;
+  }
+  ierr = PetscTime(&t2);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    ierr = PetscOptionsFindPair(options,pre[i],key[i],&v,&set);CHKERRQ(ierr);
+    if (set) found++;
+    ierr = PetscOptionsFindPair(options,pre[i],"-ksp_missing",&v,&set);CHKERRQ(ierr);
+    if (set) found++;
+  }
+  ierr = PetscTime(&t3);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    ierr = PetscOptionsClearValue(options,name[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscTime(&t4);CHKERRQ(ierr);
+  if (found != 2*n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Found %D options, expected %D",found,2*n);
+
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%D options: setup %g us, lookup %g us, remove %g us per option\n",n,1.e6*(t2-t1)/n,1.e6*(t3-t2)/n,1.e6*(t4-t3)/n);CHKERRQ(ierr);
+  ierr = PetscOptionsDestroy(&options);CHKERRQ(ierr);
+  ierr = PetscFree3(name,pre,key);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
@@ -0,0 +1,108 @@
+static char help[] = "Tests the Jacobian action of a PetscFE against its element matrices.\n\n";
+
+#include <petscdmplex.h>
+#include <petscdmfield.h>
+#include <petscds.h>
+
+static void g0_uu(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                  const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                  const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                  PetscReal t, PetscReal u_tShift, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar g0[])
+{
+  g0[0] = 1.0 + u[0]*u[0];
+}
+
+static void g3_uu(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                  const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                  const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                  PetscReal t, PetscReal u_tShift, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar g3[])
+{
+  PetscInt d;
+  for (d = 0; d < dim; ++d) g3[d*dim+d] = 1.0;
+}
+
+int main(int argc, char **argv)
+{
+  DM              dm;
+  DMField         coordField;
+  PetscDS         ds;
+  PetscFE         fe;
+  PetscQuadrature quad;
+  PetscFEGeom    *geom;
+  IS              cellIS;
+  PetscScalar    *u, *y, *elemMat, *elemVec;
+  PetscReal       err = 0.0, nrm = 0.0;
+  PetscInt        dim = 2, cStart, cEnd, Ne, totDim, e, i, j;
+  PetscBool       embedded = PETSC_FALSE;
+  PetscErrorCode  ierr;
+
+  ierr = PetscInitialize(&argc, &argv, NULL, help);if (ierr) return ierr;
+  ierr = PetscOptionsBegin(PETSC_COMM_WORLD, "", "Jacobian Action Test Options", "PETSCFE");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-dim", "The topological dimension", "ex7.c", dim, &dim, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-embedded", "Use the surface of a cube, whose cells are embedded in a higher dimension", "ex7.c", embedded, &embedded, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();
+
+  if (embedded) {ierr = DMPlexCreateSphereMesh(PETSC_COMM_SELF, dim, PETSC_FALSE, &dm);CHKERRQ(ierr);}
+  else          {ierr = DMPlexCreateBoxMesh(PETSC_COMM_SELF, dim, PETSC_FALSE, NULL, NULL, NULL, NULL, PETSC_TRUE, &dm);CHKERRQ(ierr);}
+  ierr = PetscFECreateDefault(PETSC_COMM_SELF, dim, 1, PETSC_FALSE, NULL, -1, &fe);CHKERRQ(ierr);
+  ierr = DMSetField(dm, 0, NULL, (PetscObject) fe);CHKERRQ(ierr);
+  ierr = DMCreateDS(dm);CHKERRQ(ierr);
+  ierr = DMGetDS(dm, &ds);CHKERRQ(ierr);
+  ierr = PetscDSSetJacobian(ds, 0, 0, g0_uu, NULL, NULL, g3_uu);CHKERRQ(ierr);
+  ierr = PetscDSSetUp(ds);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalDimension(ds, &totDim);CHKERRQ(ierr);
+
+  ierr = DMPlexGetHeightStratum(dm, 0, &cStart, &cEnd);CHKERRQ(ierr);
+  Ne   = cEnd - cStart;
+  ierr = ISCreateStride(PETSC_COMM_SELF, Ne, cStart, 1, &cellIS);CHKERRQ(ierr);
+  ierr = DMGetCoordinateField(dm, &coordField);CHKERRQ(ierr);
+  ierr = PetscFEGetQuadrature(fe, &quad);CHKERRQ(ierr);
+  ierr = DMFieldCreateFEGeom(coordField, cellIS, quad, PETSC_FALSE, &geom);CHKERRQ(ierr);
+
+  ierr = PetscMalloc4(Ne*totDim, &u, Ne*totDim, &y, Ne*totDim*totDim, &elemMat, Ne*totDim, &elemVec);CHKERRQ(ierr);
+  for (i = 0; i < Ne*totDim; ++i) {
+    u[i] = PetscSinReal(0.5*i);
+    y[i] = PetscCosReal(0.3*i);
+  }
+  ierr = PetscMemzero(elemMat, Ne*totDim*totDim * sizeof(PetscScalar));CHKERRQ(ierr);
+  ierr = PetscMemzero(elemVec, Ne*totDim * sizeof(PetscScalar));CHKERRQ(ierr);
+  ierr = PetscFEIntegrateJacobian(ds, PETSCFE_JACOBIAN, 0, 0, Ne, geom, u, NULL, NULL, NULL, 0.0, 0.0, elemMat);CHKERRQ(ierr);
+  ierr = PetscFEIntegrateJacobianAction(ds, PETSCFE_JACOBIAN, 0, 0, Ne, geom, u, NULL, NULL, NULL, 0.0, 0.0, y, elemVec);CHKERRQ(ierr);
+  for (e = 0; e < Ne; ++e) {
+    for (i = 0; i < totDim; ++i) {
+      PetscScalar Ay = 0.0;
+
+      for (j = 0; j < totDim; ++j) Ay += elemMat[(e*totDim+i)*totDim+j]*y[e*totDim+j];
+      err = PetscMax(err, PetscAbsScalar(Ay - elemVec[e*totDim+i]));
+      nrm = PetscMax(nrm, PetscAbsScalar(Ay));
+    }
+  }
+  ierr = PetscPrintf(PETSC_COMM_SELF, "Jacobian action matches the element matrices: %s\n", err <= 100*PETSC_SMALL*nrm ? "yes" : "no");CHKERRQ(ierr);
+
+  ierr = PetscFree4(u, y, elemMat, elemVec);CHKERRQ(ierr);
+  ierr = PetscFEGeomDestroy(&geom);CHKERRQ(ierr);
+  ierr = ISDestroy(&cellIS);CHKERRQ(ierr);
+  ierr = PetscFEDestroy(&fe);CHKERRQ(ierr);
+  ierr = DMDestroy(&dm);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+  # The sum factorization on flat cells
+  test:
+    suffix: sumfact
+    args: -petscspace_degree {{1 3}separate output} -petscfe_type sumfact
+
+  test:
+    suffix: sumfact_3d
+    args: -dim 3 -petscspace_degree 2 -petscfe_type sumfact
+
+  # Cells embedded in a higher dimension fall back to the element matrices
+  test:
+    suffix: sumfact_embedded
+    args: -embedded -petscspace_degree 2 -petscfe_type sumfact -info
+    filter: grep -E "Unsupported geometry|Jacobian action"
+
+TEST*/
@@ -0,0 +1,765 @@
+#include <petsc/private/petscfeimpl.h> /*I "petscfe.h" I*/
+
+/*
+  The sum factorization implementation shares the setup, tabulation and Jacobian assembly with PETSCFEBASIC. When the
+  basis is a tensor product of one dimensional Lagrange polynomials and the quadrature is a tensor product of one
+  dimensional rules, the volume residual and the Jacobian action interpolate to the quadrature points, and integrate
+  against the test functions, one direction at a time. This costs O(p^{d+1}) per cell instead of the O(p^{2d}) of the
+  contraction with the full tabulation.
+*/
+PETSC_EXTERN PetscErrorCode PetscFESetUp_Basic(PetscFE);
+PETSC_EXTERN PetscErrorCode PetscFEGetTabulation_Basic(PetscFE, PetscInt, const PetscReal [], PetscReal *, PetscReal *, PetscReal *);
+PETSC_EXTERN PetscErrorCode PetscFEIntegrate_Basic(PetscDS, PetscInt, PetscInt, PetscFEGeom *, const PetscScalar [], PetscDS, const PetscScalar [], PetscScalar []);
+PETSC_EXTERN PetscErrorCode PetscFEIntegrateBd_Basic(PetscDS, PetscInt, PetscBdPointFunc, PetscInt, PetscFEGeom *, const PetscScalar [], PetscDS, const PetscScalar [], PetscScalar []);
+PETSC_EXTERN PetscErrorCode PetscFEIntegrateBdJacobian_Basic(PetscDS, PetscInt, PetscInt, PetscInt, PetscFEGeom *, const PetscScalar [], const PetscScalar [], PetscDS, const PetscScalar [], PetscReal, PetscReal, PetscScalar []);
+
+static PetscErrorCode PetscFESumFactReset_Private(PetscFE fem)
+{
+  PetscFE_SumFact *sf = (PetscFE_SumFact *) fem->data;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree4(sf->B1, sf->D1, sf->bperm, sf->qperm);CHKERRQ(ierr);
+  ierr = PetscQuadratureDestroy(&sf->quad);CHKERRQ(ierr);
+  sf->tensor = PETSC_FALSE;
+  sf->Nb1    = 0;
+  sf->Nq1    = 0;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscFEDestroy_SumFact(PetscFE fem)
+{
+  PetscFE_SumFact *sf = (PetscFE_SumFact *) fem->data;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFESumFactReset_Private(fem);CHKERRQ(ierr);
+  ierr = PetscFree(sf->work);CHKERRQ(ierr);
+  ierr = PetscFree(sf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscFEView_SumFact_Ascii(PetscFE fe, PetscViewer v)
+{
+  PetscFE_SumFact *sf = (PetscFE_SumFact *) fe->data;
+  PetscInt         dim, Nc;
+  PetscSpace       basis = NULL;
+  PetscDualSpace   dual = NULL;
+  PetscQuadrature  quad = NULL;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFEGetSpatialDimension(fe, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetNumComponents(fe, &Nc);CHKERRQ(ierr);
+  ierr = PetscFEGetBasisSpace(fe, &basis);CHKERRQ(ierr);
+  ierr = PetscFEGetDualSpace(fe, &dual);CHKERRQ(ierr);
+  ierr = PetscFEGetQuadrature(fe, &quad);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPushTab(v);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(v, "Sum Factorization Finite Element in %D dimensions with %D components\n",dim,Nc);CHKERRQ(ierr);
+  if (sf->tensor) {ierr = PetscViewerASCIIPrintf(v, "  tensor product of %D basis functions and %D quadrature points in each direction\n",sf->Nb1,sf->Nq1);CHKERRQ(ierr);}
+  if (basis) {ierr = PetscSpaceView(basis, v);CHKERRQ(ierr);}
+  if (dual)  {ierr = PetscDualSpaceView(dual, v);CHKERRQ(ierr);}
+  if (quad)  {ierr = PetscQuadratureView(quad, v);CHKERRQ(ierr);}
+  ierr = PetscViewerASCIIPopTab(v);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscFEView_SumFact(PetscFE fe, PetscViewer v)
+{
+  PetscBool      iascii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject) v, PETSCVIEWERASCII, &iascii);CHKERRQ(ierr);
+  if (iascii) {ierr = PetscFEView_SumFact_Ascii(fe, v);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/* Collect the sorted distinct coordinates of n points */
+static PetscErrorCode PetscFESumFactGetNodes_Private(PetscInt n, PetscInt dim, const PetscReal points[], PetscReal nodes[], PetscInt *Nn)
+{
+  PetscInt       i, j;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *Nn = 0;
+  for (i = 0; i < n*dim; ++i) {
+    for (j = 0; j < *Nn; ++j) if (PetscAbsReal(points[i] - nodes[j]) < PETSC_SQRT_MACHINE_EPSILON) break;
+    if (j == *Nn) nodes[(*Nn)++] = points[i];
+  }
+  ierr = PetscSortReal(*Nn, nodes);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* The lexicographic index of a point on the tensor grid of nodes, with the first coordinate varying slowest */
+static PetscInt PetscFESumFactLexIndex_Private(PetscInt dim, const PetscReal x[], PetscInt Nn, const PetscReal nodes[])
+{
+  PetscInt d, j, idx = 0;
+
+  for (d = 0; d < dim; ++d) {
+    for (j = 0; j < Nn; ++j) if (PetscAbsReal(x[d] - nodes[j]) < PETSC_SQRT_MACHINE_EPSILON) break;
+    idx = idx*Nn + j;
+  }
+  return idx;
+}
+
+/*
+  Factor the basis and quadrature into one dimensional pieces. The basis functions must be dual to point evaluations of
+  a single component on a tensor grid of nodes, and the quadrature points must lie on a tensor grid. The factors are
+  checked against the full tabulation, so any basis which is not the tensor product of one dimensional Lagrange
+  polynomials on these nodes is integrated with the full tabulation instead.
+*/
+static PetscErrorCode PetscFESumFactSetUpTensor_Private(PetscFE fem)
+{
+  PetscFE_SumFact *sf = (PetscFE_SumFact *) fem->data;
+  PetscDualSpace   dual;
+  PetscQuadrature  quad;
+  const PetscReal *qpoints;
+  PetscReal       *B, *D, *qnodes, *bnodes, *bpoints, tol = PETSC_SQRT_MACHINE_EPSILON;
+  PetscInt        *comp, *blex;
+  PetscInt         dim, Nc, Nb, Nq, qNc, Nb1 = 0, Nq1 = 0, N = 1, i, j, b, c, d, q;
+  PetscBool        tensor = PETSC_TRUE;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFEGetQuadrature(fem, &quad);CHKERRQ(ierr);
+  if (quad == sf->quad) PetscFunctionReturn(0);
+  ierr = PetscFESumFactReset_Private(fem);CHKERRQ(ierr);
+  if (!quad) PetscFunctionReturn(0);
+  ierr = PetscObjectReference((PetscObject) quad);CHKERRQ(ierr);
+  sf->quad = quad;
+  ierr = PetscFEGetSpatialDimension(fem, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetNumComponents(fem, &Nc);CHKERRQ(ierr);
+  ierr = PetscFEGetDimension(fem, &Nb);CHKERRQ(ierr);
+  ierr = PetscFEGetDualSpace(fem, &dual);CHKERRQ(ierr);
+  ierr = PetscQuadratureGetData(quad, NULL, &qNc, &Nq, &qpoints, NULL);CHKERRQ(ierr);
+  if (qNc != 1 || dim < 1 || dim > 3) PetscFunctionReturn(0);
+  ierr = PetscMalloc5(Nq*dim, &qnodes, Nb*dim, &bnodes, Nb*dim, &bpoints, Nb, &comp, Nb, &blex);CHKERRQ(ierr);
+  for (b = 0; b < Nb && tensor; ++b) {
+    PetscQuadrature  f;
+    const PetscReal *fpoints, *fweights;
+    PetscInt         fNc, fNp, nz = 0;
+
+    ierr = PetscDualSpaceGetFunctional(dual, b, &f);CHKERRQ(ierr);
+    ierr = PetscQuadratureGetData(f, NULL, &fNc, &fNp, &fpoints, &fweights);CHKERRQ(ierr);
+    if (fNp != 1 || fNc != Nc) {tensor = PETSC_FALSE; break;}
+    for (c = 0; c < Nc; ++c) if (fweights[c] != 0.0) {comp[b] = c; ++nz;}
+    if (nz != 1) tensor = PETSC_FALSE;
+    for (d = 0; d < dim; ++d) bpoints[b*dim+d] = fpoints[d];
+  }
+  if (tensor) {
+    ierr = PetscFESumFactGetNodes_Private(Nq, dim, qpoints, qnodes, &Nq1);CHKERRQ(ierr);
+    ierr = PetscFESumFactGetNodes_Private(Nb, dim, bpoints, bnodes, &Nb1);CHKERRQ(ierr);
+    for (d = 0; d < dim; ++d) N *= Nb1;
+    if (Nq != (PetscInt) PetscPowInt(Nq1, dim) || Nb != Nc*N) tensor = PETSC_FALSE;
+  }
+  if (tensor) {
+    ierr = PetscMalloc4(Nq1*Nb1, &sf->B1, Nq1*Nb1, &sf->D1, Nb, &sf->bperm, Nq, &sf->qperm);CHKERRQ(ierr);
+    for (i = 0; i < Nb; ++i) sf->bperm[i] = -1;
+    for (i = 0; i < Nq; ++i) sf->qperm[i] = -1;
+    for (b = 0; b < Nb; ++b) {
+      blex[b] = PetscFESumFactLexIndex_Private(dim, &bpoints[b*dim], Nb1, bnodes);
+      if (sf->bperm[comp[b]*N+blex[b]] >= 0) {tensor = PETSC_FALSE; break;}
+      sf->bperm[comp[b]*N+blex[b]] = b;
+    }
+    for (q = 0; q < Nq && tensor; ++q) {
+      i = PetscFESumFactLexIndex_Private(dim, &qpoints[q*dim], Nq1, qnodes);
+      if (sf->qperm[i] >= 0) {tensor = PETSC_FALSE; break;}
+      sf->qperm[i] = q;
+    }
+  }
+  if (tensor) {
+    /* Lagrange polynomials on the nodes and their derivatives at the quadrature points */
+    for (q = 0; q < Nq1; ++q) {
+      for (b = 0; b < Nb1; ++b) {
+        PetscReal l = 1.0, dl = 0.0;
+
+        for (i = 0; i < Nb1; ++i) {
+          PetscReal p;
+
+          if (i == b) continue;
+          p  = 1.0/(bnodes[b] - bnodes[i]);
+          l *= (qnodes[q] - bnodes[i])*p;
+          for (j = 0; j < Nb1; ++j) if (j != b && j != i) p *= (qnodes[q] - bnodes[j])/(bnodes[b] - bnodes[j]);
+          dl += p;
+        }
+        sf->B1[q*Nb1+b] = l;
+        sf->D1[q*Nb1+b] = dl;
+      }
+    }
+    /* Check the factors against the full tabulation */
+    ierr = PetscFEGetDefaultTabulation(fem, &B, &D, NULL);CHKERRQ(ierr);
+    for (q = 0; q < Nq && tensor; ++q) {
+      PetscInt qi[3], bi[3], qlex = PetscFESumFactLexIndex_Private(dim, &qpoints[q*dim], Nq1, qnodes);
+
+      for (d = dim-1; d >= 0; --d) {qi[d] = qlex % Nq1; qlex /= Nq1;}
+      for (b = 0; b < Nb && tensor; ++b) {
+        PetscInt lex = blex[b];
+
+        for (d = dim-1; d >= 0; --d) {bi[d] = lex % Nb1; lex /= Nb1;}
+        for (c = 0; c < Nc; ++c) {
+          PetscReal val = 1.0, der[3] = {1.0, 1.0, 1.0};
+          PetscInt  e;
+
+          for (d = 0; d < dim; ++d) {
+            val *= sf->B1[qi[d]*Nb1+bi[d]];
+            for (e = 0; e < dim; ++e) der[e] *= (e == d ? sf->D1 : sf->B1)[qi[d]*Nb1+bi[d]];
+          }
+          if (c != comp[b]) {val = 0.0; der[0] = der[1] = der[2] = 0.0;}
+          if (PetscAbsReal(B[(q*Nb+b)*Nc+c] - val) > tol*(1.0 + PetscAbsReal(val))) tensor = PETSC_FALSE;
+          for (e = 0; e < dim; ++e) if (PetscAbsReal(D[((q*Nb+b)*Nc+c)*dim+e] - der[e]) > tol*(1.0 + PetscAbsReal(der[e]))) tensor = PETSC_FALSE;
+        }
+      }
+    }
+  }
+  ierr = PetscFree5(qnodes, bnodes, bpoints, comp, blex);CHKERRQ(ierr);
+  if (!tensor) {ierr = PetscFree4(sf->B1, sf->D1, sf->bperm, sf->qperm);CHKERRQ(ierr);}
+  sf->tensor = tensor;
+  sf->Nb1    = tensor ? Nb1 : 0;
+  sf->Nq1    = tensor ? Nq1 : 0;
+  ierr = PetscInfo3(fem, "Tensor product structure %s, with %D basis functions and %D quadrature points in each direction\n", tensor ? "found" : "not found", Nb1, Nq1);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscFESumFactGetWorkspace_Private(PetscFE fem, PetscInt n, PetscScalar **work)
+{
+  PetscFE_SumFact *sf = (PetscFE_SumFact *) fem->data;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  if (n > sf->workSize) {
+    ierr = PetscFree(sf->work);CHKERRQ(ierr);
+    ierr = PetscMalloc1(n, &sf->work);CHKERRQ(ierr);
+    sf->workSize = n;
+  }
+  *work = sf->work;
+  PetscFunctionReturn(0);
+}
+
+/*
+  Apply A[dim-1] x ... x A[0] to a tensor with n entries in each direction, giving m entries in each direction. Each A[a]
+  is m x n, stored as A[i*n+j], or when trans is true it is the transpose of an n x m matrix stored as A[j*m+i].
+  The directions are contracted one at a time, so out and tmp need room for max(m,n)^dim entries.
+*/
+static void PetscFESumFactApply_Private(PetscInt dim, PetscInt m, PetscInt n, const PetscReal *A[], PetscBool trans, const PetscScalar in[], PetscScalar out[], PetscScalar tmp[])
+{
+  const PetscScalar *src = in;
+  PetscInt           outer = 1, inner = 1, a, d, o, i, j, k;
+
+  for (d = 1; d < dim; ++d) inner *= n;
+  for (a = 0; a < dim; ++a) {
+    PetscScalar *dst = (dim-1-a) % 2 ? tmp : out;
+
+    for (k = 0; k < outer*m*inner; ++k) dst[k] = 0.0;
+    for (o = 0; o < outer; ++o) {
+      for (i = 0; i < m; ++i) {
+        PetscScalar *di = &dst[(o*m+i)*inner];
+
+        for (j = 0; j < n; ++j) {
+          const PetscReal    Aij = trans ? A[a][j*m+i] : A[a][i*n+j];
+          const PetscScalar *sj  = &src[(o*n+j)*inner];
+
+          for (k = 0; k < inner; ++k) di[k] += Aij*sj[k];
+        }
+      }
+    }
+    src    = dst;
+    outer *= m;
+    if (a < dim-1) inner /= n;
+  }
+}
+
+static PetscErrorCode PetscFESumFactIsTensor_Private(PetscFE fe, PetscBool *tensor)
+{
+  PetscBool      isSumFact;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject) fe, PETSCFESUMFACT, &isSumFact);CHKERRQ(ierr);
+  *tensor = PETSC_FALSE;
+  if (isSumFact) {
+    ierr = PetscFESumFactSetUpTensor_Private(fe);CHKERRQ(ierr);
+    *tensor = ((PetscFE_SumFact *) fe->data)->tensor;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+  Evaluate a field with coefficients coef[] at the quadrature points, u[q*ldu+c], and if u_x is given also its gradient
+  with respect to reference coordinates, u_x[(q*ldu+c)*dim+d]. work needs room for 3 max(Nb,Nq) entries.
+*/
+static PetscErrorCode PetscFESumFactEvaluateField_Private(PetscFE fe, PetscInt Nq, PetscInt ldu, const PetscScalar coef[], PetscScalar u[], PetscScalar u_x[], PetscScalar work[])
+{
+  PetscInt       dim, Nb, Nc, b, c, d, i, q;
+  PetscBool      tensor;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginHot;
+  ierr = PetscFEGetSpatialDimension(fe, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetDimension(fe, &Nb);CHKERRQ(ierr);
+  ierr = PetscFEGetNumComponents(fe, &Nc);CHKERRQ(ierr);
+  ierr = PetscFESumFactIsTensor_Private(fe, &tensor);CHKERRQ(ierr);
+  if (tensor) {
+    PetscFE_SumFact *sf = (PetscFE_SumFact *) fe->data;
+    const PetscInt   N  = Nb/Nc, L = PetscMax(Nb, Nq);
+    PetscScalar     *in = work, *out = &work[L], *tmp = &work[2*L];
+    const PetscReal *A[3];
+
+    for (c = 0; c < Nc; ++c) {
+      for (i = 0; i < N; ++i) in[i] = coef[sf->bperm[c*N+i]];
+      for (d = 0; d < dim; ++d) A[d] = sf->B1;
+      PetscFESumFactApply_Private(dim, sf->Nq1, sf->Nb1, A, PETSC_FALSE, in, out, tmp);
+      for (i = 0; i < Nq; ++i) u[sf->qperm[i]*ldu+c] = out[i];
+      if (!u_x) continue;
+      for (d = 0; d < dim; ++d) {
+        PetscInt e;
+
+        for (e = 0; e < dim; ++e) A[e] = e == d ? sf->D1 : sf->B1;
+        PetscFESumFactApply_Private(dim, sf->Nq1, sf->Nb1, A, PETSC_FALSE, in, out, tmp);
+        for (i = 0; i < Nq; ++i) u_x[(sf->qperm[i]*ldu+c)*dim+d] = out[i];
+      }
+    }
+  } else {
+    PetscReal *B, *D;
+
+    ierr = PetscFEGetDefaultTabulation(fe, &B, &D, NULL);CHKERRQ(ierr);
+    for (q = 0; q < Nq; ++q) {
+      for (c = 0; c < Nc; ++c) {
+        u[q*ldu+c] = 0.0;
+        if (u_x) for (d = 0; d < dim; ++d) u_x[(q*ldu+c)*dim+d] = 0.0;
+      }
+      for (b = 0; b < Nb; ++b) {
+        for (c = 0; c < Nc; ++c) {
+          u[q*ldu+c] += B[(q*Nb+b)*Nc+c]*coef[b];
+          if (u_x) for (d = 0; d < dim; ++d) u_x[(q*ldu+c)*dim+d] += D[((q*Nb+b)*Nc+c)*dim+d]*coef[b];
+        }
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+  Add the integral against the test functions, elemVec[b] += \sum_{q,c} B_{qbc} f0[q*Nc+c] + \sum_{q,c,d} D_{qbcd} f1[(q*Nc+c)*dim+d],
+  where f1 is taken with respect to reference coordinates. work needs room for 4 max(Nb,Nq) entries.
+*/
+static PetscErrorCode PetscFESumFactIntegrateField_Private(PetscFE fe, PetscInt Nq, const PetscScalar f0[], const PetscScalar f1[], PetscScalar elemVec[], PetscScalar work[])
+{
+  PetscInt       dim, Nb, Nc, b, c, d, i, q;
+  PetscBool      tensor;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginHot;
+  ierr = PetscFEGetSpatialDimension(fe, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetDimension(fe, &Nb);CHKERRQ(ierr);
+  ierr = PetscFEGetNumComponents(fe, &Nc);CHKERRQ(ierr);
+  ierr = PetscFESumFactIsTensor_Private(fe, &tensor);CHKERRQ(ierr);
+  if (tensor) {
+    PetscFE_SumFact *sf = (PetscFE_SumFact *) fe->data;
+    const PetscInt   N  = Nb/Nc, L = PetscMax(Nb, Nq);
+    PetscScalar     *in = work, *out = &work[L], *tmp = &work[2*L], *acc = &work[3*L];
+    const PetscReal *A[3];
+
+    for (c = 0; c < Nc; ++c) {
+      for (i = 0; i < N; ++i) acc[i] = 0.0;
+      if (f0) {
+        for (i = 0; i < Nq; ++i) in[i] = f0[sf->qperm[i]*Nc+c];
+        for (d = 0; d < dim; ++d) A[d] = sf->B1;
+        PetscFESumFactApply_Private(dim, sf->Nb1, sf->Nq1, A, PETSC_TRUE, in, out, tmp);
+        for (i = 0; i < N; ++i) acc[i] += out[i];
+      }
+      if (f1) {
+        for (d = 0; d < dim; ++d) {
+          PetscInt e;
+
+          for (i = 0; i < Nq; ++i) in[i] = f1[(sf->qperm[i]*Nc+c)*dim+d];
+          for (e = 0; e < dim; ++e) A[e] = e == d ? sf->D1 : sf->B1;
+          PetscFESumFactApply_Private(dim, sf->Nb1, sf->Nq1, A, PETSC_TRUE, in, out, tmp);
+          for (i = 0; i < N; ++i) acc[i] += out[i];
+        }
+      }
+      for (i = 0; i < N; ++i) elemVec[sf->bperm[c*N+i]] += acc[i];
+    }
+  } else {
+    PetscReal *B, *D;
+
+    ierr = PetscFEGetDefaultTabulation(fe, &B, &D, NULL);CHKERRQ(ierr);
+    for (q = 0; q < Nq; ++q) {
+      for (b = 0; b < Nb; ++b) {
+        for (c = 0; c < Nc; ++c) {
+          if (f0) elemVec[b] += B[(q*Nb+b)*Nc+c]*f0[q*Nc+c];
+          if (f1) for (d = 0; d < dim; ++d) elemVec[b] += D[((q*Nb+b)*Nc+c)*dim+d]*f1[(q*Nc+c)*dim+d];
+        }
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Evaluate all fields of ds for one cell, u[q*NcT+c] and the reference gradients u_x[(q*NcT+c)*dim+d] */
+static PetscErrorCode PetscFESumFactEvaluateFieldJets_Private(PetscDS ds, PetscInt Nq, const PetscScalar coefficients[], const PetscScalar coefficients_t[], PetscScalar u[], PetscScalar u_x[], PetscScalar u_t[], PetscScalar work[])
+{
+  PetscInt      *Nb, *uOff;
+  PetscInt       Nf, NcT, dim, f, dOffset = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginHot;
+  ierr = PetscDSGetSpatialDimension(ds, &dim);CHKERRQ(ierr);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalComponents(ds, &NcT);CHKERRQ(ierr);
+  ierr = PetscDSGetDimensions(ds, &Nb);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentOffsets(ds, &uOff);CHKERRQ(ierr);
+  for (f = 0; f < Nf; ++f) {
+    PetscFE fe;
+
+    ierr = PetscDSGetDiscretization(ds, f, (PetscObject *) &fe);CHKERRQ(ierr);
+    ierr = PetscFESumFactEvaluateField_Private(fe, Nq, NcT, &coefficients[dOffset], &u[uOff[f]], &u_x[uOff[f]*dim], work);CHKERRQ(ierr);
+    if (u_t) {ierr = PetscFESumFactEvaluateField_Private(fe, Nq, NcT, &coefficients_t[dOffset], &u_t[uOff[f]], NULL, work);CHKERRQ(ierr);}
+    dOffset += Nb[f];
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Push reference gradients forward, \nabla u = J^{-T} \hat\nabla u */
+PETSC_STATIC_INLINE void PetscFESumFactPushforward_Private(PetscInt dim, PetscInt Nc, const PetscReal invJ[], PetscScalar u_x[])
+{
+  PetscInt c, d, e;
+
+  for (c = 0; c < Nc; ++c) {
+    PetscScalar g[3];
+
+    for (d = 0; d < dim; ++d) g[d] = u_x[c*dim+d];
+    for (d = 0; d < dim; ++d) {
+      u_x[c*dim+d] = 0.0;
+      for (e = 0; e < dim; ++e) u_x[c*dim+d] += invJ[e*dim+d]*g[e];
+    }
+  }
+}
+
+/* Pull a real space flux back to the reference cell and weight it, fref[k] = w \sum_d invJ[k][d] f[d] */
+PETSC_STATIC_INLINE void PetscFESumFactPullback_Private(PetscInt dim, PetscInt Nc, const PetscReal invJ[], PetscReal w, const PetscScalar f[], PetscScalar fref[])
+{
+  PetscInt c, d, k;
+
+  for (c = 0; c < Nc; ++c) {
+    for (k = 0; k < dim; ++k) {
+      PetscScalar s = 0.0;
+
+      for (d = 0; d < dim; ++d) s += invJ[k*dim+d]*f[c*dim+d];
+      fref[c*dim+k] = w*s;
+    }
+  }
+}
+
+/* The geometry of cell e at quadrature point q */
+PETSC_STATIC_INLINE void PetscFESumFactGetGeometry_Private(PetscFEGeom *cgeom, PetscInt dim, PetscInt e, PetscInt q, const PetscReal quadPoints[], PetscReal xbuf[], const PetscReal **x, const PetscReal **invJ, PetscReal *detJ)
+{
+  if (cgeom->isAffine) {
+    CoordinatesRefToReal(dim, dim, cgeom->xi, &cgeom->v[e*dim], &cgeom->J[e*dim*dim], &quadPoints[q*dim], xbuf);
+    *x    = xbuf;
+    *invJ = &cgeom->invJ[e*dim*dim];
+    *detJ = cgeom->detJ[e];
+  } else {
+    const PetscInt Np = cgeom->numPoints;
+
+    *x    = &cgeom->v[(e*Np+q)*dim];
+    *invJ = &cgeom->invJ[(e*Np+q)*dim*dim];
+    *detJ = cgeom->detJ[e*Np+q];
+  }
+}
+
+/* The kernels handle cells that are not embedded in a higher dimension and fields whose values need no Piola transform */
+static PetscErrorCode PetscFESumFactSupported_Private(PetscDS ds, PetscInt dim, PetscInt Nq, PetscFEGeom *geom, PetscBool *supported)
+{
+  PetscInt       Nf, f;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *supported = (geom->dimEmbed == dim && (geom->isAffine || geom->numPoints == Nq)) ? PETSC_TRUE : PETSC_FALSE;
+  if (!ds || !*supported) PetscFunctionReturn(0);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  for (f = 0; f < Nf; ++f) {
+    PetscObject  obj;
+    PetscClassId id;
+    PetscInt     k, fNq;
+
+    ierr = PetscDSGetDiscretization(ds, f, &obj);CHKERRQ(ierr);
+    ierr = PetscObjectGetClassId(obj, &id);CHKERRQ(ierr);
+    if (id != PETSCFE_CLASSID) {*supported = PETSC_FALSE; break;}
+    ierr = PetscDualSpaceGetDeRahm(((PetscFE) obj)->dualSpace, &k);CHKERRQ(ierr);
+    ierr = PetscQuadratureGetData(((PetscFE) obj)->quadrature, NULL, NULL, &fNq, NULL, NULL);CHKERRQ(ierr);
+    if (k || fNq != Nq) {*supported = PETSC_FALSE; break;}
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscFEIntegrateResidual_SumFact(PetscDS ds, PetscInt field, PetscInt Ne, PetscFEGeom *cgeom,
+                                                const PetscScalar coefficients[], const PetscScalar coefficients_t[], PetscDS dsAux, const PetscScalar coefficientsAux[], PetscReal t, PetscScalar elemVec[])
+{
+  PetscFE            fe;
+  PetscPointFunc     f0_func;
+  PetscPointFunc     f1_func;
+  PetscQuadrature    quad;
+  PetscScalar       *f1, *u, *u_t = NULL, *u_x, *a = NULL, *a_x = NULL, *F0, *F1, *work;
+  const PetscScalar *constants;
+  PetscReal          xbuf[3];
+  PetscInt          *uOff, *uOff_x, *aOff = NULL, *aOff_x = NULL, *Nb, *Nc;
+  PetscInt           dim, numConstants, Nf, NfAux = 0, NcT, NcTAux = 0, totDim, totDimAux = 0, fOffset, NbI, NcI, e;
+  PetscBool          supported, supportedAux = PETSC_TRUE;
+  const PetscReal   *quadPoints, *quadWeights;
+  PetscInt           qNc, Nq, q;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscDSGetDiscretization(ds, field, (PetscObject *) &fe);CHKERRQ(ierr);
+  ierr = PetscFEGetSpatialDimension(fe, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetQuadrature(fe, &quad);CHKERRQ(ierr);
+  ierr = PetscQuadratureGetData(quad, NULL, &qNc, &Nq, &quadPoints, &quadWeights);CHKERRQ(ierr);
+  if (qNc != 1) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_SUP, "Only supports scalar quadrature, not %D components\n", qNc);
+  ierr = PetscFESumFactSupported_Private(ds, dim, Nq, cgeom, &supported);CHKERRQ(ierr);
+  if (dsAux) {ierr = PetscFESumFactSupported_Private(dsAux, dim, Nq, cgeom, &supportedAux);CHKERRQ(ierr);}
+  if (!supported || !supportedAux) {
+    ierr = PetscFEIntegrateResidual_Basic(ds, field, Ne, cgeom, coefficients, coefficients_t, dsAux, coefficientsAux, t, elemVec);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalDimension(ds, &totDim);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalComponents(ds, &NcT);CHKERRQ(ierr);
+  ierr = PetscDSGetDimensions(ds, &Nb);CHKERRQ(ierr);
+  ierr = PetscDSGetComponents(ds, &Nc);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentOffsets(ds, &uOff);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentDerivativeOffsets(ds, &uOff_x);CHKERRQ(ierr);
+  ierr = PetscDSGetFieldOffset(ds, field, &fOffset);CHKERRQ(ierr);
+  ierr = PetscDSGetResidual(ds, field, &f0_func, &f1_func);CHKERRQ(ierr);
+  ierr = PetscDSGetWeakFormArrays(ds, NULL, &f1, NULL, NULL, NULL, NULL);CHKERRQ(ierr);
+  if (!f0_func && !f1_func) PetscFunctionReturn(0);
+  ierr = PetscDSGetConstants(ds, &numConstants, &constants);CHKERRQ(ierr);
+  if (dsAux) {
+    ierr = PetscDSGetNumFields(dsAux, &NfAux);CHKERRQ(ierr);
+    ierr = PetscDSGetTotalDimension(dsAux, &totDimAux);CHKERRQ(ierr);
+    ierr = PetscDSGetTotalComponents(dsAux, &NcTAux);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentOffsets(dsAux, &aOff);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentDerivativeOffsets(dsAux, &aOff_x);CHKERRQ(ierr);
+  }
+  NbI = Nb[field];
+  NcI = Nc[field];
+  /* Fields at all quadrature points of a cell, the weak form terms, and room for the one dimensional contractions */
+  ierr = PetscFESumFactGetWorkspace_Private(fe, Nq*(NcT*(dim+(coefficients_t ? 2 : 1)) + NcTAux*(dim+1) + NcI*(dim+1)) + 4*PetscMax(PetscMax(totDim, totDimAux), Nq), &work);CHKERRQ(ierr);
+  u   = work;            work += Nq*NcT;
+  u_x = work;            work += Nq*NcT*dim;
+  if (coefficients_t) {u_t = work; work += Nq*NcT;}
+  if (dsAux)          {a   = work; work += Nq*NcTAux; a_x = work; work += Nq*NcTAux*dim;}
+  F0  = work;            work += Nq*NcI;
+  F1  = work;            work += Nq*NcI*dim;
+  for (e = 0; e < Ne; ++e) {
+    PetscScalar *eVec = &elemVec[e*totDim+fOffset];
+    PetscInt     b, c;
+
+    ierr = PetscFESumFactEvaluateFieldJets_Private(ds, Nq, &coefficients[e*totDim], coefficients_t ? &coefficients_t[e*totDim] : NULL, u, u_x, u_t, work);CHKERRQ(ierr);
+    if (dsAux) {ierr = PetscFESumFactEvaluateFieldJets_Private(dsAux, Nq, &coefficientsAux[e*totDimAux], NULL, a, a_x, NULL, work);CHKERRQ(ierr);}
+    for (q = 0; q < Nq; ++q) {
+      const PetscReal *x, *invJ;
+      PetscReal        detJ, w;
+
+      PetscFESumFactGetGeometry_Private(cgeom, dim, e, q, quadPoints, xbuf, &x, &invJ, &detJ);
+      w = detJ*quadWeights[q];
+      PetscFESumFactPushforward_Private(dim, NcT, invJ, &u_x[q*NcT*dim]);
+      if (dsAux) PetscFESumFactPushforward_Private(dim, NcTAux, invJ, &a_x[q*NcTAux*dim]);
+      if (f0_func) {
+        for (c = 0; c < NcI; ++c) F0[q*NcI+c] = 0.0;
+        f0_func(dim, Nf, NfAux, uOff, uOff_x, &u[q*NcT], u_t ? &u_t[q*NcT] : NULL, &u_x[q*NcT*dim], aOff, aOff_x, a ? &a[q*NcTAux] : NULL, NULL, a_x ? &a_x[q*NcTAux*dim] : NULL, t, x, numConstants, constants, &F0[q*NcI]);
+        for (c = 0; c < NcI; ++c) F0[q*NcI+c] *= w;
+      }
+      if (f1_func) {
+        ierr = PetscMemzero(f1, NcI*dim * sizeof(PetscScalar));CHKERRQ(ierr);
+        f1_func(dim, Nf, NfAux, uOff, uOff_x, &u[q*NcT], u_t ? &u_t[q*NcT] : NULL, &u_x[q*NcT*dim], aOff, aOff_x, a ? &a[q*NcTAux] : NULL, NULL, a_x ? &a_x[q*NcTAux*dim] : NULL, t, x, numConstants, constants, f1);
+        PetscFESumFactPullback_Private(dim, NcI, invJ, w, f1, &F1[q*NcI*dim]);
+      }
+    }
+    for (b = 0; b < NbI; ++b) eVec[b] = 0.0;
+    ierr = PetscFESumFactIntegrateField_Private(fe, Nq, f0_func ? F0 : NULL, f1_func ? F1 : NULL, eVec, work);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+  Apply the fieldI-fieldJ block of the element Jacobian to y without forming it. With u the trial function and v the test
+  function, the pointwise Jacobian gives the fluxes f0 = g0 y + g1 . \nabla y and f1 = g2 y + g3 . \nabla y at each
+  quadrature point, which are integrated against the test functions as in the residual.
+*/
+PetscErrorCode PetscFEIntegrateJacobianAction_SumFact(PetscDS ds, PetscFEJacobianType jtype, PetscInt fieldI, PetscInt fieldJ, PetscInt Ne, PetscFEGeom *cgeom,
+                                                      const PetscScalar coefficients[], const PetscScalar coefficients_t[], PetscDS dsAux, const PetscScalar coefficientsAux[], PetscReal t, PetscReal u_tshift, const PetscScalar y[], PetscScalar elemVec[])
+{
+  PetscFE            feI, feJ;
+  PetscPointJac      g0_func, g1_func, g2_func, g3_func;
+  PetscInt           offsetI = 0, offsetJ = 0;
+  PetscQuadrature    quad;
+  PetscScalar       *f1, *g0, *g1, *g2, *g3, *u = NULL, *u_t = NULL, *u_x = NULL, *a = NULL, *a_x = NULL, *yv, *y_x, *F0, *F1, *work;
+  const PetscScalar *constants;
+  PetscReal          xbuf[3];
+  PetscInt          *uOff, *uOff_x, *aOff = NULL, *aOff_x = NULL, *Nb, *Nc;
+  PetscInt           NbI, NcI, NbJ, NcJ;
+  PetscInt           dim, numConstants, Nf, NfAux = 0, NcT, NcTAux = 0, totDim, totDimAux = 0, e;
+  PetscBool          supported, supportedAux = PETSC_TRUE;
+  const PetscReal   *quadPoints, *quadWeights;
+  PetscInt           qNc, Nq, q;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscDSGetDiscretization(ds, fieldI, (PetscObject *) &feI);CHKERRQ(ierr);
+  ierr = PetscDSGetDiscretization(ds, fieldJ, (PetscObject *) &feJ);CHKERRQ(ierr);
+  ierr = PetscFEGetSpatialDimension(feI, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetQuadrature(feI, &quad);CHKERRQ(ierr);
+  ierr = PetscQuadratureGetData(quad, NULL, &qNc, &Nq, &quadPoints, &quadWeights);CHKERRQ(ierr);
+  if (qNc != 1) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_SUP, "Only supports scalar quadrature, not %D components\n", qNc);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalDimension(ds, &totDim);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalComponents(ds, &NcT);CHKERRQ(ierr);
+  ierr = PetscDSGetDimensions(ds, &Nb);CHKERRQ(ierr);
+  ierr = PetscDSGetComponents(ds, &Nc);CHKERRQ(ierr);
+  ierr = PetscDSGetFieldOffset(ds, fieldI, &offsetI);CHKERRQ(ierr);
+  ierr = PetscDSGetFieldOffset(ds, fieldJ, &offsetJ);CHKERRQ(ierr);
+  NbI  = Nb[fieldI], NbJ = Nb[fieldJ];
+  NcI  = Nc[fieldI], NcJ = Nc[fieldJ];
+  ierr = PetscFESumFactSupported_Private(ds, dim, Nq, cgeom, &supported);CHKERRQ(ierr);
+  if (dsAux) {ierr = PetscFESumFactSupported_Private(dsAux, dim, Nq, cgeom, &supportedAux);CHKERRQ(ierr);}
+  if (!supported || !supportedAux) {
+    PetscScalar *elemMat;
+
+    /* Form the element matrices with the basic kernel in the workspace, which the sum factorization does not need here */
+    ierr = PetscInfo4(feI, "Unsupported geometry or auxiliary fields, forming the %D x %D element matrices of fields %D and %D\n", NbI, NbJ, fieldI, fieldJ);CHKERRQ(ierr);
+    ierr = PetscFESumFactGetWorkspace_Private(feI, Ne*totDim*totDim, &elemMat);CHKERRQ(ierr);
+    ierr = PetscMemzero(elemMat, Ne*totDim*totDim * sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = PetscFEIntegrateJacobian_Basic(ds, jtype, fieldI, fieldJ, Ne, cgeom, coefficients, coefficients_t, dsAux, coefficientsAux, t, u_tshift, elemMat);CHKERRQ(ierr);
+    for (e = 0; e < Ne; ++e) {
+      PetscInt f, g;
+
+      for (f = 0; f < NbI; ++f) {
+        for (g = 0; g < NbJ; ++g) elemVec[e*totDim+offsetI+f] += elemMat[(e*totDim+offsetI+f)*totDim+offsetJ+g]*y[e*totDim+offsetJ+g];
+      }
+    }
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscDSGetComponentOffsets(ds, &uOff);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentDerivativeOffsets(ds, &uOff_x);CHKERRQ(ierr);
+  switch(jtype) {
+  case PETSCFE_JACOBIAN_DYN: ierr = PetscDSGetDynamicJacobian(ds, fieldI, fieldJ, &g0_func, &g1_func, &g2_func, &g3_func);CHKERRQ(ierr);break;
+  case PETSCFE_JACOBIAN_PRE: ierr = PetscDSGetJacobianPreconditioner(ds, fieldI, fieldJ, &g0_func, &g1_func, &g2_func, &g3_func);CHKERRQ(ierr);break;
+  case PETSCFE_JACOBIAN:     ierr = PetscDSGetJacobian(ds, fieldI, fieldJ, &g0_func, &g1_func, &g2_func, &g3_func);CHKERRQ(ierr);break;
+  }
+  if (!g0_func && !g1_func && !g2_func && !g3_func) PetscFunctionReturn(0);
+  ierr = PetscDSGetWeakFormArrays(ds, NULL, &f1, &g0, &g1, &g2, &g3);CHKERRQ(ierr);
+  ierr = PetscDSGetConstants(ds, &numConstants, &constants);CHKERRQ(ierr);
+  if (dsAux) {
+    ierr = PetscDSGetNumFields(dsAux, &NfAux);CHKERRQ(ierr);
+    ierr = PetscDSGetTotalDimension(dsAux, &totDimAux);CHKERRQ(ierr);
+    ierr = PetscDSGetTotalComponents(dsAux, &NcTAux);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentOffsets(dsAux, &aOff);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentDerivativeOffsets(dsAux, &aOff_x);CHKERRQ(ierr);
+  }
+  ierr = PetscFESumFactGetWorkspace_Private(feI, Nq*((coefficients ? NcT*(dim+(coefficients_t ? 2 : 1)) : 0) + NcTAux*(dim+1) + NcJ*(dim+1) + NcI*(dim+1)) + 4*PetscMax(PetscMax(totDim, totDimAux), Nq), &work);CHKERRQ(ierr);
+  if (coefficients) {
+    u   = work;            work += Nq*NcT;
+    u_x = work;            work += Nq*NcT*dim;
+    if (coefficients_t) {u_t = work; work += Nq*NcT;}
+  }
+  if (dsAux) {a = work; work += Nq*NcTAux; a_x = work; work += Nq*NcTAux*dim;}
+  yv  = work;            work += Nq*NcJ;
+  y_x = work;            work += Nq*NcJ*dim;
+  F0  = work;            work += Nq*NcI;
+  F1  = work;            work += Nq*NcI*dim;
+  for (e = 0; e < Ne; ++e) {
+    if (coefficients) {ierr = PetscFESumFactEvaluateFieldJets_Private(ds, Nq, &coefficients[e*totDim], coefficients_t ? &coefficients_t[e*totDim] : NULL, u, u_x, u_t, work);CHKERRQ(ierr);}
+    if (dsAux) {ierr = PetscFESumFactEvaluateFieldJets_Private(dsAux, Nq, &coefficientsAux[e*totDimAux], NULL, a, a_x, NULL, work);CHKERRQ(ierr);}
+    ierr = PetscFESumFactEvaluateField_Private(feJ, Nq, NcJ, &y[e*totDim+offsetJ], yv, y_x, work);CHKERRQ(ierr);
+    for (q = 0; q < Nq; ++q) {
+      const PetscScalar *uq = u ? &u[q*NcT] : NULL, *utq = u_t ? &u_t[q*NcT] : NULL, *uxq = u_x ? &u_x[q*NcT*dim] : NULL;
+      const PetscScalar *aq = a ? &a[q*NcTAux] : NULL, *axq = a_x ? &a_x[q*NcTAux*dim] : NULL;
+      const PetscScalar *yq = &yv[q*NcJ], *yxq = &y_x[q*NcJ*dim];
+      PetscScalar       *f0 = &F0[q*NcI];
+      const PetscReal   *x, *invJ;
+      PetscReal          detJ, w;
+      PetscInt           fc, gc, d, d2;
+
+      PetscFESumFactGetGeometry_Private(cgeom, dim, e, q, quadPoints, xbuf, &x, &invJ, &detJ);
+      w = detJ*quadWeights[q];
+      if (u_x) PetscFESumFactPushforward_Private(dim, NcT, invJ, &u_x[q*NcT*dim]);
+      if (a_x) PetscFESumFactPushforward_Private(dim, NcTAux, invJ, &a_x[q*NcTAux*dim]);
+      PetscFESumFactPushforward_Private(dim, NcJ, invJ, &y_x[q*NcJ*dim]);
+      for (fc = 0; fc < NcI; ++fc) f0[fc] = 0.0;
+      for (fc = 0; fc < NcI*dim; ++fc) f1[fc] = 0.0;
+      if (g0_func) {
+        ierr = PetscMemzero(g0, NcI*NcJ * sizeof(PetscScalar));CHKERRQ(ierr);
+        g0_func(dim, Nf, NfAux, uOff, uOff_x, uq, utq, uxq, aOff, aOff_x, aq, NULL, axq, t, u_tshift, x, numConstants, constants, g0);
+        for (fc = 0; fc < NcI; ++fc) for (gc = 0; gc < NcJ; ++gc) f0[fc] += g0[fc*NcJ+gc]*yq[gc];
+      }
+      if (g1_func) {
+        ierr = PetscMemzero(g1, NcI*NcJ*dim * sizeof(PetscScalar));CHKERRQ(ierr);
+        g1_func(dim, Nf, NfAux, uOff, uOff_x, uq, utq, uxq, aOff, aOff_x, aq, NULL, axq, t, u_tshift, x, numConstants, constants, g1);
+        for (fc = 0; fc < NcI; ++fc) for (gc = 0; gc < NcJ; ++gc) for (d = 0; d < dim; ++d) f0[fc] += g1[(fc*NcJ+gc)*dim+d]*yxq[gc*dim+d];
+      }
+      if (g2_func) {
+        ierr = PetscMemzero(g2, NcI*NcJ*dim * sizeof(PetscScalar));CHKERRQ(ierr);
+        g2_func(dim, Nf, NfAux, uOff, uOff_x, uq, utq, uxq, aOff, aOff_x, aq, NULL, axq, t, u_tshift, x, numConstants, constants, g2);
+        for (fc = 0; fc < NcI; ++fc) for (gc = 0; gc < NcJ; ++gc) for (d = 0; d < dim; ++d) f1[fc*dim+d] += g2[(fc*NcJ+gc)*dim+d]*yq[gc];
+      }
+      if (g3_func) {
+        ierr = PetscMemzero(g3, NcI*NcJ*dim*dim * sizeof(PetscScalar));CHKERRQ(ierr);
+        g3_func(dim, Nf, NfAux, uOff, uOff_x, uq, utq, uxq, aOff, aOff_x, aq, NULL, axq, t, u_tshift, x, numConstants, constants, g3);
+        for (fc = 0; fc < NcI; ++fc) for (gc = 0; gc < NcJ; ++gc) for (d = 0; d < dim; ++d) for (d2 = 0; d2 < dim; ++d2) f1[fc*dim+d] += g3[((fc*NcJ+gc)*dim+d)*dim+d2]*yxq[gc*dim+d2];
+      }
+      for (fc = 0; fc < NcI; ++fc) f0[fc] *= w;
+      PetscFESumFactPullback_Private(dim, NcI, invJ, w, f1, &F1[q*NcI*dim]);
+    }
+    ierr = PetscFESumFactIntegrateField_Private(feI, Nq, (g0_func || g1_func) ? F0 : NULL, (g2_func || g3_func) ? F1 : NULL, &elemVec[e*totDim+offsetI], work);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscFEInitialize_SumFact(PetscFE fem)
+{
+  PetscFunctionBegin;
+  fem->ops->setfromoptions          = NULL;
+  fem->ops->setup                   = PetscFESetUp_Basic;
+  fem->ops->view                    = PetscFEView_SumFact;
+  fem->ops->destroy                 = PetscFEDestroy_SumFact;
+  fem->ops->getdimension            = PetscFEGetDimension_Basic;
+  fem->ops->gettabulation           = PetscFEGetTabulation_Basic;
+  fem->ops->integrate               = PetscFEIntegrate_Basic;
+  fem->ops->integratebd             = PetscFEIntegrateBd_Basic;
+  fem->ops->integrateresidual       = PetscFEIntegrateResidual_SumFact;
+  fem->ops->integratebdresidual     = PetscFEIntegrateBdResidual_Basic;
+  fem->ops->integratejacobianaction = PetscFEIntegrateJacobianAction_SumFact;
+  fem->ops->integratejacobian       = PetscFEIntegrateJacobian_Basic;
+  fem->ops->integratebdjacobian     = PetscFEIntegrateBdJacobian_Basic;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+  PETSCFESUMFACT = "sumfact" - A PetscFE object that evaluates and integrates tensor product elements by sum factorization
+
+  Notes:
+  When the basis is a tensor product of one dimensional Lagrange polynomials, such as Q_k on hexahedra, and the quadrature
+  is a tensor product of one dimensional rules, the volume residual and the Jacobian action, PetscFEIntegrateJacobianAction(),
+  contract with the one dimensional tabulation one direction at a time. This costs O(p^{d+1}) per cell instead of O(p^{2d}).
+  Other bases, fields needing a Piola transform, the assembled Jacobian, and boundary integrals use the PETSCFEBASIC kernels.
+  The matrix-free Jacobian is used by DMPlexComputeJacobianAction().
+
+  Level: intermediate
+
+.seealso: PetscFEType, PetscFECreate(), PetscFESetType(), PETSCFEBASIC, PetscFEIntegrateJacobianAction()
+M*/
+
+PETSC_EXTERN PetscErrorCode PetscFECreate_SumFact(PetscFE fem)
+{
+  PetscFE_SumFact *sf;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(fem, PETSCFE_CLASSID, 1);
+  ierr      = PetscNewLog(fem,&sf);CHKERRQ(ierr);
+  fem->data = sf;
+
+  ierr = PetscFEInitialize_SumFact(fem);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,612 @@
+#include <petsc/private/petscfeimpl.h> /*I "petscfe.h" I*/
+
+/*
+  The vector implementation shares the setup and tabulation with PETSCFEBASIC. The volume residual and Jacobian
+  integrate a batch of cells at a time, with the cell index innermost in all work arrays, so that the contractions
+  with the tabulation run over contiguous cells and vectorize. The pointwise functions are still called once per
+  cell and quadrature point. Cases the batched kernels do not handle are passed on to the basic kernels.
+*/
+PETSC_EXTERN PetscErrorCode PetscFESetUp_Basic(PetscFE);
+PETSC_EXTERN PetscErrorCode PetscFEGetTabulation_Basic(PetscFE, PetscInt, const PetscReal [], PetscReal *, PetscReal *, PetscReal *);
+PETSC_EXTERN PetscErrorCode PetscFEIntegrate_Basic(PetscDS, PetscInt, PetscInt, PetscFEGeom *, const PetscScalar [], PetscDS, const PetscScalar [], PetscScalar []);
+PETSC_EXTERN PetscErrorCode PetscFEIntegrateBd_Basic(PetscDS, PetscInt, PetscBdPointFunc, PetscInt, PetscFEGeom *, const PetscScalar [], PetscDS, const PetscScalar [], PetscScalar []);
+PETSC_EXTERN PetscErrorCode PetscFEIntegrateBdJacobian_Basic(PetscDS, PetscInt, PetscInt, PetscInt, PetscFEGeom *, const PetscScalar [], const PetscScalar [], PetscDS, const PetscScalar [], PetscReal, PetscReal, PetscScalar []);
+
+PetscErrorCode PetscFEDestroy_Vector(PetscFE fem)
+{
+  PetscFE_Vector *v = (PetscFE_Vector *) fem->data;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(v->work);CHKERRQ(ierr);
+  ierr = PetscFree(v);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscFESetFromOptions_Vector(PetscOptionItems *PetscOptionsObject, PetscFE fem)
+{
+  PetscFE_Vector *v = (PetscFE_Vector *) fem->data;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject, "PetscFE Vector Options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-petscfe_vector_width", "The number of cells integrated together", "PetscFESetType", v->width, &v->width, NULL);CHKERRQ(ierr);
+  if (v->width < 1) SETERRQ1(PetscObjectComm((PetscObject) fem), PETSC_ERR_ARG_OUTOFRANGE, "The vector width %D must be positive", v->width);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscFEView_Vector_Ascii(PetscFE fe, PetscViewer v)
+{
+  PetscFE_Vector *vec = (PetscFE_Vector *) fe->data;
+  PetscInt        dim, Nc;
+  PetscSpace      basis = NULL;
+  PetscDualSpace  dual = NULL;
+  PetscQuadrature quad = NULL;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFEGetSpatialDimension(fe, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetNumComponents(fe, &Nc);CHKERRQ(ierr);
+  ierr = PetscFEGetBasisSpace(fe, &basis);CHKERRQ(ierr);
+  ierr = PetscFEGetDualSpace(fe, &dual);CHKERRQ(ierr);
+  ierr = PetscFEGetQuadrature(fe, &quad);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPushTab(v);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(v, "Vector Finite Element in %D dimensions with %D components, integrating %D cells at a time\n",dim,Nc,vec->width);CHKERRQ(ierr);
+  if (basis) {ierr = PetscSpaceView(basis, v);CHKERRQ(ierr);}
+  if (dual)  {ierr = PetscDualSpaceView(dual, v);CHKERRQ(ierr);}
+  if (quad)  {ierr = PetscQuadratureView(quad, v);CHKERRQ(ierr);}
+  ierr = PetscViewerASCIIPopTab(v);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscFEView_Vector(PetscFE fe, PetscViewer v)
+{
+  PetscBool      iascii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject) v, PETSCVIEWERASCII, &iascii);CHKERRQ(ierr);
+  if (iascii) {ierr = PetscFEView_Vector_Ascii(fe, v);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscFEVectorGetWorkspace_Private(PetscFE fem, PetscInt n, PetscScalar **work)
+{
+  PetscFE_Vector *v = (PetscFE_Vector *) fem->data;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  if (n > v->workSize) {
+    ierr = PetscFree(v->work);CHKERRQ(ierr);
+    ierr = PetscMalloc1(n, &v->work);CHKERRQ(ierr);
+    v->workSize = n;
+  }
+  *work = v->work;
+  PetscFunctionReturn(0);
+}
+
+/* The batched kernels handle affine cells that are not embedded in a higher dimension and fields whose values need no Piola transform */
+static PetscErrorCode PetscFEVectorSupported_Private(PetscDS ds, PetscInt dim, PetscFEGeom *geom, PetscBool *supported)
+{
+  PetscInt       Nf, f;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *supported = (geom->isAffine && geom->dimEmbed == dim) ? PETSC_TRUE : PETSC_FALSE;
+  if (!ds || !*supported) PetscFunctionReturn(0);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  for (f = 0; f < Nf; ++f) {
+    PetscObject  obj;
+    PetscClassId id;
+    PetscInt     k;
+
+    ierr = PetscDSGetDiscretization(ds, f, &obj);CHKERRQ(ierr);
+    ierr = PetscObjectGetClassId(obj, &id);CHKERRQ(ierr);
+    if (id != PETSCFE_CLASSID) {*supported = PETSC_FALSE; break;}
+    ierr = PetscDualSpaceGetDeRahm(((PetscFE) obj)->dualSpace, &k);CHKERRQ(ierr);
+    if (k) {*supported = PETSC_FALSE; break;}
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Copy the cell data into the batch layout, a[i*W+w] = A[(e0+w)*n+i] */
+PETSC_STATIC_INLINE void PetscFEVectorInterlace_Private(PetscInt n, PetscInt Nw, PetscInt W, const PetscScalar A[], PetscScalar a[])
+{
+  PetscInt i, w;
+
+  for (w = 0; w < Nw; ++w) for (i = 0; i < n; ++i) a[i*W+w] = A[w*n+i];
+}
+
+PETSC_STATIC_INLINE void PetscFEVectorInterlaceReal_Private(PetscInt n, PetscInt Nw, PetscInt W, const PetscReal A[], PetscScalar a[])
+{
+  PetscInt i, w;
+
+  for (w = 0; w < Nw; ++w) for (i = 0; i < n; ++i) a[i*W+w] = A[w*n+i];
+}
+
+/*
+  Evaluate the fields and their real space gradients at quadrature point q for Nw cells in batch layout:
+  u[c*W+w], u_x[(c*dim+d)*W+w] and u_t[c*W+w]. The gradients are pushed forward with invJ[(e*dim+d)*W+w].
+  tmp has room for dim*W entries.
+*/
+static PetscErrorCode PetscFEVectorEvaluateFieldJets_Private(PetscDS ds, PetscInt dim, PetscInt q, PetscInt Nw, PetscInt W, const PetscScalar invJ[], const PetscScalar coefficients[], const PetscScalar coefficients_t[], PetscScalar u[], PetscScalar u_x[], PetscScalar u_t[], PetscScalar tmp[])
+{
+  PetscReal    **B, **D;
+  PetscInt      *Nb, *Nc;
+  PetscInt       Nf, f, dOffset = 0, fOffset = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginHot;
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  ierr = PetscDSGetDimensions(ds, &Nb);CHKERRQ(ierr);
+  ierr = PetscDSGetComponents(ds, &Nc);CHKERRQ(ierr);
+  ierr = PetscDSGetTabulation(ds, &B, &D);CHKERRQ(ierr);
+  for (f = 0; f < Nf; ++f) {
+    const PetscInt   Nbf = Nb[f], Ncf = Nc[f];
+    const PetscReal *Bq  = &B[f][q*Nbf*Ncf];
+    const PetscReal *Dq  = &D[f][q*Nbf*Ncf*dim];
+    PetscScalar     *uf  = &u[fOffset*W], *uxf = &u_x[fOffset*dim*W], *utf = u_t ? &u_t[fOffset*W] : NULL;
+    PetscInt         b, c, d, e, w;
+
+    ierr = PetscMemzero(uf, Ncf*W * sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = PetscMemzero(uxf, Ncf*dim*W * sizeof(PetscScalar));CHKERRQ(ierr);
+    if (utf) {ierr = PetscMemzero(utf, Ncf*W * sizeof(PetscScalar));CHKERRQ(ierr);}
+    for (b = 0; b < Nbf; ++b) {
+      const PetscScalar *cb  = &coefficients[(dOffset+b)*W];
+      const PetscScalar *ctb = utf ? &coefficients_t[(dOffset+b)*W] : NULL;
+
+      for (c = 0; c < Ncf; ++c) {
+        const PetscReal Bv = Bq[b*Ncf+c];
+        PetscScalar    *uc = &uf[c*W];
+
+        for (w = 0; w < Nw; ++w) uc[w] += Bv*cb[w];
+        for (d = 0; d < dim; ++d) {
+          const PetscReal Dv   = Dq[(b*Ncf+c)*dim+d];
+          PetscScalar    *uxcd = &uxf[(c*dim+d)*W];
+
+          for (w = 0; w < Nw; ++w) uxcd[w] += Dv*cb[w];
+        }
+        if (utf) {
+          PetscScalar *utc = &utf[c*W];
+
+          for (w = 0; w < Nw; ++w) utc[w] += Bv*ctb[w];
+        }
+      }
+    }
+    /* Push the reference gradients forward, \nabla u = J^{-T} \hat\nabla u */
+    for (c = 0; c < Ncf; ++c) {
+      ierr = PetscMemcpy(tmp, &uxf[c*dim*W], dim*W * sizeof(PetscScalar));CHKERRQ(ierr);
+      for (d = 0; d < dim; ++d) {
+        PetscScalar *uxcd = &uxf[(c*dim+d)*W];
+
+        for (w = 0; w < Nw; ++w) uxcd[w] = 0.0;
+        for (e = 0; e < dim; ++e) {
+          const PetscScalar *iJ = &invJ[(e*dim+d)*W], *te = &tmp[e*W];
+
+          for (w = 0; w < Nw; ++w) uxcd[w] += iJ[w]*te[w];
+        }
+      }
+    }
+    fOffset += Ncf;
+    dOffset += Nbf;
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Copy cell w of the batch layout back into the pointwise evaluation arrays */
+PETSC_STATIC_INLINE void PetscFEVectorDeinterlace_Private(PetscInt n, PetscInt W, PetscInt w, const PetscScalar a[], PetscScalar A[])
+{
+  PetscInt i;
+
+  for (i = 0; i < n; ++i) A[i] = a[i*W+w];
+}
+
+PetscErrorCode PetscFEIntegrateResidual_Vector(PetscDS ds, PetscInt field, PetscInt Ne, PetscFEGeom *cgeom,
+                                               const PetscScalar coefficients[], const PetscScalar coefficients_t[], PetscDS dsAux, const PetscScalar coefficientsAux[], PetscReal t, PetscScalar elemVec[])
+{
+  PetscFE            fe;
+  PetscFE_Vector    *vec;
+  PetscPointFunc     f0_func;
+  PetscPointFunc     f1_func;
+  PetscQuadrature    quad;
+  PetscScalar       *f0, *f1, *u, *u_t = NULL, *u_x, *a = NULL, *a_x = NULL, *work;
+  PetscScalar       *cI, *ctI = NULL, *aI = NULL, *uI, *utI = NULL, *uxI, *auI = NULL, *axI = NULL, *invJI, *tmp, *f0I, *f1I, *eI;
+  const PetscScalar *constants;
+  PetscReal         *x;
+  PetscReal        **B, **D, *BI, *DI;
+  PetscInt          *uOff, *uOff_x, *aOff = NULL, *aOff_x = NULL, *Nb, *Nc;
+  PetscInt           dim, numConstants, Nf, NfAux = 0, NcT, NcTAux = 0, totDim, totDimAux = 0, fOffset, NbI, NcI, W, e0;
+  PetscBool          supported, supportedAux = PETSC_TRUE;
+  const PetscReal   *quadPoints, *quadWeights;
+  PetscInt           qNc, Nq, q, dE;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscDSGetDiscretization(ds, field, (PetscObject *) &fe);CHKERRQ(ierr);
+  ierr = PetscFEGetSpatialDimension(fe, &dim);CHKERRQ(ierr);
+  ierr = PetscFEVectorSupported_Private(ds, dim, cgeom, &supported);CHKERRQ(ierr);
+  if (dsAux) {ierr = PetscFEVectorSupported_Private(dsAux, dim, cgeom, &supportedAux);CHKERRQ(ierr);}
+  if (!supported || !supportedAux) {
+    ierr = PetscFEIntegrateResidual_Basic(ds, field, Ne, cgeom, coefficients, coefficients_t, dsAux, coefficientsAux, t, elemVec);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  vec  = (PetscFE_Vector *) fe->data;
+  W    = vec->width;
+  ierr = PetscFEGetQuadrature(fe, &quad);CHKERRQ(ierr);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalDimension(ds, &totDim);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalComponents(ds, &NcT);CHKERRQ(ierr);
+  ierr = PetscDSGetDimensions(ds, &Nb);CHKERRQ(ierr);
+  ierr = PetscDSGetComponents(ds, &Nc);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentOffsets(ds, &uOff);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentDerivativeOffsets(ds, &uOff_x);CHKERRQ(ierr);
+  ierr = PetscDSGetFieldOffset(ds, field, &fOffset);CHKERRQ(ierr);
+  ierr = PetscDSGetResidual(ds, field, &f0_func, &f1_func);CHKERRQ(ierr);
+  ierr = PetscDSGetEvaluationArrays(ds, &u, coefficients_t ? &u_t : NULL, &u_x);CHKERRQ(ierr);
+  ierr = PetscDSGetWorkspace(ds, &x, NULL, NULL, NULL, NULL);CHKERRQ(ierr);
+  ierr = PetscDSGetWeakFormArrays(ds, &f0, &f1, NULL, NULL, NULL, NULL);CHKERRQ(ierr);
+  if (!f0_func && !f1_func) PetscFunctionReturn(0);
+  ierr = PetscDSGetTabulation(ds, &B, &D);CHKERRQ(ierr);
+  ierr = PetscDSGetConstants(ds, &numConstants, &constants);CHKERRQ(ierr);
+  if (dsAux) {
+    ierr = PetscDSGetNumFields(dsAux, &NfAux);CHKERRQ(ierr);
+    ierr = PetscDSGetTotalDimension(dsAux, &totDimAux);CHKERRQ(ierr);
+    ierr = PetscDSGetTotalComponents(dsAux, &NcTAux);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentOffsets(dsAux, &aOff);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentDerivativeOffsets(dsAux, &aOff_x);CHKERRQ(ierr);
+    ierr = PetscDSGetEvaluationArrays(dsAux, &a, NULL, &a_x);CHKERRQ(ierr);
+  }
+  NbI = Nb[field];
+  NcI = Nc[field];
+  BI  = B[field];
+  DI  = D[field];
+  ierr = PetscQuadratureGetData(quad, NULL, &qNc, &Nq, &quadPoints, &quadWeights);CHKERRQ(ierr);
+  if (qNc != 1) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_SUP, "Only supports scalar quadrature, not %D components\n", qNc);
+  dE = cgeom->dimEmbed;
+  /* Carve the batch arrays out of one workspace */
+  ierr  = PetscFEVectorGetWorkspace_Private(fe, W*(totDim*(coefficients_t ? 2 : 1) + totDimAux + NcT*(dim+(coefficients_t ? 2 : 1)) + NcTAux*(dim+1) + dim*dim + dim + Nq*NcI*(dim+1) + NbI), &work);CHKERRQ(ierr);
+  cI    = work;          work += totDim*W;
+  if (coefficients_t) {ctI = work; work += totDim*W;}
+  if (dsAux)          {aI  = work; work += totDimAux*W;}
+  uI    = work;          work += NcT*W;
+  uxI   = work;          work += NcT*dim*W;
+  if (coefficients_t) {utI = work; work += NcT*W;}
+  if (dsAux)          {auI = work; work += NcTAux*W; axI = work; work += NcTAux*dim*W;}
+  invJI = work;          work += dim*dim*W;
+  tmp   = work;          work += dim*W;
+  f0I   = work;          work += Nq*NcI*W;
+  f1I   = work;          work += Nq*NcI*dim*W;
+  eI    = work;
+  ierr  = PetscMemzero(f0I, Nq*NcI*(dim+1)*W * sizeof(PetscScalar));CHKERRQ(ierr);
+  for (e0 = 0; e0 < Ne; e0 += W) {
+    const PetscInt Nw = PetscMin(W, Ne-e0);
+    PetscInt       b, c, d, k, w;
+
+    PetscFEVectorInterlace_Private(totDim, Nw, W, &coefficients[e0*totDim], cI);
+    if (ctI) PetscFEVectorInterlace_Private(totDim, Nw, W, &coefficients_t[e0*totDim], ctI);
+    if (aI)  PetscFEVectorInterlace_Private(totDimAux, Nw, W, &coefficientsAux[e0*totDimAux], aI);
+    PetscFEVectorInterlaceReal_Private(dim*dim, Nw, W, &cgeom->invJ[e0*dim*dim], invJI);
+    for (q = 0; q < Nq; ++q) {
+      ierr = PetscFEVectorEvaluateFieldJets_Private(ds, dim, q, Nw, W, invJI, cI, ctI, uI, uxI, utI, tmp);CHKERRQ(ierr);
+      if (dsAux) {ierr = PetscFEVectorEvaluateFieldJets_Private(dsAux, dim, q, Nw, W, invJI, aI, NULL, auI, axI, NULL, tmp);CHKERRQ(ierr);}
+      /* The pointwise functions are called for one cell at a time */
+      for (w = 0; w < Nw; ++w) {
+        const PetscInt   e    = e0+w;
+        const PetscReal *invJ = &cgeom->invJ[e*dim*dim];
+        const PetscReal  wq   = cgeom->detJ[e]*quadWeights[q];
+
+        CoordinatesRefToReal(dE, dim, cgeom->xi, &cgeom->v[e*dE], &cgeom->J[e*dE*dE], &quadPoints[q*dim], x);
+        PetscFEVectorDeinterlace_Private(NcT, W, w, uI, u);
+        PetscFEVectorDeinterlace_Private(NcT*dim, W, w, uxI, u_x);
+        if (utI)   PetscFEVectorDeinterlace_Private(NcT, W, w, utI, u_t);
+        if (dsAux) {
+          PetscFEVectorDeinterlace_Private(NcTAux, W, w, auI, a);
+          PetscFEVectorDeinterlace_Private(NcTAux*dim, W, w, axI, a_x);
+        }
+        if (f0_func) {
+          ierr = PetscMemzero(f0, NcI * sizeof(PetscScalar));CHKERRQ(ierr);
+          f0_func(dim, Nf, NfAux, uOff, uOff_x, u, u_t, u_x, aOff, aOff_x, a, NULL, a_x, t, x, numConstants, constants, f0);
+          for (c = 0; c < NcI; ++c) f0I[(q*NcI+c)*W+w] = f0[c]*wq;
+        }
+        if (f1_func) {
+          ierr = PetscMemzero(f1, NcI*dim * sizeof(PetscScalar));CHKERRQ(ierr);
+          f1_func(dim, Nf, NfAux, uOff, uOff_x, u, u_t, u_x, aOff, aOff_x, a, NULL, a_x, t, x, numConstants, constants, f1);
+          /* Pull f1 back to the reference cell, so that it is contracted with the reference tabulation */
+          for (c = 0; c < NcI; ++c) {
+            for (k = 0; k < dim; ++k) {
+              PetscScalar s = 0.0;
+
+              for (d = 0; d < dim; ++d) s += invJ[k*dim+d]*f1[c*dim+d];
+              f1I[((q*NcI+c)*dim+k)*W+w] = s*wq;
+            }
+          }
+        }
+      }
+    }
+    /* Contract with the test functions, vectorized over the cells of the batch */
+    ierr = PetscMemzero(eI, NbI*W * sizeof(PetscScalar));CHKERRQ(ierr);
+    for (q = 0; q < Nq; ++q) {
+      for (b = 0; b < NbI; ++b) {
+        PetscScalar *eb = &eI[b*W];
+
+        for (c = 0; c < NcI; ++c) {
+          const PetscReal    Bv   = BI[(q*NbI+b)*NcI+c];
+          const PetscScalar *f0qc = &f0I[(q*NcI+c)*W];
+
+          for (w = 0; w < Nw; ++w) eb[w] += Bv*f0qc[w];
+          for (d = 0; d < dim; ++d) {
+            const PetscReal    Dv   = DI[((q*NbI+b)*NcI+c)*dim+d];
+            const PetscScalar *f1qc = &f1I[((q*NcI+c)*dim+d)*W];
+
+            for (w = 0; w < Nw; ++w) eb[w] += Dv*f1qc[w];
+          }
+        }
+      }
+    }
+    for (w = 0; w < Nw; ++w) for (b = 0; b < NbI; ++b) elemVec[(e0+w)*totDim+fOffset+b] = eI[b*W+w];
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscFEIntegrateJacobian_Vector(PetscDS ds, PetscFEJacobianType jtype, PetscInt fieldI, PetscInt fieldJ, PetscInt Ne, PetscFEGeom *cgeom,
+                                               const PetscScalar coefficients[], const PetscScalar coefficients_t[], PetscDS dsAux, const PetscScalar coefficientsAux[], PetscReal t, PetscReal u_tshift, PetscScalar elemMat[])
+{
+  PetscFE            feI, feJ;
+  PetscFE_Vector    *vec;
+  PetscPointJac      g0_func, g1_func, g2_func, g3_func;
+  PetscInt           offsetI = 0, offsetJ = 0;
+  PetscQuadrature    quad;
+  PetscScalar       *g0, *g1, *g2, *g3, *u, *u_t = NULL, *u_x, *a = NULL, *a_x = NULL, *work;
+  PetscScalar       *cI = NULL, *ctI = NULL, *aI = NULL, *uI = NULL, *utI = NULL, *uxI = NULL, *auI = NULL, *axI = NULL, *invJI, *tmp;
+  PetscScalar       *g0I, *g1I, *g2I, *g3I, *tI, *mI;
+  const PetscScalar *constants;
+  PetscReal         *x;
+  PetscReal        **B, **D, *BI, *DI, *BJ, *DJ;
+  PetscInt          *uOff, *uOff_x, *aOff = NULL, *aOff_x = NULL, *Nb, *Nc;
+  PetscInt           NbI, NcI, NbJ, NcJ, NcIJ;
+  PetscInt           dim, numConstants, Nf, NfAux = 0, NcT, NcTAux = 0, totDim, totDimAux = 0, W, e0;
+  PetscBool          supported, supportedAux = PETSC_TRUE;
+  const PetscReal   *quadPoints, *quadWeights;
+  PetscInt           qNc, Nq, q, dE;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscDSGetDiscretization(ds, fieldI, (PetscObject *) &feI);CHKERRQ(ierr);
+  ierr = PetscDSGetDiscretization(ds, fieldJ, (PetscObject *) &feJ);CHKERRQ(ierr);
+  ierr = PetscFEGetSpatialDimension(feI, &dim);CHKERRQ(ierr);
+  ierr = PetscFEVectorSupported_Private(ds, dim, cgeom, &supported);CHKERRQ(ierr);
+  if (dsAux) {ierr = PetscFEVectorSupported_Private(dsAux, dim, cgeom, &supportedAux);CHKERRQ(ierr);}
+  if (!supported || !supportedAux) {
+    ierr = PetscFEIntegrateJacobian_Basic(ds, jtype, fieldI, fieldJ, Ne, cgeom, coefficients, coefficients_t, dsAux, coefficientsAux, t, u_tshift, elemMat);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  vec  = (PetscFE_Vector *) feI->data;
+  W    = vec->width;
+  ierr = PetscFEGetQuadrature(feI, &quad);CHKERRQ(ierr);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalDimension(ds, &totDim);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalComponents(ds, &NcT);CHKERRQ(ierr);
+  ierr = PetscDSGetDimensions(ds, &Nb);CHKERRQ(ierr);
+  ierr = PetscDSGetComponents(ds, &Nc);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentOffsets(ds, &uOff);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentDerivativeOffsets(ds, &uOff_x);CHKERRQ(ierr);
+  switch(jtype) {
+  case PETSCFE_JACOBIAN_DYN: ierr = PetscDSGetDynamicJacobian(ds, fieldI, fieldJ, &g0_func, &g1_func, &g2_func, &g3_func);CHKERRQ(ierr);break;
+  case PETSCFE_JACOBIAN_PRE: ierr = PetscDSGetJacobianPreconditioner(ds, fieldI, fieldJ, &g0_func, &g1_func, &g2_func, &g3_func);CHKERRQ(ierr);break;
+  case PETSCFE_JACOBIAN:     ierr = PetscDSGetJacobian(ds, fieldI, fieldJ, &g0_func, &g1_func, &g2_func, &g3_func);CHKERRQ(ierr);break;
+  }
+  if (!g0_func && !g1_func && !g2_func && !g3_func) PetscFunctionReturn(0);
+  ierr = PetscDSGetEvaluationArrays(ds, &u, coefficients_t ? &u_t : NULL, &u_x);CHKERRQ(ierr);
+  ierr = PetscDSGetWorkspace(ds, &x, NULL, NULL, NULL, NULL);CHKERRQ(ierr);
+  ierr = PetscDSGetWeakFormArrays(ds, NULL, NULL, &g0, &g1, &g2, &g3);CHKERRQ(ierr);
+  ierr = PetscDSGetTabulation(ds, &B, &D);CHKERRQ(ierr);
+  ierr = PetscDSGetFieldOffset(ds, fieldI, &offsetI);CHKERRQ(ierr);
+  ierr = PetscDSGetFieldOffset(ds, fieldJ, &offsetJ);CHKERRQ(ierr);
+  ierr = PetscDSGetConstants(ds, &numConstants, &constants);CHKERRQ(ierr);
+  if (dsAux) {
+    ierr = PetscDSGetNumFields(dsAux, &NfAux);CHKERRQ(ierr);
+    ierr = PetscDSGetTotalDimension(dsAux, &totDimAux);CHKERRQ(ierr);
+    ierr = PetscDSGetTotalComponents(dsAux, &NcTAux);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentOffsets(dsAux, &aOff);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentDerivativeOffsets(dsAux, &aOff_x);CHKERRQ(ierr);
+    ierr = PetscDSGetEvaluationArrays(dsAux, &a, NULL, &a_x);CHKERRQ(ierr);
+  }
+  NbI  = Nb[fieldI], NbJ = Nb[fieldJ];
+  NcI  = Nc[fieldI], NcJ = Nc[fieldJ];
+  BI   = B[fieldI],  BJ  = B[fieldJ];
+  DI   = D[fieldI],  DJ  = D[fieldJ];
+  NcIJ = NcI*NcJ;
+  ierr = PetscQuadratureGetData(quad, NULL, &qNc, &Nq, &quadPoints, &quadWeights);CHKERRQ(ierr);
+  if (qNc != 1) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_SUP, "Only supports scalar quadrature, not %D components\n", qNc);
+  dE = cgeom->dimEmbed;
+  /* Carve the batch arrays out of one workspace */
+  ierr  = PetscFEVectorGetWorkspace_Private(feI, W*(totDim*(coefficients_t ? 2 : 1) + totDimAux + NcT*(dim+(coefficients_t ? 2 : 1)) + NcTAux*(dim+1) + dim*dim + dim + NcIJ*(dim+1)*(dim+1) + NcJ*(dim+1) + NbI*NbJ), &work);CHKERRQ(ierr);
+  if (coefficients) {
+    cI  = work;          work += totDim*W;
+    uI  = work;          work += NcT*W;
+    uxI = work;          work += NcT*dim*W;
+    if (coefficients_t) {ctI = work; work += totDim*W; utI = work; work += NcT*W;}
+  }
+  if (dsAux) {aI = work; work += totDimAux*W; auI = work; work += NcTAux*W; axI = work; work += NcTAux*dim*W;}
+  invJI = work;          work += dim*dim*W;
+  tmp   = work;          work += dim*W;
+  g0I   = work;          work += NcIJ*W;
+  g1I   = work;          work += NcIJ*dim*W;
+  g2I   = work;          work += NcIJ*dim*W;
+  g3I   = work;          work += NcIJ*dim*dim*W;
+  tI    = work;          work += NcJ*(dim+1)*W;
+  mI    = work;
+  for (e0 = 0; e0 < Ne; e0 += W) {
+    const PetscInt Nw = PetscMin(W, Ne-e0);
+    PetscInt       f, fc, g, gc, k, df, dg, d, d2, w;
+
+    if (cI)  PetscFEVectorInterlace_Private(totDim, Nw, W, &coefficients[e0*totDim], cI);
+    if (ctI) PetscFEVectorInterlace_Private(totDim, Nw, W, &coefficients_t[e0*totDim], ctI);
+    if (aI)  PetscFEVectorInterlace_Private(totDimAux, Nw, W, &coefficientsAux[e0*totDimAux], aI);
+    PetscFEVectorInterlaceReal_Private(dim*dim, Nw, W, &cgeom->invJ[e0*dim*dim], invJI);
+    ierr = PetscMemzero(mI, NbI*NbJ*W * sizeof(PetscScalar));CHKERRQ(ierr);
+    for (q = 0; q < Nq; ++q) {
+      const PetscReal *BIq = &BI[q*NbI*NcI],     *BJq = &BJ[q*NbJ*NcJ];
+      const PetscReal *DIq = &DI[q*NbI*NcI*dim], *DJq = &DJ[q*NbJ*NcJ*dim];
+
+      if (cI)    {ierr = PetscFEVectorEvaluateFieldJets_Private(ds, dim, q, Nw, W, invJI, cI, ctI, uI, uxI, utI, tmp);CHKERRQ(ierr);}
+      if (dsAux) {ierr = PetscFEVectorEvaluateFieldJets_Private(dsAux, dim, q, Nw, W, invJI, aI, NULL, auI, axI, NULL, tmp);CHKERRQ(ierr);}
+      /* The pointwise functions are called for one cell at a time, their results are pulled back to the reference cell */
+      for (w = 0; w < Nw; ++w) {
+        const PetscInt   e    = e0+w;
+        const PetscReal *invJ = &cgeom->invJ[e*dim*dim];
+        const PetscReal  wq   = cgeom->detJ[e]*quadWeights[q];
+
+        CoordinatesRefToReal(dE, dim, cgeom->xi, &cgeom->v[e*dE], &cgeom->J[e*dE*dE], &quadPoints[q*dim], x);
+        if (cI) {
+          PetscFEVectorDeinterlace_Private(NcT, W, w, uI, u);
+          PetscFEVectorDeinterlace_Private(NcT*dim, W, w, uxI, u_x);
+          if (utI) PetscFEVectorDeinterlace_Private(NcT, W, w, utI, u_t);
+        }
+        if (dsAux) {
+          PetscFEVectorDeinterlace_Private(NcTAux, W, w, auI, a);
+          PetscFEVectorDeinterlace_Private(NcTAux*dim, W, w, axI, a_x);
+        }
+        if (g0_func) {
+          ierr = PetscMemzero(g0, NcIJ * sizeof(PetscScalar));CHKERRQ(ierr);
+          g0_func(dim, Nf, NfAux, uOff, uOff_x, u, u_t, u_x, aOff, aOff_x, a, NULL, a_x, t, u_tshift, x, numConstants, constants, g0);
+          for (k = 0; k < NcIJ; ++k) g0I[k*W+w] = g0[k]*wq;
+        }
+        if (g1_func) {
+          ierr = PetscMemzero(g1, NcIJ*dim * sizeof(PetscScalar));CHKERRQ(ierr);
+          g1_func(dim, Nf, NfAux, uOff, uOff_x, u, u_t, u_x, aOff, aOff_x, a, NULL, a_x, t, u_tshift, x, numConstants, constants, g1);
+          for (k = 0; k < NcIJ; ++k) {
+            for (dg = 0; dg < dim; ++dg) {
+              PetscScalar s = 0.0;
+
+              for (d = 0; d < dim; ++d) s += invJ[dg*dim+d]*g1[k*dim+d];
+              g1I[(k*dim+dg)*W+w] = s*wq;
+            }
+          }
+        }
+        if (g2_func) {
+          ierr = PetscMemzero(g2, NcIJ*dim * sizeof(PetscScalar));CHKERRQ(ierr);
+          g2_func(dim, Nf, NfAux, uOff, uOff_x, u, u_t, u_x, aOff, aOff_x, a, NULL, a_x, t, u_tshift, x, numConstants, constants, g2);
+          for (k = 0; k < NcIJ; ++k) {
+            for (df = 0; df < dim; ++df) {
+              PetscScalar s = 0.0;
+
+              for (d = 0; d < dim; ++d) s += invJ[df*dim+d]*g2[k*dim+d];
+              g2I[(k*dim+df)*W+w] = s*wq;
+            }
+          }
+        }
+        if (g3_func) {
+          ierr = PetscMemzero(g3, NcIJ*dim*dim * sizeof(PetscScalar));CHKERRQ(ierr);
+          g3_func(dim, Nf, NfAux, uOff, uOff_x, u, u_t, u_x, aOff, aOff_x, a, NULL, a_x, t, u_tshift, x, numConstants, constants, g3);
+          for (k = 0; k < NcIJ; ++k) {
+            for (df = 0; df < dim; ++df) {
+              for (dg = 0; dg < dim; ++dg) {
+                PetscScalar s = 0.0;
+
+                for (d = 0; d < dim; ++d) for (d2 = 0; d2 < dim; ++d2) s += invJ[df*dim+d]*g3[(k*dim+d)*dim+d2]*invJ[dg*dim+d2];
+                g3I[((k*dim+df)*dim+dg)*W+w] = s*wq;
+              }
+            }
+          }
+        }
+      }
+      /* Contract with the test and then the trial functions, vectorized over the cells of the batch.
+         tI[(gc*(dim+1))*W] multiplies the trial function values and tI[(gc*(dim+1)+1+dg)*W] their derivatives. */
+      for (f = 0; f < NbI; ++f) {
+        ierr = PetscMemzero(tI, NcJ*(dim+1)*W * sizeof(PetscScalar));CHKERRQ(ierr);
+        for (fc = 0; fc < NcI; ++fc) {
+          const PetscReal  Bf = BIq[f*NcI+fc];
+          const PetscReal *Df = &DIq[(f*NcI+fc)*dim];
+
+          for (gc = 0; gc < NcJ; ++gc) {
+            const PetscInt k  = fc*NcJ+gc;
+            PetscScalar   *t0 = &tI[gc*(dim+1)*W];
+
+            if (g0_func) {for (w = 0; w < Nw; ++w) t0[w] += Bf*g0I[k*W+w];}
+            if (g2_func) {for (df = 0; df < dim; ++df) for (w = 0; w < Nw; ++w) t0[w] += Df[df]*g2I[(k*dim+df)*W+w];}
+            for (dg = 0; dg < dim; ++dg) {
+              PetscScalar *tg = &tI[(gc*(dim+1)+1+dg)*W];
+
+              if (g1_func) {for (w = 0; w < Nw; ++w) tg[w] += Bf*g1I[(k*dim+dg)*W+w];}
+              if (g3_func) {for (df = 0; df < dim; ++df) for (w = 0; w < Nw; ++w) tg[w] += Df[df]*g3I[((k*dim+df)*dim+dg)*W+w];}
+            }
+          }
+        }
+        for (g = 0; g < NbJ; ++g) {
+          PetscScalar *m = &mI[(f*NbJ+g)*W];
+
+          for (gc = 0; gc < NcJ; ++gc) {
+            const PetscReal    Bg = BJq[g*NcJ+gc];
+            const PetscScalar *t0 = &tI[gc*(dim+1)*W];
+
+            for (w = 0; w < Nw; ++w) m[w] += Bg*t0[w];
+            for (dg = 0; dg < dim; ++dg) {
+              const PetscReal    Dg = DJq[(g*NcJ+gc)*dim+dg];
+              const PetscScalar *tg = &tI[(gc*(dim+1)+1+dg)*W];
+
+              for (w = 0; w < Nw; ++w) m[w] += Dg*tg[w];
+            }
+          }
+        }
+      }
+    }
+    for (w = 0; w < Nw; ++w) {
+      PetscScalar *eMat = &elemMat[(e0+w)*totDim*totDim];
+
+      for (f = 0; f < NbI; ++f) for (g = 0; g < NbJ; ++g) eMat[(offsetI+f)*totDim+offsetJ+g] += mI[(f*NbJ+g)*W+w];
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscFEInitialize_Vector(PetscFE fem)
+{
+  PetscFunctionBegin;
+  fem->ops->setfromoptions          = PetscFESetFromOptions_Vector;
+  fem->ops->setup                   = PetscFESetUp_Basic;
+  fem->ops->view                    = PetscFEView_Vector;
+  fem->ops->destroy                 = PetscFEDestroy_Vector;
+  fem->ops->getdimension            = PetscFEGetDimension_Basic;
+  fem->ops->gettabulation           = PetscFEGetTabulation_Basic;
+  fem->ops->integrate               = PetscFEIntegrate_Basic;
+  fem->ops->integratebd             = PetscFEIntegrateBd_Basic;
+  fem->ops->integrateresidual       = PetscFEIntegrateResidual_Vector;
+  fem->ops->integratebdresidual     = PetscFEIntegrateBdResidual_Basic;
+  fem->ops->integratejacobianaction = NULL;
+  fem->ops->integratejacobian       = PetscFEIntegrateJacobian_Vector;
+  fem->ops->integratebdjacobian     = PetscFEIntegrateBdJacobian_Basic;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+  PETSCFEVECTOR = "vector" - A PetscFE object that integrates the volume residual and Jacobian for a batch of cells
+  at a time, with the cell index innermost, so that the contractions with the basis tabulation vectorize across cells
+
+  Options Database:
+. -petscfe_vector_width <8> - The number of cells in a batch, a multiple of the SIMD width is a good choice
+
+  Notes:
+  The pointwise functions are called for each cell and quadrature point as with PETSCFEBASIC. Affine cells whose fields
+  need no Piola transform are batched, all other cases and boundary integrals use the PETSCFEBASIC kernels.
+
+  Level: intermediate
+
+.seealso: PetscFEType, PetscFECreate(), PetscFESetType(), PETSCFEBASIC
+M*/
+
+PETSC_EXTERN PetscErrorCode PetscFECreate_Vector(PetscFE fem)
+{
+  PetscFE_Vector *v;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(fem, PETSCFE_CLASSID, 1);
+  ierr      = PetscNewLog(fem,&v);CHKERRQ(ierr);
+  fem->data = v;
+  v->width  = 8;
+
+  ierr = PetscFEInitialize_Vector(fem);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -1369,6 +1369,74 @@ PetscErrorCode PetscFEIntegrateJacobian(PetscDS prob, PetscFEJacobianType jtype,
   PetscFunctionReturn(0);
 }
 
+/*@C
+  PetscFEHasJacobianAction - Check whether the PetscFE can apply the element Jacobian without forming it
+
+  Not collective
+
+  Input Parameter:
+. fem - The PetscFE object
+
+  Output Parameter:
+. has - PETSC_TRUE if PetscFEIntegrateJacobianAction() is available
+
+  Level: developer
+
+.seealso: PetscFEIntegrateJacobianAction(), PetscFEIntegrateJacobian()
+@*/
+PetscErrorCode PetscFEHasJacobianAction(PetscFE fem, PetscBool *has)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(fem, PETSCFE_CLASSID, 1);
+  PetscValidPointer(has, 2);
+  *has = fem->ops->integratejacobianaction ? PETSC_TRUE : PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  PetscFEIntegrateJacobianAction - Apply the element Jacobian for a chunk of elements to element vectors, without forming the element matrices
+
+  Not collective
+
+  Input Parameters:
++ prob         - The PetscDS specifying the discretizations and continuum functions
+. jtype        - The type of matrix pointwise functions that should be used
+. fieldI       - The test field being integrated
+. fieldJ       - The basis field being integrated
+. Ne           - The number of elements in the chunk
+. cgeom        - The cell geometry for each cell in the chunk
+. coefficients - The array of FEM basis coefficients for the elements for the Jacobian evaluation point
+. coefficients_t - The array of FEM basis time derivative coefficients for the elements
+. probAux      - The PetscDS specifying the auxiliary discretizations
+. coefficientsAux - The array of FEM auxiliary basis coefficients for the elements
+. t            - The time
+. u_tShift     - A multiplier for the dF/du_t term (as opposed to the dF/du term)
+- y            - The array of FEM basis coefficients for the elements the Jacobian is applied to, in the same layout as coefficients
+
+  Output Parameter
+. elemVec      - the element vectors, to which the action of the fieldI-fieldJ block of the element Jacobian on y is added
+
+  Note:
+  This is only available for implementations where PetscFEHasJacobianAction() is true, such as PETSCFESUMFACT.
+
+  Level: developer
+
+.seealso: PetscFEIntegrateJacobian(), PetscFEHasJacobianAction()
+@*/
+PetscErrorCode PetscFEIntegrateJacobianAction(PetscDS prob, PetscFEJacobianType jtype, PetscInt fieldI, PetscInt fieldJ, PetscInt Ne, PetscFEGeom *cgeom,
+                                              const PetscScalar coefficients[], const PetscScalar coefficients_t[], PetscDS probAux, const PetscScalar coefficientsAux[], PetscReal t, PetscReal u_tshift, const PetscScalar y[], PetscScalar elemVec[])
+{
+  PetscFE        fe;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(prob, PETSCDS_CLASSID, 1);
+  ierr = PetscDSGetDiscretization(prob, fieldI, (PetscObject *) &fe);CHKERRQ(ierr);
+  if (!fe->ops->integratejacobianaction) SETERRQ1(PetscObjectComm((PetscObject) fe), PETSC_ERR_SUP, "PetscFE type %s cannot apply the Jacobian without forming it", ((PetscObject) fe)->type_name);
+  ierr = (*fe->ops->integratejacobianaction)(prob, jtype, fieldI, fieldJ, Ne, cgeom, coefficients, coefficients_t, probAux, coefficientsAux, t, u_tshift, y, elemVec);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
   PetscFEIntegrateBdJacobian - Produce the boundary element Jacobian for a chunk of elements by quadrature integration
 
@@ -174,6 +174,8 @@ PetscErrorCode PetscDualSpaceRegisterAll(void)
 PETSC_EXTERN PetscErrorCode PetscFECreate_Basic(PetscFE);
 PETSC_EXTERN PetscErrorCode PetscFECreate_Nonaffine(PetscFE);
 PETSC_EXTERN PetscErrorCode PetscFECreate_Composite(PetscFE);
+PETSC_EXTERN PetscErrorCode PetscFECreate_Vector(PetscFE);
+PETSC_EXTERN PetscErrorCode PetscFECreate_SumFact(PetscFE);
 #if defined(PETSC_HAVE_OPENCL)
 PETSC_EXTERN PetscErrorCode PetscFECreate_OpenCL(PetscFE);
 #endif
@@ -201,6 +203,8 @@ PetscErrorCode PetscFERegisterAll(void)
 
   ierr = PetscFERegister(PETSCFEBASIC,     PetscFECreate_Basic);CHKERRQ(ierr);
   ierr = PetscFERegister(PETSCFECOMPOSITE, PetscFECreate_Composite);CHKERRQ(ierr);
+  ierr = PetscFERegister(PETSCFEVECTOR,    PetscFECreate_Vector);CHKERRQ(ierr);
+  ierr = PetscFERegister(PETSCFESUMFACT,   PetscFECreate_SumFact);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_OPENCL)
   ierr = PetscFERegister(PETSCFEOPENCL, PetscFECreate_OpenCL);CHKERRQ(ierr);
 #endif
@@ -0,0 +1,109 @@
+static char help[] = "Solves a Laplacian with the preconditioner built from a MATAIJSINGLE copy of the operator.\n\
+The Krylov method applies the MATAIJ operator, the smoothers use the single precision values.\n\
+Input parameters include:\n\
+  -m <mesh_x>        : number of mesh points in x-direction\n\
+  -n <mesh_y>        : number of mesh points in y-direction\n\
+  -single_operator   : the Krylov method also applies the MATAIJSINGLE matrix\n\n";
+
+#include <petscksp.h>
+
+int main(int argc,char **args)
+{
+  Vec            x,b,u;
+  Mat            A,P;
+  KSP            ksp;
+  PetscInt       i,j,Ii,J,Istart,Iend,m = 16,n = 16;
+  PetscScalar    v;
+  PetscReal      norm,unorm;
+  PetscBool      single = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-single_operator",&single,NULL);CHKERRQ(ierr);
+
+  /* variable coefficient 5-point stencil, the entries are not exactly representable in single precision */
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,m*n,m*n);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,5,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,5,NULL,5,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (Ii=Istart; Ii<Iend; Ii++) {
+    PetscScalar diag = 0.0;
+
+    v = -1.0 - 0.1/(1.0 + (PetscReal)(Ii%3)); i = Ii/n; j = Ii - i*n;
+    if (i>0)   {J = Ii - n; ierr = MatSetValues(A,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);diag -= v;}
+    if (i<m-1) {J = Ii + n; ierr = MatSetValues(A,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);diag -= v;}
+    if (j>0)   {J = Ii - 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);diag -= v;}
+    if (j<n-1) {J = Ii + 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);diag -= v;}
+    diag += 0.3; ierr = MatSetValues(A,1,&Ii,1,&Ii,&diag,ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatConvert(A,MATAIJSINGLE,MAT_INITIAL_MATRIX,&P);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&u,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&x);CHKERRQ(ierr);
+  ierr = VecSet(u,1.0);CHKERRQ(ierr);
+
+  /* the products only differ by the rounding of the entries to single precision */
+  ierr = MatMult(P,u,x);CHKERRQ(ierr);
+  ierr = MatMult(A,u,b);CHKERRQ(ierr);
+  ierr = VecAXPY(x,-1.0,b);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  if (norm > 1.e-6) {ierr = PetscPrintf(PETSC_COMM_WORLD,"MatMult() of MATAIJSINGLE differs by %g\n",(double)norm);CHKERRQ(ierr);}
+  ierr = MatMultAdd(P,u,b,x);CHKERRQ(ierr);
+  ierr = VecAXPBY(x,-2.0,1.0,b);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  if (norm > 1.e-6) {ierr = PetscPrintf(PETSC_COMM_WORLD,"MatMultAdd() of MATAIJSINGLE differs by %g\n",(double)norm);CHKERRQ(ierr);}
+
+  /* with the single precision operator the right hand side is its product, so the solution is still u */
+  if (single) {ierr = MatMult(P,u,b);CHKERRQ(ierr);}
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,single ? P : A,P);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(ksp,1.e-10,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+  ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+
+  /* the solution is accurate to the tolerance of the solver, not to single precision */
+  ierr = VecAXPY(x,-1.0,u);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_2,&norm);CHKERRQ(ierr);
+  ierr = VecNorm(u,NORM_2,&unorm);CHKERRQ(ierr);
+  if (norm > 1.e-8*unorm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Relative error %g\n",(double)(norm/unorm));CHKERRQ(ierr);}
+
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = VecDestroy(&u);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&P);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   build:
+      requires: !complex
+
+   test:
+      args: -ksp_type cg -pc_type sor -ksp_converged_reason
+
+   test:
+      suffix: 2
+      nsize: 2
+      args: -single_operator -ksp_type cg -pc_type jacobi -ksp_converged_reason
+
+   test:
+      suffix: 3
+      nsize: 2
+      args: -ksp_type cg -pc_type bjacobi -sub_pc_type sor -sub_pc_sor_symmetric -ksp_converged_reason
+
+   test:
+      suffix: gamg
+      nsize: 2
+      args: -ksp_type cg -pc_type gamg -mg_levels_ksp_type chebyshev -mg_levels_pc_type sor -ksp_converged_reason
+
+TEST*/
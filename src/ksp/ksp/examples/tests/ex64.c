@@ -0,0 +1,171 @@
+static char help[] = "Tests the reuse of the Galerkin coarse operators of PCMG and PCGAMG when the operator is changed.\n\
+The values of the operator are changed first, then its nonzero pattern.\n\
+Input parameters include:\n\
+  -m <mesh_x>   : number of mesh points in x-direction\n\
+  -n <mesh_y>   : number of mesh points in y-direction\n\
+  -levels <l>   : number of levels for PCMG\n\n";
+
+#include <petscksp.h>
+
+/* 5-point Laplacian scaled by s, with the diagonal couplings of a 9-point stencil if requested */
+static PetscErrorCode AssembleOperator(Mat A,PetscInt m,PetscInt n,PetscScalar s,PetscBool diagonals)
+{
+  PetscInt       i,j,Ii,J,Istart,Iend;
+  PetscScalar    v = -s,d;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = MatZeroEntries(A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (Ii=Istart; Ii<Iend; Ii++) {
+    i = Ii/n; j = Ii - i*n; d = 4.0*s;
+    if (i>0)   {J = Ii - n; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {J = Ii + n; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {J = Ii - 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<n-1) {J = Ii + 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (diagonals) {
+      PetscScalar w = -0.25*s;
+      if (i>0 && j>0)     {J = Ii - n - 1; ierr = MatSetValues(A,1,&Ii,1,&J,&w,INSERT_VALUES);CHKERRQ(ierr); d -= w;}
+      if (i>0 && j<n-1)   {J = Ii - n + 1; ierr = MatSetValues(A,1,&Ii,1,&J,&w,INSERT_VALUES);CHKERRQ(ierr); d -= w;}
+      if (i<m-1 && j>0)   {J = Ii + n - 1; ierr = MatSetValues(A,1,&Ii,1,&J,&w,INSERT_VALUES);CHKERRQ(ierr); d -= w;}
+      if (i<m-1 && j<n-1) {J = Ii + n + 1; ierr = MatSetValues(A,1,&Ii,1,&J,&w,INSERT_VALUES);CHKERRQ(ierr); d -= w;}
+    }
+    ierr = MatSetValues(A,1,&Ii,1,&Ii,&d,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* piecewise constant interpolation from pairs of consecutive unknowns, to a level with M unknowns, mlocal of them on this process */
+static PetscErrorCode CreateInterpolation(MPI_Comm comm,PetscInt mlocal,PetscInt M,Mat *P)
+{
+  PetscInt       Ii,J,Istart,Iend;
+  PetscScalar    one = 1.0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = MatCreateAIJ(comm,mlocal,PETSC_DECIDE,M,(M+1)/2,1,NULL,1,NULL,P);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(*P,&Istart,&Iend);CHKERRQ(ierr);
+  for (Ii=Istart; Ii<Iend; Ii++) {
+    J    = Ii/2;
+    ierr = MatSetValues(*P,1,&Ii,1,&J,&one,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(*P,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*P,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* compares each coarse operator with the product computed from scratch, and counts the ones that are the same objects as before */
+static PetscErrorCode CheckCoarseOperators(KSP ksp,Mat coarse[],PetscInt *nlevels,PetscInt *nwrong,PetscInt *nsame)
+{
+  PC             pc;
+  KSP            smoother;
+  Mat            Af,Ac,P,C;
+  PetscInt       l;
+  PetscReal      norm,cnorm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  *nwrong = *nsame = 0;
+  ierr = KSPGetPC(ksp,&pc);CHKERRQ(ierr);
+  ierr = PCMGGetLevels(pc,nlevels);CHKERRQ(ierr);
+  for (l=*nlevels-1; l>0; l--) {
+    ierr = PCMGGetSmoother(pc,l,&smoother);CHKERRQ(ierr);
+    ierr = KSPGetOperators(smoother,NULL,&Af);CHKERRQ(ierr);
+    ierr = PCMGGetSmoother(pc,l-1,&smoother);CHKERRQ(ierr);
+    ierr = KSPGetOperators(smoother,NULL,&Ac);CHKERRQ(ierr);
+    ierr = PCMGGetInterpolation(pc,l,&P);CHKERRQ(ierr);
+    ierr = MatPtAP(Af,P,MAT_INITIAL_MATRIX,2.0,&C);CHKERRQ(ierr);
+    ierr = MatNorm(Ac,NORM_FROBENIUS,&cnorm);CHKERRQ(ierr);
+    ierr = MatAXPY(C,-1.0,Ac,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
+    ierr = MatNorm(C,NORM_FROBENIUS,&norm);CHKERRQ(ierr);
+    ierr = MatDestroy(&C);CHKERRQ(ierr);
+    if (norm > 1.e-10*cnorm) (*nwrong)++;
+    if (Ac == coarse[l-1]) (*nsame)++;
+    coarse[l-1] = Ac;
+  }
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Vec            x,b;
+  Mat            A,P[10],coarse[10];
+  KSP            ksp;
+  PC             pc;
+  PetscInt       l,m = 16,n = 16,levels = 3,nlevels,nwrong,nsame,step;
+  PetscBool      ismg;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-levels",&levels,NULL);CHKERRQ(ierr);
+  if (levels < 2 || levels > 10) SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_ARG_OUTOFRANGE,"Number of levels must be between 2 and 10");
+
+  /* preallocated for the 9-point stencil, only the 5-point one is set at first */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*n,m*n,9,NULL,9,NULL,&A);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = AssembleOperator(A,m,n,1.0,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecSet(b,1.0);CHKERRQ(ierr);
+
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+  ierr = KSPGetPC(ksp,&pc);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)pc,PCMG,&ismg);CHKERRQ(ierr);
+  if (ismg) {
+    ierr = PCMGSetLevels(pc,levels,NULL);CHKERRQ(ierr);
+    ierr = PCMGSetGalerkin(pc,PC_MG_GALERKIN_BOTH);CHKERRQ(ierr);
+    for (l=levels-1; l>0; l--) {
+      PetscInt mlocal,M;
+
+      if (l == levels-1) {
+        ierr = MatGetLocalSize(A,&mlocal,NULL);CHKERRQ(ierr);
+        ierr = MatGetSize(A,&M,NULL);CHKERRQ(ierr);
+      } else {
+        ierr = MatGetLocalSize(P[l+1],NULL,&mlocal);CHKERRQ(ierr);
+        ierr = MatGetSize(P[l+1],NULL,&M);CHKERRQ(ierr);
+      }
+      ierr = CreateInterpolation(PETSC_COMM_WORLD,mlocal,M,&P[l]);CHKERRQ(ierr);
+      ierr = PCMGSetInterpolation(pc,l,P[l]);CHKERRQ(ierr);
+    }
+  }
+  for (l=0; l<10; l++) coarse[l] = NULL;
+
+  for (step=0; step<4; step++) {
+    if (step == 1) {ierr = AssembleOperator(A,m,n,2.0,PETSC_FALSE);CHKERRQ(ierr);}
+    if (step == 2) {ierr = AssembleOperator(A,m,n,2.0,PETSC_TRUE);CHKERRQ(ierr);}
+    if (step == 3) {ierr = AssembleOperator(A,m,n,0.5,PETSC_TRUE);CHKERRQ(ierr);}
+    ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+    ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+    ierr = CheckCoarseOperators(ksp,coarse,&nlevels,&nwrong,&nsame);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Solve %D: %D levels, wrong coarse operators %D, reused coarse operators %D\n",step,nlevels,nwrong,nsame);CHKERRQ(ierr);
+  }
+
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  if (ismg) {
+    for (l=levels-1; l>0; l--) {ierr = MatDestroy(&P[l]);CHKERRQ(ierr);}
+  }
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: mg
+      nsize: 2
+      args: -ksp_type cg -pc_type mg -levels 3
+
+   test:
+      suffix: gamg
+      nsize: 2
+      args: -ksp_type cg -pc_type gamg -pc_gamg_reuse_interpolation -m 32 -n 32
+
+TEST*/
@@ -0,0 +1,66 @@
+static char help[] = "Solves a 2d Laplacian whose first diagonal entry is zero with ILU, to test the zero pivot shifts of the factorization.\n\
+Input parameters include:\n\
+  -m <mesh_x>   : number of mesh points in x-direction\n\
+  -n <mesh_y>   : number of mesh points in y-direction\n\n";
+
+#include <petscksp.h>
+
+int main(int argc,char **args)
+{
+  Mat            A;
+  Vec            x,b;
+  KSP            ksp;
+  PetscInt       i,j,Ii,J,Istart,Iend,m = 8,n = 8;
+  PetscScalar    v;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,m*n,m*n);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSetUp(A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (Ii=Istart; Ii<Iend; Ii++) {
+    v = -1.0; i = Ii/n; j = Ii - i*n;
+    if (i>0)   {J = Ii - n; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {J = Ii + n; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {J = Ii - 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<n-1) {J = Ii + 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    /* the first pivot of the factorization is zero */
+    v = Ii ? 4.0 : 0.0; ierr = MatSetValues(A,1,&Ii,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecSet(b,1.0);CHKERRQ(ierr);
+
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+  ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: chowilu
+      args: -ksp_type gmres -pc_type ilu -pc_factor_mat_solver_type chowilu -ksp_converged_reason -pc_factor_shift_type {{none nonzero positive_definite inblocks}separate output}
+
+   test:
+      suffix: chowilu_info
+      args: -ksp_type gmres -pc_type ilu -pc_factor_mat_solver_type chowilu -pc_factor_shift_type {{nonzero positive_definite inblocks}separate output} -info
+      requires: double
+      filter: grep -oE "MatLUFactorNumeric_SeqAIJ_ChowILU\(\): number of shift_[a-z]* (tries|applied) [0-9]*"
+
+TEST*/
@@ -257,6 +257,10 @@ int main(int argc,char **args)
       suffix: fbcgs
       args: -ksp_type fbcgs -pc_type ilu
 
+   test:
+      suffix: chowilu
+      args: -m 20 -n 20 -pc_type ilu -pc_factor_mat_solver_type chowilu -ksp_monitor_short
+
    test:
       suffix: fbcgs_2
       nsize: 3
@@ -297,6 +301,49 @@ int main(int argc,char **args)
       args: -ksp_monitor_short -ksp_type pipelcg -m 9 -n 9 -pc_type none -ksp_pipelcg_pipel 2 -ksp_pipelcg_lmax 2
       filter: grep -v "sqrt breakdown in iteration"
 
+   test:
+      suffix: scg
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type scg -ksp_scg_s 3 -m 9 -n 9
+
+   test:
+      suffix: scg_basis
+      nsize: 3
+      args: -ksp_converged_reason -ksp_type scg -ksp_scg_s 8 -ksp_scg_basis {{newton chebyshev monomial}separate output} -m 40 -n 40 -ksp_rtol 1e-10
+      filter: grep -v "Norm of error"
+
+   test:
+      suffix: scg_eigenvalues
+      nsize: 3
+      args: -ksp_converged_reason -ksp_type scg -ksp_scg_s 8 -ksp_scg_basis {{newton chebyshev monomial}separate output} -ksp_scg_eigenvalues 0.01,1.6 -m 40 -n 40 -ksp_rtol 1e-10
+      filter: grep -v "Norm of error"
+
+   test:
+      suffix: scg_eigenvalues_loose
+      nsize: 3
+      args: -ksp_converged_reason -ksp_type scg -ksp_scg_s 8 -ksp_scg_basis {{newton chebyshev}separate output} -ksp_scg_eigenvalues 0.01,2 -m 40 -n 40 -ksp_rtol 1e-10 -info
+      filter: grep -E "^Linear solve|KSPSolve_SCG"
+
+   test:
+      suffix: cholqr
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type {{gmres fgmres lgmres}separate output} -ksp_gmres_cholqr -ksp_gmres_cgs_refinement_type {{refine_never refine_ifneeded refine_always}} -ksp_gmres_restart 8 -m 9 -n 9
+
+   test:
+      suffix: sgmres
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type sgmres -ksp_sgmres_s 4 -ksp_gmres_restart 5 -m 9 -n 9
+
+   test:
+      suffix: contiguous
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type {{gmres fgmres}separate output} -ksp_gmres_contiguous -ksp_gmres_restart 16 -m 9 -n 9
+
+   test:
+      suffix: contiguous_gcr
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type gcr -ksp_gcr_contiguous -ksp_gcr_restart 16 -m 9 -n 9
+
    test:
       suffix: sell
       args: -ksp_monitor_short -ksp_gmres_cgs_refinement_type refine_always -m 9 -n 9 -mat_type sell
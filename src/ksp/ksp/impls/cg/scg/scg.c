@@ -0,0 +1,569 @@
+/*
+    This file implements SCG, an s-step (communication avoiding) variant of the preconditioned conjugate gradient method.
+
+    Each outer iteration builds bases of the Krylov spaces of the search direction and of the residual, s+1 and s vectors,
+    with a polynomial recurrence and no inner products, computes all the inner products among them with a single global
+    reduction and then runs s steps of CG on the coordinates of the iterates in these bases.
+
+    Reference: E. Carson, Communication-avoiding Krylov subspace methods in theory and practice, PhD thesis, UC Berkeley, 2015.
+*/
+#include <../src/ksp/ksp/impls/cg/cgimpl.h>       /*I "petscksp.h" I*/
+extern PetscErrorCode KSPComputeExtremeSingularValues_CG(KSP,PetscReal*,PetscReal*);
+extern PetscErrorCode KSPComputeEigenvalues_CG(KSP,PetscInt,PetscReal*,PetscReal*,PetscInt*);
+
+typedef struct {
+  KSP_CG            cg;                /* must be first, its Lanczos data is used by KSPComputeEigenvalues_CG() */
+  PetscInt          s;                 /* number of CG steps per reduction */
+  KSPSStepBasisType basis;             /* polynomial basis of the blocks */
+  PetscReal         interval[2];       /* eigenvalue bounds given by the user, for the basis */
+  PetscBool         userinterval;
+  PetscBool         basisready;        /* otherwise the first iterations run with s = 1 to estimate the eigenvalues */
+  PetscInt          nwarmup;           /* number of iterations with s = 1 */
+  PetscInt          nrestarts;         /* number of restarts after the s-step iteration stalled */
+  PetscInt          nlanczos;          /* length of the Lanczos arrays of cg */
+  PetscScalar       *alpha,*beta,*gamma;
+  PetscScalar       *G,*Gn,*B;         /* Gram matrix, Gram matrix of the norm and change of basis of the operator */
+  PetscScalar       *cx,*cr,*cp,*w;    /* coordinates of the iterates in the basis */
+  PetscReal         *eigr,*eigi;
+  Vec               *Yh,*Y,*pool;      /* unpreconditioned and preconditioned basis, Y = B Yh, and unused work vectors */
+  Vec               up,p,r,z;          /* p = B up, z = B r, the starting vectors of a block */
+  Vec               xtmp;
+  PetscInt          n;                 /* size of the current basis */
+  PetscBool         inblock;           /* the solution is ksp->vec_sol + Y cx */
+} KSP_SCG;
+
+static PetscErrorCode KSPSetUp_SCG(KSP ksp)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  KSP_CG         *cg = &scg->cg;
+  PetscInt       s = scg->s,nmax = 2*s+1,k,nint;
+  PetscReal      c,d;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSetWorkVecs(ksp,2*nmax+4);CHKERRQ(ierr);
+  ierr = PetscMalloc3(s,&scg->alpha,s,&scg->beta,s,&scg->gamma);CHKERRQ(ierr);
+  ierr = PetscMalloc7(nmax*nmax,&scg->G,nmax*nmax,&scg->Gn,nmax*nmax,&scg->B,nmax,&scg->cx,nmax,&scg->cr,nmax,&scg->cp,nmax,&scg->w);CHKERRQ(ierr);
+  ierr = PetscMalloc3(nmax,&scg->Yh,nmax,&scg->Y,2*nmax+4,&scg->pool);CHKERRQ(ierr);
+
+  /* the Lanczos tridiagonal matrix of the first iterations gives the eigenvalue estimates of the basis */
+  scg->nwarmup  = 2*s;
+  scg->nlanczos = scg->nwarmup+1;
+  if (ksp->calc_sings) scg->nlanczos = PetscMax(scg->nlanczos,ksp->max_it+1);
+  ierr = PetscMalloc4(scg->nlanczos,&cg->e,scg->nlanczos,&cg->d,scg->nlanczos,&cg->ee,scg->nlanczos,&cg->dd);CHKERRQ(ierr);
+  ierr = PetscMalloc2(scg->nlanczos,&scg->eigr,scg->nlanczos,&scg->eigi);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,(3*s+3*nmax*nmax+4*nmax+2*scg->nlanczos)*sizeof(PetscScalar)+4*scg->nlanczos*sizeof(PetscReal));CHKERRQ(ierr);
+  if (ksp->calc_sings) {
+    ksp->ops->computeextremesingularvalues = KSPComputeExtremeSingularValues_CG;
+    ksp->ops->computeeigenvalues           = KSPComputeEigenvalues_CG;
+  }
+
+  scg->basisready = PETSC_FALSE;
+  if (scg->basis == KSP_SSTEP_BASIS_MONOMIAL) {
+    ierr = KSPSStepBasisCoefficients_Private(scg->basis,0,NULL,NULL,s,scg->alpha,scg->beta,scg->gamma);CHKERRQ(ierr);
+    scg->basisready = PETSC_TRUE;
+  } else if (scg->userinterval) {
+    /* the Chebyshev basis needs the ends of the interval, the Newton basis uses the roots of the Chebyshev polynomial */
+    c = 0.5*(scg->interval[0] + scg->interval[1]);
+    d = 0.5*(scg->interval[1] - scg->interval[0]);
+    if (scg->basis == KSP_SSTEP_BASIS_CHEBYSHEV) {
+      nint = 2;
+      scg->eigr[0] = scg->interval[0];
+      scg->eigr[1] = scg->interval[1];
+    } else {
+      nint = s;
+      for (k=0; k<s; k++) scg->eigr[k] = c + d*PetscCosReal((2*k+1)*PETSC_PI/(2*s));
+    }
+    for (k=0; k<nint; k++) scg->eigi[k] = 0.0;
+    ierr = KSPSStepBasisCoefficients_Private(scg->basis,nint,scg->eigr,scg->eigi,s,scg->alpha,scg->beta,scg->gamma);CHKERRQ(ierr);
+    scg->basisready = PETSC_TRUE;
+  }
+  PetscFunctionReturn(0);
+}
+
+/* returns u^H M v for the n x n matrix M */
+PETSC_STATIC_INLINE PetscScalar KSPSCGInner(PetscInt n,const PetscScalar *M,const PetscScalar *u,const PetscScalar *v)
+{
+  PetscInt    i,j;
+  PetscScalar sum = 0.0,t;
+
+  for (j=0; j<n; j++) {
+    if (v[j] == 0.0) continue;
+    t = 0.0;
+    for (i=0; i<n; i++) t += PetscConj(u[i])*M[i+j*n];
+    sum += t*v[j];
+  }
+  return sum;
+}
+
+/*
+    KSPSCGBuildBasis - Builds the basis of a block of sb steps
+
+    The first sb+1 columns of Yh and Y span the Krylov space of p = B up and the last sb ones the Krylov space of z = B r,
+    with gamma_t yh_{t+1} = A y_t - alpha_t yh_t - beta_t yh_{t-1} and y_{t+1} = B yh_{t+1}, so A Y = Yh Bm in the columns
+    that are not the last of their part, for the block tridiagonal Bm computed here.
+*/
+static PetscErrorCode KSPSCGBuildBasis(KSP ksp,Mat Amat,PetscInt sb,const PetscScalar *alpha,const PetscScalar *beta,const PetscScalar *gamma)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscInt       n = 2*sb+1,o,m,t,k,np = 0;
+  Vec            *Yh = scg->Yh,*Y = scg->Y;
+  PetscScalar    *Bm = scg->B;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (k=0; k<ksp->nwork; k++) {
+    if (ksp->work[k] != scg->up && ksp->work[k] != scg->p && ksp->work[k] != scg->r && ksp->work[k] != scg->z) scg->pool[np++] = ksp->work[k];
+  }
+  Yh[0] = scg->up; Y[0] = scg->p;
+  Yh[sb+1] = scg->r; Y[sb+1] = scg->z;
+  for (k=1; k<n; k++) {
+    if (k == sb+1) continue;
+    Yh[k] = scg->pool[--np];
+    Y[k]  = scg->pool[--np];
+  }
+  ierr = PetscMemzero(Bm,n*n*sizeof(PetscScalar));CHKERRQ(ierr);
+  for (o=0; o<n; o+=sb+1) {
+    m = o ? sb : sb+1;
+    for (t=0; t<m-1; t++) {
+      ierr = KSP_MatMult(ksp,Amat,Y[o+t],Yh[o+t+1]);CHKERRQ(ierr);
+      if (t) {
+        ierr = VecAXPBYPCZ(Yh[o+t+1],-alpha[t]/gamma[t],-beta[t]/gamma[t],1.0/gamma[t],Yh[o+t],Yh[o+t-1]);CHKERRQ(ierr);
+      } else {
+        ierr = VecAXPBY(Yh[o+t+1],-alpha[t]/gamma[t],1.0/gamma[t],Yh[o+t]);CHKERRQ(ierr);
+      }
+      ierr = KSP_PCApply(ksp,Yh[o+t+1],Y[o+t+1]);CHKERRQ(ierr);
+      Bm[o+t+1+(o+t)*n] = gamma[t];
+      Bm[o+t+(o+t)*n]   = alpha[t];
+      if (t) Bm[o+t-1+(o+t)*n] = beta[t];
+    }
+  }
+  scg->n = n;
+  PetscFunctionReturn(0);
+}
+
+/* one reduction for the Gram matrix Yh^H Y and the one of the norm, Yh^H Yh or else Y^H Y, which also detects stagnation */
+static PetscErrorCode KSPSCGGram(KSP ksp)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscInt       j,n = scg->n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (j=0; j<n; j++) {
+    ierr = VecMDotBegin(scg->Y[j],n,scg->Yh,scg->G+j*n);CHKERRQ(ierr);
+    if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {
+      ierr = VecMDotBegin(scg->Yh[j],n,scg->Yh,scg->Gn+j*n);CHKERRQ(ierr);
+    } else {
+      ierr = VecMDotBegin(scg->Y[j],n,scg->Y,scg->Gn+j*n);CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  for (j=0; j<n; j++) {
+    ierr = VecMDotEnd(scg->Y[j],n,scg->Yh,scg->G+j*n);CHKERRQ(ierr);
+    if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {
+      ierr = VecMDotEnd(scg->Yh[j],n,scg->Yh,scg->Gn+j*n);CHKERRQ(ierr);
+    } else {
+      ierr = VecMDotEnd(scg->Y[j],n,scg->Y,scg->Gn+j*n);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* sets r = b - Ax and z = Br */
+static PetscErrorCode KSPSCGTrueResidual(KSP ksp,Mat Amat)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ksp->guess_zero || ksp->its) {
+    ierr = KSP_MatMult(ksp,Amat,ksp->vec_sol,scg->r);CHKERRQ(ierr);  /*    r <- b - Ax                       */
+    ierr = VecAYPX(scg->r,-1.0,ksp->vec_rhs);CHKERRQ(ierr);
+  } else {
+    ierr = VecCopy(ksp->vec_rhs,scg->r);CHKERRQ(ierr);               /*    r <- b (x is 0)                   */
+  }
+  ierr = KSP_PCApply(ksp,scg->r,scg->z);CHKERRQ(ierr);               /*    z <- Br                           */
+  PetscFunctionReturn(0);
+}
+
+/* replaces the starting vectors by up = Yh cp, p = Y cp, r = Yh cr and z = Y cr */
+static PetscErrorCode KSPSCGUpdateStart(KSP ksp)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscInt       j,k,np = 0,n = scg->n;
+  Vec            v[4];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (k=0; k<ksp->nwork && np<4; k++) {
+    for (j=0; j<n; j++) if (ksp->work[k] == scg->Yh[j] || ksp->work[k] == scg->Y[j]) break;
+    if (j == n) v[np++] = ksp->work[k];
+  }
+  if (np < 4) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_PLIB,"Not enough work vectors");
+  for (k=0; k<4; k++) {ierr = VecSet(v[k],0.0);CHKERRQ(ierr);}
+  ierr = VecMAXPY(v[0],n,scg->cp,scg->Yh);CHKERRQ(ierr);
+  ierr = VecMAXPY(v[1],n,scg->cp,scg->Y);CHKERRQ(ierr);
+  ierr = VecMAXPY(v[2],n,scg->cr,scg->Yh);CHKERRQ(ierr);
+  ierr = VecMAXPY(v[3],n,scg->cr,scg->Y);CHKERRQ(ierr);
+  scg->up = v[0]; scg->p = v[1]; scg->r = v[2]; scg->z = v[3];
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_SCG(KSP ksp)
+{
+  KSP_SCG           *scg = (KSP_SCG*)ksp->data;
+  KSP_CG            *cg = &scg->cg;
+  PetscErrorCode    ierr;
+  PetscInt          i,j,k,l,sb,n,neig,istart = 0,ibest = 0;
+  PetscScalar       dpi = 0.0,dpiold,a = 1.0,b = 0.0,delta = 0.0,deltanew,*e = cg->e,*d = cg->d;
+  PetscScalar       *G = scg->G,*Bm = scg->B,*cx = scg->cx,*cr = scg->cr,*cp = scg->cp,*w = scg->w;
+  PetscReal         dp = 0.0,rbest,rnew;
+  PetscBool         stalled;
+  Vec               X = ksp->vec_sol;
+  Mat               Amat,Pmat;
+  PetscBool         diagonalscale;
+  const PetscScalar zero = 0.0,one = 1.0,*alpha,*beta,*gamma;
+
+  PetscFunctionBegin;
+  ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
+  if (diagonalscale) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Krylov method %s does not support diagonal scaling",((PetscObject)ksp)->type_name);
+  ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+
+  scg->up = ksp->work[0];
+  scg->p  = ksp->work[1];
+  scg->r  = ksp->work[2];
+  scg->z  = ksp->work[3];
+  e[0]    = 0.0;
+  cg->ned = 0;
+
+  ksp->its = 0;
+  ierr = KSPSCGTrueResidual(ksp,Amat);CHKERRQ(ierr);
+  switch (ksp->normtype) {
+    case KSP_NORM_PRECONDITIONED:
+      ierr = VecNorm(scg->z,NORM_2,&dp);CHKERRQ(ierr);
+      KSPCheckNorm(ksp,dp);
+      break;
+    case KSP_NORM_UNPRECONDITIONED:
+      ierr = VecNorm(scg->r,NORM_2,&dp);CHKERRQ(ierr);
+      KSPCheckNorm(ksp,dp);
+      break;
+    case KSP_NORM_NATURAL:
+      ierr = VecDot(scg->z,scg->r,&delta);CHKERRQ(ierr);
+      KSPCheckDot(ksp,delta);
+      dp = PetscSqrtReal(PetscAbsScalar(delta));
+      break;
+    case KSP_NORM_NONE:
+      dp = 0.0;
+      break;
+    default: SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"%s",KSPNormTypes[ksp->normtype]);
+  }
+  ierr       = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+  ierr       = KSPMonitor(ksp,0,dp);CHKERRQ(ierr);
+  ksp->rnorm = dp;
+  ierr = (*ksp->converged)(ksp,0,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+  if (ksp->reason) PetscFunctionReturn(0);
+  ierr = VecCopy(scg->r,scg->up);CHKERRQ(ierr);                 /*    p <- z                            */
+  ierr = VecCopy(scg->z,scg->p);CHKERRQ(ierr);
+
+  i     = 0;
+  rbest = PETSC_MAX_REAL;
+  while (!ksp->reason) {
+    if (scg->basisready) {
+      sb = scg->s; alpha = scg->alpha; beta = scg->beta; gamma = scg->gamma;
+    } else {
+      sb = 1; alpha = beta = &zero; gamma = &one;
+    }
+    sb = PetscMin(sb,ksp->max_it - i);
+    ierr = KSPSCGBuildBasis(ksp,Amat,sb,alpha,beta,gamma);CHKERRQ(ierr);
+    ierr = KSPSCGGram(ksp);CHKERRQ(ierr);
+    n    = scg->n;
+
+    ierr   = PetscMemzero(cx,n*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr   = PetscMemzero(cr,n*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr   = PetscMemzero(cp,n*sizeof(PetscScalar));CHKERRQ(ierr);
+    cp[0]  = 1.0;
+    cr[sb+1] = 1.0;
+    delta  = KSPSCGInner(n,G,cr,cr);                            /*     delta <- z'*r                     */
+    KSPCheckDot(ksp,delta);
+    if (delta == 0.0) {
+      ksp->reason = KSP_CONVERGED_ATOL;
+      ierr        = PetscInfo(ksp,"converged due to beta = 0\n");CHKERRQ(ierr);
+      break;
+    }
+    if (i == istart) rbest = PetscSqrtReal(PetscAbsScalar(scg->Gn[(sb+1)*(n+1)]));
+    stalled      = PETSC_FALSE;
+    scg->inblock = PETSC_TRUE;
+    for (j=0; j<sb; j++) {
+      /* w <- Bm cp, the coordinates of Ap in Yh */
+      for (k=0; k<n; k++) w[k] = 0.0;
+      for (k=0; k<n; k++) {
+        if (cp[k] == 0.0) continue;
+        for (l=PetscMax(k-1,0); l<=PetscMin(k+1,n-1); l++) w[l] += Bm[l+k*n]*cp[k];
+      }
+      dpiold = dpi;
+      dpi    = PetscConj(KSPSCGInner(n,G,w,cp));                /*     dpi <- p'Ap = cp' G' w            */
+      KSPCheckDot(ksp,dpi);
+      if ((dpi == 0.0) || ((i > 0) && ((PetscSign(PetscRealPart(dpi))*PetscSign(PetscRealPart(dpiold))) < 0.0))) {
+        if (sb > 1) {stalled = PETSC_TRUE; break;}
+        if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"Diverged due to indefinite matrix");
+        ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+        ierr        = PetscInfo(ksp,"diverging due to indefinite or negative definite matrix\n");CHKERRQ(ierr);
+        break;
+      }
+      a = delta/dpi;
+      if (i-istart < scg->nlanczos) d[i-istart] = PetscSqrtReal(PetscAbsScalar(b))*e[i-istart] + 1.0/a;
+      for (k=0; k<n; k++) {
+        cx[k] += a*cp[k];                                       /*     x <- x + ap                      */
+        cr[k] -= a*w[k];                                        /*     r <- r - aAp                     */
+      }
+      deltanew = KSPSCGInner(n,G,cr,cr);                        /*     deltanew <- z'*r                 */
+      KSPCheckDot(ksp,deltanew);
+      rnew     = PetscSqrtReal(PetscMax(0.0,PetscRealPart(KSPSCGInner(n,scg->Gn,cr,cr))));
+      switch (ksp->normtype) {
+        case KSP_NORM_PRECONDITIONED:
+        case KSP_NORM_UNPRECONDITIONED:
+          dp = rnew;
+          break;
+        case KSP_NORM_NATURAL:
+          dp = PetscSqrtReal(PetscAbsScalar(deltanew));
+          break;
+        default:
+          dp = 0.0;
+      }
+      i++;
+      if (rnew < rbest) {rbest = rnew; ibest = i;}
+      ksp->its   = i;
+      ksp->rnorm = dp;
+      ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+      cg->ned = PetscMin(i-istart,scg->nlanczos);
+      ierr = KSPMonitor(ksp,i,dp);CHKERRQ(ierr);
+      ierr = (*ksp->converged)(ksp,i,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+      if (ksp->reason) break;
+      if (i >= ksp->max_it) {
+        ksp->reason = KSP_DIVERGED_ITS;
+        break;
+      }
+
+      if (deltanew == 0.0) {
+        ksp->reason = KSP_CONVERGED_ATOL;
+        ierr        = PetscInfo(ksp,"converged due to beta = 0\n");CHKERRQ(ierr);
+        break;
+#if !defined(PETSC_USE_COMPLEX)
+      } else if (deltanew*delta < 0.0) {
+        if (sb > 1) {stalled = PETSC_TRUE; break;}
+        if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"Diverged due to indefinite preconditioner");
+        ksp->reason = KSP_DIVERGED_INDEFINITE_PC;
+        ierr        = PetscInfo(ksp,"diverging due to indefinite preconditioner\n");CHKERRQ(ierr);
+        break;
+#endif
+      }
+      b = deltanew/delta;
+      if (i-istart < scg->nlanczos) e[i-istart] = PetscSqrtReal(PetscAbsScalar(b))/a;
+      for (k=0; k<n; k++) cp[k] = cr[k] + b*cp[k];              /*     p <- z + b* p                    */
+      delta = deltanew;
+    }
+    ierr = VecMAXPY(X,n,cx,scg->Y);CHKERRQ(ierr);
+    scg->inblock = PETSC_FALSE;
+    if (ksp->reason) break;
+
+    /*
+       With a poor basis, for instance from loose bounds given with -ksp_scg_eigenvalues, the coefficients computed from
+       the Gram matrix lose their accuracy and the iteration stagnates or breaks down. When the smallest residual norm has
+       not decreased for 2s iterations nor for a quarter of the iterations that reached it (longer than the plateaus of CG),
+       restart from the true residual with s = 1 until the basis is computed again from the eigenvalue estimates of the new
+       Lanczos process.
+    */
+    if (sb > 1 && i-ibest >= PetscMax(2*scg->s,(ibest-istart)/4)) stalled = PETSC_TRUE;
+    if (stalled) {
+      ierr = PetscInfo1(ksp,"Stalled at iteration %D, restarting with s = 1 to compute a new basis\n",i);CHKERRQ(ierr);
+      ierr = KSPSCGTrueResidual(ksp,Amat);CHKERRQ(ierr);
+      ierr = VecCopy(scg->r,scg->up);CHKERRQ(ierr);
+      ierr = VecCopy(scg->z,scg->p);CHKERRQ(ierr);
+      scg->basisready = PETSC_FALSE;
+      scg->nrestarts++;
+      istart  = ibest = i;
+      b       = 0.0;
+      e[0]    = 0.0;
+      cg->ned = 0;
+    } else {
+      ierr = KSPSCGUpdateStart(ksp);CHKERRQ(ierr);
+    }
+
+    if (!scg->basisready && i-istart >= scg->nwarmup) {
+      ierr = KSPComputeEigenvalues_CG(ksp,scg->nlanczos,scg->eigr,scg->eigi,&neig);CHKERRQ(ierr);
+      ierr = KSPSStepBasisCoefficients_Private(scg->basis,neig,scg->eigr,scg->eigi,scg->s,scg->alpha,scg->beta,scg->gamma);CHKERRQ(ierr);
+      ierr = PetscInfo3(ksp,"Basis computed from %D eigenvalue estimates in [%g, %g]\n",neig,(double)scg->eigr[0],(double)scg->eigr[neig-1]);CHKERRQ(ierr);
+      scg->basisready = PETSC_TRUE;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPBuildSolution_SCG(KSP ksp,Vec v,Vec *V)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!scg->inblock) {
+    ierr = KSPBuildSolutionDefault(ksp,v,V);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  /* within a block the iterate is only known by its coordinates */
+  if (!v) {
+    if (!scg->xtmp) {
+      ierr = VecDuplicate(ksp->vec_sol,&scg->xtmp);CHKERRQ(ierr);
+      ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)scg->xtmp);CHKERRQ(ierr);
+    }
+    v = scg->xtmp;
+  }
+  ierr = VecCopy(ksp->vec_sol,v);CHKERRQ(ierr);
+  ierr = VecMAXPY(v,scg->n,scg->cx,scg->Y);CHKERRQ(ierr);
+  *V   = v;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_SCG(KSP ksp)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  KSP_CG         *cg = &scg->cg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree3(scg->alpha,scg->beta,scg->gamma);CHKERRQ(ierr);
+  ierr = PetscFree7(scg->G,scg->Gn,scg->B,scg->cx,scg->cr,scg->cp,scg->w);CHKERRQ(ierr);
+  ierr = PetscFree3(scg->Yh,scg->Y,scg->pool);CHKERRQ(ierr);
+  ierr = PetscFree4(cg->e,cg->d,cg->ee,cg->dd);CHKERRQ(ierr);
+  ierr = PetscFree2(scg->eigr,scg->eigi);CHKERRQ(ierr);
+  ierr = VecDestroy(&scg->xtmp);CHKERRQ(ierr);
+  cg->ned         = 0;
+  scg->basisready = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_SCG(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_SCG(ksp);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_SCG(KSP ksp,PetscViewer viewer)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  blocks of s=%D steps in the %s basis\n",scg->s,KSPSStepBasisTypes[scg->basis]);CHKERRQ(ierr);
+    if (scg->userinterval && scg->basis != KSP_SSTEP_BASIS_MONOMIAL) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  basis for the eigenvalues in [%g, %g]\n",(double)scg->interval[0],(double)scg->interval[1]);CHKERRQ(ierr);
+    }
+    if (scg->nrestarts) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  %D restarts with a new basis after the iteration stalled\n",scg->nrestarts);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_SCG(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscInt       s = scg->s,two = 2;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP s-step CG Options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_scg_s","Number of CG steps per reduction","None",s,&s,NULL);CHKERRQ(ierr);
+  if (s < 1) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Number of steps in a block must be positive");
+  ierr = PetscOptionsEnum("-ksp_scg_basis","Polynomial basis of the blocks","None",KSPSStepBasisTypes,(PetscEnum)scg->basis,(PetscEnum*)&scg->basis,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsRealArray("-ksp_scg_eigenvalues","Bounds of the eigenvalues of the preconditioned operator, for the basis","None",scg->interval,&two,&flg);CHKERRQ(ierr);
+  if (flg) {
+    if (two != 2) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_WRONG,"Must give both the smallest and the largest eigenvalue");
+    if (scg->interval[0] > scg->interval[1]) SETERRQ2(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_WRONG,"Smallest eigenvalue %g is larger than the largest %g",(double)scg->interval[0],(double)scg->interval[1]);
+    scg->userinterval = PETSC_TRUE;
+  }
+  if ((s != scg->s || flg) && ksp->setupstage) {
+    ierr = KSPReset_SCG(ksp);CHKERRQ(ierr);
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  scg->s = s;
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+     KSPSCG - The s-step (communication avoiding) preconditioned conjugate gradient method
+
+   Each outer iteration builds bases of s+1 and s vectors of the Krylov spaces of the search direction and of the
+   residual, with a polynomial recurrence and no inner products, computes all their inner products with a single global
+   reduction and then runs s steps of CG on the coordinates of the iterates in these bases, so it needs one reduction per
+   s iterations instead of two per iteration.
+
+   Options Database Keys:
++   -ksp_scg_s <s> - the number of CG steps per reduction (default 4)
+.   -ksp_scg_basis <newton,chebyshev,monomial> - the polynomial basis (default chebyshev)
+-   -ksp_scg_eigenvalues <emin,emax> - bounds of the spectrum of the preconditioned operator for the basis
+
+   Level: intermediate
+
+   Notes:
+   The residual norm and the convergence test are computed after each of the s steps, from the inner products of the
+   basis, so the monitors and convergence tests behave as for KSPCG. Each iteration costs two applications of the
+   matrix and of the preconditioner.
+
+   Unless they are given with -ksp_scg_eigenvalues, the Newton and Chebyshev bases need estimates of the eigenvalues of the
+   preconditioned operator, so the first 2s iterations are run with s = 1 (still one reduction per iteration) and the
+   eigenvalues of their Lanczos tridiagonal matrix are used. The monomial basis needs no estimates but is only usable for
+   small s.
+
+   The convergence is sensitive to the bounds given with -ksp_scg_eigenvalues: an interval much larger than the spectrum,
+   or one that misses its largest eigenvalues, gives an ill-conditioned basis with which the s-step iteration loses
+   accuracy and stagnates well above the tolerance, the more so for large s. When the residual norm stops decreasing the
+   solver therefore restarts from the true residual with s = 1 and replaces the basis by one computed from the new
+   eigenvalue estimates, as when no bounds are given; -info and KSPView() report these restarts. Bounds are only
+   worthwhile when they are known to be tight.
+
+   The matrix and the preconditioner must be Hermitian positive definite, the complex symmetric variant of KSPCG is not
+   supported. Only left preconditioning is supported.
+
+   Reference:
+   E. Carson, Communication-avoiding Krylov subspace methods in theory and practice, PhD thesis, University of California,
+   Berkeley, 2015.
+
+.seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPCG, KSPPIPECG, KSPSGMRES
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_SCG(KSP ksp)
+{
+  PetscErrorCode ierr;
+  KSP_SCG        *scg;
+
+  PetscFunctionBegin;
+  ierr = PetscNewLog(ksp,&scg);CHKERRQ(ierr);
+  scg->cg.type = KSP_CG_HERMITIAN;
+  scg->s       = 4;
+  scg->basis   = KSP_SSTEP_BASIS_CHEBYSHEV;
+  ksp->data    = (void*)scg;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NATURAL,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+
+  ksp->ops->setup          = KSPSetUp_SCG;
+  ksp->ops->solve          = KSPSolve_SCG;
+  ksp->ops->reset          = KSPReset_SCG;
+  ksp->ops->destroy        = KSPDestroy_SCG;
+  ksp->ops->view           = KSPView_SCG;
+  ksp->ops->setfromoptions = KSPSetFromOptions_SCG;
+  ksp->ops->buildsolution  = KSPBuildSolution_SCG;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+  PetscFunctionReturn(0);
+}
@@ -4,6 +4,7 @@
 typedef struct {
   PetscInt    restart;
   PetscInt    n_restarts;
+  PetscBool   contiguous;   /* VV and SS are each stored as the columns of one array */
   PetscScalar *val;
   Vec         *VV, *SS;
   Vec         R;
@@ -149,8 +150,13 @@ static PetscErrorCode KSPSetUp_GCR(KSP ksp)
 
   ierr = KSPGetOperators(ksp, &A, NULL);CHKERRQ(ierr);
   ierr = MatCreateVecs(A, &ctx->R, NULL);CHKERRQ(ierr);
-  ierr = VecDuplicateVecs(ctx->R, ctx->restart, &ctx->VV);CHKERRQ(ierr);
-  ierr = VecDuplicateVecs(ctx->R, ctx->restart, &ctx->SS);CHKERRQ(ierr);
+  if (ctx->contiguous) {
+    ierr = VecDuplicateVecsContiguous(ctx->R, ctx->restart, &ctx->VV);CHKERRQ(ierr);
+    ierr = VecDuplicateVecsContiguous(ctx->R, ctx->restart, &ctx->SS);CHKERRQ(ierr);
+  } else {
+    ierr = VecDuplicateVecs(ctx->R, ctx->restart, &ctx->VV);CHKERRQ(ierr);
+    ierr = VecDuplicateVecs(ctx->R, ctx->restart, &ctx->SS);CHKERRQ(ierr);
+  }
 
   ierr = PetscMalloc1(ctx->restart, &ctx->val);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -193,6 +199,7 @@ static PetscErrorCode KSPSetFromOptions_GCR(PetscOptionItems *PetscOptionsObject
   ierr = PetscOptionsHead(PetscOptionsObject,"KSP GCR options");CHKERRQ(ierr);
   ierr = PetscOptionsInt("-ksp_gcr_restart","Number of Krylov search directions","KSPGCRSetRestart",ctx->restart,&restart,&flg);CHKERRQ(ierr);
   if (flg) { ierr = KSPGCRSetRestart(ksp,restart);CHKERRQ(ierr); }
+  ierr = PetscOptionsBool("-ksp_gcr_contiguous","Store the search directions as the columns of one array","VecDuplicateVecsContiguous",ctx->contiguous,&ctx->contiguous,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -304,7 +311,8 @@ static PetscErrorCode  KSPBuildResidual_GCR(KSP ksp, Vec t, Vec v, Vec *V)
      KSPGCR - Implements the preconditioned Generalized Conjugate Residual method.
 
    Options Database Keys:
-.   -ksp_gcr_restart <restart> - the number of stored vectors to orthogonalize against
++   -ksp_gcr_restart <restart> - the number of stored vectors to orthogonalize against
+-   -ksp_gcr_contiguous - store the search directions as the columns of one array, so that the orthogonalization uses BLAS gemv
 
    Level: beginner
 
@@ -116,3 +116,94 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
 
 
 
+
+/*@C
+     KSPGMRESCholQROrthogonalization - Orthogonalization routine that computes the inner products of the new direction
+                with the Krylov vectors and its norm in a single reduction, as a Cholesky QR of the new direction
+                against the orthonormal Krylov basis
+
+     Collective on KSP
+
+  Input Parameters:
++   ksp - KSP object, must be associated with GMRES, FGMRES, LGMRES or DGMRES Krylov method
+-   its - one less then the current GMRES restart iteration, i.e. the size of the Krylov space
+
+   Options Database Keys:
++   -ksp_gmres_cholqr - Activates KSPGMRESCholQROrthogonalization()
+-   -ksp_gmres_cgs_refinement_type <refine_never,refine_ifneeded,refine_always> - determine if a second pass is
+                                   used to increase the stability of the orthogonalization
+
+    Notes:
+    Each pass is one VecMDot() of the new direction w with all the Krylov vectors and w itself, which gives
+    h = V^H w and w^H w, followed by w = w - V h. The norm of the projected direction, w^H w - h^H h, is passed to the
+    Krylov method, so it does not need the VecNorm() of KSPGMRESClassicalGramSchmidtOrthogonalization(). This takes one
+    reduction per iteration instead of two.
+
+    With KSP_GMRES_CGS_REFINE_ALWAYS a second pass is always made (CholQR2, two reductions per iteration instead of
+    three). With KSP_GMRES_CGS_REFINE_IFNEEDED it is only made when the projection removed more than half of the squared
+    norm of w. The norm then comes from the inner products of the second pass, so it is accurate. With
+    KSP_GMRES_CGS_REFINE_NEVER a second pass is still made when the norm computed from the first pass has lost more
+    than half of its digits.
+
+   Level: intermediate
+
+.seelaso:  KSPGMRESSetOrthogonalization(), KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESSetCGSRefinementType(),
+           KSPGMRESGetCGSRefinementType(), KSPGMRESGetOrthogonalization()
+
+@*/
+PetscErrorCode  KSPGMRESCholQROrthogonalization(KSP ksp,PetscInt it)
+{
+  KSP_GMRES      *gmres = (KSP_GMRES*)(ksp->data);
+  PetscErrorCode ierr;
+  PetscInt       j,pass;
+  PetscScalar    *hh,*hes,*lhh;
+  PetscReal      hnrm2,wnrm2,nrm2 = 0.0;
+  PetscBool      refine;
+
+  PetscFunctionBegin;
+  ierr = PetscLogEventBegin(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+  if (!gmres->orthogwork) {
+    ierr = PetscMalloc1(gmres->max_k + 2,&gmres->orthogwork);CHKERRQ(ierr);
+  }
+  lhh = gmres->orthogwork;
+
+  hh  = HH(0,it);
+  hes = HES(0,it);
+  for (j=0; j<=it; j++) {
+    hh[j]  = 0.0;
+    hes[j] = 0.0;
+  }
+
+  for (pass=0; pass<2; pass++) {
+    /* the new direction follows the Krylov vectors, so one VecMDot() gives <v,vnew> and <vnew,vnew> */
+    ierr  = VecMDot(VEC_VV(it+1),it+2,&(VEC_VV(0)),lhh);CHKERRQ(ierr);
+    wnrm2 = PetscRealPart(lhh[it+1]);
+    hnrm2 = 0.0;
+    for (j=0; j<=it; j++) {
+      KSPCheckDot(ksp,lhh[j]);
+      hnrm2  += PetscRealPart(lhh[j]*PetscConj(lhh[j]));
+      hh[j]  += lhh[j];
+      hes[j] += lhh[j];
+      lhh[j]  = -lhh[j];
+    }
+    ierr = VecMAXPY(VEC_VV(it+1),it+1,lhh,&VEC_VV(0));CHKERRQ(ierr);
+    nrm2 = wnrm2 - hnrm2;
+
+    if (pass) break;
+    switch (gmres->cgstype) {
+    case KSP_GMRES_CGS_REFINE_ALWAYS:
+      refine = PETSC_TRUE;
+      break;
+    case KSP_GMRES_CGS_REFINE_IFNEEDED:
+      refine = (PetscBool)(nrm2 < hnrm2);
+      break;
+    default:
+      refine = (PetscBool)(nrm2 <= PETSC_SQRT_MACHINE_EPSILON*wnrm2);
+    }
+    if (!refine) break;
+    ierr = PetscInfo2(ksp,"Performing a second pass, wnorm^2 %g hnorm^2 %g\n",(double)wnrm2,(double)hnrm2);CHKERRQ(ierr);
+  }
+  gmres->orthognorm = PetscSqrtReal(PetscMax(nrm2,0.0));
+  ierr = PetscLogEventEnd(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
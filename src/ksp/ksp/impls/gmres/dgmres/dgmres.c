@@ -191,10 +191,16 @@ PetscErrorCode KSPDGMRESCycle(PetscInt *itcount,KSP ksp)
     }
     dgmres->matvecs += 1;
     /* update hessenberg matrix and do Gram-Schmidt */
+    dgmres->orthognorm = -1.0;
     ierr = (*dgmres->orthog)(ksp,it);CHKERRQ(ierr);
 
-    /* vv(i+1) . vv(i+1) */
-    ierr = VecNormalize(VEC_VV(it+1),&tt);CHKERRQ(ierr);
+    /* vv(i+1) . vv(i+1), unless the orthogonalization computed it */
+    if (dgmres->orthognorm >= 0.0) {
+      tt = dgmres->orthognorm;
+      if (tt > 0.0) {ierr = VecScale(VEC_VV(it+1),1.0/tt);CHKERRQ(ierr);}
+    } else {
+      ierr = VecNormalize(VEC_VV(it+1),&tt);CHKERRQ(ierr);
+    }
     /* save the magnitude */
     *HH(it+1,it)  = tt;
     *HES(it+1,it) = tt;
@@ -467,7 +473,7 @@ static PetscErrorCode KSPDGMRESGetNewVectors(KSP ksp,PetscInt it)
 
   dgmres->vv_allocated += nalloc;
 
-  ierr = KSPCreateVecs(ksp,nalloc,&dgmres->user_work[nwork],0,NULL);CHKERRQ(ierr);
+  ierr = KSPGMRESCreateVecs(ksp,nalloc,&dgmres->user_work[nwork]);CHKERRQ(ierr);
   ierr = PetscLogObjectParents(ksp,nalloc,dgmres->user_work[nwork]);CHKERRQ(ierr);
 
   dgmres->mwork_alloc[nwork] = nalloc;
@@ -71,7 +71,7 @@ PetscErrorCode    KSPSetUp_GMRES(KSP ksp)
   if (gmres->q_preallocate) {
     gmres->vv_allocated = VEC_OFFSET + 2 + max_k;
 
-    ierr = KSPCreateVecs(ksp,gmres->vv_allocated,&gmres->user_work[0],0,NULL);CHKERRQ(ierr);
+    ierr = KSPGMRESCreateVecs(ksp,gmres->vv_allocated,&gmres->user_work[0]);CHKERRQ(ierr);
     ierr = PetscLogObjectParents(ksp,gmres->vv_allocated,gmres->user_work[0]);CHKERRQ(ierr);
 
     gmres->mwork_alloc[0] = gmres->vv_allocated;
@@ -82,7 +82,7 @@ PetscErrorCode    KSPSetUp_GMRES(KSP ksp)
   } else {
     gmres->vv_allocated = 5;
 
-    ierr = KSPCreateVecs(ksp,5,&gmres->user_work[0],0,NULL);CHKERRQ(ierr);
+    ierr = KSPGMRESCreateVecs(ksp,5,&gmres->user_work[0]);CHKERRQ(ierr);
     ierr = PetscLogObjectParents(ksp,5,gmres->user_work[0]);CHKERRQ(ierr);
 
     gmres->mwork_alloc[0] = 5;
@@ -152,11 +152,17 @@ PetscErrorCode KSPGMRESCycle(PetscInt *itcount,KSP ksp)
     ierr = KSP_PCApplyBAorAB(ksp,VEC_VV(it),VEC_VV(1+it),VEC_TEMP_MATOP);CHKERRQ(ierr);
 
     /* update hessenberg matrix and do Gram-Schmidt */
+    gmres->orthognorm = -1.0;
     ierr = (*gmres->orthog)(ksp,it);CHKERRQ(ierr);
     if (ksp->reason) break;
 
-    /* vv(i+1) . vv(i+1) */
-    ierr = VecNormalize(VEC_VV(it+1),&tt);CHKERRQ(ierr);
+    /* vv(i+1) . vv(i+1), unless the orthogonalization computed it */
+    if (gmres->orthognorm >= 0.0) {
+      tt = gmres->orthognorm;
+      if (tt > 0.0) {ierr = VecScale(VEC_VV(it+1),1.0/tt);CHKERRQ(ierr);}
+    } else {
+      ierr = VecNormalize(VEC_VV(it+1),&tt);CHKERRQ(ierr);
+    }
     KSPCheckNorm(ksp,tt);
 
     /* save the magnitude */
@@ -435,6 +441,28 @@ static PetscErrorCode KSPGMRESUpdateHessenberg(KSP ksp,PetscInt it,PetscBool hap
   }
   PetscFunctionReturn(0);
 }
+
+/*
+   Creates n work vectors; with -ksp_gmres_contiguous they are the columns of one array, so the VecMDot() and
+   VecMAXPY() of the orthogonalization use BLAS gemv, see VecDuplicateVecsContiguous()
+*/
+PetscErrorCode KSPGMRESCreateVecs(KSP ksp,PetscInt n,Vec **vecs)
+{
+  KSP_GMRES      *gmres = (KSP_GMRES*)ksp->data;
+  PetscErrorCode ierr;
+  Vec            *t;
+
+  PetscFunctionBegin;
+  if (gmres->contiguous) {
+    ierr = KSPCreateVecs(ksp,1,&t,0,NULL);CHKERRQ(ierr);
+    ierr = VecDuplicateVecsContiguous(t[0],n,vecs);CHKERRQ(ierr);
+    ierr = VecDestroyVecs(1,&t);CHKERRQ(ierr);
+  } else {
+    ierr = KSPCreateVecs(ksp,n,vecs,0,NULL);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 /*
    This routine allocates more work vectors, starting from VEC_VV(it).
  */
@@ -455,7 +483,7 @@ PetscErrorCode KSPGMRESGetNewVectors(KSP ksp,PetscInt it)
 
   gmres->vv_allocated += nalloc;
 
-  ierr = KSPCreateVecs(ksp,nalloc,&gmres->user_work[nwork],0,NULL);CHKERRQ(ierr);
+  ierr = KSPGMRESCreateVecs(ksp,nalloc,&gmres->user_work[nwork]);CHKERRQ(ierr);
   ierr = PetscLogObjectParents(ksp,nalloc,gmres->user_work[nwork]);CHKERRQ(ierr);
 
   gmres->mwork_alloc[nwork] = nalloc;
@@ -516,6 +544,17 @@ PetscErrorCode KSPView_GMRES(KSP ksp,PetscViewer viewer)
     }
   } else if (gmres->orthog == KSPGMRESModifiedGramSchmidtOrthogonalization) {
     cstr = "Modified Gram-Schmidt Orthogonalization";
+  } else if (gmres->orthog == KSPGMRESCholQROrthogonalization) {
+    switch (gmres->cgstype) {
+    case (KSP_GMRES_CGS_REFINE_ALWAYS):
+      cstr = "Cholesky QR Orthogonalization with two passes (CholQR2)";
+      break;
+    case (KSP_GMRES_CGS_REFINE_IFNEEDED):
+      cstr = "Cholesky QR Orthogonalization with a second pass when needed";
+      break;
+    default:
+      cstr = "Cholesky QR Orthogonalization with a second pass when the norm is inaccurate";
+    }
   } else {
     cstr = "unknown orthogonalization";
   }
@@ -588,10 +627,13 @@ PetscErrorCode KSPSetFromOptions_GMRES(PetscOptionItems *PetscOptionsObject,KSP
   flg  = PETSC_FALSE;
   ierr = PetscOptionsBool("-ksp_gmres_preallocate","Preallocate Krylov vectors","KSPGMRESSetPreAllocateVectors",flg,&flg,NULL);CHKERRQ(ierr);
   if (flg) {ierr = KSPGMRESSetPreAllocateVectors(ksp);CHKERRQ(ierr);}
+  ierr = PetscOptionsBool("-ksp_gmres_contiguous","Store each group of Krylov vectors as the columns of one array","VecDuplicateVecsContiguous",gmres->contiguous,&gmres->contiguous,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBoolGroupBegin("-ksp_gmres_classicalgramschmidt","Classical (unmodified) Gram-Schmidt (fast)","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
   if (flg) {ierr = KSPGMRESSetOrthogonalization(ksp,KSPGMRESClassicalGramSchmidtOrthogonalization);CHKERRQ(ierr);}
-  ierr = PetscOptionsBoolGroupEnd("-ksp_gmres_modifiedgramschmidt","Modified Gram-Schmidt (slow,more stable)","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
+  ierr = PetscOptionsBoolGroup("-ksp_gmres_modifiedgramschmidt","Modified Gram-Schmidt (slow,more stable)","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
   if (flg) {ierr = KSPGMRESSetOrthogonalization(ksp,KSPGMRESModifiedGramSchmidtOrthogonalization);CHKERRQ(ierr);}
+  ierr = PetscOptionsBoolGroupEnd("-ksp_gmres_cholqr","Cholesky QR, one reduction per pass (fewest reductions)","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGMRESSetOrthogonalization(ksp,KSPGMRESCholQROrthogonalization);CHKERRQ(ierr);}
   ierr = PetscOptionsEnum("-ksp_gmres_cgs_refinement_type","Type of iterative refinement for classical (unmodified) Gram-Schmidt","KSPGMRESSetCGSRefinementType",
                           KSPGMRESCGSRefinementTypes,(PetscEnum)gmres->cgstype,(PetscEnum*)&gmres->cgstype,&flg);CHKERRQ(ierr);
   flg  = PETSC_FALSE;
@@ -849,10 +891,13 @@ PetscErrorCode  KSPGMRESSetHapTol(KSP ksp,PetscReal tol)
 .   -ksp_gmres_haptol <tol> - sets the tolerance for "happy ending" (exact convergence)
 .   -ksp_gmres_preallocate - preallocate all the Krylov search directions initially (otherwise groups of
                              vectors are allocated as needed)
+.   -ksp_gmres_contiguous - store each group of Krylov vectors as the columns of one array, so that the orthogonalization
+                             uses BLAS gemv; with -ksp_gmres_preallocate the whole basis is one array
 .   -ksp_gmres_classicalgramschmidt - use classical (unmodified) Gram-Schmidt to orthogonalize against the Krylov space (fast) (the default)
 .   -ksp_gmres_modifiedgramschmidt - use modified Gram-Schmidt in the orthogonalization (more stable, but slower)
+.   -ksp_gmres_cholqr - use Cholesky QR, which needs a single reduction per pass, in the orthogonalization
 .   -ksp_gmres_cgs_refinement_type <refine_never,refine_ifneeded,refine_always> - determine if iterative refinement is used to increase the
-                                   stability of the classical Gram-Schmidt  orthogonalization.
+                                   stability of the classical Gram-Schmidt or Cholesky QR orthogonalization.
 -   -ksp_gmres_krylov_monitor - plot the Krylov space generated
 
    Level: beginner
@@ -866,7 +911,7 @@ PetscErrorCode  KSPGMRESSetHapTol(KSP ksp,PetscReal tol)
 
 .seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPFGMRES, KSPLGMRES,
            KSPGMRESSetRestart(), KSPGMRESSetHapTol(), KSPGMRESSetPreAllocateVectors(), KSPGMRESSetOrthogonalization(), KSPGMRESGetOrthogonalization(),
-           KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESModifiedGramSchmidtOrthogonalization(),
+           KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESModifiedGramSchmidtOrthogonalization(), KSPGMRESCholQROrthogonalization(),
            KSPGMRESCGSRefinementType, KSPGMRESSetCGSRefinementType(), KSPGMRESGetCGSRefinementType(), KSPGMRESMonitorKrylov(), KSPSetPCSide()
 
 M*/
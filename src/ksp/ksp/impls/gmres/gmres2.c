@@ -16,25 +16,32 @@ $   it is one minus the number of GMRES iterations since last restart;
 $    i.e. the size of Krylov space minus one
 
    Notes:
-   Two orthogonalization routines are predefined, including
+   Three orthogonalization routines are predefined, including
 
    KSPGMRESModifiedGramSchmidtOrthogonalization()
 
    KSPGMRESClassicalGramSchmidtOrthogonalization() - Default. Use KSPGMRESSetCGSRefinementType() to determine if
      iterative refinement is used to increase stability.
 
+   KSPGMRESCholQROrthogonalization() - One reduction per iteration. Use KSPGMRESSetCGSRefinementType() to determine if
+     a second pass is used to increase stability.
+
+   An orthogonalization routine may also compute the norm of the orthogonalized direction and store it in the orthognorm
+   field of the GMRES context, then the Krylov method does not compute it again.
 
    Options Database Keys:
 
 +  -ksp_gmres_classicalgramschmidt - Activates KSPGMRESClassicalGramSchmidtOrthogonalization() (default)
--  -ksp_gmres_modifiedgramschmidt - Activates KSPGMRESModifiedGramSchmidtOrthogonalization()
+.  -ksp_gmres_modifiedgramschmidt - Activates KSPGMRESModifiedGramSchmidtOrthogonalization()
+-  -ksp_gmres_cholqr - Activates KSPGMRESCholQROrthogonalization()
 
    Level: intermediate
 
 .keywords: KSP, GMRES, set, orthogonalization, Gram-Schmidt, iterative refinement
 
 .seealso: KSPGMRESSetRestart(), KSPGMRESSetPreAllocateVectors(), KSPGMRESSetCGSRefinementType(), KSPGMRESSetOrthogonalization(),
-          KSPGMRESModifiedGramSchmidtOrthogonalization(), KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESGetCGSRefinementType()
+          KSPGMRESModifiedGramSchmidtOrthogonalization(), KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESCholQROrthogonalization(),
+          KSPGMRESGetCGSRefinementType()
 @*/
 PetscErrorCode  KSPGMRESSetOrthogonalization(KSP ksp,PetscErrorCode (*fcn)(KSP,PetscInt))
 {
@@ -63,18 +70,21 @@ $   it is one minus the number of GMRES iterations since last restart;
 $    i.e. the size of Krylov space minus one
 
    Notes:
-   Two orthogonalization routines are predefined, including
+   Three orthogonalization routines are predefined, including
 
    KSPGMRESModifiedGramSchmidtOrthogonalization()
 
    KSPGMRESClassicalGramSchmidtOrthogonalization() - Default. Use KSPGMRESSetCGSRefinementType() to determine if
      iterative refinement is used to increase stability.
 
+   KSPGMRESCholQROrthogonalization() - One reduction per iteration. Use KSPGMRESSetCGSRefinementType() to determine if
+     a second pass is used to increase stability.
 
    Options Database Keys:
 
 +  -ksp_gmres_classicalgramschmidt - Activates KSPGMRESClassicalGramSchmidtOrthogonalization() (default)
--  -ksp_gmres_modifiedgramschmidt - Activates KSPGMRESModifiedGramSchmidtOrthogonalization()
+.  -ksp_gmres_modifiedgramschmidt - Activates KSPGMRESModifiedGramSchmidtOrthogonalization()
+-  -ksp_gmres_cholqr - Activates KSPGMRESCholQROrthogonalization()
 
    Level: intermediate
 
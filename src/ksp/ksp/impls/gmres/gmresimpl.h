@@ -30,6 +30,7 @@
                                                                         \
   PetscErrorCode (*orthog)(KSP,PetscInt);                    \
   KSPGMRESCGSRefinementType cgstype;                                    \
+  PetscReal orthognorm;    /* norm of the new direction when the orthogonalization computes it, otherwise negative */ \
                                                                         \
   Vec      *vecs;                                        /* the work vectors */ \
   Vec      *vecb;                                        /* holds the last full basis vectors of the Krylov subspace to compute (harmonic) Ritz pairs */ \
@@ -41,6 +42,7 @@
   Vec      **user_work;                                              \
   PetscInt *mwork_alloc;       /* Number of work vectors allocated as part of  a work-vector chunck */ \
   PetscInt nwork_alloc;        /* Number of work vector chunks allocated */ \
+  PetscBool contiguous;        /* each chunk of work vectors is stored as the columns of one array */ \
                                                                         \
   /* Information for building solution */                               \
   PetscInt    it;              /* Current iteration: inside restart */  \
@@ -61,6 +63,7 @@ PETSC_INTERN PetscErrorCode KSPComputeRitz_GMRES(KSP,PetscBool,PetscBool,PetscIn
 PETSC_INTERN PetscErrorCode KSPReset_GMRES(KSP);
 PETSC_INTERN PetscErrorCode KSPDestroy_GMRES(KSP);
 PETSC_INTERN PetscErrorCode KSPGMRESGetNewVectors(KSP,PetscInt);
+PETSC_INTERN PetscErrorCode KSPGMRESCreateVecs(KSP,PetscInt,Vec**);
 
 typedef PetscErrorCode (*FCN)(KSP,PetscInt); /* force argument to next function to not be extern C*/
 
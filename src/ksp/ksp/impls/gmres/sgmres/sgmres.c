@@ -0,0 +1,609 @@
+/*
+    This file implements SGMRES, an s-step (communication avoiding) variant of GMRES.
+
+    Each block of s Krylov vectors is generated with a polynomial basis and no inner products, then orthogonalized
+    against the previous basis vectors and among themselves with block classical Gram-Schmidt and a Cholesky QR,
+    using a single global reduction. The Hessenberg matrix is recovered from the change of basis, so the residual
+    norm is still available after each of the s steps.
+
+    Reference: M. Hoemmen, Communication-avoiding Krylov subspace methods, PhD thesis, UC Berkeley, 2010.
+*/
+
+#include <../src/ksp/ksp/impls/gmres/sgmres/sgmresimpl.h>       /*I  "petscksp.h"  I*/
+#define SGMRES_DELTA_DIRECTIONS 10
+#define SGMRES_DEFAULT_MAXK     30
+#define SGMRES_DEFAULT_S        5
+
+static PetscErrorCode KSPSGMRESUpdateHessenberg(KSP,PetscInt,PetscBool,PetscReal*);
+static PetscErrorCode KSPSGMRESBuildSoln(PetscScalar*,Vec,Vec,KSP,PetscInt);
+
+static PetscErrorCode KSPSetUp_SGMRES(KSP ksp)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscInt       max_k = sgmres->max_k,s = sgmres->s;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSetUp_GMRES(ksp);CHKERRQ(ierr);
+  if (!sgmres->Rsvd) {
+    /* work space of KSPComputeEigenvalues_GMRES(), used for the shifts of the basis */
+    ierr = PetscMalloc1((max_k + 3)*(max_k + 9),&sgmres->Rsvd);CHKERRQ(ierr);
+    ierr = PetscMalloc1(6*(max_k+2),&sgmres->Dsvd);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,(max_k + 3)*(max_k + 9)*sizeof(PetscScalar) + 6*(max_k+2)*sizeof(PetscReal));CHKERRQ(ierr);
+  }
+  if (!sgmres->orthogwork) {
+    ierr = PetscMalloc1(max_k + 2,&sgmres->orthogwork);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,(max_k + 2)*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  ierr = PetscMalloc3(s,&sgmres->alpha,s,&sgmres->beta,s,&sgmres->gamma);CHKERRQ(ierr);
+  ierr = PetscMalloc5((max_k+1)*s,&sgmres->gram,(max_k+1)*s,&sgmres->gram2,s*s,&sgmres->R,(max_k+1)*(s+1),&sgmres->zc,(max_k+1)*s,&sgmres->hb);CHKERRQ(ierr);
+  ierr = PetscMalloc3(max_k+1,&sgmres->eigr,max_k+1,&sgmres->eigi,s,&sgmres->dtol);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,(3*s + (max_k+1)*(4*s+1) + s*s)*sizeof(PetscScalar) + (2*max_k+2+s)*sizeof(PetscReal));CHKERRQ(ierr);
+
+  /* the monomial basis needs no eigenvalue estimates */
+  sgmres->basisready = PETSC_FALSE;
+  if (sgmres->basis == KSP_SSTEP_BASIS_MONOMIAL) {
+    ierr = KSPSStepBasisCoefficients_Private(sgmres->basis,0,NULL,NULL,s,sgmres->alpha,sgmres->beta,sgmres->gamma);CHKERRQ(ierr);
+    sgmres->basisready = PETSC_TRUE;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPSGMRESCholesky - Computes the Cholesky factor R^H R = G - C^H C of the new vectors W of a block after they are projected
+    out of the orthonormal basis Q, where the columns of gram are [C; G] = [Q W]^H W, and C has n1 rows.
+
+    Column t fails when the squared norm left in it is at most dtol[t]; then its off-diagonal entries are set, R(t,t) is zero
+    and nok = t, otherwise nok = bs.
+*/
+static PetscErrorCode KSPSGMRESCholesky(PetscInt n1,PetscInt bs,PetscInt ld,const PetscScalar *gram,PetscScalar *R,PetscInt ldr,const PetscReal *dtol,PetscInt *nok)
+{
+  PetscInt    i,k,l,t;
+  PetscScalar v;
+  PetscReal   d;
+
+  PetscFunctionBegin;
+  *nok = bs;
+  for (t=0; t<bs; t++) {
+    for (k=0; k<=t; k++) {
+      v = gram[n1+k+t*ld];
+      for (i=0; i<n1; i++) v -= PetscConj(gram[i+k*ld])*gram[i+t*ld];
+      for (l=0; l<k; l++) v -= PetscConj(R[l+k*ldr])*R[l+t*ldr];
+      if (k < t) R[k+t*ldr] = v/R[k+k*ldr];
+      else {
+        d = PetscRealPart(v);
+        if (d <= dtol[t]) {
+          R[t+t*ldr] = 0.0;
+          *nok       = t;
+          PetscFunctionReturn(0);
+        }
+        R[t+t*ldr] = PetscSqrtReal(d);
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* one reduction for the inner products [Q W]^H W of the bs new vectors W = VEC_VV(n1),...,VEC_VV(n1+bs-1) */
+static PetscErrorCode KSPSGMRESBlockDot(KSP ksp,PetscInt n1,PetscInt bs,PetscScalar *gram)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscInt       t,ld = sgmres->max_k+1;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (t=0; t<bs; t++) {
+    ierr = VecMDotBegin(VEC_VV(n1+t),n1+bs,&VEC_VV(0),gram+t*ld);CHKERRQ(ierr);
+  }
+  ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  for (t=0; t<bs; t++) {
+    ierr = VecMDotEnd(VEC_VV(n1+t),n1+bs,&VEC_VV(0),gram+t*ld);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPSGMRESBlockOrthogonalization - Orthonormalizes the block Z = [VEC_VV(it),...,VEC_VV(it+bs)], whose first vector
+    is the last one of the orthonormal basis, and computes the new columns it,...,it+ncols-1 of the Hessenberg matrix.
+
+    The inner products of the new vectors with the basis and among themselves take a single reduction; if the Cholesky
+    factorization of their Gram matrix shows too much cancellation the block is projected a second time, which takes a
+    second reduction. If the new vectors are still numerically dependent only the leading ones are kept, and when not even
+    the first one is left the Krylov space is invariant (happy breakdown).
+
+    The basis recurrence Op Z(:,0:bs-1) = Z B, with the (bs+1) x bs tridiagonal matrix B of alpha, beta and gamma, and
+    Z = V Zc, with V the orthonormal basis and Zc upper triangular in its last rows, give the Hessenberg matrix from
+    H Zc(0:it+bs-1,0:bs-1) = Zc B. The known columns of H are moved to the right hand side and the remaining triangular
+    system is solved for the new ones.
+*/
+static PetscErrorCode KSPSGMRESBlockOrthogonalization(KSP ksp,PetscInt it,PetscInt bs,const PetscScalar *alpha,const PetscScalar *beta,const PetscScalar *gamma,PetscInt *ncols,PetscBool *hapend)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscInt       n1 = it+1,ld = sgmres->max_k+1,s = sgmres->s,nrows = it+bs+1,i,k,t,nv;
+  PetscScalar    *gram = sgmres->gram,*gram2 = sgmres->gram2,*cupd = gram,*R = sgmres->R,*zc = sgmres->zc,*hb = sgmres->hb;
+  PetscScalar    *work = sgmres->orthogwork,*h,c;
+  PetscReal      *dtol = sgmres->dtol;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscLogEventBegin(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+  ierr = KSPSGMRESBlockDot(ksp,n1,bs,gram);CHKERRQ(ierr);
+  /* the computed norms are accurate to about half the digits when less than sqrt(eps) of the squared norm is left */
+  for (t=0; t<bs; t++) dtol[t] = PETSC_SQRT_MACHINE_EPSILON*PetscRealPart(gram[n1+t+t*ld]);
+  ierr = KSPSGMRESCholesky(n1,bs,ld,gram,R,s,dtol,&nv);CHKERRQ(ierr);
+  if (nv < bs) {
+    ierr = PetscInfo2(ksp,"Block at iteration %D is projected twice, vector %D lost too much of its norm\n",it,nv);CHKERRQ(ierr);
+    for (t=0; t<bs; t++) {
+      for (i=0; i<n1; i++) work[i] = -gram[i+t*ld];
+      ierr = VecMAXPY(VEC_VV(n1+t),n1,work,&VEC_VV(0));CHKERRQ(ierr);
+    }
+    ierr = KSPSGMRESBlockDot(ksp,n1,bs,gram2);CHKERRQ(ierr);
+    /* a vector is dependent when it lost all but sqrt(eps) of its original norm, or too much to the earlier vectors of the block */
+    for (t=0; t<bs; t++) dtol[t] = PetscMax(PETSC_MACHINE_EPSILON*PetscRealPart(gram[n1+t+t*ld]),PETSC_SQRT_MACHINE_EPSILON*PetscRealPart(gram2[n1+t+t*ld]));
+    ierr = KSPSGMRESCholesky(n1,bs,ld,gram2,R,s,dtol,&nv);CHKERRQ(ierr);
+    for (t=0; t<bs; t++) {
+      for (i=0; i<n1; i++) gram[i+t*ld] += gram2[i+t*ld];
+    }
+    cupd = gram2;
+  }
+  if (nv < bs) {
+    ierr = PetscInfo3(ksp,"Block at iteration %D truncated to %D of %D vectors\n",it,nv,bs);CHKERRQ(ierr);
+  }
+
+  /* W <- (W - Q C) R^{-1}, column by column so the new orthonormal vectors are used in place */
+  for (t=0; t<nv; t++) {
+    for (i=0; i<n1; i++) work[i] = -cupd[i+t*ld];
+    for (k=0; k<t; k++) work[n1+k] = -R[k+t*s];
+    ierr = VecMAXPY(VEC_VV(n1+t),n1+t,work,&VEC_VV(0));CHKERRQ(ierr);
+    ierr = VecScale(VEC_VV(n1+t),1.0/R[t+t*s]);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+
+  *hapend = (PetscBool)!nv;
+  *ncols  = nv ? nv : 1;
+
+  /* coordinates of the block in the orthonormal basis */
+  ierr = PetscMemzero(zc,ld*(s+1)*sizeof(PetscScalar));CHKERRQ(ierr);
+  zc[it] = 1.0;
+  for (t=0; t<*ncols; t++) {
+    for (i=0; i<n1; i++) zc[i+(t+1)*ld] = gram[i+t*ld];
+    for (k=0; k<=t; k++) zc[n1+k+(t+1)*ld] = R[k+t*s];
+  }
+
+  /* new columns of the Hessenberg matrix */
+  for (t=0; t<*ncols; t++) {
+    h = hb + t*ld;
+    for (i=0; i<nrows; i++) {
+      h[i] = gamma[t]*zc[i+(t+1)*ld] + alpha[t]*zc[i+t*ld];
+      if (t) h[i] += beta[t]*zc[i+(t-1)*ld];
+    }
+    for (k=0; t && k<it; k++) {
+      c = zc[k+t*ld];
+      if (c == 0.0) continue;
+      for (i=0; i<=k+1; i++) h[i] -= *HES(i,k)*c;
+    }
+    for (k=0; k<t; k++) {
+      c = zc[it+k+t*ld];
+      for (i=0; i<nrows; i++) h[i] -= hb[i+k*ld]*c;
+    }
+    c = zc[it+t+t*ld];
+    for (i=0; i<nrows; i++) h[i] /= c;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPSGMRESCycle - Runs one restart cycle of SGMRES, in blocks of s vectors, or of a single vector in the first cycle
+    when the basis needs eigenvalue estimates.
+
+    On entry, the value in vector VEC_VV(0) should be the initial residual.
+*/
+static PetscErrorCode KSPSGMRESCycle(PetscInt *itcount,KSP ksp)
+{
+  KSP_SGMRES        *sgmres = (KSP_SGMRES*)(ksp->data);
+  PetscReal         res_norm,res = 0.0,hapbnd,tt;
+  PetscErrorCode    ierr;
+  PetscInt          it = 0,max_k = sgmres->max_k,s = sgmres->s,bs,ncols = 0,t,i;
+  PetscBool         hapend = PETSC_FALSE;
+  const PetscScalar zero = 0.0,one = 1.0,*alpha = sgmres->alpha,*beta = sgmres->beta,*gamma = sgmres->gamma;
+
+  PetscFunctionBegin;
+  if (itcount) *itcount = 0;
+  ierr   = VecNormalize(VEC_VV(0),&res_norm);CHKERRQ(ierr);
+  KSPCheckNorm(ksp,res_norm);
+  res    = res_norm;
+  *RS(0) = res_norm;
+
+  /* check for the convergence */
+  ierr       = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm = res;
+  ierr       = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  sgmres->it = (it - 1);
+  ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+  if (!res) {
+    ksp->reason = KSP_CONVERGED_ATOL;
+    ierr        = PetscInfo(ksp,"Converged due to zero residual norm on entry\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  if (!sgmres->basisready) { /* unshifted Arnoldi, which gives the eigenvalue estimates */
+    s     = 1;
+    alpha = beta = &zero;
+    gamma = &one;
+  }
+  ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+  while (!ksp->reason && it < max_k && ksp->its < ksp->max_it) {
+    bs = PetscMin(s,PetscMin(max_k - it,ksp->max_it - ksp->its));
+    while (sgmres->vv_allocated <= it + bs + VEC_OFFSET) {
+      ierr = KSPGMRESGetNewVectors(ksp,sgmres->vv_allocated - VEC_OFFSET);CHKERRQ(ierr);
+    }
+    /* gamma_t z_{t+1} = Op z_t - alpha_t z_t - beta_t z_{t-1}, with z_0 the last basis vector */
+    for (t=0; t<bs; t++) {
+      ierr = KSP_PCApplyBAorAB(ksp,VEC_VV(it+t),VEC_VV(it+t+1),VEC_TEMP_MATOP);CHKERRQ(ierr);
+      if (t) {
+        ierr = VecAXPBYPCZ(VEC_VV(it+t+1),-alpha[t]/gamma[t],-beta[t]/gamma[t],1.0/gamma[t],VEC_VV(it+t),VEC_VV(it+t-1));CHKERRQ(ierr);
+      } else {
+        ierr = VecAXPBY(VEC_VV(it+t+1),-alpha[t]/gamma[t],1.0/gamma[t],VEC_VV(it+t));CHKERRQ(ierr);
+      }
+    }
+    ierr = KSPSGMRESBlockOrthogonalization(ksp,it,bs,alpha,beta,gamma,&ncols,&hapend);CHKERRQ(ierr);
+
+    /* the s steps of the block update the least squares problem one column at a time */
+    for (t=0; t<ncols; t++) {
+      if (it) {
+        ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+        ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+      }
+      for (i=0; i<=it+1; i++) *HH(i,it) = *HES(i,it) = sgmres->hb[i+t*(max_k+1)];
+      tt = PetscAbsScalar(*HH(it+1,it));
+
+      /* check for the happy breakdown */
+      hapbnd = PetscAbsScalar(tt / *RS(it));
+      if (hapbnd > sgmres->haptol) hapbnd = sgmres->haptol;
+      if (tt < hapbnd) {
+        ierr   = PetscInfo2(ksp,"Detected happy breakdown, current hapbnd = %14.12e tt = %14.12e\n",(double)hapbnd,(double)tt);CHKERRQ(ierr);
+        hapend = PETSC_TRUE;
+      }
+      ierr = KSPSGMRESUpdateHessenberg(ksp,it,hapend,&res);CHKERRQ(ierr);
+
+      it++;
+      sgmres->it = (it-1);   /* For converged */
+      ksp->its++;
+      ksp->rnorm = res;
+      if (ksp->reason) break;
+
+      ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+
+      /* Catch error in happy breakdown and signal convergence and break from loop */
+      if (hapend) {
+        if (ksp->normtype == KSP_NORM_NONE) { /* convergence test was skipped in this case */
+          ksp->reason = KSP_CONVERGED_HAPPY_BREAKDOWN;
+        } else if (!ksp->reason) {
+          if (ksp->errorifnotconverged) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"You reached the happy break down, but convergence was not indicated. Residual norm = %g",(double)res);
+          else ksp->reason = KSP_DIVERGED_BREAKDOWN;
+        }
+      }
+      if (ksp->reason) break;
+    }
+  }
+
+  /* Monitor if we know that we will not return for a restart */
+  if (it && (ksp->reason || ksp->its >= ksp->max_it)) {
+    ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+    ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+  }
+
+  if (itcount) *itcount = it;
+
+  /* Form the solution (or the solution so far) */
+  ierr = KSPSGMRESBuildSoln(RS(0),ksp->vec_sol,ksp->vec_sol,ksp,it-1);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_SGMRES(KSP ksp)
+{
+  PetscErrorCode ierr;
+  PetscInt       its,itcount,neig;
+  KSP_SGMRES     *sgmres    = (KSP_SGMRES*)ksp->data;
+  PetscBool      guess_zero = ksp->guess_zero;
+
+  PetscFunctionBegin;
+  ierr     = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its = 0;
+  ierr     = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+
+  itcount     = 0;
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  while (!ksp->reason) {
+    ierr     = KSPInitialResidual(ksp,ksp->vec_sol,VEC_TEMP,VEC_TEMP_MATOP,VEC_VV(0),ksp->vec_rhs);CHKERRQ(ierr);
+    ierr     = KSPSGMRESCycle(&its,ksp);CHKERRQ(ierr);
+    if (!sgmres->basisready && its) {
+      /* the Ritz values of the first cycle are the eigenvalue estimates of the basis */
+      ierr = KSPComputeEigenvalues_GMRES(ksp,sgmres->max_k+1,sgmres->eigr,sgmres->eigi,&neig);CHKERRQ(ierr);
+      ierr = KSPSStepBasisCoefficients_Private(sgmres->basis,neig,sgmres->eigr,sgmres->eigi,sgmres->s,sgmres->alpha,sgmres->beta,sgmres->gamma);CHKERRQ(ierr);
+      ierr = PetscInfo1(ksp,"Basis computed from %D eigenvalue estimates\n",neig);CHKERRQ(ierr);
+      sgmres->basisready = PETSC_TRUE;
+    }
+    itcount += its;
+    if (itcount >= ksp->max_it) {
+      if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+    ksp->guess_zero = PETSC_FALSE; /* every future call to KSPInitialResidual() will have nonzero guess */
+  }
+  ksp->guess_zero = guess_zero; /* restore if user provided nonzero initial guess */
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_SGMRES(KSP ksp)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree3(sgmres->alpha,sgmres->beta,sgmres->gamma);CHKERRQ(ierr);
+  ierr = PetscFree5(sgmres->gram,sgmres->gram2,sgmres->R,sgmres->zc,sgmres->hb);CHKERRQ(ierr);
+  ierr = PetscFree3(sgmres->eigr,sgmres->eigi,sgmres->dtol);CHKERRQ(ierr);
+  sgmres->basisready = PETSC_FALSE;
+  ierr = KSPReset_GMRES(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_SGMRES(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_SGMRES(ksp);CHKERRQ(ierr);
+  ierr = KSPDestroy_GMRES(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPSGMRESBuildSoln - create the solution from the starting vector and the
+    current iterates.
+
+    Input parameters:
+        nrs - work area of size it + 1.
+        vguess  - index of initial guess
+        vdest - index of result.  Note that vguess may == vdest (replace
+                guess with the solution).
+        it - HH upper triangular part is a block of size (it+1) x (it+1)
+
+     This is an internal routine that knows about the SGMRES internals.
+ */
+static PetscErrorCode KSPSGMRESBuildSoln(PetscScalar *nrs,Vec vguess,Vec vdest,KSP ksp,PetscInt it)
+{
+  PetscScalar    tt;
+  PetscErrorCode ierr;
+  PetscInt       k,j;
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)(ksp->data);
+
+  PetscFunctionBegin;
+  /* Solve for solution vector that minimizes the residual */
+
+  if (it < 0) {                                 /* no sgmres steps have been performed */
+    ierr = VecCopy(vguess,vdest);CHKERRQ(ierr); /* VecCopy() is smart, exits immediately if vguess == vdest */
+    PetscFunctionReturn(0);
+  }
+  if (*HH(it,it) != 0.0) nrs[it] = *RS(it) / *HH(it,it);
+  else {
+    if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"You reached the break down in SGMRES; HH(it,it) = 0");
+    else ksp->reason = KSP_DIVERGED_BREAKDOWN;
+
+    ierr = PetscInfo2(ksp,"Likely your matrix or preconditioner is singular. HH(it,it) is identically zero; it = %D RS(it) = %g\n",it,(double)PetscAbsScalar(*RS(it)));CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  for (k=it-1; k>=0; k--) {
+    tt = *RS(k);
+    for (j=k+1; j<=it; j++) tt -= *HH(k,j) * nrs[j];
+    nrs[k] = tt / *HH(k,k);
+  }
+
+  /* Accumulate the correction to the solution of the preconditioned problem in TEMP */
+  ierr = VecZeroEntries(VEC_TEMP);CHKERRQ(ierr);
+  ierr = VecMAXPY(VEC_TEMP,it+1,nrs,&VEC_VV(0));CHKERRQ(ierr);
+  ierr = KSPUnwindPreconditioner(ksp,VEC_TEMP,VEC_TEMP_MATOP);CHKERRQ(ierr);
+  /* add solution to previous solution */
+  if (vdest == vguess) {
+    ierr = VecAXPY(vdest,1.0,VEC_TEMP);CHKERRQ(ierr);
+  } else {
+    ierr = VecWAXPY(vdest,1.0,VEC_TEMP,vguess);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Do the scalar work for the orthogonalization.  Return new residual norm.
+ */
+static PetscErrorCode KSPSGMRESUpdateHessenberg(KSP ksp,PetscInt it,PetscBool hapend,PetscReal *res)
+{
+  PetscScalar    *hh,*cc,*ss,*rs,tt;
+  PetscInt       j;
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)(ksp->data);
+
+  PetscFunctionBegin;
+  hh = HH(0,it);
+  cc = CC(0);
+  ss = SS(0);
+  rs = RS(0);
+
+  /* Apply all the previously computed plane rotations to the new column
+     of the Hessenberg matrix */
+  for (j=0; j<it; j++) {
+    tt      = hh[j];
+    hh[j]   = PetscConj(cc[j])*tt + ss[j]*hh[j+1];
+    hh[j+1] = cc[j]*hh[j+1] - ss[j]*tt;
+  }
+
+  /*
+    compute the new plane rotation, and apply it to:
+     1) the right-hand-side of the Hessenberg system
+     2) the new column of the Hessenberg matrix
+    thus obtaining the updated value of the residual
+  */
+  if (!hapend) {
+    tt = PetscSqrtScalar(PetscConj(hh[it])*hh[it] + PetscConj(hh[it+1])*hh[it+1]);
+    if (tt == 0.0) {
+      if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"tt == 0.0");
+      else {
+        ksp->reason = KSP_DIVERGED_NULL;
+        PetscFunctionReturn(0);
+      }
+    }
+    cc[it]   = hh[it] / tt;
+    ss[it]   = hh[it+1] / tt;
+    rs[it+1] = -(ss[it]*rs[it]);
+    rs[it]   = PetscConj(cc[it])*rs[it];
+    hh[it]   = PetscConj(cc[it])*hh[it] + ss[it]*hh[it+1];
+    *res     = PetscAbsScalar(rs[it+1]);
+  } else {
+    /* happy breakdown: HH(it+1, it) = 0, the residual of the least squares problem is zero */
+    *res = 0.0;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPBuildSolution_SGMRES(KSP ksp,Vec ptr,Vec *result)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ptr) {
+    if (!sgmres->sol_temp) {
+      ierr = VecDuplicate(ksp->vec_sol,&sgmres->sol_temp);CHKERRQ(ierr);
+      ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)sgmres->sol_temp);CHKERRQ(ierr);
+    }
+    ptr = sgmres->sol_temp;
+  }
+  if (!sgmres->nrs) {
+    /* allocate the work area */
+    ierr = PetscMalloc1(sgmres->max_k,&sgmres->nrs);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,sgmres->max_k*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+
+  ierr = KSPSGMRESBuildSoln(sgmres->nrs,ksp->vec_sol,ptr,ksp,sgmres->it);CHKERRQ(ierr);
+  if (result) *result = ptr;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_SGMRES(KSP ksp,PetscViewer viewer)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii,isstring;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERSTRING,&isstring);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  restart=%D, blocks of s=%D vectors in the %s basis, orthogonalized by block Gram-Schmidt and Cholesky QR\n",sgmres->max_k,sgmres->s,KSPSStepBasisTypes[sgmres->basis]);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  happy breakdown tolerance %g\n",(double)sgmres->haptol);CHKERRQ(ierr);
+  } else if (isstring) {
+    ierr = PetscViewerStringSPrintf(viewer,"s %D basis %s restart %D",sgmres->s,KSPSStepBasisTypes[sgmres->basis],sgmres->max_k);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_SGMRES(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscInt       s = sgmres->s;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSetFromOptions_GMRES(PetscOptionsObject,ksp);CHKERRQ(ierr);
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP s-step GMRES Options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_sgmres_s","Number of Krylov vectors orthogonalized with one reduction","None",s,&s,NULL);CHKERRQ(ierr);
+  if (s < 1) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Number of vectors in a block must be positive");
+  ierr = PetscOptionsEnum("-ksp_sgmres_basis","Polynomial basis of the blocks","None",KSPSStepBasisTypes,(PetscEnum)sgmres->basis,(PetscEnum*)&sgmres->basis,NULL);CHKERRQ(ierr);
+  if (s != sgmres->s && ksp->setupstage) {
+    ierr = KSPReset_SGMRES(ksp);CHKERRQ(ierr);
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  sgmres->s = s;
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+     KSPSGMRES - Implements the s-step (communication avoiding) Generalized Minimal Residual method.
+
+   Each block of s Krylov vectors is generated with a polynomial basis, without inner products, and is orthogonalized
+   against the previous Krylov vectors and among themselves by block classical Gram-Schmidt and a Cholesky QR, with a
+   single global reduction, instead of the s reductions (or more) of GMRES.
+
+   Options Database Keys:
++   -ksp_gmres_restart <restart> - the number of Krylov directions to orthogonalize against
+.   -ksp_gmres_haptol <tol> - sets the tolerance for "happy ending" (exact convergence)
+.   -ksp_gmres_preallocate - preallocate all the Krylov search directions initially (otherwise groups of
+                             vectors are allocated as needed)
+.   -ksp_sgmres_s <s> - the number of Krylov vectors generated and orthogonalized together (default 5)
+-   -ksp_sgmres_basis <newton,chebyshev,monomial> - the polynomial basis of a block (default newton)
+
+   Level: intermediate
+
+   Notes:
+   The Newton basis uses the Ritz values of the first restart cycle, in Leja order, as shifts and the Chebyshev basis
+   uses the interval spanned by their real parts, so the first cycle is run with blocks of a single vector. The monomial
+   basis (scaled powers of the operator) needs no estimates but becomes ill conditioned quickly, so it is only useful
+   for small s. A block whose Gram matrix is too ill conditioned is projected a second time, with a second reduction,
+   and then truncated to its leading well conditioned vectors. The residual norm and convergence test are computed
+   after each of the s steps of a block, as for KSPGMRES. Left and right preconditioning are supported.
+
+   The orthogonalization options of KSPGMRES do not apply.
+
+   Reference:
+   M. Hoemmen, Communication-avoiding Krylov subspace methods, PhD thesis, University of California, Berkeley, 2010.
+
+   Developer Notes:
+    This object is subclassed off of KSPGMRES
+
+.seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPGMRES, KSPPGMRES, KSPPIPEFGMRES, KSPSCG,
+           KSPGMRESSetRestart(), KSPGMRESSetHapTol(), KSPGMRESSetPreAllocateVectors()
+M*/
+
+PETSC_EXTERN PetscErrorCode KSPCreate_SGMRES(KSP ksp)
+{
+  KSP_SGMRES     *sgmres;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscNewLog(ksp,&sgmres);CHKERRQ(ierr);
+
+  ksp->data                              = (void*)sgmres;
+  ksp->ops->buildsolution                = KSPBuildSolution_SGMRES;
+  ksp->ops->setup                        = KSPSetUp_SGMRES;
+  ksp->ops->solve                        = KSPSolve_SGMRES;
+  ksp->ops->reset                        = KSPReset_SGMRES;
+  ksp->ops->destroy                      = KSPDestroy_SGMRES;
+  ksp->ops->view                         = KSPView_SGMRES;
+  ksp->ops->setfromoptions               = KSPSetFromOptions_SGMRES;
+  ksp->ops->computeextremesingularvalues = KSPComputeExtremeSingularValues_GMRES;
+  ksp->ops->computeeigenvalues           = KSPComputeEigenvalues_GMRES;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_RIGHT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_RIGHT,1);CHKERRQ(ierr);
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetPreAllocateVectors_C",KSPGMRESSetPreAllocateVectors_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetRestart_C",KSPGMRESSetRestart_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetRestart_C",KSPGMRESGetRestart_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetHapTol_C",KSPGMRESSetHapTol_GMRES);CHKERRQ(ierr);
+
+  sgmres->haptol         = 1.0e-30;
+  sgmres->q_preallocate  = 0;
+  sgmres->delta_allocate = SGMRES_DELTA_DIRECTIONS;
+  sgmres->orthog         = NULL;
+  sgmres->nrs            = 0;
+  sgmres->sol_temp       = 0;
+  sgmres->max_k          = SGMRES_DEFAULT_MAXK;
+  sgmres->Rsvd           = 0;
+  sgmres->orthogwork     = 0;
+  sgmres->cgstype        = KSP_GMRES_CGS_REFINE_NEVER;
+  sgmres->s              = SGMRES_DEFAULT_S;
+  sgmres->basis          = KSP_SSTEP_BASIS_NEWTON;
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,36 @@
+#if !defined(__SGMRES)
+#define __SGMRES
+
+#define KSPGMRES_NO_MACROS
+#include <../src/ksp/ksp/impls/gmres/gmresimpl.h>
+
+typedef struct {
+  KSPGMRESHEADER
+
+  /* s-step basis */
+  PetscInt          s;                /* number of Krylov vectors generated and orthogonalized together */
+  KSPSStepBasisType basis;            /* polynomial basis of each block */
+  PetscBool         basisready;       /* the recurrence below is known, otherwise the first cycle computes eigenvalue estimates */
+  PetscScalar       *alpha,*beta,*gamma; /* three term recurrence of the basis, length s */
+
+  /* work space for one block, see KSPSGMRESBlockOrthogonalization() */
+  PetscScalar       *gram,*gram2;     /* inner products of the new vectors with the basis, (max_k+1) x s */
+  PetscScalar       *R;               /* Cholesky factor of the new vectors, s x s */
+  PetscScalar       *zc;              /* coordinates of the block in the orthonormal basis, (max_k+1) x (s+1) */
+  PetscScalar       *hb;              /* new columns of the Hessenberg matrix, (max_k+1) x s */
+  PetscReal         *dtol;            /* breakdown thresholds of the Cholesky factorization, s */
+  PetscReal         *eigr,*eigi;      /* eigenvalue estimates, max_k+1 */
+} KSP_SGMRES;
+
+#define HH(a,b)  (sgmres->hh_origin + (b)*(sgmres->max_k+2)+(a))
+#define HES(a,b) (sgmres->hes_origin + (b)*(sgmres->max_k+1)+(a))
+#define CC(a)    (sgmres->cc_origin + (a))
+#define SS(a)    (sgmres->ss_origin + (a))
+#define RS(a)    (sgmres->rs_origin + (a))
+
+/* vector names */
+#define VEC_OFFSET     2
+#define VEC_TEMP       sgmres->vecs[0]
+#define VEC_TEMP_MATOP sgmres->vecs[1]
+#define VEC_VV(i)      sgmres->vecs[VEC_OFFSET+i]
+#endif
@@ -362,3 +362,115 @@ PetscErrorCode KSPPlotEigenContours_Private(KSP ksp,PetscInt neig,const PetscRea
   ierr = PetscFree3(xloc,yloc,value);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
+
+/*
+   KSPSStepBasisCoefficients_Private - Computes the three term recurrence
+
+       gamma[t] z_{t+1} = Op z_t - alpha[t] z_t - beta[t] z_{t-1},   t = 0,...,s-1
+
+   that generates the polynomial basis z_0,...,z_s of a Krylov space in the s-step methods, from n estimates (re[i],im[i])
+   of the eigenvalues of the operator Op. With no estimates all bases are monomial.
+
+   KSP_SSTEP_BASIS_NEWTON: the shifts alpha[] are the estimates in Leja order. In real arithmetic only the estimates with a
+     nonnegative imaginary part are used and a complex conjugate pair is applied as one real quadratic factor, with a nonzero beta[].
+   KSP_SSTEP_BASIS_CHEBYSHEV: the Chebyshev polynomials of the smallest interval containing the real parts of the estimates
+   KSP_SSTEP_BASIS_MONOMIAL: powers of Op, scaled by the largest estimate
+*/
+PetscErrorCode KSPSStepBasisCoefficients_Private(KSPSStepBasisType type,PetscInt n,const PetscReal *re,const PetscReal *im,PetscInt s,PetscScalar *alpha,PetscScalar *beta,PetscScalar *gamma)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,j,k,t,m,*order;
+  PetscReal      radius = 0.0,diam = 0.0,lo,hi,c,d,scale,*score;
+  PetscBool      *used,*dup;
+
+  PetscFunctionBegin;
+  for (t=0; t<s; t++) {
+    alpha[t] = 0.0;
+    beta[t]  = 0.0;
+    gamma[t] = 1.0;
+  }
+  if (n <= 0) PetscFunctionReturn(0);
+  for (i=0; i<n; i++) {
+    radius = PetscMax(radius,PetscSqrtReal(re[i]*re[i] + im[i]*im[i]));
+    for (j=0; j<i; j++) diam = PetscMax(diam,PetscSqrtReal(PetscSqr(re[i]-re[j]) + PetscSqr(im[i]-im[j])));
+  }
+  switch (type) {
+  case KSP_SSTEP_BASIS_MONOMIAL:
+    if (radius > 0.0) for (t=0; t<s; t++) gamma[t] = radius;
+    break;
+  case KSP_SSTEP_BASIS_CHEBYSHEV:
+    lo = hi = re[0];
+    for (i=1; i<n; i++) {
+      lo = PetscMin(lo,re[i]);
+      hi = PetscMax(hi,re[i]);
+    }
+    c = 0.5*(hi + lo);
+    d = 0.5*(hi - lo);
+    if (d <= 0.0) d = c != 0.0 ? PetscAbsReal(c) : 1.0;
+    /* z_1 = (Op - c) z_0/d and z_{t+1} = 2 (Op - c) z_t/d - z_{t-1} */
+    for (t=0; t<s; t++) {
+      alpha[t] = c;
+      beta[t]  = t ? 0.5*d : 0.0;
+      gamma[t] = t ? 0.5*d : d;
+    }
+    break;
+  case KSP_SSTEP_BASIS_NEWTON:
+    /* a quarter of the diameter is the capacity of an interval, it keeps the basis vectors of order one */
+    scale = diam > 0.0 ? 0.25*diam : (radius > 0.0 ? radius : 1.0);
+    ierr  = PetscMalloc4(n,&order,n,&score,n,&used,n,&dup);CHKERRQ(ierr);
+    for (i=0; i<n; i++) {
+#if defined(PETSC_USE_COMPLEX)
+      used[i] = PETSC_FALSE;
+#else
+      used[i] = (PetscBool)(im[i] < 0.0); /* represented by its conjugate */
+#endif
+      score[i] = 0.0;
+      dup[i]   = PETSC_FALSE;
+    }
+    /* Leja ordering: start with the estimate of largest modulus, then maximize the product of the distances to the ones chosen */
+    for (m=0; m<n; m++) {
+      k = -1;
+      for (i=0; i<n; i++) {
+        if (used[i]) continue;
+        if (!m) {
+          if (k < 0 || re[i]*re[i] + im[i]*im[i] > re[k]*re[k] + im[k]*im[k]) k = i;
+        } else if (k < 0 || (dup[k] && !dup[i]) || (dup[k] == dup[i] && score[i] > score[k])) k = i;
+      }
+      if (k < 0) break;
+      used[k]  = PETSC_TRUE;
+      order[m] = k;
+      for (i=0; i<n; i++) {
+        PetscReal dist;
+
+        if (used[i]) continue;
+        dist = PetscSqrtReal(PetscSqr(re[i]-re[k]) + PetscSqr(im[i]-im[k]));
+#if !defined(PETSC_USE_COMPLEX)
+        if (im[k] > 0.0) dist *= PetscSqrtReal(PetscSqr(re[i]-re[k]) + PetscSqr(im[i]+im[k]));
+#endif
+        if (dist > 0.0) score[i] += PetscLogReal(dist);
+        else dup[i] = PETSC_TRUE;
+      }
+    }
+    for (t=0, j=0; m && t<s; j++) {
+      k = order[j%m];
+#if defined(PETSC_USE_COMPLEX)
+      alpha[t] = re[k] + PETSC_i*im[k];
+      t++;
+#else
+      alpha[t] = re[k];
+      if (im[k] > 0.0 && t+1 < s) {
+        /* (Op - a - ib)(Op - a + ib) = (Op - a)^2 + b^2 */
+        alpha[t+1] = re[k];
+        beta[t+1]  = -im[k]*im[k]/scale;
+        t++;
+      }
+      t++;
+#endif
+    }
+    for (t=0; t<s; t++) gamma[t] = scale;
+    ierr = PetscFree4(order,score,used,dup);CHKERRQ(ierr);
+    break;
+  default: SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Unknown s-step basis");
+  }
+  PetscFunctionReturn(0);
+}
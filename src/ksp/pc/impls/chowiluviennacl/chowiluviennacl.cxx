@@ -162,11 +162,14 @@ static PetscErrorCode PCSetFromOptions_CHOWILUVIENNACL(PetscOptionItems *PetscOp
 
 
 /*MC
-     PCCHOWILUViennaCL  - A smoothed agglomeration algorithm that can be used via the CUDA, OpenCL, and OpenMP backends of ViennaCL
+     PCCHOWILUVIENNACL  - The fine grained parallel ILU of Chow and Patel that can be used via the CUDA, OpenCL, and OpenMP backends of ViennaCL
+
+   Notes:
+     Without ViennaCL the same algorithm is available for SeqAIJ matrices with -pc_type ilu -pc_factor_mat_solver_type chowilu
 
    Level: advanced
 
-.seealso:  PCCreate(), PCSetType(), PCType (for list of available types), PC
+.seealso:  PCCreate(), PCSetType(), PCType (for list of available types), PC, MATSOLVERCHOWILU
 
 M*/
 
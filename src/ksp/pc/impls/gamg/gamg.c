@@ -419,7 +419,8 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
   PetscInt       fine_level,level,level1,bs,M,N,qq,lidx,nASMBlocksArr[PETSC_GAMG_MAXLEVELS];
   MPI_Comm       comm;
   PetscMPIInt    rank,size,nactivepe;
-  Mat            Aarr[PETSC_GAMG_MAXLEVELS],Parr[PETSC_GAMG_MAXLEVELS];
+  Mat            Aarr[PETSC_GAMG_MAXLEVELS],Parr[PETSC_GAMG_MAXLEVELS],Pold;
+  PetscObjectState nzstate[PETSC_GAMG_MAXLEVELS];
   IS             *ASMLocalIDsArr[PETSC_GAMG_MAXLEVELS];
   PetscLogDouble nnz0=0.,nnztot=0.;
   MatInfo        info;
@@ -436,9 +437,11 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
       ierr = PCReset_MG(pc);CHKERRQ(ierr);
       pc->setupcalled = 0;
     } else {
-      PC_MG_Levels **mglevels = mg->levels;
+      PC_MG_Levels     **mglevels = mg->levels;
       /* just do Galerkin grids */
-      Mat          B,dA,dB;
+      Mat              B,dA,dB;
+      MatReuse         reuse = MAT_REUSE_MATRIX;
+      PetscObjectState state;
 
       if (!pc->setupcalled) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"PCSetUp() has not been called yet");
       if (pc_gamg->Nlevels > 1) {
@@ -448,8 +451,12 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
         ierr = KSPSetOperators(mglevels[pc_gamg->Nlevels-1]->smoothd,dA,dB);CHKERRQ(ierr);
 
         for (level=pc_gamg->Nlevels-2; level>=0; level--) {
-          /* 2nd solve, matrix structure can change from repartitioning or process reduction but don't know if we have process reduction here. Should fix */
-          if (pc_gamg->setup_count==2 /* && pc_gamg->repart||reduction */) {
+          /* only the numeric product is needed if the coarse matrix was computed by MatPtAP() with this interpolation
+             from a fine matrix with the same nonzero pattern; this is not the case after repartitioning or process
+             reduction, and once a level is recomputed all coarser ones are too */
+          ierr = MatGetNonzeroState(dB,&state);CHKERRQ(ierr);
+          if (state != mglevels[level]->Bnonzerostate) reuse = MAT_INITIAL_MATRIX;
+          if (reuse == MAT_INITIAL_MATRIX) {
             ierr = PetscInfo2(pc,"new RAP after first solve level %D, %D setup\n",level,pc_gamg->setup_count);CHKERRQ(ierr);
             ierr = MatPtAP(dB,mglevels[level+1]->interpolate,MAT_INITIAL_MATRIX,2.0,&B);CHKERRQ(ierr);
             ierr = MatDestroy(&mglevels[level]->A);CHKERRQ(ierr);
@@ -459,6 +466,7 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
             ierr = KSPGetOperators(mglevels[level]->smoothd,NULL,&B);CHKERRQ(ierr);
             ierr = MatPtAP(dB,mglevels[level+1]->interpolate,MAT_REUSE_MATRIX,1.0,&B);CHKERRQ(ierr);
           }
+          mglevels[level]->Bnonzerostate = state;
           ierr = KSPSetOperators(mglevels[level]->smoothd,B,B);CHKERRQ(ierr);
           dB   = B;
         }
@@ -562,7 +570,12 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
     if (is_last) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Is last ????????");
     if (N <= pc_gamg->coarse_eq_limit) is_last = PETSC_TRUE;
     if (level1 == pc_gamg->Nlevels-1) is_last = PETSC_TRUE;
+    Pold = Parr[level1];
     ierr = pc_gamg->ops->createlevel(pc, Aarr[level], bs, &Parr[level1], &Aarr[level1], &nactivepe, NULL, is_last);CHKERRQ(ierr);
+    /* the coarse matrix is the product of the fine one and the final interpolation unless it was repartitioned */
+    if (Parr[level1] == Pold) {
+      ierr = MatGetNonzeroState(Aarr[level],&nzstate[level1]);CHKERRQ(ierr);
+    } else nzstate[level1] = -1;
 
 #if defined PETSC_GAMG_USE_LOG
     ierr = PetscLogEventEnd(petsc_gamg_setup_events[SET2],0,0,0,0);CHKERRQ(ierr);
@@ -602,6 +615,7 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
       /* set ops */
       ierr = KSPSetOperators(smoother, Aarr[level], Aarr[level]);CHKERRQ(ierr);
       ierr = PCMGSetInterpolation(pc, lidx, Parr[level+1]);CHKERRQ(ierr);
+      mg->levels[lidx-1]->Bnonzerostate = nzstate[level+1];
 
       /* set defaults */
       ierr = KSPSetType(smoother, KSPCHEBYSHEV);CHKERRQ(ierr);
@@ -852,7 +866,8 @@ static PetscErrorCode PCGAMGSetRepartition_GAMG(PC pc, PetscBool n)
 
    Notes:
     this may negatively affect the convergence rate of the method on new matrices if the matrix entries change a great deal, but allows
-          rebuilding the preconditioner quicker.
+          rebuilding the preconditioner quicker. While the nonzero pattern of the matrix does not change the coarse grid operators are
+          updated with only the numeric part of MatPtAP().
 
    Concepts: Unstructured multigrid preconditioner
 
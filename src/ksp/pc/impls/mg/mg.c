@@ -720,9 +720,10 @@ PetscErrorCode PCSetUp_MG(PC pc)
   }
 
   if (mg->galerkin < PC_MG_GALERKIN_NONE) {
-    Mat       A,B;
-    PetscBool doA = PETSC_FALSE,doB = PETSC_FALSE;
-    MatReuse  reuse = MAT_INITIAL_MATRIX;
+    Mat              A,B;
+    PetscBool        doA = PETSC_FALSE,doB = PETSC_FALSE;
+    MatReuse         reuse = MAT_INITIAL_MATRIX;
+    PetscObjectState Astate,Bstate;
 
     if ((mg->galerkin == PC_MG_GALERKIN_PMAT) || (mg->galerkin == PC_MG_GALERKIN_BOTH)) doB = PETSC_TRUE;
     if ((mg->galerkin == PC_MG_GALERKIN_MAT) || ((mg->galerkin == PC_MG_GALERKIN_BOTH) && (dA != dB))) doA = PETSC_TRUE;
@@ -735,14 +736,24 @@ PetscErrorCode PCSetUp_MG(PC pc)
       if (!mglevels[i+1]->restrct) {
         ierr = PCMGSetRestriction(pc,i+1,mglevels[i+1]->interpolate);CHKERRQ(ierr);
       }
+      /* the symbolic products are only reused while the nonzero pattern of the finer operators is unchanged,
+         once a level is recomputed all coarser ones are too */
+      ierr = MatGetNonzeroState(dA,&Astate);CHKERRQ(ierr);
+      ierr = MatGetNonzeroState(dB,&Bstate);CHKERRQ(ierr);
+      if (reuse == MAT_REUSE_MATRIX && ((doA && Astate != mglevels[i]->Anonzerostate) || (doB && Bstate != mglevels[i]->Bnonzerostate))) {
+        ierr  = PetscInfo1(pc,"Nonzero pattern of level %D operator changed, recomputing the symbolic Galerkin products\n",i+1);CHKERRQ(ierr);
+        reuse = MAT_INITIAL_MATRIX;
+      }
       if (reuse == MAT_REUSE_MATRIX) {
         ierr = KSPGetOperators(mglevels[i]->smoothd,&A,&B);CHKERRQ(ierr);
       }
       if (doA) {
         ierr = MatGalerkin(mglevels[i+1]->restrct,dA,mglevels[i+1]->interpolate,reuse,1.0,&A);CHKERRQ(ierr);
+        mglevels[i]->Anonzerostate = Astate;
       }
       if (doB) {
         ierr = MatGalerkin(mglevels[i+1]->restrct,dB,mglevels[i+1]->interpolate,reuse,1.0,&B);CHKERRQ(ierr);
+        mglevels[i]->Bnonzerostate = Bstate;
       }
       /* the management of the PetscObjectReference() and PetscObjecDereference() below is rather delicate */
       if (!doA && dAeqdB) {
@@ -761,6 +772,12 @@ PetscErrorCode PCSetUp_MG(PC pc)
       }
       if (reuse == MAT_INITIAL_MATRIX) {
         ierr = KSPSetOperators(mglevels[i]->smoothd,A,B);CHKERRQ(ierr);
+        if (pc->setupcalled) { /* replacing the operators of an existing hierarchy */
+          if (mglevels[i]->smoothu && mglevels[i]->smoothu != mglevels[i]->smoothd) {
+            ierr = KSPSetOperators(mglevels[i]->smoothu,A,B);CHKERRQ(ierr);
+          }
+          ierr = MatDestroy(&mglevels[i]->A);CHKERRQ(ierr);
+        }
         ierr = PetscObjectDereference((PetscObject)A);CHKERRQ(ierr);
         ierr = PetscObjectDereference((PetscObject)B);CHKERRQ(ierr);
       }
@@ -1119,6 +1136,9 @@ PetscErrorCode PCMGSetGalerkin_MG(PC pc,PCMGGalerkinType use)
     Some codes that use PCMG such as PCGAMG use Galerkin internally while constructing the hierarchy and thus do not
      use the PCMG construction of the coarser grids.
 
+    When the preconditioner is set up again the symbolic part of the products is reused, only the numeric part is
+     recomputed, unless the nonzero pattern of a finer grid matrix has changed.
+
 .keywords: MG, set, Galerkin
 
 .seealso: PCMGGetGalerkin(), PCMGGalerkinType
@@ -0,0 +1,203 @@
+static char help[] = "Scaling benchmark of the threaded SeqAIJ and Seq Vec kernels over a range of OpenMP thread counts.\n\
+Checks that every thread count gives the results of one thread.\n\
+  -n <n>         : the matrix is the 5 point Laplacian on an n x n grid\n\
+  -threads <list>: thread counts to run, for example -threads 1,2,4,8\n\
+  -nvec <nv>     : number of vectors in VecMDot()\n\
+  -niter <it>    : number of times each kernel is timed\n\
+  -empty_rows    : only fill every fourth row, so the compressed row kernels are used\n\
+  -time          : print the time per call and the speedup over the first thread count\n\
+The threaded MatMultTranspose() is selected with -mat_seqaij_multtranspose <serial,csc,buffers>.\n\n";
+
+/*
+   Run, for example, with
+     ./ex229 -n 1000 -threads 1,2,4,8,16 -niter 100 -time
+   on a node of the target machine and with OMP_PROC_BIND=close or spread; the Vec kernels are memory bound,
+   so their speedup flattens out once the threads saturate the memory bandwidth of the NUMA domains in use.
+*/
+
+#include <petscmat.h>
+#include <petsctime.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+#define NKERNELS 6
+static const char *kernelnames[NKERNELS] = {"MatMult","MatMultAdd","MatMultTranspose","VecAXPY","VecMDot","VecNorm"};
+
+int main(int argc,char **argv)
+{
+  Mat            A;
+  Vec            x,y,z,w,*v;
+  PetscInt       n = 100,N,i,j,k,t,row,nthreads[16],nt = 16,nv = 8,niter = 10;
+  PetscScalar    *dots,*dots1;
+  PetscReal      nrm,nrm1 = 0.0,err,tol = 100*PETSC_SMALL;
+  PetscLogDouble t0,times[16][NKERNELS];
+  PetscBool      flg,time = PETSC_FALSE,emptyrows = PETSC_FALSE;
+  Vec            y1,z1,x1,w1;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nvec",&nv,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-niter",&niter,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-empty_rows",&emptyrows,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-time",&time,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetIntArray(NULL,NULL,"-threads",nthreads,&nt,&flg);CHKERRQ(ierr);
+  if (!flg) {nthreads[0] = 1; nt = 1;}
+  for (t=0; t<nt; t++) {
+    if (nthreads[t] < 1) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Thread count %D must be positive",nthreads[t]);
+  }
+#if !defined(PETSC_HAVE_OPENMP)
+  /* without OpenMP there is a single thread count to run */
+  nt = 1; nthreads[0] = 1;
+#endif
+  N = n*n;
+
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,N,N,5,NULL,&A);CHKERRQ(ierr);
+  for (row=0; row<N; row++) {
+    PetscInt    cols[5],ncols = 0;
+    PetscScalar vals[5];
+
+    if (emptyrows && row%4) continue;
+    i = row/n; j = row%n;
+    if (i > 0)   {cols[ncols] = row-n; vals[ncols++] = -1.0;}
+    if (j > 0)   {cols[ncols] = row-1; vals[ncols++] = -1.0;}
+    cols[ncols] = row; vals[ncols++] = 4.0;
+    if (j < n-1) {cols[ncols] = row+1; vals[ncols++] = -1.0;}
+    if (i < n-1) {cols[ncols] = row+n; vals[ncols++] = -1.0;}
+    ierr = MatSetValues(A,1,&row,ncols,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&x1);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&y1);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z1);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&w);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&w1);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(x,nv,&v);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nv,&dots,nv,&dots1);CHKERRQ(ierr);
+  for (k=0; k<nv; k++) {
+    PetscScalar *a;
+
+    ierr = VecGetArray(v[k],&a);CHKERRQ(ierr);
+    for (i=0; i<N; i++) a[i] = PetscSinReal((PetscReal)(k+1)*(i+1)/N);
+    ierr = VecRestoreArray(v[k],&a);CHKERRQ(ierr);
+  }
+
+  for (t=0; t<nt; t++) {
+#if defined(PETSC_HAVE_OPENMP)
+    omp_set_num_threads((int)nthreads[t]);
+#endif
+    /* MatMult */
+    ierr = VecCopy(v[0],x);CHKERRQ(ierr);
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    for (k=0; k<niter; k++) {ierr = MatMult(A,x,y);CHKERRQ(ierr);}
+    ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+    times[t][0] = -t0;
+    /* MatMultAdd */
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    for (k=0; k<niter; k++) {ierr = MatMultAdd(A,x,y,z);CHKERRQ(ierr);}
+    ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+    times[t][1] = -t0;
+    /* MatMultTranspose */
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    for (k=0; k<niter; k++) {ierr = MatMultTranspose(A,z,w);CHKERRQ(ierr);}
+    ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+    times[t][2] = -t0;
+    /* VecAXPY, alternating the sign of alpha so x does not grow */
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    for (k=0; k<niter; k++) {ierr = VecAXPY(x,(k%2) ? -0.5 : 0.5,v[1%nv]);CHKERRQ(ierr);}
+    ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+    times[t][3] = -t0;
+    /* VecMDot */
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    for (k=0; k<niter; k++) {ierr = VecMDot(x,nv,v,dots);CHKERRQ(ierr);}
+    ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+    times[t][4] = -t0;
+    /* VecNorm */
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    for (k=0; k<niter; k++) {ierr = VecNorm(z,NORM_2,&nrm);CHKERRQ(ierr);}
+    ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+    times[t][5] = -t0;
+
+    /* compare with the results of the first thread count */
+    if (!t) {
+      ierr = VecCopy(x,x1);CHKERRQ(ierr);
+      ierr = VecCopy(y,y1);CHKERRQ(ierr);
+      ierr = VecCopy(z,z1);CHKERRQ(ierr);
+      ierr = VecCopy(w,w1);CHKERRQ(ierr);
+      for (k=0; k<nv; k++) dots1[k] = dots[k];
+      nrm1 = nrm;
+    } else {
+      ierr = VecAXPY(x1,-1.0,x);CHKERRQ(ierr);
+      ierr = VecNorm(x1,NORM_INFINITY,&err);CHKERRQ(ierr);
+      if (err > tol) {ierr = PetscPrintf(PETSC_COMM_SELF,"VecAXPY with %D threads differs by %g\n",nthreads[t],(double)err);CHKERRQ(ierr);}
+      ierr = VecAXPY(y1,-1.0,y);CHKERRQ(ierr);
+      ierr = VecNorm(y1,NORM_INFINITY,&err);CHKERRQ(ierr);
+      if (err > tol) {ierr = PetscPrintf(PETSC_COMM_SELF,"MatMult with %D threads differs by %g\n",nthreads[t],(double)err);CHKERRQ(ierr);}
+      ierr = VecAXPY(z1,-1.0,z);CHKERRQ(ierr);
+      ierr = VecNorm(z1,NORM_INFINITY,&err);CHKERRQ(ierr);
+      if (err > tol) {ierr = PetscPrintf(PETSC_COMM_SELF,"MatMultAdd with %D threads differs by %g\n",nthreads[t],(double)err);CHKERRQ(ierr);}
+      ierr = VecAXPY(w1,-1.0,w);CHKERRQ(ierr);
+      ierr = VecNorm(w1,NORM_INFINITY,&err);CHKERRQ(ierr);
+      if (err > tol) {ierr = PetscPrintf(PETSC_COMM_SELF,"MatMultTranspose with %D threads differs by %g\n",nthreads[t],(double)err);CHKERRQ(ierr);}
+      for (k=0; k<nv; k++) {
+        if (PetscAbsScalar(dots[k]-dots1[k]) > tol*PetscAbsScalar(dots1[k])) {
+          ierr = PetscPrintf(PETSC_COMM_SELF,"VecMDot with %D threads differs for vector %D\n",nthreads[t],k);CHKERRQ(ierr);
+        }
+      }
+      if (PetscAbsReal(nrm-nrm1) > tol*nrm1) {ierr = PetscPrintf(PETSC_COMM_SELF,"VecNorm with %D threads differs by %g\n",nthreads[t],(double)PetscAbsReal(nrm-nrm1));CHKERRQ(ierr);}
+      ierr = VecCopy(x,x1);CHKERRQ(ierr);
+      ierr = VecCopy(y,y1);CHKERRQ(ierr);
+      ierr = VecCopy(z,z1);CHKERRQ(ierr);
+      ierr = VecCopy(w,w1);CHKERRQ(ierr);
+    }
+  }
+
+  if (time && niter > 0) {
+    ierr = PetscPrintf(PETSC_COMM_SELF,"Matrix of %D rows, %D vectors in VecMDot, time per call in microseconds (speedup)\n",N,nv);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_SELF,"%-8s","threads");CHKERRQ(ierr);
+    for (k=0; k<NKERNELS; k++) {ierr = PetscPrintf(PETSC_COMM_SELF," %20s",kernelnames[k]);CHKERRQ(ierr);}
+    ierr = PetscPrintf(PETSC_COMM_SELF,"\n");CHKERRQ(ierr);
+    for (t=0; t<nt; t++) {
+      ierr = PetscPrintf(PETSC_COMM_SELF,"%-8D",nthreads[t]);CHKERRQ(ierr);
+      for (k=0; k<NKERNELS; k++) {ierr = PetscPrintf(PETSC_COMM_SELF," %12.3f (%5.2f)",1e6*times[t][k]/niter,times[0][k]/times[t][k]);CHKERRQ(ierr);}
+      ierr = PetscPrintf(PETSC_COMM_SELF,"\n");CHKERRQ(ierr);
+    }
+  }
+
+  ierr = PetscFree2(dots,dots1);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(nv,&v);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&x1);CHKERRQ(ierr);
+  ierr = VecDestroy(&y1);CHKERRQ(ierr);
+  ierr = VecDestroy(&z1);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = VecDestroy(&w1);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      args: -n 80 -threads 1,2,3 -nvec 6 -mat_no_inode
+      output_file: output/ex229_1.out
+
+   test:
+      suffix: empty_rows
+      args: -n 80 -threads 1,4 -nvec 3 -mat_no_inode -empty_rows
+      output_file: output/ex229_1.out
+
+   test:
+      suffix: multtranspose
+      args: -n 80 -threads 1,3 -nvec 1 -mat_seqaij_multtranspose {{csc buffers}separate output} -empty_rows {{0 1}separate output}
+      output_file: output/ex229_1.out
+
+TEST*/
@@ -0,0 +1,106 @@
+static char help[] = "Compares MatMultAdd(), MatMultTranspose(), MatMultTransposeAdd() and MatSOR() of MATSEQSELL with MATSEQAIJ.\n\
+Uses a nonsymmetric matrix with rows of different lengths whose size is not a multiple of the slice height.\n\n";
+
+#include <petscmat.h>
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  Vec            x,y,z,w1,w2;
+  PetscErrorCode ierr;
+  PetscInt       i,j,k,l,n = 8,m,row,cols[5],f;
+  PetscScalar    vals[5];
+  PetscReal      omega[] = {1.0,0.7},norm,tol = 100*PETSC_MACHINE_EPSILON;
+  PetscRandom    rctx;
+  MatSORType     flag,flags[] = {SOR_FORWARD_SWEEP,SOR_BACKWARD_SWEEP,SOR_SYMMETRIC_SWEEP};
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  m    = n*n+3;
+
+  /* 2d convection-diffusion stencil on the first n*n rows, the last three rows only couple to a few far away columns */
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,m,m,5,NULL,&A);CHKERRQ(ierr);
+  for (row=0; row<m; row++) {
+    k = 0;
+    if (row < n*n) {
+      i = row/n; j = row - i*n;
+      if (i > 0)   {cols[k] = row-n; vals[k++] = -1.5;}
+      if (j > 0)   {cols[k] = row-1; vals[k++] = -1.2;}
+      cols[k] = row; vals[k++] = 6.0 + (PetscReal)(row%7);
+      if (j < n-1) {cols[k] = row+1; vals[k++] = -0.8;}
+      if (i < n-1) {cols[k] = row+n; vals[k++] = -0.5;}
+    } else {
+      cols[k] = (row*17)%(n*n); vals[k++] = 0.3;
+      if (row > n*n) {cols[k] = row-1; vals[k++] = -0.2;}
+      cols[k] = row; vals[k++] = 2.0;
+    }
+    ierr = MatSetValues(A,1,&row,k,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatConvert(A,MATSEQSELL,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&w1);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&w2);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rctx);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rctx);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rctx);CHKERRQ(ierr);
+  ierr = VecSetRandom(y,rctx);CHKERRQ(ierr);
+
+  ierr = MatMultAdd(A,x,y,w1);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,y,w2);CHKERRQ(ierr);
+  ierr = VecAXPY(w2,-1.0,w1);CHKERRQ(ierr);
+  ierr = VecNorm(w2,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  if (norm > tol) {ierr = PetscPrintf(PETSC_COMM_SELF,"MatMultAdd() differs by %g\n",(double)norm);CHKERRQ(ierr);}
+
+  ierr = MatMultTranspose(A,x,w1);CHKERRQ(ierr);
+  ierr = MatMultTranspose(B,x,w2);CHKERRQ(ierr);
+  ierr = VecAXPY(w2,-1.0,w1);CHKERRQ(ierr);
+  ierr = VecNorm(w2,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  if (norm > tol) {ierr = PetscPrintf(PETSC_COMM_SELF,"MatMultTranspose() differs by %g\n",(double)norm);CHKERRQ(ierr);}
+
+  ierr = MatMultTransposeAdd(A,x,y,w1);CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd(B,x,y,w2);CHKERRQ(ierr);
+  ierr = VecAXPY(w2,-1.0,w1);CHKERRQ(ierr);
+  ierr = VecNorm(w2,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  if (norm > tol) {ierr = PetscPrintf(PETSC_COMM_SELF,"MatMultTransposeAdd() differs by %g\n",(double)norm);CHKERRQ(ierr);}
+
+  /* the sweeps are compared with and without zero initial guess and with several iterations */
+  for (f=0; f<3; f++) {
+    for (k=0; k<2; k++) {
+      for (l=0; l<2; l++) {
+        flag = l ? flags[f] : (MatSORType)(flags[f] | SOR_ZERO_INITIAL_GUESS);
+        ierr = VecCopy(z,w1);CHKERRQ(ierr);
+        ierr = VecCopy(z,w2);CHKERRQ(ierr);
+        ierr = MatSOR(A,y,omega[k],flag,0.0,2,1,w1);CHKERRQ(ierr);
+        ierr = MatSOR(B,y,omega[k],flag,0.0,2,1,w2);CHKERRQ(ierr);
+        ierr = VecAXPY(w2,-1.0,w1);CHKERRQ(ierr);
+        ierr = VecNorm(w2,NORM_INFINITY,&norm);CHKERRQ(ierr);
+        if (norm > tol) {ierr = PetscPrintf(PETSC_COMM_SELF,"MatSOR() with flag %D and omega %g differs by %g\n",(PetscInt)flag,(double)omega[k],(double)norm);CHKERRQ(ierr);}
+        ierr = VecCopy(w1,z);CHKERRQ(ierr);
+      }
+    }
+  }
+  ierr = PetscRandomDestroy(&rctx);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&w1);CHKERRQ(ierr);
+  ierr = VecDestroy(&w2);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      args: -n 13
+
+TEST*/
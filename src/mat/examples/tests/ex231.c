@@ -0,0 +1,222 @@
+static char help[] = "Compares MatSolve() with the level sets of -mat_factor_solve_levels with the sequential MatSolve()\n\
+for ILU(0), ILU(1) and ICC(0) of a 3d Poisson and a 3d convection-diffusion problem, or with -chowilu compares\n\
+the Chow-Patel ILU(0) and ILU(1) of MATSOLVERCHOWILU with the sequential ILU of MATSOLVERPETSC.\n\
+  -n <n>       : the grid is n x n x n\n\
+  -beta <b>    : the convection coefficient of the convection-diffusion problem\n\
+  -threads <t> : number of OpenMP threads for the solves with the level sets or the second Chow-Patel factorization\n\
+  -ordering <o>: ordering of the factors\n\
+  -chowilu     : test MATSOLVERCHOWILU instead of the level sets\n\n";
+
+#include <petscmat.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+/* 7 point Laplacian, with a central difference of the convection (1,1,1)*beta */
+static PetscErrorCode CreateMatrix(PetscInt n,PetscReal beta,Mat *A)
+{
+  PetscInt       N = n*n*n,row,i,j,k,ncols,cols[7];
+  PetscScalar    vals[7],c = 0.5*beta/n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,N,N,7,NULL,A);CHKERRQ(ierr);
+  for (row=0; row<N; row++) {
+    i = row%n; j = (row/n)%n; k = row/(n*n);
+    ncols = 0;
+    if (k > 0)   {cols[ncols] = row-n*n; vals[ncols++] = -1.0 - c;}
+    if (j > 0)   {cols[ncols] = row-n;   vals[ncols++] = -1.0 - c;}
+    if (i > 0)   {cols[ncols] = row-1;   vals[ncols++] = -1.0 - c;}
+    cols[ncols] = row; vals[ncols++] = 6.0;
+    if (i < n-1) {cols[ncols] = row+1;   vals[ncols++] = -1.0 + c;}
+    if (j < n-1) {cols[ncols] = row+n;   vals[ncols++] = -1.0 + c;}
+    if (k < n-1) {cols[ncols] = row+n*n; vals[ncols++] = -1.0 + c;}
+    ierr = MatSetValues(*A,1,&row,ncols,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* sweeps and solvesweeps are only used by MATSOLVERCHOWILU, solvelevels only by MATSOLVERPETSC */
+static PetscErrorCode Factor(Mat A,MatSolverType type,MatFactorType ftype,PetscInt levels,const char *ordering,PetscBool solvelevels,const char *sweeps,const char *solvesweeps,Mat *F)
+{
+  MatFactorInfo  info;
+  IS             row,col;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = PetscOptionsSetValue(NULL,"-mat_factor_solve_levels",solvelevels ? "1" : "0");CHKERRQ(ierr);
+  if (sweeps) {
+    ierr = PetscOptionsSetValue(NULL,"-mat_chowilu_sweeps",sweeps);CHKERRQ(ierr);
+    ierr = PetscOptionsSetValue(NULL,"-mat_chowilu_solve_sweeps",solvesweeps);CHKERRQ(ierr);
+  }
+  ierr = MatGetFactor(A,type,ftype,F);CHKERRQ(ierr);
+  ierr = MatGetOrdering(A,ordering,&row,&col);CHKERRQ(ierr);
+  ierr = MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+  info.levels = levels;
+  info.fill   = 2.0;
+  if (ftype == MAT_FACTOR_ILU) {
+    ierr = MatILUFactorSymbolic(*F,A,row,col,&info);CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(*F,A,&info);CHKERRQ(ierr);
+  } else {
+    ierr = MatICCFactorSymbolic(*F,A,row,&info);CHKERRQ(ierr);
+    ierr = MatCholeskyFactorNumeric(*F,A,&info);CHKERRQ(ierr);
+  }
+  ierr = ISDestroy(&row);CHKERRQ(ierr);
+  ierr = ISDestroy(&col);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CompareSolveLevels(Mat A,Vec b,const char *problem,PetscBool symmetric,PetscInt threads,const char *ordering)
+{
+  Mat            F0,F1;
+  Vec            x0,x1;
+  PetscInt       t;
+  PetscReal      err,nrm;
+  const char     *tests[3] = {"ILU(0)","ILU(1)","ICC(0)"};
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = VecDuplicate(b,&x0);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&x1);CHKERRQ(ierr);
+  for (t=0; t<3; t++) {
+    if (t == 2 && !symmetric) continue;
+    ierr = Factor(A,MATSOLVERPETSC,t < 2 ? MAT_FACTOR_ILU : MAT_FACTOR_ICC,t%2,ordering,PETSC_FALSE,NULL,NULL,&F0);CHKERRQ(ierr);
+    ierr = Factor(A,MATSOLVERPETSC,t < 2 ? MAT_FACTOR_ILU : MAT_FACTOR_ICC,t%2,ordering,PETSC_TRUE,NULL,NULL,&F1);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP)
+    omp_set_num_threads(1);
+#endif
+    ierr = MatSolve(F0,b,x0);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP)
+    omp_set_num_threads((int)threads);
+#endif
+    ierr = MatSolve(F1,b,x1);CHKERRQ(ierr);
+    ierr = VecNorm(x0,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+    ierr = VecAXPY(x1,-1.0,x0);CHKERRQ(ierr);
+    ierr = VecNorm(x1,NORM_INFINITY,&err);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_SELF,"%s %s: solves with the level sets %s\n",problem,tests[t],err <= 100*PETSC_SMALL*nrm ? "agree" : "differ");CHKERRQ(ierr);
+    ierr = MatDestroy(&F0);CHKERRQ(ierr);
+    ierr = MatDestroy(&F1);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&x0);CHKERRQ(ierr);
+  ierr = VecDestroy(&x1);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CompareChowILU(Mat A,Vec b,const char *problem,PetscInt threads,const char *ordering)
+{
+  Mat            F0,F1,F2;
+  Vec            x0,x1,x2,r;
+  PetscInt       lev;
+  PetscReal      err,res0,res1,nrm;
+  MatSolverType  type;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = VecDuplicate(b,&x0);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&x1);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&x2);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&r);CHKERRQ(ierr);
+  for (lev=0; lev<2; lev++) {
+#if defined(PETSC_HAVE_OPENMP)
+    omp_set_num_threads(1);
+#endif
+    ierr = Factor(A,MATSOLVERPETSC,MAT_FACTOR_ILU,lev,ordering,PETSC_FALSE,NULL,NULL,&F0);CHKERRQ(ierr);
+    ierr = MatSolve(F0,b,x0);CHKERRQ(ierr);
+    ierr = VecNorm(x0,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+    ierr = MatMult(A,x0,r);CHKERRQ(ierr);
+    ierr = VecAXPY(r,-1.0,b);CHKERRQ(ierr);
+    ierr = VecNorm(r,NORM_2,&res0);CHKERRQ(ierr);
+
+    /* with enough sweeps the fixed point iteration gives the factors of the sequential ILU */
+    ierr = Factor(A,MATSOLVERCHOWILU,MAT_FACTOR_ILU,lev,ordering,PETSC_FALSE,"200","0",&F1);CHKERRQ(ierr);
+    ierr = MatFactorGetSolverType(F1,&type);CHKERRQ(ierr);
+    ierr = MatSolve(F1,b,x1);CHKERRQ(ierr);
+    ierr = VecAXPY(x1,-1.0,x0);CHKERRQ(ierr);
+    ierr = VecNorm(x1,NORM_INFINITY,&err);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_SELF,"%s ILU(%D) %s with 200 sweeps and exact solves: %s\n",problem,lev,type,err <= 1.e-10*nrm ? "agrees" : "differs");CHKERRQ(ierr);
+    ierr = MatDestroy(&F1);CHKERRQ(ierr);
+
+    /* a few sweeps make a preconditioner nearly as good, with the same result for any number of threads */
+    ierr = Factor(A,MATSOLVERCHOWILU,MAT_FACTOR_ILU,lev,ordering,PETSC_FALSE,"3","3",&F1);CHKERRQ(ierr);
+    ierr = MatSolve(F1,b,x1);CHKERRQ(ierr);
+    ierr = MatMult(A,x1,r);CHKERRQ(ierr);
+    ierr = VecAXPY(r,-1.0,b);CHKERRQ(ierr);
+    ierr = VecNorm(r,NORM_2,&res1);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP)
+    omp_set_num_threads((int)threads);
+#endif
+    ierr = Factor(A,MATSOLVERCHOWILU,MAT_FACTOR_ILU,lev,ordering,PETSC_FALSE,"3","3",&F2);CHKERRQ(ierr);
+    ierr = MatSolve(F2,b,x2);CHKERRQ(ierr);
+    ierr = VecAXPY(x2,-1.0,x1);CHKERRQ(ierr);
+    ierr = VecNorm(x2,NORM_INFINITY,&err);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_SELF,"%s ILU(%D) %s with 3 sweeps: residual %s than twice the sequential one, threads %s\n",problem,lev,type,res1 < 2.0*res0 ? "smaller" : "larger",err <= 100*PETSC_MACHINE_EPSILON*nrm ? "agree" : "differ");CHKERRQ(ierr);
+    ierr = MatDestroy(&F0);CHKERRQ(ierr);
+    ierr = MatDestroy(&F1);CHKERRQ(ierr);
+    ierr = MatDestroy(&F2);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&x0);CHKERRQ(ierr);
+  ierr = VecDestroy(&x1);CHKERRQ(ierr);
+  ierr = VecDestroy(&x2);CHKERRQ(ierr);
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Mat            A;
+  Vec            b;
+  PetscInt       n = 20,threads = 2,p;
+  PetscReal      beta[2] = {0.0,20.0};
+  PetscBool      chowilu = PETSC_FALSE;
+  char           ordering[256] = MATORDERINGNATURAL;
+  const char     *problems[2] = {"Poisson","convection-diffusion"};
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-beta",&beta[1],NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-threads",&threads,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetString(NULL,NULL,"-ordering",ordering,sizeof(ordering),NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-chowilu",&chowilu,NULL);CHKERRQ(ierr);
+
+  for (p=0; p<2; p++) {
+    ierr = CreateMatrix(n,beta[p],&A);CHKERRQ(ierr);
+    ierr = MatCreateVecs(A,NULL,&b);CHKERRQ(ierr);
+    ierr = VecSetRandom(b,NULL);CHKERRQ(ierr);
+    if (chowilu) {
+      ierr = CompareChowILU(A,b,problems[p],threads,ordering);CHKERRQ(ierr);
+    } else {
+      /* the convection-diffusion matrix is not symmetric */
+      ierr = CompareSolveLevels(A,b,problems[p],(PetscBool)(p == 0),threads,ordering);CHKERRQ(ierr);
+    }
+    ierr = VecDestroy(&b);CHKERRQ(ierr);
+    ierr = MatDestroy(&A);CHKERRQ(ierr);
+  }
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      args: -threads 2 -ordering {{natural rcm}separate output}
+      output_file: output/ex231_1.out
+
+   test:
+      suffix: threads
+      args: -threads 3 -n 24 -mat_no_inode
+      output_file: output/ex231_1.out
+
+   test:
+      suffix: chowilu
+      args: -chowilu -n 10 -beta 10 -threads 2 -ordering {{natural rcm}separate output}
+      output_file: output/ex231_chowilu.out
+
+   test:
+      suffix: chowilu_threads
+      args: -chowilu -n 16 -beta 10 -threads 3
+      output_file: output/ex231_chowilu.out
+
+TEST*/
@@ -0,0 +1,147 @@
+static char help[] = "Tests the vectorized SeqAIJ inode MatMult(), MatMultAdd() and MatSOR() against the scalar inode kernels.\n\
+The second matrix uses the prefix scalar_, run with -scalar_mat_inode_simd false.\n\
+  -m <rows> : number of rows\n\n";
+
+#include <petscmat.h>
+
+/*
+   Builds a diagonally dominant matrix whose rows form inodes of sizes 1 to 5 (cycling through 1,2,3,4,5,3,2),
+   each node coupled to a number of columns that changes from node to node, so the vectorized kernels see
+   rows of every length modulo the vector width
+*/
+static PetscErrorCode CreateInodeMatrix(PetscInt m,const char prefix[],Mat *A)
+{
+  const PetscInt sizes[] = {1,2,3,4,5,3,2};
+  PetscInt       r,s,c,k,p,node,ncols,cols[32];
+  PetscScalar    v[32];
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = MatCreate(PETSC_COMM_SELF,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,m,m,m);CHKERRQ(ierr);
+  ierr = MatSetOptionsPrefix(*A,prefix);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(*A);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(*A,32,NULL);CHKERRQ(ierr);
+  for (r=0,node=0; r<m; r+=s,node++) {
+    s = PetscMin(sizes[node%7],m-r);
+    c = (node*7)%17;
+    for (p=0; p<s; p++) {
+      ncols = 0;
+      for (k=0; k<s; k++) {
+        cols[ncols] = r+k;
+        v[ncols++]  = (k == p) ? 20.0 + 0.01*(r+p) : 1.0/(2.0 + PetscAbsInt(k-p));
+      }
+      /* the columns of the node are those after it, with a stride of 3 wrapping around to the start of the matrix */
+      for (k=0; k<c; k++) {
+        if ((r+s+3*k)%m >= r && (r+s+3*k)%m < r+s) break;
+        cols[ncols] = (r+s+3*k)%m;
+        v[ncols++]  = -0.5/(1.0 + k) - 0.05*p;
+      }
+      k    = r+p;
+      ierr = MatSetValues(*A,1,&k,ncols,cols,v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* the relative difference between x and y, destroys y */
+static PetscErrorCode RelDiff(Vec x,Vec y,PetscReal *err)
+{
+  PetscReal      nrm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = VecNorm(x,NORM_2,&nrm);CHKERRQ(ierr);
+  ierr = VecAXPY(y,-1.0,x);CHKERRQ(ierr);
+  ierr = VecNorm(y,NORM_2,err);CHKERRQ(ierr);
+  if (nrm > 0.0) *err /= nrm;
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Mat               A,B;
+  Vec               x,b,z,y[2];
+  PetscInt          m = 211,i,j,nodes[2];
+  PetscReal         err,maxerr = 0.0;
+  PetscRandom       rand;
+  const MatSORType  flags[] = {SOR_FORWARD_SWEEP,SOR_BACKWARD_SWEEP,SOR_SYMMETRIC_SWEEP,SOR_LOCAL_FORWARD_SWEEP,SOR_LOCAL_BACKWARD_SWEEP,SOR_LOCAL_SYMMETRIC_SWEEP};
+  PetscErrorCode    ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = CreateInodeMatrix(m,NULL,&A);CHKERRQ(ierr);
+  ierr = CreateInodeMatrix(m,"scalar_",&B);CHKERRQ(ierr);
+  ierr = MatInodeGetInodeSizes(A,&nodes[0],NULL,NULL);CHKERRQ(ierr);
+  ierr = MatInodeGetInodeSizes(B,&nodes[1],NULL,NULL);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_SELF,"Inodes %D and %D\n",nodes[0],nodes[1]);CHKERRQ(ierr);
+
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y[0]);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y[1]);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(b,rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(z,rand);CHKERRQ(ierr);
+
+  ierr = MatMult(A,x,y[0]);CHKERRQ(ierr);
+  ierr = MatMult(B,x,y[1]);CHKERRQ(ierr);
+  ierr = RelDiff(y[0],y[1],&err);CHKERRQ(ierr);
+  maxerr = PetscMax(maxerr,err);
+
+  ierr = MatMultAdd(A,x,z,y[0]);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,z,y[1]);CHKERRQ(ierr);
+  ierr = RelDiff(y[0],y[1],&err);CHKERRQ(ierr);
+  maxerr = PetscMax(maxerr,err);
+
+  /* in place, y = y + A x */
+  ierr = VecCopy(z,y[0]);CHKERRQ(ierr);
+  ierr = VecCopy(z,y[1]);CHKERRQ(ierr);
+  ierr = MatMultAdd(A,x,y[0],y[0]);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,y[1],y[1]);CHKERRQ(ierr);
+  ierr = RelDiff(y[0],y[1],&err);CHKERRQ(ierr);
+  maxerr = PetscMax(maxerr,err);
+  ierr = PetscPrintf(PETSC_COMM_SELF,"MatMult() and MatMultAdd(): %s\n",maxerr < 1.e-12 ? "agree" : "differ");CHKERRQ(ierr);
+
+  /* each sweep from a zero and from a nonzero initial guess */
+  maxerr = 0.0;
+  for (i=0; i<6; i++) {
+    for (j=0; j<2; j++) {
+      ierr = VecCopy(x,y[0]);CHKERRQ(ierr);
+      ierr = VecCopy(x,y[1]);CHKERRQ(ierr);
+      ierr = MatSOR(A,b,1.0,j ? flags[i] : (flags[i] | SOR_ZERO_INITIAL_GUESS),0.0,2,1,y[0]);CHKERRQ(ierr);
+      ierr = MatSOR(B,b,1.0,j ? flags[i] : (flags[i] | SOR_ZERO_INITIAL_GUESS),0.0,2,1,y[1]);CHKERRQ(ierr);
+      ierr = RelDiff(y[0],y[1],&err);CHKERRQ(ierr);
+      maxerr = PetscMax(maxerr,err);
+    }
+  }
+  ierr = PetscPrintf(PETSC_COMM_SELF,"MatSOR(): %s\n",maxerr < 1.e-12 ? "agree" : "differ");CHKERRQ(ierr);
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&y[0]);CHKERRQ(ierr);
+  ierr = VecDestroy(&y[1]);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      args: -mat_inode_simd true -scalar_mat_inode_simd false
+
+   test:
+      suffix: 2
+      args: -m 1000 -mat_inode_simd true -scalar_mat_inode_simd false
+      output_file: output/ex233_2.out
+
+TEST*/
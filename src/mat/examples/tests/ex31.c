@@ -15,6 +15,7 @@ int main(int argc,char **args)
   PetscMPIInt    rank,size;
   PetscErrorCode ierr;
   PetscViewer    viewer;
+  PetscBool      prealloc = PETSC_FALSE;
 #if defined(PETSC_USE_LOG)
   PetscLogEvent MATRIX_GENERATE,MATRIX_READ;
 #endif
@@ -24,6 +25,7 @@ int main(int argc,char **args)
   ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
   ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-preallocate",&prealloc,NULL);CHKERRQ(ierr);
   N    = m*n;
 
   /* PART 1:  Generate matrix, then write it in binary format */
@@ -66,6 +68,11 @@ int main(int argc,char **args)
   ierr = PetscPrintf(PETSC_COMM_WORLD,"reading matrix in binary from matrix.dat ...\n");CHKERRQ(ierr);
   ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD,"matrix.dat",FILE_MODE_READ,&viewer);CHKERRQ(ierr);
   ierr = MatCreate(PETSC_COMM_WORLD,&C);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(C);CHKERRQ(ierr);
+  if (prealloc) { /* loading must replace the storage of an already preallocated matrix */
+    ierr = MatSetSizes(C,PETSC_DECIDE,PETSC_DECIDE,N,N);CHKERRQ(ierr);
+    ierr = MatSetUp(C);CHKERRQ(ierr);
+  }
   ierr = MatLoad(C,viewer);CHKERRQ(ierr);
   ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
   ierr = PetscLogEventEnd(MATRIX_READ,0,0,0,0);CHKERRQ(ierr);
@@ -86,4 +93,42 @@ int main(int argc,char **args)
    test:
       filter: grep -v "MPI processes"
 
+   test:
+      suffix: mmap
+      args: -viewer_binary_mmap
+      filter: grep -v "MPI processes"
+      output_file: output/ex31_1.out
+
+   test:
+      suffix: mmap_preallocated
+      args: -viewer_binary_mmap -preallocate -malloc_dump
+      filter: grep -v "MPI processes"
+      output_file: output/ex31_1.out
+
+   test:
+      suffix: mmap_2
+      nsize: 3
+      args: -viewer_binary_mmap
+      filter: grep -v "MPI processes" | sed -e "s/mpiaij/seqaij/g"
+      output_file: output/ex31_1.out
+
+   test:
+      suffix: mpiio
+      nsize: 3
+      args: -viewer_binary_mpiio
+      filter: grep -v "MPI processes" | sed -e "s/mpiaij/seqaij/g"
+      output_file: output/ex31_1.out
+
+   test:
+      suffix: mpiio_baij
+      nsize: 3
+      args: -viewer_binary_mpiio -mat_type baij -matload_block_size 3 -viewer_binary_skip_info
+      filter: grep -v "MPI processes"
+
+   test:
+      suffix: mpiio_sbaij
+      nsize: 3
+      args: -viewer_binary_mpiio -mat_type sbaij -mat_block_size 2
+      filter: grep -v "MPI processes"
+
 TEST*/
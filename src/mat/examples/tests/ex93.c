@@ -242,6 +242,11 @@ PetscErrorCode testPTAPRectangular(void)
       args: -B_matmatmult_via btheap
       output_file: output/ex93_1.out
 
+   test:
+      suffix: hash
+      args: -B_matmatmult_via hash
+      output_file: output/ex93_1.out
+
    test:
       suffix: heap
       args: -B_matmatmult_via heap
@@ -316,6 +316,17 @@ int main(int argc,char **argv)
      args: -Mx 10 -My 5 -Mz 10 -matmatmult_via scalable -matptap_via scalable -inner_diag_matmatmult_via btheap -inner_offdiag_matmatmult_via btheap
      output_file: output/ex96_1.out
 
+   test:
+     suffix: seq_hash
+     nsize: 3
+     args: -Mx 10 -My 5 -Mz 10 -matmatmult_via scalable -matptap_via scalable -inner_diag_matmatmult_via hash -inner_offdiag_matmatmult_via hash
+     output_file: output/ex96_1.out
+
+   test:
+     suffix: hash
+     args: -Mx 10 -My 5 -Mz 10 -matmatmult_via hash
+     output_file: output/ex96_1.out
+
    test:
      suffix: seq_llcondensed
      nsize: 3
@@ -1265,63 +1265,29 @@ PetscErrorCode MatView_MPIAIJ_Binary(Mat mat,PetscViewer viewer)
   Mat_SeqAIJ     *A   = (Mat_SeqAIJ*)aij->A->data;
   Mat_SeqAIJ     *B   = (Mat_SeqAIJ*)aij->B->data;
   PetscErrorCode ierr;
-  PetscMPIInt    rank,size,tag = ((PetscObject)viewer)->tag;
-  int            fd;
-  PetscInt       nz,header[4],*row_lengths,*range=0,rlen,i;
-  PetscInt       nzmax,*column_indices,j,k,col,*garray = aij->garray,cnt,cstart = mat->cmap->rstart,rnz = 0;
+  PetscInt       nz,header[4],*row_lengths,i,m = mat->rmap->n;
+  PetscInt       *column_indices,j,k,col,*garray = aij->garray,cnt,cstart = mat->cmap->rstart;
   PetscScalar    *column_values;
-  PetscInt       message_count,flowcontrolcount;
   FILE           *file;
 
   PetscFunctionBegin;
-  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)mat),&rank);CHKERRQ(ierr);
-  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)mat),&size);CHKERRQ(ierr);
   nz   = A->nz + B->nz;
-  ierr = PetscViewerBinaryGetDescriptor(viewer,&fd);CHKERRQ(ierr);
-  if (!rank) {
-    header[0] = MAT_FILE_CLASSID;
-    header[1] = mat->rmap->N;
-    header[2] = mat->cmap->N;
-
-    ierr = MPI_Reduce(&nz,&header[3],1,MPIU_INT,MPI_SUM,0,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-    ierr = PetscBinaryWrite(fd,header,4,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
-    /* get largest number of rows any processor has */
-    rlen  = mat->rmap->n;
-    range = mat->rmap->range;
-    for (i=1; i<size; i++) rlen = PetscMax(rlen,range[i+1] - range[i]);
-  } else {
-    ierr = MPI_Reduce(&nz,0,1,MPIU_INT,MPI_SUM,0,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-    rlen = mat->rmap->n;
-  }
-
-  /* load up the local row counts */
-  ierr = PetscMalloc1(rlen+1,&row_lengths);CHKERRQ(ierr);
-  for (i=0; i<mat->rmap->n; i++) row_lengths[i] = A->i[i+1] - A->i[i] + B->i[i+1] - B->i[i];
-
-  /* store the row lengths to the file */
-  ierr = PetscViewerFlowControlStart(viewer,&message_count,&flowcontrolcount);CHKERRQ(ierr);
-  if (!rank) {
-    ierr = PetscBinaryWrite(fd,row_lengths,mat->rmap->n,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
-    for (i=1; i<size; i++) {
-      ierr = PetscViewerFlowControlStepMaster(viewer,i,&message_count,flowcontrolcount);CHKERRQ(ierr);
-      rlen = range[i+1] - range[i];
-      ierr = MPIULong_Recv(row_lengths,rlen,MPIU_INT,i,tag,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-      ierr = PetscBinaryWrite(fd,row_lengths,rlen,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
-    }
-    ierr = PetscViewerFlowControlEndMaster(viewer,&message_count);CHKERRQ(ierr);
-  } else {
-    ierr = PetscViewerFlowControlStepWorker(viewer,rank,&message_count);CHKERRQ(ierr);
-    ierr = MPIULong_Send(row_lengths,mat->rmap->n,MPIU_INT,0,tag,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-    ierr = PetscViewerFlowControlEndWorker(viewer,&message_count);CHKERRQ(ierr);
-  }
+  header[0] = MAT_FILE_CLASSID;
+  header[1] = mat->rmap->N;
+  header[2] = mat->cmap->N;
+  ierr = MPIU_Allreduce(&nz,&header[3],1,MPIU_INT,MPI_SUM,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
+  ierr = PetscViewerBinaryWrite(viewer,header,4,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
+
+  /* store the row lengths to the file, each process writes the rows it owns */
+  ierr = PetscMalloc1(m+1,&row_lengths);CHKERRQ(ierr);
+  for (i=0; i<m; i++) row_lengths[i] = A->i[i+1] - A->i[i] + B->i[i+1] - B->i[i];
+  ierr = PetscViewerBinaryWriteAll(viewer,row_lengths,m,mat->rmap->rstart,mat->rmap->N,PETSC_INT);CHKERRQ(ierr);
   ierr = PetscFree(row_lengths);CHKERRQ(ierr);
 
-  /* load up the local column indices */
-  nzmax = nz; /* th processor needs space a largest processor needs */
-  ierr  = MPI_Reduce(&nz,&nzmax,1,MPIU_INT,MPI_MAX,0,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-  ierr  = PetscMalloc1(nzmax+1,&column_indices);CHKERRQ(ierr);
-  cnt   = 0;
-  for (i=0; i<mat->rmap->n; i++) {
+  /* load up the local column indices, in global column order */
+  ierr = PetscMalloc1(nz+1,&column_indices);CHKERRQ(ierr);
+  cnt  = 0;
+  for (i=0; i<m; i++) {
     for (j=B->i[i]; j<B->i[i+1]; j++) {
       if ((col = garray[B->j[j]]) > cstart) break;
       column_indices[cnt++] = col;
@@ -1329,33 +1295,14 @@ PetscErrorCode MatView_MPIAIJ_Binary(Mat mat,PetscViewer viewer)
     for (k=A->i[i]; k<A->i[i+1]; k++) column_indices[cnt++] = A->j[k] + cstart;
     for (; j<B->i[i+1]; j++) column_indices[cnt++] = garray[B->j[j]];
   }
-  if (cnt != A->nz + B->nz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_LIB,"Internal PETSc error: cnt = %D nz = %D",cnt,A->nz+B->nz);
-
-  /* store the column indices to the file */
-  ierr = PetscViewerFlowControlStart(viewer,&message_count,&flowcontrolcount);CHKERRQ(ierr);
-  if (!rank) {
-    MPI_Status status;
-    ierr = PetscBinaryWrite(fd,column_indices,nz,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
-    for (i=1; i<size; i++) {
-      ierr = PetscViewerFlowControlStepMaster(viewer,i,&message_count,flowcontrolcount);CHKERRQ(ierr);
-      ierr = MPI_Recv(&rnz,1,MPIU_INT,i,tag,PetscObjectComm((PetscObject)mat),&status);CHKERRQ(ierr);
-      if (rnz > nzmax) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_LIB,"Internal PETSc error: nz = %D nzmax = %D",nz,nzmax);
-      ierr = MPIULong_Recv(column_indices,rnz,MPIU_INT,i,tag,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-      ierr = PetscBinaryWrite(fd,column_indices,rnz,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
-    }
-    ierr = PetscViewerFlowControlEndMaster(viewer,&message_count);CHKERRQ(ierr);
-  } else {
-    ierr = PetscViewerFlowControlStepWorker(viewer,rank,&message_count);CHKERRQ(ierr);
-    ierr = MPI_Send(&nz,1,MPIU_INT,0,tag,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-    ierr = MPIULong_Send(column_indices,nz,MPIU_INT,0,tag,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-    ierr = PetscViewerFlowControlEndWorker(viewer,&message_count);CHKERRQ(ierr);
-  }
+  if (cnt != nz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_LIB,"Internal PETSc error: cnt = %D nz = %D",cnt,nz);
+  ierr = PetscViewerBinaryWriteAll(viewer,column_indices,nz,PETSC_DETERMINE,header[3],PETSC_INT);CHKERRQ(ierr);
   ierr = PetscFree(column_indices);CHKERRQ(ierr);
 
   /* load up the local column values */
-  ierr = PetscMalloc1(nzmax+1,&column_values);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nz+1,&column_values);CHKERRQ(ierr);
   cnt  = 0;
-  for (i=0; i<mat->rmap->n; i++) {
+  for (i=0; i<m; i++) {
     for (j=B->i[i]; j<B->i[i+1]; j++) {
       if (garray[B->j[j]] > cstart) break;
       column_values[cnt++] = B->a[j];
@@ -1363,27 +1310,8 @@ PetscErrorCode MatView_MPIAIJ_Binary(Mat mat,PetscViewer viewer)
     for (k=A->i[i]; k<A->i[i+1]; k++) column_values[cnt++] = A->a[k];
     for (; j<B->i[i+1]; j++) column_values[cnt++] = B->a[j];
   }
-  if (cnt != A->nz + B->nz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Internal PETSc error: cnt = %D nz = %D",cnt,A->nz+B->nz);
-
-  /* store the column values to the file */
-  ierr = PetscViewerFlowControlStart(viewer,&message_count,&flowcontrolcount);CHKERRQ(ierr);
-  if (!rank) {
-    MPI_Status status;
-    ierr = PetscBinaryWrite(fd,column_values,nz,PETSC_SCALAR,PETSC_TRUE);CHKERRQ(ierr);
-    for (i=1; i<size; i++) {
-      ierr = PetscViewerFlowControlStepMaster(viewer,i,&message_count,flowcontrolcount);CHKERRQ(ierr);
-      ierr = MPI_Recv(&rnz,1,MPIU_INT,i,tag,PetscObjectComm((PetscObject)mat),&status);CHKERRQ(ierr);
-      if (rnz > nzmax) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_LIB,"Internal PETSc error: nz = %D nzmax = %D",nz,nzmax);
-      ierr = MPIULong_Recv(column_values,rnz,MPIU_SCALAR,i,tag,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-      ierr = PetscBinaryWrite(fd,column_values,rnz,PETSC_SCALAR,PETSC_TRUE);CHKERRQ(ierr);
-    }
-    ierr = PetscViewerFlowControlEndMaster(viewer,&message_count);CHKERRQ(ierr);
-  } else {
-    ierr = PetscViewerFlowControlStepWorker(viewer,rank,&message_count);CHKERRQ(ierr);
-    ierr = MPI_Send(&nz,1,MPIU_INT,0,tag,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-    ierr = MPIULong_Send(column_values,nz,MPIU_SCALAR,0,tag,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-    ierr = PetscViewerFlowControlEndWorker(viewer,&message_count);CHKERRQ(ierr);
-  }
+  if (cnt != nz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Internal PETSc error: cnt = %D nz = %D",cnt,nz);
+  ierr = PetscViewerBinaryWriteAll(viewer,column_values,nz,PETSC_DETERMINE,header[3],PETSC_SCALAR);CHKERRQ(ierr);
   ierr = PetscFree(column_values);CHKERRQ(ierr);
 
   ierr = PetscViewerBinaryGetInfoPointer(viewer,&file);CHKERRQ(ierr);
@@ -1459,7 +1387,10 @@ PetscErrorCode MatView_MPIAIJ_ASCIIorDraworSocket(Mat mat,PetscViewer viewer)
       PetscFunctionReturn(0);
     }
   } else if (isbinary) {
-    if (size == 1) {
+    PetscBool mpiio;
+
+    ierr = PetscViewerBinaryGetUseMPIIO(viewer,&mpiio);CHKERRQ(ierr);
+    if (size == 1 && !mpiio) {
       ierr = PetscObjectSetName((PetscObject)aij->A,((PetscObject)mat)->name);CHKERRQ(ierr);
       ierr = MatView(aij->A,viewer);CHKERRQ(ierr);
     } else {
@@ -2925,6 +2856,107 @@ PetscErrorCode MatLoad_MPIAIJ(Mat newMat, PetscViewer viewer)
   PetscFunctionReturn(0);
 }
 
+/*
+   Creates the loaded matrix from the local rows ii,jj,aa that each process has read from the file
+*/
+static PetscErrorCode MatLoad_MPIAIJ_Binary_CSR(Mat newMat,PetscInt M,PetscInt N,PetscInt m,PetscInt bs,const PetscInt ii[],const PetscInt jj[],const PetscScalar aa[])
+{
+  PetscMPIInt    rank,size;
+  PetscInt       n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)newMat),&size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)newMat),&rank);CHKERRQ(ierr);
+  /* determine column ownership if matrix is not square */
+  if (N != M) {
+    if (newMat->cmap->n < 0) n = N/size + ((N % size) > rank);
+    else n = newMat->cmap->n;
+  } else n = m;
+  ierr = MatSetSizes(newMat,m,n,M,N);CHKERRQ(ierr);
+  if (bs > 1) {ierr = MatSetBlockSize(newMat,bs);CHKERRQ(ierr);}
+  ierr = MatMPIAIJSetPreallocationCSR(newMat,ii,jj,aa);CHKERRQ(ierr);
+  /* a loaded matrix may get new nonzeros, as with the default path */
+  ierr = MatSetOption(newMat,MAT_NEW_NONZERO_LOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Each process reads the row lengths, column indices and values of its own rows from the file with collective
+   MPI-IO reads, at offsets given by a prefix sum of the local row lengths
+*/
+static PetscErrorCode MatLoad_MPIAIJ_Binary_MPIIO(Mat newMat,PetscViewer viewer,PetscInt M,PetscInt N,PetscInt nztotal,PetscInt m,PetscInt rstart,PetscInt bs)
+{
+  MPI_Comm       comm;
+  PetscInt       i,nz,sum,*ii,*jj;
+  PetscScalar    *aa;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)viewer,&comm);CHKERRQ(ierr);
+  ierr = PetscMalloc1(m+1,&ii);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryReadAll(viewer,ii+1,m,rstart,M,PETSC_INT);CHKERRQ(ierr);
+  ii[0] = 0;
+  for (i=0; i<m; i++) ii[i+1] += ii[i];
+  nz   = ii[m];
+  ierr = MPIU_Allreduce(&nz,&sum,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+  if (sum != nztotal) SETERRQ2(comm,PETSC_ERR_FILE_READ,"Inconsistent matrix data in file. no-nonzeros = %D, sum-row-lengths = %D",nztotal,sum);
+
+  ierr = PetscMalloc2(nz,&jj,nz,&aa);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryReadAll(viewer,jj,nz,PETSC_DETERMINE,nztotal,PETSC_INT);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryReadAll(viewer,aa,nz,PETSC_DETERMINE,nztotal,PETSC_SCALAR);CHKERRQ(ierr);
+  ierr = MatLoad_MPIAIJ_Binary_CSR(newMat,M,N,m,bs,ii,jj,aa);CHKERRQ(ierr);
+  ierr = PetscFree2(jj,aa);CHKERRQ(ierr);
+  ierr = PetscFree(ii);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#if defined(PETSC_HAVE_MMAP)
+/*
+   Each process maps the row lengths, column indices and values of its own rows from the file, instead of the first
+   process reading the whole matrix and sending each process its part
+*/
+static PetscErrorCode MatLoad_MPIAIJ_Binary_MMap(Mat newMat,PetscViewer viewer,PetscInt M,PetscInt N,PetscInt nztotal,PetscInt m,PetscInt rstart,PetscInt bs)
+{
+  MPI_Comm       comm;
+  PetscInt       i,nz,nzstart,sum,*ii,*rowlengths,*jj;
+  PetscScalar    *aa;
+  void           *map,*jmap,*amap;
+  size_t         maplen,jmaplen,amaplen;
+  off_t          off;
+  int            fd;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)viewer,&comm);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryGetDescriptor(viewer,&fd);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryGetMMapOffset(viewer,&off);CHKERRQ(ierr);
+
+  ierr = PetscMalloc1(m+1,&ii);CHKERRQ(ierr);
+  ierr = PetscBinaryMap(fd,off+rstart*sizeof(PetscInt),m,PETSC_INT,PETSC_TRUE,(void**)&rowlengths,&map,&maplen);CHKERRQ(ierr);
+  ii[0] = 0;
+  for (i=0; i<m; i++) ii[i+1] = ii[i] + rowlengths[i];
+  ierr = PetscBinaryUnmap(map,maplen);CHKERRQ(ierr);
+  nz   = ii[m];
+  ierr = MPIU_Allreduce(&nz,&sum,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+  if (sum != nztotal) SETERRQ2(comm,PETSC_ERR_FILE_READ,"Inconsistent matrix data in file. no-nonzeros = %D, sum-row-lengths = %D",nztotal,sum);
+  ierr = MPI_Scan(&nz,&nzstart,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+  nzstart -= nz;
+
+  off += M*sizeof(PetscInt);
+  ierr = PetscBinaryMap(fd,off+nzstart*sizeof(PetscInt),nz,PETSC_INT,PETSC_TRUE,(void**)&jj,&jmap,&jmaplen);CHKERRQ(ierr);
+  off += nztotal*sizeof(PetscInt);
+  ierr = PetscBinaryMap(fd,off+nzstart*sizeof(PetscScalar),nz,PETSC_SCALAR,PETSC_TRUE,(void**)&aa,&amap,&amaplen);CHKERRQ(ierr);
+
+  ierr = MatLoad_MPIAIJ_Binary_CSR(newMat,M,N,m,bs,ii,jj,aa);CHKERRQ(ierr);
+  ierr = PetscBinaryUnmap(jmap,jmaplen);CHKERRQ(ierr);
+  ierr = PetscBinaryUnmap(amap,amaplen);CHKERRQ(ierr);
+  ierr = PetscFree(ii);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryAddMMapOffset(viewer,M*sizeof(PetscInt)+nztotal*(sizeof(PetscInt)+sizeof(PetscScalar)));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
+
 PetscErrorCode MatLoad_MPIAIJ_Binary(Mat newMat, PetscViewer viewer)
 {
   PetscScalar    *vals,*svals;
@@ -2937,25 +2969,26 @@ PetscErrorCode MatLoad_MPIAIJ_Binary(Mat newMat, PetscViewer viewer)
   PetscInt       cend,cstart,n,*rowners;
   int            fd;
   PetscInt       bs = newMat->rmap->bs;
+  PetscBool      usempiio;
+#if defined(PETSC_HAVE_MMAP)
+  PetscBool      usemmap;
+#endif
 
   PetscFunctionBegin;
   ierr = PetscObjectGetComm((PetscObject)viewer,&comm);CHKERRQ(ierr);
   ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
   ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
   ierr = PetscViewerBinaryGetDescriptor(viewer,&fd);CHKERRQ(ierr);
-  if (!rank) {
-    ierr = PetscBinaryRead(fd,(char*)header,4,NULL,PETSC_INT);CHKERRQ(ierr);
-    if (header[0] != MAT_FILE_CLASSID) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"not matrix object");
-    if (header[3] < 0) SETERRQ(PetscObjectComm((PetscObject)newMat),PETSC_ERR_FILE_UNEXPECTED,"Matrix stored in special format on disk,cannot load as MATMPIAIJ");
-  }
+  ierr = PetscViewerBinaryRead(viewer,header,4,NULL,PETSC_INT);CHKERRQ(ierr);
+  if (header[0] != MAT_FILE_CLASSID) SETERRQ(comm,PETSC_ERR_FILE_UNEXPECTED,"not matrix object");
+  if (header[3] < 0) SETERRQ(comm,PETSC_ERR_FILE_UNEXPECTED,"Matrix stored in special format on disk,cannot load as MATMPIAIJ");
 
   ierr = PetscOptionsBegin(comm,NULL,"Options for loading MATMPIAIJ matrix","Mat");CHKERRQ(ierr);
   ierr = PetscOptionsInt("-matload_block_size","Set the blocksize used to store the matrix","MatLoad",bs,&bs,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsEnd();CHKERRQ(ierr);
   if (bs < 0) bs = 1;
 
-  ierr = MPI_Bcast(header+1,3,MPIU_INT,0,comm);CHKERRQ(ierr);
-  M    = header[1]; N = header[2];
+  M = header[1]; N = header[2];
 
   /* If global sizes are set, check if they are consistent with that given in the file */
   if (newMat->rmap->N >= 0 && newMat->rmap->N != M) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"Inconsistent # of rows:Matrix in file has (%D) and input matrix has (%D)",newMat->rmap->N,M);
@@ -2984,6 +3017,21 @@ PetscErrorCode MatLoad_MPIAIJ_Binary(Mat newMat, PetscViewer viewer)
   rstart = rowners[rank];
   rend   = rowners[rank+1];
 
+  ierr = PetscViewerBinaryGetUseMPIIO(viewer,&usempiio);CHKERRQ(ierr);
+  if (usempiio) {
+    ierr = PetscFree(rowners);CHKERRQ(ierr);
+    ierr = MatLoad_MPIAIJ_Binary_MPIIO(newMat,viewer,M,N,header[3],m,rstart,bs);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#if defined(PETSC_HAVE_MMAP)
+  ierr = PetscViewerBinaryGetUseMMap(viewer,&usemmap);CHKERRQ(ierr);
+  if (usemmap) {
+    ierr = PetscFree(rowners);CHKERRQ(ierr);
+    ierr = MatLoad_MPIAIJ_Binary_MMap(newMat,viewer,M,N,header[3],m,rstart,bs);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#endif
+
   /* distribute row lengths to all processors */
   ierr = PetscMalloc2(m,&ourlens,m,&offlens);CHKERRQ(ierr);
   if (!rank) {
@@ -5531,6 +5579,7 @@ PetscErrorCode MatGetCommunicationStructs(Mat A, Vec *lvec, PetscInt *colmap[],
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJCRL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJPERM(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJSELL(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJSingle(Mat,MatType,MatReuse,Mat*);
 #if defined(PETSC_HAVE_MKL_SPARSE)
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJMKL(Mat,MatType,MatReuse,Mat*);
 #endif
@@ -5669,6 +5718,7 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatDiagonalScaleLocal_C",MatDiagonalScaleLocal_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijperm_C",MatConvert_MPIAIJ_MPIAIJPERM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijsell_C",MatConvert_MPIAIJ_MPIAIJSELL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijsingle_C",MatConvert_MPIAIJ_MPIAIJSingle);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijmkl_C",MatConvert_MPIAIJ_MPIAIJMKL);CHKERRQ(ierr);
 #endif
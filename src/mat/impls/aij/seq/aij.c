@@ -10,14 +10,18 @@
 #include <petscbt.h>
 #include <petsc/private/kernels/blocktranspose.h>
 
+const char *const MatSeqAIJMultTransposeTypes[] = {"serial","csc","buffers","MatSeqAIJMultTransposeType","MAT_SEQAIJ_MULTTRANSPOSE_",0};
+
 PetscErrorCode MatSeqAIJSetTypeFromOptions(Mat A)
 {
   PetscErrorCode       ierr;
   PetscBool            flg;
   char                 type[256];
+  Mat_SeqAIJ           *a = (Mat_SeqAIJ*)A->data;
 
   PetscFunctionBegin;
   ierr = PetscObjectOptionsBegin((PetscObject)A);
+  ierr = PetscOptionsEnum("-mat_seqaij_multtranspose","How threads are used by MatMultTranspose()","None",MatSeqAIJMultTransposeTypes,(PetscEnum)a->multtranspose.type,(PetscEnum*)&a->multtranspose.type,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsFList("-mat_seqaij_type","Matrix SeqAIJ type","MatSeqAIJSetType",MatSeqAIJList,"seqaij",type,256,&flg);CHKERRQ(ierr);
   if (flg) {
     ierr = MatSeqAIJSetType(A,type);CHKERRQ(ierr);
@@ -1105,6 +1109,12 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   ierr = ISColoringDestroy(&a->coloring);CHKERRQ(ierr);
   ierr = PetscFree2(a->compressedrow.i,a->compressedrow.rindex);CHKERRQ(ierr);
   ierr = PetscFree(a->matmult_abdense);CHKERRQ(ierr);
+  if (a->multtranspose.ci) {
+    PetscInt n;
+    ierr = MatRestoreColumnIJ_SeqAIJ_Color(A,0,PETSC_FALSE,PETSC_FALSE,&n,(const PetscInt**)&a->multtranspose.ci,(const PetscInt**)&a->multtranspose.cj,&a->multtranspose.cperm,NULL);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(a->multtranspose.work);CHKERRQ(ierr);
+  ierr = MatSolveLevelsReset_Private(&a->solvelevels);CHKERRQ(ierr);
 
   ierr = MatDestroy_SeqAIJ_Inode(A);CHKERRQ(ierr);
   ierr = PetscFree(A->data);CHKERRQ(ierr);
@@ -1225,6 +1235,77 @@ PetscErrorCode MatGetDiagonal_SeqAIJ(Mat A,Vec v)
 }
 
 #include <../src/mat/impls/aij/seq/ftn-kernels/fmult.h>
+#if defined(PETSC_HAVE_OPENMP)
+/*
+   Threaded y += A^T x, see MatSeqAIJMultTransposeType. Neither variant needs atomics: with csc every entry of y is
+   computed by a single thread, with buffers every thread but the first accumulates into its own copy of y.
+*/
+static PetscErrorCode MatMultTransposeAdd_SeqAIJ_Threaded(Mat A,const PetscScalar *x,PetscScalar *y)
+{
+  Mat_SeqAIJ               *a  = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_MultTranspose *mt = &a->multtranspose;
+  const MatScalar          *aa = a->a;
+  PetscInt                 c,n = A->cmap->n;
+  PetscErrorCode           ierr;
+
+  PetscFunctionBegin;
+  if (mt->type == MAT_SEQAIJ_MULTTRANSPOSE_CSC) {
+    const PetscInt *ci,*cj,*cperm;
+
+    if (mt->ci && mt->cnonzerostate != A->nonzerostate) {
+      ierr = MatRestoreColumnIJ_SeqAIJ_Color(A,0,PETSC_FALSE,PETSC_FALSE,&n,(const PetscInt**)&mt->ci,(const PetscInt**)&mt->cj,&mt->cperm,NULL);CHKERRQ(ierr);
+    }
+    if (!mt->ci) {
+      ierr = MatGetColumnIJ_SeqAIJ_Color(A,0,PETSC_FALSE,PETSC_FALSE,&n,(const PetscInt**)&mt->ci,(const PetscInt**)&mt->cj,&mt->cperm,NULL);CHKERRQ(ierr);
+      mt->cnonzerostate = A->nonzerostate;
+    }
+    ci = mt->ci; cj = mt->cj; cperm = mt->cperm;
+    PetscPragmaOMP(parallel for schedule(static))
+    for (c=0; c<n; c++) {
+      PetscInt    k;
+      PetscScalar sum = 0.0;
+      for (k=ci[c]; k<ci[c+1]; k++) sum += aa[cperm[k]]*x[cj[k]];
+      y[c] += sum;
+    }
+  } else {
+    Mat_CompressedRow cprow = a->compressedrow;
+    const PetscInt    *ii   = cprow.use ? cprow.i : a->i,*ridx = cprow.use ? cprow.rindex : NULL;
+    PetscInt          m     = cprow.use ? cprow.nrows : A->rmap->n;
+    int               nt    = omp_get_max_threads();
+    PetscScalar       *work;
+
+    if (mt->nwork < (nt-1)*n) {
+      ierr      = PetscFree(mt->work);CHKERRQ(ierr);
+      mt->nwork = (nt-1)*n;
+      ierr      = PetscMalloc1(mt->nwork,&mt->work);CHKERRQ(ierr);
+    }
+    work = mt->work;
+    PetscPragmaOMP(parallel num_threads(nt))
+    {
+      int         t = omp_get_thread_num(),nth = omp_get_num_threads();
+      PetscScalar *w = t ? work + (t-1)*n : y;
+      PetscInt    i,j;
+
+      if (t) {for (j=0; j<n; j++) w[j] = 0.0;}
+      PetscPragmaOMP(for schedule(static))
+      for (i=0; i<m; i++) {
+        const PetscInt  *idx  = a->j + ii[i];
+        const MatScalar *v    = aa + ii[i];
+        PetscInt        nrow  = ii[i+1] - ii[i];
+        PetscScalar     alpha = x[ridx ? ridx[i] : i];
+        for (j=0; j<nrow; j++) w[idx[j]] += alpha*v[j];
+      }
+      PetscPragmaOMP(for schedule(static))
+      for (j=0; j<n; j++) {
+        int s;
+        for (s=1; s<nth; s++) y[j] += work[(s-1)*n+j];
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+#endif
+
 PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat A,Vec xx,Vec zz,Vec yy)
 {
   Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
@@ -1246,6 +1327,15 @@ PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat A,Vec xx,Vec zz,Vec yy)
   ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
 
+#if defined(PETSC_HAVE_OPENMP)
+  if (a->multtranspose.type != MAT_SEQAIJ_MULTTRANSPOSE_SERIAL && PetscOMPUseThreads(a->nz)) {
+    ierr = MatMultTransposeAdd_SeqAIJ_Threaded(A,x,y);CHKERRQ(ierr);
+    ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+    ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#endif
 #if defined(PETSC_USE_FORTRAN_KERNEL_MULTTRANSPOSEAIJ)
   fortranmulttransposeaddaij_(&m,x,a->i,a->j,a->a,y);
 #else
@@ -1291,16 +1381,14 @@ PetscErrorCode MatMult_SeqAIJ(Mat A,Vec xx,Vec yy)
   Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
   PetscScalar       *y;
   const PetscScalar *x;
-  const MatScalar   *aa;
   PetscErrorCode    ierr;
   PetscInt          m=A->rmap->n;
-  const PetscInt    *aj,*ii,*ridx=NULL;
-  PetscInt          n,i;
-  PetscScalar       sum;
+  const PetscInt    *ii,*ridx=NULL;
+  PetscInt          i;
   PetscBool         usecprow=a->compressedrow.use;
 
 #if defined(PETSC_HAVE_PRAGMA_DISJOINT)
-#pragma disjoint(*x,*y,*aa)
+#pragma disjoint(*x,*y)
 #endif
 
   PetscFunctionBegin;
@@ -1312,26 +1400,26 @@ PetscErrorCode MatMult_SeqAIJ(Mat A,Vec xx,Vec yy)
     m    = a->compressedrow.nrows;
     ii   = a->compressedrow.i;
     ridx = a->compressedrow.rindex;
+    PetscPragmaOMP(parallel for schedule(static) if(PetscOMPUseThreads(a->nz)))
     for (i=0; i<m; i++) {
-      n           = ii[i+1] - ii[i];
-      aj          = a->j + ii[i];
-      aa          = a->a + ii[i];
-      sum         = 0.0;
+      PetscInt        n   = ii[i+1] - ii[i];
+      const PetscInt  *aj = a->j + ii[i];
+      const MatScalar *aa = a->a + ii[i];
+      PetscScalar     sum = 0.0;
       PetscSparseDensePlusDot(sum,x,aa,aj,n);
       /* for (j=0; j<n; j++) sum += (*aa++)*x[*aj++]; */
-      y[*ridx++] = sum;
+      y[ridx[i]] = sum;
     }
   } else { /* do not use compressed row format */
 #if defined(PETSC_USE_FORTRAN_KERNEL_MULTAIJ)
-    aj   = a->j;
-    aa   = a->a;
-    fortranmultaij_(&m,x,ii,aj,aa,y);
+    fortranmultaij_(&m,x,ii,a->j,a->a,y);
 #else
+    PetscPragmaOMP(parallel for schedule(static) if(PetscOMPUseThreads(a->nz)))
     for (i=0; i<m; i++) {
-      n           = ii[i+1] - ii[i];
-      aj          = a->j + ii[i];
-      aa          = a->a + ii[i];
-      sum         = 0.0;
+      PetscInt        n   = ii[i+1] - ii[i];
+      const PetscInt  *aj = a->j + ii[i];
+      const MatScalar *aa = a->a + ii[i];
+      PetscScalar     sum = 0.0;
       PetscSparseDensePlusDot(sum,x,aa,aj,n);
       y[i] = sum;
     }
@@ -1448,11 +1536,9 @@ PetscErrorCode MatMultAdd_SeqAIJ(Mat A,Vec xx,Vec yy,Vec zz)
   Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
   PetscScalar       *y,*z;
   const PetscScalar *x;
-  const MatScalar   *aa;
   PetscErrorCode    ierr;
-  const PetscInt    *aj,*ii,*ridx=NULL;
-  PetscInt          m = A->rmap->n,n,i;
-  PetscScalar       sum;
+  const PetscInt    *ii,*ridx=NULL;
+  PetscInt          m = A->rmap->n,i;
   PetscBool         usecprow=a->compressedrow.use;
 
   PetscFunctionBegin;
@@ -1465,26 +1551,26 @@ PetscErrorCode MatMultAdd_SeqAIJ(Mat A,Vec xx,Vec yy,Vec zz)
     m    = a->compressedrow.nrows;
     ii   = a->compressedrow.i;
     ridx = a->compressedrow.rindex;
+    PetscPragmaOMP(parallel for schedule(static) if(PetscOMPUseThreads(a->nz)))
     for (i=0; i<m; i++) {
-      n   = ii[i+1] - ii[i];
-      aj  = a->j + ii[i];
-      aa  = a->a + ii[i];
-      sum = y[*ridx];
+      PetscInt        n   = ii[i+1] - ii[i];
+      const PetscInt  *aj = a->j + ii[i];
+      const MatScalar *aa = a->a + ii[i];
+      PetscScalar     sum = y[ridx[i]];
       PetscSparseDensePlusDot(sum,x,aa,aj,n);
-      z[*ridx++] = sum;
+      z[ridx[i]] = sum;
     }
   } else { /* do not use compressed row format */
     ii = a->i;
 #if defined(PETSC_USE_FORTRAN_KERNEL_MULTADDAIJ)
-    aj = a->j;
-    aa = a->a;
-    fortranmultaddaij_(&m,x,ii,aj,aa,y,z);
+    fortranmultaddaij_(&m,x,ii,a->j,a->a,y,z);
 #else
+    PetscPragmaOMP(parallel for schedule(static) if(PetscOMPUseThreads(a->nz)))
     for (i=0; i<m; i++) {
-      n   = ii[i+1] - ii[i];
-      aj  = a->j + ii[i];
-      aa  = a->a + ii[i];
-      sum = y[i];
+      PetscInt        n   = ii[i+1] - ii[i];
+      const PetscInt  *aj = a->j + ii[i];
+      const MatScalar *aa = a->a + ii[i];
+      PetscScalar     sum = y[i];
       PetscSparseDensePlusDot(sum,x,aa,aj,n);
       z[i] = sum;
     }
@@ -3685,7 +3771,8 @@ PetscErrorCode  MatRetrieveValues(Mat mat)
 
    Options Database Keys:
 +  -mat_no_inode  - Do not use inodes
--  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+.  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+-  -mat_inode_simd <true,false> - Use the vectorized inode kernels when PETSc is compiled for AVX2 or AVX-512 (default true)
 
    Level: intermediate
 
@@ -3746,7 +3833,8 @@ PetscErrorCode  MatCreateSeqAIJ(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,
 
    Options Database Keys:
 +  -mat_no_inode  - Do not use inodes
--  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+.  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+-  -mat_inode_simd <true,false> - Use the vectorized inode kernels when PETSc is compiled for AVX2 or AVX-512 (default true)
 
    Level: intermediate
 
@@ -3830,6 +3918,17 @@ PetscErrorCode  MatSeqAIJSetPreallocation_SeqAIJ(Mat B,PetscInt nz,const PetscIn
     for (i=1; i<B->rmap->n+1; i++) {
       b->i[i] = b->i[i-1] + b->imax[i-1];
     }
+    if (PetscOMPUseThreads(nz) && !B->structure_only) {
+      PetscInt  *bi = b->i,*bj = b->j;
+      MatScalar *ba = b->a;
+
+      /* first touch the rows with the partition of the threaded MatMult_SeqAIJ(), so they are placed near the thread using them */
+      PetscPragmaOMP(parallel for schedule(static))
+      for (i=0; i<B->rmap->n; i++) {
+        PetscInt k;
+        for (k=bi[i]; k<bi[i+1]; k++) {bj[k] = 0; ba[k] = 0.0;}
+      }
+    }
     if (B->structure_only) {
       b->singlemalloc = PETSC_FALSE;
       b->free_a       = PETSC_FALSE;
@@ -4055,7 +4154,10 @@ PETSC_INTERN PetscErrorCode MatMatMult_SeqDense_SeqAIJ(Mat A,Mat B,MatReuse scal
    based on compressed sparse row format.
 
    Options Database Keys:
-. -mat_type seqaij - sets the matrix type to "seqaij" during a call to MatSetFromOptions()
++ -mat_type seqaij - sets the matrix type to "seqaij" during a call to MatSetFromOptions()
+- -mat_seqaij_multtranspose <serial,csc,buffers> - with OpenMP, compute MatMultTranspose() serially, with threads over the columns
+                                                 of a cached compressed column copy of the nonzero structure, or with threads over
+                                                 the rows accumulating into private copies of the result
 
   Level: beginner
 
@@ -4240,6 +4342,7 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqbaij_C",MatConvert_SeqAIJ_SeqBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijperm_C",MatConvert_SeqAIJ_SeqAIJPERM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijsell_C",MatConvert_SeqAIJ_SeqAIJSELL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijsingle_C",MatConvert_SeqAIJ_SeqAIJSingle);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijmkl_C",MatConvert_SeqAIJ_SeqAIJMKL);CHKERRQ(ierr);
 #endif
@@ -4291,6 +4394,8 @@ PetscErrorCode MatDuplicateNoCreate_SeqAIJ(Mat C,Mat A,MatDuplicateOption cpvalu
   c->icol       = 0;
   c->reallocs   = 0;
 
+  c->multtranspose.type = a->multtranspose.type;
+
   C->assembled = PETSC_TRUE;
 
   ierr = PetscLayoutReference(A->rmap,&C->rmap);CHKERRQ(ierr);
@@ -4406,6 +4511,87 @@ PetscErrorCode MatLoad_SeqAIJ(Mat newMat, PetscViewer viewer)
   PetscFunctionReturn(0);
 }
 
+#if defined(PETSC_HAVE_MMAP)
+typedef struct {
+  PetscInt *i;                      /* row offsets, computed from the row lengths in the file */
+  void     *jmap,*amap;             /* the mappings holding the column indices and values */
+  size_t   jmaplen,amaplen;
+} Mat_SeqAIJ_MMap;
+
+static PetscErrorCode MatSeqAIJMMapDestroy_Private(void *ptr)
+{
+  Mat_SeqAIJ_MMap *mm = (Mat_SeqAIJ_MMap*)ptr;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscBinaryUnmap(mm->jmap,mm->jmaplen);CHKERRQ(ierr);
+  ierr = PetscBinaryUnmap(mm->amap,mm->amaplen);CHKERRQ(ierr);
+  ierr = PetscFree(mm->i);CHKERRQ(ierr);
+  ierr = PetscFree(mm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Uses the column indices and values mapped from the file (converted in place to native byte order, in private pages)
+   as the storage of the matrix; the mappings live in a container composed with the matrix so that they are released
+   when it is destroyed, even if new nonzeros later move the matrix to freshly allocated arrays.
+*/
+static PetscErrorCode MatLoad_SeqAIJ_Binary_MMap(Mat newMat,PetscViewer viewer,PetscInt M,PetscInt nz)
+{
+  Mat_SeqAIJ      *a;
+  Mat_SeqAIJ_MMap *mm;
+  PetscContainer  container;
+  PetscInt        i,*rowlengths,*aj;
+  PetscScalar     *aa;
+  void            *map;
+  size_t          maplen;
+  off_t           off;
+  int             fd;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscViewerBinaryGetDescriptor(viewer,&fd);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryGetMMapOffset(viewer,&off);CHKERRQ(ierr);
+  ierr = PetscNew(&mm);CHKERRQ(ierr);
+  ierr = PetscMalloc1(M+1,&mm->i);CHKERRQ(ierr);
+  ierr = PetscBinaryMap(fd,off,M,PETSC_INT,PETSC_TRUE,(void**)&rowlengths,&map,&maplen);CHKERRQ(ierr);
+  mm->i[0] = 0;
+  for (i=0; i<M; i++) mm->i[i+1] = mm->i[i] + rowlengths[i];
+  ierr = PetscBinaryUnmap(map,maplen);CHKERRQ(ierr);
+  if (mm->i[M] != nz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_READ,"Inconsistant matrix data in file. no-nonzeros = %D, sum-row-lengths = %D\n",nz,mm->i[M]);
+  off += M*sizeof(PetscInt);
+  ierr = PetscBinaryMap(fd,off,nz,PETSC_INT,PETSC_TRUE,(void**)&aj,&mm->jmap,&mm->jmaplen);CHKERRQ(ierr);
+  off += nz*sizeof(PetscInt);
+  ierr = PetscBinaryMap(fd,off,nz,PETSC_SCALAR,PETSC_TRUE,(void**)&aa,&mm->amap,&mm->amaplen);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryAddMMapOffset(viewer,M*sizeof(PetscInt)+nz*(sizeof(PetscInt)+sizeof(PetscScalar)));CHKERRQ(ierr);
+
+  /* the matrix may already have storage from an earlier preallocation, which MAT_SKIP_ALLOCATION leaves alone */
+  a    = (Mat_SeqAIJ*)newMat->data;
+  ierr = MatSeqXAIJFreeAIJ(newMat,&a->a,&a->j,&a->i);CHKERRQ(ierr);
+  ierr = PetscFree2(a->imax,a->ilen);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(newMat,MAT_SKIP_ALLOCATION,0);CHKERRQ(ierr);
+  ierr = PetscMalloc2(M,&a->imax,M,&a->ilen);CHKERRQ(ierr);
+  for (i=0; i<M; i++) a->ilen[i] = a->imax[i] = mm->i[i+1] - mm->i[i];
+  a->i            = mm->i;
+  a->j            = aj;
+  a->a            = aa;
+  a->maxnz        = nz;
+  a->singlemalloc = PETSC_FALSE;
+  a->free_a       = PETSC_FALSE;
+  a->free_ij      = PETSC_FALSE;
+
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container,mm);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container,MatSeqAIJMMapDestroy_Private);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject)newMat,"MatLoad_SeqAIJ_MMap",(PetscObject)container);CHKERRQ(ierr);
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+
+  ierr = MatAssemblyBegin(newMat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(newMat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
+
 PetscErrorCode MatLoad_SeqAIJ_Binary(Mat newMat, PetscViewer viewer)
 {
   Mat_SeqAIJ     *a;
@@ -4415,6 +4601,9 @@ PetscErrorCode MatLoad_SeqAIJ_Binary(Mat newMat, PetscViewer viewer)
   PetscMPIInt    size;
   MPI_Comm       comm;
   PetscInt       bs = newMat->rmap->bs;
+#if defined(PETSC_HAVE_MMAP)
+  PetscBool      usemmap;
+#endif
 
   PetscFunctionBegin;
   ierr = PetscObjectGetComm((PetscObject)viewer,&comm);CHKERRQ(ierr);
@@ -4434,14 +4623,6 @@ PetscErrorCode MatLoad_SeqAIJ_Binary(Mat newMat, PetscViewer viewer)
 
   if (nz < 0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"Matrix stored in special format on disk,cannot load as SeqAIJ");
 
-  /* read in row lengths */
-  ierr = PetscMalloc1(M,&rowlengths);CHKERRQ(ierr);
-  ierr = PetscBinaryRead(fd,rowlengths,M,NULL,PETSC_INT);CHKERRQ(ierr);
-
-  /* check if sum of rowlengths is same as nz */
-  for (i=0,sum=0; i< M; i++) sum +=rowlengths[i];
-  if (sum != nz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_READ,"Inconsistant matrix data in file. no-nonzeros = %dD, sum-row-lengths = %D\n",nz,sum);
-
   /* set global size if not set already*/
   if (newMat->rmap->n < 0 && newMat->rmap->N < 0 && newMat->cmap->n < 0 && newMat->cmap->N < 0) {
     ierr = MatSetSizes(newMat,PETSC_DECIDE,PETSC_DECIDE,M,N);CHKERRQ(ierr);
@@ -4453,6 +4634,23 @@ PetscErrorCode MatLoad_SeqAIJ_Binary(Mat newMat, PetscViewer viewer)
     }
     if (M != rows ||  N != cols) SETERRQ4(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED, "Matrix in file of different length (%D, %D) than the input matrix (%D, %D)",M,N,rows,cols);
   }
+
+#if defined(PETSC_HAVE_MMAP)
+  ierr = PetscViewerBinaryGetUseMMap(viewer,&usemmap);CHKERRQ(ierr);
+  if (usemmap && M && nz) {
+    ierr = MatLoad_SeqAIJ_Binary_MMap(newMat,viewer,M,nz);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#endif
+
+  /* read in row lengths */
+  ierr = PetscMalloc1(M,&rowlengths);CHKERRQ(ierr);
+  ierr = PetscBinaryRead(fd,rowlengths,M,NULL,PETSC_INT);CHKERRQ(ierr);
+
+  /* check if sum of rowlengths is same as nz */
+  for (i=0,sum=0; i< M; i++) sum +=rowlengths[i];
+  if (sum != nz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_READ,"Inconsistant matrix data in file. no-nonzeros = %dD, sum-row-lengths = %D\n",nz,sum);
+
   ierr = MatSeqAIJSetPreallocation_SeqAIJ(newMat,0,rowlengths);CHKERRQ(ierr);
   a    = (Mat_SeqAIJ*)newMat->data;
 
@@ -4880,6 +5078,7 @@ PetscErrorCode  MatSeqAIJRegisterAll(void)
   ierr = MatSeqAIJRegister(MATSEQAIJCRL,      MatConvert_SeqAIJ_SeqAIJCRL);CHKERRQ(ierr);
   ierr = MatSeqAIJRegister(MATSEQAIJPERM,     MatConvert_SeqAIJ_SeqAIJPERM);CHKERRQ(ierr);
   ierr = MatSeqAIJRegister(MATSEQAIJSELL,     MatConvert_SeqAIJ_SeqAIJSELL);CHKERRQ(ierr);
+  ierr = MatSeqAIJRegister(MATSEQAIJSINGLE,   MatConvert_SeqAIJ_SeqAIJSingle);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = MatSeqAIJRegister(MATSEQAIJMKL,      MatConvert_SeqAIJ_SeqAIJMKL);CHKERRQ(ierr);
 #endif
@@ -82,6 +82,11 @@ typedef struct {
   matrix elements are stored with the rest of the nonzeros (not separately).
 */
 
+/* the vectorized inode kernels in inode.c are compiled in for AVX2 or AVX-512 with real double precision and 32-bit indices */
+#if defined(PETSC_HAVE_IMMINTRIN_H) && (defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__))) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+#define MATINODE_USE_SIMD
+#endif
+
 /* Info about i-nodes (identical nodes) helper class for SeqAIJ */
 typedef struct {
   MatScalar        *bdiag,*ibdiag,*ssor_work;        /* diagonal blocks of matrix used for MatSOR_SeqAIJ_Inode() */
@@ -93,6 +98,7 @@ typedef struct {
   PetscInt         *size;                          /* size of each inode */
   PetscInt         limit;                          /* inode limit */
   PetscInt         max_limit;                      /* maximum supported inode limit */
+  PetscBool        simd;                           /* use the AVX2/AVX-512 MatMult(), MatMultAdd() and MatSOR(), always false unless compiled in */
   PetscBool        checked;                        /* if inodes have been checked for */
   PetscObjectState mat_nonzerostate;               /* non-zero state when inodes were checked for */
 } Mat_SeqAIJ_Inode;
@@ -107,9 +113,50 @@ PETSC_INTERN PetscErrorCode MatDuplicateNoCreate_SeqAIJ(Mat,Mat,MatDuplicateOpti
 PETSC_INTERN PetscErrorCode MatLUFactorNumeric_SeqAIJ_Inode_inplace(Mat,Mat,const MatFactorInfo*);
 PETSC_INTERN PetscErrorCode MatLUFactorNumeric_SeqAIJ_Inode(Mat,Mat,const MatFactorInfo*);
 
+/*
+   How MatMultTranspose_SeqAIJ() and MatMultTransposeAdd_SeqAIJ() use threads, selected with -mat_seqaij_multtranspose
+     serial  - the sequential kernel that scatters each row into y
+     csc     - threads over the columns of a compressed sparse column copy of the nonzero structure, cached on the matrix
+     buffers - threads over the rows, each thread scatters into a private copy of y and the copies are summed at the end
+*/
+typedef enum {MAT_SEQAIJ_MULTTRANSPOSE_SERIAL,MAT_SEQAIJ_MULTTRANSPOSE_CSC,MAT_SEQAIJ_MULTTRANSPOSE_BUFFERS} MatSeqAIJMultTransposeType;
+PETSC_INTERN const char *const MatSeqAIJMultTransposeTypes[];
+
+typedef struct {
+  MatSeqAIJMultTransposeType type;
+  PetscInt                   *ci,*cj,*cperm;     /* column c has the rows cj[ci[c]..ci[c+1]) with the values a[cperm[ci[c]..ci[c+1])] */
+  PetscObjectState           cnonzerostate;      /* nonzero state of the matrix the CSC structure was built for */
+  PetscScalar                *work;              /* private copies of y for all threads but the first */
+  PetscInt                   nwork;              /* length of work */
+} Mat_SeqAIJ_MultTranspose;
+
+/*
+   Level sets (wavefronts) of the triangular solves with a factor, built after each numeric factorization when the
+   factor was obtained with -mat_factor_solve_levels. A row of a level only depends on rows of earlier levels, so the
+   rows of a level are solved concurrently, one parallel loop per level. Rows are in increasing order within a level,
+   they are not reordered for locality. The LU solves compute each row as MatSolve_SeqAIJ() does. The sequential forward
+   solve of the Cholesky factors scatters with the rows of U, the threads cannot, so they gather with the rows of the
+   row oriented copy ti,tj of U^T; this sums in another order and agrees with the sequential solve only up to rounding.
+   The entries of row k of U^T are at a[tperm[ti[k]..ti[k+1])].
+*/
+typedef struct {
+  PetscBool      use;                       /* build the level sets and solve with them */
+  PetscInt       nfwd,nbwd;                 /* number of levels of the forward and backward solves */
+  PetscInt       *fwdptr,*fwdrows;          /* level l of the forward solve has the rows fwdrows[fwdptr[l]..fwdptr[l+1]) */
+  PetscInt       *bwdptr,*bwdrows;          /* the same for the backward solve */
+  PetscInt       *ti,*tj,*tperm;            /* transpose of the Cholesky factor */
+  PetscErrorCode (*solve)(Mat,Vec,Vec);     /* the sequential MatSolve(), used when threads do not pay off */
+} Mat_SeqAIJ_SolveLevels;
+
+PETSC_INTERN PetscErrorCode MatSolveLevelsSort_Private(PetscInt,const PetscInt*,PetscInt*,PetscInt**,PetscInt**);
+PETSC_INTERN PetscErrorCode MatSolveLevelsReset_Private(Mat_SeqAIJ_SolveLevels*);
+PETSC_INTERN PetscErrorCode MatSolveLevelsFromOptions_Private(Mat,Mat_SeqAIJ_SolveLevels*);
+
 typedef struct {
   SEQAIJHEADER(MatScalar);
   Mat_SeqAIJ_Inode inode;
+  Mat_SeqAIJ_MultTranspose multtranspose;     /* threaded MatMultTranspose() data */
+  Mat_SeqAIJ_SolveLevels   solvelevels;       /* level sets of a factor for the threaded MatSolve() */
   MatScalar        *saved_values;             /* location for stashing nonzero values of matrix */
 
   PetscScalar *idiag,*mdiag,*ssor_work;       /* inverse of diagonal entries, diagonal values and workspace for Eisenstat trick */
@@ -228,6 +275,7 @@ PETSC_INTERN PetscErrorCode MatDuplicate_SeqAIJ(Mat,MatDuplicateOption,Mat*);
 PETSC_INTERN PetscErrorCode MatCopy_SeqAIJ(Mat,Mat,MatStructure);
 PETSC_INTERN PetscErrorCode MatMissingDiagonal_SeqAIJ(Mat,PetscBool*,PetscInt*);
 PETSC_INTERN PetscErrorCode MatMarkDiagonal_SeqAIJ(Mat);
+PETSC_INTERN PetscErrorCode MatInvertDiagonal_SeqAIJ(Mat,PetscScalar,PetscScalar);
 PETSC_INTERN PetscErrorCode MatFindZeroDiagonals_SeqAIJ_Private(Mat,PetscInt*,PetscInt**);
 
 PETSC_INTERN PetscErrorCode MatMult_SeqAIJ(Mat A,Vec,Vec);
@@ -252,6 +300,8 @@ PETSC_INTERN PetscErrorCode MatLUFactorNumeric_SeqAIJ_InplaceWithPerm(Mat,Mat,co
 PETSC_INTERN PetscErrorCode MatLUFactor_SeqAIJ(Mat,IS,IS,const MatFactorInfo*);
 PETSC_INTERN PetscErrorCode MatSolve_SeqAIJ_inplace(Mat,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqAIJ(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatSolve_SeqAIJ_Levels(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatSeqAIJSetUpSolveLevels_Private(Mat);
 PETSC_INTERN PetscErrorCode MatSolve_SeqAIJ_Inode_inplace(Mat,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqAIJ_Inode(Mat,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqAIJ_NaturalOrdering_inplace(Mat,Vec,Vec);
@@ -284,6 +334,7 @@ PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Heap(Mat,Mat,PetscR
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_BTHeap(Mat,Mat,PetscReal,Mat*);
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_RowMerge(Mat,Mat,PetscReal,Mat*);
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_LLCondensed(Mat,Mat,PetscReal,Mat*);
+PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Hash(Mat,Mat,PetscReal,Mat*);
 #if defined(PETSC_HAVE_HYPRE)
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_AIJ_AIJ_wHYPRE(Mat,Mat,PetscReal,Mat*);
 #endif
@@ -293,6 +344,7 @@ PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Sorted(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqDense_SeqAIJ(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Combined(Mat,Mat,Mat);
+PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Hash(Mat,Mat,Mat);
 
 PETSC_INTERN PetscErrorCode MatPtAP_SeqAIJ_SeqAIJ(Mat,Mat,MatReuse,PetscReal,Mat*);
 PETSC_INTERN PetscErrorCode MatPtAPSymbolic_SeqAIJ_SeqAIJ_SparseAxpy(Mat,Mat,PetscReal,Mat*);
@@ -364,6 +416,7 @@ PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_Elemental(Mat,MatType,MatReuse,Mat
 PETSC_INTERN PetscErrorCode MatConvert_AIJ_HYPRE(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJPERM(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSELL(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSingle(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJMKL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJViennaCL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatReorderForNonzeroDiagonal_SeqAIJ(Mat,PetscReal,IS,IS);
@@ -89,6 +89,88 @@ PetscErrorCode MatGetOrdering_Flow_SeqAIJ(Mat mat,MatOrderingType type,IS *irow,
   PetscFunctionReturn(0);
 }
 
+/* counting sort of the rows by level, the rows of a level stay in increasing order */
+PetscErrorCode MatSolveLevelsSort_Private(PetscInt n,const PetscInt *lev,PetscInt *nlevels,PetscInt **ptr,PetscInt **rows)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,l,nl = 0,*p,*r;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) nl = PetscMax(nl,lev[i]+1);
+  ierr = PetscCalloc1(nl+1,&p);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&r);CHKERRQ(ierr);
+  for (i=0; i<n; i++) p[lev[i]+1]++;
+  for (l=0; l<nl; l++) p[l+1] += p[l];
+  for (i=0; i<n; i++) r[p[lev[i]]++] = i;
+  for (l=nl; l>0; l--) p[l] = p[l-1];
+  p[0]     = 0;
+  *nlevels = nl;
+  *ptr     = p;
+  *rows    = r;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSolveLevelsReset_Private(Mat_SeqAIJ_SolveLevels *sl)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr     = PetscFree(sl->fwdptr);CHKERRQ(ierr);
+  ierr     = PetscFree(sl->fwdrows);CHKERRQ(ierr);
+  ierr     = PetscFree(sl->bwdptr);CHKERRQ(ierr);
+  ierr     = PetscFree(sl->bwdrows);CHKERRQ(ierr);
+  ierr     = PetscFree3(sl->ti,sl->tj,sl->tperm);CHKERRQ(ierr);
+  sl->nfwd = sl->nbwd = 0;
+  PetscFunctionReturn(0);
+}
+
+/* the factor options are given with the prefix of the matrix being factored, as for the external solvers */
+PetscErrorCode MatSolveLevelsFromOptions_Private(Mat A,Mat_SeqAIJ_SolveLevels *sl)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectOptionsBegin((PetscObject)A);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-mat_factor_solve_levels","Solve with the factors level by level with threads","None",sl->use,&sl->use,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Builds the level sets of L and U of a factor from MatLUFactorNumeric_SeqAIJ(). The level of a row is one more
+   than the largest level of the rows it depends on, those of its column indices; L is traversed top down and U
+   bottom up so these levels are known when a row is reached.
+*/
+PetscErrorCode MatSeqAIJSetUpSolveLevels_Private(Mat B)
+{
+  Mat_SeqAIJ             *b  = (Mat_SeqAIJ*)B->data;
+  Mat_SeqAIJ_SolveLevels *sl = &b->solvelevels;
+  const PetscInt         n   = B->rmap->n,*bi = b->i,*bj = b->j,*bdiag = b->diag;
+  PetscInt               i,k,*lev;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSolveLevelsReset_Private(sl);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&lev);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    lev[i] = 0;
+    for (k=bi[i]; k<bi[i+1]; k++) lev[i] = PetscMax(lev[i],lev[bj[k]]+1);
+  }
+  ierr = MatSolveLevelsSort_Private(n,lev,&sl->nfwd,&sl->fwdptr,&sl->fwdrows);CHKERRQ(ierr);
+  for (i=n-1; i>=0; i--) {
+    lev[i] = 0;
+    for (k=bdiag[i+1]+1; k<bdiag[i]; k++) lev[i] = PetscMax(lev[i],lev[bj[k]]+1);
+  }
+  ierr = MatSolveLevelsSort_Private(n,lev,&sl->nbwd,&sl->bwdptr,&sl->bwdrows);CHKERRQ(ierr);
+  ierr = PetscFree(lev);CHKERRQ(ierr);
+  if (B->ops->solve != MatSolve_SeqAIJ_Levels) {
+    sl->solve     = B->ops->solve;
+    B->ops->solve = MatSolve_SeqAIJ_Levels;
+  }
+  ierr = PetscInfo3(B,"Forward solve in %D levels, backward solve in %D levels, of %D rows\n",sl->nfwd,sl->nbwd,n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_petsc(Mat A,MatFactorType ftype,Mat *B)
 {
   PetscInt       n = A->rmap->n;
@@ -107,12 +189,15 @@ PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_petsc(Mat A,MatFactorType ftype,
     (*B)->ops->lufactorsymbolic  = MatLUFactorSymbolic_SeqAIJ;
 
     ierr = MatSetBlockSizesFromMats(*B,A,A);CHKERRQ(ierr);
+    ierr = MatSolveLevelsFromOptions_Private(A,&((Mat_SeqAIJ*)(*B)->data)->solvelevels);CHKERRQ(ierr);
   } else if (ftype == MAT_FACTOR_CHOLESKY || ftype == MAT_FACTOR_ICC) {
     ierr = MatSetType(*B,MATSEQSBAIJ);CHKERRQ(ierr);
     ierr = MatSeqSBAIJSetPreallocation(*B,1,MAT_SKIP_ALLOCATION,NULL);CHKERRQ(ierr);
 
     (*B)->ops->iccfactorsymbolic      = MatICCFactorSymbolic_SeqAIJ;
     (*B)->ops->choleskyfactorsymbolic = MatCholeskyFactorSymbolic_SeqAIJ;
+
+    ierr = MatSolveLevelsFromOptions_Private(A,&((Mat_SeqSBAIJ*)(*B)->data)->solvelevels);CHKERRQ(ierr);
   } else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Factor type not supported");
   (*B)->factortype = ftype;
 
@@ -598,6 +683,7 @@ PetscErrorCode MatLUFactorNumeric_SeqAIJ(Mat B,Mat A,const MatFactorInfo *info)
   C->ops->matsolve          = MatMatSolve_SeqAIJ;
   C->assembled              = PETSC_TRUE;
   C->preallocated           = PETSC_TRUE;
+  if (b->solvelevels.use) {ierr = MatSeqAIJSetUpSolveLevels_Private(C);CHKERRQ(ierr);}
 
   ierr = PetscLogFlops(C->cmap->n);CHKERRQ(ierr);
 
@@ -2173,6 +2259,7 @@ PetscErrorCode MatCholeskyFactorNumeric_SeqAIJ(Mat B,Mat A,const MatFactorInfo *
 
   C->assembled    = PETSC_TRUE;
   C->preallocated = PETSC_TRUE;
+  if (b->solvelevels.use) {ierr = MatSeqSBAIJSetUpSolveLevels_Private(B);CHKERRQ(ierr);}
 
   ierr = PetscLogFlops(C->rmap->n);CHKERRQ(ierr);
 
@@ -3198,6 +3285,71 @@ PetscErrorCode MatSolve_SeqAIJ(Mat A,Vec bb,Vec xx)
   PetscFunctionReturn(0);
 }
 
+/*
+   MatSolve() with the level sets of MatSeqAIJSetUpSolveLevels_Private(), each level is a parallel loop over its rows.
+   The sequential solve is used for matrices too small to pay for the synchronization between the levels.
+*/
+PetscErrorCode MatSolve_SeqAIJ_Levels(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqAIJ             *a  = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_SolveLevels *sl = &a->solvelevels;
+  PetscErrorCode         ierr;
+  const PetscInt         *ai = a->i,*aj = a->j,*adiag = a->diag,*r,*c;
+  const MatScalar        *aa = a->a;
+  const PetscScalar      *b;
+  PetscScalar            *x,*tmp;
+
+  PetscFunctionBegin;
+  if (!PetscOMPUseThreads(a->nz)) {
+    ierr = (*sl->solve)(A,bb,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->col,&c);CHKERRQ(ierr);
+  tmp  = a->solve_work;
+
+  PetscPragmaOMP(parallel)
+  {
+    PetscInt l,k;
+
+    /* forward solve the lower triangular */
+    for (l=0; l<sl->nfwd; l++) {
+      PetscPragmaOMP(for schedule(static))
+      for (k=sl->fwdptr[l]; k<sl->fwdptr[l+1]; k++) {
+        PetscInt        i   = sl->fwdrows[k],nz = ai[i+1] - ai[i];
+        const PetscInt  *vi = aj + ai[i];
+        const MatScalar *v  = aa + ai[i];
+        PetscScalar     sum = b[r[i]];
+
+        PetscSparseDenseMinusDot(sum,tmp,v,vi,nz);
+        tmp[i] = sum;
+      }
+    }
+    /* backward solve the upper triangular */
+    for (l=0; l<sl->nbwd; l++) {
+      PetscPragmaOMP(for schedule(static))
+      for (k=sl->bwdptr[l]; k<sl->bwdptr[l+1]; k++) {
+        PetscInt        i   = sl->bwdrows[k],nz = adiag[i] - adiag[i+1] - 1;
+        const PetscInt  *vi = aj + adiag[i+1] + 1;
+        const MatScalar *v  = aa + adiag[i+1] + 1;
+        PetscScalar     sum = tmp[i];
+
+        PetscSparseDenseMinusDot(sum,tmp,v,vi,nz);
+        x[c[i]] = tmp[i] = sum*v[nz]; /* v[nz] = aa[adiag[i]] */
+      }
+    }
+  }
+
+  ierr = ISRestoreIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(a->col,&c);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2*a->nz - A->cmap->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
     This will get a new name and become a varient of MatILUFactor_SeqAIJ() there is no longer separate functions in the matrix function table for dt factors
 */
@@ -0,0 +1,412 @@
+/*
+  Defines basic operations for the MATSEQAIJSINGLE matrix class.
+  This class is derived from the MATSEQAIJ class and keeps a "shadow" copy of the
+  numerical values (and, with 64 bit indices, of the column indices) in single precision
+  that is used by the bandwidth limited operations MatMult(), MatMultAdd() and MatSOR().
+  Products are accumulated in PetscScalar, so only the matrix entries are rounded.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+typedef float MatScalarSingle;
+#if defined(PETSC_USE_64BIT_INDICES)
+typedef int   MatIndexSingle;
+#else
+typedef PetscInt MatIndexSingle;
+#endif
+
+typedef struct {
+  MatScalarSingle  *a;           /* single precision copy of the values of the Mat_SeqAIJ */
+  MatIndexSingle   *j;           /* column indices, a copy only with 64 bit indices */
+  PetscObjectState state;        /* state of the matrix when the shadow copy was last constructed */
+  PetscObjectState nonzerostate; /* nonzero state of the matrix when the shadow copy was last allocated */
+} Mat_SeqAIJSingle;
+
+static PetscErrorCode MatSeqAIJSingle_free_shadow(Mat_SeqAIJSingle *aijsingle)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(aijsingle->a);CHKERRQ(ierr);
+#if defined(PETSC_USE_64BIT_INDICES)
+  ierr = PetscFree(aijsingle->j);CHKERRQ(ierr);
+#endif
+  aijsingle->j            = NULL;
+  aijsingle->state        = -1;
+  aijsingle->nonzerostate = -1;
+  PetscFunctionReturn(0);
+}
+
+/* Build or update the single precision copy if and only if needed.
+ * We track the ObjectState to determine when this needs to be done. */
+PETSC_INTERN PetscErrorCode MatSeqAIJSingle_build_shadow(Mat A)
+{
+  PetscErrorCode   ierr;
+  Mat_SeqAIJ       *a         = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  PetscInt         k,nz       = a->i[A->rmap->n];
+  PetscObjectState state;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectStateGet((PetscObject)A,&state);CHKERRQ(ierr);
+  if (aijsingle->state == state && aijsingle->nonzerostate == A->nonzerostate) PetscFunctionReturn(0);
+
+  ierr = PetscLogEventBegin(MAT_Convert,A,0,0,0);CHKERRQ(ierr);
+  if (aijsingle->nonzerostate != A->nonzerostate) {
+    ierr = MatSeqAIJSingle_free_shadow(aijsingle);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nz,&aijsingle->a);CHKERRQ(ierr);
+#if defined(PETSC_USE_64BIT_INDICES)
+    if (A->cmap->n > PETSC_MPI_INT_MAX) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SUP,"MATSEQAIJSINGLE stores 32 bit column indices, %D columns is too many",A->cmap->n);
+    ierr = PetscMalloc1(nz,&aijsingle->j);CHKERRQ(ierr);
+    for (k=0; k<nz; k++) aijsingle->j[k] = (MatIndexSingle)a->j[k];
+#else
+    aijsingle->j = a->j;
+#endif
+    aijsingle->nonzerostate = A->nonzerostate;
+  }
+  PetscPragmaOMP(parallel for schedule(static) if(PetscOMPUseThreads(nz)))
+  for (k=0; k<nz; k++) aijsingle->a[k] = (MatScalarSingle)PetscRealPart(a->a[k]);
+  ierr = PetscLogEventEnd(MAT_Convert,A,0,0,0);CHKERRQ(ierr);
+
+  /* Record the ObjectState so that we can tell when the shadow copy needs updating */
+  aijsingle->state = state;
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJSingle_SeqAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  /* This routine is only called to convert a MATAIJSINGLE to its base PETSc type, */
+  /* so we will ignore 'MatType type'. */
+  PetscErrorCode   ierr;
+  Mat              B          = *newmat;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr      = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+    aijsingle = (Mat_SeqAIJSingle*)B->spptr;
+  }
+
+  /* Reset the original function pointers. */
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy     = MatDestroy_SeqAIJ;
+  B->ops->mult        = MatMult_SeqAIJ;
+  B->ops->multadd     = MatMultAdd_SeqAIJ;
+  B->ops->sor         = MatSOR_SeqAIJ;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijsingle_seqaij_C",NULL);CHKERRQ(ierr);
+
+  ierr = MatSeqAIJSingle_free_shadow(aijsingle);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+
+  /* Change the type of B to MATSEQAIJ. */
+  ierr = PetscObjectChangeTypeName((PetscObject)B, MATSEQAIJ);CHKERRQ(ierr);
+
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJSingle(Mat A)
+{
+  PetscErrorCode   ierr;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+
+  PetscFunctionBegin;
+  /* If MatHeaderMerge() was used, then this SeqAIJSingle matrix will not have an spptr pointer. */
+  if (aijsingle) {
+    ierr = MatSeqAIJSingle_free_shadow(aijsingle);CHKERRQ(ierr);
+    ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  }
+
+  /* Change the type of A back to SEQAIJ and use MatDestroy_SeqAIJ()
+   * to destroy everything that remains. */
+  ierr = PetscObjectChangeTypeName((PetscObject)A, MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatAssemblyEnd_SeqAIJSingle(Mat A, MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+
+  /* The inode routines would replace the single precision MatMult() and MatSOR() */
+  a->inode.use = PETSC_FALSE;
+  ierr         = MatAssemblyEnd_SeqAIJ(A, mode);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqAIJSingle(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle      *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  const PetscScalar     *x;
+  PetscScalar           *y;
+  const MatScalarSingle *aa;
+  const MatIndexSingle  *aj;
+  const PetscInt        *ai = a->i;
+  PetscInt              i,m = A->rmap->n;
+  PetscErrorCode        ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSingle_build_shadow(A);CHKERRQ(ierr);
+  aa   = aijsingle->a;
+  aj   = aijsingle->j;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  PetscPragmaOMP(parallel for schedule(static) if(PetscOMPUseThreads(a->nz)))
+  for (i=0; i<m; i++) {
+    PetscInt    k;
+    PetscScalar sum = 0.0;
+
+    for (k=ai[i]; k<ai[i+1]; k++) sum += (PetscScalar)aa[k]*x[aj[k]];
+    y[i] = sum;
+  }
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJSingle(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle      *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  const PetscScalar     *x;
+  PetscScalar           *y,*z;
+  const MatScalarSingle *aa;
+  const MatIndexSingle  *aj;
+  const PetscInt        *ai = a->i;
+  PetscInt              i,m = A->rmap->n;
+  PetscErrorCode        ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSingle_build_shadow(A);CHKERRQ(ierr);
+  aa   = aijsingle->a;
+  aj   = aijsingle->j;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  PetscPragmaOMP(parallel for schedule(static) if(PetscOMPUseThreads(a->nz)))
+  for (i=0; i<m; i++) {
+    PetscInt    k;
+    PetscScalar sum = y[i];
+
+    for (k=ai[i]; k<ai[i+1]; k++) sum += (PetscScalar)aa[k]*x[aj[k]];
+    z[i] = sum;
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Forward, backward and symmetric sweeps (local or not, with or without zero initial guess) use the single precision values,
+   the diagonal is inverted in double precision exactly as for MATSEQAIJ. Eisenstat and SOR_APPLY_UPPER/LOWER are passed on
+   to MatSOR_SeqAIJ().
+*/
+PetscErrorCode MatSOR_SeqAIJSingle(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle      *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  PetscScalar           *x,sum,*t;
+  const PetscScalar     *b,*xb;
+  const MatScalar       *idiag;
+  const MatScalarSingle *v;
+  const MatIndexSingle  *idx;
+  const PetscInt        *diag,*ai = a->i;
+  PetscInt              m = A->rmap->n,i,k;
+  PetscErrorCode        ierr;
+
+  PetscFunctionBegin;
+  if ((flag & SOR_EISENSTAT) || flag == SOR_APPLY_UPPER || flag == SOR_APPLY_LOWER) {
+    ierr = MatSOR_SeqAIJ(A,bb,omega,flag,fshift,its,lits,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = MatSeqAIJSingle_build_shadow(A);CHKERRQ(ierr);
+  its  = its*lits;
+
+  if (fshift != a->fshift || omega != a->omega) a->idiagvalid = PETSC_FALSE; /* must recompute idiag[] */
+  if (!a->idiagvalid) {ierr = MatInvertDiagonal_SeqAIJ(A,omega,fshift);CHKERRQ(ierr);}
+  a->fshift = fshift;
+  a->omega  = omega;
+
+  diag  = a->diag;
+  t     = a->ssor_work;
+  idiag = a->idiag;
+  v     = aijsingle->a;
+  idx   = aijsingle->j;
+
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  /* We count flops by assuming the upper triangular and lower triangular parts have the same number of nonzeros */
+  if (flag & SOR_ZERO_INITIAL_GUESS) {
+    if ((flag & SOR_FORWARD_SWEEP) || (flag & SOR_LOCAL_FORWARD_SWEEP)) {
+      for (i=0; i<m; i++) {
+        sum  = b[i];
+        for (k=ai[i]; k<diag[i]; k++) sum -= (PetscScalar)v[k]*x[idx[k]];
+        t[i] = sum;
+        x[i] = sum*idiag[i];
+      }
+      xb   = t;
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if ((flag & SOR_BACKWARD_SWEEP) || (flag & SOR_LOCAL_BACKWARD_SWEEP)) {
+      for (i=m-1; i>=0; i--) {
+        sum = xb[i];
+        for (k=diag[i]+1; k<ai[i+1]; k++) sum -= (PetscScalar)v[k]*x[idx[k]];
+        if (xb == b) {
+          x[i] = sum*idiag[i];
+        } else {
+          x[i] = (1.-omega)*x[i]+sum*idiag[i];  /* omega in idiag */
+        }
+      }
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+    }
+    its--;
+  }
+  while (its--) {
+    if ((flag & SOR_FORWARD_SWEEP) || (flag & SOR_LOCAL_FORWARD_SWEEP)) {
+      for (i=0; i<m; i++) {
+        /* lower */
+        sum  = b[i];
+        for (k=ai[i]; k<diag[i]; k++) sum -= (PetscScalar)v[k]*x[idx[k]];
+        t[i] = sum;             /* save application of the lower-triangular part */
+        /* upper */
+        for (k=diag[i]+1; k<ai[i+1]; k++) sum -= (PetscScalar)v[k]*x[idx[k]];
+        x[i] = (1.-omega)*x[i]+sum*idiag[i];  /* omega in idiag */
+      }
+      xb   = t;
+      ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if ((flag & SOR_BACKWARD_SWEEP) || (flag & SOR_LOCAL_BACKWARD_SWEEP)) {
+      for (i=m-1; i>=0; i--) {
+        sum = xb[i];
+        if (xb == b) {
+          /* whole matrix (no checkpointing available) */
+          for (k=ai[i]; k<diag[i]; k++) sum -= (PetscScalar)v[k]*x[idx[k]];
+        }
+        /* the lower-triangular part has been saved in xb otherwise, so only apply the upper-triangular one */
+        for (k=diag[i]+1; k<ai[i+1]; k++) sum -= (PetscScalar)v[k]*x[idx[k]];
+        x[i] = (1.-omega)*x[i]+sum*idiag[i];  /* omega in idiag */
+      }
+      if (xb == b) {
+        ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+      } else {
+        ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+      }
+    }
+  }
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJSingle converts a SeqAIJ matrix into a
+ * SeqAIJSingle matrix.  This routine is called by the MatCreate_SeqAIJSingle()
+ * routine, but can also be used to convert an assembled SeqAIJ matrix
+ * into a SeqAIJSingle one. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSingle(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode   ierr;
+  Mat              B = *newmat;
+  Mat_SeqAIJ       *b;
+  Mat_SeqAIJSingle *aijsingle;
+  PetscBool        sametype;
+
+  PetscFunctionBegin;
+#if defined(PETSC_USE_COMPLEX)
+  SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_SUP,"MATSEQAIJSINGLE is only available for real scalars");
+#endif
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectTypeCompare((PetscObject)A,type,&sametype);CHKERRQ(ierr);
+  if (sametype) PetscFunctionReturn(0);
+
+  ierr     = PetscNewLog(B,&aijsingle);CHKERRQ(ierr);
+  b        = (Mat_SeqAIJ*)B->data;
+  B->spptr = (void*)aijsingle;
+
+  /* Disable use of the inode routines so that the single precision ones will be used instead.
+   * This happens in MatAssemblyEnd_SeqAIJSingle as well, but the assembly end may not be called, so set it here, too. */
+  b->inode.use = PETSC_FALSE;
+
+  aijsingle->state        = -1;  /* this will trigger the construction of the shadow copy the first time it is used */
+  aijsingle->nonzerostate = -1;
+
+  /* Set function pointers for methods that we inherit from AIJ but override.
+   * MatDuplicate_SeqAIJ() creates the new matrix with the type of A, its shadow copy is constructed when it is first used. */
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJSingle;
+  B->ops->destroy     = MatDestroy_SeqAIJSingle;
+  B->ops->mult        = MatMult_SeqAIJSingle;
+  B->ops->multadd     = MatMultAdd_SeqAIJSingle;
+  B->ops->sor         = MatSOR_SeqAIJSingle;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijsingle_seqaij_C",MatConvert_SeqAIJSingle_SeqAIJ);CHKERRQ(ierr);
+
+  ierr    = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJSINGLE);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatCreateSeqAIJSingle - Creates a sparse matrix of type SEQAIJSINGLE.
+   This type inherits from AIJ and is identical to it, but keeps an additional copy
+   of the numerical values in single precision that is used by MatMult(), MatMultAdd()
+   and MatSOR(). Those operations are limited by memory bandwidth, so reading 4 instead
+   of 8 bytes per entry makes them faster; the products are still accumulated in double precision.
+   This is intended for the matrix from which the preconditioner is built (the Pmat argument
+   of KSPSetOperators()), so that smoothers such as Jacobi, SOR or Chebyshev run on single
+   precision values while the Krylov method applies the operator in double precision.
+
+   Collective on MPI_Comm
+
+   Input Parameters:
++  comm - MPI communicator, set to PETSC_COMM_SELF
+.  m - number of rows
+.  n - number of columns
+.  nz - number of nonzeros per row (same for all rows)
+-  nnz - array containing the number of nonzeros in the various rows
+         (possibly different for each row) or NULL
+
+   Output Parameter:
+.  A - the matrix
+
+   Notes:
+   If nnz is given then nz is ignored
+
+   All other operations, including factorizations and matrix products, use the double precision values.
+   Because SEQAIJSINGLE is a subtype of SEQAIJ, the option "-mat_seqaij_type seqaijsingle" can be used to make
+   sequential AIJ matrices default to being instances of MATSEQAIJSINGLE. Only real scalars are supported.
+
+   Level: intermediate
+
+.keywords: matrix, sparse, single precision
+
+.seealso: MatCreate(), MatCreateMPIAIJSingle(), MatSetValues(), MATAIJSINGLE
+@*/
+PetscErrorCode  MatCreateSeqAIJSingle(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,const PetscInt nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJSINGLE);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(*A,nz,nnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJSingle(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJSingle(A,MATSEQAIJSINGLE,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
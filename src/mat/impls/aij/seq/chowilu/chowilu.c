@@ -0,0 +1,431 @@
+/*
+     Fine grained parallel ILU(k) of SeqAIJ matrices, following
+
+       E. Chow and A. Patel, Fine-grained parallel incomplete LU factorization,
+       SIAM J. Sci. Comput. 37 (2015), C169-C193.
+
+     The nonzero pattern of the factors is the one of the usual ILU(k) symbolic factorization and the
+     factors are stored as MatLUFactorNumeric_SeqAIJ() stores them. Their values are computed by a few
+     fixed point sweeps over all the nonzeros of the pattern
+
+        l_ij = (a_ij - sum_{k<j} l_ik u_kj) / u_jj    i > j
+        u_ij =  a_ij - sum_{k<i} l_ik u_kj            i <= j
+
+     and the triangular solves are a few Jacobi sweeps. Each sweep only uses the values of the previous one,
+     so every nonzero or row is computed independently and the results do not depend on the number of threads.
+*/
+#include <../src/mat/impls/aij/seq/aij.h>
+
+typedef struct {
+  PetscInt    sweeps;       /* fixed point sweeps of the factorization */
+  PetscInt    solvesweeps;  /* Jacobi sweeps of each triangular solve, 0 means exact triangular solves */
+  PetscInt    *apos;        /* location in A of each nonzero of the factor, -1 for fill */
+  PetscInt    *ucptr,*ucrow,*ucpos; /* U by columns: row and location in the factor of its nonzeros */
+  MatScalar   *anew;        /* values of the factor computed by the current sweep */
+  PetscScalar *work;        /* two work vectors for the Jacobi sweeps */
+} Mat_SeqAIJ_ChowILU;
+
+static PetscErrorCode MatDestroy_SeqAIJ_ChowILU(Mat A)
+{
+  Mat_SeqAIJ_ChowILU *chow = (Mat_SeqAIJ_ChowILU*)A->spptr;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  if (chow) {
+    ierr = PetscFree3(chow->apos,chow->anew,chow->work);CHKERRQ(ierr);
+    ierr = PetscFree3(chow->ucptr,chow->ucrow,chow->ucpos);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatFactorGetSolverType_C",NULL);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatView_SeqAIJ_ChowILU(Mat A,PetscViewer viewer)
+{
+  Mat_SeqAIJ_ChowILU *chow = (Mat_SeqAIJ_ChowILU*)A->spptr;
+  PetscErrorCode     ierr;
+  PetscBool          iascii;
+  PetscViewerFormat  format;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+    if (format == PETSC_VIEWER_ASCII_INFO) {
+      if (chow->solvesweeps) {
+        ierr = PetscViewerASCIIPrintf(viewer,"Chow-Patel ILU: %D factorization sweeps, %D Jacobi sweeps per triangular solve\n",chow->sweeps,chow->solvesweeps);CHKERRQ(ierr);
+      } else {
+        ierr = PetscViewerASCIIPrintf(viewer,"Chow-Patel ILU: %D factorization sweeps, exact triangular solves\n",chow->sweeps);CHKERRQ(ierr);
+      }
+    }
+  }
+  ierr = MatView_SeqAIJ(A,viewer);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Solves with the factors by Jacobi sweeps, for L starting from b and for U starting from D^{-1} y.
+   After k sweeps the result is exact in the rows that depend on fewer than k other rows.
+*/
+static PetscErrorCode MatSolve_SeqAIJ_ChowILU(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqAIJ         *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_ChowILU *chow = (Mat_SeqAIJ_ChowILU*)A->spptr;
+  const PetscInt     n = A->rmap->n,*ai = a->i,*aj = a->j,*adiag = a->diag,*r,*c;
+  const MatScalar    *aa = a->a;
+  const PetscScalar  *b;
+  PetscScalar        *x,*rhs,*y,*ynew,*tmp;
+  PetscInt           i,s;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->col,&c);CHKERRQ(ierr);
+  rhs  = a->solve_work;
+  y    = chow->work;
+  ynew = chow->work + n;
+
+  PetscPragmaOMP(parallel for schedule(static) if(PetscOMPUseThreads(a->nz)))
+  for (i=0; i<n; i++) rhs[i] = y[i] = b[r[i]];
+
+  /* L y = rhs, L has a unit diagonal */
+  for (s=0; s<chow->solvesweeps; s++) {
+    PetscPragmaOMP(parallel for schedule(static) if(PetscOMPUseThreads(a->nz)))
+    for (i=0; i<n; i++) {
+      const MatScalar *v  = aa + ai[i];
+      const PetscInt  *vi = aj + ai[i],nz = ai[i+1] - ai[i];
+      PetscScalar     sum = rhs[i];
+
+      PetscSparseDenseMinusDot(sum,y,v,vi,nz);
+      ynew[i] = sum;
+    }
+    tmp = y; y = ynew; ynew = tmp;
+  }
+
+  /* U x = y, the factor stores the inverse of the diagonal of U; rhs and ynew are free */
+  PetscPragmaOMP(parallel for schedule(static) if(PetscOMPUseThreads(a->nz)))
+  for (i=0; i<n; i++) rhs[i] = aa[adiag[i]]*y[i];
+  for (s=0; s<chow->solvesweeps; s++) {
+    PetscPragmaOMP(parallel for schedule(static) if(PetscOMPUseThreads(a->nz)))
+    for (i=0; i<n; i++) {
+      const MatScalar *v  = aa + adiag[i+1] + 1;
+      const PetscInt  *vi = aj + adiag[i+1] + 1,nz = adiag[i] - adiag[i+1] - 1;
+      PetscScalar     sum = y[i];
+
+      PetscSparseDenseMinusDot(sum,rhs,v,vi,nz);
+      ynew[i] = sum*aa[adiag[i]];
+    }
+    tmp = rhs; rhs = ynew; ynew = tmp;
+  }
+
+  PetscPragmaOMP(parallel for schedule(static) if(PetscOMPUseThreads(a->nz)))
+  for (i=0; i<n; i++) x[c[i]] = rhs[i];
+
+  ierr = ISRestoreIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(a->col,&c);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(chow->solvesweeps*(2.0*a->nz - n) + n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   a_ij - sum_{k<min(i,j)} l_ik u_kj with the current values of the factors, merging row i of L and column j of U.
+   The flops are added to the counter of the calling thread.
+*/
+PETSC_STATIC_INLINE MatScalar MatChowILUResidual(const MatScalar *ba,const PetscInt *bi,const PetscInt *bj,const PetscInt *ucptr,const PetscInt *ucrow,const PetscInt *ucpos,MatScalar aij,PetscInt i,PetscInt j,PetscLogDouble *flops)
+{
+  PetscInt  q = bi[i],qend = bi[i+1],t = ucptr[j],tend = ucptr[j+1],m = PetscMin(i,j),nmult = 0;
+  MatScalar sum = aij;
+
+  while (q < qend && t < tend && bj[q] < m && ucrow[t] < m) {
+    if (bj[q] < ucrow[t]) q++;
+    else if (ucrow[t] < bj[q]) t++;
+    else {sum -= ba[q]*ba[ucpos[t]]; q++; t++; nmult++;}
+  }
+  *flops += 2.0*nmult;
+  return sum;
+}
+
+static PetscErrorCode MatLUFactorNumeric_SeqAIJ_ChowILU(Mat B,Mat A,const MatFactorInfo *info)
+{
+  Mat_SeqAIJ         *a = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data;
+  Mat_SeqAIJ_ChowILU *chow = (Mat_SeqAIJ_ChowILU*)B->spptr;
+  const PetscInt     n = A->rmap->n,*bi = b->i,*bj = b->j,*bdiag = b->diag;
+  const PetscInt     *apos = chow->apos,*ucptr = chow->ucptr,*ucrow = chow->ucrow,*ucpos = chow->ucpos;
+  const MatScalar    *aa = a->a;
+  MatScalar          *ba = b->a,*anew = chow->anew;
+  const PetscInt     nz = bdiag[0] + 1;
+  PetscInt           i,p,s;
+  PetscLogDouble     flops = 0.0;
+  PetscBool          row_identity,col_identity;
+  FactorShiftCtx     sctx;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  /* MatPivotSetUp(): initialize shift context sctx */
+  ierr = PetscMemzero(&sctx,sizeof(FactorShiftCtx));CHKERRQ(ierr);
+  if (info->shifttype == (PetscReal) MAT_SHIFT_POSITIVE_DEFINITE) { /* set sctx.shift_top=max{rs} */
+    sctx.shift_top = info->zeropivot;
+    for (i=0; i<n; i++) {
+      /* calculate sum(|aij|)-RealPart(aii), amt of shift needed for this row */
+      PetscReal rs = -PetscAbsScalar(aa[a->diag[i]]) - PetscRealPart(aa[a->diag[i]]);
+
+      for (p=a->i[i]; p<a->i[i+1]; p++) rs += PetscAbsScalar(aa[p]);
+      if (rs > sctx.shift_top) sctx.shift_top = rs;
+    }
+    sctx.shift_top *= 1.1;
+    sctx.nshift_max = 5;
+    sctx.shift_lo   = 0.;
+    sctx.shift_hi   = 1.;
+  }
+
+  /* a shift of the diagonal restarts the sweeps from the shifted matrix, as the sequential ILU restarts the elimination */
+  do {
+    sctx.newshift = PETSC_FALSE;
+
+    /* the initial guess is the upper triangular part of A and its lower triangular part scaled by the diagonal */
+    PetscPragmaOMP(parallel for schedule(static) if(PetscOMPUseThreads(nz)))
+    for (p=bdiag[n]+1; p<=bdiag[0]; p++) ba[p] = apos[p] >= 0 ? aa[apos[p]] : 0.0;
+    for (i=0; i<n; i++) ba[bdiag[i]] += sctx.shift_amount;
+    PetscPragmaOMP(parallel for schedule(static) if(PetscOMPUseThreads(nz)))
+    for (p=0; p<bi[n]; p++) {
+      MatScalar d = ba[bdiag[bj[p]]];
+
+      ba[p] = apos[p] >= 0 ? aa[apos[p]] : 0.0;
+      if (d != 0.0) ba[p] /= d;
+    }
+
+    for (s=0; s<chow->sweeps; s++) {
+      PetscPragmaOMP(parallel for schedule(static) reduction(+:flops) if(PetscOMPUseThreads(nz)))
+      for (i=0; i<n; i++) {
+        PetscInt k;
+
+        for (k=bi[i]; k<bi[i+1]; k++) {
+          MatScalar sum = MatChowILUResidual(ba,bi,bj,ucptr,ucrow,ucpos,apos[k] >= 0 ? aa[apos[k]] : 0.0,i,bj[k],&flops);
+
+          anew[k] = ba[bdiag[bj[k]]] != 0.0 ? sum/ba[bdiag[bj[k]]] : sum;
+        }
+        for (k=bdiag[i+1]+1; k<bdiag[i]; k++) anew[k] = MatChowILUResidual(ba,bi,bj,ucptr,ucrow,ucpos,apos[k] >= 0 ? aa[apos[k]] : 0.0,i,bj[k],&flops);
+        anew[bdiag[i]] = MatChowILUResidual(ba,bi,bj,ucptr,ucrow,ucpos,(apos[bdiag[i]] >= 0 ? aa[apos[bdiag[i]]] : 0.0) + sctx.shift_amount,i,i,&flops);
+      }
+      ierr = PetscMemcpy(ba,anew,nz*sizeof(MatScalar));CHKERRQ(ierr);
+    }
+
+    /* the solves use the inverse of the diagonal of U */
+    B->factorerrortype = MAT_FACTOR_NOERROR;
+    for (i=0; i<n; i++) {
+      sctx.rs = 0.0;
+      for (p=bi[i]; p<bi[i+1]; p++) sctx.rs += PetscAbsScalar(ba[p]);
+      for (p=bdiag[i+1]+1; p<bdiag[i]; p++) sctx.rs += PetscAbsScalar(ba[p]);
+      sctx.pv = ba[bdiag[i]];
+      ierr    = MatPivotCheck(B,A,info,&sctx,i);CHKERRQ(ierr);
+      if (sctx.newshift || B->factorerrortype) break;
+      ba[bdiag[i]] = 1.0/sctx.pv; /* sctx.pv might be updated in the case of MAT_SHIFT_INBLOCKS */
+    }
+
+    /* MatPivotRefine() */
+    if (info->shifttype == (PetscReal)MAT_SHIFT_POSITIVE_DEFINITE && !sctx.newshift && sctx.shift_fraction>0 && sctx.nshift<sctx.nshift_max) {
+      /*
+       * if no shift in this attempt & shifting & started shifting & can refine,
+       * then try lower shift
+       */
+      sctx.shift_hi       = sctx.shift_fraction;
+      sctx.shift_fraction = (sctx.shift_hi+sctx.shift_lo)/2.;
+      sctx.shift_amount   = sctx.shift_fraction * sctx.shift_top;
+      sctx.newshift       = PETSC_TRUE;
+      sctx.nshift++;
+    }
+  } while (sctx.newshift);
+
+  if (chow->solvesweeps) {
+    B->ops->solve             = MatSolve_SeqAIJ_ChowILU;
+    B->ops->solveadd          = NULL;
+    B->ops->solvetranspose    = NULL;
+    B->ops->solvetransposeadd = NULL;
+    B->ops->matsolve          = NULL;
+  } else {
+    ierr = ISIdentity(b->row,&row_identity);CHKERRQ(ierr);
+    ierr = ISIdentity(b->icol,&col_identity);CHKERRQ(ierr);
+    if (b->inode.size) {
+      B->ops->solve = MatSolve_SeqAIJ_Inode;
+    } else if (row_identity && col_identity) {
+      B->ops->solve = MatSolve_SeqAIJ_NaturalOrdering;
+    } else {
+      B->ops->solve = MatSolve_SeqAIJ;
+    }
+    B->ops->solveadd          = MatSolveAdd_SeqAIJ;
+    B->ops->solvetranspose    = MatSolveTranspose_SeqAIJ;
+    B->ops->solvetransposeadd = MatSolveTransposeAdd_SeqAIJ;
+    B->ops->matsolve          = MatMatSolve_SeqAIJ;
+  }
+  B->assembled    = PETSC_TRUE;
+  B->preallocated = PETSC_TRUE;
+  if (!chow->solvesweeps && b->solvelevels.use) {ierr = MatSeqAIJSetUpSolveLevels_Private(B);CHKERRQ(ierr);}
+
+  ierr = PetscInfo2(A,"%D sweeps, %g flops per sweep\n",chow->sweeps,chow->sweeps ? flops/chow->sweeps : 0.0);CHKERRQ(ierr);
+
+  /* MatShiftView(A,info,&sctx) */
+  if (sctx.nshift) {
+    if (info->shifttype == (PetscReal)MAT_SHIFT_POSITIVE_DEFINITE) {
+      ierr = PetscInfo4(A,"number of shift_pd tries %D, shift_amount %g, diagonal shifted up by %e fraction top_value %e\n",sctx.nshift,(double)sctx.shift_amount,(double)sctx.shift_fraction,(double)sctx.shift_top);CHKERRQ(ierr);
+    } else if (info->shifttype == (PetscReal)MAT_SHIFT_NONZERO) {
+      ierr = PetscInfo2(A,"number of shift_nz tries %D, shift_amount %g\n",sctx.nshift,(double)sctx.shift_amount);CHKERRQ(ierr);
+    } else if (info->shifttype == (PetscReal)MAT_SHIFT_INBLOCKS) {
+      ierr = PetscInfo2(A,"number of shift_inblocks applied %D, each shift_amount %g\n",sctx.nshift,(double)info->shiftamount);CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscLogFlops(flops + n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatILUFactorSymbolic_SeqAIJ_ChowILU(Mat fact,Mat A,IS isrow,IS iscol,const MatFactorInfo *info)
+{
+  Mat_SeqAIJ         *a = (Mat_SeqAIJ*)A->data,*b;
+  Mat_SeqAIJ_ChowILU *chow = (Mat_SeqAIJ_ChowILU*)fact->spptr;
+  const PetscInt     n = A->rmap->n,*ai = a->i,*aj = a->j,*r,*ic;
+  const PetscInt     *bi,*bj,*bdiag;
+  PetscInt           i,j,k,p,nz,nzu,*map,*apos,*ucptr,*ucrow,*ucpos;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  /* the pattern and the storage of the factors are the ones of the sequential ILU(k) */
+  ierr  = MatILUFactorSymbolic_SeqAIJ(fact,A,isrow,iscol,info);CHKERRQ(ierr);
+  b     = (Mat_SeqAIJ*)fact->data;
+  bi    = b->i;
+  bj    = b->j;
+  bdiag = b->diag;
+  nz    = bdiag[0] + 1;
+  nzu   = bdiag[0] - bdiag[n];
+
+  ierr = PetscFree3(chow->apos,chow->anew,chow->work);CHKERRQ(ierr);
+  ierr = PetscFree3(chow->ucptr,chow->ucrow,chow->ucpos);CHKERRQ(ierr);
+  ierr = PetscMalloc3(nz,&chow->apos,nz,&chow->anew,2*n,&chow->work);CHKERRQ(ierr);
+  ierr = PetscMalloc3(n+1,&chow->ucptr,nzu,&chow->ucrow,nzu,&chow->ucpos);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)fact,nz*(sizeof(PetscInt)+sizeof(MatScalar))+(n+1+2*nzu)*sizeof(PetscInt)+2*n*sizeof(PetscScalar));CHKERRQ(ierr);
+  apos  = chow->apos;
+  ucptr = chow->ucptr;
+  ucrow = chow->ucrow;
+  ucpos = chow->ucpos;
+
+  /* locations of the values of A in the factor, rows of the factor are the rows r[] of A */
+  ierr = ISGetIndices(isrow,&r);CHKERRQ(ierr);
+  ierr = ISGetIndices(b->icol,&ic);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&map);CHKERRQ(ierr);
+  for (i=0; i<n; i++) map[i] = -1;
+  for (p=0; p<nz; p++) apos[p] = -1;
+  for (i=0; i<n; i++) {
+    for (p=bi[i]; p<bi[i+1]; p++) map[bj[p]] = p;
+    for (p=bdiag[i+1]+1; p<bdiag[i]; p++) map[bj[p]] = p;
+    map[i] = bdiag[i];
+    for (k=ai[r[i]]; k<ai[r[i]+1]; k++) {
+      j = map[ic[aj[k]]];
+      if (j < 0) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Entry (%D,%D) of the matrix is not in the factor",r[i],aj[k]);
+      apos[j] = k;
+    }
+    for (p=bi[i]; p<bi[i+1]; p++) map[bj[p]] = -1;
+    for (p=bdiag[i+1]+1; p<bdiag[i]; p++) map[bj[p]] = -1;
+    map[i] = -1;
+  }
+  ierr = PetscFree(map);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(isrow,&r);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(b->icol,&ic);CHKERRQ(ierr);
+
+  /* U by columns, the rows of each column increasing so its diagonal is last */
+  ierr = PetscMemzero(ucptr,(n+1)*sizeof(PetscInt));CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    for (p=bdiag[i+1]+1; p<bdiag[i]; p++) ucptr[bj[p]+1]++;
+    ucptr[i+1]++;
+  }
+  for (i=0; i<n; i++) ucptr[i+1] += ucptr[i];
+  for (i=0; i<n; i++) {
+    for (p=bdiag[i+1]+1; p<bdiag[i]; p++) {
+      j = bj[p];
+      ucrow[ucptr[j]] = i;
+      ucpos[ucptr[j]] = p;
+      ucptr[j]++;
+    }
+    ucrow[ucptr[i]] = i;
+    ucpos[ucptr[i]] = bdiag[i];
+    ucptr[i]++;
+  }
+  for (i=n; i>0; i--) ucptr[i] = ucptr[i-1];
+  ucptr[0] = 0;
+
+  fact->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_ChowILU;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatFactorGetSolverType_seqaij_chowilu(Mat A,MatSolverType *type)
+{
+  PetscFunctionBegin;
+  *type = MATSOLVERCHOWILU;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+  MATSOLVERCHOWILU = "chowilu" - A fine grained parallel ILU(k) for sequential AIJ matrices, that needs no external package.
+
+  The factors have the nonzero pattern of the usual ILU(k). Their values are computed by a few fixed point sweeps over all
+  the nonzeros, as in Chow and Patel, Fine-grained parallel incomplete LU factorization, 2015, and the triangular solves are
+  a few Jacobi sweeps. Each sweep is parallel over the rows of the matrix when PETSc is configured --with-openmp.
+
+  Use -pc_type ilu -pc_factor_mat_solver_type chowilu to use this preconditioner
+
+  Options Database Keys:
++ -mat_chowilu_sweeps <3>       - number of fixed point sweeps of the factorization
+- -mat_chowilu_solve_sweeps <3> - number of Jacobi sweeps of each triangular solve, 0 for the usual exact triangular solves
+
+  Notes:
+    With enough sweeps the factors are the ones of the sequential ILU(k), in exact arithmetic. A few sweeps usually give a
+    preconditioner as good as the sequential one on diagonally dominant matrices. The Jacobi triangular solves do not apply
+    the inverse of LU, and the preconditioner is a fixed linear operator only because the number of sweeps is fixed.
+
+    The zero pivot shifts of -pc_factor_shift_type are applied to the diagonal of A as in the sequential ILU(k): a pivot that
+    needs a larger shift restarts the sweeps from the shifted matrix.
+
+    MatSolveTranspose() is only supported with exact triangular solves.
+
+   Level: intermediate
+
+.seealso: PCILU, PCCHOWILUVIENNACL, PCFactorSetMatSolverType(), MatSolverType
+M*/
+
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_chowilu(Mat A,MatFactorType ftype,Mat *B)
+{
+  PetscInt           n = A->rmap->n;
+  Mat_SeqAIJ_ChowILU *chow;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  if (ftype != MAT_FACTOR_ILU) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Factor type not supported");
+  ierr = MatCreate(PetscObjectComm((PetscObject)A),B);CHKERRQ(ierr);
+  ierr = MatSetSizes(*B,n,n,n,n);CHKERRQ(ierr);
+  ierr = MatSetType(*B,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatSetBlockSizesFromMats(*B,A,A);CHKERRQ(ierr);
+
+  ierr = PetscNewLog(*B,&chow);CHKERRQ(ierr);
+  chow->sweeps      = 3;
+  chow->solvesweeps = 3;
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)A),((PetscObject)A)->prefix,"Chow-Patel ILU Options","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_chowilu_sweeps","Number of fixed point sweeps of the factorization","None",chow->sweeps,&chow->sweeps,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_chowilu_solve_sweeps","Number of Jacobi sweeps of the triangular solves, 0 for exact solves","None",chow->solvesweeps,&chow->solvesweeps,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (chow->sweeps < 0 || chow->solvesweeps < 0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of sweeps cannot be negative");
+  ierr = MatSolveLevelsFromOptions_Private(A,&((Mat_SeqAIJ*)(*B)->data)->solvelevels);CHKERRQ(ierr);
+  (*B)->spptr = chow;
+
+  (*B)->ops->ilufactorsymbolic = MatILUFactorSymbolic_SeqAIJ_ChowILU;
+  (*B)->ops->destroy           = MatDestroy_SeqAIJ_ChowILU;
+  (*B)->ops->view              = MatView_SeqAIJ_ChowILU;
+  ierr = PetscObjectComposeFunction((PetscObject)*B,"MatFactorGetSolverType_C",MatFactorGetSolverType_seqaij_chowilu);CHKERRQ(ierr);
+  (*B)->factortype = ftype;
+
+  ierr = PetscFree((*B)->solvertype);CHKERRQ(ierr);
+  ierr = PetscStrallocpy(MATSOLVERCHOWILU,&(*B)->solvertype);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
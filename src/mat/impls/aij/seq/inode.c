@@ -4,6 +4,9 @@
   by taking advantage of rows with identical nonzero structure (I-nodes).
 */
 #include <../src/mat/impls/aij/seq/aij.h>
+#if defined(MATINODE_USE_SIMD)
+#include <immintrin.h>
+#endif
 
 static PetscErrorCode MatCreateColInode_Private(Mat A,PetscInt *size,PetscInt **ns)
 {
@@ -748,6 +751,130 @@ static PetscErrorCode MatMultAdd_SeqAIJ_Inode(Mat A,Vec xx,Vec zz,Vec yy)
   PetscFunctionReturn(0);
 }
 
+#if defined(MATINODE_USE_SIMD)
+/*
+   Vectorized inode kernels, compiled instead of the unrolled scalar ones above when the target has AVX-512 or
+   AVX2 with FMA (for example with COPTFLAGS=-march=native). The nsz rows of an inode share their column indices,
+   so a group of 8 (AVX-512) or 4 (AVX2) entries of x is gathered once into a vector register and multiplied with
+   the values of every row of the node, each row accumulating into its own register.
+
+   dot[r] = sum_k v[r*stride+k]*x[idx[k]], r < nsz, k < len
+*/
+PETSC_STATIC_INLINE void MatInodeRowsDot_SIMD(const PetscInt nsz,PetscInt len,const PetscInt *idx,const MatScalar *v,PetscInt stride,const PetscScalar *x,PetscScalar *dot)
+{
+  PetscInt r,k = 0;
+#if defined(__AVX512F__)
+  __m512d  acc[5],vx;
+  __m256i  vi;
+
+  __mmask8 mask;
+
+  for (r=0; r<nsz; r++) acc[r] = _mm512_setzero_pd();
+  for (; k+8<=len; k+=8) {
+    vi = _mm256_loadu_si256((const __m256i*)(idx+k));
+    vx = _mm512_i32gather_pd(vi,x,8);
+    for (r=0; r<nsz; r++) acc[r] = _mm512_fmadd_pd(_mm512_loadu_pd(v+r*stride+k),vx,acc[r]);
+  }
+  if (k < len) { /* masked loads do not touch the entries past the end */
+    mask = (__mmask8)((1 << (len-k)) - 1);
+    vi   = _mm512_castsi512_si256(_mm512_maskz_loadu_epi32((__mmask16)mask,idx+k));
+    vx   = _mm512_mask_i32gather_pd(_mm512_setzero_pd(),mask,vi,x,8);
+    for (r=0; r<nsz; r++) acc[r] = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask,v+r*stride+k),vx,acc[r]);
+  }
+  for (r=0; r<nsz; r++) dot[r] = _mm512_reduce_add_pd(acc[r]);
+#else
+  __m256d  acc[5],vx;
+  __m128i  vi;
+  __m128d  h;
+
+  __m128i  mask32;
+  __m256i  mask;
+
+  for (r=0; r<nsz; r++) acc[r] = _mm256_setzero_pd();
+  for (; k+4<=len; k+=4) {
+    vi = _mm_loadu_si128((const __m128i*)(idx+k));
+    vx = _mm256_i32gather_pd(x,vi,8);
+    for (r=0; r<nsz; r++) acc[r] = _mm256_fmadd_pd(_mm256_loadu_pd(v+r*stride+k),vx,acc[r]);
+  }
+  if (k < len) { /* masked loads do not touch the entries past the end */
+    mask32 = _mm_cmpgt_epi32(_mm_set1_epi32((int)(len-k)),_mm_set_epi32(3,2,1,0));
+    mask   = _mm256_cvtepi32_epi64(mask32);
+    vi     = _mm_maskload_epi32((const int*)(idx+k),mask32);
+    vx     = _mm256_mask_i32gather_pd(_mm256_setzero_pd(),x,vi,_mm256_castsi256_pd(mask),8);
+    for (r=0; r<nsz; r++) acc[r] = _mm256_fmadd_pd(_mm256_maskload_pd(v+r*stride+k,mask),vx,acc[r]);
+  }
+  for (r=0; r<nsz; r++) {
+    h      = _mm_add_pd(_mm256_castpd256_pd128(acc[r]),_mm256_extractf128_pd(acc[r],1));
+    dot[r] = _mm_cvtsd_f64(_mm_add_sd(h,_mm_unpackhi_pd(h,h)));
+  }
+#endif
+}
+
+/* instantiates the kernel for each node size so the accumulators of the rows stay in registers */
+static PetscErrorCode MatInodeRowsDot_Private(PetscInt nsz,PetscInt len,const PetscInt *idx,const MatScalar *v,PetscInt stride,const PetscScalar *x,PetscScalar *dot)
+{
+  PetscFunctionBegin;
+  switch (nsz) {
+  case 1: MatInodeRowsDot_SIMD(1,len,idx,v,stride,x,dot); break;
+  case 2: MatInodeRowsDot_SIMD(2,len,idx,v,stride,x,dot); break;
+  case 3: MatInodeRowsDot_SIMD(3,len,idx,v,stride,x,dot); break;
+  case 4: MatInodeRowsDot_SIMD(4,len,idx,v,stride,x,dot); break;
+  case 5: MatInodeRowsDot_SIMD(5,len,idx,v,stride,x,dot); break;
+  default: SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Node size not yet supported");
+  }
+  PetscFunctionReturn(0);
+}
+
+/* y = A x when zz is NULL, y = z + A x otherwise */
+static PetscErrorCode MatMultAdd_SeqAIJ_Inode_SIMD(Mat A,Vec xx,Vec zz,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  const PetscScalar *x;
+  PetscScalar       *y,*z = NULL,dot[5];
+  PetscErrorCode    ierr;
+  PetscInt          i,r,n,row,nsz,node_max,nonzerorow = 0;
+  const PetscInt    *ns,*ii = a->i;
+
+  PetscFunctionBegin;
+  if (!a->inode.size) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Missing Inode Structure");
+  node_max = a->inode.node_count;
+  ns       = a->inode.size;
+  ierr     = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  if (zz) {
+    ierr = VecGetArrayPair(zz,yy,&z,&y);CHKERRQ(ierr);
+  } else {
+    ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  }
+  for (i=0,row=0; i<node_max; i++) {
+    nsz         = ns[i];
+    n           = ii[row+1] - ii[row];
+    nonzerorow += (n>0)*nsz;
+    ierr        = MatInodeRowsDot_Private(nsz,n,a->j+ii[row],a->a+ii[row],n,x,dot);CHKERRQ(ierr);
+    if (z) for (r=0; r<nsz; r++) y[row+r] = z[row+r] + dot[r];
+    else   for (r=0; r<nsz; r++) y[row+r] = dot[r];
+    row += nsz;
+  }
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  if (zz) {
+    ierr = VecRestoreArrayPair(zz,yy,&z,&y);CHKERRQ(ierr);
+    ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  } else {
+    ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+    ierr = PetscLogFlops(2.0*a->nz - nonzerorow);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMult_SeqAIJ_Inode_SIMD(Mat A,Vec xx,Vec yy)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMultAdd_SeqAIJ_Inode_SIMD(A,xx,NULL,yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
+
 /* ----------------------------------------------------------- */
 PetscErrorCode MatSolve_SeqAIJ_Inode_inplace(Mat A,Vec bb,Vec xx)
 {
@@ -1851,6 +1978,7 @@ PetscErrorCode MatLUFactorNumeric_SeqAIJ_Inode(Mat B,Mat A,const MatFactorInfo *
   C->ops->matsolve          = MatMatSolve_SeqAIJ;
   C->assembled              = PETSC_TRUE;
   C->preallocated           = PETSC_TRUE;
+  if (b->solvelevels.use) {ierr = MatSeqAIJSetUpSolveLevels_Private(C);CHKERRQ(ierr);}
 
   ierr = PetscLogFlops(C->cmap->n);CHKERRQ(ierr);
 
@@ -2719,86 +2847,99 @@ PetscErrorCode MatColoringPatch_SeqAIJ_Inode(Mat mat,PetscInt ncolors,PetscInt n
 
 #include <petsc/private/kernels/blockinvert.h>
 
+/* copies the diagonal blocks of the inodes to bdiag and their inverses to ibdiag, used by MatSOR_SeqAIJ_Inode() */
+static PetscErrorCode MatInodeInvertDiagonalBlocks_Private(Mat A)
+{
+  Mat_SeqAIJ      *a = (Mat_SeqAIJ*)A->data;
+  MatScalar       *ibdiag,*bdiag,work[25];
+  const MatScalar *v = a->a;
+  PetscReal       zeropivot = 100.*PETSC_MACHINE_EPSILON, shift = 0.0;
+  PetscErrorCode  ierr;
+  PetscInt        m = a->inode.node_count,cnt = 0,i,j,k,row,ipvt[5];
+  PetscBool       allowzeropivot,zeropivotdetected;
+  const PetscInt  *sizes = a->inode.size,*diag = a->diag;
+
+  PetscFunctionBegin;
+  if (a->inode.ibdiagvalid) PetscFunctionReturn(0);
+  allowzeropivot = PetscNot(A->erroriffailure);
+  if (!a->inode.ibdiag) {
+    /* calculate space needed for diagonal blocks */
+    for (i=0; i<m; i++) {
+      cnt += sizes[i]*sizes[i];
+    }
+    a->inode.bdiagsize = cnt;
+
+    ierr = PetscMalloc3(cnt,&a->inode.ibdiag,cnt,&a->inode.bdiag,A->rmap->n,&a->inode.ssor_work);CHKERRQ(ierr);
+  }
+
+  /* copy over the diagonal blocks and invert them */
+  ibdiag = a->inode.ibdiag;
+  bdiag  = a->inode.bdiag;
+  cnt    = 0;
+  for (i=0, row = 0; i<m; i++) {
+    for (j=0; j<sizes[i]; j++) {
+      for (k=0; k<sizes[i]; k++) {
+        bdiag[cnt+k*sizes[i]+j] = v[diag[row+j] - j + k];
+      }
+    }
+    ierr = PetscMemcpy(ibdiag+cnt,bdiag+cnt,sizes[i]*sizes[i]*sizeof(MatScalar));CHKERRQ(ierr);
+
+    switch (sizes[i]) {
+    case 1:
+      /* Create matrix data structure */
+      if (PetscAbsScalar(ibdiag[cnt]) < zeropivot) {
+        if (allowzeropivot) {
+          A->factorerrortype = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+          A->factorerror_zeropivot_value = PetscAbsScalar(ibdiag[cnt]);
+          A->factorerror_zeropivot_row   = row;
+          ierr = PetscInfo1(A,"Zero pivot, row %D\n",row);CHKERRQ(ierr);
+        } else SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_MAT_LU_ZRPVT,"Zero pivot on row %D",row);
+      }
+      ibdiag[cnt] = 1.0/ibdiag[cnt];
+      break;
+    case 2:
+      ierr = PetscKernel_A_gets_inverse_A_2(ibdiag+cnt,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      if (zeropivotdetected) A->factorerrortype = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+      break;
+    case 3:
+      ierr = PetscKernel_A_gets_inverse_A_3(ibdiag+cnt,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      if (zeropivotdetected) A->factorerrortype = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+      break;
+    case 4:
+      ierr = PetscKernel_A_gets_inverse_A_4(ibdiag+cnt,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      if (zeropivotdetected) A->factorerrortype = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+      break;
+    case 5:
+      ierr = PetscKernel_A_gets_inverse_A_5(ibdiag+cnt,ipvt,work,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      if (zeropivotdetected) A->factorerrortype = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+      break;
+    default:
+      SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SUP,"Inode size %D not supported",sizes[i]);
+    }
+    cnt += sizes[i]*sizes[i];
+    row += sizes[i];
+  }
+  a->inode.ibdiagvalid = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatSOR_SeqAIJ_Inode(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
 {
   Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
   PetscScalar       sum1 = 0.0,sum2 = 0.0,sum3 = 0.0,sum4 = 0.0,sum5 = 0.0,tmp0,tmp1,tmp2,tmp3;
-  MatScalar         *ibdiag,*bdiag,work[25],*t;
+  MatScalar         *ibdiag,*bdiag,*t;
   PetscScalar       *x,tmp4,tmp5,x1,x2,x3,x4,x5;
-  const MatScalar   *v = a->a,*v1 = NULL,*v2 = NULL,*v3 = NULL,*v4 = NULL,*v5 = NULL;
+  const MatScalar   *v1 = NULL,*v2 = NULL,*v3 = NULL,*v4 = NULL,*v5 = NULL;
   const PetscScalar *xb, *b;
-  PetscReal         zeropivot = 100.*PETSC_MACHINE_EPSILON, shift = 0.0;
   PetscErrorCode    ierr;
-  PetscInt          n,m = a->inode.node_count,cnt = 0,i,j,row,i1,i2;
-  PetscInt          sz,k,ipvt[5];
-  PetscBool         allowzeropivot,zeropivotdetected;
+  PetscInt          n,m = a->inode.node_count,cnt,i,row,i1,i2,sz;
   const PetscInt    *sizes = a->inode.size,*idx,*diag = a->diag,*ii = a->i;
 
   PetscFunctionBegin;
-  allowzeropivot = PetscNot(A->erroriffailure);
   if (omega != 1.0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No support for omega != 1.0; use -mat_no_inode");
   if (fshift != 0.0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No support for fshift != 0.0; use -mat_no_inode");
 
-  if (!a->inode.ibdiagvalid) {
-    if (!a->inode.ibdiag) {
-      /* calculate space needed for diagonal blocks */
-      for (i=0; i<m; i++) {
-        cnt += sizes[i]*sizes[i];
-      }
-      a->inode.bdiagsize = cnt;
-
-      ierr = PetscMalloc3(cnt,&a->inode.ibdiag,cnt,&a->inode.bdiag,A->rmap->n,&a->inode.ssor_work);CHKERRQ(ierr);
-    }
-
-    /* copy over the diagonal blocks and invert them */
-    ibdiag = a->inode.ibdiag;
-    bdiag  = a->inode.bdiag;
-    cnt    = 0;
-    for (i=0, row = 0; i<m; i++) {
-      for (j=0; j<sizes[i]; j++) {
-        for (k=0; k<sizes[i]; k++) {
-          bdiag[cnt+k*sizes[i]+j] = v[diag[row+j] - j + k];
-        }
-      }
-      ierr = PetscMemcpy(ibdiag+cnt,bdiag+cnt,sizes[i]*sizes[i]*sizeof(MatScalar));CHKERRQ(ierr);
-
-      switch (sizes[i]) {
-      case 1:
-        /* Create matrix data structure */
-        if (PetscAbsScalar(ibdiag[cnt]) < zeropivot) {
-          if (allowzeropivot) {
-            A->factorerrortype = MAT_FACTOR_NUMERIC_ZEROPIVOT;
-            A->factorerror_zeropivot_value = PetscAbsScalar(ibdiag[cnt]);
-            A->factorerror_zeropivot_row   = row;
-            ierr = PetscInfo1(A,"Zero pivot, row %D\n",row);CHKERRQ(ierr);
-          } else SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_MAT_LU_ZRPVT,"Zero pivot on row %D",row);
-        }
-        ibdiag[cnt] = 1.0/ibdiag[cnt];
-        break;
-      case 2:
-        ierr = PetscKernel_A_gets_inverse_A_2(ibdiag+cnt,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
-        if (zeropivotdetected) A->factorerrortype = MAT_FACTOR_NUMERIC_ZEROPIVOT;
-        break;
-      case 3:
-        ierr = PetscKernel_A_gets_inverse_A_3(ibdiag+cnt,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
-        if (zeropivotdetected) A->factorerrortype = MAT_FACTOR_NUMERIC_ZEROPIVOT;
-        break;
-      case 4:
-        ierr = PetscKernel_A_gets_inverse_A_4(ibdiag+cnt,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
-        if (zeropivotdetected) A->factorerrortype = MAT_FACTOR_NUMERIC_ZEROPIVOT;
-        break;
-      case 5:
-        ierr = PetscKernel_A_gets_inverse_A_5(ibdiag+cnt,ipvt,work,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
-        if (zeropivotdetected) A->factorerrortype = MAT_FACTOR_NUMERIC_ZEROPIVOT;
-        break;
-      default:
-        SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SUP,"Inode size %D not supported",sizes[i]);
-      }
-      cnt += sizes[i]*sizes[i];
-      row += sizes[i];
-    }
-    a->inode.ibdiagvalid = PETSC_TRUE;
-  }
+  ierr   = MatInodeInvertDiagonalBlocks_Private(A);CHKERRQ(ierr);
   ibdiag = a->inode.ibdiag;
   bdiag  = a->inode.bdiag;
   t      = a->inode.ssor_work;
@@ -3971,6 +4112,87 @@ PetscErrorCode MatSOR_SeqAIJ_Inode(Mat A,Vec bb,PetscReal omega,MatSORType flag,
   PetscFunctionReturn(0);
 }
 
+#if defined(MATINODE_USE_SIMD)
+/*
+   Same sweeps as MatSOR_SeqAIJ_Inode() with the sums over the lower and upper parts of the rows of an inode
+   computed by MatInodeRowsDot_Private(). The columns of the diagonal block are at the same place in every row
+   of the node, so the lower part of each row is its first lo entries and the upper part its last n-lo-nsz.
+   The Eisenstat trick is left to MatSOR_SeqAIJ_Inode().
+*/
+static PetscErrorCode MatSOR_SeqAIJ_Inode_SIMD(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscScalar       *x,*t,s[5],dl[5],du[5];
+  const PetscScalar *b,*xb;
+  const MatScalar   *ibdiag;
+  PetscErrorCode    ierr;
+  PetscInt          i,p,q,n,lo,up,nsz,row,m = a->inode.node_count;
+  const PetscInt    *sizes = a->inode.size,*diag = a->diag,*ii = a->i;
+  PetscBool         zeroguess = (flag & SOR_ZERO_INITIAL_GUESS) ? PETSC_TRUE : PETSC_FALSE;
+
+  PetscFunctionBegin;
+  if (flag & SOR_EISENSTAT) {
+    ierr = MatSOR_SeqAIJ_Inode(A,bb,omega,flag,fshift,its,lits,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (omega != 1.0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No support for omega != 1.0; use -mat_no_inode");
+  if (fshift != 0.0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No support for fshift != 0.0; use -mat_no_inode");
+
+  ierr = MatInodeInvertDiagonalBlocks_Private(A);CHKERRQ(ierr);
+  t    = a->inode.ssor_work;
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  while (its--) {
+    xb = b;
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i=0, row=0, ibdiag=a->inode.ibdiag; i<m; row+=nsz, ibdiag+=nsz*nsz, i++) {
+        nsz  = sizes[i];
+        n    = ii[row+1] - ii[row];
+        lo   = diag[row] - ii[row];
+        up   = lo + nsz;
+        ierr = MatInodeRowsDot_Private(nsz,lo,a->j+ii[row],a->a+ii[row],n,x,dl);CHKERRQ(ierr);
+        for (p=0; p<nsz; p++) t[row+p] = s[p] = b[row+p] - dl[p];
+        if (!zeroguess) {
+          ierr = MatInodeRowsDot_Private(nsz,n-up,a->j+ii[row]+up,a->a+ii[row]+up,n,x,du);CHKERRQ(ierr);
+          for (p=0; p<nsz; p++) s[p] -= du[p];
+        }
+        for (p=0; p<nsz; p++) {
+          x[row+p] = 0.0;
+          for (q=0; q<nsz; q++) x[row+p] += s[q]*ibdiag[q*nsz+p];
+        }
+      }
+      xb   = t;
+      ierr = PetscLogFlops(zeroguess ? a->nz : 2.0*a->nz);CHKERRQ(ierr);
+    }
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i=m-1, row=A->rmap->n, ibdiag=a->inode.ibdiag+a->inode.bdiagsize; i>=0; i--) {
+        nsz     = sizes[i];
+        row    -= nsz;
+        ibdiag -= nsz*nsz;
+        n       = ii[row+1] - ii[row];
+        lo      = diag[row] - ii[row];
+        up      = lo + nsz;
+        ierr    = MatInodeRowsDot_Private(nsz,n-up,a->j+ii[row]+up,a->a+ii[row]+up,n,x,du);CHKERRQ(ierr);
+        for (p=0; p<nsz; p++) s[p] = xb[row+p] - du[p];
+        if (xb == b && !zeroguess) {
+          ierr = MatInodeRowsDot_Private(nsz,lo,a->j+ii[row],a->a+ii[row],n,x,dl);CHKERRQ(ierr);
+          for (p=0; p<nsz; p++) s[p] -= dl[p];
+        }
+        for (p=0; p<nsz; p++) {
+          x[row+p] = 0.0;
+          for (q=0; q<nsz; q++) x[row+p] += s[q]*ibdiag[q*nsz+p];
+        }
+      }
+      ierr = PetscLogFlops((xb == b && !zeroguess) ? 2.0*a->nz : a->nz);CHKERRQ(ierr);
+    }
+    zeroguess = PETSC_FALSE;
+  }
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
+
 PetscErrorCode MatMultDiagonalBlock_SeqAIJ_Inode(Mat A,Vec bb,Vec xx)
 {
   Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
@@ -4107,6 +4329,13 @@ PetscErrorCode MatSeqAIJCheckInode(Mat A)
       A->ops->mult              = MatMult_SeqAIJ_Inode;
       A->ops->sor               = MatSOR_SeqAIJ_Inode;
       A->ops->multadd           = MatMultAdd_SeqAIJ_Inode;
+#if defined(MATINODE_USE_SIMD)
+      if (a->inode.simd) {
+        A->ops->mult              = MatMult_SeqAIJ_Inode_SIMD;
+        A->ops->sor               = MatSOR_SeqAIJ_Inode_SIMD;
+        A->ops->multadd           = MatMultAdd_SeqAIJ_Inode_SIMD;
+      }
+#endif
       A->ops->multdiagonalblock = MatMultDiagonalBlock_SeqAIJ_Inode;
       if (A->rmap->n == A->cmap->n) {
         A->ops->getrowij          = MatGetRowIJ_SeqAIJ_Inode;
@@ -4138,6 +4367,7 @@ PetscErrorCode MatDuplicate_SeqAIJ_Inode(Mat A,MatDuplicateOption cpvalues,Mat *
   c->inode.use       = a->inode.use;
   c->inode.limit     = a->inode.limit;
   c->inode.max_limit = a->inode.max_limit;
+  c->inode.simd      = a->inode.simd;
   if (a->inode.size) {
     ierr                = PetscMalloc1(m+1,&c->inode.size);CHKERRQ(ierr);
     c->inode.node_count = a->inode.node_count;
@@ -4147,6 +4377,13 @@ PetscErrorCode MatDuplicate_SeqAIJ_Inode(Mat A,MatDuplicateOption cpvalues,Mat *
       B->ops->mult              = MatMult_SeqAIJ_Inode;
       B->ops->sor               = MatSOR_SeqAIJ_Inode;
       B->ops->multadd           = MatMultAdd_SeqAIJ_Inode;
+#if defined(MATINODE_USE_SIMD)
+      if (c->inode.simd) {
+        B->ops->mult              = MatMult_SeqAIJ_Inode_SIMD;
+        B->ops->sor               = MatSOR_SeqAIJ_Inode_SIMD;
+        B->ops->multadd           = MatMultAdd_SeqAIJ_Inode_SIMD;
+      }
+#endif
       B->ops->getrowij          = MatGetRowIJ_SeqAIJ_Inode;
       B->ops->restorerowij      = MatRestoreRowIJ_SeqAIJ_Inode;
       B->ops->getcolumnij       = MatGetColumnIJ_SeqAIJ_Inode;
@@ -68,6 +68,7 @@ PetscErrorCode MatCreate_SeqAIJ_Inode(Mat B)
   b->inode.size        = 0;
   b->inode.limit       = 5;
   b->inode.max_limit   = 5;
+  b->inode.simd        = PETSC_TRUE;
   b->inode.ibdiagvalid = PETSC_FALSE;
   b->inode.ibdiag      = 0;
   b->inode.bdiag       = 0;
@@ -82,7 +83,11 @@ PetscErrorCode MatCreate_SeqAIJ_Inode(Mat B)
     ierr = PetscInfo(B,"Not using Inode routines due to -mat_no_inode\n");CHKERRQ(ierr);
   }
   ierr = PetscOptionsInt("-mat_inode_limit","Do not use inodes larger then this value",NULL,b->inode.limit,&b->inode.limit,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-mat_inode_simd","Use the AVX2/AVX-512 inode kernels if PETSc was compiled for them",NULL,b->inode.simd,&b->inode.simd,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsEnd();CHKERRQ(ierr);
+#if !defined(MATINODE_USE_SIMD)
+  b->inode.simd = PETSC_FALSE;
+#endif
 
   b->inode.use = (PetscBool)(!(no_unroll || no_inode));
   if (b->inode.limit > b->inode.max_limit) b->inode.limit = b->inode.max_limit;
@@ -45,11 +45,11 @@
  {
    PetscErrorCode ierr;
  #if !defined(PETSC_HAVE_HYPRE)
-   const char     *algTypes[8] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","combined","rowmerge"};
-   PetscInt       nalg = 8;
- #else
-   const char     *algTypes[9] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","combined","rowmerge","hypre"};
+   const char     *algTypes[9] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","combined","rowmerge","hash"};
    PetscInt       nalg = 9;
+ #else
+   const char     *algTypes[10] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","combined","rowmerge","hash","hypre"};
+   PetscInt       nalg = 10;
  #endif
    PetscInt       alg = 0; /* set default algorithm */
 
@@ -79,8 +79,11 @@
    case 7:
      ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_RowMerge(A,B,fill,C);CHKERRQ(ierr);
      break;
- #if defined(PETSC_HAVE_HYPRE)
    case 8:
+     ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_Hash(A,B,fill,C);CHKERRQ(ierr);
+     break;
+ #if defined(PETSC_HAVE_HYPRE)
+   case 9:
      ierr = MatMatMultSymbolic_AIJ_AIJ_wHYPRE(A,B,fill,C);CHKERRQ(ierr);
      break;
  #endif
@@ -1016,6 +1019,222 @@ PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_RowMerge(Mat A,Mat B,PetscReal f
   PetscFunctionReturn(0);
 }
 
+/*
+   The "hash" algorithm builds each row of C = A*B in an open addressing hash table with linear probing instead of a
+   dense or linked-list accumulator, so its work space only depends on the number of nonzeros in a row of C and not
+   on the number of columns of B. The table for a row is a power of two at least twice the size of an upper bound of
+   the number of nonzeros in the row (the sum of the lengths of the rows of B it combines), empty slots hold -1.
+
+   The symbolic phase makes two passes over the rows, one to count the nonzeros of each row and one to list and sort
+   them, and the numeric phase fills each row of C through a table mapping its columns to their positions. The rows
+   are independent so all passes run threaded (with a table per thread) when PETSc is configured with OpenMP.
+*/
+#if defined(PETSC_HAVE_OPENMP)
+#define MatMatMultHashThread_Private() omp_get_thread_num()
+#else
+#define MatMatMultHashThread_Private() 0
+#endif
+
+PETSC_STATIC_INLINE PetscInt MatMatMultHashSize_Private(PetscInt nz)
+{
+  PetscInt size = 8;
+  while (size < 2*nz) size *= 2;
+  return size;
+}
+
+#define MatMatMultHash_Private(col,mask) ((PetscInt)(((size_t)(col)*(size_t)2654435761U) & (size_t)(mask)))
+
+static int MatMatMultHashThreads_Private(PetscInt n)
+{
+#if defined(PETSC_HAVE_OPENMP)
+  if (PetscOMPUseThreads(n)) return omp_get_max_threads();
+#endif
+  return 1;
+}
+
+/* number of distinct columns in row i of C, copied into cjj in the order they are found when cjj is not NULL */
+PETSC_STATIC_INLINE PetscInt MatMatMultSymbolicRow_Hash_Private(const PetscInt *ai,const PetscInt *aj,const PetscInt *bi,const PetscInt *bj,PetscInt i,PetscInt size,PetscInt *table,PetscInt *cjj)
+{
+  PetscInt j,k,h,col,brow,mask = size-1,nz = 0;
+
+  for (k=0; k<size; k++) table[k] = -1;
+  for (j=ai[i]; j<ai[i+1]; j++) {
+    brow = aj[j];
+    for (k=bi[brow]; k<bi[brow+1]; k++) {
+      col = bj[k];
+      h   = MatMatMultHash_Private(col,mask);
+      while (table[h] != col && table[h] != -1) h = (h+1) & mask;
+      if (table[h] == -1) {
+        table[h] = col;
+        if (cjj) cjj[nz] = col;
+        nz++;
+      }
+    }
+  }
+  return nz;
+}
+
+/* shell sort of the columns of a row; it makes no PETSc calls (PetscSortInt() pushes on the PetscStack) so threads may call it */
+PETSC_STATIC_INLINE void MatMatMultSortRow_Hash_Private(PetscInt n,PetscInt *x)
+{
+  PetscInt gap = 1,i,j,t;
+
+  while (gap < n/3) gap = 3*gap+1;
+  for (; gap>0; gap /= 3) {
+    for (i=gap; i<n; i++) {
+      t = x[i];
+      for (j=i; j>=gap && x[j-gap] > t; j -= gap) x[j] = x[j-gap];
+      x[j] = t;
+    }
+  }
+}
+
+PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Hash(Mat A,Mat B,PetscReal fill,Mat *C)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data,*c;
+  const PetscInt *ai = a->i,*aj = a->j,*bi = b->i,*bj = b->j;
+  PetscInt       *ci,*cj,*work;
+  PetscInt       am = A->rmap->N,bn = B->cmap->N,bm = B->rmap->N;
+  PetscInt       i,ubmax = 0,cnzmax = 0,tsize;
+  MatScalar      *ca;
+  PetscReal      afill;
+  int            nt;
+
+  PetscFunctionBegin;
+  nt   = MatMatMultHashThreads_Private(ai[am]);
+  ierr = PetscMalloc1(am+1,&ci);CHKERRQ(ierr);
+  ci[0] = 0;
+
+  /* row-wise upper bound of the number of nonzeros in C, which sizes the tables of the first pass */
+  PetscPragmaOMP(parallel for schedule(static) num_threads(nt) if(nt > 1) reduction(max:ubmax))
+  for (i=0; i<am; i++) {
+    PetscInt j,ub = 0;
+    for (j=ai[i]; j<ai[i+1]; j++) ub += bi[aj[j]+1] - bi[aj[j]];
+    ub = PetscMin(ub,bn);
+    ci[i+1] = ub;
+    if (ub > ubmax) ubmax = ub;
+  }
+  tsize = MatMatMultHashSize_Private(ubmax);
+  ierr  = PetscMalloc1(nt*tsize,&work);CHKERRQ(ierr);
+
+  /* first pass: count the nonzeros of each row */
+  PetscPragmaOMP(parallel for schedule(dynamic,64) num_threads(nt) if(nt > 1))
+  for (i=0; i<am; i++) {
+    PetscInt *table = work + MatMatMultHashThread_Private()*tsize;
+    ci[i+1] = MatMatMultSymbolicRow_Hash_Private(ai,aj,bi,bj,i,MatMatMultHashSize_Private(ci[i+1]),table,NULL);
+  }
+  for (i=0; i<am; i++) {
+    cnzmax   = PetscMax(cnzmax,ci[i+1]);
+    ci[i+1] += ci[i];
+  }
+  ierr = PetscMalloc1(ci[am]+1,&cj);CHKERRQ(ierr);
+  ierr = PetscMalloc1(ci[am]+1,&ca);CHKERRQ(ierr);
+
+  /* second pass: list and sort the columns of each row, with tables sized from the exact counts */
+  PetscPragmaOMP(parallel for schedule(dynamic,64) num_threads(nt) if(nt > 1))
+  for (i=0; i<am; i++) {
+    PetscInt *table = work + MatMatMultHashThread_Private()*tsize,k,cnz = ci[i+1] - ci[i];
+
+    MatMatMultSymbolicRow_Hash_Private(ai,aj,bi,bj,i,MatMatMultHashSize_Private(cnz),table,cj+ci[i]);
+    MatMatMultSortRow_Hash_Private(cnz,cj+ci[i]);
+    for (k=ci[i]; k<ci[i+1]; k++) ca[k] = 0.0;
+  }
+  ierr = PetscFree(work);CHKERRQ(ierr);
+
+  /* put together the new symbolic matrix */
+  ierr = MatCreateSeqAIJWithArrays(PetscObjectComm((PetscObject)A),am,bn,ci,cj,ca,C);CHKERRQ(ierr);
+  ierr = MatSetBlockSizesFromMats(*C,A,B);CHKERRQ(ierr);
+  ierr = MatSetType(*C,((PetscObject)A)->type_name);CHKERRQ(ierr);
+
+  /* MatCreateSeqAIJWithArrays flags matrix so PETSc doesn't free the user's arrays. */
+  /* These are PETSc arrays, so change flags so arrays can be deleted by PETSc */
+  c          = (Mat_SeqAIJ*)((*C)->data);
+  c->free_a  = PETSC_TRUE;
+  c->free_ij = PETSC_TRUE;
+  c->nonew   = 0;
+
+  (*C)->ops->matmultnumeric = MatMatMultNumeric_SeqAIJ_SeqAIJ_Hash;
+
+  /* set MatInfo */
+  afill = (PetscReal)ci[am]/(ai[am]+bi[bm]) + 1.e-5;
+  if (afill < 1.0) afill = 1.0;
+  c->maxnz                     = ci[am];
+  c->nz                        = ci[am];
+  (*C)->info.mallocs           = 0;
+  (*C)->info.fill_ratio_given  = fill;
+  (*C)->info.fill_ratio_needed = afill;
+
+#if defined(PETSC_USE_INFO)
+  if (ci[am]) {
+    ierr = PetscInfo5((*C),"Hash tables of %D entries on %d threads, longest row %D; Fill ratio: given %g needed %g.\n",tsize,nt,cnzmax,(double)fill,(double)afill);CHKERRQ(ierr);
+  } else {
+    ierr = PetscInfo((*C),"Empty matrix product\n");CHKERRQ(ierr);
+  }
+#endif
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Hash(Mat A,Mat B,Mat C)
+{
+  PetscErrorCode  ierr;
+  PetscLogDouble  flops = 0.0;
+  Mat_SeqAIJ      *a = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data,*c = (Mat_SeqAIJ*)C->data;
+  const PetscInt  *ai = a->i,*aj = a->j,*bi = b->i,*bj = b->j,*ci = c->i,*cj = c->j;
+  const MatScalar *aa = a->a,*ba = b->a;
+  PetscInt        am = A->rmap->N,cm = C->rmap->N,i,cnzmax = 0,tsize,nmissing = 0,*work;
+  MatScalar       *ca = c->a;
+  int             nt;
+
+  PetscFunctionBegin;
+  if (!ca) {
+    ierr      = PetscMalloc1(ci[cm]+1,&ca);CHKERRQ(ierr);
+    c->a      = ca;
+    c->free_a = PETSC_TRUE;
+  }
+  for (i=0; i<cm; i++) cnzmax = PetscMax(cnzmax,ci[i+1]-ci[i]);
+  nt    = MatMatMultHashThreads_Private(ai[am]);
+  tsize = MatMatMultHashSize_Private(cnzmax);
+  ierr  = PetscMalloc1(2*nt*tsize,&work);CHKERRQ(ierr);
+
+  /* the table of a row maps its columns (first half) to their positions in the row (second half) */
+  PetscPragmaOMP(parallel for schedule(dynamic,64) num_threads(nt) if(nt > 1) reduction(+:flops,nmissing))
+  for (i=0; i<am; i++) {
+    PetscInt  *table = work + 2*MatMatMultHashThread_Private()*tsize,*pos = table + tsize;
+    PetscInt  j,k,h,col,brow,cnz = ci[i+1] - ci[i],size = MatMatMultHashSize_Private(cnz),mask = size-1;
+    MatScalar *crow = ca + ci[i],aval;
+
+    for (k=0; k<size; k++) table[k] = -1;
+    for (k=0; k<cnz; k++) {
+      col = cj[ci[i]+k];
+      h   = MatMatMultHash_Private(col,mask);
+      while (table[h] != -1) h = (h+1) & mask;
+      table[h] = col;
+      pos[h]   = k;
+      crow[k]  = 0.0;
+    }
+    for (j=ai[i]; j<ai[i+1]; j++) {
+      brow = aj[j];
+      aval = aa[j];
+      for (k=bi[brow]; k<bi[brow+1]; k++) {
+        col = bj[k];
+        h   = MatMatMultHash_Private(col,mask);
+        while (table[h] != col && table[h] != -1) h = (h+1) & mask;
+        if (table[h] == -1) nmissing++;
+        else crow[pos[h]] += aval*ba[k];
+      }
+      flops += 2*(bi[brow+1] - bi[brow]);
+    }
+  }
+  ierr = PetscFree(work);CHKERRQ(ierr);
+  if (nmissing) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"%D products are not in the nonzero pattern of C, the nonzero pattern of A or B changed since the symbolic product",nmissing);
+
+  ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /* concatenate unique entries and then sort */
 PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Sorted(Mat A,Mat B,PetscReal fill,Mat *C)
 {
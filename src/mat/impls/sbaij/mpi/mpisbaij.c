@@ -988,79 +988,30 @@ static PetscErrorCode MatView_MPISBAIJ_Binary(Mat mat,PetscViewer viewer)
   Mat_SeqSBAIJ   *A = (Mat_SeqSBAIJ*)a->A->data;
   Mat_SeqBAIJ    *B = (Mat_SeqBAIJ*)a->B->data;
   PetscErrorCode ierr;
-  PetscInt       i,*row_lens,*crow_lens,bs = mat->rmap->bs,j,k,bs2=a->bs2,header[4],nz,rlen;
-  PetscInt       *range=0,nzmax,*column_indices,cnt,col,*garray = a->garray,cstart = mat->cmap->rstart/bs,len,pcnt,l,ll;
-  int            fd;
+  PetscInt       i,*row_lens,bs = mat->rmap->bs,j,k,bs2=a->bs2,header[4],nz,rlen;
+  PetscInt       *column_indices,cnt,col,*garray = a->garray,cstart = mat->cmap->rstart/bs,len,pcnt,l,ll;
   PetscScalar    *column_values;
   FILE           *file;
-  PetscMPIInt    rank,size,tag = ((PetscObject)viewer)->tag;
-  PetscInt       message_count,flowcontrolcount;
 
   PetscFunctionBegin;
-  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)mat),&rank);CHKERRQ(ierr);
-  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)mat),&size);CHKERRQ(ierr);
-  nz   = bs2*(A->nz + B->nz);
-  rlen = mat->rmap->n;
-  ierr = PetscViewerBinaryGetDescriptor(viewer,&fd);CHKERRQ(ierr);
-  if (!rank) {
-    header[0] = MAT_FILE_CLASSID;
-    header[1] = mat->rmap->N;
-    header[2] = mat->cmap->N;
-
-    ierr = MPI_Reduce(&nz,&header[3],1,MPIU_INT,MPI_SUM,0,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-    ierr = PetscBinaryWrite(fd,header,4,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
-    /* get largest number of rows any processor has */
-    range = mat->rmap->range;
-    for (i=1; i<size; i++) {
-      rlen = PetscMax(rlen,range[i+1] - range[i]);
-    }
-  } else {
-    ierr = MPI_Reduce(&nz,0,1,MPIU_INT,MPI_SUM,0,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
+  nz        = bs2*(A->nz + B->nz);
+  header[0] = MAT_FILE_CLASSID;
+  header[1] = mat->rmap->N;
+  header[2] = mat->cmap->N;
+  ierr = MPIU_Allreduce(&nz,&header[3],1,MPIU_INT,MPI_SUM,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
+  ierr = PetscViewerBinaryWrite(viewer,header,4,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
+
+  /* store the lengths of each point row to the file, each process writes the rows it owns */
+  ierr = PetscMalloc1(mat->rmap->n+1,&row_lens);CHKERRQ(ierr);
+  for (i=0; i<a->mbs; i++) {
+    rlen = bs*(A->i[i+1] - A->i[i] + B->i[i+1] - B->i[i]);
+    for (j=0; j<bs; j++) row_lens[i*bs+j] = rlen;
   }
+  ierr = PetscViewerBinaryWriteAll(viewer,row_lens,mat->rmap->n,mat->rmap->rstart,mat->rmap->N,PETSC_INT);CHKERRQ(ierr);
+  ierr = PetscFree(row_lens);CHKERRQ(ierr);
 
-  ierr = PetscMalloc1(rlen/bs,&crow_lens);CHKERRQ(ierr);
-  /* compute lengths of each row  */
-  for (i=0; i<a->mbs; i++) {
-    crow_lens[i] = A->i[i+1] - A->i[i] + B->i[i+1] - B->i[i];
-  }
-  /* store the row lengths to the file */
-  ierr = PetscViewerFlowControlStart(viewer,&message_count,&flowcontrolcount);CHKERRQ(ierr);
-  if (!rank) {
-    MPI_Status status;
-    ierr = PetscMalloc1(rlen,&row_lens);CHKERRQ(ierr);
-    rlen = (range[1] - range[0])/bs;
-    for (i=0; i<rlen; i++) {
-      for (j=0; j<bs; j++) {
-        row_lens[i*bs+j] = bs*crow_lens[i];
-      }
-    }
-    ierr = PetscBinaryWrite(fd,row_lens,bs*rlen,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
-    for (i=1; i<size; i++) {
-      rlen = (range[i+1] - range[i])/bs;
-      ierr = PetscViewerFlowControlStepMaster(viewer,i,&message_count,flowcontrolcount);CHKERRQ(ierr);
-      ierr = MPI_Recv(crow_lens,rlen,MPIU_INT,i,tag,PetscObjectComm((PetscObject)mat),&status);CHKERRQ(ierr);
-      for (k=0; k<rlen; k++) {
-        for (j=0; j<bs; j++) {
-          row_lens[k*bs+j] = bs*crow_lens[k];
-        }
-      }
-      ierr = PetscBinaryWrite(fd,row_lens,bs*rlen,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
-    }
-    ierr = PetscViewerFlowControlEndMaster(viewer,&message_count);CHKERRQ(ierr);
-    ierr = PetscFree(row_lens);CHKERRQ(ierr);
-  } else {
-    ierr = PetscViewerFlowControlStepWorker(viewer,rank,&message_count);CHKERRQ(ierr);
-    ierr = MPI_Send(crow_lens,mat->rmap->n/bs,MPIU_INT,0,tag,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-    ierr = PetscViewerFlowControlEndWorker(viewer,&message_count);CHKERRQ(ierr);
-  }
-  ierr = PetscFree(crow_lens);CHKERRQ(ierr);
-
-  /* load up the local column indices. Include for all rows not just one for each block row since process 0 does not have the
-     information needed to make it for each row from a block row. This does require more communication but still not more than
-     the communication needed for the nonzero values  */
-  nzmax = nz; /*  space a largest processor needs */
-  ierr  = MPI_Reduce(&nz,&nzmax,1,MPIU_INT,MPI_MAX,0,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-  ierr  = PetscMalloc1(nzmax,&column_indices);CHKERRQ(ierr);
+  /* load up the local column indices. Include for all rows not just one for each block row */
+  ierr  = PetscMalloc1(nz+1,&column_indices);CHKERRQ(ierr);
   cnt   = 0;
   for (i=0; i<a->mbs; i++) {
     pcnt = cnt;
@@ -1087,29 +1038,11 @@ static PetscErrorCode MatView_MPISBAIJ_Binary(Mat mat,PetscViewer viewer)
     }
   }
   if (cnt != nz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_LIB,"Internal PETSc error: cnt = %D nz = %D",cnt,nz);
-
-  /* store the columns to the file */
-  ierr = PetscViewerFlowControlStart(viewer,&message_count,&flowcontrolcount);CHKERRQ(ierr);
-  if (!rank) {
-    MPI_Status status;
-    ierr = PetscBinaryWrite(fd,column_indices,nz,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
-    for (i=1; i<size; i++) {
-      ierr = PetscViewerFlowControlStepMaster(viewer,i,&message_count,flowcontrolcount);CHKERRQ(ierr);
-      ierr = MPI_Recv(&cnt,1,MPIU_INT,i,tag,PetscObjectComm((PetscObject)mat),&status);CHKERRQ(ierr);
-      ierr = MPI_Recv(column_indices,cnt,MPIU_INT,i,tag,PetscObjectComm((PetscObject)mat),&status);CHKERRQ(ierr);
-      ierr = PetscBinaryWrite(fd,column_indices,cnt,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
-    }
-    ierr = PetscViewerFlowControlEndMaster(viewer,&message_count);CHKERRQ(ierr);
-  } else {
-    ierr = PetscViewerFlowControlStepWorker(viewer,rank,&message_count);CHKERRQ(ierr);
-    ierr = MPI_Send(&cnt,1,MPIU_INT,0,tag,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-    ierr = MPI_Send(column_indices,cnt,MPIU_INT,0,tag,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-    ierr = PetscViewerFlowControlEndWorker(viewer,&message_count);CHKERRQ(ierr);
-  }
+  ierr = PetscViewerBinaryWriteAll(viewer,column_indices,nz,PETSC_DETERMINE,header[3],PETSC_INT);CHKERRQ(ierr);
   ierr = PetscFree(column_indices);CHKERRQ(ierr);
 
   /* load up the numerical values */
-  ierr = PetscMalloc1(nzmax,&column_values);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nz+1,&column_values);CHKERRQ(ierr);
   cnt  = 0;
   for (i=0; i<a->mbs; i++) {
     rlen = bs*(B->i[i+1] - B->i[i] + A->i[i+1] - A->i[i]);
@@ -1141,25 +1074,7 @@ static PetscErrorCode MatView_MPISBAIJ_Binary(Mat mat,PetscViewer viewer)
     cnt += (bs-1)*rlen;
   }
   if (cnt != nz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Internal PETSc error: cnt = %D nz = %D",cnt,nz);
-
-  /* store the column values to the file */
-  ierr = PetscViewerFlowControlStart(viewer,&message_count,&flowcontrolcount);CHKERRQ(ierr);
-  if (!rank) {
-    MPI_Status status;
-    ierr = PetscBinaryWrite(fd,column_values,nz,PETSC_SCALAR,PETSC_TRUE);CHKERRQ(ierr);
-    for (i=1; i<size; i++) {
-      ierr = PetscViewerFlowControlStepMaster(viewer,i,&message_count,flowcontrolcount);CHKERRQ(ierr);
-      ierr = MPI_Recv(&cnt,1,MPIU_INT,i,tag,PetscObjectComm((PetscObject)mat),&status);CHKERRQ(ierr);
-      ierr = MPI_Recv(column_values,cnt,MPIU_SCALAR,i,tag,PetscObjectComm((PetscObject)mat),&status);CHKERRQ(ierr);
-      ierr = PetscBinaryWrite(fd,column_values,cnt,PETSC_SCALAR,PETSC_TRUE);CHKERRQ(ierr);
-    }
-    ierr = PetscViewerFlowControlEndMaster(viewer,&message_count);CHKERRQ(ierr);
-  } else {
-    ierr = PetscViewerFlowControlStepWorker(viewer,rank,&message_count);CHKERRQ(ierr);
-    ierr = MPI_Send(&nz,1,MPIU_INT,0,tag,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-    ierr = MPI_Send(column_values,nz,MPIU_SCALAR,0,tag,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-    ierr = PetscViewerFlowControlEndWorker(viewer,&message_count);CHKERRQ(ierr);
-  }
+  ierr = PetscViewerBinaryWriteAll(viewer,column_values,nz,PETSC_DETERMINE,header[3],PETSC_SCALAR);CHKERRQ(ierr);
   ierr = PetscFree(column_values);CHKERRQ(ierr);
 
   ierr = PetscViewerBinaryGetInfoPointer(viewer,&file);CHKERRQ(ierr);
@@ -2734,9 +2649,9 @@ PetscErrorCode MatLoad_MPISBAIJ(Mat newmat,PetscViewer viewer)
   PetscInt       *procsnz = 0,jj,*mycols,*ibuf;
   PetscInt       bs = newmat->rmap->bs,Mbs,mbs,extra_rows;
   PetscInt       *dlens,*odlens,*mask,*masked1,*masked2,rowcount,odcount;
-  PetscInt       dcount,kmax,k,nzcount,tmp;
+  PetscInt       dcount,kmax,k,nzcount,tmp,mdisk = 0;
   int            fd;
-  PetscBool      isbinary;
+  PetscBool      isbinary,usempiio;
 
   PetscFunctionBegin;
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERBINARY,&isbinary);CHKERRQ(ierr);
@@ -2753,13 +2668,10 @@ PetscErrorCode MatLoad_MPISBAIJ(Mat newmat,PetscViewer viewer)
   ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
   ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
   ierr = PetscViewerBinaryGetDescriptor(viewer,&fd);CHKERRQ(ierr);
-  if (!rank) {
-    ierr = PetscBinaryRead(fd,(char*)header,4,NULL,PETSC_INT);CHKERRQ(ierr);
-    if (header[0] != MAT_FILE_CLASSID) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"not matrix object");
-    if (header[3] < 0) SETERRQ(PetscObjectComm((PetscObject)newmat),PETSC_ERR_FILE_UNEXPECTED,"Matrix stored in special format, cannot load as MPISBAIJ");
-  }
-
-  ierr = MPI_Bcast(header+1,3,MPIU_INT,0,comm);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryGetUseMPIIO(viewer,&usempiio);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryRead(viewer,header,4,NULL,PETSC_INT);CHKERRQ(ierr);
+  if (header[0] != MAT_FILE_CLASSID) SETERRQ(comm,PETSC_ERR_FILE_UNEXPECTED,"not matrix object");
+  if (header[3] < 0) SETERRQ(comm,PETSC_ERR_FILE_UNEXPECTED,"Matrix stored in special format, cannot load as MPISBAIJ");
   M    = header[1];
   N    = header[2];
 
@@ -2800,7 +2712,12 @@ PetscErrorCode MatLoad_MPISBAIJ(Mat newmat,PetscViewer viewer)
 
   /* distribute row lengths to all processors */
   ierr = PetscMalloc1((rend-rstart)*bs,&locrowlens);CHKERRQ(ierr);
-  if (!rank) {
+  if (usempiio) {
+    /* each process reads its own rows, the padding rows are not on the disk */
+    mdisk = PetscMax(0,PetscMin(m,M-rstart*bs));
+    ierr  = PetscViewerBinaryReadAll(viewer,locrowlens,mdisk,rstart*bs,M,PETSC_INT);CHKERRQ(ierr);
+    for (j=mdisk; j<m; j++) locrowlens[j] = 1;
+  } else if (!rank) {
     ierr = PetscMalloc1(M+extra_rows,&rowlengths);CHKERRQ(ierr);
     ierr = PetscBinaryRead(fd,rowlengths,M,NULL,PETSC_INT);CHKERRQ(ierr);
     for (i=0; i<extra_rows; i++) rowlengths[M+i] = 1;
@@ -2812,7 +2729,14 @@ PetscErrorCode MatLoad_MPISBAIJ(Mat newmat,PetscViewer viewer)
     ierr = MPI_Scatterv(0,0,0,MPIU_INT,locrowlens,(rend-rstart)*bs,MPIU_INT,0,comm);CHKERRQ(ierr);
   }
 
-  if (!rank) {   /* procs[0] */
+  if (usempiio) {
+    nz = 0;
+    for (i=0; i<m; i++) nz += locrowlens[i];
+    ierr   = PetscMalloc1(nz+1,&ibuf);CHKERRQ(ierr);
+    mycols = ibuf;
+    ierr   = PetscViewerBinaryReadAll(viewer,mycols,nz-(m-mdisk),PETSC_DETERMINE,header[3],PETSC_INT);CHKERRQ(ierr);
+    for (i=mdisk; i<m; i++) mycols[nz-m+i] = rstart*bs+i;
+  } else if (!rank) {   /* procs[0] */
     /* calculate the number of nonzeros on each processor */
     ierr = PetscMalloc1(size,&procsnz);CHKERRQ(ierr);
     ierr = PetscMemzero(procsnz,size*sizeof(PetscInt));CHKERRQ(ierr);
@@ -2901,7 +2825,22 @@ PetscErrorCode MatLoad_MPISBAIJ(Mat newmat,PetscViewer viewer)
   ierr = MatMPISBAIJSetPreallocation(newmat,bs,0,dlens,0,odlens);CHKERRQ(ierr);
   ierr = MatSetOption(newmat,MAT_IGNORE_LOWER_TRIANGULAR,PETSC_TRUE);CHKERRQ(ierr);
 
-  if (!rank) {
+  if (usempiio) {
+    ierr   = PetscMalloc1(nz+1,&buf);CHKERRQ(ierr);
+    vals   = buf;
+    mycols = ibuf;
+    ierr   = PetscViewerBinaryReadAll(viewer,vals,nz-(m-mdisk),PETSC_DETERMINE,header[3],PETSC_SCALAR);CHKERRQ(ierr);
+    for (i=mdisk; i<m; i++) vals[nz-m+i] = 1.0;
+
+    /* insert into matrix */
+    jj = rstart*bs;
+    for (i=0; i<m; i++) {
+      ierr    = MatSetValues_MPISBAIJ(newmat,1,&jj,locrowlens[i],mycols,vals,INSERT_VALUES);CHKERRQ(ierr);
+      mycols += locrowlens[i];
+      vals   += locrowlens[i];
+      jj++;
+    }
+  } else if (!rank) {
     ierr = PetscMalloc1(maxnz,&buf);CHKERRQ(ierr);
     /* read in my part of the matrix numerical values  */
     nz     = procsnz[0];
@@ -22,6 +22,7 @@ typedef struct {
   PetscBool        ignore_ltriangular; /* if true, ignore the lower triangular values inserted by users */
   PetscBool        getrow_utriangular; /* if true, MatGetRow_SeqSBAIJ() is enabled to get the upper part of the row */
   Mat_SeqAIJ_Inode inode;
+  Mat_SeqAIJ_SolveLevels solvelevels; /* level sets of a factor for the threaded MatSolve() */
   unsigned short   *jshort;
   PetscBool        free_jshort;
 } Mat_SeqSBAIJ;
@@ -53,6 +54,8 @@ PETSC_INTERN PetscErrorCode MatCholeskyFactorNumeric_SeqSBAIJ_1_NaturalOrdering(
 PETSC_INTERN PetscErrorCode MatCholeskyFactorNumeric_SeqSBAIJ_1_NaturalOrdering_inplace(Mat,Mat,const MatFactorInfo*);
 PETSC_INTERN PetscErrorCode MatSolve_SeqSBAIJ_1_NaturalOrdering_inplace(Mat,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqSBAIJ_1_NaturalOrdering(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatSolve_SeqSBAIJ_1_Levels(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatSeqSBAIJSetUpSolveLevels_Private(Mat);
 
 PETSC_INTERN PetscErrorCode MatForwardSolve_SeqSBAIJ_1_NaturalOrdering_inplace(Mat,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatBackwardSolve_SeqSBAIJ_1_NaturalOrdering_inplace(Mat,Vec,Vec);
@@ -1429,6 +1429,7 @@ PetscErrorCode MatCholeskyFactorNumeric_SeqSBAIJ_1_NaturalOrdering(Mat B,Mat A,c
 
   B->assembled    = PETSC_TRUE;
   B->preallocated = PETSC_TRUE;
+  if (b->solvelevels.use) {ierr = MatSeqSBAIJSetUpSolveLevels_Private(B);CHKERRQ(ierr);}
 
   ierr = PetscLogFlops(B->rmap->n);CHKERRQ(ierr);
 
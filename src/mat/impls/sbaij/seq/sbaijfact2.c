@@ -1978,6 +1978,125 @@ PetscErrorCode MatSolve_SeqSBAIJ_1_NaturalOrdering(Mat A,Vec bb,Vec xx)
   PetscFunctionReturn(0);
 }
 
+/*
+   Builds the level sets of a factor U^T D U with block size 1, in the format of MatCholeskyFactorNumeric_SeqAIJ()
+   with the diagonal at the end of each row. Row k of the forward solve with U^T needs the rows of U that have an
+   entry in column k, so the transpose of U is built first; row k of U in the backward solve needs the rows of its
+   column indices.
+*/
+PetscErrorCode MatSeqSBAIJSetUpSolveLevels_Private(Mat B)
+{
+  Mat_SeqSBAIJ           *b  = (Mat_SeqSBAIJ*)B->data;
+  Mat_SeqAIJ_SolveLevels *sl = &b->solvelevels;
+  const PetscInt         mbs = b->mbs,*bi = b->i,*bj = b->j;
+  PetscInt               i,j,k,*ti,*tj,*tperm,*lev;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSolveLevelsReset_Private(sl);CHKERRQ(ierr);
+  ierr = PetscMalloc3(mbs+1,&ti,bi[mbs]-mbs,&tj,bi[mbs]-mbs,&tperm);CHKERRQ(ierr);
+  ierr = PetscMemzero(ti,(mbs+1)*sizeof(PetscInt));CHKERRQ(ierr);
+  for (k=0; k<mbs; k++) {
+    for (j=bi[k]; j<bi[k+1]-1; j++) ti[bj[j]+1]++;
+  }
+  for (k=0; k<mbs; k++) ti[k+1] += ti[k];
+  for (k=0; k<mbs; k++) {
+    for (j=bi[k]; j<bi[k+1]-1; j++) {
+      tj[ti[bj[j]]]      = k;
+      tperm[ti[bj[j]]++] = j;
+    }
+  }
+  for (k=mbs; k>0; k--) ti[k] = ti[k-1];
+  ti[0]     = 0;
+  sl->ti    = ti;
+  sl->tj    = tj;
+  sl->tperm = tperm;
+
+  ierr = PetscMalloc1(mbs,&lev);CHKERRQ(ierr);
+  for (k=0; k<mbs; k++) {
+    lev[k] = 0;
+    for (i=ti[k]; i<ti[k+1]; i++) lev[k] = PetscMax(lev[k],lev[tj[i]]+1);
+  }
+  ierr = MatSolveLevelsSort_Private(mbs,lev,&sl->nfwd,&sl->fwdptr,&sl->fwdrows);CHKERRQ(ierr);
+  for (k=mbs-1; k>=0; k--) {
+    lev[k] = 0;
+    for (j=bi[k]; j<bi[k+1]-1; j++) lev[k] = PetscMax(lev[k],lev[bj[j]]+1);
+  }
+  ierr = MatSolveLevelsSort_Private(mbs,lev,&sl->nbwd,&sl->bwdptr,&sl->bwdrows);CHKERRQ(ierr);
+  ierr = PetscFree(lev);CHKERRQ(ierr);
+  if (B->ops->solve != MatSolve_SeqSBAIJ_1_Levels) {
+    sl->solve     = B->ops->solve;
+    B->ops->solve = MatSolve_SeqSBAIJ_1_Levels;
+  }
+  ierr = PetscInfo3(B,"Forward solve in %D levels, backward solve in %D levels, of %D rows\n",sl->nfwd,sl->nbwd,mbs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatSolve() with the level sets of MatSeqSBAIJSetUpSolveLevels_Private(). The forward solve gathers the entries
+   of the rows of U^T, so it first computes the unscaled y = U^{-T} b of the sequential scatter and then applies D^{-1}.
+   The gather adds the entries in another order than the scatter, so the result agrees with the sequential solve
+   only up to rounding.
+*/
+PetscErrorCode MatSolve_SeqSBAIJ_1_Levels(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqSBAIJ           *a  = (Mat_SeqSBAIJ*)A->data;
+  Mat_SeqAIJ_SolveLevels *sl = &a->solvelevels;
+  const PetscInt         mbs = a->mbs,*ai = a->i,*aj = a->j,*rp;
+  const MatScalar        *aa = a->a;
+  const PetscScalar      *b;
+  PetscScalar            *x,*t;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  if (!PetscOMPUseThreads(a->nz)) {
+    ierr = (*sl->solve)(A,bb,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->row,&rp);CHKERRQ(ierr);
+  t    = a->solve_work;
+
+  PetscPragmaOMP(parallel)
+  {
+    PetscInt l,k;
+
+    /* solve U^T*D*y = perm(b) by forward substitution */
+    for (l=0; l<sl->nfwd; l++) {
+      PetscPragmaOMP(for schedule(static))
+      for (k=sl->fwdptr[l]; k<sl->fwdptr[l+1]; k++) {
+        PetscInt    i = sl->fwdrows[k],j;
+        PetscScalar xk = b[rp[i]];
+
+        for (j=sl->ti[i]; j<sl->ti[i+1]; j++) xk += aa[sl->tperm[j]]*t[sl->tj[j]];
+        t[i] = xk;
+      }
+    }
+    PetscPragmaOMP(for schedule(static))
+    for (k=0; k<mbs; k++) t[k] *= aa[ai[k+1]-1]; /* 1/D(k) */
+
+    /* solve U*perm(x) = y by back substitution */
+    for (l=0; l<sl->nbwd; l++) {
+      PetscPragmaOMP(for schedule(static))
+      for (k=sl->bwdptr[l]; k<sl->bwdptr[l+1]; k++) {
+        PetscInt    i = sl->bwdrows[k],j;
+        PetscScalar xk = t[i];
+
+        for (j=ai[i]; j<ai[i+1]-1; j++) xk += aa[j]*t[aj[j]];
+        t[i]     = xk;
+        x[rp[i]] = xk;
+      }
+    }
+  }
+
+  ierr = ISRestoreIndices(a->row,&rp);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(4.0*a->nz - 3.0*mbs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatSolve_SeqSBAIJ_1_NaturalOrdering_inplace(Mat A,Vec bb,Vec xx)
 {
   Mat_SeqSBAIJ      *a = (Mat_SeqSBAIJ*)A->data;
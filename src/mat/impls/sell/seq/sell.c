@@ -512,6 +512,11 @@ PetscErrorCode MatMultAdd_SeqSELL(Mat A,Vec xx,Vec yy,Vec zz)
   __mmask8          mask;
   __m512d           vec_x2,vec_y2,vec_vals2,vec_x3,vec_y3,vec_vals3,vec_x4,vec_y4,vec_vals4;
   __m256i           vec_idx2,vec_idx3,vec_idx4;
+#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+  __m128i           vec_idx;
+  __m256d           vec_x,vec_y,vec_y2,vec_vals;
+  MatScalar         yval;
+  PetscInt          r,row,nnz_in_row;
 #elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
   __m128d           vec_x_tmp;
   __m256d           vec_x,vec_y,vec_y2,vec_vals;
@@ -588,6 +593,39 @@ PetscErrorCode MatMultAdd_SeqSELL(Mat A,Vec xx,Vec yy,Vec zz)
       _mm512_storeu_pd(&z[8*i],vec_y);
     }
   }
+#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+  for (i=0; i<totalslices; i++) { /* loop over full slices */
+    PetscPrefetchBlock(acolidx,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
+    PetscPrefetchBlock(aval,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
+
+    /* last slice may have padding rows. Don't use vectorization. */
+    if (i == totalslices-1 && (A->rmap->n & 0x07)) {
+      for (r=0; r<(A->rmap->n & 0x07); ++r) {
+        row        = 8*i + r;
+        yval       = (MatScalar)0.0;
+        nnz_in_row = a->rlen[row];
+        for (j=0; j<nnz_in_row; ++j) yval += aval[8*j+r] * x[acolidx[8*j+r]];
+        z[row] = y[row] + yval;
+      }
+      break;
+    }
+
+    vec_y  = _mm256_loadu_pd(y+8*i);
+    vec_y2 = _mm256_loadu_pd(y+8*i+4);
+
+    /* Process slice of height 8 (512 bits) via two subslices of height 4 (256 bits) via AVX2 */
+    #pragma novector
+    #pragma unroll(2)
+    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
+      AVX2_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
+      aval += 4; acolidx += 4;
+      AVX2_Mult_Private(vec_idx,vec_x,vec_vals,vec_y2);
+      aval += 4; acolidx += 4;
+    }
+
+    _mm256_storeu_pd(z+i*8,vec_y);
+    _mm256_storeu_pd(z+i*8+4,vec_y2);
+  }
 #elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
   for (i=0; i<totalslices; i++) { /* loop over full slices */
     PetscPrefetchBlock(acolidx,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
@@ -668,8 +706,20 @@ PetscErrorCode MatMultTransposeAdd_SeqSELL(Mat A,Vec xx,Vec zz,Vec yy)
   const PetscScalar *x;
   const MatScalar   *aval=a->val;
   const PetscInt    *acolidx=a->colidx;
-  PetscInt          i,j,r,row,nnz_in_row,totalslices=a->totalslices;
+  PetscInt          i,j,r,totalslices=a->totalslices;
   PetscErrorCode    ierr;
+#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+  __m512d           vec_x,vec_vals;
+  __mmask8          mask=0xff;
+  PetscScalar       prod[8];
+#if defined(__AVX512CD__)
+  __m512d           vec_y;
+  __m256i           vec_idx;
+  __m512i           vec_conflict;
+#endif
+#else
+  PetscInt          row,nnz_in_row;
+#endif
 
 #if defined(PETSC_HAVE_PRAGMA_DISJOINT)
 #pragma disjoint(*x,*y,*aval)
@@ -683,12 +733,36 @@ PetscErrorCode MatMultTransposeAdd_SeqSELL(Mat A,Vec xx,Vec zz,Vec yy)
   if (zz != yy) { ierr = VecCopy(zz,yy);CHKERRQ(ierr); }
   ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+  for (i=0; i<totalslices; i++) { /* loop over slices */
+    PetscPrefetchBlock(acolidx+a->sliidx[i],a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
+    PetscPrefetchBlock(aval+a->sliidx[i],a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
+
+    if (i == totalslices-1 && (A->rmap->n & 0x07)) mask = (__mmask8)(0xff >> (8-(A->rmap->n & 0x07))); /* padding rows contribute zero */
+    vec_x = _mm512_maskz_loadu_pd(mask,&x[8*i]);
+    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
+      vec_vals = _mm512_mul_pd(_mm512_loadu_pd(&aval[j]),vec_x);
+#if defined(__AVX512CD__)
+      vec_idx  = _mm256_loadu_si256((__m256i const*)&acolidx[j]);
+      /* rows of a slice may hit the same column (e.g. padded entries), so scatter only when the 8 columns are distinct */
+      vec_conflict = _mm512_conflict_epi32(_mm512_castsi256_si512(vec_idx));
+      if (!_mm512_mask_test_epi32_mask(0xff,vec_conflict,vec_conflict)) {
+        vec_y = _mm512_i32gather_pd(vec_idx,y,_MM_SCALE_8);
+        _mm512_i32scatter_pd(y,vec_idx,_mm512_add_pd(vec_y,vec_vals),_MM_SCALE_8);
+        continue;
+      }
+#endif
+      _mm512_storeu_pd(prod,vec_vals);
+      for (r=0; r<8; r++) y[acolidx[j+r]] += prod[r];
+    }
+  }
+#else
   for (i=0; i<a->totalslices; i++) { /* loop over slices */
     if (i == totalslices-1 && (A->rmap->n & 0x07)) {
       for (r=0; r<(A->rmap->n & 0x07); ++r) {
         row        = 8*i + r;
         nnz_in_row = a->rlen[row];
-        for (j=0; j<nnz_in_row; ++j) y[acolidx[8*j+r]] += aval[8*j+r] * x[row];
+        for (j=0; j<nnz_in_row; ++j) y[acolidx[a->sliidx[i]+8*j+r]] += aval[a->sliidx[i]+8*j+r] * x[row];
       }
       break;
     }
@@ -703,6 +777,7 @@ PetscErrorCode MatMultTransposeAdd_SeqSELL(Mat A,Vec xx,Vec zz,Vec yy)
       y[acolidx[j+7]] += aval[j+7] * x[8*i+7];
     }
   }
+#endif
   ierr = PetscLogFlops(2.0*a->sliidx[a->totalslices]);CHKERRQ(ierr);
   ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
@@ -1627,15 +1702,74 @@ PetscErrorCode MatShift_SeqSELL(Mat Y,PetscScalar a)
   PetscFunctionReturn(0);
 }
 
+#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+/*
+   For the 8 rows of slice s, accumulates the products with the columns left of the diagonal block of the slice (lower)
+   and right of it (upper). Those entries of x are not changed while the rows of the slice are relaxed, so they are
+   gathered once per slice; the entries inside the diagonal block are handled row by row in MatSOR_SeqSELL_BlockRow_Private().
+*/
+PETSC_STATIC_INLINE void MatSOR_SeqSELL_SliceSums_Private(Mat_SeqSELL *a,PetscInt s,const PetscScalar *x,PetscBool dolower,PetscBool doupper,PetscScalar *lower,PetscScalar *upper)
+{
+  const PetscInt  *acolidx=a->colidx+a->sliidx[s];
+  const MatScalar *aval=a->val+a->sliidx[s];
+  const __m512i   vec_cstart=_mm512_set1_epi32((int)(8*s)),vec_cend=_mm512_set1_epi32((int)(8*s+8));
+  __m512d         vec_x,vec_vals,vec_lower=_mm512_setzero_pd(),vec_upper=_mm512_setzero_pd();
+  __m256i         vec_idx;
+  __mmask8        mask_lower=0,mask_upper=0;
+  PetscInt        j;
+
+  for (j=a->sliidx[s]; j<a->sliidx[s+1]; j+=8) {
+    vec_idx  = _mm256_loadu_si256((__m256i const*)acolidx);
+    vec_vals = _mm512_loadu_pd(aval);
+    if (dolower) mask_lower = (__mmask8)_mm512_mask_cmplt_epi32_mask(0xff,_mm512_castsi256_si512(vec_idx),vec_cstart);
+    if (doupper) mask_upper = (__mmask8)_mm512_mask_cmpge_epi32_mask(0xff,_mm512_castsi256_si512(vec_idx),vec_cend);
+    vec_x     = _mm512_mask_i32gather_pd(_mm512_setzero_pd(),mask_lower|mask_upper,vec_idx,x,_MM_SCALE_8);
+    vec_lower = _mm512_mask3_fmadd_pd(vec_vals,vec_x,vec_lower,mask_lower);
+    vec_upper = _mm512_mask3_fmadd_pd(vec_vals,vec_x,vec_upper,mask_upper);
+    acolidx += 8; aval += 8;
+  }
+  _mm512_storeu_pd(lower,vec_lower);
+  _mm512_storeu_pd(upper,vec_upper);
+}
+
+/*
+   Products of row i with the entries of x inside the diagonal block of its slice, left (lower) and right (upper) of the diagonal.
+   The columns of a row are sorted, so these entries are adjacent to the diagonal entry.
+*/
+PETSC_STATIC_INLINE void MatSOR_SeqSELL_BlockRow_Private(Mat_SeqSELL *a,PetscInt i,const PetscScalar *x,PetscBool dolower,PetscBool doupper,PetscScalar *lower,PetscScalar *upper)
+{
+  PetscInt    shift=a->sliidx[i>>3]+(i&0x07),cstart=i&~0x07,k;
+  PetscScalar sum;
+
+  if (dolower) {
+    sum = 0.0;
+    for (k=a->diag[i]-8; k>=shift && a->colidx[k]>=cstart; k-=8) sum += a->val[k]*x[a->colidx[k]];
+    *lower = sum;
+  }
+  if (doupper) {
+    sum = 0.0;
+    for (k=a->diag[i]+8; k<shift+8*a->rlen[i] && a->colidx[k]<cstart+8; k+=8) sum += a->val[k]*x[a->colidx[k]];
+    *upper = sum;
+  }
+}
+#endif
+
 PetscErrorCode MatSOR_SeqSELL(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
 {
   Mat_SeqSELL       *a=(Mat_SeqSELL*)A->data;
   PetscScalar       *x,sum,*t;
-  const MatScalar   *idiag=0,*mdiag;
+  const MatScalar   *idiag=0;
   const PetscScalar *b,*xb;
-  PetscInt          n,m=A->rmap->n,i,j,shift;
-  const PetscInt    *diag;
+  PetscInt          m=A->rmap->n,i;
   PetscErrorCode    ierr;
+#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+  PetscScalar       lower[8],upper[8],blower,bupper;
+  PetscInt          sl;
+#else
+  const MatScalar   *mdiag;
+  PetscInt          n,j,shift;
+  const PetscInt    *diag;
+#endif
 
   PetscFunctionBegin;
   its = its*lits;
@@ -1645,10 +1779,12 @@ PetscErrorCode MatSOR_SeqSELL(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
   a->fshift = fshift;
   a->omega  = omega;
 
-  diag  = a->diag;
   t     = a->ssor_work;
   idiag = a->idiag;
+#if !(defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES))
+  diag  = a->diag;
   mdiag = a->mdiag;
+#endif
 
   ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
   ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
@@ -1657,6 +1793,76 @@ PetscErrorCode MatSOR_SeqSELL(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
   if (flag == SOR_APPLY_LOWER) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"SOR_APPLY_LOWER is not implemented");
   if (flag & SOR_EISENSTAT) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No support yet for Eisenstat");
 
+#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+  /*
+     Sweep slice by slice: the couplings to the other slices are applied with masked gathers for all 8 rows at once,
+     the couplings inside the 8x8 diagonal block of the slice are applied row by row as in the scalar sweep.
+  */
+  if (flag & SOR_ZERO_INITIAL_GUESS) {
+    if ((flag & SOR_FORWARD_SWEEP) || (flag & SOR_LOCAL_FORWARD_SWEEP)) {
+      for (sl=0; sl<a->totalslices; sl++) {
+        MatSOR_SeqSELL_SliceSums_Private(a,sl,x,PETSC_TRUE,PETSC_FALSE,lower,upper);
+        for (i=8*sl; i<PetscMin(8*sl+8,m); i++) {
+          MatSOR_SeqSELL_BlockRow_Private(a,i,x,PETSC_TRUE,PETSC_FALSE,&blower,&bupper);
+          sum  = b[i]-lower[i&0x07]-blower;
+          t[i] = sum;
+          x[i] = sum*idiag[i];
+        }
+      }
+      xb   = t;
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if ((flag & SOR_BACKWARD_SWEEP) || (flag & SOR_LOCAL_BACKWARD_SWEEP)) {
+      for (sl=a->totalslices-1; sl>=0; sl--) {
+        MatSOR_SeqSELL_SliceSums_Private(a,sl,x,PETSC_FALSE,PETSC_TRUE,lower,upper);
+        for (i=PetscMin(8*sl+8,m)-1; i>=8*sl; i--) {
+          MatSOR_SeqSELL_BlockRow_Private(a,i,x,PETSC_FALSE,PETSC_TRUE,&blower,&bupper);
+          sum = xb[i]-upper[i&0x07]-bupper;
+          if (xb == b) {
+            x[i] = sum*idiag[i];
+          } else {
+            x[i] = (1.-omega)*x[i]+sum*idiag[i];  /* omega in idiag */
+          }
+        }
+      }
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+    }
+    its--;
+  }
+  while (its--) {
+    if ((flag & SOR_FORWARD_SWEEP) || (flag & SOR_LOCAL_FORWARD_SWEEP)) {
+      for (sl=0; sl<a->totalslices; sl++) {
+        MatSOR_SeqSELL_SliceSums_Private(a,sl,x,PETSC_TRUE,PETSC_TRUE,lower,upper);
+        for (i=8*sl; i<PetscMin(8*sl+8,m); i++) {
+          MatSOR_SeqSELL_BlockRow_Private(a,i,x,PETSC_TRUE,PETSC_TRUE,&blower,&bupper);
+          sum  = b[i]-lower[i&0x07]-blower;
+          t[i] = sum;             /* save application of the lower-triangular part */
+          sum -= upper[i&0x07]+bupper;
+          x[i] = (1.-omega)*x[i]+sum*idiag[i];  /* omega in idiag */
+        }
+      }
+      xb   = t;
+      ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if ((flag & SOR_BACKWARD_SWEEP) || (flag & SOR_LOCAL_BACKWARD_SWEEP)) {
+      for (sl=a->totalslices-1; sl>=0; sl--) {
+        /* whole matrix when xb == b (no checkpointing available), otherwise the lower-triangular part has been saved */
+        MatSOR_SeqSELL_SliceSums_Private(a,sl,x,(PetscBool)(xb == b),PETSC_TRUE,lower,upper);
+        for (i=PetscMin(8*sl+8,m)-1; i>=8*sl; i--) {
+          MatSOR_SeqSELL_BlockRow_Private(a,i,x,(PetscBool)(xb == b),PETSC_TRUE,&blower,&bupper);
+          sum = xb[i]-upper[i&0x07]-bupper;
+          if (xb == b) sum -= lower[i&0x07]+blower;
+          x[i] = (1.-omega)*x[i]+sum*idiag[i];  /* omega in idiag */
+        }
+      }
+      if (xb == b) {
+        ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+      } else {
+        ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+      }
+    }
+  }
+#else
   if (flag & SOR_ZERO_INITIAL_GUESS) {
     if ((flag & SOR_FORWARD_SWEEP) || (flag & SOR_LOCAL_FORWARD_SWEEP)) {
       for (i=0; i<m; i++) {
@@ -1725,6 +1931,7 @@ PetscErrorCode MatSOR_SeqSELL(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
       }
     }
   }
+#endif
   ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
   ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
   PetscFunctionReturn(0);
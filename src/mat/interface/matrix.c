@@ -1003,9 +1003,10 @@ PetscErrorCode MatView(Mat mat,PetscViewer viewer)
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERBINARY,&ibinary);CHKERRQ(ierr);
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERSTRING,&isstring);CHKERRQ(ierr);
   if (ibinary) {
-    PetscBool mpiio;
+    PetscBool mpiio,supported;
     ierr = PetscViewerBinaryGetUseMPIIO(viewer,&mpiio);CHKERRQ(ierr);
-    if (mpiio) SETERRQ(PetscObjectComm((PetscObject)viewer),PETSC_ERR_SUP,"PETSc matrix viewers do not support using MPI-IO, turn off that flag");
+    ierr = PetscObjectTypeCompareAny((PetscObject)mat,&supported,MATMPIAIJ,MATMPIBAIJ,MATMPISBAIJ,"");CHKERRQ(ierr);
+    if (mpiio && !supported) SETERRQ1(PetscObjectComm((PetscObject)viewer),PETSC_ERR_SUP,"PETSc matrix viewers only support MPI-IO for MATMPIAIJ, MATMPIBAIJ and MATMPISBAIJ, not %s, turn off that flag",((PetscObject)mat)->type_name);
   }
 
   ierr = PetscLogEventBegin(MAT_View,mat,viewer,0,0);CHKERRQ(ierr);
@@ -1156,7 +1157,9 @@ $ -viewer_type {binary,hdf5}
 
    Notes about the PETSc binary format:
    In case of PETSCVIEWERBINARY, a native PETSc binary format is used. Each of the blocks
-   is read onto rank 0 and then shipped to its destination rank, one after another.
+   is read onto rank 0 and then shipped to its destination rank, one after another. If the
+   viewer uses MPI-IO (-viewer_binary_mpiio) MATMPIAIJ, MATMPIBAIJ and MATMPISBAIJ matrices are
+   instead read by every rank at once, each rank reading its own rows with collective MPI-IO calls.
    Multiple objects, both matrices and vectors, can be stored within the same file.
    Their PetscObject name is ignored; they are loaded in the order of their storage.
 
@@ -1243,6 +1246,13 @@ PetscErrorCode MatLoad(Mat newmat,PetscViewer viewer)
   }
 
   if (!newmat->ops->load) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"MatLoad is not supported for type");
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERBINARY,&flg);CHKERRQ(ierr);
+  if (flg) {
+    PetscBool mpiio,supported;
+    ierr = PetscViewerBinaryGetUseMPIIO(viewer,&mpiio);CHKERRQ(ierr);
+    ierr = PetscObjectTypeCompareAny((PetscObject)newmat,&supported,MATMPIAIJ,MATMPIBAIJ,MATMPISBAIJ,"");CHKERRQ(ierr);
+    if (mpiio && !supported) SETERRQ1(PetscObjectComm((PetscObject)viewer),PETSC_ERR_SUP,"PETSc matrix loaders only support MPI-IO for MATMPIAIJ, MATMPIBAIJ and MATMPISBAIJ, not %s, turn off that flag",((PetscObject)newmat)->type_name);
+  }
   ierr = PetscLogEventBegin(MAT_Load,viewer,0,0,0);CHKERRQ(ierr);
   ierr = (*newmat->ops->load)(newmat,viewer);CHKERRQ(ierr);
   ierr = PetscLogEventEnd(MAT_Load,viewer,0,0,0);CHKERRQ(ierr);
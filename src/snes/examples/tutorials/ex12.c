@@ -935,6 +935,31 @@ static PetscErrorCode SNESMonitorError(SNES snes, PetscInt its, PetscReal rnorm,
 #endif
 }
 
+/* Apply the Jacobian at the base vector ctx->u, with the boundary values held fixed */
+static PetscErrorCode FormJacobianAction(Mat J, Vec X, Vec Y)
+{
+  JacActionCtx  *ctx;
+  DM             dm;
+  Vec            localX, localY;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = MatShellGetContext(J, &ctx);CHKERRQ(ierr);
+  dm   = ctx->dm;
+  ierr = DMGetLocalVector(dm, &localX);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(dm, &localY);CHKERRQ(ierr);
+  ierr = VecSet(localX, 0.0);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(dm, X, INSERT_VALUES, localX);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(dm, X, INSERT_VALUES, localX);CHKERRQ(ierr);
+  ierr = DMPlexComputeJacobianAction(dm, NULL, 0.0, 0.0, ctx->u, NULL, localX, localY, ctx->user);CHKERRQ(ierr);
+  ierr = VecSet(Y, 0.0);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalBegin(dm, localY, ADD_VALUES, Y);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalEnd(dm, localY, ADD_VALUES, Y);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(dm, &localX);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(dm, &localY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 int main(int argc, char **argv)
 {
   DM             dm;          /* Problem specification */
@@ -971,9 +996,7 @@ int main(int argc, char **argv)
     ierr = MatSetSizes(A, m, n, M, N);CHKERRQ(ierr);
     ierr = MatSetType(A, MATSHELL);CHKERRQ(ierr);
     ierr = MatSetUp(A);CHKERRQ(ierr);
-#if 0
     ierr = MatShellSetOperation(A, MATOP_MULT, (void (*)(void))FormJacobianAction);CHKERRQ(ierr);
-#endif
 
     userJ.dm   = dm;
     userJ.J    = J;
@@ -1817,4 +1840,21 @@ int main(int argc, char **argv)
     requires: p4est
     args: -quiet -run_type test -interpolate 1 -bc_type dirichlet -petscspace_degree 2 -vec_view glvis: -simplex 0 -dm_plex_convert_type p4est -dm_forest_minimum_refinement 0 -dm_forest_initial_refinement 1 -dm_forest_maximum_refinement 4 -dm_p4est_refine_pattern hash -cells 2,2 -viewer_glvis_dm_plex_enable_ncmesh
 
+  # Test PETSCFEVECTOR against the same solve as with the basic implementation
+  test:
+    suffix: 2d_p2_vector
+    args: -run_type full -f ${wPETSC_DIR}/share/petsc/datafiles/meshes/square.msh -dm_refine 1 -interpolate 1 -bc_type dirichlet -petscspace_degree 2 -variable_coefficient field -mat_petscspace_degree 1 -petscfe_type vector -mat_petscfe_type vector -petscfe_vector_width 5 -pc_type lu -snes_monitor_short -snes_converged_reason
+
+  # Test PETSCFESUMFACT residual and matrix-free Jacobian on hexahedra
+  test:
+    suffix: 2d_q3_sumfact
+    args: -run_type full -simplex 0 -dm_refine 1 -interpolate 1 -bc_type dirichlet -petscspace_degree 3 -variable_coefficient field -mat_petscspace_degree 2 -petscfe_type sumfact -mat_petscfe_type sumfact -jacobian_mf -ksp_type cg -pc_type jacobi -ksp_rtol 1e-13 -snes_monitor_short -snes_converged_reason
+  test:
+    suffix: 2d_q3_sumfact_fp_trap
+    output_file: output/ex12_2d_q3_sumfact.out
+    args: -run_type full -simplex 0 -dm_refine 1 -interpolate 1 -bc_type dirichlet -petscspace_degree 3 -variable_coefficient field -mat_petscspace_degree 2 -petscfe_type sumfact -mat_petscfe_type sumfact -jacobian_mf -ksp_type cg -pc_type jacobi -ksp_rtol 1e-13 -snes_monitor_short -snes_converged_reason -fp_trap
+  test:
+    suffix: 3d_q2_sumfact
+    args: -run_type full -dim 3 -simplex 0 -dm_refine 1 -interpolate 1 -bc_type dirichlet -petscspace_degree 2 -petscfe_type sumfact -jacobian_mf -ksp_type cg -pc_type jacobi -ksp_rtol 1e-13 -snes_monitor_short -snes_converged_reason
+
 TEST*/
@@ -2124,11 +2124,12 @@ PetscErrorCode DMPlexComputeJacobian_Internal(DM dm, IS cellIS, PetscReal t, Pet
 
   Note:
   We form the residual one batch of elements at a time. This allows us to offload work onto an accelerator,
-  like a GPU, or vectorize on a multicore machine.
+  like a GPU, or vectorize on a multicore machine. When the discretization of every field supports
+  PetscFEIntegrateJacobianAction(), such as PETSCFESUMFACT, the element matrices are not formed.
 
   Level: developer
 
-.seealso: FormFunctionLocal()
+.seealso: FormFunctionLocal(), PetscFEIntegrateJacobianAction()
 @*/
 PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscReal X_tShift, Vec X, Vec X_t, Vec Y, Vec Z, void *user)
 {
@@ -2144,7 +2145,7 @@ PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscR
   PetscInt          totDim, totDimAux = 0;
   const PetscInt   *cells;
   PetscInt          cStart, cEnd, numCells, c;
-  PetscBool         hasDyn;
+  PetscBool         hasDyn, hasAction = PETSC_TRUE;
   DMField           coordField;
   PetscErrorCode    ierr;
 
@@ -2177,8 +2178,20 @@ PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscR
     ierr = DMGetDS(dmAux, &probAux);CHKERRQ(ierr);
     ierr = PetscDSGetTotalDimension(probAux, &totDimAux);CHKERRQ(ierr);
   }
+  /* When every field can apply its element Jacobian directly, the element matrices are never formed */
+  for (fieldI = 0; fieldI < Nf; ++fieldI) {
+    PetscObject  obj;
+    PetscClassId id;
+    PetscBool    has = PETSC_FALSE;
+
+    ierr = PetscDSGetDiscretization(prob, fieldI, &obj);CHKERRQ(ierr);
+    ierr = PetscObjectGetClassId(obj, &id);CHKERRQ(ierr);
+    if (id == PETSCFE_CLASSID) {ierr = PetscFEHasJacobianAction((PetscFE) obj, &has);CHKERRQ(ierr);}
+    if (!has) hasAction = PETSC_FALSE;
+  }
   ierr = VecSet(Z, 0.0);CHKERRQ(ierr);
-  ierr = PetscMalloc6(numCells*totDim,&u,X_t ? numCells*totDim : 0,&u_t,numCells*totDim*totDim,&elemMat,hasDyn ? numCells*totDim*totDim : 0, &elemMatD,numCells*totDim,&y,totDim,&z);CHKERRQ(ierr);
+  /* With hasAction, elemMat and elemMatD hold the element vectors of the action */
+  ierr = PetscMalloc6(numCells*totDim,&u,X_t ? numCells*totDim : 0,&u_t,numCells*totDim*(hasAction ? 1 : totDim),&elemMat,hasDyn ? numCells*totDim*(hasAction ? 1 : totDim) : 0, &elemMatD,numCells*totDim,&y,totDim,&z);CHKERRQ(ierr);
   if (dmAux) {ierr = PetscMalloc1(numCells*totDimAux, &a);CHKERRQ(ierr);}
   ierr = DMGetCoordinateField(dm, &coordField);CHKERRQ(ierr);
   for (c = cStart; c < cEnd; ++c) {
@@ -2206,8 +2219,8 @@ PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscR
     for (i = 0; i < totDim; ++i) y[cind*totDim+i] = x[i];
     ierr = DMPlexVecRestoreClosure(dm, section, Y, cell, NULL, &x);CHKERRQ(ierr);
   }
-  ierr = PetscMemzero(elemMat, numCells*totDim*totDim * sizeof(PetscScalar));CHKERRQ(ierr);
-  if (hasDyn)  {ierr = PetscMemzero(elemMatD, numCells*totDim*totDim * sizeof(PetscScalar));CHKERRQ(ierr);}
+  ierr = PetscMemzero(elemMat, numCells*totDim*(hasAction ? 1 : totDim) * sizeof(PetscScalar));CHKERRQ(ierr);
+  if (hasDyn)  {ierr = PetscMemzero(elemMatD, numCells*totDim*(hasAction ? 1 : totDim) * sizeof(PetscScalar));CHKERRQ(ierr);}
   for (fieldI = 0; fieldI < Nf; ++fieldI) {
     PetscFE  fe;
     PetscInt Nb;
@@ -2241,6 +2254,15 @@ PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscR
     ierr = PetscFEGeomGetChunk(cgeomFEM,0,offset,&chunkGeom);CHKERRQ(ierr);
     ierr = PetscFEGeomGetChunk(cgeomFEM,offset,numCells,&remGeom);CHKERRQ(ierr);
     for (fieldJ = 0; fieldJ < Nf; ++fieldJ) {
+      if (hasAction) {
+        ierr = PetscFEIntegrateJacobianAction(prob, PETSCFE_JACOBIAN, fieldI, fieldJ, Ne, chunkGeom, u, u_t, probAux, a, t, X_tShift, y, elemMat);CHKERRQ(ierr);
+        ierr = PetscFEIntegrateJacobianAction(prob, PETSCFE_JACOBIAN, fieldI, fieldJ, Nr, remGeom, &u[offset*totDim], u_t ? &u_t[offset*totDim] : NULL, probAux, &a[offset*totDimAux], t, X_tShift, &y[offset*totDim], &elemMat[offset*totDim]);CHKERRQ(ierr);
+        if (hasDyn) {
+          ierr = PetscFEIntegrateJacobianAction(prob, PETSCFE_JACOBIAN_DYN, fieldI, fieldJ, Ne, chunkGeom, u, u_t, probAux, a, t, X_tShift, y, elemMatD);CHKERRQ(ierr);
+          ierr = PetscFEIntegrateJacobianAction(prob, PETSCFE_JACOBIAN_DYN, fieldI, fieldJ, Nr, remGeom, &u[offset*totDim], u_t ? &u_t[offset*totDim] : NULL, probAux, &a[offset*totDimAux], t, X_tShift, &y[offset*totDim], &elemMatD[offset*totDim]);CHKERRQ(ierr);
+        }
+        continue;
+      }
       ierr = PetscFEIntegrateJacobian(prob, PETSCFE_JACOBIAN, fieldI, fieldJ, Ne, chunkGeom, u, u_t, probAux, a, t, X_tShift, elemMat);CHKERRQ(ierr);
       ierr = PetscFEIntegrateJacobian(prob, PETSCFE_JACOBIAN, fieldI, fieldJ, Nr, remGeom, &u[offset*totDim], u_t ? &u_t[offset*totDim] : NULL, probAux, &a[offset*totDimAux], t, X_tShift, &elemMat[offset*totDim*totDim]);CHKERRQ(ierr);
       if (hasDyn) {
@@ -2254,7 +2276,7 @@ PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscR
     ierr = PetscQuadratureDestroy(&qGeom);CHKERRQ(ierr);
   }
   if (hasDyn) {
-    for (c = 0; c < numCells*totDim*totDim; ++c) elemMat[c] += X_tShift*elemMatD[c];
+    for (c = 0; c < numCells*totDim*(hasAction ? 1 : totDim); ++c) elemMat[c] += X_tShift*elemMatD[c];
   }
   for (c = cStart; c < cEnd; ++c) {
     const PetscInt     cell = cells ? cells[c] : c;
@@ -2262,6 +2284,11 @@ PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscR
     const PetscBLASInt M = totDim, one = 1;
     const PetscScalar  a = 1.0, b = 0.0;
 
+    if (hasAction) {
+      ierr = PetscMemcpy(z, &elemMat[cind*totDim], totDim * sizeof(PetscScalar));CHKERRQ(ierr);
+      ierr = DMPlexVecSetClosure(dm, section, Z, cell, z, ADD_VALUES);CHKERRQ(ierr);
+      continue;
+    }
     PetscStackCallBLAS("BLASgemv", BLASgemv_("N", &M, &M, &a, &elemMat[cind*totDim*totDim], &M, &y[cind*totDim], &one, &b, z, &one));
     if (mesh->printFEM > 1) {
       ierr = DMPrintCellMatrix(c, name, totDim, totDim, &elemMat[cind*totDim*totDim]);CHKERRQ(ierr);
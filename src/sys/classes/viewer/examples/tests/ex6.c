@@ -0,0 +1,80 @@
+static char help[] = "Tests PetscViewerBinaryWriteAll() and PetscViewerBinaryReadAll().\n\n";
+
+#include <petscviewer.h>
+
+int main(int argc,char **args)
+{
+  PetscViewer    viewer;
+  PetscMPIInt    rank,size;
+  PetscInt       i,n,start,total,*idx,*ridx,*all,header[2],nbad = 0;
+  PetscScalar    *val,*rval;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+
+  /* process i owns 2*i+1 items, the last process none */
+  n     = rank == size-1 ? 0 : 2*rank+1;
+  ierr  = MPI_Scan(&n,&start,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  start -= n;
+  total = (size-1)*(size-1);
+  ierr  = PetscMalloc4(n,&idx,n,&ridx,n,&val,n,&rval);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    idx[i] = start + i;
+    val[i] = -0.5*(start + i);
+  }
+
+  header[0] = 1211214;
+  header[1] = total;
+  ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD,"ex6.dat",FILE_MODE_WRITE,&viewer);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryWrite(viewer,header,2,PETSC_INT,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryWriteAll(viewer,idx,n,start,total,PETSC_INT);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryWriteAll(viewer,val,n,PETSC_DETERMINE,PETSC_DETERMINE,PETSC_SCALAR);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryWrite(viewer,header,2,PETSC_INT,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
+
+  ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD,"ex6.dat",FILE_MODE_READ,&viewer);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryRead(viewer,header,2,NULL,PETSC_INT);CHKERRQ(ierr);
+  if (header[0] != 1211214 || header[1] != total) nbad++;
+  ierr = PetscViewerBinaryReadAll(viewer,ridx,n,PETSC_DETERMINE,total,PETSC_INT);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryReadAll(viewer,rval,n,start,PETSC_DETERMINE,PETSC_SCALAR);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    if (ridx[i] != idx[i] || rval[i] != val[i]) nbad++;
+  }
+  header[0] = header[1] = 0;
+  ierr = PetscViewerBinaryRead(viewer,header,2,NULL,PETSC_INT);CHKERRQ(ierr);
+  if (header[0] != 1211214 || header[1] != total) nbad++;
+  ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
+
+  /* the whole array as written by the pieces, read back on every process */
+  ierr = PetscMalloc1(total,&all);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD,"ex6.dat",FILE_MODE_READ,&viewer);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryRead(viewer,header,2,NULL,PETSC_INT);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryRead(viewer,all,total,NULL,PETSC_INT);CHKERRQ(ierr);
+  for (i=0; i<total; i++) {
+    if (all[i] != i) nbad++;
+  }
+  ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
+
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&nbad,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Total %D items, wrong items %D\n",total,nbad);CHKERRQ(ierr);
+  ierr = PetscFree4(idx,ridx,val,rval);CHKERRQ(ierr);
+  ierr = PetscFree(all);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      nsize: 4
+      args: -viewer_binary_skip_info
+
+   test:
+      suffix: mpiio
+      nsize: 4
+      args: -viewer_binary_skip_info -viewer_binary_mpiio
+      output_file: output/ex6_1.out
+
+TEST*/
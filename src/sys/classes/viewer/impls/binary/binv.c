@@ -15,6 +15,9 @@ typedef struct  {
   MPI_File      mfdes;                /* ignored unless using MPI IO */
   MPI_File      mfsub;                /* subviewer support */
   MPI_Offset    moff;
+#endif
+#if defined(PETSC_HAVE_MMAP)
+  PetscBool     usemmap;              /* loaders map the file on each process instead of reading it on the first */
 #endif
   PetscFileMode btype;                /* read or write? */
   FILE          *fdes_info;           /* optional file containing info on binary file*/
@@ -218,6 +221,135 @@ static PetscErrorCode PetscViewerBinaryGetUseMPIIO_Binary(PetscViewer viewer,Pet
 }
 #endif
 
+#if defined(PETSC_HAVE_MMAP)
+/*@C
+    PetscViewerBinaryGetMMapOffset - Gets the current location in the file of a binary viewer that is read with mapped memory
+
+    Collective on PetscViewer
+
+    Input Parameter:
+.   viewer - PetscViewer context, obtained from PetscViewerBinaryOpen()
+
+    Output Parameter:
+.    off - the current location in bytes, the same on all processes
+
+    Level: advanced
+
+    Fortran Note:
+    This routine is not supported in Fortran.
+
+    Use PetscViewerBinaryAddMMapOffset() to move past the data after each process has mapped its part with PetscBinaryMap()
+
+.seealso: PetscViewerBinaryOpen(), PetscViewerBinaryGetUseMMap(), PetscViewerBinarySetUseMMap(), PetscViewerBinaryAddMMapOffset(), PetscBinaryMap()
+@*/
+PetscErrorCode PetscViewerBinaryGetMMapOffset(PetscViewer viewer,off_t *off)
+{
+  PetscViewer_Binary *vbinary = (PetscViewer_Binary*)viewer->data;
+  PetscMPIInt        rank;
+  PetscInt64         ioff = 0;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)viewer),&rank);CHKERRQ(ierr);
+  if (!rank) {
+    ierr = PetscBinarySeek(vbinary->fdes,0,PETSC_BINARY_SEEK_CUR,off);CHKERRQ(ierr);
+    ioff = (PetscInt64)*off;
+  }
+  ierr = MPI_Bcast(&ioff,1,MPIU_INT64,0,PetscObjectComm((PetscObject)viewer));CHKERRQ(ierr);
+  *off = (off_t)ioff;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+    PetscViewerBinaryAddMMapOffset - Moves the location in the file of a binary viewer past data that has been mapped
+
+    Logically Collective on PetscViewer
+
+    Input Parameters:
++   viewer - PetscViewer context, obtained from PetscViewerBinaryOpen()
+-    off - the number of bytes to move
+
+    Notes:
+    Only the first process seeks its file descriptor, since it is the one that reads the file in PetscViewerBinaryRead()
+    and in PetscViewerBinaryGetMMapOffset(); on the other processes the call does nothing and does not communicate. All
+    processes should still call it with the same off, after they have all mapped the data they need.
+
+    Level: advanced
+
+    Fortran Note:
+    This routine is not supported in Fortran.
+
+.seealso: PetscViewerBinaryOpen(), PetscViewerBinaryGetUseMMap(), PetscViewerBinaryGetMMapOffset(), PetscBinaryMap()
+@*/
+PetscErrorCode PetscViewerBinaryAddMMapOffset(PetscViewer viewer,off_t off)
+{
+  PetscViewer_Binary *vbinary = (PetscViewer_Binary*)viewer->data;
+  PetscMPIInt        rank;
+  off_t              loc;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)viewer),&rank);CHKERRQ(ierr);
+  if (!rank) {ierr = PetscBinarySeek(vbinary->fdes,off,PETSC_BINARY_SEEK_CUR,&loc);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscViewerBinaryGetUseMMap_Binary(PetscViewer viewer,PetscBool *flg)
+{
+  PetscViewer_Binary *vbinary = (PetscViewer_Binary*)viewer->data;
+
+  PetscFunctionBegin;
+  *flg = vbinary->usemmap;
+#if defined(PETSC_HAVE_MPIIO)
+  if (vbinary->usempiio) *flg = PETSC_FALSE;
+#endif
+  if (vbinary->btype != FILE_MODE_READ) *flg = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscViewerBinarySetUseMMap_Binary(PetscViewer viewer,PetscBool flg)
+{
+  PetscViewer_Binary *vbinary = (PetscViewer_Binary*)viewer->data;
+
+  PetscFunctionBegin;
+  vbinary->usemmap = flg;
+  PetscFunctionReturn(0);
+}
+#endif
+
+/*@C
+    PetscViewerBinaryGetUseMMap - Returns PETSC_TRUE if objects are loaded from the binary viewer by mapping the file into memory
+
+    Not Collective
+
+    Input Parameter:
+.   viewer - PetscViewer context, obtained from PetscViewerBinaryOpen()
+
+    Output Parameter:
+.   flg - PETSC_TRUE if the file is mapped
+
+    Options Database:
+    -viewer_binary_mmap : Flag for loading with mapped memory
+
+    Level: advanced
+
+    Note:
+    This is PETSC_FALSE if the system does not have mmap(), if MPI-IO is used or if the file is not open for reading
+
+    Fortran Note:
+    This routine is not supported in Fortran.
+
+.seealso: PetscViewerBinaryOpen(), PetscViewerBinarySetUseMMap(), PetscViewerBinaryGetUseMPIIO(), PetscBinaryMap()
+@*/
+PetscErrorCode PetscViewerBinaryGetUseMMap(PetscViewer viewer,PetscBool *flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *flg = PETSC_FALSE;
+  ierr = PetscTryMethod(viewer,"PetscViewerBinaryGetUseMMap_C",(PetscViewer,PetscBool*),(viewer,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
 /*@C
     PetscViewerBinaryGetUseMPIIO - Returns PETSC_TRUE if the binary viewer uses MPI-IO.
@@ -800,7 +932,8 @@ $    FILE_MODE_APPEND - open existing file for binary output
 .    -viewer_binary_skip_info -
 .    -viewer_binary_skip_options -
 .    -viewer_binary_skip_header -
--    -viewer_binary_mpiio -
+.    -viewer_binary_mpiio -
+-    -viewer_binary_mmap -
 
    Level: beginner
 
@@ -956,6 +1089,162 @@ PetscErrorCode PetscViewerBinaryWrite(PetscViewer viewer,void *data,PetscInt cou
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode PetscViewerBinaryWriteReadAll(PetscViewer viewer,void *data,PetscInt count,PetscInt start,PetscInt total,PetscDataType dtype,PetscBool write)
+{
+  PetscViewer_Binary *vbinary = (PetscViewer_Binary*)viewer->data;
+  MPI_Comm           comm;
+  PetscMPIInt        rank,size,tag = ((PetscObject)viewer)->tag;
+  MPI_Datatype       mdtype;
+  PetscInt           i,*counts = NULL,maxcount = 0,message_count,flowcontrolcount;
+  size_t             dsize;
+  void               *buf = NULL;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscViewerSetUp(viewer);CHKERRQ(ierr);
+  ierr = PetscObjectGetComm((PetscObject)viewer,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = PetscDataTypeToMPIDataType(dtype,&mdtype);CHKERRQ(ierr);
+  ierr = PetscDataTypeGetSize(dtype,&dsize);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MPIIO)
+  if (vbinary->usempiio) {
+    MPI_File    mfdes = vbinary->mfdes;
+    MPI_Status  status;
+    PetscMPIInt cnt;
+
+    ierr = PetscMPIIntCast(count,&cnt);CHKERRQ(ierr);
+    if (start == PETSC_DETERMINE) {
+      ierr   = MPI_Scan(&count,&start,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+      start -= count;
+    }
+    if (total == PETSC_DETERMINE) {
+      ierr = MPIU_Allreduce(&count,&total,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+    }
+    ierr = MPI_File_set_view(mfdes,vbinary->moff,mdtype,mdtype,(char*)"native",MPI_INFO_NULL);CHKERRQ(ierr);
+    if (write) {
+      ierr = MPIU_File_write_at_all(mfdes,(MPI_Offset)start,data,cnt,mdtype,&status);CHKERRQ(ierr);
+    } else {
+      PetscMPIInt rcnt = 0;
+
+      ierr = MPIU_File_read_at_all(mfdes,(MPI_Offset)start,data,cnt,mdtype,&status);CHKERRQ(ierr);
+      if (cnt) {ierr = MPI_Get_count(&status,mdtype,&rcnt);CHKERRQ(ierr);}
+      if (rcnt != cnt) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_READ,"Read past end of file, wanted %d items but got %d",cnt,rcnt);
+    }
+    vbinary->moff += (MPI_Offset)dsize*total;
+    PetscFunctionReturn(0);
+  }
+#endif
+  /* without MPI-IO the pieces are read or written by the first process, in process order, and may exceed 2^31 entries */
+  if (!rank) {ierr = PetscMalloc1(size,&counts);CHKERRQ(ierr);}
+  ierr = MPI_Gather(&count,1,MPIU_INT,counts,1,MPIU_INT,0,comm);CHKERRQ(ierr);
+  if (!rank) {
+    for (i=1; i<size; i++) maxcount = PetscMax(maxcount,counts[i]);
+    ierr = PetscMalloc(maxcount*dsize,&buf);CHKERRQ(ierr);
+  }
+  if (write) {
+    ierr = PetscViewerFlowControlStart(viewer,&message_count,&flowcontrolcount);CHKERRQ(ierr);
+    if (!rank) {
+      ierr = PetscBinaryWrite(vbinary->fdes,data,count,dtype,PETSC_FALSE);CHKERRQ(ierr);
+      for (i=1; i<size; i++) {
+        ierr = PetscViewerFlowControlStepMaster(viewer,i,&message_count,flowcontrolcount);CHKERRQ(ierr);
+        ierr = MPIULong_Recv(buf,counts[i],mdtype,i,tag,comm);CHKERRQ(ierr);
+        ierr = PetscBinaryWrite(vbinary->fdes,buf,counts[i],dtype,PETSC_TRUE);CHKERRQ(ierr);
+      }
+      ierr = PetscViewerFlowControlEndMaster(viewer,&message_count);CHKERRQ(ierr);
+    } else {
+      ierr = PetscViewerFlowControlStepWorker(viewer,rank,&message_count);CHKERRQ(ierr);
+      ierr = MPIULong_Send(data,count,mdtype,0,tag,comm);CHKERRQ(ierr);
+      ierr = PetscViewerFlowControlEndWorker(viewer,&message_count);CHKERRQ(ierr);
+    }
+  } else {
+    if (!rank) {
+      ierr = PetscBinaryRead(vbinary->fdes,data,count,NULL,dtype);CHKERRQ(ierr);
+      for (i=1; i<size; i++) {
+        ierr = PetscBinaryRead(vbinary->fdes,buf,counts[i],NULL,dtype);CHKERRQ(ierr);
+        ierr = MPIULong_Send(buf,counts[i],mdtype,i,tag,comm);CHKERRQ(ierr);
+      }
+    } else {
+      ierr = MPIULong_Recv(data,count,mdtype,0,tag,comm);CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscFree(counts);CHKERRQ(ierr);
+  ierr = PetscFree(buf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscViewerBinaryWriteAll - Writes a distributed array to a binary file, each process writing its own piece
+
+   Collective on PetscViewer
+
+   Input Parameters:
++  viewer - the binary viewer
+.  data - the local piece of the array
+.  count - number of items in the local piece
+.  start - position of the local piece in the whole array, or PETSC_DETERMINE
+.  total - length of the whole array, or PETSC_DETERMINE
+-  dtype - type of data to write
+
+   Notes:
+   The local pieces are stored one after the other in process order, so start is the sum of the counts on the lower
+   ranked processes. If the viewer uses MPI-IO (PetscViewerBinarySetUseMPIIO()) each process writes its piece at its
+   own offset with a single collective MPI_File_write_at_all(), otherwise the pieces are funneled through the first
+   process. Passing start and total, when they are already known, saves a reduction.
+
+   Because byte-swapping may be done on the values in data it cannot be declared const
+
+   Level: developer
+
+   Concepts: binary files
+
+.seealso: PetscViewerBinaryReadAll(), PetscViewerBinaryWrite(), PetscViewerBinaryOpen(), PetscViewerBinarySetUseMPIIO()
+@*/
+PetscErrorCode PetscViewerBinaryWriteAll(PetscViewer viewer,void *data,PetscInt count,PetscInt start,PetscInt total,PetscDataType dtype)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(viewer,PETSC_VIEWER_CLASSID,1);
+  ierr = PetscViewerBinaryWriteReadAll(viewer,data,count,start,total,dtype,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscViewerBinaryReadAll - Reads a distributed array from a binary file, each process reading its own piece
+
+   Collective on PetscViewer
+
+   Input Parameters:
++  viewer - the binary viewer
+.  count - number of items in the local piece
+.  start - position of the local piece in the whole array, or PETSC_DETERMINE
+.  total - length of the whole array, or PETSC_DETERMINE
+-  dtype - type of data to read
+
+   Output Parameter:
+.  data - the local piece of the array
+
+   Notes:
+   See PetscViewerBinaryWriteAll() for the layout. With MPI-IO each process reads its piece with a single collective
+   MPI_File_read_at_all(), otherwise the first process reads the pieces and sends them out.
+
+   Level: developer
+
+   Concepts: binary files
+
+.seealso: PetscViewerBinaryWriteAll(), PetscViewerBinaryRead(), PetscViewerBinaryOpen(), PetscViewerBinarySetUseMPIIO()
+@*/
+PetscErrorCode PetscViewerBinaryReadAll(PetscViewer viewer,void *data,PetscInt count,PetscInt start,PetscInt total,PetscDataType dtype)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(viewer,PETSC_VIEWER_CLASSID,1);
+  ierr = PetscViewerBinaryWriteReadAll(viewer,data,count,start,total,dtype,PETSC_FALSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
    PetscViewerBinaryWriteStringArray - writes to a binary file, only from the first process an array of strings
 
@@ -1113,6 +1402,44 @@ PetscErrorCode PetscViewerBinarySetUseMPIIO(PetscViewer viewer,PetscBool flg)
   PetscFunctionReturn(0);
 }
 
+/*@
+    PetscViewerBinarySetUseMMap - Sets a binary viewer to load objects by mapping the file into memory on each process
+
+    Logically Collective on PetscViewer
+
+    Input Parameters:
++   viewer - the PetscViewer; must be a binary
+-   flg - PETSC_TRUE means the file will be mapped
+
+    Options Database:
+    -viewer_binary_mmap : Flag for loading with mapped memory
+
+    Notes:
+    With this option MatLoad() and VecLoad() for the AIJ matrix and standard vector types let every process map
+    (with PetscBinaryMap()) only the part of the file it owns, instead of having the first process read everything and
+    send each process its part. A MATSEQAIJ matrix keeps the mapped column indices and values as its storage, so loading
+    it needs no more memory than one copy of the matrix. A MATMPIAIJ matrix copies the mapped data into its diagonal and
+    off-diagonal blocks, so while it is loaded each process holds its part of the file twice: once in the mapped pages,
+    which are private copies on little-endian machines because of the byte swapping, and once in the matrix. The file
+    must be visible from all processes.
+
+    It has no effect when writing, when MPI-IO is used, or if the system does not have mmap().
+
+    Level: advanced
+
+.seealso: PetscViewerBinaryOpen(), PetscViewerBinaryGetUseMMap(), PetscViewerBinarySetUseMPIIO(), PetscBinaryMap()
+@*/
+PetscErrorCode PetscViewerBinarySetUseMMap(PetscViewer viewer,PetscBool flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(viewer,PETSC_VIEWER_CLASSID,1);
+  PetscValidLogicalCollectiveBool(viewer,flg,2);
+  ierr = PetscTryMethod(viewer,"PetscViewerBinarySetUseMMap_C",(PetscViewer,PetscBool),(viewer,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
      PetscViewerFileSetMode - Sets the type of file to be open
 
@@ -1394,6 +1721,9 @@ static PetscErrorCode PetscViewerSetFromOptions_Binary(PetscOptionItems *PetscOp
   ierr = PetscOptionsBool("-viewer_binary_mpiio","Use MPI-IO functionality to write/read binary file","PetscViewerBinarySetUseMPIIO",PETSC_FALSE,&binary->usempiio,NULL);CHKERRQ(ierr);
 #elif defined(PETSC_HAVE_MPIUNI)
   ierr = PetscOptionsBool("-viewer_binary_mpiio","Use MPI-IO functionality to write/read binary file","PetscViewerBinarySetUseMPIIO",PETSC_FALSE,NULL,NULL);CHKERRQ(ierr);  
+#endif
+#if defined(PETSC_HAVE_MMAP)
+  ierr = PetscOptionsBool("-viewer_binary_mmap","Load objects by mapping the binary file into memory on each process","PetscViewerBinarySetUseMMap",binary->usemmap,&binary->usemmap,NULL);CHKERRQ(ierr);
 #endif
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   binary->setfromoptionscalled = PETSC_TRUE;
@@ -1407,7 +1737,7 @@ static PetscErrorCode PetscViewerSetFromOptions_Binary(PetscOptionItems *PetscOp
 .seealso:  PetscViewerBinaryOpen(), PETSC_VIEWER_STDOUT_(),PETSC_VIEWER_STDOUT_SELF, PETSC_VIEWER_STDOUT_WORLD, PetscViewerCreate(), PetscViewerASCIIOpen(),
            PetscViewerMatlabOpen(), VecView(), DMView(), PetscViewerMatlabPutArray(), PETSCVIEWERASCII, PETSCVIEWERMATLAB, PETSCVIEWERDRAW,
            PetscViewerFileSetName(), PetscViewerFileSetMode(), PetscViewerFormat, PetscViewerType, PetscViewerSetType(),
-           PetscViewerBinaryGetUseMPIIO(), PetscViewerBinarySetUseMPIIO()
+           PetscViewerBinaryGetUseMPIIO(), PetscViewerBinarySetUseMPIIO(), PetscViewerBinarySetUseMMap()
 
   Level: beginner
 
@@ -1461,6 +1791,10 @@ PETSC_EXTERN PetscErrorCode PetscViewerCreate_Binary(PetscViewer v)
 #if defined(PETSC_HAVE_MPIIO)
   ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinaryGetUseMPIIO_C",PetscViewerBinaryGetUseMPIIO_Binary);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinarySetUseMPIIO_C",PetscViewerBinarySetUseMPIIO_Binary);CHKERRQ(ierr);
+#endif
+#if defined(PETSC_HAVE_MMAP)
+  ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinaryGetUseMMap_C",PetscViewerBinaryGetUseMMap_Binary);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinarySetUseMMap_C",PetscViewerBinarySetUseMMap_Binary);CHKERRQ(ierr);
 #endif
   PetscFunctionReturn(0);
 }
@@ -1488,7 +1822,8 @@ PetscMPIInt Petsc_Viewer_Binary_keyval = MPI_KEYVAL_INVALID;
 .    -viewer_binary_skip_info
 .    -viewer_binary_skip_options
 .    -viewer_binary_skip_header
--    -viewer_binary_mpiio
+.    -viewer_binary_mpiio
+-    -viewer_binary_mmap
 
    Environmental variables:
 -   PETSC_VIEWER_BINARY_FILENAME
@@ -0,0 +1,101 @@
+static char help[] = "Tests timeline logging with PetscLogTimelineDump().\n\n";
+
+#include <petscsys.h>
+
+int main(int argc,char **argv)
+{
+  PetscLogEvent  outer,inner;
+  PetscLogStage  stage;
+  PetscInt       i,j,n = 3,m = 4,nouter = 0,ninner = 0,nranks = 0,dropped = 0;
+  PetscMPIInt    rank;
+  char           fname[PETSC_MAX_PATH_LEN] = "ex52-timeline.json",line[1024],*p;
+  FILE           *fd;
+  PetscBool      flg,check = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = PetscOptionsGetString(NULL,NULL,"-log_timeline",fname,sizeof(fname),&flg);CHKERRQ(ierr);
+  if (!flg) {ierr = PetscLogTimelineBegin(PETSC_DEFAULT);CHKERRQ(ierr);}
+  ierr = PetscOptionsGetBool(NULL,NULL,"-check_counters",&check,NULL);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("Outer",0,&outer);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("Inner",0,&inner);CHKERRQ(ierr);
+  ierr = PetscLogStageRegister("Work",&stage);CHKERRQ(ierr);
+
+  ierr = PetscLogStagePush(stage);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    ierr = PetscLogEventBegin(outer,0,0,0,0);CHKERRQ(ierr);
+    for (j=0; j<m; j++) {
+      ierr = PetscLogEventBegin(inner,0,0,0,0);CHKERRQ(ierr);
+      ierr = PetscLogFlops(10.0);CHKERRQ(ierr);
+      ierr = PetscLogEventEnd(inner,0,0,0,0);CHKERRQ(ierr);
+    }
+    ierr = PetscLogEventEnd(outer,0,0,0,0);CHKERRQ(ierr);
+  }
+  ierr = PetscLogStagePop();CHKERRQ(ierr);
+  ierr = PetscLogTimelineDump(fname);CHKERRQ(ierr);
+
+  /* with -log_view_counters the cycles and instructions of the inner events must have been counted on every process,
+     the nested logging keeps all its events in the main stage */
+  if (check) {
+    if (PetscLogCounters) {
+      PetscEventPerfInfo info,maininfo;
+      PetscLogDouble     counts[2],mincounts[2];
+
+      ierr      = PetscLogEventGetPerfInfo(stage,inner,&info);CHKERRQ(ierr);
+      ierr      = PetscLogEventGetPerfInfo(0,inner,&maininfo);CHKERRQ(ierr);
+      counts[0] = info.counters[PETSC_LOG_COUNTER_CYCLES] + maininfo.counters[PETSC_LOG_COUNTER_CYCLES];
+      counts[1] = info.counters[PETSC_LOG_COUNTER_INSTRUCTIONS] + maininfo.counters[PETSC_LOG_COUNTER_INSTRUCTIONS];
+      ierr      = MPIU_Allreduce(counts,mincounts,2,MPIU_PETSCLOGDOUBLE,MPI_MIN,PETSC_COMM_WORLD);CHKERRQ(ierr);
+      ierr      = PetscPrintf(PETSC_COMM_WORLD,"hardware counters: cycles %s instructions %s\n",mincounts[0] > 0.0 ? "counted" : "zero",mincounts[1] > 0.0 ? "counted" : "zero");CHKERRQ(ierr);
+    } else {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"hardware counters: not available\n");CHKERRQ(ierr);
+    }
+  }
+
+  if (!rank) {
+    fd = fopen(fname,"r");
+    if (!fd) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_FILE_OPEN,"Unable to open %s",fname);
+    while (fgets(line,sizeof(line),fd)) {
+      ierr = PetscStrstr(line,"\"name\":\"Outer\",\"cat\":\"Work\"",&p);CHKERRQ(ierr);
+      if (p) nouter++;
+      ierr = PetscStrstr(line,"\"name\":\"Inner\",\"cat\":\"Work\"",&p);CHKERRQ(ierr);
+      if (p) ninner++;
+      ierr = PetscStrstr(line,"\"process_name\"",&p);CHKERRQ(ierr);
+      if (p) nranks++;
+      ierr = PetscStrstr(line,"\"dropped_events\":",&p);CHKERRQ(ierr);
+      if (p) dropped += atoi(p+17);
+    }
+    fclose(fd);
+    ierr = PetscPrintf(PETSC_COMM_SELF,"ranks %D outer events %D inner events %D dropped %D\n",nranks,nouter,ninner,dropped);CHKERRQ(ierr);
+  }
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      nsize: 2
+      args: -log_timeline ex52-timeline.json
+
+   test:
+      suffix: 2
+      nsize: 2
+      args: -log_timeline ex52-timeline.json -log_timeline_size 5 -log_view ascii:ex52-log.txt
+
+   # configure only defines PETSC_HAVE_HARDWARE_COUNTERS where it could count cycles and instructions
+   test:
+      suffix: counters
+      nsize: 2
+      requires: hardware_counters
+      args: -log_timeline ex52-timeline.json -log_view_counters -log_view ascii:ex52-log.txt -check_counters
+
+   test:
+      suffix: counters_xml
+      nsize: 2
+      requires: hardware_counters
+      args: -log_timeline ex52-timeline.json -log_view_counters -log_view :ex52-log.xml:ascii_xml -check_counters
+      output_file: output/ex52_counters.out
+
+TEST*/
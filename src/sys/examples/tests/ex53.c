@@ -0,0 +1,70 @@
+static char help[] = "Tests the pooled allocator of PetscMallocSetPool().\n\n";
+
+#include <petscsys.h>
+
+int main(int argc,char **argv)
+{
+  PetscInt       i,j,n = 2000,*a[2000],size[2000],nbad = 0,nalign = 0;
+  PetscScalar    *big;
+  PetscRandom    r;
+  PetscReal      value;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&r);CHKERRQ(ierr);
+  ierr = PetscRandomSetInterval(r,0.0,1.0);CHKERRQ(ierr);
+
+  /* blocks of all sizes up to beyond the largest size class, freed and reallocated in a random order */
+  for (i=0; i<n; i++) {
+    ierr    = PetscRandomGetValueReal(r,&value);CHKERRQ(ierr);
+    size[i] = 1 + (PetscInt)(value*value*20000);
+    ierr    = PetscMalloc1(size[i],&a[i]);CHKERRQ(ierr);
+    for (j=0; j<size[i]; j++) a[i][j] = i;
+  }
+  for (i=0; i<n; i+=3) {ierr = PetscFree(a[i]);CHKERRQ(ierr);}
+  for (i=1; i<n; i+=3) {
+    size[i] *= 2;
+    ierr     = PetscRealloc(size[i]*sizeof(PetscInt),&a[i]);CHKERRQ(ierr);
+    for (j=size[i]/2; j<size[i]; j++) a[i][j] = i;
+  }
+  for (i=0; i<n; i+=3) {
+    ierr = PetscMalloc1(size[i],&a[i]);CHKERRQ(ierr);
+    for (j=0; j<size[i]; j++) a[i][j] = i;
+  }
+  for (i=0; i<n; i++) {
+    if (((PETSC_UINTPTR_T)a[i]) % PETSC_MEMALIGN) nalign++;
+    for (j=0; j<size[i]; j++) if (a[i][j] != i) {nbad++; break;}
+    ierr = PetscFree(a[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Corrupted blocks %D misaligned blocks %D\n",nbad,nalign);CHKERRQ(ierr);
+
+  /* large arrays created and destroyed repeatedly */
+  for (i=0; i<4; i++) {
+    ierr = PetscCalloc1(1000000+i,&big);CHKERRQ(ierr);
+    for (j=0; j<1000000+i; j++) if (big[j] != 0.0) {nbad++; break;}
+    for (j=0; j<1000000+i; j++) big[j] = 1.0;
+    ierr = PetscFree(big);CHKERRQ(ierr);
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Nonzero calloc arrays %D\n",nbad);CHKERRQ(ierr);
+
+  ierr = PetscRandomDestroy(&r);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      args: -malloc_pool
+
+   test:
+      suffix: 2
+      args: -malloc_pool -malloc_pool_huge_cache 1 -malloc_debug -malloc_dump
+      output_file: output/ex53_1.out
+
+   test:
+      suffix: 3
+      args: -malloc_pool -malloc_pool_huge_size 0
+      output_file: output/ex53_1.out
+
+TEST*/
@@ -0,0 +1,65 @@
+static char help[] = "Tests an options database with many more options than the initial table size.\n\n";
+
+#include <petscsys.h>
+
+int main(int argc,char **argv)
+{
+  PetscOptions   options;
+  PetscInt       i,n = 1000,N,nbad = 0,nused,nleft;
+  char           name[64],value[64],**names,**values;
+  const char     *v;
+  PetscBool      set,used;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsCreate(&options);CHKERRQ(ierr);
+
+  /* insert in reverse order, with mixed case names, then remove every third option */
+  for (i=n-1; i>=0; i--) {
+    ierr = PetscSNPrintf(name,sizeof(name),"-%s_%D_opt",i%2 ? "Level" : "level",i);CHKERRQ(ierr);
+    ierr = PetscSNPrintf(value,sizeof(value),"%D",i);CHKERRQ(ierr);
+    ierr = PetscOptionsSetValue(options,name,value);CHKERRQ(ierr);
+  }
+  for (i=0; i<n; i+=3) {
+    ierr = PetscSNPrintf(name,sizeof(name),"-LEVEL_%D_opt",i);CHKERRQ(ierr);
+    ierr = PetscOptionsClearValue(options,name);CHKERRQ(ierr);
+  }
+
+  /* every option that is left is found with its value, and is used after that */
+  for (i=0; i<n; i++) {
+    ierr = PetscSNPrintf(name,sizeof(name),"level_%D_opt",i);CHKERRQ(ierr);
+    ierr = PetscOptionsUsed(options,name,&used);CHKERRQ(ierr);
+    if (used) nbad++;
+    if (i%2) continue;
+    ierr = PetscSNPrintf(name,sizeof(name),"-%D_opt",i);CHKERRQ(ierr);
+    ierr = PetscOptionsFindPair(options,"level_",name,&v,&set);CHKERRQ(ierr);
+    if (set != (PetscBool)(i%3 != 0)) nbad++;
+    if (set && atoi(v) != i) nbad++;
+  }
+  ierr = PetscOptionsAllUsed(options,&nleft);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Wrong lookups %D options left %D\n",nbad,nleft);CHKERRQ(ierr);
+
+  /* the unused options are reported in alphabetical order */
+  ierr = PetscOptionsLeftGet(options,&N,&names,&values);CHKERRQ(ierr);
+  for (i=1, nbad=0; i<N; i++) {
+    ierr = PetscStrgrt(names[i-1],names[i],&set);CHKERRQ(ierr);
+    if (set) nbad++;
+  }
+  nused = 0;
+  for (i=0; i<N; i++) {
+    ierr = PetscOptionsUsed(options,names[i],&used);CHKERRQ(ierr);
+    if (used) nused++;
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Unused options %D out of order %D used %D first -%s %s last -%s %s\n",N,nbad,nused,names[0],values[0],names[N-1],values[N-1]);CHKERRQ(ierr);
+  ierr = PetscOptionsLeftRestore(options,&N,&names,&values);CHKERRQ(ierr);
+
+  ierr = PetscOptionsDestroy(&options);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+
+TEST*/
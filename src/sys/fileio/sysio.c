@@ -13,6 +13,10 @@
 #include <io.h>
 #endif
 #include <petscbt.h>
+#if defined(PETSC_HAVE_MMAP)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 const char *const PetscFileModes[] = {"READ","WRITE","APPEND","UPDATE","APPEND_UPDATE","PetscFileMode","PETSC_FILE_",0};
 
@@ -593,6 +597,106 @@ PetscErrorCode  PetscBinarySeek(int fd,off_t off,PetscBinarySeekType whence,off_
   PetscFunctionReturn(0);
 }
 
+/*@C
+   PetscBinaryMap - Maps an array stored in a binary file into memory instead of reading it.
+
+   Not Collective
+
+   Input Parameters:
++  fd - the file descriptor
+.  off - the location of the array in the file, in bytes
+.  num - the number of items in the array
+.  type - the type of the items (PETSC_INT, PETSC_REAL, PETSC_SCALAR, etc.)
+-  native - PETSC_TRUE to convert the array in place to the byte order and alignment of this machine
+
+   Output Parameters:
++  data - the array, NULL if num is zero
+.  map - the start of the mapping, to be passed to PetscBinaryUnmap()
+-  maplen - the length of the mapping
+
+   Level: developer
+
+   Notes:
+   The mapping is private to the process: pages that are never written are shared with the operating system's file
+   cache, and pages that are written (including by the conversion to native byte order on small-endian machines) become
+   private copies that do not change the file. Each process may thus map just the part of the file it needs.
+
+   If native is PETSC_FALSE data points to the bytes as they are stored in the file (big-endian, possibly not aligned for
+   type), and must not be written to; PetscByteSwap() can be used on a copy.
+
+   Concepts: files^mapping binary
+   Concepts: binary files^mapping
+
+.seealso: PetscBinaryUnmap(), PetscBinaryRead(), PetscBinarySeek(), PetscViewerBinarySetUseMMap()
+@*/
+PetscErrorCode PetscBinaryMap(int fd,off_t off,PetscInt num,PetscDataType type,PetscBool native,void **data,void **map,size_t *maplen)
+{
+#if defined(PETSC_HAVE_MMAP)
+  size_t         typesize,page,shift,len;
+  struct stat    sbuf;
+  char           *p;
+  PetscErrorCode ierr;
+#endif
+
+  PetscFunctionBegin;
+  *data   = NULL;
+  *map    = NULL;
+  *maplen = 0;
+  if (num < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Trying to map a negative amount of data %D",num);
+  if (type == PETSC_FUNCTION || type == PETSC_BIT_LOGICAL) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Cannot map functions or bit arrays");
+  if (!num) PetscFunctionReturn(0);
+#if defined(PETSC_HAVE_MMAP)
+  ierr  = PetscDataTypeGetSize(type,&typesize);CHKERRQ(ierr);
+  if (fstat(fd,&sbuf)) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_FILE_READ,"Unable to stat file, errno %d",errno);
+  if (off + (off_t)(num*typesize) > sbuf.st_size) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_READ,"Read past end of file");
+  page  = (size_t)sysconf(_SC_PAGESIZE);
+  shift = (size_t)(off % (off_t)page);
+  len   = shift + num*typesize;
+  p     = (char*)mmap(NULL,len,native ? PROT_READ|PROT_WRITE : PROT_READ,MAP_PRIVATE,fd,off - (off_t)shift);
+  if (p == (char*)MAP_FAILED) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_FILE_READ,"Unable to map file, errno %d",errno);
+  *map    = (void*)p;
+  *maplen = len;
+  p      += shift;
+  if (native) {
+    /* the page offset of p is at least its misalignment, so the array can always be moved down to an aligned start */
+    size_t misalign = (size_t)(((PETSC_UINTPTR_T)p) % typesize);
+
+    if (misalign && !(page % typesize)) {
+      ierr = PetscMemmove(p - misalign,p,num*typesize);CHKERRQ(ierr);
+      p   -= misalign;
+    }
+    if (!PetscBinaryBigEndian()) {ierr = PetscByteSwap(p,type,num);CHKERRQ(ierr);}
+  }
+  *data = (void*)p;
+#else
+  SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP_SYS,"System does not have mmap()");
+#endif
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscBinaryUnmap - Releases an array obtained with PetscBinaryMap()
+
+   Not Collective
+
+   Input Parameters:
++  map - the start of the mapping, from PetscBinaryMap()
+-  maplen - the length of the mapping, from PetscBinaryMap()
+
+   Level: developer
+
+.seealso: PetscBinaryMap()
+@*/
+PetscErrorCode PetscBinaryUnmap(void *map,size_t maplen)
+{
+  PetscFunctionBegin;
+  if (!map) PetscFunctionReturn(0);
+#if defined(PETSC_HAVE_MMAP)
+  if (munmap(map,maplen)) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SYS,"Unable to unmap file, errno %d",errno);
+#endif
+  PetscFunctionReturn(0);
+}
+
 /*@C
    PetscBinarySynchronizedRead - Reads from a binary file.
 
@@ -839,4 +943,29 @@ PetscErrorCode MPIU_File_read_all(MPI_File fd,void *data,PetscMPIInt cnt,MPI_Dat
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode MPIU_File_write_at_all(MPI_File fd,MPI_Offset off,void *data,PetscMPIInt cnt,MPI_Datatype dtype,MPI_Status *status)
+{
+  PetscDataType  pdtype;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMPIDataTypeToPetscDataType(dtype,&pdtype);CHKERRQ(ierr);
+  if (!PetscBinaryBigEndian()) {ierr = PetscByteSwap(data,pdtype,cnt);CHKERRQ(ierr);}
+  ierr = MPI_File_write_at_all(fd,off,data,cnt,dtype,status);CHKERRQ(ierr);
+  if (!PetscBinaryBigEndian()) {ierr = PetscByteSwap(data,pdtype,cnt);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MPIU_File_read_at_all(MPI_File fd,MPI_Offset off,void *data,PetscMPIInt cnt,MPI_Datatype dtype,MPI_Status *status)
+{
+  PetscDataType  pdtype;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMPIDataTypeToPetscDataType(dtype,&pdtype);CHKERRQ(ierr);
+  ierr = MPI_File_read_at_all(fd,off,data,cnt,dtype,status);CHKERRQ(ierr);
+  if (!PetscBinaryBigEndian()) {ierr = PetscByteSwap(data,pdtype,cnt);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
 #endif
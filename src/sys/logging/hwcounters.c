@@ -0,0 +1,191 @@
+/*
+     Hardware performance counters for PetscLogEventBegin()/PetscLogEventEnd(), read through PAPI if PETSc was
+  configured with it and otherwise through the Linux perf_event_open() system call.
+*/
+#include <petsc/private/logimpl.h>        /*I    "petscsys.h"   I*/
+
+#if defined(PETSC_USE_LOG)
+#if defined(PETSC_HAVE_PAPI)
+#include <papi.h>
+#elif defined(PETSC_HAVE_LINUX_PERF_EVENT_H) && defined(PETSC_HAVE_UNISTD_H)
+#define PETSC_USE_PERF_EVENT
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+/* position of each PETSC_LOG_COUNTER_XXX slot in the values returned by the backend, -1 if it is not counted */
+static int counterSlot[PETSC_LOG_NUM_COUNTERS] = {-1,-1,-1,-1};
+static int counterNum = 0;
+
+#if defined(PETSC_HAVE_PAPI)
+static int counterEventSet = PAPI_NULL;
+
+static PetscErrorCode PetscLogCountersAdd_PAPI(int slot,const char *name,const char *altname)
+{
+  int code;
+
+  PetscFunctionBegin;
+  if ((PAPI_event_name_to_code((char*)name,&code) != PAPI_OK || PAPI_add_event(counterEventSet,code) != PAPI_OK) &&
+      (!altname || PAPI_event_name_to_code((char*)altname,&code) != PAPI_OK || PAPI_add_event(counterEventSet,code) != PAPI_OK)) {
+    PetscErrorCode ierr = PetscInfo1(NULL,"PAPI event %s is not available\n",name);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  counterSlot[slot] = counterNum++;
+  PetscFunctionReturn(0);
+}
+#elif defined(PETSC_USE_PERF_EVENT)
+static int counterFd[PETSC_LOG_NUM_COUNTERS] = {-1,-1,-1,-1};
+
+static PetscErrorCode PetscLogCountersAdd_Perf(int slot,__u32 type,__u64 config)
+{
+  struct perf_event_attr attr;
+  int                    fd;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMemzero(&attr,sizeof(attr));CHKERRQ(ierr);
+  attr.size           = sizeof(attr);
+  attr.type           = type;
+  attr.config         = config;
+  attr.disabled       = counterNum ? 0 : 1;  /* the group leader starts the whole group */
+  attr.exclude_kernel = 1;
+  attr.exclude_hv     = 1;
+  attr.read_format    = PERF_FORMAT_GROUP;
+  fd = (int)syscall(__NR_perf_event_open,&attr,0,-1,counterNum ? counterFd[0] : -1,0);
+  if (fd < 0) {
+    ierr = PetscInfo3(NULL,"perf_event_open() failed for event type %d config 0x%llx: %s\n",(int)type,(unsigned long long)config,strerror(errno));CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  counterFd[counterNum] = fd;
+  counterSlot[slot]     = counterNum++;
+  PetscFunctionReturn(0);
+}
+#endif
+
+/*@C
+   PetscLogCountersBegin - Turns on collection of hardware performance counters in the default and nested event logging
+
+   Collective over PETSC_COMM_WORLD
+
+   Options Database Keys:
++  -log_view_counters - turns on counter collection, called automatically from PetscInitialize() together with -log_view
+-  -log_view_counters_vector <event> - the event counted as vector instructions: a PAPI event name (default PAPI_VEC_DP) or,
+                                        without PAPI, a raw hexadecimal perf event code for the processor at hand
+
+   Notes:
+   Four counters are kept for each event: processor cycles, instructions, last level cache misses and retired vector
+   instructions (PETSC_LOG_COUNTER_CYCLES, PETSC_LOG_COUNTER_INSTRUCTIONS, PETSC_LOG_COUNTER_CACHE_MISSES and
+   PETSC_LOG_COUNTER_VECTOR_INSTRUCTIONS in the counters[] array of PetscEventPerfInfo). PetscLogView() then adds the
+   instructions per cycle, the bytes moved from memory (cache misses times the cache line size), the vector instructions
+   and the arithmetic intensity (flop per byte moved from memory) of each event.
+
+   The counters are read from PAPI if PETSc was configured with --with-papi and otherwise with the Linux perf_event_open()
+   system call, which may require lowering /proc/sys/kernel/perf_event_paranoid. Only the thread calling
+   PetscLogEventBegin() is counted. If no counter can be opened on some process counting is left off everywhere, and
+   counters that are not supported by the hardware are reported as zero.
+
+   Reading the counters costs a system call (or a PAPI_read()) at every event begin and end, so events that take a
+   few microseconds will appear slower than they are.
+
+   Level: advanced
+
+.seealso: PetscLogView(), PetscLogDefaultBegin(), PetscLogNestedBegin(), PetscLogEventGetPerfInfo()
+@*/
+PetscErrorCode PetscLogCountersBegin(void)
+{
+  char           vector[256] = "";
+  PetscBool      have = PETSC_FALSE,haveall;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (PetscLogCounters) PetscFunctionReturn(0);
+  ierr = PetscOptionsGetString(NULL,NULL,"-log_view_counters_vector",vector,sizeof(vector),NULL);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_PAPI)
+  if (PAPI_library_init(PAPI_VER_CURRENT) != PAPI_VER_CURRENT || PAPI_create_eventset(&counterEventSet) != PAPI_OK) {
+    ierr = PetscInfo(NULL,"Unable to initialize PAPI\n");CHKERRQ(ierr);
+  } else {
+    ierr = PetscLogCountersAdd_PAPI(PETSC_LOG_COUNTER_CYCLES,"PAPI_TOT_CYC",NULL);CHKERRQ(ierr);
+    ierr = PetscLogCountersAdd_PAPI(PETSC_LOG_COUNTER_INSTRUCTIONS,"PAPI_TOT_INS",NULL);CHKERRQ(ierr);
+    ierr = PetscLogCountersAdd_PAPI(PETSC_LOG_COUNTER_CACHE_MISSES,"PAPI_L3_TCM","PAPI_L2_TCM");CHKERRQ(ierr);
+    ierr = PetscLogCountersAdd_PAPI(PETSC_LOG_COUNTER_VECTOR_INSTRUCTIONS,vector[0] ? vector : "PAPI_VEC_DP",vector[0] ? NULL : "PAPI_VEC_INS");CHKERRQ(ierr);
+    if (counterNum && PAPI_start(counterEventSet) == PAPI_OK) have = PETSC_TRUE;
+  }
+#elif defined(PETSC_USE_PERF_EVENT)
+  ierr = PetscLogCountersAdd_Perf(PETSC_LOG_COUNTER_CYCLES,PERF_TYPE_HARDWARE,PERF_COUNT_HW_CPU_CYCLES);CHKERRQ(ierr);
+  ierr = PetscLogCountersAdd_Perf(PETSC_LOG_COUNTER_INSTRUCTIONS,PERF_TYPE_HARDWARE,PERF_COUNT_HW_INSTRUCTIONS);CHKERRQ(ierr);
+  ierr = PetscLogCountersAdd_Perf(PETSC_LOG_COUNTER_CACHE_MISSES,PERF_TYPE_HARDWARE,PERF_COUNT_HW_CACHE_MISSES);CHKERRQ(ierr);
+  if (vector[0]) {
+    ierr = PetscLogCountersAdd_Perf(PETSC_LOG_COUNTER_VECTOR_INSTRUCTIONS,PERF_TYPE_RAW,(__u64)strtoull(vector,NULL,16));CHKERRQ(ierr);
+  }
+  if (counterNum && !ioctl(counterFd[0],PERF_EVENT_IOC_RESET,PERF_IOC_FLAG_GROUP) && !ioctl(counterFd[0],PERF_EVENT_IOC_ENABLE,PERF_IOC_FLAG_GROUP)) have = PETSC_TRUE;
+#else
+  ierr = PetscInfo(NULL,"PETSc was built without PAPI or perf_event support, hardware counters are not available\n");CHKERRQ(ierr);
+#endif
+  /* the counters add collective reductions to PetscLogView() so they must be on everywhere or nowhere */
+  ierr = MPIU_Allreduce(&have,&haveall,1,MPIU_BOOL,MPI_LAND,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  if (!haveall) {
+    ierr = PetscLogCountersEnd();CHKERRQ(ierr);
+    ierr = PetscInfo(NULL,"Hardware counters are not available on all processes, not collecting them\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  PetscLogCounters = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscLogCountersRead - Reads the current value of the hardware counters, in the PETSC_LOG_COUNTER_XXX order
+*/
+PetscErrorCode PetscLogCountersRead(PetscLogDouble values[])
+{
+  int i;
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_PAPI)
+  {
+    long long v[PETSC_LOG_NUM_COUNTERS];
+
+    if (PAPI_read(counterEventSet,v) != PAPI_OK) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_LIB,"PAPI_read() failed");
+    for (i=0; i<PETSC_LOG_NUM_COUNTERS; i++) values[i] = counterSlot[i] < 0 ? 0.0 : (PetscLogDouble)v[counterSlot[i]];
+  }
+#elif defined(PETSC_USE_PERF_EVENT)
+  {
+    __u64 v[1+PETSC_LOG_NUM_COUNTERS];  /* the number of counters in the group followed by their values */
+
+    if (read(counterFd[0],v,sizeof(v)) < (ssize_t)((1+counterNum)*sizeof(__u64))) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SYS,"Reading the perf event counters failed: %s",strerror(errno));
+    for (i=0; i<PETSC_LOG_NUM_COUNTERS; i++) values[i] = counterSlot[i] < 0 ? 0.0 : (PetscLogDouble)v[1+counterSlot[i]];
+  }
+#else
+  for (i=0; i<PETSC_LOG_NUM_COUNTERS; i++) values[i] = 0.0;
+#endif
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscLogCountersEnd - Releases the hardware counters, called from PetscLogFinalize()
+*/
+PetscErrorCode PetscLogCountersEnd(void)
+{
+  int i;
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_PAPI)
+  if (counterEventSet != PAPI_NULL) {
+    long long v[PETSC_LOG_NUM_COUNTERS];
+
+    if (PetscLogCounters) PAPI_stop(counterEventSet,v);
+    PAPI_cleanup_eventset(counterEventSet);
+    PAPI_destroy_eventset(&counterEventSet);
+    counterEventSet = PAPI_NULL;
+  }
+#elif defined(PETSC_USE_PERF_EVENT)
+  for (i=counterNum-1; i>=0; i--) {close(counterFd[i]); counterFd[i] = -1;}
+#endif
+  for (i=0; i<PETSC_LOG_NUM_COUNTERS; i++) counterSlot[i] = -1;
+  counterNum       = 0;
+  PetscLogCounters = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+#endif
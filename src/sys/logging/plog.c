@@ -137,6 +137,8 @@ PETSC_INTERN PetscErrorCode PetscLogFinalize(void)
   ierr = PetscFree(petsc_actions);CHKERRQ(ierr);
   ierr = PetscFree(petsc_objects);CHKERRQ(ierr);
   ierr = PetscLogNestedEnd();CHKERRQ(ierr);
+  ierr = PetscLogTimelineEnd();CHKERRQ(ierr);
+  ierr = PetscLogCountersEnd();CHKERRQ(ierr);
   ierr = PetscLogSet(NULL, NULL);CHKERRQ(ierr);
 
   /* Resetting phase */
@@ -1363,6 +1365,7 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
   PetscLogDouble     fracStageTime, fracStageFlops, fracStageMess, fracStageMessLen, fracStageRed;
   PetscLogDouble     min, max, tot, ratio, avg, x, y;
   PetscLogDouble     minf, maxf, totf, ratf, mint, maxt, tott, ratt, ratC, totm, totml, totr,mal,malmax,emalmax;
+  PetscLogDouble     totcnt[PETSC_LOG_NUM_COUNTERS], cntZero[PETSC_LOG_NUM_COUNTERS] = {0.0,0.0,0.0,0.0};
   PetscMPIInt        minC, maxC;
   PetscMPIInt        size, rank;
   PetscBool          *localStageUsed,    *stageUsed;
@@ -1562,6 +1565,12 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
     ierr = PetscFPrintf(comm, fd, "   MMalloc Mbytes: Increase in high water mark of allocated memory (sum over all calls to event)\n");CHKERRQ(ierr);
     ierr = PetscFPrintf(comm, fd, "   RMI Mbytes: Increase in resident memory (sum over all calls to event)\n");CHKERRQ(ierr);
   }
+  if (PetscLogCounters) {
+    ierr = PetscFPrintf(comm, fd, "   IPC: instructions per cycle (sums over all processors)\n");CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm, fd, "   DRAM Mbytes: last level cache misses times the cache line size (sum over all processors)\n");CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm, fd, "   VecIns: millions of vector instructions retired (sum over all processors)\n");CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm, fd, "   AI flop/B: arithmetic intensity, flop per DRAM byte\n");CHKERRQ(ierr);
+  }
   ierr = PetscFPrintf(comm, fd, "------------------------------------------------------------------------------------------------------------------------\n");CHKERRQ(ierr);
 
   ierr = PetscLogViewWarnDebugging(comm,fd);CHKERRQ(ierr);
@@ -1569,16 +1578,20 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
   /* Report events */
   ierr = PetscFPrintf(comm, fd,"Event                Count      Time (sec)     Flop                              --- Global ---  --- Stage ----  Total");CHKERRQ(ierr);
   if (PetscLogMemory) {
-    ierr = PetscFPrintf(comm, fd,"  Malloc EMalloc MMalloc RMI\n");CHKERRQ(ierr);
-  } else {
-    ierr = PetscFPrintf(comm, fd,"\n");CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm, fd,"  Malloc EMalloc MMalloc RMI");CHKERRQ(ierr);
+  }
+  if (PetscLogCounters) {
+    ierr = PetscFPrintf(comm, fd,"   IPC    DRAM  VecIns     AI");CHKERRQ(ierr);
   }
+  ierr = PetscFPrintf(comm, fd,"\n");CHKERRQ(ierr);
   ierr = PetscFPrintf(comm, fd,"                   Max Ratio  Max     Ratio   Max  Ratio  Mess   AvgLen  Reduct  %%T %%F %%M %%L %%R  %%T %%F %%M %%L %%R Mflop/s");CHKERRQ(ierr);
   if (PetscLogMemory) {
-    ierr = PetscFPrintf(comm, fd," Mbytes Mbytes Mbytes Mbytes\n");CHKERRQ(ierr);
-  } else {
-    ierr = PetscFPrintf(comm, fd,"\n");CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm, fd," Mbytes Mbytes Mbytes Mbytes");CHKERRQ(ierr);
+  }
+  if (PetscLogCounters) {
+    ierr = PetscFPrintf(comm, fd,"        Mbytes Minstr flop/B");CHKERRQ(ierr);
   }
+  ierr = PetscFPrintf(comm, fd,"\n");CHKERRQ(ierr);
   ierr = PetscFPrintf(comm,fd,"------------------------------------------------------------------------------------------------------------------------\n");CHKERRQ(ierr);
 
   /* Problem: The stage name will not show up unless the stage executed on proc 1 */
@@ -1636,6 +1649,9 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
           ierr  = MPI_Allreduce(&eventInfo[event].mallocIncrease, &malmax,1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
           ierr  = MPI_Allreduce(&eventInfo[event].mallocIncreaseEvent, &emalmax,1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
         }
+        if (PetscLogCounters) {
+          ierr  = MPI_Allreduce(eventInfo[event].counters, totcnt, PETSC_LOG_NUM_COUNTERS, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
+        }
         name = stageLog->eventLog->eventInfo[event].name;
       } else {
         flopr = 0.0;
@@ -1656,6 +1672,9 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
           ierr  = MPI_Allreduce(&zero,                        &malmax, 1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
           ierr  = MPI_Allreduce(&zero,                        &emalmax,1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
         }
+        if (PetscLogCounters) {
+          ierr  = MPI_Allreduce(cntZero,                      totcnt, PETSC_LOG_NUM_COUNTERS, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
+        }
         name  = "";
       }
       if (mint < 0.0) {
@@ -1689,10 +1708,16 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
                             100.0*fracStageTime, 100.0*fracStageFlops, 100.0*fracStageMess, 100.0*fracStageMessLen, 100.0*fracStageRed,
                             PetscAbs(flopr)/1.0e6);CHKERRQ(ierr);
         if (PetscLogMemory) {
-          ierr = PetscFPrintf(comm, fd," %5.0f   %5.0f   %5.0f   %5.0f\n",mal/1.0e6,emalmax/1.0e6,malmax/1.0e6,mem/1.0e6);CHKERRQ(ierr);
-        } else {
-          ierr = PetscFPrintf(comm, fd,"\n");CHKERRQ(ierr);
+          ierr = PetscFPrintf(comm, fd," %5.0f   %5.0f   %5.0f   %5.0f",mal/1.0e6,emalmax/1.0e6,malmax/1.0e6,mem/1.0e6);CHKERRQ(ierr);
+        }
+        if (PetscLogCounters) {
+          PetscLogDouble ipc = 0.0, dram = totcnt[PETSC_LOG_COUNTER_CACHE_MISSES]*PETSC_LEVEL1_DCACHE_LINESIZE, ai = 0.0;
+
+          if (totcnt[PETSC_LOG_COUNTER_CYCLES] != 0.0) ipc = totcnt[PETSC_LOG_COUNTER_INSTRUCTIONS]/totcnt[PETSC_LOG_COUNTER_CYCLES];
+          if (dram != 0.0) ai = totf/dram;
+          ierr = PetscFPrintf(comm, fd," %5.2f %7.0f %7.0f %6.2f",ipc,dram/1.0e6,totcnt[PETSC_LOG_COUNTER_VECTOR_INSTRUCTIONS]/1.0e6,ai);CHKERRQ(ierr);
         }
+        ierr = PetscFPrintf(comm, fd,"\n");CHKERRQ(ierr);
       }
     }
   }
@@ -0,0 +1,328 @@
+/*
+     Timeline logging: every completed event is stored in a fixed size ring buffer on each process
+  and the buffers are written as a Chrome trace (which Perfetto also reads) with one track per MPI rank.
+*/
+#include <petsc/private/logimpl.h>        /*I    "petscsys.h"   I*/
+#include <petsctime.h>
+#if defined(PETSC_HAVE_SIGNAL)
+#include <signal.h>
+#endif
+
+#if defined(PETSC_USE_LOG)
+
+#define PETSC_LOG_TIMELINE_MAX_DEPTH 128
+
+typedef struct {
+  PetscLogDouble begin;      /* seconds since PetscInitialize() */
+  PetscLogDouble duration;
+  PetscLogDouble flops;
+  PetscLogDouble bytes;      /* bytes sent and received */
+  PetscLogDouble messages;   /* messages sent and received */
+  PetscLogDouble reductions;
+  PetscLogEvent  event;
+  int            stage;
+} PetscTimelineRecord;
+
+typedef struct {
+  PetscLogDouble time,flops,bytes,messages,reductions;
+} PetscTimelineOpen;
+
+static PetscTimelineRecord *timelineRing    = NULL;
+static PetscInt            timelineSize     = 0;
+static PetscInt64          timelineCount    = 0;  /* records ever written, the ring holds the last timelineSize of them */
+static int                 timelineDepth    = 0;
+static PetscTimelineOpen   timelineOpen[PETSC_LOG_TIMELINE_MAX_DEPTH];
+static char                timelineSignalFile[PETSC_MAX_PATH_LEN];
+static volatile int        timelineDumpRequested = 0;
+static PetscErrorCode      (*timelinePrevBegin)(PetscLogEvent,int,PetscObject,PetscObject,PetscObject,PetscObject) = NULL;
+static PetscErrorCode      (*timelinePrevEnd)(PetscLogEvent,int,PetscObject,PetscObject,PetscObject,PetscObject)   = NULL;
+
+#define PetscTimelineBytes()    (petsc_send_len+petsc_isend_len+petsc_recv_len+petsc_irecv_len)
+#define PetscTimelineMessages() (petsc_send_ct+petsc_isend_ct+petsc_recv_ct+petsc_irecv_ct)
+
+static PetscErrorCode PetscLogTimelineDumpLocal(const char[]);
+
+static PetscErrorCode PetscLogEventBeginTimeline(PetscLogEvent event,int t,PetscObject o1,PetscObject o2,PetscObject o3,PetscObject o4)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (timelinePrevBegin) {ierr = (*timelinePrevBegin)(event,t,o1,o2,o3,o4);CHKERRQ(ierr);}
+  if (timelineDepth < PETSC_LOG_TIMELINE_MAX_DEPTH) {
+    PetscTimelineOpen *open = &timelineOpen[timelineDepth];
+
+    PetscTime(&open->time);
+    open->flops      = petsc_TotalFlops;
+    open->bytes      = PetscTimelineBytes();
+    open->messages   = PetscTimelineMessages();
+    open->reductions = petsc_allreduce_ct;
+  }
+  timelineDepth++;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscLogEventEndTimeline(PetscLogEvent event,int t,PetscObject o1,PetscObject o2,PetscObject o3,PetscObject o4)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (timelinePrevEnd) {ierr = (*timelinePrevEnd)(event,t,o1,o2,o3,o4);CHKERRQ(ierr);}
+  if (timelineDepth > 0) timelineDepth--;
+  if (timelineDepth < PETSC_LOG_TIMELINE_MAX_DEPTH) {
+    PetscTimelineOpen   *open = &timelineOpen[timelineDepth];
+    PetscTimelineRecord *rec  = &timelineRing[timelineCount%timelineSize];
+    PetscLogDouble      now;
+
+    PetscTime(&now);
+    rec->begin      = open->time-petsc_BaseTime;
+    rec->duration   = now-open->time;
+    rec->flops      = petsc_TotalFlops-open->flops;
+    rec->bytes      = PetscTimelineBytes()-open->bytes;
+    rec->messages   = PetscTimelineMessages()-open->messages;
+    rec->reductions = petsc_allreduce_ct-open->reductions;
+    rec->event      = event;
+    rec->stage      = petsc_stageLog->curStage;
+    timelineCount++;
+  }
+  if (timelineDumpRequested) {
+    timelineDumpRequested = 0;
+    ierr = PetscLogTimelineDumpLocal(timelineSignalFile);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+#if defined(PETSC_HAVE_SIGNAL) && !defined(PETSC_MISSING_SIGUSR1)
+/* only raise a flag, the buffer is written by the next event end on this process */
+static void PetscLogTimelineSignalHandler(int sig)
+{
+  timelineDumpRequested = 1;
+}
+#endif
+
+/*@C
+  PetscLogTimelineBegin - Turns on timeline logging. Every completed event is recorded, with its
+  start time, duration, stage, flops and message traffic, into a fixed size ring buffer on each process.
+
+  Logically Collective over PETSC_COMM_WORLD
+
+  Input Parameter:
+. size - the number of events kept on each process, or PETSC_DEFAULT
+
+  Options Database Keys:
++ -log_timeline [filename] - Activates PetscLogTimelineBegin() and writes the timeline with PetscLogTimelineDump() in PetscFinalize()
+. -log_timeline_size <n> - The number of events kept on each process (default 100000)
+- -log_timeline_signal - Writes the timeline of a process to filename.rank when it receives SIGUSR1
+
+  Notes:
+  The buffer is allocated here, nothing is allocated while events are logged. When the buffer is full the oldest
+  events are overwritten. Timeline logging wraps the logging functions active when it is called, so it can be
+  combined with -log_view.
+
+  Usage:
+.vb
+      PetscInitialize(...);
+      PetscLogTimelineBegin(PETSC_DEFAULT);
+       ... code ...
+      PetscLogTimelineDump(filename);
+      PetscFinalize();
+.ve
+
+  Level: advanced
+
+.keywords: log, begin, timeline, trace
+.seealso: PetscLogTimelineDump(), PetscLogTraceBegin(), PetscLogDefaultBegin()
+@*/
+PetscErrorCode PetscLogTimelineBegin(PetscInt size)
+{
+  PetscBool      flg = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (timelineRing) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Timeline logging is already active");
+  if (size == PETSC_DEFAULT) size = 100000;
+  if (size < 1) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Timeline size %D must be positive",size);
+  ierr = PetscMalloc1(size,&timelineRing);CHKERRQ(ierr);
+  timelineSize      = size;
+  timelineCount     = 0;
+  timelineDepth     = 0;
+  timelinePrevBegin = PetscLogPLB;
+  timelinePrevEnd   = PetscLogPLE;
+  ierr = PetscLogSet(PetscLogEventBeginTimeline,PetscLogEventEndTimeline);CHKERRQ(ierr);
+
+  ierr = PetscOptionsGetBool(NULL,NULL,"-log_timeline_signal",&flg,NULL);CHKERRQ(ierr);
+  if (flg) {
+    ierr = PetscStrcpy(timelineSignalFile,"petsc-timeline.json");CHKERRQ(ierr);
+    ierr = PetscOptionsGetString(NULL,NULL,"-log_timeline",timelineSignalFile,sizeof(timelineSignalFile),NULL);CHKERRQ(ierr);
+    if (!timelineSignalFile[0]) {ierr = PetscStrcpy(timelineSignalFile,"petsc-timeline.json");CHKERRQ(ierr);}
+#if defined(PETSC_HAVE_SIGNAL) && !defined(PETSC_MISSING_SIGUSR1)
+    signal(SIGUSR1,PetscLogTimelineSignalHandler);
+#else
+    ierr = PetscInfo(NULL,"SIGUSR1 is not available, -log_timeline_signal is ignored\n");CHKERRQ(ierr);
+#endif
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Frees the ring buffer, called by PetscLogFinalize() */
+PetscErrorCode PetscLogTimelineEnd(void)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!timelineRing) PetscFunctionReturn(0);
+  ierr = PetscFree(timelineRing);CHKERRQ(ierr);
+  timelineSize      = 0;
+  timelineCount     = 0;
+  timelineDepth     = 0;
+  timelinePrevBegin = NULL;
+  timelinePrevEnd   = NULL;
+  PetscFunctionReturn(0);
+}
+
+/* Copies the records in the ring to rec, oldest first */
+static PetscErrorCode PetscLogTimelineGetRecords(PetscTimelineRecord rec[],PetscInt *n)
+{
+  PetscInt       start;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (timelineCount <= timelineSize) {
+    *n   = (PetscInt)timelineCount;
+    ierr = PetscMemcpy(rec,timelineRing,(*n)*sizeof(PetscTimelineRecord));CHKERRQ(ierr);
+  } else {
+    *n    = timelineSize;
+    start = (PetscInt)(timelineCount%timelineSize);
+    ierr  = PetscMemcpy(rec,timelineRing+start,(timelineSize-start)*sizeof(PetscTimelineRecord));CHKERRQ(ierr);
+    ierr  = PetscMemcpy(rec+timelineSize-start,timelineRing,start*sizeof(PetscTimelineRecord));CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Writes the trace events of one rank; the times are in microseconds */
+static PetscErrorCode PetscLogTimelineWrite(FILE *fd,PetscMPIInt rank,const PetscTimelineRecord rec[],PetscInt n,PetscInt64 dropped,PetscBool *first)
+{
+  PetscStageLog    stageLog;
+  PetscEventRegLog eventRegLog;
+  const char       *name,*stage;
+  PetscInt         i;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscLogGetStageLog(&stageLog);CHKERRQ(ierr);
+  ierr = PetscStageLogGetEventRegLog(stageLog,&eventRegLog);CHKERRQ(ierr);
+  ierr = PetscFPrintf(PETSC_COMM_SELF,fd,"%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"rank %d\"}},\n",*first ? "" : ",\n",rank,rank);CHKERRQ(ierr);
+  ierr = PetscFPrintf(PETSC_COMM_SELF,fd,"{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"sort_index\":%d,\"dropped_events\":%lld}}",rank,rank,(long long)dropped);CHKERRQ(ierr);
+  *first = PETSC_FALSE;
+  for (i=0; i<n; i++) {
+    name  = rec[i].event >= 0 && rec[i].event < eventRegLog->numEvents ? eventRegLog->eventInfo[rec[i].event].name : "unknown";
+    stage = rec[i].stage >= 0 && rec[i].stage < stageLog->numStages ? stageLog->stageInfo[rec[i].stage].name : "unknown";
+    ierr  = PetscFPrintf(PETSC_COMM_SELF,fd,",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"flops\":%.15g,\"bytes\":%.15g,\"messages\":%.15g,\"reductions\":%.15g}}",
+                         name,stage,rank,1.e6*rec[i].begin,1.e6*rec[i].duration,rec[i].flops,rec[i].bytes,rec[i].messages,rec[i].reductions);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Writes the timeline of this process alone, to filename.rank; used on SIGUSR1 since the other processes are not involved */
+static PetscErrorCode PetscLogTimelineDumpLocal(const char filename[])
+{
+  PetscTimelineRecord *rec;
+  PetscInt            n;
+  PetscMPIInt         rank;
+  PetscBool           first = PETSC_TRUE;
+  char                fname[PETSC_MAX_PATH_LEN];
+  FILE                *fd;
+  PetscErrorCode      ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(fname,sizeof(fname),"%s.%d",filename,rank);CHKERRQ(ierr);
+  fd   = fopen(fname,"w");
+  if (!fd) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_FILE_OPEN,"Unable to open timeline file: %s",fname);
+  ierr = PetscMalloc1(timelineSize,&rec);CHKERRQ(ierr);
+  ierr = PetscLogTimelineGetRecords(rec,&n);CHKERRQ(ierr);
+  ierr = PetscFPrintf(PETSC_COMM_SELF,fd,"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");CHKERRQ(ierr);
+  ierr = PetscLogTimelineWrite(fd,rank,rec,n,timelineCount-n,&first);CHKERRQ(ierr);
+  ierr = PetscFPrintf(PETSC_COMM_SELF,fd,"\n]}\n");CHKERRQ(ierr);
+  ierr = PetscFree(rec);CHKERRQ(ierr);
+  if (fclose(fd)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SYS,"fclose() failed on file");
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  PetscLogTimelineDump - Writes the events recorded since PetscLogTimelineBegin() as a Chrome trace,
+  which can be opened in chrome://tracing or https://ui.perfetto.dev
+
+  Collective over PETSC_COMM_WORLD
+
+  Input Parameter:
+. filename - the file name, or NULL for petsc-timeline.json
+
+  Notes:
+  Each MPI rank is shown as a process; the events give the flops, bytes and messages sent and received
+  and the number of reductions between their begin and end. The time of each rank is measured from the barrier in
+  PetscInitialize(). The first process writes the file, the others send their events to it one at a time.
+
+  Level: advanced
+
+.keywords: log, dump, timeline, trace
+.seealso: PetscLogTimelineBegin(), PetscLogDump()
+@*/
+PetscErrorCode PetscLogTimelineDump(const char filename[])
+{
+  PetscTimelineRecord *rec;
+  PetscInt            n;
+  PetscInt64          dropped;
+  PetscMPIInt         rank,size,r,cnt;
+  MPI_Comm            comm;
+  MPI_Status          status;
+  PetscBool           first = PETSC_TRUE;
+  char                fname[PETSC_MAX_PATH_LEN];
+  FILE                *fd = NULL;
+  PetscErrorCode      ierr;
+
+  PetscFunctionBegin;
+  if (!timelineRing) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call PetscLogTimelineBegin() or use -log_timeline first");
+  ierr = MPI_Comm_dup(PETSC_COMM_WORLD,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = PetscMalloc1(timelineSize,&rec);CHKERRQ(ierr);
+  ierr = PetscLogTimelineGetRecords(rec,&n);CHKERRQ(ierr);
+  dropped = timelineCount-n;
+  if (!rank) {
+    ierr = PetscFixFilename(filename && filename[0] ? filename : "petsc-timeline.json",fname);CHKERRQ(ierr);
+    fd   = fopen(fname,"w");
+    if (!fd) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_FILE_OPEN,"Unable to open timeline file: %s",fname);
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fd,"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");CHKERRQ(ierr);
+    ierr = PetscLogTimelineWrite(fd,0,rec,n,dropped,&first);CHKERRQ(ierr);
+    for (r=1; r<size; r++) {
+      PetscInt64 rdropped;
+      PetscInt   rn;
+
+      ierr = MPI_Recv(&rdropped,1,MPIU_INT64,r,0,comm,&status);CHKERRQ(ierr);
+      ierr = MPI_Probe(r,1,comm,&status);CHKERRQ(ierr);
+      ierr = MPI_Get_count(&status,MPI_BYTE,&cnt);CHKERRQ(ierr);
+      rn   = cnt/(PetscMPIInt)sizeof(PetscTimelineRecord);
+      if (rn > timelineSize) {
+        ierr = PetscFree(rec);CHKERRQ(ierr);
+        ierr = PetscMalloc1(rn,&rec);CHKERRQ(ierr);
+      }
+      ierr = MPI_Recv(rec,cnt,MPI_BYTE,r,1,comm,&status);CHKERRQ(ierr);
+      ierr = PetscLogTimelineWrite(fd,r,rec,rn,rdropped,&first);CHKERRQ(ierr);
+      if (rn > timelineSize) {
+        ierr = PetscFree(rec);CHKERRQ(ierr);
+        ierr = PetscMalloc1(timelineSize,&rec);CHKERRQ(ierr);
+      }
+    }
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fd,"\n]}\n");CHKERRQ(ierr);
+    if (fclose(fd)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SYS,"fclose() failed on file");
+  } else {
+    ierr = PetscMPIIntCast(n*sizeof(PetscTimelineRecord),&cnt);CHKERRQ(ierr);
+    ierr = MPI_Send(&dropped,1,MPIU_INT64,0,0,comm);CHKERRQ(ierr);
+    ierr = MPI_Send(rec,cnt,MPI_BYTE,0,1,comm);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(rec);CHKERRQ(ierr);
+  ierr = MPI_Comm_free(&comm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#endif
@@ -9,6 +9,7 @@
 
 PetscBool PetscLogSyncOn = PETSC_FALSE;
 PetscBool PetscLogMemory = PETSC_FALSE;
+PetscBool PetscLogCounters = PETSC_FALSE;
 
 /*----------------------------------------------- Creation Functions -------------------------------------------------*/
 /* Note: these functions do not have prototypes in a public directory, so they are considered "internal" and not exported. */
@@ -133,6 +134,8 @@ PetscErrorCode PetscEventPerfLogDestroy(PetscEventPerfLog eventLog)
 @*/
 PetscErrorCode PetscEventPerfInfoClear(PetscEventPerfInfo *eventInfo)
 {
+  int i;
+
   PetscFunctionBegin;
   eventInfo->id            = -1;
   eventInfo->active        = PETSC_TRUE;
@@ -165,6 +168,7 @@ PetscErrorCode PetscEventPerfInfoClear(PetscEventPerfInfo *eventInfo)
   eventInfo->numMessages   = 0.0;
   eventInfo->messageLength = 0.0;
   eventInfo->numReductions = 0.0;
+  for (i=0; i<PETSC_LOG_NUM_COUNTERS; i++) eventInfo->counters[i] = 0.0;
   PetscFunctionReturn(0);
 }
 
@@ -669,6 +673,12 @@ PetscErrorCode PetscLogEventBeginDefault(PetscLogEvent event,int t,PetscObject o
     eventLog->eventInfo[event].mallocIncrease -= usage;
     ierr = PetscMallocPushMaximumUsage((int)event);CHKERRQ(ierr);
   }
+  if (PetscLogCounters) {
+    PetscLogDouble counters[PETSC_LOG_NUM_COUNTERS];
+    int            i;
+    ierr = PetscLogCountersRead(counters);CHKERRQ(ierr);
+    for (i=0; i<PETSC_LOG_NUM_COUNTERS; i++) eventLog->eventInfo[event].counters[i] -= counters[i];
+  }
   PetscFunctionReturn(0);
 }
 
@@ -708,6 +718,12 @@ PetscErrorCode PetscLogEventEndDefault(PetscLogEvent event,int t,PetscObject o1,
     ierr = PetscMallocGetMaximumUsage(&usage);CHKERRQ(ierr);
     eventLog->eventInfo[event].mallocIncrease += usage;
   }
+  if (PetscLogCounters) {
+    PetscLogDouble counters[PETSC_LOG_NUM_COUNTERS];
+    int            i;
+    ierr = PetscLogCountersRead(counters);CHKERRQ(ierr);
+    for (i=0; i<PETSC_LOG_NUM_COUNTERS; i++) eventLog->eventInfo[event].counters[i] += counters[i];
+  }
   PetscFunctionReturn(0);
 }
 
@@ -913,6 +913,15 @@ static PetscErrorCode PetscLogNestedTreePrintLine(PetscViewer viewer,PetscEventP
     ierr = PetscPrintXMLNestedLinePerfResults(viewer, "mflops", time>=timeMx*0.001 ? 1e-6*perfInfo.flops/time : 0, 0, 0.01, 1.05);CHKERRQ(ierr);
     ierr = PetscPrintXMLNestedLinePerfResults(viewer, "mbps",time>=timeMx*0.001 ? perfInfo.messageLength/(1024*1024*time) : 0, 0, 0.01, 1.05);CHKERRQ(ierr);
     ierr = PetscPrintXMLNestedLinePerfResults(viewer, "nreductsps", time>=timeMx*0.001 ? perfInfo.numReductions/time : 0, 0, 0.01, 1.05);CHKERRQ(ierr);
+    if (PetscLogCounters) {
+      PetscLogDouble cycles = perfInfo.counters[PETSC_LOG_COUNTER_CYCLES];
+      PetscLogDouble dram   = perfInfo.counters[PETSC_LOG_COUNTER_CACHE_MISSES]*PETSC_LEVEL1_DCACHE_LINESIZE;
+
+      ierr = PetscPrintXMLNestedLinePerfResults(viewer, "ipc", cycles>0 ? perfInfo.counters[PETSC_LOG_COUNTER_INSTRUCTIONS]/cycles : 0, 0, 0.01, 1.05);CHKERRQ(ierr);
+      ierr = PetscPrintXMLNestedLinePerfResults(viewer, "drammbps", time>=timeMx*0.001 ? dram/(1024*1024*time) : 0, 0, 0.01, 1.05);CHKERRQ(ierr);
+      ierr = PetscPrintXMLNestedLinePerfResults(viewer, "mvecinsps", time>=timeMx*0.001 ? 1e-6*perfInfo.counters[PETSC_LOG_COUNTER_VECTOR_INSTRUCTIONS]/time : 0, 0, 0.01, 1.05);CHKERRQ(ierr);
+      ierr = PetscPrintXMLNestedLinePerfResults(viewer, "intensity", dram>0 ? perfInfo.flops/dram : 0, 0, 0.01, 1.05);CHKERRQ(ierr);
+    }
   }
   PetscFunctionReturn(0);
 }
@@ -1030,7 +1039,7 @@ static PetscErrorCode PetscLogNestedTreePrint(PetscViewer viewer, PetscNestedEve
     countsPerCall = 0;
   } else {
   /* Set the values for a timer that was activated in this process */
-    int           i;
+    int           i, j;
     PetscLogEvent dftEvent   = tree[iStart].dftEvent;
 
     parentCount    = countParents( tree, eventPerfInfo, iStart);
@@ -1043,6 +1052,7 @@ static PetscErrorCode PetscLogNestedTreePrint(PetscViewer viewer, PetscNestedEve
     otherPerfInfo.numMessages   = 0;
     otherPerfInfo.messageLength = 0;
     otherPerfInfo.numReductions = 0;
+    for (j=0; j<PETSC_LOG_NUM_COUNTERS; j++) otherPerfInfo.counters[j] = 0;
 
     for (i=0; i<nChildren; i++) {
       /* For all child counters: subtract the child values from self-timers */
@@ -1055,6 +1065,7 @@ static PetscErrorCode PetscLogNestedTreePrint(PetscViewer viewer, PetscNestedEve
       selfPerfInfo.numMessages   -= childPerfInfo.numMessages;
       selfPerfInfo.messageLength -= childPerfInfo.messageLength;
       selfPerfInfo.numReductions -= childPerfInfo.numReductions;
+      for (j=0; j<PETSC_LOG_NUM_COUNTERS; j++) selfPerfInfo.counters[j] -= childPerfInfo.counters[j];
 
       if ((children[i].val/totalTime) < THRESHOLD) {
         /* Add them to 'other' if the time is ignored in the output */
@@ -1063,6 +1074,7 @@ static PetscErrorCode PetscLogNestedTreePrint(PetscViewer viewer, PetscNestedEve
         otherPerfInfo.numMessages   += childPerfInfo.numMessages;
         otherPerfInfo.messageLength += childPerfInfo.messageLength;
         otherPerfInfo.numReductions += childPerfInfo.numReductions;
+        for (j=0; j<PETSC_LOG_NUM_COUNTERS; j++) otherPerfInfo.counters[j] += childPerfInfo.counters[j];
       }
     }
   }
@@ -1198,6 +1210,7 @@ typedef struct {
   PetscLogDouble numMessages;
   PetscLogDouble messageLength;
   PetscLogDouble numReductions;
+  PetscLogDouble counters[PETSC_LOG_NUM_COUNTERS];
 } PetscSelfTimer;
 
 static PetscErrorCode PetscCalcSelfTime(PetscViewer viewer, PetscSelfTimer **p_self, int *p_nstMax)
@@ -1210,7 +1223,7 @@ static PetscErrorCode PetscCalcSelfTime(PetscViewer viewer, PetscSelfTimer **p_s
   PetscSelfTimer     *selftimes;
   PetscSelfTimer     *totaltimes;
   NestedEventId      *nstEvents;
-  int                i, j, maxDefaultTimer;
+  int                i, j, k, maxDefaultTimer;
   NestedEventId      nst;
   PetscLogEvent      dft;
   int                nstMax, nstMax_local;
@@ -1253,6 +1266,7 @@ static PetscErrorCode PetscCalcSelfTime(PetscViewer viewer, PetscSelfTimer **p_s
     totaltimes[nst].messageLength = 0;
     totaltimes[nst].numReductions = 0;
     totaltimes[nst].name          = NULL;
+    for (k=0; k<PETSC_LOG_NUM_COUNTERS; k++) totaltimes[nst].counters[k] = 0;
   }
 
   /* Calculate total-times */
@@ -1267,6 +1281,7 @@ static PetscErrorCode PetscCalcSelfTime(PetscViewer viewer, PetscSelfTimer **p_s
       totaltimes[nstEvent].numMessages   += eventPerfInfo[dftEvent].numMessages;
       totaltimes[nstEvent].messageLength += eventPerfInfo[dftEvent].messageLength;
       totaltimes[nstEvent].numReductions += eventPerfInfo[dftEvent].numReductions;
+      for (k=0; k<PETSC_LOG_NUM_COUNTERS; k++) totaltimes[nstEvent].counters[k] += eventPerfInfo[dftEvent].counters[k];
     }
     totaltimes[nstEvent].name = eventRegInfo[(PetscLogEvent)nstEvent].name;
   }
@@ -1288,6 +1303,7 @@ static PetscErrorCode PetscCalcSelfTime(PetscViewer viewer, PetscSelfTimer **p_s
         selftimes[nstParent].numMessages   -= eventPerfInfo[dftEvent].numMessages;
         selftimes[nstParent].messageLength -= eventPerfInfo[dftEvent].messageLength;
         selftimes[nstParent].numReductions -= eventPerfInfo[dftEvent].numReductions;
+        for (k=0; k<PETSC_LOG_NUM_COUNTERS; k++) selftimes[nstParent].counters[k] -= eventPerfInfo[dftEvent].counters[k];
       }
     }
   }
@@ -1349,6 +1365,7 @@ static PetscErrorCode PetscPrintSelfTime(PetscViewer viewer, const PetscSelfTime
       selfPerfInfo.numMessages   = selftimes[nstEvent].numMessages;
       selfPerfInfo.messageLength = selftimes[nstEvent].messageLength;
       selfPerfInfo.numReductions = selftimes[nstEvent].numReductions;
+      ierr = PetscMemcpy(selfPerfInfo.counters,selftimes[nstEvent].counters,sizeof(selfPerfInfo.counters));CHKERRQ(ierr);
 
       ierr = PetscLogNestedTreePrintLine(viewer, selfPerfInfo, dum_count, dum_parentcount, dum_depth, name, totalTime, &wasPrinted);CHKERRQ(ierr);
       if (wasPrinted){
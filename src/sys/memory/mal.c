@@ -23,9 +23,23 @@ PetscMemkindType previousmktype = PETSC_MK_HBW_PREFERRED;
 */
 #define SHIFT_CLASSID 456123
 
+/* The pooled allocator in mpool.c */
+PETSC_INTERN PetscBool petscmallocpool;
+PETSC_INTERN PetscBool petscmallocpoolinuse;
+PETSC_INTERN PetscErrorCode PetscMallocPoolGet_Private(size_t,void**,PetscBool*);
+PETSC_INTERN PetscErrorCode PetscMallocPoolPut_Private(void*,PetscBool*);
+PETSC_INTERN PetscErrorCode PetscMallocPoolSize_Private(void*,size_t*,PetscBool*);
+
 PETSC_EXTERN PetscErrorCode PetscMallocAlign(size_t mem,int line,const char func[],const char file[],void **result)
 {
   if (!mem) { *result = NULL; return 0; }
+  if (petscmallocpool) {
+    PetscBool      pooled;
+    PetscErrorCode ierr = PetscMallocPoolGet_Private(mem,result,&pooled);
+
+    if (ierr) return PetscError(PETSC_COMM_SELF,line,func,file,ierr,PETSC_ERROR_INITIAL,"Pooled allocator failed for %.0f bytes",(PetscLogDouble)mem);
+    if (pooled) return 0;
+  }
 #if defined(PETSC_HAVE_MEMKIND)
   {
     int ierr;
@@ -64,6 +78,13 @@ PETSC_EXTERN PetscErrorCode PetscMallocAlign(size_t mem,int line,const char func
 PETSC_EXTERN PetscErrorCode PetscFreeAlign(void *ptr,int line,const char func[],const char file[])
 {
   if (!ptr) return 0;
+  if (petscmallocpoolinuse) {
+    PetscBool      pooled;
+    PetscErrorCode ierr = PetscMallocPoolPut_Private(ptr,&pooled);
+
+    if (ierr) return PetscError(PETSC_COMM_SELF,line,func,file,ierr,PETSC_ERROR_INITIAL,"Pooled allocator failed to free memory");
+    if (pooled) return 0;
+  }
 #if defined(PETSC_HAVE_MEMKIND)
   memkind_free(0,ptr); /* specify the kind to 0 so that memkind will look up for the right type */
 #else
@@ -100,6 +121,24 @@ PETSC_EXTERN PetscErrorCode PetscReallocAlign(size_t mem, int line, const char f
     *result = NULL;
     return 0;
   }
+  if (petscmallocpoolinuse && *result) {
+    size_t    size;
+    PetscBool pooled;
+
+    ierr = PetscMallocPoolSize_Private(*result,&size,&pooled);
+    if (ierr) return PetscError(PETSC_COMM_SELF,line,func,file,ierr,PETSC_ERROR_INITIAL,"Pooled allocator failed");
+    if (pooled) {
+      void *newResult;
+
+      /* a block from the pool cannot be resized in place, move it unless it is already large enough */
+      if (mem <= size) return 0;
+      ierr = PetscMallocAlign(mem,line,func,file,&newResult);if (ierr) return ierr;
+      ierr = PetscMemcpy(newResult,*result,size);if (ierr) return ierr;
+      ierr = PetscFreeAlign(*result,line,func,file);if (ierr) return ierr;
+      *result = newResult;
+      return 0;
+    }
+  }
 #if defined(PETSC_HAVE_MEMKIND)
   if (!currentmktype) *result = memkind_realloc(MEMKIND_DEFAULT,*result,mem);
   else *result = memkind_realloc(MEMKIND_HBW_PREFERRED,*result,mem);
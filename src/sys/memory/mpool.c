@@ -0,0 +1,422 @@
+/*
+    A pooled allocator underneath PetscMallocAlign() and PetscFreeAlign(): small requests are served from free lists of
+  fixed size blocks carved out of slabs, one list per size class, and large arrays from huge page aligned mappings that
+  are cached when freed so that objects which are repeatedly created and destroyed do not go back to the system.
+
+    Since the pool sits below PetscMallocAlign() it is used by the -malloc_debug allocator in mtr.c (which keeps
+  accounting for the requested sizes) and by anything installed with PetscMallocSet() that calls PetscMallocAlign().
+*/
+#include <petsc/private/petscimpl.h>   /*I   "petscsys.h"   I*/
+#if defined(PETSC_HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+#if defined(PETSC_HAVE_MMAP)
+#include <sys/mman.h>
+#endif
+
+#define POOL_NUM_CLASSES  23          /* 32, 48, 64, 96, ..., 49152, 65536 bytes */
+#define POOL_MIN_SLAB     65536
+#define POOL_HUGE_PAGE    2097152
+#define POOL_HUGE         -1          /* region class of a large mapping */
+#define POOL_MAX_CACHE    64
+
+typedef struct _n_PetscPoolBlock *PetscPoolBlock;
+struct _n_PetscPoolBlock {
+  PetscPoolBlock next;
+};
+
+typedef struct {
+  char   *base;
+  size_t len;
+  int    cls;                         /* size class of a slab or POOL_HUGE */
+} PetscPoolRegion;
+
+typedef struct {
+  size_t         size;                /* block size of this class */
+  PetscPoolBlock free;                /* freed blocks */
+  char           *bump,*end;          /* the part of the newest slab not handed out yet */
+  PetscSpinlock  lock;
+  PetscLogDouble nget,nslab;
+} PetscPoolClass;
+
+PETSC_INTERN PetscBool petscmallocpool;
+PETSC_INTERN PetscBool petscmallocpoolinuse;
+PetscBool petscmallocpool      = PETSC_FALSE;  /* new requests go to the pool */
+PetscBool petscmallocpoolinuse = PETSC_FALSE;  /* some memory has come from the pool, frees must check for it */
+
+static PetscPoolClass  poolClass[POOL_NUM_CLASSES];
+static PetscPoolRegion *poolRegion = NULL;     /* slabs and large mappings sorted by address */
+static int             poolNumRegions = 0,poolMaxRegions = 0;
+#if defined(PETSC_HAVE_THREADSAFETY)
+static PetscSpinlock   poolRegionLock;       /* the registry and the cache of large mappings */
+#endif
+#if defined(PETSC_HAVE_MMAP)
+static size_t          poolHugeSize = POOL_HUGE_PAGE;
+#else
+static size_t          poolHugeSize = 0;              /* large mappings could not be returned to the system */
+#endif
+static int             poolHugeCacheMax = 8;
+static PetscPoolRegion poolHugeCache[POOL_MAX_CACHE];
+static int             poolHugeCacheNum = 0;
+static PetscLogDouble  poolHugeGet = 0,poolHugeHit = 0,poolHugeBytes = 0,poolSlabBytes = 0;
+
+static PetscErrorCode PetscPoolMap(size_t len,size_t align,void **p)
+{
+#if defined(PETSC_HAVE_MMAP)
+  char *q;
+
+  if (align == POOL_HUGE_PAGE) {
+    size_t shift;
+
+    /* map one huge page more than needed and trim the ends to get an aligned start */
+    q = (char*)mmap(NULL,len+align,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+    if (q == (char*)MAP_FAILED) {*p = NULL; return 0;}
+    shift = (align - ((PETSC_UINTPTR_T)q) % align) % align;
+    if (shift) munmap(q,shift);
+    munmap(q+shift+len,align-shift);
+    q += shift;
+#if defined(MADV_HUGEPAGE)
+    madvise(q,len,MADV_HUGEPAGE);
+#endif
+  } else {
+    /* page aligned, which is enough for the small size classes */
+    q = (char*)mmap(NULL,len,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+    if (q == (char*)MAP_FAILED) {*p = NULL; return 0;}
+  }
+  *p = q;
+#else
+  *p = malloc(len+align);  /* never returned to the system, so the unaligned start does not need to be kept */
+  if (*p) *p = (void*)((char*)*p + (align - ((PETSC_UINTPTR_T)*p) % align) % align);
+#endif
+  return 0;
+}
+
+/* position of the region containing p, or of the first region above it */
+static int PetscPoolRegionFind(const char *p)
+{
+  int lo = 0,hi = poolNumRegions;
+
+  while (lo < hi) {
+    int mid = (lo + hi)/2;
+    if (poolRegion[mid].base + poolRegion[mid].len <= p) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+/* registers a new slab or large mapping and counts its bytes, both under the registry lock */
+static PetscErrorCode PetscPoolRegionInsert(char *base,size_t len,int cls)
+{
+  PetscErrorCode ierr;
+  int            i;
+
+  ierr = PetscSpinlockLock(&poolRegionLock);if (ierr) return ierr;
+  if (poolNumRegions == poolMaxRegions) {
+    PetscPoolRegion *r;
+    /* the registry cannot come from PetscMalloc() since it is used by PetscMallocAlign() */
+    r = (PetscPoolRegion*)realloc(poolRegion,(poolMaxRegions ? 2*poolMaxRegions : 256)*sizeof(PetscPoolRegion));
+    if (!r) {ierr = PetscSpinlockUnlock(&poolRegionLock); return ierr ? ierr : PETSC_ERR_MEM;}
+    poolRegion     = r;
+    poolMaxRegions = poolMaxRegions ? 2*poolMaxRegions : 256;
+  }
+  i = PetscPoolRegionFind(base);
+  memmove(poolRegion+i+1,poolRegion+i,(poolNumRegions-i)*sizeof(PetscPoolRegion));
+  poolRegion[i].base = base;
+  poolRegion[i].len  = len;
+  poolRegion[i].cls  = cls;
+  poolNumRegions++;
+  if (cls == POOL_HUGE) poolHugeBytes += len;
+  else                  poolSlabBytes += len;
+  petscmallocpoolinuse = PETSC_TRUE;
+  return PetscSpinlockUnlock(&poolRegionLock);
+}
+
+/* the region containing p, copied out since the registry may move when another thread adds a slab */
+static PetscErrorCode PetscPoolRegionLookup(const void *p,PetscPoolRegion *region,PetscBool *found)
+{
+  PetscErrorCode ierr;
+  int            i;
+
+  *found = PETSC_FALSE;
+  ierr = PetscSpinlockLock(&poolRegionLock);if (ierr) return ierr;
+  i = PetscPoolRegionFind((const char*)p);
+  if (i < poolNumRegions && poolRegion[i].base <= (const char*)p) {
+    *region = poolRegion[i];
+    *found  = PETSC_TRUE;
+  }
+  return PetscSpinlockUnlock(&poolRegionLock);
+}
+
+static int PetscPoolClassOf(size_t mem)
+{
+  int lo = 0,hi = POOL_NUM_CLASSES-1;
+
+  while (lo < hi) {
+    int mid = (lo + hi)/2;
+    if (poolClass[mid].size < mem) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+static PetscErrorCode PetscPoolGetSmall(int c,void **result)
+{
+  PetscPoolClass *pc = &poolClass[c];
+  PetscErrorCode ierr;
+
+  ierr = PetscSpinlockLock(&pc->lock);if (ierr) return ierr;
+  pc->nget++;
+  if (pc->free) {
+    *result  = (void*)pc->free;
+    pc->free = pc->free->next;
+  } else {
+    if (pc->bump + pc->size > pc->end) {
+      size_t len = PetscMax(POOL_MIN_SLAB,8*pc->size);
+      void   *slab;
+
+      ierr = PetscPoolMap(len,PETSC_MEMALIGN,&slab);
+      if (!ierr && slab) ierr = PetscPoolRegionInsert((char*)slab,len,c);
+      if (ierr || !slab) {
+        PetscErrorCode ierru = PetscSpinlockUnlock(&pc->lock);
+
+        *result = NULL;
+        return ierr ? ierr : ierru;
+      }
+      pc->bump       = (char*)slab;
+      pc->end        = (char*)slab + len;
+      pc->nslab++;
+    }
+    *result   = (void*)pc->bump;
+    pc->bump += pc->size;
+  }
+  return PetscSpinlockUnlock(&pc->lock);
+}
+
+static PetscErrorCode PetscPoolGetHuge(size_t mem,void **result)
+{
+  size_t         len = ((mem + POOL_HUGE_PAGE-1)/POOL_HUGE_PAGE)*POOL_HUGE_PAGE;
+  int            i,best = -1;
+  PetscErrorCode ierr;
+
+  /* reuse the smallest cached mapping that is at most twice as large as needed */
+  ierr = PetscSpinlockLock(&poolRegionLock);if (ierr) return ierr;
+  poolHugeGet++;
+  for (i=0; i<poolHugeCacheNum; i++) {
+    if (poolHugeCache[i].len >= len && poolHugeCache[i].len <= 2*len && (best < 0 || poolHugeCache[i].len < poolHugeCache[best].len)) best = i;
+  }
+  if (best >= 0) {
+    *result = (void*)poolHugeCache[best].base;
+    poolHugeCache[best] = poolHugeCache[--poolHugeCacheNum];
+    poolHugeHit++;
+    return PetscSpinlockUnlock(&poolRegionLock);
+  }
+  ierr = PetscSpinlockUnlock(&poolRegionLock);if (ierr) return ierr;
+  ierr = PetscPoolMap(len,POOL_HUGE_PAGE,result);if (ierr) return ierr;
+  if (!*result) return 0;
+  return PetscPoolRegionInsert((char*)*result,len,POOL_HUGE);
+}
+
+static PetscErrorCode PetscPoolPutHuge(const PetscPoolRegion *region)
+{
+  PetscPoolRegion evict;
+  PetscBool       unmap = PETSC_FALSE;
+  PetscErrorCode  ierr;
+
+  ierr = PetscSpinlockLock(&poolRegionLock);if (ierr) return ierr;
+  if (poolHugeCacheMax <= 0) {
+    evict = *region;
+    unmap = PETSC_TRUE;
+  } else {
+    if (poolHugeCacheNum == poolHugeCacheMax) {
+      /* drop the oldest cached mapping */
+      evict = poolHugeCache[0];
+      unmap = PETSC_TRUE;
+      memmove(poolHugeCache,poolHugeCache+1,(poolHugeCacheNum-1)*sizeof(PetscPoolRegion));
+      poolHugeCacheNum--;
+    }
+    poolHugeCache[poolHugeCacheNum++] = *region;
+  }
+  if (unmap) {
+    int i = PetscPoolRegionFind(evict.base);
+    memmove(poolRegion+i,poolRegion+i+1,(poolNumRegions-i-1)*sizeof(PetscPoolRegion));
+    poolNumRegions--;
+    poolHugeBytes -= evict.len;
+  }
+  ierr = PetscSpinlockUnlock(&poolRegionLock);if (ierr) return ierr;
+#if defined(PETSC_HAVE_MMAP)
+  if (unmap) munmap(evict.base,evict.len);
+#endif
+  return 0;
+}
+
+/*
+   PetscMallocPoolGet_Private - Gets memory from the pool, pooled is PETSC_FALSE if the request should go to the system
+*/
+PETSC_INTERN PetscErrorCode PetscMallocPoolGet_Private(size_t mem,void **result,PetscBool *pooled)
+{
+  PetscErrorCode ierr;
+
+  *pooled = PETSC_FALSE;
+  if (mem <= poolClass[POOL_NUM_CLASSES-1].size) {
+    ierr = PetscPoolGetSmall(PetscPoolClassOf(mem),result);if (ierr) return ierr;
+  } else if (poolHugeSize && mem >= poolHugeSize) {
+    ierr = PetscPoolGetHuge(mem,result);if (ierr) return ierr;
+  } else return 0;
+  if (*result) *pooled = PETSC_TRUE;
+  return 0;
+}
+
+/*
+   PetscMallocPoolPut_Private - Returns memory to the pool, pooled is PETSC_FALSE if ptr did not come from the pool
+*/
+PETSC_INTERN PetscErrorCode PetscMallocPoolPut_Private(void *ptr,PetscBool *pooled)
+{
+  PetscPoolRegion region;
+  PetscPoolClass  *pc;
+  PetscPoolBlock  block = (PetscPoolBlock)ptr;
+  PetscErrorCode  ierr;
+
+  ierr = PetscPoolRegionLookup(ptr,&region,pooled);if (ierr) return ierr;
+  if (!*pooled) return 0;
+  if (region.cls == POOL_HUGE) return PetscPoolPutHuge(&region);
+  pc   = &poolClass[region.cls];
+  ierr = PetscSpinlockLock(&pc->lock);if (ierr) return ierr;
+  block->next = pc->free;
+  pc->free    = block;
+  return PetscSpinlockUnlock(&pc->lock);
+}
+
+/*
+   PetscMallocPoolSize_Private - Gives the usable size of a block from the pool, pooled is PETSC_FALSE if ptr did not come from the pool
+*/
+PETSC_INTERN PetscErrorCode PetscMallocPoolSize_Private(void *ptr,size_t *size,PetscBool *pooled)
+{
+  PetscPoolRegion region;
+  PetscErrorCode  ierr;
+
+  ierr = PetscPoolRegionLookup(ptr,&region,pooled);if (ierr) return ierr;
+  if (*pooled) *size = region.cls == POOL_HUGE ? region.len : poolClass[region.cls].size;
+  return 0;
+}
+
+/*@C
+   PetscMallocSetPool - Use a pooled allocator underneath PetscMallocAlign()
+
+   Not Collective
+
+   Input Parameter:
+.  pool - PETSC_TRUE to serve new requests from the pool
+
+   Options Database Keys:
++  -malloc_pool - turn the pooled allocator on or off
+.  -malloc_pool_huge_size <bytes> - arrays at least this large get their own huge page aligned mapping (default 2 megabytes, 0 to leave them to the system), a multiple of the page size
+.  -malloc_pool_huge_cache <n> - number of freed large mappings kept for reuse (default 8)
+-  -malloc_pool_view - print statistics of the pool in PetscFinalize()
+
+   Notes:
+   Requests up to 64 kilobytes are rounded up to one of 23 size classes (two per power of two) and served from a free list
+   for that class; each class gets its memory in slabs of at least 64 kilobytes that are never returned to the system.
+   Arrays of at least the huge size get a mapping aligned to, and advised for, transparent huge pages; when freed the
+   mapping is cached and given to the next request that fits in it, so vectors and matrices that are created and destroyed
+   repeatedly keep their (already faulted in) pages. Everything in between goes to the system malloc().
+
+   The pool sits underneath PetscMallocAlign(), so -malloc_debug and routines installed with PetscMallocSet() keep working
+   on top of it, and memory obtained before the pool was turned on (or after it was turned off) is freed correctly.
+   Free lists are protected with PetscSpinlock when PETSc is configured --with-threadsafety.
+
+   Level: developer
+
+.seealso: PetscMallocA(), PetscMallocSetPoolHuge(), PetscMallocPoolView(), PetscMallocSetCoalesce()
+@*/
+PetscErrorCode PetscMallocSetPool(PetscBool pool)
+{
+  static PetscBool setup = PETSC_FALSE;
+  PetscErrorCode   ierr;
+  int              c;
+
+  PetscFunctionBegin;
+  if (pool && !setup) {
+    for (c=0; c<POOL_NUM_CLASSES; c++) {
+      size_t size = ((size_t)32 << c/2)*(c%2 ? 3 : 2)/2;
+
+      poolClass[c].size = (size + PETSC_MEMALIGN-1) & ~(size_t)(PETSC_MEMALIGN-1);
+      ierr = PetscSpinlockCreate(&poolClass[c].lock);CHKERRQ(ierr);
+    }
+    ierr  = PetscSpinlockCreate(&poolRegionLock);CHKERRQ(ierr);
+    setup = PETSC_TRUE;
+  }
+  petscmallocpool = pool;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscMallocSetPoolHuge - Sets how the pooled allocator treats large arrays
+
+   Not Collective
+
+   Input Parameters:
++  size - arrays of at least this many bytes get their own huge page aligned mapping, 0 to send them to the system malloc();
+          a multiple of the page size
+-  ncache - the number of freed mappings kept for reuse
+
+   Options Database Keys:
++  -malloc_pool_huge_size <bytes> - the size
+-  -malloc_pool_huge_cache <n> - the number of cached mappings
+
+   Level: developer
+
+.seealso: PetscMallocSetPool()
+@*/
+PetscErrorCode PetscMallocSetPoolHuge(size_t size,PetscInt ncache)
+{
+  PetscFunctionBegin;
+  if (ncache < 0 || ncache > POOL_MAX_CACHE) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of cached mappings must be between 0 and %d",POOL_MAX_CACHE);
+#if !defined(PETSC_HAVE_MMAP)
+  if (size) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Pooling large arrays requires mmap()");
+#endif
+  if (size && size <= (size_t)65536) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Huge size must be larger than the largest size class of 65536 bytes");
+#if defined(PETSC_HAVE_MMAP)
+  {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    if (size % page) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Huge size %D must be a multiple of the page size %D",(PetscInt)size,(PetscInt)page);
+  }
+#endif
+  if ((int)ncache < poolHugeCacheNum) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Cannot shrink the cache of large mappings once it is in use");
+  poolHugeSize     = size;
+  poolHugeCacheMax = (int)ncache;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscMallocPoolView - Prints statistics of the pooled allocator on this process
+
+   Not Collective
+
+   Input Parameter:
+.  fp - file pointer, if NULL stdout is used
+
+   Options Database Key:
+.  -malloc_pool_view - calls PetscMallocPoolView() from PetscFinalize()
+
+   Level: developer
+
+.seealso: PetscMallocSetPool(), PetscMallocDump()
+@*/
+PetscErrorCode PetscMallocPoolView(FILE *fp)
+{
+  PetscLogDouble nget = 0,nslab = 0;
+  PetscMPIInt    rank;
+  PetscErrorCode ierr;
+  int            c;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(MPI_COMM_WORLD,&rank);CHKERRQ(ierr);
+  if (!fp) fp = PETSC_STDOUT;
+  for (c=0; c<POOL_NUM_CLASSES; c++) {nget += poolClass[c].nget; nslab += poolClass[c].nslab;}
+  fprintf(fp,"[%d]Pooled allocator: %.0f small requests from %.0f slabs of %.0f bytes total\n",rank,nget,nslab,poolSlabBytes);
+  fprintf(fp,"[%d]Pooled allocator: %.0f large requests, %.0f reused a cached mapping, %.0f bytes mapped\n",rank,poolHugeGet,poolHugeHit,poolHugeBytes);
+  for (c=0; c<POOL_NUM_CLASSES; c++) {
+    if (poolClass[c].nget) fprintf(fp,"[%d]  %6.0f bytes: %.0f requests, %.0f slabs\n",rank,(PetscLogDouble)poolClass[c].size,poolClass[c].nget,poolClass[c].nslab);
+  }
+  PetscFunctionReturn(0);
+}
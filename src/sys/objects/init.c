@@ -259,6 +259,9 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
 #if !defined(PETSC_HAVE_THREADSAFETY)
   PetscReal         logthreshold;
 #endif
+#if defined(PETSC_HAVE_OPENMP)
+  PetscInt          nthreads;
+#endif
 #if defined(PETSC_USE_LOG)
   PetscViewerFormat format;
   PetscBool         flg4 = PETSC_FALSE;
@@ -324,6 +327,18 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
   }
 #endif
 
+  flg1 = PETSC_FALSE;
+  ierr = PetscOptionsGetBool(NULL,NULL,"-malloc_pool",&flg1,NULL);CHKERRQ(ierr);
+  if (flg1) {
+    PetscInt hugesize = 2097152,hugecache = 8;
+
+    ierr = PetscOptionsGetInt(NULL,NULL,"-malloc_pool_huge_size",&hugesize,&flg2);CHKERRQ(ierr);
+    ierr = PetscOptionsGetInt(NULL,NULL,"-malloc_pool_huge_cache",&hugecache,&flg3);CHKERRQ(ierr);
+    if (hugesize < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"-malloc_pool_huge_size %D must not be negative",hugesize);
+    if (flg2 || flg3) {ierr = PetscMallocSetPoolHuge((size_t)hugesize,hugecache);CHKERRQ(ierr);}
+    ierr = PetscMallocSetPool(PETSC_TRUE);CHKERRQ(ierr);
+  }
+
 #if defined(PETSC_USE_LOG)
   ierr = PetscOptionsHasName(NULL,NULL,"-objects_dump",&PetscObjectsLog);CHKERRQ(ierr);
 #endif
@@ -405,6 +420,17 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
   ierr = PetscOptionsGetInt(NULL,NULL,"-check_pointer_intensity",&intensity,&flag);CHKERRQ(ierr);
   if (flag) {ierr = PetscCheckPointerSetIntensity(intensity);CHKERRQ(ierr);}
 
+#if defined(PETSC_HAVE_OPENMP)
+  /*
+      Setup the number of OpenMP threads used by the threaded kernels, the default is set by the OpenMP runtime (OMP_NUM_THREADS)
+  */
+  ierr = PetscOptionsGetInt(NULL,NULL,"-omp_num_threads",&nthreads,&flag);CHKERRQ(ierr);
+  if (flag) {
+    if (nthreads < 1) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of OpenMP threads %D must be positive",nthreads);
+    omp_set_num_threads((int)nthreads);
+  }
+#endif
+
   /*
       Setup debugger information
   */
@@ -537,12 +563,23 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
     if (PetscLogMemory) {
       ierr = PetscSetUseTrMalloc_Private();CHKERRQ(ierr);
     }
+    flg1 = PETSC_FALSE;
+    ierr = PetscOptionsGetBool(NULL,NULL,"-log_view_counters",&flg1,NULL);CHKERRQ(ierr);
+    if (flg1) {ierr = PetscLogCountersBegin();CHKERRQ(ierr);}
   }
   if (flg4 && format == PETSC_VIEWER_ASCII_XML) {
     PetscReal threshold = PetscRealConstant(0.01);
     ierr = PetscOptionsGetReal(NULL,NULL,"-log_threshold",&threshold,&flg1);CHKERRQ(ierr);
     if (flg1) {ierr = PetscLogSetThreshold((PetscLogDouble)threshold,NULL);CHKERRQ(ierr);}
   }
+
+  /* wraps the logging functions set above */
+  ierr = PetscOptionsHasName(NULL,NULL,"-log_timeline",&flg1);CHKERRQ(ierr);
+  if (flg1) {
+    PetscInt size = PETSC_DEFAULT;
+    ierr = PetscOptionsGetInt(NULL,NULL,"-log_timeline_size",&size,NULL);CHKERRQ(ierr);
+    ierr = PetscLogTimelineBegin(size);CHKERRQ(ierr);
+  }
 #endif
 
   ierr = PetscOptionsGetBool(NULL,NULL,"-saws_options",&PetscOptionsPublish,NULL);CHKERRQ(ierr);
@@ -638,6 +675,9 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
     ierr = (*PetscHelpPrintf)(comm," -stop_for_debugger : prints message on how to attach debugger manually\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm,"                      waits the delay for you to attach\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -display display: Location where X window graphics and debuggers are displayed\n");CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP)
+    ierr = (*PetscHelpPrintf)(comm," -omp_num_threads <n>: number of OpenMP threads used by the threaded kernels\n");CHKERRQ(ierr);
+#endif
     ierr = (*PetscHelpPrintf)(comm," -no_signal_handler: do not trap error signals\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -mpi_return_on_error: MPI returns error code, rather than abort on internal error\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -fp_trap: stop on floating point exceptions\n");CHKERRQ(ierr);
@@ -648,6 +688,7 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
     ierr = (*PetscHelpPrintf)(comm," -malloc_info: prints total memory usage\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -malloc_log: keeps log of all memory allocations\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -malloc_debug: enables extended checking for memory corruption\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -malloc_pool: serve PetscMalloc() from size class free lists and cached huge page mappings\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -options_view: dump list of options inputted\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -options_left: dump list of unused options\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -options_left no: don't dump list of unused options\n");CHKERRQ(ierr);
@@ -658,7 +699,11 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
 #if defined(PETSC_USE_LOG)
     ierr = (*PetscHelpPrintf)(comm," -get_total_flops: total flops over all processors\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -log_view [:filename:[format]]: logging objects and events\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -log_view_counters: adds hardware counters to -log_view\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -log_trace [filename]: prints trace of all PETSc calls\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -log_timeline [filename]: writes a Chrome trace of all events at the end of the run\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -log_timeline_size <n>: number of events kept on each process\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -log_timeline_signal: writes the timeline of a process when it receives SIGUSR1\n");CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MPE)
     ierr = (*PetscHelpPrintf)(comm," -log_mpe: Also create logfile viewable through Jumpshot\n");CHKERRQ(ierr);
 #endif
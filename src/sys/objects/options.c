@@ -33,7 +33,7 @@
 #define PetscOptNameCmp(a,b) Error_strcasecmp_not_found
 #endif
 
-#include <petsc/private/hashtable.h>
+#include <petsc/private/hashmap.h>
 
 /* This assumes ASCII encoding and ignores locale settings */
 /* Using tolower() is about 2X slower in microbenchmarks   */
@@ -62,25 +62,27 @@ PETSC_STATIC_INLINE int PetscOptEqual(const char a[],const char b[])
   return !PetscOptNameCmp(a,b);
 }
 
-KHASH_INIT(HO, kh_cstr_t, int, 1, PetscOptHash, PetscOptEqual)
+PETSC_HASH_MAP(HMapO, kh_cstr_t, PetscInt, PetscOptHash, PetscOptEqual, -1)
 
 /*
-    This table holds all the options set by the user. For simplicity, we use a static size database
+    This table holds all the options set by the user. The options are kept in the order they were
+    inserted, in arrays that grow as needed, and a hash table maps each (prefixed) name to its
+    location in the arrays. Routines that print the database sort the names first.
 */
 #define MAXOPTNAME 512
-#define MAXOPTIONS 512
 #define MAXALIASES  25
 #define MAXPREFIXES 25
 #define MAXOPTIONSMONITORS 5
 
 struct  _n_PetscOptions {
   int        N;                    /* number of options */
-  char       *names[MAXOPTIONS];   /* option names */
-  char       *values[MAXOPTIONS];  /* option values */
-  PetscBool  used[MAXOPTIONS];     /* flag option use */
+  int        Nalloc;               /* allocated length of names, values and used */
+  char       **names;              /* option names */
+  char       **values;             /* option values */
+  PetscBool  *used;                /* flag option use */
 
-  /* Hash table */
-  khash_t(HO) *ht;
+  /* Hash table, name to index in names[] */
+  PetscHMapO ht;
 
   /* Prefixes */
   int   prefixind;
@@ -104,6 +106,32 @@ struct  _n_PetscOptions {
 
 static PetscOptions defaultoptions = NULL;
 
+static int PetscOptionsNameCompare(const void *a,const void *b)
+{
+  return PetscOptNameCmp(**(char***)a,**(char***)b);
+}
+
+/*
+    Returns the indices of the options sorted by name, so the database is printed in a reproducible order.
+    Uses malloc() directly since it may be called from an error handler; free the result with free()
+*/
+static PetscErrorCode PetscOptionsGetSortedOrder_Private(PetscOptions options,int **order)
+{
+  char ***p;
+  int  i,N = options->N;
+
+  *order = NULL;
+  if (!N) return 0;
+  p      = (char***)malloc(N*sizeof(char**));
+  *order = (int*)malloc(N*sizeof(int));
+  if (!p || !*order) {free(p); free(*order); *order = NULL; return PETSC_ERR_MEM;}
+  for (i=0; i<N; i++) p[i] = options->names + i;
+  qsort(p,N,sizeof(char**),PetscOptionsNameCompare);
+  for (i=0; i<N; i++) (*order)[i] = (int)(p[i] - options->names);
+  free(p);
+  return 0;
+}
+
 
 /*
     Options events monitor
@@ -652,7 +680,7 @@ PetscErrorCode PetscOptionsInsert(PetscOptions options,int *argc,char ***args,co
 PetscErrorCode PetscOptionsView(PetscOptions options,PetscViewer viewer)
 {
   PetscErrorCode ierr;
-  PetscInt       i;
+  int            i,j,*order;
   PetscBool      isascii;
 
   PetscFunctionBegin;
@@ -667,8 +695,10 @@ PetscErrorCode PetscOptionsView(PetscOptions options,PetscViewer viewer)
     PetscFunctionReturn(0);
   }
 
+  ierr = PetscOptionsGetSortedOrder_Private(options,&order);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"#PETSc Option Table entries:\n");CHKERRQ(ierr);
-  for (i=0; i<options->N; i++) {
+  for (j=0; j<options->N; j++) {
+    i = order[j];
     if (options->values[i]) {
       ierr = PetscViewerASCIIPrintf(viewer,"-%s %s\n",options->names[i],options->values[i]);CHKERRQ(ierr);
     } else {
@@ -676,6 +706,7 @@ PetscErrorCode PetscOptionsView(PetscOptions options,PetscViewer viewer)
     }
   }
   ierr = PetscViewerASCIIPrintf(viewer,"#End of PETSc Option Table entries\n");CHKERRQ(ierr);
+  free(order);
   PetscFunctionReturn(0);
 }
 
@@ -684,7 +715,7 @@ PetscErrorCode PetscOptionsView(PetscOptions options,PetscViewer viewer)
 */
 PETSC_EXTERN PetscErrorCode PetscOptionsViewError(void)
 {
-  PetscInt     i;
+  int          i,j,*order = NULL;
   PetscOptions options = defaultoptions;
 
   PetscFunctionBegin;
@@ -693,13 +724,16 @@ PETSC_EXTERN PetscErrorCode PetscOptionsViewError(void)
   } else {
     (*PetscErrorPrintf)("No PETSc Option Table entries\n");
   }
-  for (i=0; i<options->N; i++) {
+  (void)PetscOptionsGetSortedOrder_Private(options,&order);
+  for (j=0; j<options->N; j++) {
+    i = order ? order[j] : j;
     if (options->values[i]) {
       (*PetscErrorPrintf)("-%s %s\n",options->names[i],options->values[i]);
     } else {
       (*PetscErrorPrintf)("-%s\n",options->names[i]);
     }
   }
+  free(order);
   PetscFunctionReturn(0);
 }
 
@@ -788,7 +822,8 @@ PetscErrorCode PetscOptionsPrefixPop(PetscOptions options)
 @*/
 PetscErrorCode PetscOptionsClear(PetscOptions options)
 {
-  PetscInt i;
+  PetscInt       i;
+  PetscErrorCode ierr;
 
   options = options ? options : defaultoptions;
   if (!options) return 0;
@@ -797,7 +832,14 @@ PetscErrorCode PetscOptionsClear(PetscOptions options)
     if (options->names[i])  free(options->names[i]);
     if (options->values[i]) free(options->values[i]);
   }
-  options->N = 0;
+  free(options->names);
+  free(options->values);
+  free(options->used);
+  options->names  = NULL;
+  options->values = NULL;
+  options->used   = NULL;
+  options->N      = 0;
+  options->Nalloc = 0;
 
   for (i=0; i<options->Naliases; i++) {
     free(options->aliases1[i]);
@@ -806,8 +848,7 @@ PetscErrorCode PetscOptionsClear(PetscOptions options)
   options->Naliases = 0;
 
   /* destroy hash table */
-  kh_destroy(HO,options->ht);
-  options->ht = NULL;
+  ierr = PetscHMapODestroy(&options->ht);if (ierr) return ierr;
 
   options->prefixind = 0;
   options->prefix[0] = 0;
@@ -888,8 +929,8 @@ PetscErrorCode PetscOptionsSetAlias(PetscOptions options,const char newname[],co
 PetscErrorCode PetscOptionsSetValue(PetscOptions options,const char name[],const char value[])
 {
   size_t         len;
-  int            N,n,i;
-  char           **names;
+  int            N,i;
+  PetscInt       n;
   char           fullname[MAXOPTNAME] = "";
   PetscErrorCode ierr;
 
@@ -921,38 +962,42 @@ PetscErrorCode PetscOptionsSetValue(PetscOptions options,const char name[],const
     if (!result) { name = options->aliases2[i]; break; }
   }
 
-  /* slow search */
-  N = n = options->N;
-  names = options->names;
-  for (i=0; i<N; i++) {
-    int result = PetscOptNameCmp(names[i],name);
-    if (!result) {
-      n = i; goto setvalue;
-    } else if (result > 0) {
-      n = i; break;
-    }
+  /* fast search */
+  if (!options->ht) {
+    ierr = PetscHMapOCreate(&options->ht);if (ierr) return ierr;
   }
-  if (N >= MAXOPTIONS) return PETSC_ERR_MEM;
-  /* shift remaining values up 1 */
-  for (i=N; i>n; i--) {
-    options->names[i]  = options->names[i-1];
-    options->values[i] = options->values[i-1];
-    options->used[i]   = options->used[i-1];
-  }
-  options->names[n]  = NULL;
-  options->values[n] = NULL;
-  options->used[n]   = PETSC_FALSE;
-  options->N++;
+  ierr = PetscHMapOGet(options->ht,name,&n);if (ierr) return ierr;
+  if (n >= 0) goto setvalue;
 
-  /* destroy hash table */
-  kh_destroy(HO,options->ht);
-  options->ht = NULL;
+  /* grow the arrays, doubling their length */
+  N = options->N;
+  if (N >= options->Nalloc) {
+    int       Nalloc = options->Nalloc ? 2*options->Nalloc : 128;
+    char      **names,**values;
+    PetscBool *used;
+
+    names  = (char**)realloc(options->names,Nalloc*sizeof(char*));
+    if (!names) return PETSC_ERR_MEM;
+    options->names  = names;
+    values = (char**)realloc(options->values,Nalloc*sizeof(char*));
+    if (!values) return PETSC_ERR_MEM;
+    options->values = values;
+    used   = (PetscBool*)realloc(options->used,Nalloc*sizeof(PetscBool));
+    if (!used) return PETSC_ERR_MEM;
+    options->used   = used;
+    options->Nalloc = Nalloc;
+  }
 
   /* set new name */
+  n   = N;
   len = strlen(name);
   options->names[n] = (char*)malloc((len+1)*sizeof(char));
   if (!options->names[n]) return PETSC_ERR_MEM;
   strcpy(options->names[n],name);
+  options->values[n] = NULL;
+  options->used[n]   = PETSC_FALSE;
+  ierr = PetscHMapOSet(options->ht,options->names[n],n);if (ierr) return ierr;
+  options->N++;
 
 setvalue:
   /* set new value */
@@ -988,8 +1033,8 @@ setvalue:
 @*/
 PetscErrorCode PetscOptionsClearValue(PetscOptions options,const char name[])
 {
-  int            N,n,i;
-  char           **names;
+  int            N;
+  PetscInt       n = -1;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -1002,33 +1047,22 @@ PetscErrorCode PetscOptionsClearValue(PetscOptions options,const char name[])
 
   name++; /* skip starting dash */
 
-  /* slow search */
-  N = n = options->N;
-  names = options->names;
-  for (i=0; i<N; i++) {
-    int result = PetscOptNameCmp(names[i],name);
-    if (!result) {
-      n = i; break;
-    } else if (result > 0) {
-      n = N; break;
-    }
-  }
-  if (n == N) PetscFunctionReturn(0); /* it was not present */
+  /* fast search */
+  if (options->ht) {ierr = PetscHMapOGet(options->ht,name,&n);CHKERRQ(ierr);}
+  if (n < 0) PetscFunctionReturn(0); /* it was not present */
 
   /* remove name and value */
+  ierr = PetscHMapODel(options->ht,name);CHKERRQ(ierr);
   if (options->names[n])  free(options->names[n]);
   if (options->values[n]) free(options->values[n]);
-  /* shift remaining values down 1 */
-  for (i=n; i<N-1; i++) {
-    options->names[i]  = options->names[i+1];
-    options->values[i] = options->values[i+1];
-    options->used[i]   = options->used[i+1];
+  /* move the last option into the hole */
+  N = --options->N;
+  if (n < N) {
+    options->names[n]  = options->names[N];
+    options->values[n] = options->values[N];
+    options->used[n]   = options->used[N];
+    ierr = PetscHMapOSet(options->ht,options->names[n],n);CHKERRQ(ierr);
   }
-  options->N--;
-
-  /* destroy hash table */
-  kh_destroy(HO,options->ht);
-  options->ht = NULL;
 
   ierr = PetscOptionsMonitor(options,name,NULL);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -1057,7 +1091,6 @@ PetscErrorCode PetscOptionsClearValue(PetscOptions options,const char name[])
 PetscErrorCode PetscOptionsFindPair(PetscOptions options,const char pre[],const char name[],const char *value[],PetscBool *set)
 {
   char           buf[MAXOPTNAME];
-  PetscBool      usehashtable = PETSC_TRUE;
   PetscBool      matchnumbers = PETSC_TRUE;
   PetscErrorCode ierr;
 
@@ -1087,47 +1120,15 @@ PetscErrorCode PetscOptionsFindPair(PetscOptions options,const char pre[],const
   }
 #endif
 
-  if (!options->ht && usehashtable) {
-    int i,ret;
-    khiter_t it;
-    khash_t(HO) *ht;
-    ht = kh_init(HO);
-    if (PetscUnlikely(!ht)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_MEM,"Hash table allocation failed");
-    ret = kh_resize(HO,ht,options->N*2); /* twice the required size to reduce risk of collisions */
-    if (PetscUnlikely(ret)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_MEM,"Hash table allocation failed");
-    for (i=0; i<options->N; i++) {
-      it = kh_put(HO,ht,options->names[i],&ret);
-      if (PetscUnlikely(ret != 1)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_MEM,"Hash table allocation failed");
-      kh_val(ht,it) = i;
-    }
-    options->ht = ht;
-  }
-
-  if (usehashtable)
   { /* fast search */
-    khash_t(HO) *ht = options->ht;
-    khiter_t it = kh_get(HO,ht,name);
-    if (it != kh_end(ht)) {
-      int i = kh_val(ht,it);
+    PetscInt i = -1;
+    if (options->ht) {ierr = PetscHMapOGet(options->ht,name,&i);CHKERRQ(ierr);}
+    if (i >= 0) {
       options->used[i]  = PETSC_TRUE;
       if (value) *value = options->values[i];
       if (set)   *set   = PETSC_TRUE;
       PetscFunctionReturn(0);
     }
-  } else
-  { /* slow search */
-    int i, N = options->N;
-    for (i=0; i<N; i++) {
-      int result = PetscOptNameCmp(options->names[i],name);
-      if (!result) {
-        options->used[i]  = PETSC_TRUE;
-        if (value) *value = options->values[i];
-        if (set)   *set   = PETSC_TRUE;
-        PetscFunctionReturn(0);
-      } else if (result > 0) {
-        break;
-      }
-    }
   }
 
   /*
@@ -1218,7 +1219,7 @@ PETSC_EXTERN PetscErrorCode PetscOptionsFindPairPrefix_Private(PetscOptions opti
   }
 
   { /* slow search */
-    int       c, i;
+    int       c, i, found;
     size_t    len;
     PetscBool match;
 
@@ -1233,14 +1234,16 @@ PETSC_EXTERN PetscErrorCode PetscOptionsFindPairPrefix_Private(PetscOptions opti
         ierr = PetscStrlcat(opt,name+loce[c],sizeof(opt));CHKERRQ(ierr);
       }
       ierr = PetscStrlen(opt,&len);CHKERRQ(ierr);
-      for (i=0; i<options->N; i++) {
+      /* the options are not sorted, take the first match in alphabetical order */
+      for (i=0, found=-1; i<options->N; i++) {
         ierr = PetscStrncmp(options->names[i],opt,len,&match);CHKERRQ(ierr);
-        if (match) {
-          options->used[i]  = PETSC_TRUE;
-          if (value) *value = options->values[i];
-          if (set)   *set   = PETSC_TRUE;
-          PetscFunctionReturn(0);
-        }
+        if (match && (found < 0 || PetscOptNameCmp(options->names[i],options->names[found]) < 0)) found = i;
+      }
+      if (found >= 0) {
+        options->used[found] = PETSC_TRUE;
+        if (value) *value    = options->values[found];
+        if (set)   *set      = PETSC_TRUE;
+        PetscFunctionReturn(0);
       }
     }
   }
@@ -1377,7 +1380,7 @@ PetscErrorCode PetscOptionsHasName(PetscOptions options,const char pre[],const c
 PetscErrorCode PetscOptionsGetAll(PetscOptions options,char *copts[])
 {
   PetscErrorCode ierr;
-  PetscInt       i;
+  int            i,j,*order;
   size_t         len = 1,lent = 0;
   char           *coptions = NULL;
 
@@ -1394,8 +1397,10 @@ PetscErrorCode PetscOptionsGetAll(PetscOptions options,char *copts[])
     }
   }
   ierr = PetscMalloc1(len,&coptions);CHKERRQ(ierr);
+  ierr = PetscOptionsGetSortedOrder_Private(options,&order);CHKERRQ(ierr);
   coptions[0] = 0;
-  for (i=0; i<options->N; i++) {
+  for (j=0; j<options->N; j++) {
+    i = order[j];
     ierr = PetscStrcat(coptions,"-");CHKERRQ(ierr);
     ierr = PetscStrcat(coptions,options->names[i]);CHKERRQ(ierr);
     ierr = PetscStrcat(coptions," ");CHKERRQ(ierr);
@@ -1404,6 +1409,7 @@ PetscErrorCode PetscOptionsGetAll(PetscOptions options,char *copts[])
       ierr = PetscStrcat(coptions," ");CHKERRQ(ierr);
     }
   }
+  free(order);
   *copts = coptions;
   PetscFunctionReturn(0);
 }
@@ -1426,21 +1432,15 @@ PetscErrorCode PetscOptionsGetAll(PetscOptions options,char *copts[])
 @*/
 PetscErrorCode PetscOptionsUsed(PetscOptions options,const char *name,PetscBool *used)
 {
-  PetscInt       i;
+  PetscInt       i = -1;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
   PetscValidCharPointer(name,2);
   PetscValidPointer(used,3);
   options = options ? options : defaultoptions;
-  *used = PETSC_FALSE;
-  for (i=0; i<options->N; i++) {
-    ierr = PetscStrcmp(options->names[i],name,used);CHKERRQ(ierr);
-    if (*used) {
-      *used = options->used[i];
-      break;
-    }
-  }
+  if (options->ht) {ierr = PetscHMapOGet(options->ht,name,&i);CHKERRQ(ierr);}
+  *used = i >= 0 ? options->used[i] : PETSC_FALSE;
   PetscFunctionReturn(0);
 }
 
@@ -1492,11 +1492,13 @@ PetscErrorCode PetscOptionsAllUsed(PetscOptions options,PetscInt *N)
 PetscErrorCode PetscOptionsLeft(PetscOptions options)
 {
   PetscErrorCode ierr;
-  PetscInt       i;
+  int            i,j,*order;
 
   PetscFunctionBegin;
   options = options ? options : defaultoptions;
-  for (i=0; i<options->N; i++) {
+  ierr = PetscOptionsGetSortedOrder_Private(options,&order);CHKERRQ(ierr);
+  for (j=0; j<options->N; j++) {
+    i = order[j];
     if (!options->used[i]) {
       if (options->values[i]) {
         ierr = PetscPrintf(PETSC_COMM_WORLD,"Option left: name:-%s value: %s\n",options->names[i],options->values[i]);CHKERRQ(ierr);
@@ -1505,6 +1507,7 @@ PetscErrorCode PetscOptionsLeft(PetscOptions options)
       }
     }
   }
+  free(order);
   PetscFunctionReturn(0);
 }
 
@@ -1531,7 +1534,8 @@ PetscErrorCode PetscOptionsLeft(PetscOptions options)
 PetscErrorCode PetscOptionsLeftGet(PetscOptions options,PetscInt *N,char **names[],char **values[])
 {
   PetscErrorCode ierr;
-  PetscInt       i,n;
+  PetscInt       n;
+  int            i,j,*order;
 
   PetscFunctionBegin;
   if (N) PetscValidIntPointer(N,2);
@@ -1550,13 +1554,16 @@ PetscErrorCode PetscOptionsLeftGet(PetscOptions options,PetscInt *N,char **names
 
   n = 0;
   if (names || values) {
-    for (i=0; i<options->N; i++) {
+    ierr = PetscOptionsGetSortedOrder_Private(options,&order);CHKERRQ(ierr);
+    for (j=0; j<options->N; j++) {
+      i = order[j];
       if (!options->used[i]) {
         if (names)  (*names)[n]  = options->names[i];
         if (values) (*values)[n] = options->values[i];
         n++;
       }
     }
+    free(order);
   }
   PetscFunctionReturn(0);
 }
@@ -691,6 +691,7 @@ int64_t Petsc_adios_group;
 .  -malloc_debug - check for memory corruption at EVERY malloc or free
 .  -malloc_dump - prints a list of all unfreed memory at the end of the run
 .  -malloc_test - like -malloc_dump -malloc_debug, but only active for debugging builds
+.  -malloc_pool - use a pooled allocator for PetscMalloc(), see PetscMallocSetPool()
 .  -fp_trap - Stops on floating point exceptions (Note that on the
               IBM RS6000 this slows code by at least a factor of 10.)
 .  -no_signal_handler - Indicates not to trap error signals
@@ -698,7 +699,8 @@ int64_t Petsc_adios_group;
 .  -not_shared_tmp - each processor has own /tmp
 .  -tmp - alternative name of /tmp directory
 .  -get_total_flops - returns total flops done by all processors
--  -memory_view - Print memory usage at end of run
+.  -memory_view - Print memory usage at end of run
+-  -omp_num_threads <n> - number of OpenMP threads used by the threaded sequential kernels (only if configured --with-openmp)
 
    Options Database Keys for Profiling:
    See Users-Manual: ch_profiling for details.
@@ -709,10 +711,12 @@ int64_t Petsc_adios_group;
 .  -log_trace [filename] - Print traces of all PETSc calls to the screen (useful to determine where a program
         hangs without running in the debugger).  See PetscLogTraceBegin().
 .  -log_view [:filename:format] - Prints summary of flop and timing information to screen or file, see PetscLogView().
+.  -log_view_counters - Adds hardware counters (cycles, instructions, cache misses, vector instructions) to -log_view, see PetscLogCountersBegin().
 .  -log_summary [filename] - (Deprecated, use -log_view) Prints summary of flop and timing information to screen. If the filename is specified the
         summary is written to the file.  See PetscLogView().
 .  -log_exclude: <vec,mat,pc,ksp,snes> - excludes subset of object classes from logging
 .  -log_all [filename] - Logs extensive profiling information  See PetscLogDump().
+.  -log_timeline [filename] - Writes a Chrome trace of the events on all processes, see PetscLogTimelineBegin().
 .  -log [filename] - Logs basic profiline information  See PetscLogDump().
 .  -log_mpe [filename] - Creates a logfile viewable by the utility Jumpshot (in MPICH distribution)
 .  -viewfromoptions on,off - Enable or disable XXXSetFromOptions() calls, for applications with many small solves turn this off
@@ -1141,7 +1145,7 @@ PetscErrorCode  PetscFinalize(void)
   PetscMPIInt    rank;
   PetscInt       nopt;
   PetscBool      flg1 = PETSC_FALSE,flg2 = PETSC_FALSE,flg3 = PETSC_FALSE;
-  PetscBool      flg;
+  PetscBool      flg,poolview = PETSC_FALSE;
 #if defined(PETSC_USE_LOG)
   char           mname[PETSC_MAX_PATH_LEN];
 #endif
@@ -1318,6 +1322,10 @@ PetscErrorCode  PetscFinalize(void)
   ierr = PetscOptionsGetString(NULL,NULL,"-log_all",mname,PETSC_MAX_PATH_LEN,&flg1);CHKERRQ(ierr);
   ierr = PetscOptionsGetString(NULL,NULL,"-log",mname,PETSC_MAX_PATH_LEN,&flg2);CHKERRQ(ierr);
   if (flg1 || flg2) {ierr = PetscLogDump(mname);CHKERRQ(ierr);}
+
+  mname[0] = 0;
+  ierr = PetscOptionsGetString(NULL,NULL,"-log_timeline",mname,PETSC_MAX_PATH_LEN,&flg1);CHKERRQ(ierr);
+  if (flg1) {ierr = PetscLogTimelineDump(mname);CHKERRQ(ierr);}
 #endif
 
   ierr = PetscStackDestroy();CHKERRQ(ierr);
@@ -1345,6 +1353,8 @@ PetscErrorCode  PetscFinalize(void)
     ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
   }
 
+  ierr = PetscOptionsGetBool(NULL,NULL,"-malloc_pool_view",&poolview,NULL);CHKERRQ(ierr);
+
   /* to prevent PETSc -options_left from warning */
   ierr = PetscOptionsHasName(NULL,NULL,"-nox",&flg1);CHKERRQ(ierr);
   ierr = PetscOptionsHasName(NULL,NULL,"-nox_warning",&flg1);CHKERRQ(ierr);
@@ -1471,6 +1481,16 @@ PetscErrorCode  PetscFinalize(void)
     }
   }
 
+  if (poolview) {
+    MPI_Comm local_comm;
+
+    ierr = MPI_Comm_dup(MPI_COMM_WORLD,&local_comm);CHKERRQ(ierr);
+    ierr = PetscSequentialPhaseBegin_Private(local_comm,1);CHKERRQ(ierr);
+    ierr = PetscMallocPoolView(stdout);CHKERRQ(ierr);
+    ierr = PetscSequentialPhaseEnd_Private(local_comm,1);CHKERRQ(ierr);
+    ierr = MPI_Comm_free(&local_comm);CHKERRQ(ierr);
+  }
+
   {
     char fname[PETSC_MAX_PATH_LEN];
     FILE *fd = NULL;
@@ -623,6 +623,11 @@ PetscErrorCode IJacobian(TS ts,PetscReal t,Vec U,Vec Udot,PetscReal a,Mat A,Mat
       output_file: output/ex5adj_3.out
       requires: knl
 
+   test:
+      suffix: async_io
+      nsize: 2
+      args: -ts_max_steps 10 -ts_monitor -ts_adjoint_monitor -ts_trajectory_type memory -ts_trajectory_solution_only 0 -ts_trajectory_stride 5 -ts_trajectory_async_io -ts_trajectory_compress
+
    test:
       suffix: sell
       nsize: 4
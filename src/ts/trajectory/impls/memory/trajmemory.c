@@ -1,8 +1,16 @@
 #include <petsc/private/tsimpl.h>        /*I "petscts.h"  I*/
 #include <petscsys.h>
+#include <petsctime.h>
 #if defined(PETSC_HAVE_REVOLVE)
 #include <revolve_c.h>
 #endif
+#if defined(PETSC_HAVE_PTHREAD)
+#include <pthread.h>
+#endif
+#if defined(PETSC_HAVE_SYS_TIME_H)
+#include <sys/time.h>
+#endif
+#include <errno.h>
 
 PetscLogEvent TSTrajectory_DiskWrite, TSTrajectory_DiskRead;
 static PetscErrorCode TSTrajectorySet_Memory(TSTrajectory,TS,PetscInt,PetscReal,Vec);
@@ -47,6 +55,44 @@ typedef struct _DiskStack {
   PetscInt  *container;
 } DiskStack;
 
+typedef enum {TJIO_WRITE,TJIO_READ} TJIOJobType;
+
+typedef struct _TJIOJob *TJIOJob;
+struct _TJIOJob {
+  TJIOJobType type;
+  char        filename[PETSC_MAX_PATH_LEN];
+  char        *buf;     /* raw blocks, each preceded by its size */
+  size_t      len,cap;
+  PetscBool   compress;
+  PetscBool   pending;  /* submitted and not yet waited for */
+  PetscBool   done;     /* set by the I/O thread */
+  int         status;   /* errno of a failed operation */
+  double      iotime;   /* seconds spent by the I/O thread on this job */
+  size_t      raw;      /* payload bytes of the blocks, without their headers */
+  size_t      stored;   /* payload bytes in the file, without the block headers */
+  TJIOJob     next;
+};
+
+typedef struct _TJIO {
+  PetscBool       async;     /* write and prefetch checkpoints in a background thread */
+  PetscBool       compress;  /* compress checkpoint blocks losslessly */
+  struct _TJIOJob wjob[2];   /* double buffered writes */
+  PetscInt        wcur;
+  struct _TJIOJob rjob;      /* prefetched or requested read */
+  char            *scratch;  /* only touched while executing a job */
+  size_t          scratchcap;
+#if defined(PETSC_HAVE_PTHREAD)
+  PetscBool       running;
+  PetscBool       shutdown;
+  pthread_t       thread;
+  pthread_mutex_t lock;
+  pthread_cond_t  submitted,finished;
+  TJIOJob         head,tail;
+#endif
+  PetscLogDouble  iotime,waittime,rawbytes,storedbytes;
+  PetscInt        reads,prefetched;
+} TJIO;
+
 typedef struct _TJScheduler {
   SchedulerType stype;
 #if defined(PETSC_HAVE_REVOLVE)
@@ -64,6 +110,7 @@ typedef struct _TJScheduler {
   Stack         stack;
   DiskStack     diskstack;
   PetscViewer   viewer;
+  TJIO          io;
 } TJScheduler;
 
 static PetscErrorCode TurnForwardWithStepsize(TS ts,PetscReal nextstepsize)
@@ -251,6 +298,484 @@ static PetscErrorCode StackFind(Stack *stack,StackElement *e,PetscInt index)
   PetscFunctionReturn(0);
 }
 
+/*
+   Asynchronous and compressed disk tier, enabled with -ts_trajectory_async_io or -ts_trajectory_compress.
+
+   Every rank writes its local part of a checkpoint file to a file of its own, so the I/O thread never calls MPI or PETSc.
+   A file is a sequence of blocks, one per time step. Each block has two size_t (raw and stored size) followed by the
+   payload. The payload is stored raw when compressing it does not save space. In memory the blocks are kept raw, each
+   preceded by its size.
+*/
+typedef struct {
+  PetscInt  stepnum;
+  PetscReal time;
+  PetscReal timeprev;
+} TJIOBlockHeader;
+
+PETSC_STATIC_INLINE PetscBool TJIOEnabled(TJIO *io)
+{
+  return (io->async || io->compress) ? PETSC_TRUE : PETSC_FALSE;
+}
+
+static double TJIOWallTime(void)
+{
+#if defined(PETSC_HAVE_GETTIMEOFDAY) && defined(PETSC_HAVE_SYS_TIME_H)
+  struct timeval tp;
+
+  gettimeofday(&tp,NULL);
+  return (double)tp.tv_sec+1.e-6*(double)tp.tv_usec;
+#else
+  return 0.0;
+#endif
+}
+
+static int TJIOGrow(char **buf,size_t *cap,size_t size)
+{
+  char *newbuf;
+
+  if (size <= *cap) return 0;
+  size   = PetscMax(size,2*(*cap));
+  newbuf = (char*)realloc(*buf,size);
+  if (!newbuf) return ENOMEM;
+  *buf = newbuf;
+  *cap = size;
+  return 0;
+}
+
+/*
+   Lossless codec for blocks of floating point numbers: each 8 byte word is XORed with its predecessor and the bytes are
+   grouped by significance, which turns the slowly varying sign and exponent bytes into runs of zeros. The result is run
+   length encoded: a control byte c < 128 is followed by c+1 literal bytes, c >= 128 by one byte repeated c-126 times.
+   Returns the encoded size in dst, or 0 when the encoding is not smaller than the input. tmp holds n bytes.
+*/
+static size_t TJIOEncode(const unsigned char *src,size_t n,unsigned char *tmp,unsigned char *dst)
+{
+  const size_t w = 8,nw = n/w;
+  size_t       i,b,r,o = 0,ctrl = 0,nlit = 0;
+
+  if (nw) {
+    for (b=0; b<w; b++) {
+      tmp[b*nw] = src[b];
+      for (i=1; i<nw; i++) tmp[b*nw+i] = src[i*w+b]^src[(i-1)*w+b];
+    }
+  }
+  for (i=nw*w; i<n; i++) tmp[i] = src[i];
+  for (i=0; i<n;) {
+    for (r=1; i+r<n && r<129 && tmp[i+r] == tmp[i]; r++) ;
+    if (r >= 3) {
+      if (o+2 >= n) return 0;
+      dst[o++] = (unsigned char)(r+126);
+      dst[o++] = tmp[i];
+      i       += r;
+      nlit     = 0;
+    } else {
+      if (!nlit) {
+        if (o+1 >= n) return 0;
+        ctrl = o++;
+      }
+      if (o+1 >= n) return 0;
+      dst[o++]  = tmp[i++];
+      dst[ctrl] = (unsigned char)nlit++;
+      if (nlit == 128) nlit = 0;
+    }
+  }
+  return o;
+}
+
+/* Inverse of TJIOEncode(), returns nonzero if src does not decode to exactly n bytes */
+static int TJIODecode(const unsigned char *src,size_t m,unsigned char *tmp,unsigned char *dst,size_t n)
+{
+  const size_t w = 8,nw = n/w;
+  size_t       i,b,c,o = 0;
+
+  for (i=0; i<m;) {
+    c = src[i++];
+    if (c < 128) {
+      if (i+c+1 > m || o+c+1 > n) return 1;
+      memcpy(tmp+o,src+i,c+1);
+      i += c+1;
+      o += c+1;
+    } else {
+      if (i >= m || o+c-126 > n) return 1;
+      memset(tmp+o,src[i++],c-126);
+      o += c-126;
+    }
+  }
+  if (o != n) return 1;
+  for (b=0; b<w; b++) {
+    if (nw) dst[b] = tmp[b*nw];
+    for (i=1; i<nw; i++) dst[i*w+b] = tmp[b*nw+i]^dst[(i-1)*w+b];
+  }
+  for (i=nw*w; i<n; i++) dst[i] = tmp[i];
+  return 0;
+}
+
+/* Performs a job, called by the I/O thread or, without one, by the main thread; uses only the C library */
+static void TJIOExecute(TJIO *io,TJIOJob job)
+{
+  FILE   *fp;
+  size_t hdr[2],off = 0;
+  char   *payload;
+  double t0 = TJIOWallTime();
+
+  job->status = 0;
+  job->raw    = 0;
+  job->stored = 0;
+  if (job->type == TJIO_WRITE) {
+    fp = fopen(job->filename,"wb");
+    if (!fp) job->status = errno ? errno : EIO;
+    while (fp && !job->status && off < job->len) {
+      memcpy(&hdr[0],job->buf+off,sizeof(size_t));
+      off    += sizeof(size_t);
+      hdr[1]  = hdr[0];
+      payload = job->buf+off;
+      if (job->compress) {
+        if ((job->status = TJIOGrow(&io->scratch,&io->scratchcap,2*hdr[0]))) break;
+        hdr[1] = TJIOEncode((unsigned char*)payload,hdr[0],(unsigned char*)io->scratch,(unsigned char*)io->scratch+hdr[0]);
+        if (hdr[1]) payload = io->scratch+hdr[0];
+        else hdr[1] = hdr[0];
+      }
+      if (fwrite(hdr,sizeof(size_t),2,fp) != 2 || fwrite(payload,1,hdr[1],fp) != hdr[1]) job->status = errno ? errno : EIO;
+      job->raw    += hdr[0];
+      job->stored += hdr[1];
+      off         += hdr[0];
+    }
+    if (fp && fclose(fp) && !job->status) job->status = errno ? errno : EIO;
+  } else {
+    job->len = 0;
+    fp = fopen(job->filename,"rb");
+    if (!fp) job->status = errno ? errno : EIO;
+    while (fp && !job->status && fread(hdr,sizeof(size_t),2,fp) == 2) {
+      if (hdr[1] > hdr[0]) {job->status = EIO; break;}
+      if ((job->status = TJIOGrow(&job->buf,&job->cap,job->len+sizeof(size_t)+hdr[0]))) break;
+      memcpy(job->buf+job->len,&hdr[0],sizeof(size_t));
+      payload = job->buf+job->len+sizeof(size_t);
+      if (hdr[1] == hdr[0]) {
+        if (fread(payload,1,hdr[0],fp) != hdr[0]) job->status = EIO;
+      } else {
+        if ((job->status = TJIOGrow(&io->scratch,&io->scratchcap,hdr[0]+hdr[1]))) break;
+        if (fread(io->scratch,1,hdr[1],fp) != hdr[1]) job->status = EIO;
+        else if (TJIODecode((unsigned char*)io->scratch,hdr[1],(unsigned char*)io->scratch+hdr[1],(unsigned char*)payload,hdr[0])) job->status = EIO;
+      }
+      job->raw    += hdr[0];
+      job->stored += hdr[1];
+      job->len    += sizeof(size_t)+hdr[0];
+    }
+    if (fp && !job->status && ferror(fp)) job->status = EIO;
+    if (fp) fclose(fp);
+  }
+  job->iotime = TJIOWallTime()-t0;
+}
+
+#if defined(PETSC_HAVE_PTHREAD)
+static void *TJIOWorker(void *ctx)
+{
+  TJIO    *io = (TJIO*)ctx;
+  TJIOJob job;
+
+  pthread_mutex_lock(&io->lock);
+  while (1) {
+    while (!io->head && !io->shutdown) pthread_cond_wait(&io->submitted,&io->lock);
+    if (!io->head) break;
+    job      = io->head;
+    io->head = job->next;
+    if (!io->head) io->tail = NULL;
+    pthread_mutex_unlock(&io->lock);
+    TJIOExecute(io,job);
+    pthread_mutex_lock(&io->lock);
+    job->done = PETSC_TRUE;
+    pthread_cond_broadcast(&io->finished);
+  }
+  pthread_mutex_unlock(&io->lock);
+  return NULL;
+}
+#endif
+
+static PetscErrorCode TJIOSetUp(TSTrajectory tj,TJIO *io)
+{
+  MPI_Comm       comm;
+  PetscMPIInt    rank;
+  char           dirname[PETSC_MAX_PATH_LEN];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!TJIOEnabled(io)) PetscFunctionReturn(0);
+  /* the checkpoint directory may have been created and named by the first process only */
+  ierr = PetscObjectGetComm((PetscObject)tj,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  if (!rank) {
+    ierr = PetscStrncpy(dirname,tj->dirname,sizeof(dirname));CHKERRQ(ierr);
+  }
+  ierr = MPI_Bcast(dirname,sizeof(dirname),MPI_CHAR,0,comm);CHKERRQ(ierr);
+  if (rank) {
+    ierr = PetscFree(tj->dirname);CHKERRQ(ierr);
+    ierr = PetscStrallocpy(dirname,&tj->dirname);CHKERRQ(ierr);
+  }
+  if (!io->async) PetscFunctionReturn(0);
+#if defined(PETSC_HAVE_PTHREAD)
+  if (io->running) PetscFunctionReturn(0);
+  io->head     = io->tail = NULL;
+  io->shutdown = PETSC_FALSE;
+  if (pthread_mutex_init(&io->lock,NULL) || pthread_cond_init(&io->submitted,NULL) || pthread_cond_init(&io->finished,NULL)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SYS,"Could not initialize the checkpoint I/O thread synchronization");
+  if (pthread_create(&io->thread,NULL,TJIOWorker,io)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SYS,"Could not create the checkpoint I/O thread");
+  io->running = PETSC_TRUE;
+#else
+  ierr = PetscInfo(tj,"No thread support, checkpoints are written synchronously\n");CHKERRQ(ierr);
+  io->async = PETSC_FALSE;
+#endif
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TJIOSubmit(TJIO *io,TJIOJob job)
+{
+  PetscLogDouble t0,t1;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  job->pending = PETSC_TRUE;
+  job->done    = PETSC_FALSE;
+  job->next    = NULL;
+#if defined(PETSC_HAVE_PTHREAD)
+  if (io->running) {
+    pthread_mutex_lock(&io->lock);
+    if (io->tail) io->tail->next = job;
+    else io->head = job;
+    io->tail = job;
+    pthread_cond_signal(&io->submitted);
+    pthread_mutex_unlock(&io->lock);
+    PetscFunctionReturn(0);
+  }
+#endif
+  ierr = PetscTime(&t0);CHKERRQ(ierr);
+  TJIOExecute(io,job);
+  job->done = PETSC_TRUE;
+  ierr = PetscTime(&t1);CHKERRQ(ierr);
+  io->waittime += t1-t0;
+  PetscFunctionReturn(0);
+}
+
+/* Blocks until the job has been performed; the status of the job is left for the caller to check */
+static PetscErrorCode TJIOWait(TJIO *io,TJIOJob job)
+{
+#if defined(PETSC_HAVE_PTHREAD)
+  PetscLogDouble t0,t1;
+  PetscErrorCode ierr;
+#endif
+
+  PetscFunctionBegin;
+  if (!job->pending) PetscFunctionReturn(0);
+#if defined(PETSC_HAVE_PTHREAD)
+  if (io->running) {
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    pthread_mutex_lock(&io->lock);
+    while (!job->done) pthread_cond_wait(&io->finished,&io->lock);
+    pthread_mutex_unlock(&io->lock);
+    ierr = PetscTime(&t1);CHKERRQ(ierr);
+    io->waittime += t1-t0;
+  }
+#endif
+  job->pending = PETSC_FALSE;
+  io->iotime  += job->iotime;
+  if (job->type == TJIO_WRITE) {
+    io->rawbytes    += job->raw;
+    io->storedbytes += job->stored;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TJIOCheckWrite(TJIO *io,TJIOJob job)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = TJIOWait(io,job);CHKERRQ(ierr);
+  if (job->status) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_WRITE,"Could not write checkpoint file %s: %s",job->filename,strerror(job->status));
+  job->status = 0;
+  PetscFunctionReturn(0);
+}
+
+/* Waits for all outstanding jobs and stops the I/O thread */
+static PetscErrorCode TJIOFinalize(TSTrajectory tj,TJIO *io)
+{
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = TJIOWait(io,&io->rjob);CHKERRQ(ierr);
+  for (i=0; i<2; i++) {
+    ierr = TJIOCheckWrite(io,&io->wjob[i]);CHKERRQ(ierr);
+  }
+#if defined(PETSC_HAVE_PTHREAD)
+  if (io->running) {
+    pthread_mutex_lock(&io->lock);
+    io->shutdown = PETSC_TRUE;
+    pthread_cond_signal(&io->submitted);
+    pthread_mutex_unlock(&io->lock);
+    if (pthread_join(io->thread,NULL)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SYS,"Could not join the checkpoint I/O thread");
+    pthread_cond_destroy(&io->submitted);
+    pthread_cond_destroy(&io->finished);
+    pthread_mutex_destroy(&io->lock);
+    io->running = PETSC_FALSE;
+  }
+#endif
+  for (i=0; i<2; i++) {
+    free(io->wjob[i].buf);
+    io->wjob[i].buf = NULL;
+    io->wjob[i].cap = io->wjob[i].len = 0;
+  }
+  free(io->rjob.buf);
+  free(io->scratch);
+  io->rjob.buf     = io->scratch    = NULL;
+  io->rjob.cap     = io->scratchcap = 0;
+  io->rjob.len     = 0;
+  if (io->iotime > 0.0) {
+    ierr = PetscInfo4(tj,"Checkpoint I/O took %g s, the main thread waited %g s, %g bytes written as %g bytes\n",io->iotime,io->waittime,io->rawbytes,io->storedbytes);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TJIOGetFileName(TSTrajectory tj,const char prefix[],PetscInt id,char filename[],size_t len)
+{
+  PetscMPIInt    rank;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)tj),&rank);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(filename,len,"%s/%s%06d-%d.bin",tj->dirname,prefix,(int)id,(int)rank);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Returns an empty write buffer for filename, waiting for the write that used it before to complete */
+static PetscErrorCode TJIOBeginWrite(TJIO *io,const char filename[],TJIOJob *job)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  io->wcur = (io->wcur+1)%2;
+  *job     = &io->wjob[io->wcur];
+  ierr = TJIOCheckWrite(io,*job);CHKERRQ(ierr);
+  ierr = PetscStrncpy((*job)->filename,filename,sizeof((*job)->filename));CHKERRQ(ierr);
+  (*job)->type     = TJIO_WRITE;
+  (*job)->compress = io->compress;
+  (*job)->len      = 0;
+  /* a prefetch of this file queued before the write would return the old contents */
+  if (io->rjob.pending && !strcmp(io->rjob.filename,filename)) {
+    ierr = TJIOWait(io,&io->rjob);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TJIOPackBlock(TJIOJob job,PetscInt stepnum,PetscReal time,PetscReal timeprev,Vec X,Vec *Y,PetscInt numY,PetscBool solution_only)
+{
+  TJIOBlockHeader   hdr;
+  PetscInt          i,n,nv = solution_only ? 1 : 1+numY;
+  size_t            rawsize = sizeof(TJIOBlockHeader);
+  const PetscScalar *x;
+  char              *p;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<nv; i++) {
+    ierr     = VecGetLocalSize(i ? Y[i-1] : X,&n);CHKERRQ(ierr);
+    rawsize += (size_t)n*sizeof(PetscScalar);
+  }
+  if (TJIOGrow(&job->buf,&job->cap,job->len+sizeof(size_t)+rawsize)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_MEM,"Could not allocate checkpoint buffer");
+  p            = job->buf+job->len;
+  hdr.stepnum  = stepnum;
+  hdr.time     = time;
+  hdr.timeprev = timeprev;
+  ierr = PetscMemcpy(p,&rawsize,sizeof(size_t));CHKERRQ(ierr);
+  p   += sizeof(size_t);
+  ierr = PetscMemcpy(p,&hdr,sizeof(hdr));CHKERRQ(ierr);
+  p   += sizeof(hdr);
+  for (i=0; i<nv; i++) {
+    ierr = VecGetLocalSize(i ? Y[i-1] : X,&n);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(i ? Y[i-1] : X,&x);CHKERRQ(ierr);
+    ierr = PetscMemcpy(p,x,n*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(i ? Y[i-1] : X,&x);CHKERRQ(ierr);
+    p   += n*sizeof(PetscScalar);
+  }
+  job->len += sizeof(size_t)+rawsize;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TJIOUnpackBlock(TJIOJob job,size_t *off,PetscInt *stepnum,PetscReal *time,PetscReal *timeprev,Vec X,Vec *Y,PetscInt numY,PetscBool solution_only)
+{
+  TJIOBlockHeader hdr;
+  PetscInt        i,n,nv = solution_only ? 1 : 1+numY;
+  size_t          rawsize,expected = sizeof(TJIOBlockHeader);
+  PetscScalar     *x;
+  const char      *p;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<nv; i++) {
+    ierr      = VecGetLocalSize(i ? Y[i-1] : X,&n);CHKERRQ(ierr);
+    expected += (size_t)n*sizeof(PetscScalar);
+  }
+  if (*off+sizeof(size_t) > job->len) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"Checkpoint file %s has fewer steps than expected",job->filename);
+  p    = job->buf+*off;
+  ierr = PetscMemcpy(&rawsize,p,sizeof(size_t));CHKERRQ(ierr);
+  if (rawsize != expected || *off+sizeof(size_t)+rawsize > job->len) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"Checkpoint file %s does not match the layout of the solution",job->filename);
+  p   += sizeof(size_t);
+  ierr = PetscMemcpy(&hdr,p,sizeof(hdr));CHKERRQ(ierr);
+  p   += sizeof(hdr);
+  for (i=0; i<nv; i++) {
+    ierr = VecGetLocalSize(i ? Y[i-1] : X,&n);CHKERRQ(ierr);
+    ierr = VecGetArray(i ? Y[i-1] : X,&x);CHKERRQ(ierr);
+    ierr = PetscMemcpy(x,p,n*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = VecRestoreArray(i ? Y[i-1] : X,&x);CHKERRQ(ierr);
+    p   += n*sizeof(PetscScalar);
+  }
+  *stepnum  = hdr.stepnum;
+  *time     = hdr.time;
+  *timeprev = hdr.timeprev;
+  *off     += sizeof(size_t)+rawsize;
+  PetscFunctionReturn(0);
+}
+
+/* Returns the contents of filename, using the prefetched copy if there is one */
+static PetscErrorCode TJIORead(TJIO *io,const char filename[],TJIOJob *job)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *job = &io->rjob;
+  io->reads++;
+  if (io->rjob.pending && !strcmp(io->rjob.filename,filename)) {
+    ierr = TJIOWait(io,&io->rjob);CHKERRQ(ierr);
+    if (!io->rjob.status) {
+      io->prefetched++;
+      PetscFunctionReturn(0);
+    }
+  }
+  ierr = TJIOWait(io,&io->rjob);CHKERRQ(ierr);
+  ierr = PetscStrncpy(io->rjob.filename,filename,sizeof(io->rjob.filename));CHKERRQ(ierr);
+  io->rjob.type = TJIO_READ;
+  ierr = TJIOSubmit(io,&io->rjob);CHKERRQ(ierr);
+  ierr = TJIOWait(io,&io->rjob);CHKERRQ(ierr);
+  if (io->rjob.status) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_READ,"Could not read checkpoint file %s: %s",filename,strerror(io->rjob.status));
+  PetscFunctionReturn(0);
+}
+
+/* Starts reading filename in the background; a failure only surfaces if the file is actually requested */
+static PetscErrorCode TJIOPrefetch(TJIO *io,const char filename[])
+{
+#if defined(PETSC_HAVE_PTHREAD)
+  PetscErrorCode ierr;
+#endif
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_PTHREAD)
+  if (!io->running) PetscFunctionReturn(0);
+  ierr = TJIOWait(io,&io->rjob);CHKERRQ(ierr);
+  ierr = PetscStrncpy(io->rjob.filename,filename,sizeof(io->rjob.filename));CHKERRQ(ierr);
+  io->rjob.type = TJIO_READ;
+  ierr = TJIOSubmit(io,&io->rjob);CHKERRQ(ierr);
+#endif
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode WriteToDisk(PetscInt stepnum,PetscReal time,PetscReal timeprev,Vec X,Vec *Y,PetscInt numY,PetscBool solution_only,PetscViewer viewer)
 {
   PetscInt       i;
@@ -300,6 +825,27 @@ static PetscErrorCode StackDumpAll(TSTrajectory tj,TS ts,Stack *stack,PetscInt i
     ierr = PetscViewerASCIIPrintf(tj->monitor,"Dump stack id %D to file\n",id);CHKERRQ(ierr);
     ierr = PetscViewerASCIIPopTab(tj->monitor);CHKERRQ(ierr);
   }
+  if (TJIOEnabled(&tjsch->io)) {
+    TJIOJob job;
+
+    ierr = TJIOGetFileName(tj,"TS-STACK",id,filename,sizeof(filename));CHKERRQ(ierr);
+    ierr = PetscLogEventBegin(TSTrajectory_DiskWrite,tj,ts,0,0);CHKERRQ(ierr);
+    ierr = TJIOBeginWrite(&tjsch->io,filename,&job);CHKERRQ(ierr);
+    for (i=0;i<stack->stacksize;i++) {
+      e    = stack->container[i];
+      ierr = TJIOPackBlock(job,e->stepnum,e->time,e->timeprev,e->X,e->Y,stack->numY,stack->solution_only);CHKERRQ(ierr);
+    }
+    ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
+    ierr = TJIOPackBlock(job,ts->steps,ts->ptime,ts->ptime_prev,ts->vec_sol,Y,stack->numY,stack->solution_only);CHKERRQ(ierr);
+    ierr = TJIOSubmit(&tjsch->io,job);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(TSTrajectory_DiskWrite,tj,ts,0,0);CHKERRQ(ierr);
+    ts->trajectory->diskwrites += stack->stacksize+1;
+    for (i=0;i<stack->stacksize;i++) {
+      ierr = StackPop(stack,&e);CHKERRQ(ierr);
+      ierr = ElementDestroy(stack,e);CHKERRQ(ierr);
+    }
+    PetscFunctionReturn(0);
+  }
   ierr = PetscSNPrintf(filename,sizeof(filename),"%s/TS-STACK%06d.bin",tj->dirname,id);CHKERRQ(ierr);
   ierr = PetscViewerFileSetName(tjsch->viewer,filename);CHKERRQ(ierr);
   ierr = PetscViewerSetUp(tjsch->viewer);CHKERRQ(ierr);
@@ -329,6 +875,7 @@ static PetscErrorCode StackLoadAll(TSTrajectory tj,TS ts,Stack *stack,PetscInt i
   PetscInt       i;
   StackElement   e;
   PetscViewer    viewer;
+  TJScheduler    *tjsch = (TJScheduler*)tj->data;
   char           filename[PETSC_MAX_PATH_LEN];
   PetscErrorCode ierr;
 
@@ -338,6 +885,30 @@ static PetscErrorCode StackLoadAll(TSTrajectory tj,TS ts,Stack *stack,PetscInt i
     ierr = PetscViewerASCIIPrintf(tj->monitor,"Load stack from file\n");CHKERRQ(ierr);
     ierr = PetscViewerASCIISubtractTab(tj->monitor,((PetscObject)tj)->tablevel);CHKERRQ(ierr);
   }
+  if (TJIOEnabled(&tjsch->io)) {
+    TJIOJob job;
+    size_t  off = 0;
+
+    ierr = TJIOGetFileName(tj,"TS-STACK",id,filename,sizeof(filename));CHKERRQ(ierr);
+    ierr = PetscLogEventBegin(TSTrajectory_DiskRead,tj,ts,0,0);CHKERRQ(ierr);
+    ierr = TJIORead(&tjsch->io,filename,&job);CHKERRQ(ierr);
+    for (i=0;i<stack->stacksize;i++) {
+      ierr = ElementCreate(ts,stack,&e);CHKERRQ(ierr);
+      ierr = StackPush(stack,e);CHKERRQ(ierr);
+      ierr = TJIOUnpackBlock(job,&off,&e->stepnum,&e->time,&e->timeprev,e->X,e->Y,stack->numY,stack->solution_only);CHKERRQ(ierr);
+    }
+    ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
+    ierr = TJIOUnpackBlock(job,&off,&ts->steps,&ts->ptime,&ts->ptime_prev,ts->vec_sol,Y,stack->numY,stack->solution_only);CHKERRQ(ierr);
+    /* the two level scheme without revolve visits the stack files in decreasing order */
+    if (tjsch->stype == TWO_LEVEL_NOREVOLVE && id > 1) {
+      ierr = TJIOGetFileName(tj,"TS-STACK",id-1,filename,sizeof(filename));CHKERRQ(ierr);
+      ierr = TJIOPrefetch(&tjsch->io,filename);CHKERRQ(ierr);
+    }
+    ierr = PetscLogEventEnd(TSTrajectory_DiskRead,tj,ts,0,0);CHKERRQ(ierr);
+    ts->trajectory->diskreads += stack->stacksize+1;
+    ierr = TurnBackward(ts);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = PetscSNPrintf(filename,sizeof filename,"%s/TS-STACK%06d.bin",tj->dirname,id);CHKERRQ(ierr);
   ierr = PetscViewerBinaryOpen(PetscObjectComm((PetscObject)tj),filename,FILE_MODE_READ,&viewer);CHKERRQ(ierr);
   for (i=0;i<stack->stacksize;i++) {
@@ -365,6 +936,7 @@ static PetscErrorCode StackLoadLast(TSTrajectory tj,TS ts,Stack *stack,PetscInt
   Vec            *Y;
   PetscInt       size;
   PetscViewer    viewer;
+  TJScheduler    *tjsch = (TJScheduler*)tj->data;
   char           filename[PETSC_MAX_PATH_LEN];
 #if defined(PETSC_HAVE_MPIIO)
   PetscBool      usempiio;
@@ -379,6 +951,26 @@ static PetscErrorCode StackLoadLast(TSTrajectory tj,TS ts,Stack *stack,PetscInt
     ierr = PetscViewerASCIIPrintf(tj->monitor,"Load last stack element from file\n");CHKERRQ(ierr);
     ierr = PetscViewerASCIISubtractTab(tj->monitor,((PetscObject)tj)->tablevel);CHKERRQ(ierr);
   }
+  if (TJIOEnabled(&tjsch->io)) {
+    TJIOJob job;
+    size_t  blockoff = 0,rawsize;
+
+    ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
+    ierr = TJIOGetFileName(tj,"TS-STACK",id,filename,sizeof(filename));CHKERRQ(ierr);
+    ierr = PetscLogEventBegin(TSTrajectory_DiskRead,tj,ts,0,0);CHKERRQ(ierr);
+    ierr = TJIORead(&tjsch->io,filename,&job);CHKERRQ(ierr);
+    /* skip to the last block */
+    while (blockoff+sizeof(size_t) <= job->len) {
+      ierr = PetscMemcpy(&rawsize,job->buf+blockoff,sizeof(size_t));CHKERRQ(ierr);
+      if (blockoff+2*sizeof(size_t)+rawsize > job->len) break;
+      blockoff += sizeof(size_t)+rawsize;
+    }
+    ierr = TJIOUnpackBlock(job,&blockoff,&ts->steps,&ts->ptime,&ts->ptime_prev,ts->vec_sol,Y,stack->numY,stack->solution_only);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(TSTrajectory_DiskRead,tj,ts,0,0);CHKERRQ(ierr);
+    ts->trajectory->diskreads++;
+    ierr = TurnBackward(ts);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
   ierr = VecGetSize(Y[0],&size);CHKERRQ(ierr);
   /* VecView writes to file two extra int's for class id and number of rows */
@@ -426,6 +1018,19 @@ static PetscErrorCode DumpSingle(TSTrajectory tj,TS ts,Stack *stack,PetscInt id)
     ierr = PetscViewerASCIISubtractTab(tj->monitor,((PetscObject)tj)->tablevel);CHKERRQ(ierr);
   }
   ierr = TSGetStepNumber(ts,&stepnum);CHKERRQ(ierr);
+  if (TJIOEnabled(&tjsch->io)) {
+    TJIOJob job;
+
+    ierr = TJIOGetFileName(tj,"TS-CPS",id,filename,sizeof(filename));CHKERRQ(ierr);
+    ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
+    ierr = PetscLogEventBegin(TSTrajectory_DiskWrite,tj,ts,0,0);CHKERRQ(ierr);
+    ierr = TJIOBeginWrite(&tjsch->io,filename,&job);CHKERRQ(ierr);
+    ierr = TJIOPackBlock(job,stepnum,ts->ptime,ts->ptime_prev,ts->vec_sol,Y,stack->numY,stack->solution_only);CHKERRQ(ierr);
+    ierr = TJIOSubmit(&tjsch->io,job);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(TSTrajectory_DiskWrite,tj,ts,0,0);CHKERRQ(ierr);
+    ts->trajectory->diskwrites++;
+    PetscFunctionReturn(0);
+  }
   ierr = PetscSNPrintf(filename,sizeof(filename),"%s/TS-CPS%06d.bin",tj->dirname,id);CHKERRQ(ierr);
   ierr = PetscViewerFileSetName(tjsch->viewer,filename);CHKERRQ(ierr);
   ierr = PetscViewerSetUp(tjsch->viewer);CHKERRQ(ierr);
@@ -442,6 +1047,7 @@ static PetscErrorCode LoadSingle(TSTrajectory tj,TS ts,Stack *stack,PetscInt id)
 {
   Vec            *Y;
   PetscViewer    viewer;
+  TJScheduler    *tjsch = (TJScheduler*)tj->data;
   char           filename[PETSC_MAX_PATH_LEN];
   PetscErrorCode ierr;
 
@@ -451,6 +1057,23 @@ static PetscErrorCode LoadSingle(TSTrajectory tj,TS ts,Stack *stack,PetscInt id)
     ierr = PetscViewerASCIIPrintf(tj->monitor,"Load a single point from file\n");CHKERRQ(ierr);
     ierr = PetscViewerASCIISubtractTab(tj->monitor,((PetscObject)tj)->tablevel);CHKERRQ(ierr);
   }
+  if (TJIOEnabled(&tjsch->io)) {
+    TJIOJob job;
+    size_t  off = 0;
+
+    ierr = TJIOGetFileName(tj,"TS-CPS",id,filename,sizeof(filename));CHKERRQ(ierr);
+    ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
+    ierr = PetscLogEventBegin(TSTrajectory_DiskRead,tj,ts,0,0);CHKERRQ(ierr);
+    ierr = TJIORead(&tjsch->io,filename,&job);CHKERRQ(ierr);
+    ierr = TJIOUnpackBlock(job,&off,&ts->steps,&ts->ptime,&ts->ptime_prev,ts->vec_sol,Y,stack->numY,stack->solution_only);CHKERRQ(ierr);
+    if (tjsch->stype == TWO_LEVEL_NOREVOLVE && id > 1) {
+      ierr = TJIOGetFileName(tj,"TS-CPS",id-1,filename,sizeof(filename));CHKERRQ(ierr);
+      ierr = TJIOPrefetch(&tjsch->io,filename);CHKERRQ(ierr);
+    }
+    ierr = PetscLogEventEnd(TSTrajectory_DiskRead,tj,ts,0,0);CHKERRQ(ierr);
+    ts->trajectory->diskreads++;
+    PetscFunctionReturn(0);
+  }
   ierr = PetscSNPrintf(filename,sizeof filename,"%s/TS-CPS%06d.bin",tj->dirname,id);CHKERRQ(ierr);
   ierr = PetscViewerBinaryOpen(PetscObjectComm((PetscObject)tj),filename,FILE_MODE_READ,&viewer);CHKERRQ(ierr);
 
@@ -1653,6 +2276,24 @@ PETSC_UNUSED static PetscErrorCode TSTrajectorySetUseDRAM(TSTrajectory tj,PetscB
   PetscFunctionReturn(0);
 }
 
+PETSC_UNUSED static PetscErrorCode TSTrajectorySetAsyncIO_Memory(TSTrajectory tj,PetscBool async)
+{
+  TJScheduler *tjsch = (TJScheduler*)tj->data;
+
+  PetscFunctionBegin;
+  tjsch->io.async = async;
+  PetscFunctionReturn(0);
+}
+
+PETSC_UNUSED static PetscErrorCode TSTrajectorySetCompress_Memory(TSTrajectory tj,PetscBool compress)
+{
+  TJScheduler *tjsch = (TJScheduler*)tj->data;
+
+  PetscFunctionBegin;
+  tjsch->io.compress = compress;
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode TSTrajectorySetFromOptions_Memory(PetscOptionItems *PetscOptionsObject,TSTrajectory tj)
 {
   TJScheduler    *tjsch = (TJScheduler*)tj->data;
@@ -1669,6 +2310,8 @@ static PetscErrorCode TSTrajectorySetFromOptions_Memory(PetscOptionItems *PetscO
 #endif
     ierr = PetscOptionsBool("-ts_trajectory_save_stack","Save all stack to disk","TSTrajectorySetSaveStack",tjsch->save_stack,&tjsch->save_stack,NULL);CHKERRQ(ierr);
     ierr = PetscOptionsBool("-ts_trajectory_use_dram","Use DRAM for checkpointing","TSTrajectorySetUseDRAM",tjsch->stack.use_dram,&tjsch->stack.use_dram,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsBool("-ts_trajectory_async_io","Write and prefetch disk checkpoints in a background thread","TSTrajectorySetAsyncIO_Memory",tjsch->io.async,&tjsch->io.async,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsBool("-ts_trajectory_compress","Compress disk checkpoints losslessly","TSTrajectorySetCompress_Memory",tjsch->io.compress,&tjsch->io.compress,NULL);CHKERRQ(ierr);
   }
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   tjsch->stack.solution_only = tj->solution_only;
@@ -1775,6 +2418,7 @@ static PetscErrorCode TSTrajectorySetUp_Memory(TSTrajectory tj,TS ts)
 
   if ((tjsch->stype >= TWO_LEVEL_NOREVOLVE && tjsch->stype < REVOLVE_OFFLINE) || tjsch->stype == REVOLVE_MULTISTAGE) { /* these types need to use disk */
     ierr = TSTrajectorySetUp_Basic(tj,ts);CHKERRQ(ierr);
+    ierr = TJIOSetUp(tj,&tjsch->io);CHKERRQ(ierr);
   }
 
   tjsch->recompute = PETSC_FALSE;
@@ -1789,6 +2433,7 @@ static PetscErrorCode TSTrajectoryReset_Memory(TSTrajectory tj)
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  ierr = TJIOFinalize(tj,&tjsch->io);CHKERRQ(ierr);
   if (tjsch->stype > TWO_LEVEL_NOREVOLVE) {
 #if defined(PETSC_HAVE_REVOLVE)
     revolve_reset();
@@ -1814,14 +2459,53 @@ static PetscErrorCode TSTrajectoryDestroy_Memory(TSTrajectory tj)
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  ierr = TJIOFinalize(tj,&tjsch->io);CHKERRQ(ierr);
   ierr = PetscViewerDestroy(&tjsch->viewer);CHKERRQ(ierr);
   ierr = PetscFree(tjsch);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode TSTrajectoryView_Memory(TSTrajectory tj,PetscViewer viewer)
+{
+  TJScheduler    *tjsch = (TJScheduler*)tj->data;
+  TJIO           *io = &tjsch->io;
+  PetscLogDouble local[4],global[4];
+  PetscBool      iascii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!TJIOEnabled(io)) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (!iascii) PetscFunctionReturn(0);
+  /* account for the writes still held in the buffers */
+  ierr = TJIOWait(io,&io->wjob[0]);CHKERRQ(ierr);
+  ierr = TJIOWait(io,&io->wjob[1]);CHKERRQ(ierr);
+  local[0] = io->rawbytes;
+  local[1] = io->storedbytes;
+  local[2] = io->iotime;
+  local[3] = io->waittime;
+  ierr = MPIU_Allreduce(local,global,4,MPIU_PETSCLOGDOUBLE,MPI_SUM,PetscObjectComm((PetscObject)tj));CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"disk checkpoints: %s I/O%s\n",io->async ? "asynchronous" : "synchronous",io->compress ? ", compressed" : "");CHKERRQ(ierr);
+  if (global[1] > 0.0) {
+    ierr = PetscViewerASCIIPrintf(viewer,"bytes written = %g, before compression = %g (ratio %g)\n",global[1],global[0],global[0]/global[1]);CHKERRQ(ierr);
+  }
+  if (global[2] > 0.0) {
+    ierr = PetscViewerASCIIPrintf(viewer,"I/O time = %g s, time waiting for I/O = %g s, I/O hidden behind computation = %g%%\n",global[2],global[3],100.0*PetscMax(0.0,1.0-global[3]/global[2]));CHKERRQ(ierr);
+  }
+  ierr = PetscViewerASCIIPrintf(viewer,"reads served by prefetching = %D of %D\n",io->prefetched,io->reads);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*MC
       TSTRAJECTORYMEMORY - Stores each solution of the ODE/ADE in memory
 
+  Options Database Keys:
++  -ts_trajectory_async_io - write disk checkpoints in a background thread and prefetch them during the adjoint sweep
+-  -ts_trajectory_compress - compress disk checkpoints losslessly
+
+  Notes:
+  With either option every process writes its part of the disk checkpoints to a file of its own.
+
   Level: intermediate
 
 .seealso:  TSTrajectoryCreate(), TS, TSTrajectorySetType()
@@ -1833,6 +2517,7 @@ PETSC_EXTERN PetscErrorCode TSTrajectoryCreate_Memory(TSTrajectory tj,TS ts)
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  tj->ops->view           = TSTrajectoryView_Memory;
   tj->ops->set            = TSTrajectorySet_Memory;
   tj->ops->get            = TSTrajectoryGet_Memory;
   tj->ops->setup          = TSTrajectorySetUp_Memory;
@@ -0,0 +1,136 @@
+static const char help[] = "Benchmark PetscSF Bcast/Reduce latency on a small ring halo\n\n";
+
+/*
+   Each process owns n roots and has n leaves, half of them connected to the last roots of the previous
+   process and half to the first roots of the next process, which mimics the ghost exchange of a 1D
+   stencil. The same exchange is timed through PetscSF (whose Basic type reuses persistent MPI requests
+   created once per unit type) and through a hand-coded MPI_Irecv/MPI_Isend exchange that creates fresh
+   requests on every call, so the per-call saving of the persistent requests can be read off directly.
+
+   Run, for example, with
+     mpiexec -n 2 ./ex3 -n 4 -niter 100000 -time
+   and compare PetscSF types with -sf_type basic or -sf_type neighbor.
+*/
+
+#include <petscsf.h>
+#include <petsctime.h>
+
+int main(int argc,char **argv)
+{
+  PetscSF        sf;
+  PetscSFNode    *iremote;
+  PetscInt       i,it,n = 4,nh,niter = 100,nwarmup = 10,errors = 0;
+  PetscScalar    *rootdata,*leafdata,*sbuf,*rbuf;
+  PetscMPIInt    rank,size,prev,next,tag = 77;
+  MPI_Request    reqs[4];
+  MPI_Comm       comm;
+  PetscLogDouble t0,tsfbcast,tsfreduce,tmpi;
+  PetscBool      time = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  comm = PETSC_COMM_WORLD;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-niter",&niter,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nwarmup",&nwarmup,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-time",&time,NULL);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  if (n < 2 || n%2) SETERRQ(comm,PETSC_ERR_ARG_OUTOFRANGE,"-n must be a positive even number");
+  nh   = n/2;
+  prev = (rank+size-1)%size;
+  next = (rank+1)%size;
+
+  /* Leaves [0,nh) take the last nh roots of prev, leaves [nh,n) take the first nh roots of next */
+  ierr = PetscMalloc1(n,&iremote);CHKERRQ(ierr);
+  for (i=0; i<nh; i++) {
+    iremote[i].rank     = prev;
+    iremote[i].index    = n-nh+i;
+    iremote[nh+i].rank  = next;
+    iremote[nh+i].index = i;
+  }
+  ierr = PetscSFCreate(comm,&sf);CHKERRQ(ierr);
+  ierr = PetscSFSetFromOptions(sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(sf,n,n,NULL,PETSC_COPY_VALUES,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+
+  ierr = PetscMalloc4(n,&rootdata,n,&leafdata,n,&sbuf,n,&rbuf);CHKERRQ(ierr);
+  for (i=0; i<n; i++) rootdata[i] = rank*n+i;
+
+  /* PetscSF broadcast */
+  for (it=0; it<nwarmup+niter; it++) {
+    if (it == nwarmup) {ierr = MPI_Barrier(comm);CHKERRQ(ierr); ierr = PetscTime(&t0);CHKERRQ(ierr);}
+    ierr = PetscSFBcastBegin(sf,MPIU_SCALAR,rootdata,leafdata);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sf,MPIU_SCALAR,rootdata,leafdata);CHKERRQ(ierr);
+  }
+  ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+  tsfbcast = -t0;
+  for (i=0; i<nh; i++) {
+    if (leafdata[i] != (PetscScalar)(prev*n+n-nh+i) || leafdata[nh+i] != (PetscScalar)(next*n+i)) errors++;
+  }
+
+  /* PetscSF reduction */
+  for (it=0; it<nwarmup+niter; it++) {
+    if (it == nwarmup) {ierr = MPI_Barrier(comm);CHKERRQ(ierr); ierr = PetscTime(&t0);CHKERRQ(ierr);}
+    ierr = PetscSFReduceBegin(sf,MPIU_SCALAR,leafdata,rootdata,MPIU_REPLACE);CHKERRQ(ierr);
+    ierr = PetscSFReduceEnd(sf,MPIU_SCALAR,leafdata,rootdata,MPIU_REPLACE);CHKERRQ(ierr);
+  }
+  ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+  tsfreduce = -t0;
+  for (i=0; i<n; i++) {
+    if (rootdata[i] != (PetscScalar)(rank*n+i)) errors++;
+  }
+
+  /* Equivalent exchange with non-persistent point-to-point messages, as done before PetscSF */
+  for (it=0; it<nwarmup+niter; it++) {
+    if (it == nwarmup) {ierr = MPI_Barrier(comm);CHKERRQ(ierr); ierr = PetscTime(&t0);CHKERRQ(ierr);}
+    ierr = MPI_Irecv(rbuf,(PetscMPIInt)nh,MPIU_SCALAR,prev,tag,comm,&reqs[0]);CHKERRQ(ierr);
+    ierr = MPI_Irecv(rbuf+nh,(PetscMPIInt)nh,MPIU_SCALAR,next,tag+1,comm,&reqs[1]);CHKERRQ(ierr);
+    for (i=0; i<nh; i++) {sbuf[i] = rootdata[i]; sbuf[nh+i] = rootdata[n-nh+i];}
+    ierr = MPI_Isend(sbuf,(PetscMPIInt)nh,MPIU_SCALAR,prev,tag+1,comm,&reqs[2]);CHKERRQ(ierr);
+    ierr = MPI_Isend(sbuf+nh,(PetscMPIInt)nh,MPIU_SCALAR,next,tag,comm,&reqs[3]);CHKERRQ(ierr);
+    ierr = MPI_Waitall(4,reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+    for (i=0; i<n; i++) leafdata[i] = rbuf[i];
+  }
+  ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+  tmpi = -t0;
+  for (i=0; i<nh; i++) {
+    if (leafdata[i] != (PetscScalar)(prev*n+n-nh+i) || leafdata[nh+i] != (PetscScalar)(next*n+i)) errors++;
+  }
+
+  ierr = MPI_Allreduce(MPI_IN_PLACE,&errors,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+  if (errors) {ierr = PetscPrintf(comm,"Error: Unexpected leafdata or rootdata on processors\n");CHKERRQ(ierr);}
+  if (time && niter > 0) {
+    ierr = MPI_Allreduce(MPI_IN_PLACE,&tsfbcast,1,MPI_DOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+    ierr = MPI_Allreduce(MPI_IN_PLACE,&tsfreduce,1,MPI_DOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+    ierr = MPI_Allreduce(MPI_IN_PLACE,&tmpi,1,MPI_DOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+    ierr = PetscPrintf(comm,"Halo of %D entries, %D iterations, time per call in microseconds\n",n,niter);CHKERRQ(ierr);
+    ierr = PetscPrintf(comm,"  PetscSFBcast   %10.3f\n",1e6*tsfbcast/niter);CHKERRQ(ierr);
+    ierr = PetscPrintf(comm,"  PetscSFReduce  %10.3f\n",1e6*tsfreduce/niter);CHKERRQ(ierr);
+    ierr = PetscPrintf(comm,"  MPI_Isend/Irecv%10.3f\n",1e6*tmpi/niter);CHKERRQ(ierr);
+  }
+
+  ierr = PetscFree4(rootdata,leafdata,sbuf,rbuf);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      nsize: 2
+      args: -niter 20
+
+   test:
+      suffix: 2
+      nsize: 3
+      args: -n 6 -niter 20 -sf_type basic
+
+   test:
+      suffix: neighbor
+      nsize: 3
+      args: -n 6 -niter 20 -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+TEST*/
@@ -565,4 +565,94 @@ int main(int argc,char **argv)
       suffix: 9_char
       nsize: 4
       args: -sf_type basic -test_bcast -test_reduce -test_op max -test_char
+
+   test:
+      suffix: 1_neighbor
+      nsize: 4
+      args: -test_bcast -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 2_neighbor
+      nsize: 4
+      args: -test_reduce -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 3_neighbor
+      nsize: 4
+      args: -test_degree -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 4_neighbor
+      nsize: 4
+      args: -test_gather -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 5_neighbor
+      nsize: 4
+      args: -test_scatter -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 8_neighbor
+      nsize: 3
+      args: -test_bcast -test_sf_distribute -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: bcastop_neighbor
+      nsize: 4
+      args: -test_bcastop -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: fetchandop_neighbor
+      nsize: 4
+      args: -test_fetchandop -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 1_basic_shm
+      nsize: 4
+      args: -test_bcast -sf_type basic -sf_basic_shared_memory
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) define(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+      output_file: output/ex1_1_basic.out
+
+   test:
+      suffix: 2_basic_shm
+      nsize: 4
+      args: -test_reduce -sf_type basic -sf_basic_shared_memory
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) define(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+      output_file: output/ex1_2_basic.out
+
+   test:
+      suffix: 4_basic_shm
+      nsize: 4
+      args: -test_gather -sf_type basic -sf_basic_shared_memory
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) define(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+      output_file: output/ex1_4_basic.out
+
+   test:
+      suffix: bcastop_basic_shm
+      nsize: 4
+      args: -test_bcastop -sf_type basic -sf_basic_shared_memory
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) define(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+      output_file: output/ex1_bcastop_basic.out
+
+   test:
+      suffix: fetchandop_basic_shm
+      nsize: 4
+      args: -test_fetchandop -sf_type basic -sf_basic_shared_memory
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) define(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+      output_file: output/ex1_fetchandop_basic.out
+
+   test:
+      suffix: 8_basic_shm
+      nsize: 3
+      args: -test_bcast -test_sf_distribute -sf_type basic -sf_basic_shared_memory
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) define(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+      output_file: output/ex1_8_basic.out
 TEST*/
@@ -1,58 +1,5 @@
 
-#include <petsc/private/sfimpl.h> /*I "petscsf.h" I*/
-
-typedef struct _n_PetscSFBasicPack *PetscSFBasicPack;
-struct _n_PetscSFBasicPack {
-  void (*Pack)(PetscInt,PetscInt,const PetscInt*,const void*,void*);
-  void (*UnpackInsert)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackAdd)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMin)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMax)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMinloc)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMaxloc)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMult)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackLAND)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackBAND)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackLOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackBOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackLXOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackBXOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*FetchAndInsert)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndAdd)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMin)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMax)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMinloc)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMaxloc)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMult)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndLAND)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndBAND)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndLOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndBOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndLXOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndBXOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-
-  MPI_Datatype     unit;
-  PetscBool        isbuiltin;   /* Is unit an MPI builtin datatype? */
-  size_t           unitbytes;   /* Number of bytes in a unit */
-  PetscInt         bs;          /* Number of basic units in a unit */
-  const void       *key;        /* Array used as key for operation */
-  char             **root;      /* Packed root data, indexed by leaf rank */
-  char             **leaf;      /* Packed leaf data, indexed by root rank */
-  MPI_Request      *requests;   /* Array of root requests followed by leaf requests */
-  PetscSFBasicPack next;
-};
-
-typedef struct {
-  PetscMPIInt      tag;
-  PetscMPIInt      niranks;     /* Number of incoming ranks (ranks accessing my roots) */
-  PetscMPIInt      ndiranks;    /* Number of incoming ranks (ranks accessing my roots) in distinguished set */
-  PetscMPIInt      *iranks;     /* Array of ranks that reference my roots */
-  PetscInt         itotal;      /* Total number of graph edges referencing my roots */
-  PetscInt         *ioffset;    /* Array of length niranks+1 holding offset in irootloc[] for each rank */
-  PetscInt         *irootloc;   /* Incoming roots referenced by ranks starting at ioffset[rank] */
-  PetscSFBasicPack avail;       /* One or more entries per MPI Datatype, lazily constructed */
-  PetscSFBasicPack inuse;       /* Buffers being used for transactions that have not yet completed */
-} PetscSF_Basic;
+#include <../src/vec/is/sf/impls/basic/sfbasic.h> /*I "petscsf.h" I*/
 
 #if !defined(PETSC_HAVE_MPI_TYPE_DUP)
 PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype)
@@ -551,7 +498,119 @@ DEF_Block(char,6)
 DEF_Block(char,7)
 #endif
 
-static PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) && defined(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+/*
+   Find the non-distinguished ranks on the same node, agree with them on where each one packs data for the other and
+   allocate the shared window. This is the only collective step on the node: afterwards the ranks synchronize only through
+   the messages of each operation and the flags of the slots, see PetscSFBasicShmBegin() for the order it requires.
+
+   The shared buffer of a rank starts with the flags of its slots, flags[s*shmsize+r] being the last operation of slot s
+   that rank r has read. It is followed by the root data the rank packs for on-node leaf ranks (bcast), then the leaf
+   data it packs for on-node root ranks (reduce), shmnslots times each with at most shmunitbytes bytes per unit. The
+   offsets are exchanged through the flags of the window before they are initialized.
+*/
+static PetscErrorCode PetscSFBasicSetUpShm(PetscSF sf)
+{
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode ierr;
+  PetscShmComm   pshmcomm;
+  PetscMPIInt    disp_unit;
+  PetscInt       i,off,*myoffset,*theiroffset;
+  size_t         nflags;
+  MPI_Aint       sz;
+
+  PetscFunctionBegin;
+  ierr = PetscShmCommGet(PetscObjectComm((PetscObject)sf),&pshmcomm);CHKERRQ(ierr);
+  ierr = PetscShmCommGetMpiShmComm(pshmcomm,&bas->shmcomm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(bas->shmcomm,&bas->shmsize);CHKERRQ(ierr);
+  if (bas->shmsize == 1) PetscFunctionReturn(0); /* Same decision on all ranks of the node */
+  ierr = MPI_Comm_rank(bas->shmcomm,&bas->shmrank);CHKERRQ(ierr);
+  bas->shm = PETSC_TRUE;
+
+  ierr = PetscMalloc3(bas->niranks,&bas->ishmranks,bas->niranks,&bas->ishmoffset,bas->niranks,&bas->ishmpack);CHKERRQ(ierr);
+  ierr = PetscMalloc3(sf->nranks,&bas->shmranks,sf->nranks,&bas->shmoffset,sf->nranks,&bas->shmpack);CHKERRQ(ierr);
+  for (i=0; i<bas->niranks; i++) {
+    bas->ishmranks[i] = MPI_PROC_NULL;
+    if (i >= bas->ndiranks) {ierr = PetscShmCommGlobalToLocal(pshmcomm,bas->iranks[i],&bas->ishmranks[i]);CHKERRQ(ierr);}
+  }
+  for (i=0; i<sf->nranks; i++) {
+    bas->shmranks[i] = MPI_PROC_NULL;
+    if (i >= sf->ndranks) {ierr = PetscShmCommGlobalToLocal(pshmcomm,sf->ranks[i],&bas->shmranks[i]);CHKERRQ(ierr);}
+  }
+  for (i=0,off=0; i<bas->niranks; i++) {
+    if (bas->ishmranks[i] == MPI_PROC_NULL) continue;
+    bas->ishmpack[i] = off;
+    off += bas->ioffset[i+1] - bas->ioffset[i];
+  }
+  for (i=0; i<sf->nranks; i++) {
+    if (bas->shmranks[i] == MPI_PROC_NULL) continue;
+    bas->shmpack[i] = off;
+    off += sf->roffset[i+1] - sf->roffset[i];
+  }
+  bas->shmtotal = off;
+
+  nflags            = (size_t)PetscMax(bas->shmnslots*bas->shmsize,2*bas->shmsize);
+  bas->shmflagbytes = ((nflags*sizeof(PetscInt)+15)/16)*16;
+  ierr = MPIU_Win_allocate_shared(bas->shmflagbytes+bas->shmnslots*bas->shmtotal*bas->shmunitbytes,16,MPI_INFO_NULL,bas->shmcomm,&myoffset,&bas->shmwin);CHKERRQ(ierr);
+  ierr = MPI_Win_lock_all(MPI_MODE_NOCHECK,bas->shmwin);CHKERRQ(ierr);
+  ierr = PetscMalloc1(bas->shmsize,&bas->shmbases);CHKERRQ(ierr);
+  for (i=0; i<bas->shmsize; i++) {ierr = MPIU_Win_shared_query(bas->shmwin,(PetscMPIInt)i,&sz,&disp_unit,&bas->shmbases[i]);CHKERRQ(ierr);}
+
+  /* myoffset[r] is where I pack root data for rank r in shmcomm, myoffset[shmsize+r] is where I pack leaf data for it */
+  for (i=0; i<2*bas->shmsize; i++) myoffset[i] = -1;
+  for (i=0; i<bas->niranks; i++) if (bas->ishmranks[i] != MPI_PROC_NULL) myoffset[bas->ishmranks[i]] = bas->ishmpack[i];
+  for (i=0; i<sf->nranks; i++) if (bas->shmranks[i] != MPI_PROC_NULL) myoffset[bas->shmsize+bas->shmranks[i]] = bas->shmpack[i];
+  ierr = MPI_Win_sync(bas->shmwin);CHKERRQ(ierr);
+  ierr = MPI_Barrier(bas->shmcomm);CHKERRQ(ierr);
+  ierr = MPI_Win_sync(bas->shmwin);CHKERRQ(ierr);
+  for (i=0; i<bas->niranks; i++) {
+    if (bas->ishmranks[i] == MPI_PROC_NULL) continue;
+    theiroffset = (PetscInt*)bas->shmbases[bas->ishmranks[i]];
+    bas->ishmoffset[i] = theiroffset[bas->shmsize+bas->shmrank];
+    if (bas->ishmoffset[i] < 0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Inconsistent shared memory setup");
+  }
+  for (i=0; i<sf->nranks; i++) {
+    if (bas->shmranks[i] == MPI_PROC_NULL) continue;
+    theiroffset = (PetscInt*)bas->shmbases[bas->shmranks[i]];
+    bas->shmoffset[i] = theiroffset[bas->shmrank];
+    if (bas->shmoffset[i] < 0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Inconsistent shared memory setup");
+  }
+
+  /* all ranks have read the offsets before the flags are initialized */
+  ierr = MPI_Barrier(bas->shmcomm);CHKERRQ(ierr);
+  for (i=0; i<(PetscInt)nflags; i++) myoffset[i] = -1;
+  ierr = PetscMalloc2(bas->shmnslots,&bas->shmlastseq,bas->shmnslots,&bas->shmlastdir);CHKERRQ(ierr);
+  for (i=0; i<bas->shmnslots; i++) bas->shmlastseq[i] = -1;
+  bas->shmseq = 0;
+  ierr = MPI_Win_sync(bas->shmwin);CHKERRQ(ierr);
+  ierr = MPI_Barrier(bas->shmcomm);CHKERRQ(ierr);
+  ierr = MPI_Win_sync(bas->shmwin);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Whether the ranks on this node that read my slot s for its last operation have all done it */
+static PetscErrorCode PetscSFBasicShmSlotFree(PetscSF sf,PetscInt s,PetscBool *isfree)
+{
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
+  const PetscInt    *flags = (const PetscInt*)bas->shmbases[bas->shmrank] + s*bas->shmsize,seq = bas->shmlastseq[s];
+  const PetscMPIInt *readers;
+  PetscInt          i,n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  *isfree = PETSC_TRUE;
+  if (seq < 0) PetscFunctionReturn(0);
+  ierr = MPI_Win_sync(bas->shmwin);CHKERRQ(ierr);
+  if (bas->shmlastdir[s] == PETSC_SF_ROOT2LEAF_BCAST) {readers = bas->ishmranks; n = bas->niranks;}
+  else                                                {readers = bas->shmranks;  n = sf->nranks;}
+  for (i=0; i<n; i++) {
+    if (readers[i] != MPI_PROC_NULL && flags[readers[i]] != seq) {*isfree = PETSC_FALSE; break;}
+  }
+  PetscFunctionReturn(0);
+}
+#endif
+
+PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
 {
   PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode ierr;
@@ -628,10 +687,13 @@ static PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
   }
   ierr = MPI_Waitall(nreqs,reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
   ierr = PetscFree(reqs);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) && defined(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+  if (bas->useshm) {ierr = PetscSFBasicSetUpShm(sf);CHKERRQ(ierr);}
+#endif
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicPackTypeSetup(PetscSFBasicPack link,MPI_Datatype unit)
+PetscErrorCode PetscSFBasicPackTypeSetup(PetscSFBasicPack link,MPI_Datatype unit)
 {
   PetscErrorCode ierr;
   PetscBool      isInt,isPetscInt,isPetscReal,is2Int,is2PetscInt,isSignedChar,isUnsignedChar;
@@ -734,7 +796,7 @@ static PetscErrorCode PetscSFBasicPackTypeSetup(PetscSFBasicPack link,MPI_Dataty
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicPackGetUnpackOp(PetscSF sf,PetscSFBasicPack link,MPI_Op op,void (**UnpackOp)(PetscInt,PetscInt,const PetscInt*,void*,const void*))
+PetscErrorCode PetscSFBasicPackGetUnpackOp(PetscSF sf,PetscSFBasicPack link,MPI_Op op,void (**UnpackOp)(PetscInt,PetscInt,const PetscInt*,void*,const void*))
 {
   PetscFunctionBegin;
   *UnpackOp = NULL;
@@ -754,7 +816,7 @@ static PetscErrorCode PetscSFBasicPackGetUnpackOp(PetscSF sf,PetscSFBasicPack li
   else *UnpackOp = NULL;
   PetscFunctionReturn(0);
 }
-static PetscErrorCode PetscSFBasicPackGetFetchAndOp(PetscSF sf,PetscSFBasicPack link,MPI_Op op,void (**FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*))
+PetscErrorCode PetscSFBasicPackGetFetchAndOp(PetscSF sf,PetscSFBasicPack link,MPI_Op op,void (**FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*))
 {
   PetscFunctionBegin;
   *FetchAndOp = NULL;
@@ -775,8 +837,6 @@ static PetscErrorCode PetscSFBasicPackGetFetchAndOp(PetscSF sf,PetscSFBasicPack
   PetscFunctionReturn(0);
 }
 
-typedef enum {PETSC_SF_LEAF2ROOT_REDUCE, PETSC_SF_ROOT2LEAF_BCAST} PetscSFDirection;
-
 static PetscErrorCode PetscSFBasicPackGetReqs(PetscSF sf,PetscSFBasicPack link,PetscSFDirection direction,MPI_Request **rootreqs,MPI_Request **leafreqs)
 {
   PetscSF_Basic *bas   = (PetscSF_Basic*)sf->data;
@@ -795,11 +855,17 @@ static PetscErrorCode PetscSFBasicPackWaitall(PetscSF sf,PetscSFBasicPack link,P
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = MPI_Waitall(bas->niranks+sf->nranks-(bas->ndiranks+sf->ndranks),link->requests+shift,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  ierr = MPI_Waitall(bas->niranks+sf->nranks-(bas->ndiranks+sf->ndranks),link->requests+shift,bas->shm ? link->statuses : MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) && defined(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+  if (bas->shm) {
+    ierr = MPI_Waitall(bas->niranks+sf->nranks-(bas->ndiranks+sf->ndranks),link->shmreqs+shift,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+    ierr = MPI_Win_sync(bas->shmwin);CHKERRQ(ierr); /* see the data packed in the slots of ranks on this node */
+  }
+#endif
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicGetRootInfo(PetscSF sf,PetscInt *nrootranks,PetscInt *ndrootranks,const PetscMPIInt **rootranks,const PetscInt **rootoffset,const PetscInt **rootloc)
+PetscErrorCode PetscSFBasicGetRootInfo(PetscSF sf,PetscInt *nrootranks,PetscInt *ndrootranks,const PetscMPIInt **rootranks,const PetscInt **rootoffset,const PetscInt **rootloc)
 {
   PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
 
@@ -812,7 +878,7 @@ static PetscErrorCode PetscSFBasicGetRootInfo(PetscSF sf,PetscInt *nrootranks,Pe
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicGetLeafInfo(PetscSF sf,PetscInt *nleafranks,PetscInt *ndleafranks,const PetscMPIInt **leafranks,const PetscInt **leafoffset,const PetscInt **leafloc)
+PetscErrorCode PetscSFBasicGetLeafInfo(PetscSF sf,PetscInt *nleafranks,PetscInt *ndleafranks,const PetscMPIInt **leafranks,const PetscInt **leafoffset,const PetscInt **leafloc)
 {
   PetscFunctionBegin;
   if (nleafranks)  *nleafranks  = sf->nranks;
@@ -823,7 +889,8 @@ static PetscErrorCode PetscSFBasicGetLeafInfo(PetscSF sf,PetscInt *nleafranks,Pe
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicGetPack(PetscSF sf,MPI_Datatype unit,const void *key,PetscSFBasicPack *mylink)
+/* Get a link for nvec arrays of type unit: the buffer of each rank holds nvec consecutive segments, one per array */
+static PetscErrorCode PetscSFBasicGetPack(PetscSF sf,MPI_Datatype unit,PetscInt nvec,const void *key,PetscSFBasicPack *mylink)
 {
   PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode   ierr;
@@ -839,7 +906,7 @@ static PetscErrorCode PetscSFBasicGetPack(PetscSF sf,MPI_Datatype unit,const voi
   for (p=&bas->avail; (link=*p); p=&link->next) {
     PetscBool match;
     ierr = MPIPetsc_Type_compare(unit,link->unit,&match);CHKERRQ(ierr);
-    if (match) {
+    if (match && link->nvec == nvec) {
       *p = link->next;          /* Remove from available list */
       goto found;
     }
@@ -850,6 +917,7 @@ static PetscErrorCode PetscSFBasicGetPack(PetscSF sf,MPI_Datatype unit,const voi
   ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,NULL);CHKERRQ(ierr);
   ierr = PetscNew(&link);CHKERRQ(ierr);
   ierr = PetscSFBasicPackTypeSetup(link,unit);CHKERRQ(ierr);
+  link->nvec = nvec;
   ierr = PetscMalloc2(nrootranks,&link->root,nleafranks,&link->leaf);CHKERRQ(ierr);
   /* Double the requests. First half are used for reduce (leaf to root) communication, second half for bcast (root to leaf) communication */
   half     = nrootranks + nleafranks;
@@ -858,11 +926,17 @@ static PetscErrorCode PetscSFBasicGetPack(PetscSF sf,MPI_Datatype unit,const voi
   leafreqs = link->requests + bas->niranks - bas->ndiranks;
   comm     = PetscObjectComm((PetscObject)sf);
 
+  /* With shared memory, ranks on this node also get their own buffers and requests, used when no slot is free */
+  if (bas->shm) {
+    ierr = PetscMalloc2(half*2,&link->shmreqs,half,&link->statuses);CHKERRQ(ierr);
+    for (i=0; i<half*2; i++) link->shmreqs[i] = MPI_REQUEST_NULL;
+  }
+
   /* Allocate buffer and then init the persistent communcation */
   for (i=0; i<nrootranks; i++) {
-    ierr = PetscMalloc((rootoffset[i+1]-rootoffset[i])*link->unitbytes,&link->root[i]);CHKERRQ(ierr);
+    ierr = PetscMalloc(nvec*(rootoffset[i+1]-rootoffset[i])*link->unitbytes,&link->root[i]);CHKERRQ(ierr);
     if (i >= ndrootranks) {
-      ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
+      ierr = PetscMPIIntCast(nvec*(rootoffset[i+1]-rootoffset[i]),&n);CHKERRQ(ierr);
       ierr = MPI_Recv_init(link->root[i],n,unit,bas->iranks[i],bas->tag,comm,&rootreqs[i-ndrootranks]);CHKERRQ(ierr);      /* reduce */
       ierr = MPI_Send_init(link->root[i],n,unit,bas->iranks[i],bas->tag,comm,&rootreqs[i-ndrootranks+half]);CHKERRQ(ierr); /* bcast  */
     }
@@ -873,8 +947,8 @@ static PetscErrorCode PetscSFBasicGetPack(PetscSF sf,MPI_Datatype unit,const voi
       link->leaf[i] = link->root[0];
       continue;
     }
-    ierr = PetscMalloc((leafoffset[i+1]-leafoffset[i])*link->unitbytes,&link->leaf[i]);CHKERRQ(ierr);
-    ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
+    ierr = PetscMalloc(nvec*(leafoffset[i+1]-leafoffset[i])*link->unitbytes,&link->leaf[i]);CHKERRQ(ierr);
+    ierr = PetscMPIIntCast(nvec*(leafoffset[i+1]-leafoffset[i]),&n);CHKERRQ(ierr);
     ierr = MPI_Send_init(link->leaf[i],n,unit,sf->ranks[i],bas->tag,comm,&leafreqs[i-ndleafranks]);CHKERRQ(ierr);      /* reduce */
     ierr = MPI_Recv_init(link->leaf[i],n,unit,sf->ranks[i],bas->tag,comm,&leafreqs[i-ndleafranks+half]);CHKERRQ(ierr); /* bcast  */
   }
@@ -888,7 +962,7 @@ found:
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicGetPackInUse(PetscSF sf,MPI_Datatype unit,const void *key,PetscCopyMode cmode,PetscSFBasicPack *mylink)
+PetscErrorCode PetscSFBasicGetPackInUse(PetscSF sf,MPI_Datatype unit,PetscInt nvec,const void *key,PetscCopyMode cmode,PetscSFBasicPack *mylink)
 {
   PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode   ierr;
@@ -899,7 +973,7 @@ static PetscErrorCode PetscSFBasicGetPackInUse(PetscSF sf,MPI_Datatype unit,cons
   for (p=&bas->inuse; (link=*p); p=&link->next) {
     PetscBool match;
     ierr = MPIPetsc_Type_compare(unit,link->unit,&match);CHKERRQ(ierr);
-    if (match && (key == link->key)) {
+    if (match && (key == link->key) && (nvec == link->nvec)) {
       switch (cmode) {
       case PETSC_OWN_POINTER: *p = link->next; break; /* Remove from inuse list */
       case PETSC_USE_POINTER: break;
@@ -913,7 +987,7 @@ static PetscErrorCode PetscSFBasicGetPackInUse(PetscSF sf,MPI_Datatype unit,cons
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicReclaimPack(PetscSF sf,PetscSFBasicPack *link)
+PetscErrorCode PetscSFBasicReclaimPack(PetscSF sf,PetscSFBasicPack *link)
 {
   PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
 
@@ -931,6 +1005,18 @@ static PetscErrorCode PetscSFSetFromOptions_Basic(PetscOptionItems *PetscOptions
 
   PetscFunctionBegin;
   ierr = PetscOptionsHead(PetscOptionsObject,"PetscSF Basic options");CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) && defined(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+  if (!sf->setupcalled) {
+    PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
+    PetscInt      unitbytes = (PetscInt)bas->shmunitbytes;
+    ierr = PetscOptionsBool("-sf_basic_shared_memory","Communicate with processes on the same node through MPI-3 shared memory","None",bas->useshm,&bas->useshm,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsInt("-sf_basic_shared_memory_slots","Number of operations that may be in flight in the shared memory","None",bas->shmnslots,&bas->shmnslots,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsInt("-sf_basic_shared_memory_unit_bytes","Largest unit, times the number of arrays, communicated through the shared memory","None",unitbytes,&unitbytes,NULL);CHKERRQ(ierr);
+    if (bas->shmnslots < 1) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_OUTOFRANGE,"Number of shared memory slots must be positive");
+    if (unitbytes < 1) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_OUTOFRANGE,"Shared memory unit size must be positive");
+    bas->shmunitbytes = ((unitbytes+sizeof(PetscScalar)-1)/sizeof(PetscScalar))*sizeof(PetscScalar); /* keeps the packed data aligned */
+  }
+#endif
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -943,8 +1029,6 @@ static PetscErrorCode PetscSFReset_Basic(PetscSF sf)
 
   PetscFunctionBegin;
   if (bas->inuse) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Outstanding operation has not been completed");
-  ierr = PetscFree2(bas->iranks,bas->ioffset);CHKERRQ(ierr);
-  ierr = PetscFree(bas->irootloc);CHKERRQ(ierr);
   for (link=bas->avail; link; link=next) {
     PetscInt i;
     next = link->next;
@@ -958,9 +1042,23 @@ static PetscErrorCode PetscSFReset_Basic(PetscSF sf)
       ierr = MPI_Request_free(&link->requests[sf->nranks+bas->niranks+i]);CHKERRQ(ierr); /* used in bcast */
     }
     ierr = PetscFree(link->requests);CHKERRQ(ierr);
+    ierr = PetscFree2(link->shmreqs,link->statuses);CHKERRQ(ierr);
     ierr = PetscFree(link);CHKERRQ(ierr);
   }
   bas->avail = NULL;
+  ierr = PetscFree2(bas->iranks,bas->ioffset);CHKERRQ(ierr);
+  ierr = PetscFree(bas->irootloc);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) && defined(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+  if (bas->shm) {
+    ierr = MPI_Win_unlock_all(bas->shmwin);CHKERRQ(ierr);
+    ierr = MPI_Win_free(&bas->shmwin);CHKERRQ(ierr);
+  }
+#endif
+  ierr = PetscFree(bas->shmbases);CHKERRQ(ierr);
+  ierr = PetscFree2(bas->shmlastseq,bas->shmlastdir);CHKERRQ(ierr);
+  ierr = PetscFree3(bas->ishmranks,bas->ishmoffset,bas->ishmpack);CHKERRQ(ierr);
+  ierr = PetscFree3(bas->shmranks,bas->shmoffset,bas->shmpack);CHKERRQ(ierr);
+  bas->shm = PETSC_FALSE;
   PetscFunctionReturn(0);
 }
 
@@ -974,7 +1072,7 @@ static PetscErrorCode PetscSFDestroy_Basic(PetscSF sf)
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
+PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
 {
   /* PetscSF_Basic *bas = (PetscSF_Basic*)sf->data; */
   PetscErrorCode ierr;
@@ -988,48 +1086,175 @@ static PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBcastAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+/* Start of the n units that rank r of this node packs at offset off of its buffer, in the slot of operation seq. The
+   slots of a pair of ranks are consecutive, so that the offset and the length of the pair are enough to locate them */
+PETSC_STATIC_INLINE char *PetscSFBasicShmSlot(PetscSF_Basic *bas,PetscMPIInt r,PetscInt off,PetscInt n,PetscInt seq)
+{
+  return bas->shmbases[r] + bas->shmflagbytes + (bas->shmnslots*off + (seq%bas->shmnslots)*n)*bas->shmunitbytes;
+}
+
+/*
+   Number the operation starting with link and decide whether it packs for the ranks on this node in my slot. It does if
+   allowed, if the units fit and if the ranks that read the slot for its previous operation are done with it, otherwise it
+   sends to them as to other ranks, so it never waits. A rank looks for the data of an operation in the slot given by its
+   own number of the operation, so all ranks of the node must start the operations on this SF in the same order, every
+   operation counting whether or not it uses the slots. The messages, which all have the tag of the SF, already need that.
+*/
+static PetscErrorCode PetscSFBasicShmBegin(PetscSF sf,PetscSFBasicPack link,PetscSFDirection direction,PetscBool allowed,PetscBool *useshm)
+{
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode ierr;
+  PetscInt       s;
+
+  PetscFunctionBegin;
+  *useshm = PETSC_FALSE;
+  if (!bas->shm) PetscFunctionReturn(0);
+  link->shmseq = bas->shmseq++;
+  if (!allowed || link->nvec*link->unitbytes > bas->shmunitbytes) PetscFunctionReturn(0);
+  s    = link->shmseq%bas->shmnslots;
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) && defined(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+  ierr = PetscSFBasicShmSlotFree(sf,s,useshm);CHKERRQ(ierr);
+#endif
+  if (*useshm) {
+    bas->shmlastseq[s] = link->shmseq;
+    bas->shmlastdir[s] = direction;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Tell the ranks of this node in [ndranks,nranks) that their data is in my slot. The empty messages take the place of the
+   data messages, so the receiving rank learns from the count of its receive where the data is, and no barrier is needed
+*/
+static PetscErrorCode PetscSFBasicShmNotify(PetscSF sf,MPI_Datatype unit,PetscInt nranks,PetscInt ndranks,const PetscMPIInt *ranks,const PetscMPIInt *shmranks,char *const *bufs,MPI_Request *reqs)
+{
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) && defined(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+  ierr = MPI_Win_sync(bas->shmwin);CHKERRQ(ierr); /* the packed data is visible before the messages arrive */
+#endif
+  for (i=ndranks; i<nranks; i++) {
+    if (shmranks[i] == MPI_PROC_NULL) continue;
+    ierr = MPI_Isend(bufs[i],0,unit,ranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&reqs[i-ndranks]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Where the data received from a rank is: in its slot if it is on this node and sent an empty message */
+static PetscErrorCode PetscSFBasicShmFind(PetscSF sf,PetscSFBasicPack link,MPI_Datatype unit,PetscMPIInt shmrank,const MPI_Status *status,PetscInt off,PetscInt n,const char **packstart)
+{
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode ierr;
+  PetscMPIInt    count;
+
+  PetscFunctionBegin;
+  if (!bas->shm || shmrank == MPI_PROC_NULL) PetscFunctionReturn(0);
+  ierr = MPI_Get_count(status,unit,&count);CHKERRQ(ierr);
+  if (!count) *packstart = PetscSFBasicShmSlot(bas,shmrank,off,n,link->shmseq);
+  PetscFunctionReturn(0);
+}
+
+/* Let the ranks of this node in [ndranks,nranks) whose slot I read reuse it, by setting my flag in their buffer */
+static PetscErrorCode PetscSFBasicShmRelease(PetscSF sf,PetscSFBasicPack link,MPI_Datatype unit,PetscInt nranks,PetscInt ndranks,const PetscMPIInt *shmranks,const MPI_Status *statuses)
+{
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode ierr;
+  PetscInt       i,s;
+  PetscMPIInt    count;
+
+  PetscFunctionBegin;
+  if (!bas->shm) PetscFunctionReturn(0);
+  s = link->shmseq%bas->shmnslots;
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) && defined(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+  ierr = MPI_Win_sync(bas->shmwin);CHKERRQ(ierr); /* the slots are read before the flags are set */
+#endif
+  for (i=ndranks; i<nranks; i++) {
+    if (shmranks[i] == MPI_PROC_NULL) continue;
+    ierr = MPI_Get_count(&statuses[i-ndranks],unit,&count);CHKERRQ(ierr);
+    if (!count) ((PetscInt*)bas->shmbases[shmranks[i]])[s*bas->shmsize+bas->shmrank] = link->shmseq;
+  }
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) && defined(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+  ierr = MPI_Win_sync(bas->shmwin);CHKERRQ(ierr);
+#endif
+  PetscFunctionReturn(0);
+}
+
+/* Unpack the nvec segments of a rank buffer holding n entries per array into the arrays data[] */
+static PetscErrorCode PetscSFBasicUnpackMultiple(PetscSFBasicPack link,MPI_Datatype unit,MPI_Op op,void (*UnpackOp)(PetscInt,PetscInt,const PetscInt*,void*,const void*),PetscMPIInt typesize,PetscMPIInt n,const PetscInt *idx,void *const data[],const char *packstart)
+{
+  PetscInt       k;
+#if defined(PETSC_HAVE_MPI_REDUCE_LOCAL)
+  PetscErrorCode ierr;
+  PetscInt       j;
+#endif
+
+  PetscFunctionBegin;
+  for (k=0; k<link->nvec; k++,packstart+=(size_t)n*typesize) {
+    if (UnpackOp) { (*UnpackOp)(n,link->bs,idx,data[k],(const void*)packstart); }
+#if defined(PETSC_HAVE_MPI_REDUCE_LOCAL)
+    else if (n) { /* the op should be defined to operate on the whole datatype, so we ignore link->bs */
+      for (j=0; j<n; j++) { ierr = MPI_Reduce_local(packstart+j*typesize,((char*)data[k])+idx[j]*typesize,1,unit,op);CHKERRQ(ierr); }
+    }
+#else
+    else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No unpacking reduction operation for this MPI_Op");
+#endif
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpBeginMultiple_Basic(PetscSF sf,MPI_Datatype unit,PetscInt nvec,const void *const rootdata[],void *const leafdata[],MPI_Op op)
 {
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode    ierr;
   PetscSFBasicPack  link;
-  PetscInt          i,nrootranks,ndrootranks,nleafranks,ndleafranks;
+  PetscInt          i,k,nrootranks,ndrootranks,nleafranks,ndleafranks;
   const PetscInt    *rootoffset,*leafoffset,*rootloc,*leafloc;
   const PetscMPIInt *rootranks,*leafranks;
   MPI_Request       *rootreqs,*leafreqs;
   PetscMPIInt       n;
+  PetscBool         useshm;
 
   PetscFunctionBegin;
   ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,&rootloc);CHKERRQ(ierr);
   ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,&leafloc);CHKERRQ(ierr);
-  ierr = PetscSFBasicGetPack(sf,unit,rootdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetPack(sf,unit,nvec,rootdata[0],&link);CHKERRQ(ierr);
+  ierr = PetscSFBasicShmBegin(sf,link,PETSC_SF_ROOT2LEAF_BCAST,PETSC_TRUE,&useshm);CHKERRQ(ierr);
 
   ierr = PetscSFBasicPackGetReqs(sf,link,PETSC_SF_ROOT2LEAF_BCAST,&rootreqs,&leafreqs);CHKERRQ(ierr);
   /* Eagerly post leaf receives, but only from non-distinguished ranks -- distinguished ranks will receive via shared memory */
-  ierr = PetscMPIIntCast(leafoffset[nleafranks]-leafoffset[ndleafranks],&n);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(nvec*(leafoffset[nleafranks]-leafoffset[ndleafranks]),&n);CHKERRQ(ierr);
   ierr = MPI_Startall_irecv(n,unit,nleafranks-ndleafranks,leafreqs);CHKERRQ(ierr);
 
-  /* Pack and send root data */
+  /* Pack and send root data, one message per rank carrying all arrays. Leaf ranks on this node read it in my slot */
   for (i=0; i<nrootranks; i++) {
-    void *packstart = link->root[i];
+    char *packstart = link->root[i];
     ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
-    (*link->Pack)(n,link->bs,rootloc+rootoffset[i],rootdata,packstart);
+    if (useshm && bas->ishmranks[i] != MPI_PROC_NULL) packstart = PetscSFBasicShmSlot(bas,bas->shmrank,bas->ishmpack[i],n,link->shmseq);
+    for (k=0; k<nvec; k++,packstart+=n*link->unitbytes) (*link->Pack)(n,link->bs,rootloc+rootoffset[i],rootdata[k],packstart);
     if (i < ndrootranks) continue; /* shared memory */
-    ierr = MPI_Start_isend(n,unit,&rootreqs[i-ndrootranks]);CHKERRQ(ierr);
+    if (useshm && bas->ishmranks[i] != MPI_PROC_NULL) continue;
+    ierr = MPI_Start_isend(nvec*n,unit,&rootreqs[i-ndrootranks]);CHKERRQ(ierr);
   }
+  if (useshm) {ierr = PetscSFBasicShmNotify(sf,unit,nrootranks,ndrootranks,rootranks,bas->ishmranks,link->root,link->shmreqs+(rootreqs-link->requests));CHKERRQ(ierr);}
   PetscFunctionReturn(0);
 }
 
-PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+static PetscErrorCode PetscSFBcastAndOpEndMultiple_Basic(PetscSF sf,MPI_Datatype unit,PetscInt nvec,const void *const rootdata[],void *const leafdata[],MPI_Op op)
 {
+  PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode   ierr;
   PetscSFBasicPack link;
   PetscInt         i,nleafranks,ndleafranks;
   const PetscInt   *leafoffset,*leafloc;
   void             (*UnpackOp)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
   PetscMPIInt      typesize = -1;
+  const MPI_Status *statuses;
 
   PetscFunctionBegin;
-  ierr = PetscSFBasicGetPackInUse(sf,unit,rootdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetPackInUse(sf,unit,nvec,rootdata[0],PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
   ierr = PetscSFBasicPackWaitall(sf,link,PETSC_SF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
   ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,&leafloc);CHKERRQ(ierr);
   ierr = PetscSFBasicPackGetUnpackOp(sf,link,op,&UnpackOp);CHKERRQ(ierr);
@@ -1037,24 +1262,37 @@ PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,const voi
   if (UnpackOp) { typesize = link->unitbytes; }
   else { ierr = MPI_Type_size(unit,&typesize);CHKERRQ(ierr); }
 
+  statuses = link->statuses + (bas->niranks - bas->ndiranks); /* those of the leaf receives */
   for (i=0; i<nleafranks; i++) {
-    PetscMPIInt n   = leafoffset[i+1] - leafoffset[i];
-    char *packstart = (char *) link->leaf[i];
-    if (UnpackOp) { (*UnpackOp)(n,link->bs,leafloc+leafoffset[i],leafdata,(const void *)packstart); }
-#if defined(PETSC_HAVE_MPI_REDUCE_LOCAL)
-    else if (n) { /* the op should be defined to operate on the whole datatype, so we ignore link->bs */
-      PetscInt j;
-      for (j=0; j<n; j++) { ierr = MPI_Reduce_local(packstart+j*typesize,((char *) leafdata)+(leafloc[leafoffset[i]+j])*typesize,1,unit,op);CHKERRQ(ierr); }
-    }
-#else
-    else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No unpacking reduction operation for this MPI_Op");
-#endif
+    PetscMPIInt n = leafoffset[i+1] - leafoffset[i];
+    const char  *packstart = link->leaf[i];
+    if (i >= ndleafranks) {ierr = PetscSFBasicShmFind(sf,link,unit,bas->shm ? bas->shmranks[i] : MPI_PROC_NULL,statuses+i-ndleafranks,bas->shm ? bas->shmoffset[i] : 0,n,&packstart);CHKERRQ(ierr);}
+    ierr = PetscSFBasicUnpackMultiple(link,unit,op,UnpackOp,typesize,n,leafloc+leafoffset[i],leafdata,packstart);CHKERRQ(ierr);
   }
+  ierr = PetscSFBasicShmRelease(sf,link,unit,nleafranks,ndleafranks,bas->shmranks,statuses);CHKERRQ(ierr);
 
   ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode PetscSFBcastAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastAndOpBeginMultiple_Basic(sf,unit,1,&rootdata,&leafdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastAndOpEndMultiple_Basic(sf,unit,1,&rootdata,&leafdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /* Send from roots to leaves */
 static PetscErrorCode PetscSFBcastBegin_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
 {
@@ -1074,52 +1312,68 @@ PetscErrorCode PetscSFBcastEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *ro
   PetscFunctionReturn(0);
 }
 
-/* leaf -> root with reduction */
-PetscErrorCode PetscSFReduceBegin_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+/* leaf -> root with reduction, allowshm tells whether leaf data may be packed in a shared slot */
+static PetscErrorCode PetscSFBasicReduceBegin_Private(PetscSF sf,MPI_Datatype unit,PetscInt nvec,const void *const leafdata[],void *const rootdata[],MPI_Op op,PetscBool allowshm)
 {
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
   PetscSFBasicPack  link;
   PetscErrorCode    ierr;
-  PetscInt          i,nrootranks,ndrootranks,nleafranks,ndleafranks;
+  PetscInt          i,k,nrootranks,ndrootranks,nleafranks,ndleafranks;
   const PetscInt    *rootoffset,*leafoffset,*rootloc,*leafloc;
   const PetscMPIInt *rootranks,*leafranks;
   MPI_Request       *rootreqs,*leafreqs;
   PetscMPIInt       n;
+  PetscBool         useshm;
 
   PetscFunctionBegin;
   ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,&rootloc);CHKERRQ(ierr);
   ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,&leafloc);CHKERRQ(ierr);
-  ierr = PetscSFBasicGetPack(sf,unit,leafdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetPack(sf,unit,nvec,leafdata[0],&link);CHKERRQ(ierr);
+  ierr = PetscSFBasicShmBegin(sf,link,PETSC_SF_LEAF2ROOT_REDUCE,allowshm,&useshm);CHKERRQ(ierr);
 
   ierr = PetscSFBasicPackGetReqs(sf,link,PETSC_SF_LEAF2ROOT_REDUCE,&rootreqs,&leafreqs);CHKERRQ(ierr);
   /* Eagerly post root receives for non-distinguished ranks */
-  ierr = PetscMPIIntCast(rootoffset[nrootranks]-rootoffset[ndrootranks],&n);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(nvec*(rootoffset[nrootranks]-rootoffset[ndrootranks]),&n);CHKERRQ(ierr);
   ierr = MPI_Startall_irecv(n,unit,nrootranks-ndrootranks,rootreqs);CHKERRQ(ierr);
 
-  /* Pack and send leaf data */
+  /* Pack and send leaf data, one message per rank carrying all arrays. Root ranks on this node read it in my slot */
   for (i=0; i<nleafranks; i++) {
-    void *packstart = link->leaf[i];
+    char *packstart = link->leaf[i];
     ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
-    (*link->Pack)(n,link->bs,leafloc+leafoffset[i],leafdata,packstart);
+    if (useshm && bas->shmranks[i] != MPI_PROC_NULL) packstart = PetscSFBasicShmSlot(bas,bas->shmrank,bas->shmpack[i],n,link->shmseq);
+    for (k=0; k<nvec; k++,packstart+=n*link->unitbytes) (*link->Pack)(n,link->bs,leafloc+leafoffset[i],leafdata[k],packstart);
     if (i < ndleafranks) continue; /* shared memory */
-    ierr = MPI_Start_isend(n,unit,&leafreqs[i-ndleafranks]);CHKERRQ(ierr);
+    if (useshm && bas->shmranks[i] != MPI_PROC_NULL) continue;
+    ierr = MPI_Start_isend(nvec*n,unit,&leafreqs[i-ndleafranks]);CHKERRQ(ierr);
   }
+  if (useshm) {ierr = PetscSFBasicShmNotify(sf,unit,nleafranks,ndleafranks,leafranks,bas->shmranks,link->leaf,link->shmreqs+(leafreqs-link->requests));CHKERRQ(ierr);}
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+static PetscErrorCode PetscSFReduceBeginMultiple_Basic(PetscSF sf,MPI_Datatype unit,PetscInt nvec,const void *const leafdata[],void *const rootdata[],MPI_Op op)
 {
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicReduceBegin_Private(sf,unit,nvec,leafdata,rootdata,op,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceEndMultiple_Basic(PetscSF sf,MPI_Datatype unit,PetscInt nvec,const void *const leafdata[],void *const rootdata[],MPI_Op op)
+{
+  PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   void             (*UnpackOp)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
   PetscErrorCode   ierr;
   PetscSFBasicPack link;
-  PetscInt         i,nrootranks;
+  PetscInt         i,nrootranks,ndrootranks;
   PetscMPIInt      typesize = -1;
   const PetscInt   *rootoffset,*rootloc;
 
   PetscFunctionBegin;
-  ierr = PetscSFBasicGetPackInUse(sf,unit,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetPackInUse(sf,unit,nvec,leafdata[0],PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
   /* This implementation could be changed to unpack as receives arrive, at the cost of non-determinism */
   ierr = PetscSFBasicPackWaitall(sf,link,PETSC_SF_LEAF2ROOT_REDUCE);CHKERRQ(ierr);
-  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,NULL,NULL,&rootoffset,&rootloc);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,&rootloc);CHKERRQ(ierr);
   ierr = PetscSFBasicPackGetUnpackOp(sf,link,op,&UnpackOp);CHKERRQ(ierr);
   if (UnpackOp) {
     typesize = link->unitbytes;
@@ -1128,34 +1382,41 @@ static PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,const
     ierr = MPI_Type_size(unit,&typesize);CHKERRQ(ierr);
   }
   for (i=0; i<nrootranks; i++) {
-    PetscMPIInt n   = rootoffset[i+1] - rootoffset[i];
-    char *packstart = (char *) link->root[i];
-
-    if (UnpackOp) {
-      (*UnpackOp)(n,link->bs,rootloc+rootoffset[i],rootdata,(const void *)packstart);
-    }
-#if defined(PETSC_HAVE_MPI_REDUCE_LOCAL)
-    else if (n) { /* the op should be defined to operate on the whole datatype, so we ignore link->bs */
-      PetscInt j;
-
-      for (j = 0; j < n; j++) {
-        ierr = MPI_Reduce_local(packstart+j*typesize,((char *) rootdata)+(rootloc[rootoffset[i]+j])*typesize,1,unit,op);CHKERRQ(ierr);
-      }
-    }
-#else
-    else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No unpacking reduction operation for this MPI_Op");
-#endif
+    PetscMPIInt n = rootoffset[i+1] - rootoffset[i];
+    const char  *packstart = link->root[i];
+    if (i >= ndrootranks) {ierr = PetscSFBasicShmFind(sf,link,unit,bas->shm ? bas->ishmranks[i] : MPI_PROC_NULL,link->statuses+i-ndrootranks,bas->shm ? bas->ishmoffset[i] : 0,n,&packstart);CHKERRQ(ierr);}
+    ierr = PetscSFBasicUnpackMultiple(link,unit,op,UnpackOp,typesize,n,rootloc+rootoffset[i],rootdata,packstart);CHKERRQ(ierr);
   }
+  ierr = PetscSFBasicShmRelease(sf,link,unit,nrootranks,ndrootranks,bas->ishmranks,link->statuses);CHKERRQ(ierr);
   ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode PetscSFReduceBegin_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReduceBeginMultiple_Basic(sf,unit,1,&leafdata,&rootdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReduceEndMultiple_Basic(sf,unit,1,&leafdata,&rootdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode PetscSFFetchAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
 {
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = PetscSFReduceBegin_Basic(sf,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  /* The roots update the packed leaf data and send it back, so it does not go through the shared slots */
+  ierr = PetscSFBasicReduceBegin_Private(sf,unit,1,&leafdata,&rootdata,op,PETSC_FALSE);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -1171,7 +1432,7 @@ static PetscErrorCode PetscSFFetchAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,vo
   PetscMPIInt       n;
 
   PetscFunctionBegin;
-  ierr = PetscSFBasicGetPackInUse(sf,unit,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetPackInUse(sf,unit,1,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
   /* This implementation could be changed to unpack as receives arrive, at the cost of non-determinism */
   ierr = PetscSFBasicPackWaitall(sf,link,PETSC_SF_LEAF2ROOT_REDUCE);CHKERRQ(ierr);
   ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,&rootloc);CHKERRQ(ierr);
@@ -1200,7 +1461,7 @@ static PetscErrorCode PetscSFFetchAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,vo
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFGetLeafRanks_Basic(PetscSF sf,PetscInt *niranks,const PetscMPIInt **iranks,const PetscInt **ioffset,const PetscInt **irootloc)
+PetscErrorCode PetscSFGetLeafRanks_Basic(PetscSF sf,PetscInt *niranks,const PetscMPIInt **iranks,const PetscInt **ioffset,const PetscInt **irootloc)
 {
   PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
 
@@ -1233,7 +1494,14 @@ PETSC_EXTERN PetscErrorCode PetscSFCreate_Basic(PetscSF sf)
   sf->ops->FetchAndOpEnd   = PetscSFFetchAndOpEnd_Basic;
   sf->ops->GetLeafRanks    = PetscSFGetLeafRanks_Basic;
 
+  sf->ops->BcastAndOpBeginMultiple = PetscSFBcastAndOpBeginMultiple_Basic;
+  sf->ops->BcastAndOpEndMultiple   = PetscSFBcastAndOpEndMultiple_Basic;
+  sf->ops->ReduceBeginMultiple     = PetscSFReduceBeginMultiple_Basic;
+  sf->ops->ReduceEndMultiple       = PetscSFReduceEndMultiple_Basic;
+
   ierr = PetscNewLog(sf,&bas);CHKERRQ(ierr);
+  bas->shmnslots    = 4;
+  bas->shmunitbytes = sizeof(PetscScalar);
   sf->data = (void*)bas;
   PetscFunctionReturn(0);
 }
@@ -0,0 +1,102 @@
+#if !defined(__SFBASIC_H)
+#define __SFBASIC_H
+
+#include <petsc/private/sfimpl.h>
+
+typedef struct _n_PetscSFBasicPack *PetscSFBasicPack;
+struct _n_PetscSFBasicPack {
+  void (*Pack)(PetscInt,PetscInt,const PetscInt*,const void*,void*);
+  void (*UnpackInsert)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackAdd)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackMin)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackMax)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackMinloc)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackMaxloc)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackMult)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackLAND)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackBAND)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackLOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackBOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackLXOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackBXOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*FetchAndInsert)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndAdd)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndMin)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndMax)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndMinloc)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndMaxloc)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndMult)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndLAND)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndBAND)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndLOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndBOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndLXOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndBXOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+
+  MPI_Datatype     unit;
+  PetscBool        isbuiltin;   /* Is unit an MPI builtin datatype? */
+  size_t           unitbytes;   /* Number of bytes in a unit */
+  PetscInt         bs;          /* Number of basic units in a unit */
+  PetscInt         nvec;        /* Number of arrays packed together, each rank's buffer holds nvec consecutive segments */
+  const void       *key;        /* Array used as key for operation */
+  char             **root;      /* Packed root data, indexed by leaf rank */
+  char             **leaf;      /* Packed leaf data, indexed by root rank */
+  MPI_Request      *requests;   /* Array of root requests followed by leaf requests */
+  MPI_Request      *shmreqs;    /* Empty sends telling ranks on this node that the data is in a shared slot, indexed as requests */
+  MPI_Status       *statuses;   /* Statuses of the requests of one direction, the receive counts tell how ranks on this node sent */
+  PetscInt         shmseq;      /* Sequence number of the current operation, which selects the shared slot */
+  PetscSFBasicPack next;
+};
+
+typedef enum {PETSC_SF_LEAF2ROOT_REDUCE, PETSC_SF_ROOT2LEAF_BCAST} PetscSFDirection;
+
+/* Fields shared by PetscSF_Basic and the implementations that reuse its setup, e.g. PetscSF_Neighbor */
+#define SFBASICHEADER \
+  PetscMPIInt      tag;         /* Tag used for point-to-point communication */ \
+  PetscMPIInt      niranks;     /* Number of incoming ranks (ranks accessing my roots) */ \
+  PetscMPIInt      ndiranks;    /* Number of incoming ranks (ranks accessing my roots) in distinguished set */ \
+  PetscMPIInt      *iranks;     /* Array of ranks that reference my roots */ \
+  PetscInt         itotal;      /* Total number of graph edges referencing my roots */ \
+  PetscInt         *ioffset;    /* Array of length niranks+1 holding offset in irootloc[] for each rank */ \
+  PetscInt         *irootloc;   /* Incoming roots referenced by ranks starting at ioffset[rank] */ \
+  PetscSFBasicPack avail;       /* One or more entries per MPI Datatype, lazily constructed */ \
+  PetscSFBasicPack inuse;       /* Buffers being used for transactions that have not yet completed */ \
+  PetscBool        useshm;      /* Use shared memory with non-distinguished ranks on the same node, if available */ \
+  PetscBool        shm;         /* Whether shared memory is used with the current setup */ \
+  MPI_Comm         shmcomm;     /* Communicator of the ranks on this node, if shm */ \
+  PetscMPIInt      shmsize;     /* Size of shmcomm */ \
+  PetscMPIInt      *ishmranks;  /* Rank in shmcomm of each incoming rank, or MPI_PROC_NULL if it is distinguished or on another node */ \
+  PetscInt         *ishmoffset; /* Offset (in units) of the leaf data packed for my roots in the shared buffer of ishmranks[i] */ \
+  PetscInt         *ishmpack;   /* Offset (in units) of the root data I pack for ishmranks[i] in my shared buffer */ \
+  PetscMPIInt      *shmranks;   /* Rank in shmcomm of each sf->ranks[i], or MPI_PROC_NULL if it is distinguished or on another node */ \
+  PetscInt         *shmoffset;  /* Offset (in units) of the root data packed for my leaves in the shared buffer of shmranks[i] */ \
+  PetscInt         *shmpack;    /* Offset (in units) of the leaf data I pack for shmranks[i] in my shared buffer */ \
+  PetscInt         shmtotal;    /* Number of units in a slot of my shared buffer, for each array */ \
+  PetscMPIInt      shmrank;     /* Rank in shmcomm */ \
+  char             **shmbases;  /* Shared buffers of all ranks on this node, indexed by rank in shmcomm */ \
+  PetscInt         shmnslots;   /* Number of slots in a shared buffer, operations use them in turn */ \
+  size_t           shmunitbytes;/* Largest number of bytes per unit, for all arrays of an operation, that fits in a slot */ \
+  size_t           shmflagbytes;/* Bytes at the start of a shared buffer holding the flags of its slots */ \
+  PetscInt         shmseq;      /* Number of operations started, the same on all ranks */ \
+  PetscInt         *shmlastseq; /* Operation that last packed into each of my slots, or -1 */ \
+  PetscSFDirection *shmlastdir  /* Direction of that operation, which gives the ranks that must have read the slot */
+
+typedef struct {
+  SFBASICHEADER;
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) && defined(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+  MPI_Win          shmwin;      /* Window holding the shared buffers of the node, allocated at setup if shm */
+#endif
+} PetscSF_Basic;
+
+PETSC_INTERN PetscErrorCode PetscSFSetUp_Basic(PetscSF);
+PETSC_INTERN PetscErrorCode PetscSFView_Basic(PetscSF,PetscViewer);
+PETSC_INTERN PetscErrorCode PetscSFGetLeafRanks_Basic(PetscSF,PetscInt*,const PetscMPIInt**,const PetscInt**,const PetscInt**);
+PETSC_INTERN PetscErrorCode PetscSFBasicGetRootInfo(PetscSF,PetscInt*,PetscInt*,const PetscMPIInt**,const PetscInt**,const PetscInt**);
+PETSC_INTERN PetscErrorCode PetscSFBasicGetLeafInfo(PetscSF,PetscInt*,PetscInt*,const PetscMPIInt**,const PetscInt**,const PetscInt**);
+PETSC_INTERN PetscErrorCode PetscSFBasicPackTypeSetup(PetscSFBasicPack,MPI_Datatype);
+PETSC_INTERN PetscErrorCode PetscSFBasicPackGetUnpackOp(PetscSF,PetscSFBasicPack,MPI_Op,void (**)(PetscInt,PetscInt,const PetscInt*,void*,const void*));
+PETSC_INTERN PetscErrorCode PetscSFBasicPackGetFetchAndOp(PetscSF,PetscSFBasicPack,MPI_Op,void (**)(PetscInt,PetscInt,const PetscInt*,void*,void*));
+PETSC_INTERN PetscErrorCode PetscSFBasicGetPackInUse(PetscSF,MPI_Datatype,PetscInt,const void*,PetscCopyMode,PetscSFBasicPack*);
+PETSC_INTERN PetscErrorCode PetscSFBasicReclaimPack(PetscSF,PetscSFBasicPack*);
+
+#endif
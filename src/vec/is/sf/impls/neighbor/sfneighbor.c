@@ -0,0 +1,330 @@
+#include <../src/vec/is/sf/impls/basic/sfbasic.h> /*I "petscsf.h" I*/
+
+/* Convenience local types */
+typedef struct {
+  SFBASICHEADER;
+  MPI_Comm      comms[2];       /* Communicators with distributed topology in both directions */
+  PetscMPIInt   *rootdispls,*rootcounts,*leafdispls,*leafcounts; /* displs/counts for non-distinguished ranks */
+} PetscSF_Neighbor;
+
+/*
+   The pack links are shared with PetscSF Basic, but link->root[] and link->leaf[] point into one contiguous
+   buffer each, so that a single neighborhood collective can send or receive all non-distinguished ranks.
+   Only two requests are used: one for reduce (leaf to root) and one for bcast (root to leaf).
+*/
+static PetscErrorCode PetscSFNeighborGetPack(PetscSF sf,MPI_Datatype unit,const void *key,PetscSFBasicPack *mylink)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link,*p;
+  PetscInt         nrootranks,ndrootranks,nleafranks,ndleafranks,i;
+  const PetscInt   *rootoffset,*leafoffset;
+  char             *rootbuf,*leafbuf;
+
+  PetscFunctionBegin;
+  /* Look for types in cache */
+  for (p=&dat->avail; (link=*p); p=&link->next) {
+    PetscBool match;
+    ierr = MPIPetsc_Type_compare(unit,link->unit,&match);CHKERRQ(ierr);
+    if (match) {
+      *p = link->next;          /* Remove from available list */
+      goto found;
+    }
+  }
+
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscNew(&link);CHKERRQ(ierr);
+  ierr = PetscSFBasicPackTypeSetup(link,unit);CHKERRQ(ierr);
+  link->nvec = 1;
+  ierr = PetscMalloc2(nrootranks,&link->root,nleafranks,&link->leaf);CHKERRQ(ierr);
+  ierr = PetscMalloc1(2,&link->requests);CHKERRQ(ierr);
+  link->requests[PETSC_SF_LEAF2ROOT_REDUCE] = MPI_REQUEST_NULL;
+  link->requests[PETSC_SF_ROOT2LEAF_BCAST]  = MPI_REQUEST_NULL;
+
+  /* Root buffer holds all ranks, leaf buffer only non-distinguished ranks since distinguished leaves alias roots */
+  ierr = PetscMalloc(rootoffset[nrootranks]*link->unitbytes,&rootbuf);CHKERRQ(ierr);
+  ierr = PetscMalloc((leafoffset[nleafranks]-leafoffset[ndleafranks])*link->unitbytes,&leafbuf);CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) link->root[i] = rootbuf + rootoffset[i]*link->unitbytes;
+  for (i=0; i<nleafranks; i++) {
+    if (i < ndleafranks) {      /* Leaf buffers for distinguished ranks are pointers directly into root buffers */
+      if (ndrootranks != 1) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Cannot match distinguished ranks");
+      link->leaf[i] = link->root[0];
+      continue;
+    }
+    link->leaf[i] = leafbuf + (leafoffset[i]-leafoffset[ndleafranks])*link->unitbytes;
+  }
+  /* Buffers are later freed through link->root[0] and link->leaf[ndleafranks], so drop them now if nothing points to them */
+  if (!nrootranks) {ierr = PetscFree(rootbuf);CHKERRQ(ierr);}
+  if (ndleafranks == nleafranks) {ierr = PetscFree(leafbuf);CHKERRQ(ierr);}
+
+found:
+  link->key  = key;
+  link->next = dat->inuse;
+  dat->inuse = link;
+
+  *mylink = link;
+  PetscFunctionReturn(0);
+}
+
+/* Start of the contiguous remote part of root and leaf buffers of a link */
+PETSC_STATIC_INLINE void *PetscSFNeighborRootBuf(PetscSF sf,PetscSFBasicPack link)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  return dat->niranks > dat->ndiranks ? (void*)link->root[dat->ndiranks] : NULL;
+}
+
+PETSC_STATIC_INLINE void *PetscSFNeighborLeafBuf(PetscSF sf,PetscSFBasicPack link)
+{
+  return sf->nranks > sf->ndranks ? (void*)link->leaf[sf->ndranks] : NULL;
+}
+
+static PetscErrorCode PetscSFSetUp_Neighbor(PetscSF sf)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscInt         i,j,nrootranks,ndrootranks,nleafranks,ndleafranks;
+  const PetscInt   *rootoffset,*leafoffset;
+  PetscMPIInt      m,n,*weights;
+  MPI_Comm         comm;
+
+  PetscFunctionBegin;
+  ierr = PetscSFSetUp_Basic(sf);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,NULL);CHKERRQ(ierr);
+
+  /* Only setup MPI displs/counts for non-distinguished ranks. Distinguished ranks use shared memory */
+  ierr = PetscMalloc4(nrootranks-ndrootranks,&dat->rootdispls,nrootranks-ndrootranks,&dat->rootcounts,nleafranks-ndleafranks,&dat->leafdispls,nleafranks-ndleafranks,&dat->leafcounts);CHKERRQ(ierr);
+  for (i=ndrootranks,j=0; i<nrootranks; i++,j++) {
+    ierr = PetscMPIIntCast(rootoffset[i]-rootoffset[ndrootranks],&m);CHKERRQ(ierr); dat->rootdispls[j] = m;
+    ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);          dat->rootcounts[j] = n;
+  }
+  for (i=ndleafranks,j=0; i<nleafranks; i++,j++) {
+    ierr = PetscMPIIntCast(leafoffset[i]-leafoffset[ndleafranks],&m);CHKERRQ(ierr); dat->leafdispls[j] = m;
+    ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);          dat->leafcounts[j] = n;
+  }
+
+  /* Roots send to the ranks referencing them in bcast, and receive from them in reduce. The graphs get unit weights,
+     since the MPI_UNWEIGHTED and MPI_WEIGHTS_EMPTY constants are not valid arrays to compilers checking the arguments */
+  ierr = PetscObjectGetComm((PetscObject)sf,&comm);CHKERRQ(ierr);
+  n    = PetscMax(1,PetscMax(sf->nranks-sf->ndranks,dat->niranks-dat->ndiranks));
+  ierr = PetscMalloc1(n,&weights);CHKERRQ(ierr);
+  for (i=0; i<n; i++) weights[i] = 1;
+  ierr = MPI_Dist_graph_create_adjacent(comm,sf->nranks-sf->ndranks,sf->ranks+sf->ndranks,weights,dat->niranks-dat->ndiranks,dat->iranks+dat->ndiranks,weights,MPI_INFO_NULL,0,&dat->comms[PETSC_SF_ROOT2LEAF_BCAST]);CHKERRQ(ierr);
+  ierr = MPI_Dist_graph_create_adjacent(comm,dat->niranks-dat->ndiranks,dat->iranks+dat->ndiranks,weights,sf->nranks-sf->ndranks,sf->ranks+sf->ndranks,weights,MPI_INFO_NULL,0,&dat->comms[PETSC_SF_LEAF2ROOT_REDUCE]);CHKERRQ(ierr);
+  ierr = PetscFree(weights);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReset_Neighbor(PetscSF sf)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link,next;
+  PetscInt         i;
+
+  PetscFunctionBegin;
+  if (dat->inuse) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Outstanding operation has not been completed");
+  for (link=dat->avail; link; link=next) {
+    next = link->next;
+    if (!link->isbuiltin) {ierr = MPI_Type_free(&link->unit);CHKERRQ(ierr);}
+    if (dat->niranks) {ierr = PetscFree(link->root[0]);CHKERRQ(ierr);}
+    if (sf->nranks > sf->ndranks) {ierr = PetscFree(link->leaf[sf->ndranks]);CHKERRQ(ierr);}
+    ierr = PetscFree2(link->root,link->leaf);CHKERRQ(ierr);
+    ierr = PetscFree(link->requests);CHKERRQ(ierr);
+    ierr = PetscFree(link);CHKERRQ(ierr);
+  }
+  dat->avail = NULL;
+  for (i=0; i<2; i++) {
+    if (dat->comms[i] != MPI_COMM_NULL) {ierr = MPI_Comm_free(&dat->comms[i]);CHKERRQ(ierr);}
+  }
+  ierr = PetscFree4(dat->rootdispls,dat->rootcounts,dat->leafdispls,dat->leafcounts);CHKERRQ(ierr);
+  ierr = PetscFree2(dat->iranks,dat->ioffset);CHKERRQ(ierr);
+  ierr = PetscFree(dat->irootloc);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDestroy_Neighbor(PetscSF sf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReset_Neighbor(sf);CHKERRQ(ierr);
+  ierr = PetscFree(sf->data);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Unpack the data received from leaves (direction reduce) or roots (direction bcast) with op */
+static PetscErrorCode PetscSFNeighborUnpack(PetscSF sf,PetscSFBasicPack link,MPI_Datatype unit,PetscInt nranks,const PetscInt *offset,const PetscInt *loc,char **bufs,void *data,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+  PetscMPIInt    typesize = -1;
+  void           (*UnpackOp)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicPackGetUnpackOp(sf,link,op,&UnpackOp);CHKERRQ(ierr);
+  if (UnpackOp) typesize = link->unitbytes;
+  else {ierr = MPI_Type_size(unit,&typesize);CHKERRQ(ierr);}
+  for (i=0; i<nranks; i++) {
+    PetscMPIInt n   = offset[i+1] - offset[i];
+    char *packstart = bufs[i];
+    if (UnpackOp) (*UnpackOp)(n,link->bs,loc+offset[i],data,(const void*)packstart);
+#if defined(PETSC_HAVE_MPI_REDUCE_LOCAL)
+    else if (n) { /* the op should be defined to operate on the whole datatype, so we ignore link->bs */
+      PetscInt j;
+      for (j=0; j<n; j++) {ierr = MPI_Reduce_local(packstart+j*typesize,((char*)data)+(loc[offset[i]+j])*typesize,1,unit,op);CHKERRQ(ierr);}
+    }
+#else
+    else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No unpacking reduction operation for this MPI_Op");
+#endif
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpBegin_Neighbor(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+  PetscInt         i,nrootranks;
+  const PetscInt   *rootoffset,*rootloc;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,NULL,NULL,&rootoffset,&rootloc);CHKERRQ(ierr);
+  ierr = PetscSFNeighborGetPack(sf,unit,rootdata,&link);CHKERRQ(ierr);
+
+  /* Pack all root data, including distinguished ranks which receive it via shared memory */
+  for (i=0; i<nrootranks; i++) (*link->Pack)(rootoffset[i+1]-rootoffset[i],link->bs,rootloc+rootoffset[i],rootdata,link->root[i]);
+  ierr = MPI_Ineighbor_alltoallv(PetscSFNeighborRootBuf(sf,link),dat->rootcounts,dat->rootdispls,unit,PetscSFNeighborLeafBuf(sf,link),dat->leafcounts,dat->leafdispls,unit,dat->comms[PETSC_SF_ROOT2LEAF_BCAST],&link->requests[PETSC_SF_ROOT2LEAF_BCAST]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpEnd_Neighbor(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+  PetscInt         nleafranks;
+  const PetscInt   *leafoffset,*leafloc;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetPackInUse(sf,unit,1,rootdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = MPI_Wait(&link->requests[PETSC_SF_ROOT2LEAF_BCAST],MPI_STATUS_IGNORE);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,NULL,NULL,&leafoffset,&leafloc);CHKERRQ(ierr);
+  ierr = PetscSFNeighborUnpack(sf,link,unit,nleafranks,leafoffset,leafloc,link->leaf,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastBegin_Neighbor(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastAndOpBegin_Neighbor(sf,unit,rootdata,leafdata,MPIU_REPLACE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastEnd_Neighbor(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastAndOpEnd_Neighbor(sf,unit,rootdata,leafdata,MPIU_REPLACE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceBegin_Neighbor(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+  PetscInt         i,nleafranks;
+  const PetscInt   *leafoffset,*leafloc;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,NULL,NULL,&leafoffset,&leafloc);CHKERRQ(ierr);
+  ierr = PetscSFNeighborGetPack(sf,unit,leafdata,&link);CHKERRQ(ierr);
+
+  /* Pack all leaf data, including distinguished ranks which write it directly into the root buffer */
+  for (i=0; i<nleafranks; i++) (*link->Pack)(leafoffset[i+1]-leafoffset[i],link->bs,leafloc+leafoffset[i],leafdata,link->leaf[i]);
+  ierr = MPI_Ineighbor_alltoallv(PetscSFNeighborLeafBuf(sf,link),dat->leafcounts,dat->leafdispls,unit,PetscSFNeighborRootBuf(sf,link),dat->rootcounts,dat->rootdispls,unit,dat->comms[PETSC_SF_LEAF2ROOT_REDUCE],&link->requests[PETSC_SF_LEAF2ROOT_REDUCE]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceEnd_Neighbor(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+  PetscInt         nrootranks;
+  const PetscInt   *rootoffset,*rootloc;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetPackInUse(sf,unit,1,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = MPI_Wait(&link->requests[PETSC_SF_LEAF2ROOT_REDUCE],MPI_STATUS_IGNORE);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,NULL,NULL,&rootoffset,&rootloc);CHKERRQ(ierr);
+  ierr = PetscSFNeighborUnpack(sf,link,unit,nrootranks,rootoffset,rootloc,link->root,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpBegin_Neighbor(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReduceBegin_Neighbor(sf,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpEnd_Neighbor(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscSF_Neighbor  *dat = (PetscSF_Neighbor*)sf->data;
+  void              (*FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  PetscErrorCode    ierr;
+  PetscSFBasicPack  link;
+  PetscInt          i,nrootranks,nleafranks;
+  const PetscInt    *rootoffset,*leafoffset,*rootloc,*leafloc;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetPackInUse(sf,unit,1,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = MPI_Wait(&link->requests[PETSC_SF_LEAF2ROOT_REDUCE],MPI_STATUS_IGNORE);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,NULL,NULL,&rootoffset,&rootloc);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,NULL,NULL,&leafoffset,&leafloc);CHKERRQ(ierr);
+
+  /* Process local fetch-and-op, then send the fetched values back to the leaves */
+  ierr = PetscSFBasicPackGetFetchAndOp(sf,link,op,&FetchAndOp);CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) (*FetchAndOp)(rootoffset[i+1]-rootoffset[i],link->bs,rootloc+rootoffset[i],rootdata,link->root[i]);
+  ierr = MPI_Ineighbor_alltoallv(PetscSFNeighborRootBuf(sf,link),dat->rootcounts,dat->rootdispls,unit,PetscSFNeighborLeafBuf(sf,link),dat->leafcounts,dat->leafdispls,unit,dat->comms[PETSC_SF_ROOT2LEAF_BCAST],&link->requests[PETSC_SF_ROOT2LEAF_BCAST]);CHKERRQ(ierr);
+  ierr = MPI_Wait(&link->requests[PETSC_SF_ROOT2LEAF_BCAST],MPI_STATUS_IGNORE);CHKERRQ(ierr);
+  for (i=0; i<nleafranks; i++) (*link->UnpackInsert)(leafoffset[i+1]-leafoffset[i],link->bs,leafloc+leafoffset[i],leafupdate,link->leaf[i]);
+  ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode PetscSFCreate_Neighbor(PetscSF sf)
+{
+  PetscSF_Neighbor *dat;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  sf->ops->SetUp           = PetscSFSetUp_Neighbor;
+  sf->ops->Reset           = PetscSFReset_Neighbor;
+  sf->ops->Destroy         = PetscSFDestroy_Neighbor;
+  sf->ops->View            = PetscSFView_Basic;
+  sf->ops->BcastBegin      = PetscSFBcastBegin_Neighbor;
+  sf->ops->BcastEnd        = PetscSFBcastEnd_Neighbor;
+  sf->ops->BcastAndOpBegin = PetscSFBcastAndOpBegin_Neighbor;
+  sf->ops->BcastAndOpEnd   = PetscSFBcastAndOpEnd_Neighbor;
+  sf->ops->ReduceBegin     = PetscSFReduceBegin_Neighbor;
+  sf->ops->ReduceEnd       = PetscSFReduceEnd_Neighbor;
+  sf->ops->FetchAndOpBegin = PetscSFFetchAndOpBegin_Neighbor;
+  sf->ops->FetchAndOpEnd   = PetscSFFetchAndOpEnd_Neighbor;
+  sf->ops->GetLeafRanks    = PetscSFGetLeafRanks_Basic;
+
+  ierr = PetscNewLog(sf,&dat);CHKERRQ(ierr);
+  dat->comms[0] = MPI_COMM_NULL;
+  dat->comms[1] = MPI_COMM_NULL;
+  sf->data      = (void*)dat;
+  PetscFunctionReturn(0);
+}
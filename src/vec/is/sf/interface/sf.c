@@ -107,7 +107,8 @@ PetscErrorCode PetscSFReset(PetscSF sf)
    Notes:
    See "include/petscsf.h" for available methods (for instance)
 +    PETSCSFWINDOW - MPI-2/3 one-sided
--    PETSCSFBASIC - basic implementation using MPI-1 two-sided
+.    PETSCSFBASIC - basic implementation using MPI-1 two-sided
+-    PETSCSFNEIGHBOR - MPI-3 neighborhood collectives
 
   Level: intermediate
 
@@ -226,7 +227,12 @@ PetscErrorCode PetscSFSetUp(PetscSF sf)
 
    Options Database Keys:
 +  -sf_type - implementation type, see PetscSFSetType()
--  -sf_rank_order - sort composite points for gathers and scatters in rank order, gathers are non-deterministic otherwise
+.  -sf_rank_order - sort composite points for gathers and scatters in rank order, gathers are non-deterministic otherwise
+.  -sf_basic_shared_memory - with the basic type, exchange data with processes on the same node through MPI-3 shared memory
+.  -sf_basic_shared_memory_slots - number of operations that may use the shared memory at the same time (default 4), later
+                                   ones send messages as to other nodes until the slots are read
+-  -sf_basic_shared_memory_unit_bytes - largest unit, times the number of arrays of an operation, communicated through the
+                                        shared memory (default sizeof(PetscScalar)); larger ones send messages
 
    Level: intermediate
 
@@ -1260,6 +1266,168 @@ PetscErrorCode PetscSFReduceEnd(PetscSF sf,MPI_Datatype unit,const void *leafdat
   PetscFunctionReturn(0);
 }
 
+/*@C
+   PetscSFBcastAndOpBeginMultiple - begin pointwise broadcast with reduction of several root arrays that share the
+   same communication graph, to be concluded with call to PetscSFBcastAndOpEndMultiple()
+
+   Collective on PetscSF
+
+   Input Arguments:
++  sf - star forest on which to communicate
+.  unit - data type associated with each node
+.  n - number of arrays
+.  rootdata - array of n buffers to broadcast
+-  op - operation to use for reduction
+
+   Output Arguments:
+.  leafdata - array of n buffers to be reduced with values from each leaf's respective root
+
+   Notes:
+   This is equivalent to calling PetscSFBcastAndOpBegin() on each pair rootdata[i], leafdata[i], but implementations
+   such as PETSCSFBASIC pack the data of all arrays into a single message per neighbor rank.
+   The buffers in rootdata[] must be distinct, and must not be modified until PetscSFBcastAndOpEndMultiple() is called.
+
+   Level: advanced
+
+.seealso: PetscSFBcastAndOpEndMultiple(), PetscSFBcastAndOpBegin(), PetscSFReduceBeginMultiple()
+@*/
+PetscErrorCode PetscSFBcastAndOpBeginMultiple(PetscSF sf,MPI_Datatype unit,PetscInt n,const void *const rootdata[],void *const leafdata[],MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  if (n < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of arrays %D cannot be negative",n);
+  if (!n) PetscFunctionReturn(0);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(PETSCSF_BcastAndOpBegin,sf,0,0,0);CHKERRQ(ierr);
+  if (sf->ops->BcastAndOpBeginMultiple) {ierr = (*sf->ops->BcastAndOpBeginMultiple)(sf,unit,n,rootdata,leafdata,op);CHKERRQ(ierr);}
+  else {
+    for (i=0; i<n; i++) {ierr = (*sf->ops->BcastAndOpBegin)(sf,unit,rootdata[i],leafdata[i],op);CHKERRQ(ierr);}
+  }
+  ierr = PetscLogEventEnd(PETSCSF_BcastAndOpBegin,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFBcastAndOpEndMultiple - end a broadcast & reduce operation started with PetscSFBcastAndOpBeginMultiple()
+
+   Collective
+
+   Input Arguments:
++  sf - star forest
+.  unit - data type
+.  n - number of arrays
+.  rootdata - array of n buffers to broadcast
+-  op - operation to use for reduction
+
+   Output Arguments:
+.  leafdata - array of n buffers to be reduced with values from each leaf's respective root
+
+   Level: advanced
+
+.seealso: PetscSFBcastAndOpBeginMultiple(), PetscSFBcastAndOpEnd()
+@*/
+PetscErrorCode PetscSFBcastAndOpEndMultiple(PetscSF sf,MPI_Datatype unit,PetscInt n,const void *const rootdata[],void *const leafdata[],MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  if (!n) PetscFunctionReturn(0);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(PETSCSF_BcastAndOpEnd,sf,0,0,0);CHKERRQ(ierr);
+  if (sf->ops->BcastAndOpEndMultiple) {ierr = (*sf->ops->BcastAndOpEndMultiple)(sf,unit,n,rootdata,leafdata,op);CHKERRQ(ierr);}
+  else {
+    for (i=0; i<n; i++) {ierr = (*sf->ops->BcastAndOpEnd)(sf,unit,rootdata[i],leafdata[i],op);CHKERRQ(ierr);}
+  }
+  ierr = PetscLogEventEnd(PETSCSF_BcastAndOpEnd,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFReduceBeginMultiple - begin reduction of several leaf arrays that share the same communication graph,
+   to be completed with call to PetscSFReduceEndMultiple()
+
+   Collective
+
+   Input Arguments:
++  sf - star forest
+.  unit - data type
+.  n - number of arrays
+.  leafdata - array of n buffers of values to reduce
+-  op - reduction operation
+
+   Output Arguments:
+.  rootdata - array of n buffers holding the result of reduction of values from all leaves of each root
+
+   Notes:
+   This is equivalent to calling PetscSFReduceBegin() on each pair leafdata[i], rootdata[i], but implementations
+   such as PETSCSFBASIC pack the data of all arrays into a single message per neighbor rank.
+   The buffers in leafdata[] must be distinct, and must not be modified until PetscSFReduceEndMultiple() is called.
+
+   Level: advanced
+
+.seealso: PetscSFReduceEndMultiple(), PetscSFReduceBegin(), PetscSFBcastAndOpBeginMultiple()
+@*/
+PetscErrorCode PetscSFReduceBeginMultiple(PetscSF sf,MPI_Datatype unit,PetscInt n,const void *const leafdata[],void *const rootdata[],MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  if (n < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of arrays %D cannot be negative",n);
+  if (!n) PetscFunctionReturn(0);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(PETSCSF_ReduceBegin,sf,0,0,0);CHKERRQ(ierr);
+  if (sf->ops->ReduceBeginMultiple) {ierr = (*sf->ops->ReduceBeginMultiple)(sf,unit,n,leafdata,rootdata,op);CHKERRQ(ierr);}
+  else {
+    for (i=0; i<n; i++) {ierr = (*sf->ops->ReduceBegin)(sf,unit,leafdata[i],rootdata[i],op);CHKERRQ(ierr);}
+  }
+  ierr = PetscLogEventEnd(PETSCSF_ReduceBegin,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFReduceEndMultiple - end a reduction operation started with PetscSFReduceBeginMultiple()
+
+   Collective
+
+   Input Arguments:
++  sf - star forest
+.  unit - data type
+.  n - number of arrays
+.  leafdata - array of n buffers of values to reduce
+-  op - reduction operation
+
+   Output Arguments:
+.  rootdata - array of n buffers holding the result of reduction of values from all leaves of each root
+
+   Level: advanced
+
+.seealso: PetscSFReduceBeginMultiple(), PetscSFReduceEnd()
+@*/
+PetscErrorCode PetscSFReduceEndMultiple(PetscSF sf,MPI_Datatype unit,PetscInt n,const void *const leafdata[],void *const rootdata[],MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  if (!n) PetscFunctionReturn(0);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(PETSCSF_ReduceEnd,sf,0,0,0);CHKERRQ(ierr);
+  if (sf->ops->ReduceEndMultiple) {ierr = (*sf->ops->ReduceEndMultiple)(sf,unit,n,leafdata,rootdata,op);CHKERRQ(ierr);}
+  else {
+    for (i=0; i<n; i++) {ierr = (*sf->ops->ReduceEnd)(sf,unit,leafdata[i],rootdata[i],op);CHKERRQ(ierr);}
+  }
+  ierr = PetscLogEventEnd(PETSCSF_ReduceEnd,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
    PetscSFComputeDegreeBegin - begin computation of degree for each root vertex, to be completed with PetscSFComputeDegreeEnd()
 
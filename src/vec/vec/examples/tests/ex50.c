@@ -0,0 +1,81 @@
+static char help[] = "Tests VecMDot(), VecMTDot() and VecMAXPY() with vectors from VecDuplicateVecsContiguous().\n\n";
+
+#include <petscvec.h>
+
+/* the largest difference between the m numbers in a and b */
+static PetscReal MaxDiff(PetscInt m,const PetscScalar *a,const PetscScalar *b)
+{
+  PetscInt  i;
+  PetscReal d = 0.0;
+
+  for (i=0; i<m; i++) d = PetscMax(d,PetscAbsScalar(a[i]-b[i]));
+  return d;
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  Vec            x,*V,*W,y[6],z[6];
+  PetscInt       i,n = 37,m = 6;
+  PetscScalar    alpha[6],v[6],w[6],vs[6],ws[6];
+  PetscReal      err,nrm;
+  PetscRandom    rand;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = VecCreate(PETSC_COMM_WORLD,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,n,PETSC_DECIDE);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+
+  /* V[m] plays x, the V[i] and their copies W[i] in separate vectors play y */
+  ierr = VecDuplicateVecsContiguous(x,m+1,&V);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(x,m+1,&W);CHKERRQ(ierr);
+  for (i=0; i<=m; i++) {
+    ierr     = VecSetRandom(V[i],rand);CHKERRQ(ierr);
+    ierr     = VecCopy(V[i],W[i]);CHKERRQ(ierr);
+    alpha[i] = i+1.0;
+  }
+  ierr = VecNorm(V[m],NORM_2,&nrm);CHKERRQ(ierr);
+
+  /* one run of m columns, and runs broken up by separate vectors */
+  for (i=0; i<m; i++) {y[i] = V[i]; z[i] = W[i];}
+  for (i=0; i<2; i++) {
+    if (i) {y[2] = W[2]; y[3] = W[3];}
+    ierr = VecMDot(V[m],m,y,v);CHKERRQ(ierr);
+    ierr = VecMDot(W[m],m,z,w);CHKERRQ(ierr);
+    err  = MaxDiff(m,v,w);
+    ierr = VecMTDot(V[m],m,y,v);CHKERRQ(ierr);
+    ierr = VecMTDot(W[m],m,z,w);CHKERRQ(ierr);
+    err  = PetscMax(err,MaxDiff(m,v,w));
+    ierr = VecMDotBegin(V[m],m,y,vs);CHKERRQ(ierr);
+    ierr = VecMDotBegin(W[m],m,z,ws);CHKERRQ(ierr);
+    ierr = VecMDotEnd(V[m],m,y,vs);CHKERRQ(ierr);
+    ierr = VecMDotEnd(W[m],m,z,ws);CHKERRQ(ierr);
+    err  = PetscMax(err,MaxDiff(m,vs,ws));
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"VecMDot() and VecMTDot() with %s: %s\n",i ? "broken runs" : "one run",err < 100*PETSC_MACHINE_EPSILON*nrm*nrm ? "agree" : "differ");CHKERRQ(ierr);
+
+    ierr = VecMAXPY(V[m],m,alpha,y);CHKERRQ(ierr);
+    ierr = VecMAXPY(W[m],m,alpha,z);CHKERRQ(ierr);
+    ierr = VecAXPY(W[m],-1.0,V[m]);CHKERRQ(ierr);
+    ierr = VecNorm(W[m],NORM_INFINITY,&err);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"VecMAXPY() with %s: %s\n",i ? "broken runs" : "one run",err < 1000*PETSC_MACHINE_EPSILON*nrm ? "agree" : "differ");CHKERRQ(ierr);
+    ierr = VecCopy(V[m],W[m]);CHKERRQ(ierr);
+  }
+
+  ierr = VecDestroyVecs(m+1,&V);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(m+1,&W);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      nsize: {{1 3}}
+      output_file: output/ex50_1.out
+
+TEST*/
@@ -203,5 +203,11 @@ int main(int argc,char **args)
        nsize: 4
        args: -hdf5 -sizes_set
 
+     test:
+       suffix: 7
+       nsize: 3
+       args: -binary -viewer_binary_mmap
+       output_file: output/ex10_2.out
+
 
 TEST*/
@@ -86,6 +86,48 @@ static PetscErrorCode VecDuplicate_MPI(Vec win,Vec *v)
   PetscFunctionReturn(0);
 }
 
+/*
+   The m vectors are the columns of one array with leading dimension n, the array is owned by the first vector so the
+   vectors must be destroyed together with VecDestroyVecs(). Vectors with ghost points are duplicated separately.
+*/
+PetscErrorCode VecDuplicateVecsContiguous_MPI(Vec win,PetscInt m,Vec *V[])
+{
+  PetscErrorCode ierr;
+  Vec_MPI        *w = (Vec_MPI*)win->data;
+  PetscInt       i,n = win->map->n;
+  PetscScalar    *array;
+  Vec            v;
+
+  PetscFunctionBegin;
+  if (w->nghost || w->localrep) {
+    ierr = VecDuplicateVecs(win,m,V);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscMalloc1(m,V);CHKERRQ(ierr);
+  ierr = PetscCalloc1((size_t)m*n,&array);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    ierr = VecCreate(PetscObjectComm((PetscObject)win),&v);CHKERRQ(ierr);
+    ierr = PetscLayoutReference(win->map,&v->map);CHKERRQ(ierr);
+    ierr = VecCreate_MPI_Private(v,PETSC_FALSE,0,array+(size_t)i*n);CHKERRQ(ierr);
+    ierr = PetscMemcpy(v->ops,win->ops,sizeof(struct _VecOps));CHKERRQ(ierr);
+    if (v->ops->mdot == VecMDot_MPI)         v->ops->mdot        = VecMDot_MPI_GEMV;
+    if (v->ops->mtdot == VecMTDot_MPI)       v->ops->mtdot       = VecMTDot_MPI_GEMV;
+    if (v->ops->mdot_local == VecMDot_Seq)   v->ops->mdot_local  = VecMDot_Seq_GEMV;
+    if (v->ops->mtdot_local == VecMTDot_Seq) v->ops->mtdot_local = VecMTDot_Seq_GEMV;
+    if (v->ops->maxpy == VecMAXPY_Seq)       v->ops->maxpy       = VecMAXPY_Seq_GEMV;
+
+    v->stash.donotstash   = win->stash.donotstash;
+    v->stash.ignorenegidx = win->stash.ignorenegidx;
+    v->bstash.bs          = win->bstash.bs;
+    ierr = PetscObjectListDuplicate(((PetscObject)win)->olist,&((PetscObject)v)->olist);CHKERRQ(ierr);
+    ierr = PetscFunctionListDuplicate(((PetscObject)win)->qlist,&((PetscObject)v)->qlist);CHKERRQ(ierr);
+    (*V)[i] = v;
+  }
+  ((Vec_MPI*)(*V)[0]->data)->array_allocated = array;
+  ierr = PetscLogObjectMemory((PetscObject)(*V)[0],m*n*sizeof(PetscScalar));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 
 static PetscErrorCode VecSetOption_MPI(Vec V,VecOption op,PetscBool flag)
 {
@@ -514,7 +556,15 @@ PetscErrorCode VecCreate_MPI_Private(Vec v,PetscBool alloc,PetscInt nghost,const
     PetscInt n = v->map->n+nghost;
     ierr               = PetscMalloc1(n,&s->array);CHKERRQ(ierr);
     ierr               = PetscLogObjectMemory((PetscObject)v,n*sizeof(PetscScalar));CHKERRQ(ierr);
-    ierr               = PetscMemzero(s->array,n*sizeof(PetscScalar));CHKERRQ(ierr);
+    if (PetscOMPUseThreads(n)) {
+      PetscInt i;
+
+      /* first touch with the partition of the threaded kernels, so the pages are placed near the threads using them */
+      PetscPragmaOMP(parallel for schedule(static))
+      for (i=0; i<n; i++) s->array[i] = 0.0;
+    } else {
+      ierr = PetscMemzero(s->array,n*sizeof(PetscScalar));CHKERRQ(ierr);
+    }
     s->array_allocated = s->array;
   }
 
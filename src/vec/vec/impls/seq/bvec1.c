@@ -17,8 +17,17 @@ PetscErrorCode VecDot_Seq(Vec xin,Vec yin,PetscScalar *z)
   ierr = PetscBLASIntCast(xin->map->n,&bn);CHKERRQ(ierr);
   ierr = VecGetArrayRead(xin,&xa);CHKERRQ(ierr);
   ierr = VecGetArrayRead(yin,&ya);CHKERRQ(ierr);
-  /* arguments ya, xa are reversed because BLAS complex conjugates the first argument, PETSc the second */
-  PetscStackCallBLAS("BLASdot",*z   = BLASdot_(&bn,ya,&one,xa,&one));
+  if (PetscOMPUseThreads(xin->map->n)) {
+    PetscInt    i,n = xin->map->n;
+    PetscScalar sum = 0.0;
+
+    PetscPragmaOMP(parallel for schedule(static) reduction(+:sum))
+    for (i=0; i<n; i++) sum += xa[i]*PetscConj(ya[i]);
+    *z = sum;
+  } else {
+    /* arguments ya, xa are reversed because BLAS complex conjugates the first argument, PETSc the second */
+    PetscStackCallBLAS("BLASdot",*z   = BLASdot_(&bn,ya,&one,xa,&one));
+  }
   ierr = VecRestoreArrayRead(xin,&xa);CHKERRQ(ierr);
   ierr = VecRestoreArrayRead(yin,&ya);CHKERRQ(ierr);
   if (xin->map->n > 0) {
@@ -78,7 +87,14 @@ PetscErrorCode VecAXPY_Seq(Vec yin,PetscScalar alpha,Vec xin)
   if (alpha != (PetscScalar)0.0) {
     ierr = VecGetArrayRead(xin,&xarray);CHKERRQ(ierr);
     ierr = VecGetArray(yin,&yarray);CHKERRQ(ierr);
-    PetscStackCallBLAS("BLASaxpy",BLASaxpy_(&bn,&alpha,xarray,&one,yarray,&one));
+    if (PetscOMPUseThreads(yin->map->n)) {
+      PetscInt i,n = yin->map->n;
+
+      PetscPragmaOMP(parallel for schedule(static))
+      for (i=0; i<n; i++) yarray[i] += alpha*xarray[i];
+    } else {
+      PetscStackCallBLAS("BLASaxpy",BLASaxpy_(&bn,&alpha,xarray,&one,yarray,&one));
+    }
     ierr = VecRestoreArrayRead(xin,&xarray);CHKERRQ(ierr);
     ierr = VecRestoreArray(yin,&yarray);CHKERRQ(ierr);
     ierr = PetscLogFlops(2.0*yin->map->n);CHKERRQ(ierr);
@@ -222,12 +222,21 @@ PetscErrorCode VecNorm_Seq(Vec xin,NormType type,PetscReal *z)
   ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
   if (type == NORM_2 || type == NORM_FROBENIUS) {
     ierr = VecGetArrayRead(xin,&xx);CHKERRQ(ierr);
+    if (PetscOMPUseThreads(n)) {
+      PetscInt  i;
+      PetscReal sum = 0.0;
+
+      PetscPragmaOMP(parallel for schedule(static) reduction(+:sum))
+      for (i=0; i<n; i++) sum += PetscRealPart(xx[i]*PetscConj(xx[i]));
+      *z = PetscSqrtReal(sum);
+    } else {
 #if defined(PETSC_USE_REAL___FP16)
-    *z   = BLASnrm2_(&bn,xx,&one);
+      *z = BLASnrm2_(&bn,xx,&one);
 #else
-    *z   = PetscRealPart(BLASdot_(&bn,xx,&one,xx,&one));
-    *z   = PetscSqrtReal(*z);
+      *z = PetscRealPart(BLASdot_(&bn,xx,&one,xx,&one));
+      *z = PetscSqrtReal(*z);
 #endif
+    }
     ierr = VecRestoreArrayRead(xin,&xx);CHKERRQ(ierr);
     ierr = PetscLogFlops(PetscMax(2.0*n-1,0.0));CHKERRQ(ierr);
   } else if (type == NORM_INFINITY) {
@@ -235,29 +244,52 @@ PetscErrorCode VecNorm_Seq(Vec xin,NormType type,PetscReal *z)
     PetscReal max = 0.0,tmp;
 
     ierr = VecGetArrayRead(xin,&xx);CHKERRQ(ierr);
-    for (i=0; i<n; i++) {
-      if ((tmp = PetscAbsScalar(*xx)) > max) max = tmp;
-      /* check special case of tmp == NaN */
-      if (tmp != tmp) {max = tmp; break;}
-      xx++;
+    if (PetscOMPUseThreads(n)) {
+      PetscInt nnan = 0;
+
+      PetscPragmaOMP(parallel for schedule(static) reduction(max:max) reduction(+:nnan))
+      for (i=0; i<n; i++) {
+        PetscReal t = PetscAbsScalar(xx[i]);
+        if (t > max) max = t;
+        if (t != t) nnan++;
+      }
+      /* the max reduction may drop NaN, return it as the sequential loop does */
+      if (nnan) {
+        for (i=0; i<n; i++) {
+          tmp = PetscAbsScalar(xx[i]);
+          if (tmp != tmp) {max = tmp; break;}
+        }
+      }
+    } else {
+      for (i=0; i<n; i++) {
+        if ((tmp = PetscAbsScalar(*xx)) > max) max = tmp;
+        /* check special case of tmp == NaN */
+        if (tmp != tmp) {max = tmp; break;}
+        xx++;
+      }
     }
     ierr = VecRestoreArrayRead(xin,&xx);CHKERRQ(ierr);
     *z   = max;
   } else if (type == NORM_1) {
-#if defined(PETSC_USE_COMPLEX)
     PetscReal tmp = 0.0;
-    PetscInt    i;
-#endif
+    PetscInt  i;
+
     ierr = VecGetArrayRead(xin,&xx);CHKERRQ(ierr);
+    if (PetscOMPUseThreads(n)) {
+      PetscPragmaOMP(parallel for schedule(static) reduction(+:tmp))
+      for (i=0; i<n; i++) tmp += PetscAbsScalar(xx[i]);
+      *z = tmp;
+    } else {
 #if defined(PETSC_USE_COMPLEX)
-    /* BLASasum() returns the nonstandard 1 norm of the 1 norm of the complex entries so we provide a custom loop instead */
-    for (i=0; i<n; i++) {
-      tmp += PetscAbsScalar(xx[i]);
-    }
-    *z = tmp;
+      /* BLASasum() returns the nonstandard 1 norm of the 1 norm of the complex entries so we provide a custom loop instead */
+      for (i=0; i<n; i++) {
+        tmp += PetscAbsScalar(xx[i]);
+      }
+      *z = tmp;
 #else
-    PetscStackCallBLAS("BLASasum",*z   = BLASasum_(&bn,xx,&one));
+      PetscStackCallBLAS("BLASasum",*z   = BLASasum_(&bn,xx,&one));
 #endif
+    }
     ierr = VecRestoreArrayRead(xin,&xx);CHKERRQ(ierr);
     ierr = PetscLogFlops(PetscMax(n-1.0,0.0));CHKERRQ(ierr);
   } else if (type == NORM_1_AND_2) {
@@ -822,6 +854,41 @@ PetscErrorCode VecDuplicate_Seq(Vec win,Vec *V)
   PetscFunctionReturn(0);
 }
 
+/*
+   The m vectors are the columns of one array with leading dimension n, the array is owned by the first vector so the
+   vectors must be destroyed together with VecDestroyVecs()
+*/
+PetscErrorCode VecDuplicateVecsContiguous_Seq(Vec win,PetscInt m,Vec *V[])
+{
+  PetscErrorCode ierr;
+  PetscInt       i,n = win->map->n;
+  PetscScalar    *array;
+  Vec            v;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(m,V);CHKERRQ(ierr);
+  ierr = PetscCalloc1((size_t)m*n,&array);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    ierr = VecCreate(PetscObjectComm((PetscObject)win),&v);CHKERRQ(ierr);
+    ierr = PetscLayoutReference(win->map,&v->map);CHKERRQ(ierr);
+    ierr = VecCreate_Seq_Private(v,array+(size_t)i*n);CHKERRQ(ierr);
+    ierr = PetscObjectListDuplicate(((PetscObject)win)->olist,&((PetscObject)v)->olist);CHKERRQ(ierr);
+    ierr = PetscFunctionListDuplicate(((PetscObject)win)->qlist,&((PetscObject)v)->qlist);CHKERRQ(ierr);
+
+    v->ops->view          = win->ops->view;
+    v->ops->mdot          = VecMDot_Seq_GEMV;
+    v->ops->mtdot         = VecMTDot_Seq_GEMV;
+    v->ops->mdot_local    = VecMDot_Seq_GEMV;
+    v->ops->mtdot_local   = VecMTDot_Seq_GEMV;
+    v->ops->maxpy         = VecMAXPY_Seq_GEMV;
+    v->stash.ignorenegidx = win->stash.ignorenegidx;
+    (*V)[i]               = v;
+  }
+  ((Vec_Seq*)(*V)[0]->data)->array_allocated = array;
+  ierr = PetscLogObjectMemory((PetscObject)(*V)[0],m*n*sizeof(PetscScalar));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static struct _VecOps DvOps = {VecDuplicate_Seq, /* 1 */
                                VecDuplicateVecs_Default,
                                VecDestroyVecs_Default,
@@ -39,7 +39,15 @@ PETSC_EXTERN PetscErrorCode VecCreate_Seq(Vec V)
   s                  = (Vec_Seq*)V->data;
   s->array_allocated = array;
 
-  ierr = VecSet(V,0.0);CHKERRQ(ierr);
+  if (PetscOMPUseThreads(n)) {
+    PetscInt i;
+
+    /* first touch with the partition of the threaded kernels, so the pages are placed near the threads using them */
+    PetscPragmaOMP(parallel for schedule(static))
+    for (i=0; i<n; i++) array[i] = 0.0;
+  } else {
+    ierr = PetscMemzero(array,n*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
 #else
   switch (((PetscObject)V)->precision) {
   case PETSC_PRECISION_SINGLE: {
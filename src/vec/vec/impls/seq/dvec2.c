@@ -5,8 +5,48 @@
 */
 #include <../src/vec/vec/impls/dvecimpl.h>
 #include <petsc/private/kernels/petscaxpy.h>
+#include <petscblaslapack.h>
 
+/*
+   Threaded VecMDot_Seq(), used when PetscOMPUseThreads() says so; like the sequential kernels it handles four
+   vectors per pass over x, a missing vector at the end is replaced by the last one and its result discarded
+*/
+static PetscErrorCode VecMDot_Seq_Threaded(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = xin->map->n,i,k,nk;
+  const PetscScalar *x,*yy[4];
 
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xin,&x);CHKERRQ(ierr);
+  for (k=0; k<nv; k+=4) {
+    PetscScalar sum0 = 0.0,sum1 = 0.0,sum2 = 0.0,sum3 = 0.0;
+    const PetscScalar *yy0,*yy1,*yy2,*yy3;
+
+    nk = PetscMin(nv-k,4);
+    for (i=0; i<nk; i++) {ierr = VecGetArrayRead(yin[k+i],&yy[i]);CHKERRQ(ierr);}
+    for (i=nk; i<4; i++) yy[i] = yy[nk-1];
+    yy0 = yy[0]; yy1 = yy[1]; yy2 = yy[2]; yy3 = yy[3];
+    PetscPragmaOMP(parallel for schedule(static) reduction(+:sum0,sum1,sum2,sum3))
+    for (i=0; i<n; i++) {
+      PetscScalar xi = x[i];
+      sum0 += xi*PetscConj(yy0[i]);
+      sum1 += xi*PetscConj(yy1[i]);
+      sum2 += xi*PetscConj(yy2[i]);
+      sum3 += xi*PetscConj(yy3[i]);
+    }
+    switch (nk) {
+    case 4: z[k+3] = sum3;
+    case 3: z[k+2] = sum2;
+    case 2: z[k+1] = sum1;
+    case 1: z[k]   = sum0;
+    }
+    for (i=0; i<nk; i++) {ierr = VecRestoreArrayRead(yin[k+i],&yy[i]);CHKERRQ(ierr);}
+  }
+  ierr = VecRestoreArrayRead(xin,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(PetscMax(nv*(2.0*xin->map->n-1),0.0));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
 #if defined(PETSC_USE_FORTRAN_KERNEL_MDOT)
 #include <../src/vec/vec/impls/seq/ftn-kernels/fmdot.h>
@@ -19,6 +59,10 @@ PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
   Vec               *yy;
 
   PetscFunctionBegin;
+  if (PetscOMPUseThreads(n)) {
+    ierr = VecMDot_Seq_Threaded(xin,nv,yin,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   sum0 = 0.0;
   sum1 = 0.0;
   sum2 = 0.0;
@@ -100,6 +144,10 @@ PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
   Vec               *yy;
 
   PetscFunctionBegin;
+  if (PetscOMPUseThreads(n)) {
+    ierr = VecMDot_Seq_Threaded(xin,nv,yin,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   sum0 = 0.;
   sum1 = 0.;
   sum2 = 0.;
@@ -544,7 +592,11 @@ PetscErrorCode VecSet_Seq(Vec xin,PetscScalar alpha)
 
   PetscFunctionBegin;
   ierr = VecGetArray(xin,&xx);CHKERRQ(ierr);
-  if (alpha == (PetscScalar)0.0) {
+  if (PetscOMPUseThreads(n)) {
+    /* also the first touch of a new vector, so its pages are placed near the threads that use them later */
+    PetscPragmaOMP(parallel for schedule(static))
+    for (i=0; i<n; i++) xx[i] = alpha;
+  } else if (alpha == (PetscScalar)0.0) {
     ierr = PetscMemzero(xx,n*sizeof(PetscScalar));CHKERRQ(ierr);
   } else {
     for (i=0; i<n; i++) xx[i] = alpha;
@@ -623,6 +675,111 @@ PetscErrorCode VecMAXPY_Seq(Vec xin, PetscInt nv,const PetscScalar *alpha,Vec *y
   PetscFunctionReturn(0);
 }
 
+/*
+   Kernels of the vectors created with VecDuplicateVecsContiguous(). Each run of at least two y[] vectors that are
+   consecutive columns of one array with leading dimension n is handled with one BLAS gemv, so x is streamed once per
+   run instead of once per four vectors; the remaining vectors are passed to the usual kernels.
+*/
+static PetscErrorCode VecContiguousRunLength_Private(PetscInt n,PetscInt nv,const Vec y[],PetscInt *r)
+{
+  PetscErrorCode    ierr;
+  PetscInt          j;
+  const PetscScalar *a,*y0,*yj;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(y[0],&a);CHKERRQ(ierr);
+  y0   = a;
+  ierr = VecRestoreArrayRead(y[0],&a);CHKERRQ(ierr);
+  for (j=1; j<nv; j++) {
+    ierr = VecGetArrayRead(y[j],&a);CHKERRQ(ierr);
+    yj   = a;
+    ierr = VecRestoreArrayRead(y[j],&a);CHKERRQ(ierr);
+    if (yj != y0+j*n) break;
+  }
+  *r = j;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode VecMultiDot_Seq_GEMV(const char *trans,Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z,PetscErrorCode (*mdot)(Vec,PetscInt,const Vec[],PetscScalar*))
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = xin->map->n,i,r,s;
+  const PetscScalar *x,*y0;
+  PetscScalar       one = 1.0,zero = 0.0;
+  PetscBLASInt      bn,br,ione = 1;
+
+  PetscFunctionBegin;
+  if (!n || nv < 2) {
+    ierr = (*mdot)(xin,nv,yin,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  for (i=0,s=0; i<nv; i+=r) {
+    ierr = VecContiguousRunLength_Private(n,nv-i,yin+i,&r);CHKERRQ(ierr);
+    if (r == 1) continue;
+    if (s < i) {ierr = (*mdot)(xin,i-s,yin+s,z+s);CHKERRQ(ierr);}
+    ierr = PetscBLASIntCast(r,&br);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(xin,&x);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(yin[i],&y0);CHKERRQ(ierr);
+    PetscStackCallBLAS("BLASgemv",BLASgemv_(trans,&bn,&br,&one,y0,&bn,x,&ione,&zero,z+i,&ione));
+    ierr = VecRestoreArrayRead(yin[i],&y0);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(xin,&x);CHKERRQ(ierr);
+    ierr = PetscLogFlops(r*(2.0*n-1));CHKERRQ(ierr);
+    s    = i+r;
+  }
+  if (s < nv) {ierr = (*mdot)(xin,nv-s,yin+s,z+s);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode VecMDot_Seq_GEMV(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecMultiDot_Seq_GEMV("C",xin,nv,yin,z,VecMDot_Seq);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode VecMTDot_Seq_GEMV(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecMultiDot_Seq_GEMV("T",xin,nv,yin,z,VecMTDot_Seq);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode VecMAXPY_Seq_GEMV(Vec xin,PetscInt nv,const PetscScalar *alpha,Vec *y)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = xin->map->n,i,r,s;
+  const PetscScalar *y0;
+  PetscScalar       *xx,one = 1.0;
+  PetscBLASInt      bn,br,ione = 1;
+
+  PetscFunctionBegin;
+  if (!n || nv < 2) {
+    ierr = VecMAXPY_Seq(xin,nv,alpha,y);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  for (i=0,s=0; i<nv; i+=r) {
+    ierr = VecContiguousRunLength_Private(n,nv-i,(const Vec*)y+i,&r);CHKERRQ(ierr);
+    if (r == 1) continue;
+    if (s < i) {ierr = VecMAXPY_Seq(xin,i-s,alpha+s,y+s);CHKERRQ(ierr);}
+    ierr = PetscBLASIntCast(r,&br);CHKERRQ(ierr);
+    ierr = VecGetArray(xin,&xx);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(y[i],&y0);CHKERRQ(ierr);
+    PetscStackCallBLAS("BLASgemv",BLASgemv_("N",&bn,&br,&one,y0,&bn,alpha+i,&ione,&one,xx,&ione));
+    ierr = VecRestoreArrayRead(y[i],&y0);CHKERRQ(ierr);
+    ierr = VecRestoreArray(xin,&xx);CHKERRQ(ierr);
+    ierr = PetscLogFlops(r*2.0*n);CHKERRQ(ierr);
+    s    = i+r;
+  }
+  if (s < nv) {ierr = VecMAXPY_Seq(xin,nv-s,alpha+s,y+s);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
 #include <../src/vec/vec/impls/seq/ftn-kernels/faypx.h>
 
 PetscErrorCode VecAYPX_Seq(Vec yin,PetscScalar alpha,Vec xin)
@@ -58,6 +58,35 @@ static PetscErrorCode VecLoad_Binary_MPIIO(Vec vec, PetscViewer viewer)
 }
 #endif
 
+#if defined(PETSC_HAVE_MMAP)
+static PetscErrorCode VecLoad_Binary_MMap(Vec vec, PetscViewer viewer)
+{
+  PetscErrorCode ierr;
+  PetscScalar    *avec;
+  int            fd;
+  off_t          off;
+  void           *data,*map;
+  size_t         maplen;
+
+  PetscFunctionBegin;
+  ierr = PetscViewerBinaryGetDescriptor(viewer,&fd);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryGetMMapOffset(viewer,&off);CHKERRQ(ierr);
+  off += vec->map->rstart*sizeof(PetscScalar);
+  /* the mapping is only read, so its pages stay shared with the file cache */
+  ierr = PetscBinaryMap(fd,off,vec->map->n,PETSC_SCALAR,PETSC_FALSE,&data,&map,&maplen);CHKERRQ(ierr);
+  ierr = VecGetArray(vec,&avec);CHKERRQ(ierr);
+  ierr = PetscMemcpy(avec,data,vec->map->n*sizeof(PetscScalar));CHKERRQ(ierr);
+  if (!PetscBinaryBigEndian()) {ierr = PetscByteSwap(avec,PETSC_SCALAR,vec->map->n);CHKERRQ(ierr);}
+  ierr = VecRestoreArray(vec,&avec);CHKERRQ(ierr);
+  ierr = PetscBinaryUnmap(map,maplen);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryAddMMapOffset(viewer,vec->map->N*sizeof(PetscScalar));CHKERRQ(ierr);
+
+  ierr = VecAssemblyBegin(vec);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(vec);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
+
 PetscErrorCode VecLoad_Binary(Vec vec, PetscViewer viewer)
 {
   PetscMPIInt    size,rank,tag;
@@ -72,6 +101,9 @@ PetscErrorCode VecLoad_Binary(Vec vec, PetscViewer viewer)
 #if defined(PETSC_HAVE_MPIIO)
   PetscBool      useMPIIO;
 #endif
+#if defined(PETSC_HAVE_MMAP)
+  PetscBool      useMMap;
+#endif
 
   PetscFunctionBegin;
   /* force binary viewer to load .info file if it has not yet done so */
@@ -112,6 +144,13 @@ PetscErrorCode VecLoad_Binary(Vec vec, PetscViewer viewer)
     PetscFunctionReturn(0);
   }
 #endif
+#if defined(PETSC_HAVE_MMAP)
+  ierr = PetscViewerBinaryGetUseMMap(viewer,&useMMap);CHKERRQ(ierr);
+  if (useMMap) {
+    ierr = VecLoad_Binary_MMap(vec, viewer);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#endif
 
   ierr = VecGetLocalSize(vec,&n);CHKERRQ(ierr);
   ierr = PetscObjectGetNewTag((PetscObject)viewer,&tag);CHKERRQ(ierr);
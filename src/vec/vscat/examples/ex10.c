@@ -0,0 +1,122 @@
+static char help[]= "Tests VecScatterBeginMultiple() and VecScatterEndMultiple() against scattering the vectors one by one.\n\n";
+
+#include <petscvec.h>
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode    ierr;
+  PetscMPIInt       rank,size;
+  PetscInt          i,k,n = 4,N,nv = 3,low,high,nerr = 0,*idx;
+  Vec               x[3],y[3],z[3],w[3];
+  IS                ix,iy;
+  VecScatter        vscat;
+  PetscScalar       *xv;
+  const PetscScalar *yv,*zv;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  N    = n*size;
+
+  /* x[k] are parallel vectors with entries 1000*k+i, y[k] and z[k] are sequential vectors of length 2n */
+  for (k=0; k<nv; k++) {
+    ierr = VecCreateMPI(PETSC_COMM_WORLD,n,N,&x[k]);CHKERRQ(ierr);
+    ierr = VecGetOwnershipRange(x[k],&low,&high);CHKERRQ(ierr);
+    ierr = VecGetArray(x[k],&xv);CHKERRQ(ierr);
+    for (i=low; i<high; i++) xv[i-low] = 1000*k+i;
+    ierr = VecRestoreArray(x[k],&xv);CHKERRQ(ierr);
+    ierr = VecDuplicate(x[k],&w[k]);CHKERRQ(ierr);
+    ierr = VecCreateSeq(PETSC_COMM_SELF,2*n,&y[k]);CHKERRQ(ierr);
+    ierr = VecDuplicate(y[k],&z[k]);CHKERRQ(ierr);
+  }
+
+  /* Each process gets the n entries owned by the next process, followed by its own entries in reverse order */
+  ierr = PetscMalloc1(2*n,&idx);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(x[0],&low,&high);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    idx[i]   = (high+i)%N;
+    idx[n+i] = high-1-i;
+  }
+  ierr = ISCreateGeneral(PETSC_COMM_SELF,2*n,idx,PETSC_COPY_VALUES,&ix);CHKERRQ(ierr);
+  ierr = ISCreateStride(PETSC_COMM_SELF,2*n,0,1,&iy);CHKERRQ(ierr);
+  ierr = VecScatterCreate(x[0],ix,y[0],iy,&vscat);CHKERRQ(ierr);
+
+  /* Forward scatter of all vectors at once, compared to one by one */
+  ierr = VecScatterBeginMultiple(vscat,nv,x,y,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = VecScatterEndMultiple(vscat,nv,x,y,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  for (k=0; k<nv; k++) {
+    ierr = VecScatterBegin(vscat,x[k],z[k],INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecScatterEnd(vscat,x[k],z[k],INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(y[k],&yv);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(z[k],&zv);CHKERRQ(ierr);
+    for (i=0; i<2*n; i++) {
+      if (yv[i] != zv[i] || yv[i] != (PetscScalar)(1000*k+idx[i])) nerr++;
+    }
+    ierr = VecRestoreArrayRead(y[k],&yv);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(z[k],&zv);CHKERRQ(ierr);
+  }
+
+  /* Reverse scatter with addition: every entry of x[k] is hit twice, so w[k] = x[k] + 2*x[k] */
+  for (k=0; k<nv; k++) {ierr = VecCopy(x[k],w[k]);CHKERRQ(ierr);}
+  ierr = VecScatterBeginMultiple(vscat,nv,y,w,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  ierr = VecScatterEndMultiple(vscat,nv,y,w,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  for (k=0; k<nv; k++) {
+    ierr = VecAXPY(w[k],-3.0,x[k]);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(w[k],&zv);CHKERRQ(ierr);
+    for (i=0; i<n; i++) {
+      if (zv[i] != 0.0) nerr++;
+    }
+    ierr = VecRestoreArrayRead(w[k],&zv);CHKERRQ(ierr);
+  }
+
+  ierr = MPI_Allreduce(MPI_IN_PLACE,&nerr,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  if (nerr) {ierr = PetscPrintf(PETSC_COMM_WORLD,"VecScatterBeginMultiple() produced %D wrong entries\n",nerr);CHKERRQ(ierr);}
+
+  for (k=0; k<nv; k++) {
+    ierr = VecDestroy(&x[k]);CHKERRQ(ierr);
+    ierr = VecDestroy(&y[k]);CHKERRQ(ierr);
+    ierr = VecDestroy(&z[k]);CHKERRQ(ierr);
+    ierr = VecDestroy(&w[k]);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(idx);CHKERRQ(ierr);
+  ierr = ISDestroy(&ix);CHKERRQ(ierr);
+  ierr = ISDestroy(&iy);CHKERRQ(ierr);
+  ierr = VecScatterDestroy(&vscat);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      nsize: 3
+      output_file: output/ex10_1.out
+
+   test:
+      suffix: sf
+      nsize: 3
+      args: -vecscatter_type sf
+      output_file: output/ex10_1.out
+
+   test:
+      suffix: sf_1
+      nsize: 1
+      args: -vecscatter_type sf
+      output_file: output/ex10_1.out
+
+   test:
+      suffix: sf_neighbor
+      nsize: 3
+      args: -vecscatter_type sf -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+      output_file: output/ex10_1.out
+
+   test:
+      suffix: sf_shm
+      nsize: 3
+      args: -vecscatter_type sf -sf_basic_shared_memory
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) define(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
+      output_file: output/ex10_1.out
+
+TEST*/
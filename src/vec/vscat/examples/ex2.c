@@ -124,4 +124,18 @@ int main(int argc,char **argv)
       output_file: output/ex2_5.out
       requires:  define(PETSC_HAVE_MPI_WIN_CREATE_FEATURE)
 
+   test:
+      suffix: sf_neighbor
+      nsize: 2
+      args: -bs 3 -vecscatter_type sf -sf_type neighbor
+      output_file: output/ex2_2.out
+      requires:  define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: sf_neighbor_2
+      nsize: 3
+      args: -vecscatter_type sf -sf_type neighbor
+      output_file: output/ex2_5.out
+      requires:  define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
 TEST*/
@@ -6,13 +6,24 @@ typedef struct {
   PetscSF           lsf;    /* the local part of the scatter, used for SCATTER_LOCAL */
   PetscInt          bs;     /* block size */
   MPI_Datatype      unit;   /* one unit = bs PetscScalars */
+  PetscInt          maxvecs;/* capacity of xdatas[] and ydatas[] */
+  const PetscScalar **xdatas;/* vector data to read from in VecScatterBeginMultiple() */
+  PetscScalar       **ydatas;/* vector data to write to in VecScatterBeginMultiple() */
 } VecScatter_SF;
 
-static PetscErrorCode VecScatterBegin_SF(VecScatter vscat,Vec x,Vec y,InsertMode addv,ScatterMode mode)
+static PetscErrorCode VecScatterGetMPIOp_SF(VecScatter vscat,InsertMode addv,MPI_Op *mop)
+{
+  PetscFunctionBegin;
+  if (addv == INSERT_VALUES)   *mop = MPI_REPLACE;
+  else if (addv == ADD_VALUES) *mop = MPI_SUM;
+  else if (addv == MAX_VALUES) *mop = MPI_MAX;
+  else SETERRQ1(PetscObjectComm((PetscObject)vscat),PETSC_ERR_SUP,"Unsupported InsertMode %D in VecScatterBegin/End",addv);
+  PetscFunctionReturn(0);
+}
+
+/* Locks x and y and gets their arrays, copying the entries of x needed by the scatter from the GPU */
+static PetscErrorCode VecScatterGetArrays_SF(VecScatter vscat,Vec x,Vec y,ScatterMode mode,const PetscScalar **xdata,PetscScalar **ydata)
 {
-  VecScatter_SF  *data=(VecScatter_SF*)vscat->data;
-  PetscSF        sf;
-  MPI_Op         mop=MPI_OP_NULL;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -28,25 +39,47 @@ static PetscErrorCode VecScatterBegin_SF(VecScatter vscat,Vec x,Vec y,InsertMode
         if (x->spptr && vscat->spptr) {ierr = VecCUDACopyFromGPUSome_Public(x,(PetscCUDAIndices)vscat->spptr,mode);CHKERRQ(ierr);}
         else {ierr = VecCUDACopyFromGPU(x);CHKERRQ(ierr);}
       }
-      vscat->xdata = *((PetscScalar**)x->data);
+      *xdata = *((PetscScalar**)x->data);
     } else
 #endif
     {
-      ierr = VecGetArrayRead(x,&vscat->xdata);CHKERRQ(ierr);
+      ierr = VecGetArrayRead(x,xdata);CHKERRQ(ierr);
     }
   }
 
-  if (x != y) {ierr = VecGetArray(y,&vscat->ydata);CHKERRQ(ierr);}
-  else vscat->ydata = (PetscScalar *)vscat->xdata;
+  if (x != y) {ierr = VecGetArray(y,ydata);CHKERRQ(ierr);}
+  else *ydata = (PetscScalar *)*xdata;
   ierr = VecLockWriteSet_Private(y,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode VecScatterRestoreArrays_SF(Vec x,Vec y,const PetscScalar **xdata,PetscScalar **ydata)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (x != y) {
+    ierr = VecRestoreArrayRead(x,xdata);CHKERRQ(ierr);
+    ierr = VecLockReadPop(x);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArray(y,ydata);CHKERRQ(ierr);
+  ierr = VecLockWriteSet_Private(y,PETSC_FALSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode VecScatterBegin_SF(VecScatter vscat,Vec x,Vec y,InsertMode addv,ScatterMode mode)
+{
+  VecScatter_SF  *data=(VecScatter_SF*)vscat->data;
+  PetscSF        sf;
+  MPI_Op         mop=MPI_OP_NULL;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecScatterGetArrays_SF(vscat,x,y,mode,&vscat->xdata,&vscat->ydata);CHKERRQ(ierr);
 
   /* SCATTER_LOCAL indicates ignoring inter-process communication */
   sf = (mode & SCATTER_LOCAL) ? data->lsf : data->sf;
-
-  if (addv == INSERT_VALUES)   mop = MPI_REPLACE;
-  else if (addv == ADD_VALUES) mop = MPI_SUM;
-  else if (addv == MAX_VALUES) mop = MPI_MAX;
-  else SETERRQ1(PetscObjectComm((PetscObject)sf),PETSC_ERR_SUP,"Unsupported InsertMode %D in VecScatterBegin/End",addv);
+  ierr = VecScatterGetMPIOp_SF(vscat,addv,&mop);CHKERRQ(ierr);
 
   if (mode & SCATTER_REVERSE) { /* reverse scatter sends root to leaf. Note that x and y are swapped in input */
     ierr = PetscSFBcastAndOpBegin(sf,data->unit,vscat->xdata,vscat->ydata,mop);CHKERRQ(ierr);
@@ -66,11 +99,7 @@ static PetscErrorCode VecScatterEnd_SF(VecScatter vscat,Vec x,Vec y,InsertMode a
   PetscFunctionBegin;
   /* SCATTER_LOCAL indicates ignoring inter-process communication */
   sf = (mode & SCATTER_LOCAL) ? data->lsf : data->sf;
-
-  if (addv == INSERT_VALUES)   mop = MPI_REPLACE;
-  else if (addv == ADD_VALUES) mop = MPI_SUM;
-  else if (addv == MAX_VALUES) mop = MPI_MAX;
-  else SETERRQ1(PetscObjectComm((PetscObject)sf),PETSC_ERR_SUP,"Unsupported InsertMode %D in VecScatterBegin/End",addv);
+  ierr = VecScatterGetMPIOp_SF(vscat,addv,&mop);CHKERRQ(ierr);
 
   if (mode & SCATTER_REVERSE) {/* reverse scatter sends root to leaf. Note that x and y are swapped in input */
     ierr = PetscSFBcastAndOpEnd(sf,data->unit,vscat->xdata,vscat->ydata,mop);CHKERRQ(ierr);
@@ -78,12 +107,58 @@ static PetscErrorCode VecScatterEnd_SF(VecScatter vscat,Vec x,Vec y,InsertMode a
     ierr = PetscSFReduceEnd(sf,data->unit,vscat->xdata,vscat->ydata,mop);CHKERRQ(ierr);
   }
 
-  if (x != y) {
-    ierr = VecRestoreArrayRead(x,&vscat->xdata);CHKERRQ(ierr);
-    ierr = VecLockReadPop(x);CHKERRQ(ierr);
+  ierr = VecScatterRestoreArrays_SF(x,y,&vscat->xdata,&vscat->ydata);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode VecScatterBeginMultiple_SF(VecScatter vscat,PetscInt n,Vec *x,Vec *y,InsertMode addv,ScatterMode mode)
+{
+  VecScatter_SF  *data=(VecScatter_SF*)vscat->data;
+  PetscSF        sf;
+  MPI_Op         mop=MPI_OP_NULL;
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (n > data->maxvecs) {
+    ierr = PetscFree2(data->xdatas,data->ydatas);CHKERRQ(ierr);
+    ierr = PetscMalloc2(n,&data->xdatas,n,&data->ydatas);CHKERRQ(ierr);
+    data->maxvecs = n;
   }
-  ierr = VecRestoreArray(y,&vscat->ydata);CHKERRQ(ierr);
-  ierr = VecLockWriteSet_Private(y,PETSC_FALSE);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {ierr = VecScatterGetArrays_SF(vscat,x[i],y[i],mode,&data->xdatas[i],&data->ydatas[i]);CHKERRQ(ierr);}
+
+  /* SCATTER_LOCAL indicates ignoring inter-process communication */
+  sf = (mode & SCATTER_LOCAL) ? data->lsf : data->sf;
+  ierr = VecScatterGetMPIOp_SF(vscat,addv,&mop);CHKERRQ(ierr);
+
+  if (mode & SCATTER_REVERSE) { /* reverse scatter sends root to leaf. Note that x and y are swapped in input */
+    ierr = PetscSFBcastAndOpBeginMultiple(sf,data->unit,n,(const void*const*)data->xdatas,(void*const*)data->ydatas,mop);CHKERRQ(ierr);
+  } else { /* forward scatter sends leaf to root, i.e., x to y */
+    ierr = PetscSFReduceBeginMultiple(sf,data->unit,n,(const void*const*)data->xdatas,(void*const*)data->ydatas,mop);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode VecScatterEndMultiple_SF(VecScatter vscat,PetscInt n,Vec *x,Vec *y,InsertMode addv,ScatterMode mode)
+{
+  VecScatter_SF  *data=(VecScatter_SF*)vscat->data;
+  PetscSF        sf;
+  MPI_Op         mop=MPI_OP_NULL;
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* SCATTER_LOCAL indicates ignoring inter-process communication */
+  sf = (mode & SCATTER_LOCAL) ? data->lsf : data->sf;
+  ierr = VecScatterGetMPIOp_SF(vscat,addv,&mop);CHKERRQ(ierr);
+
+  if (mode & SCATTER_REVERSE) {/* reverse scatter sends root to leaf. Note that x and y are swapped in input */
+    ierr = PetscSFBcastAndOpEndMultiple(sf,data->unit,n,(const void*const*)data->xdatas,(void*const*)data->ydatas,mop);CHKERRQ(ierr);
+  } else { /* forward scatter sends leaf to root, i.e., x to y */
+    ierr = PetscSFReduceEndMultiple(sf,data->unit,n,(const void*const*)data->xdatas,(void*const*)data->ydatas,mop);CHKERRQ(ierr);
+  }
+
+  for (i=0; i<n; i++) {ierr = VecScatterRestoreArrays_SF(x[i],y[i],&data->xdatas[i],&data->ydatas[i]);CHKERRQ(ierr);}
   PetscFunctionReturn(0);
 }
 
@@ -93,7 +168,7 @@ static PetscErrorCode VecScatterCopy_SF(VecScatter vscat,VecScatter ctx)
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = PetscMemcpy(ctx->ops,vscat->ops,sizeof(vscat->ops));CHKERRQ(ierr);
+  ierr = PetscMemcpy(ctx->ops,vscat->ops,sizeof(struct _VecScatterOps));CHKERRQ(ierr);
   ierr = PetscNewLog(ctx,&out);CHKERRQ(ierr);
   ierr = PetscSFDuplicate(data->sf,PETSCSF_DUPLICATE_GRAPH,&out->sf);CHKERRQ(ierr);
   ierr = PetscSFDuplicate(data->lsf,PETSCSF_DUPLICATE_GRAPH,&out->lsf);CHKERRQ(ierr);
@@ -119,6 +194,7 @@ static PetscErrorCode VecScatterDestroy_SF(VecScatter vscat)
   ierr = PetscSFDestroy(&data->sf);CHKERRQ(ierr);
   ierr = PetscSFDestroy(&data->lsf);CHKERRQ(ierr);
   if (data->bs > 1) {ierr = MPI_Type_free(&data->unit);CHKERRQ(ierr);}
+  ierr = PetscFree2(data->xdatas,data->ydatas);CHKERRQ(ierr);
   ierr = PetscFree(vscat->data);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -485,6 +561,7 @@ static PetscErrorCode VecScatterSetUp_SF(VecScatter vscat)
        In SF's view, yy contains the roots (i.e., the remote) and iremote[].rank are ranks in yy's comm.
        xx contains leaves, which are local and can be thought as part of PETSC_COMM_SELF. */
     ierr = PetscSFCreate(PetscObjectComm((PetscObject)yy),&data->sf);CHKERRQ(ierr);
+    ierr = PetscSFSetFromOptions(data->sf);CHKERRQ(ierr); /* so that -sf_type selects the communication implementation */
     ierr = PetscSFSetGraph(data->sf,nroots,nleaves,ilocal,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
     ierr = PetscFree(rootdata);CHKERRQ(ierr);
   } else {
@@ -497,6 +574,7 @@ static PetscErrorCode VecScatterSetUp_SF(VecScatter vscat)
     ierr = PetscMemcpy(ilocal,xindices,nleaves*sizeof(PetscInt));CHKERRQ(ierr);
     for (i=0; i<nleaves; i++) {ierr = PetscLayoutFindOwnerIndex(ylayout,yindices[i],&iremote[i].rank,&iremote[i].index);CHKERRQ(ierr);}
     ierr = PetscSFCreate(PetscObjectComm((PetscObject)yy),&data->sf);CHKERRQ(ierr);
+    ierr = PetscSFSetFromOptions(data->sf);CHKERRQ(ierr);
     ierr = PetscSFSetGraph(data->sf,nroots,nleaves,ilocal,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
   }
 
@@ -547,6 +625,8 @@ static PetscErrorCode VecScatterSetUp_SF(VecScatter vscat)
   vscat->data                      = (void*)data;
   vscat->ops->begin                = VecScatterBegin_SF;
   vscat->ops->end                  = VecScatterEnd_SF;
+  vscat->ops->beginmultiple        = VecScatterBeginMultiple_SF;
+  vscat->ops->endmultiple          = VecScatterEndMultiple_SF;
   vscat->ops->remap                = VecScatterRemap_SF;
   vscat->ops->copy                 = VecScatterCopy_SF;
   vscat->ops->destroy              = VecScatterDestroy_SF;
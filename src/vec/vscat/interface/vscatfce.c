@@ -27,6 +27,34 @@ PetscErrorCode  VecScatterGetMerged(VecScatter ctx,PetscBool  *flg)
   PetscFunctionReturn(0);
 }
 
+#if defined(PETSC_USE_DEBUG)
+/*
+     Error checking to make sure these vectors match the vectors used
+   to create the vector scatter context. -1 in the from_n and to_n indicate the
+   vector lengths are unknown (for example with mapped scatters) and thus
+   no error checking is performed.
+*/
+static PetscErrorCode VecScatterCheckSizes_Private(VecScatter ctx,Vec x,Vec y,ScatterMode mode)
+{
+  PetscErrorCode ierr;
+  PetscInt       to_n,from_n;
+
+  PetscFunctionBegin;
+  if (ctx->from_n >= 0 && ctx->to_n >= 0) {
+    ierr = VecGetLocalSize(x,&from_n);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(y,&to_n);CHKERRQ(ierr);
+    if (mode & SCATTER_REVERSE) {
+      if (to_n != ctx->from_n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter reverse and vector to != ctx from size)",to_n,ctx->from_n);
+      if (from_n != ctx->to_n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter reverse and vector from != ctx to size)",from_n,ctx->to_n);
+    } else {
+      if (to_n != ctx->to_n)     SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter forward and vector to != ctx to size)",to_n,ctx->to_n);
+      if (from_n != ctx->from_n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter forward and vector from != ctx from size)",from_n,ctx->from_n);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+#endif
+
 /*@
    VecScatterBegin - Begins a generalized scatter from one vector to
    another. Complete the scattering phase with VecScatterEnd().
@@ -76,9 +104,7 @@ PetscErrorCode  VecScatterGetMerged(VecScatter ctx,PetscBool  *flg)
 PetscErrorCode  VecScatterBegin(VecScatter ctx,Vec x,Vec y,InsertMode addv,ScatterMode mode)
 {
   PetscErrorCode ierr;
-#if defined(PETSC_USE_DEBUG)
-  PetscInt       to_n,from_n;
-#endif
+
   PetscFunctionBegin;
   PetscValidHeaderSpecific(ctx,VEC_SCATTER_CLASSID,1);
   PetscValidHeaderSpecific(x,VEC_CLASSID,2);
@@ -86,23 +112,7 @@ PetscErrorCode  VecScatterBegin(VecScatter ctx,Vec x,Vec y,InsertMode addv,Scatt
   if (ctx->inuse) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE," Scatter ctx already in use");
 
 #if defined(PETSC_USE_DEBUG)
-  /*
-     Error checking to make sure these vectors match the vectors used
-   to create the vector scatter context. -1 in the from_n and to_n indicate the
-   vector lengths are unknown (for example with mapped scatters) and thus
-   no error checking is performed.
-  */
-  if (ctx->from_n >= 0 && ctx->to_n >= 0) {
-    ierr = VecGetLocalSize(x,&from_n);CHKERRQ(ierr);
-    ierr = VecGetLocalSize(y,&to_n);CHKERRQ(ierr);
-    if (mode & SCATTER_REVERSE) {
-      if (to_n != ctx->from_n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter reverse and vector to != ctx from size)",to_n,ctx->from_n);
-      if (from_n != ctx->to_n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter reverse and vector from != ctx to size)",from_n,ctx->to_n);
-    } else {
-      if (to_n != ctx->to_n)     SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter forward and vector to != ctx to size)",to_n,ctx->to_n);
-      if (from_n != ctx->from_n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter forward and vector from != ctx from size)",from_n,ctx->from_n);
-    }
-  }
+  ierr = VecScatterCheckSizes_Private(ctx,x,y,mode);CHKERRQ(ierr);
 #endif
 
   ctx->inuse = PETSC_TRUE;
@@ -158,6 +168,107 @@ PetscErrorCode  VecScatterEnd(VecScatter ctx,Vec x,Vec y,InsertMode addv,Scatter
   PetscFunctionReturn(0);
 }
 
+/*@
+   VecScatterBeginMultiple - Begins the same scatter on several pairs of vectors at once. Complete the
+   scattering phase with VecScatterEndMultiple().
+
+   Neighbor-wise Collective on VecScatter and Vec
+
+   Input Parameters:
++  ctx - scatter context generated by VecScatterCreate()
+.  n - the number of vector pairs
+.  x - array of n vectors from which we scatter
+.  y - array of n vectors to which we scatter
+.  addv - either ADD_VALUES, INSERT_VALUES or MAX_VALUES
+-  mode - the scattering mode, usually SCATTER_FORWARD.  The available modes are:
+    SCATTER_FORWARD or SCATTER_REVERSE
+
+   Level: advanced
+
+   Notes:
+   This has the same effect as calling VecScatterBegin() and VecScatterEnd() on each pair x[i], y[i], but
+   scatters of type VECSCATTERSF send a single message per neighbor process carrying the data of all n
+   vectors, instead of n messages. This reduces the latency cost of, for example, ghost updates of
+   several fields or of the block of vectors used by block Krylov methods.
+
+   The vectors x[i] must be distinct from each other, and so must the vectors y[i]. For other scatter
+   types, all communication is done in VecScatterBeginMultiple() and VecScatterEndMultiple() does nothing.
+
+.seealso: VecScatterEndMultiple(), VecScatterBegin(), VecScatterCreate()
+@*/
+PetscErrorCode  VecScatterBeginMultiple(VecScatter ctx,PetscInt n,Vec x[],Vec y[],InsertMode addv,ScatterMode mode)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ctx,VEC_SCATTER_CLASSID,1);
+  if (n < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of vectors %D cannot be negative",n);
+  if (!n) PetscFunctionReturn(0);
+  PetscValidPointer(x,3);
+  PetscValidPointer(y,4);
+  for (i=0; i<n; i++) {
+    PetscValidHeaderSpecific(x[i],VEC_CLASSID,3);
+    PetscValidHeaderSpecific(y[i],VEC_CLASSID,4);
+#if defined(PETSC_USE_DEBUG)
+    ierr = VecScatterCheckSizes_Private(ctx,x[i],y[i],mode);CHKERRQ(ierr);
+#endif
+  }
+  if (!ctx->ops->beginmultiple) {
+    for (i=0; i<n; i++) {
+      ierr = VecScatterBegin(ctx,x[i],y[i],addv,mode);CHKERRQ(ierr);
+      ierr = VecScatterEnd(ctx,x[i],y[i],addv,mode);CHKERRQ(ierr);
+    }
+    PetscFunctionReturn(0);
+  }
+  if (ctx->inuse) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE," Scatter ctx already in use");
+
+  ctx->inuse = PETSC_TRUE;
+  ierr = PetscLogEventBegin(VEC_ScatterBegin,ctx,x[0],y[0],0);CHKERRQ(ierr);
+  ierr = (*ctx->ops->beginmultiple)(ctx,n,x,y,addv,mode);CHKERRQ(ierr);
+  if (ctx->beginandendtogether && ctx->ops->endmultiple) {
+    ctx->inuse = PETSC_FALSE;
+    ierr = (*ctx->ops->endmultiple)(ctx,n,x,y,addv,mode);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(VEC_ScatterBegin,ctx,x[0],y[0],0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecScatterEndMultiple - Ends a scatter on several pairs of vectors started with VecScatterBeginMultiple().
+
+   Neighbor-wise Collective on VecScatter and Vec
+
+   Input Parameters:
++  ctx - scatter context generated by VecScatterCreate()
+.  n - the number of vector pairs
+.  x - array of n vectors from which we scatter
+.  y - array of n vectors to which we scatter
+.  addv - either ADD_VALUES, INSERT_VALUES or MAX_VALUES
+-  mode - the scattering mode, usually SCATTER_FORWARD.  The available modes are:
+    SCATTER_FORWARD or SCATTER_REVERSE
+
+   Level: advanced
+
+.seealso: VecScatterBeginMultiple(), VecScatterEnd()
+@*/
+PetscErrorCode  VecScatterEndMultiple(VecScatter ctx,PetscInt n,Vec x[],Vec y[],InsertMode addv,ScatterMode mode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ctx,VEC_SCATTER_CLASSID,1);
+  if (!n || !ctx->ops->beginmultiple) PetscFunctionReturn(0);
+  ctx->inuse = PETSC_FALSE;
+  if (!ctx->ops->endmultiple) PetscFunctionReturn(0);
+  if (!ctx->beginandendtogether) {
+    ierr = PetscLogEventBegin(VEC_ScatterEnd,ctx,x[0],y[0],0);CHKERRQ(ierr);
+    ierr = (*ctx->ops->endmultiple)(ctx,n,x,y,addv,mode);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(VEC_ScatterEnd,ctx,x[0],y[0],0);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 /*@
    VecScatterDestroy - Destroys a scatter context created by VecScatterCreate()
 